@@ -25,10 +25,12 @@ enum ExtAnimationEventType
 };
 
 class ActionPlayerImp;
+class AnimationCache;
 
 class ActionInfo final
 {
     friend ActionPlayerImp;
+    friend AnimationCache;
 
     struct Event
     {
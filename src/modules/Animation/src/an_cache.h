@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+
+// Pre-baked animation: description and key frames in one flat block that is used in place
+
+// HEADER
+// JOINT joint[nJoints]
+// CVECTOR rootPos[nRootPos] - nFrames positions or none
+// int16_t angles[nFrames][4][nJoints rounded up to 4] - compressed quaternions as in Skeleton
+// ACTION action[nActions]
+// EVENT event[nEvents]
+// USERDATA userData[nUserData] - the animation's ones first, then the actions' ones
+// char strings[stringsSize]
+
+#pragma pack(push, 1)
+
+namespace ANCACHE
+{
+constexpr uint32_t MAGIC = 0x434e4153; // "SANC"
+constexpr uint32_t VERSION = 1;
+
+// Substring of strings
+struct STRING
+{
+    uint32_t offset;
+    uint32_t size;
+};
+
+struct HEADER
+{
+    uint32_t magic;
+    uint32_t version;
+    // Sources the cache was baked from
+    int64_t descTime;
+    uint64_t descSize;
+    int64_t anTime;
+    uint64_t anSize;
+    // FNV-1a of everything after the header
+    uint64_t hash;
+
+    int32_t nFrames;
+    int32_t nJoints;
+    float framesPerSec;
+    int32_t nRootPos;
+    int32_t nActions;
+    int32_t nEvents;
+    int32_t nUserData;
+    int32_t nAniUserData;
+    uint32_t stringsSize;
+    STRING anPath; // Key frames file
+    uint32_t reserved;
+};
+
+struct JOINT
+{
+    int32_t parent; // -1 for root
+    float pos[3];
+    float start[16];
+};
+
+struct ACTION
+{
+    STRING name;
+    int32_t startFrame;
+    int32_t endFrame;
+    float rate;
+    int32_t type;
+    int32_t isLoop;
+    int32_t firstEvent;
+    int32_t numEvents;
+    int32_t firstUserData;
+    int32_t numUserData;
+};
+
+struct EVENT
+{
+    STRING name;
+    float time;
+    int32_t type;
+};
+
+struct USERDATA
+{
+    STRING key;
+    STRING value;
+};
+}; // namespace ANCACHE
+
+#pragma pack(pop)
@@ -0,0 +1,332 @@
+// ============================================================================================
+// Storm engine v2.00
+// --------------------------------------------------------------------------------------------
+// AnimationCache
+// --------------------------------------------------------------------------------------------
+// Pre-baked animations, so a description and its key frames are loaded with one read
+// instead of parsing the toml and the an file every time the animation is needed
+// ============================================================================================
+
+#include "animation_cache.h"
+
+#include "an_cache.h"
+#include "animation_info.h"
+#include "file_service.h"
+
+#include "Filesystem/Constants/Paths.hpp"
+
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+
+using namespace Storm::Filesystem;
+
+namespace
+{
+
+uint64_t Hash(const char *data, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash ^= static_cast<uint8_t>(data[i]);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+bool GetSourceStamp(const std::string &fileName, int64_t &time, uint64_t &size)
+{
+    const auto path = std::filesystem::u8path(fio->ConvertPathResource(fileName.c_str()));
+    std::error_code ec;
+    const auto writeTime = last_write_time(path, ec);
+    if (ec)
+        return false;
+    size = file_size(path, ec);
+    if (ec)
+        return false;
+    time = writeTime.time_since_epoch().count();
+    return true;
+}
+
+class Writer
+{
+  public:
+    template <typename T> void Write(const T *src, size_t count)
+    {
+        const auto *bytes = reinterpret_cast<const char *>(src);
+        data.insert(data.end(), bytes, bytes + count * sizeof(T));
+    }
+
+    ANCACHE::STRING AddString(std::string_view str)
+    {
+        const ANCACHE::STRING res{static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(str.size())};
+        strings.insert(strings.end(), str.begin(), str.end());
+        return res;
+    }
+
+    std::vector<char> data;
+    std::vector<char> strings;
+};
+
+class Reader
+{
+  public:
+    Reader(const char *begin, const char *end) : cur(begin), end(end)
+    {
+    }
+
+    template <typename T> bool Read(T *dst, size_t count)
+    {
+        const auto size = count * sizeof(T);
+        if (size > static_cast<size_t>(end - cur))
+            return false;
+        std::memcpy(dst, cur, size);
+        cur += size;
+        return true;
+    }
+
+    template <typename T> bool Read(std::vector<T> &dst, int32_t count)
+    {
+        if (count < 0)
+            return false;
+        dst.resize(count);
+        return Read(dst.data(), dst.size());
+    }
+
+    const char *cur;
+    const char *end;
+};
+
+} // namespace
+
+// ============================================================================================
+
+std::filesystem::path AnimationCache::GetCachePath(const char *animationName)
+{
+    static const std::filesystem::path cacheFolder{Constants::Paths::animation_cache()};
+    return cacheFolder / (std::string(animationName) + ".anc");
+}
+
+AnimationInfo *AnimationCache::Load(const char *animationName, const std::filesystem::path &descPath)
+{
+    const MappedFile file(GetCachePath(animationName));
+    const auto view = file.View();
+    if (view.Size() < sizeof(ANCACHE::HEADER))
+        return nullptr;
+
+    ANCACHE::HEADER header;
+    std::memcpy(&header, view.Data(), sizeof(header));
+    const auto *payload = view.Data() + sizeof(header);
+    const auto payloadSize = view.Size() - sizeof(header);
+    if (header.magic != ANCACHE::MAGIC || header.version != ANCACHE::VERSION ||
+        header.hash != Hash(payload, payloadSize) || header.nFrames <= 0 || header.nJoints <= 0 ||
+        header.nJoints > 256 || header.nAniUserData < 0 || header.nAniUserData > header.nUserData ||
+        (header.nRootPos != 0 && header.nRootPos != header.nFrames))
+        return nullptr;
+
+    Reader reader(payload, payload + payloadSize);
+    std::vector<ANCACHE::JOINT> joints;
+    std::vector<CVECTOR> rootPos;
+    std::vector<int16_t> angles;
+    std::vector<ANCACHE::ACTION> actions;
+    std::vector<ANCACHE::EVENT> events;
+    std::vector<ANCACHE::USERDATA> userData;
+    const auto paddedJoints = (header.nJoints + 3) & ~3;
+    if (!reader.Read(joints, header.nJoints) || !reader.Read(rootPos, header.nRootPos) ||
+        !reader.Read(angles, header.nFrames * 4 * paddedJoints) || !reader.Read(actions, header.nActions) ||
+        !reader.Read(events, header.nEvents) || !reader.Read(userData, header.nUserData) ||
+        reader.end - reader.cur != static_cast<ptrdiff_t>(header.stringsSize))
+        return nullptr;
+
+    // strings are used in place
+    const std::string_view strings(reader.cur, header.stringsSize);
+    auto getString = [&strings](const ANCACHE::STRING &str, std::string_view &res) {
+        if (str.offset > strings.size() || str.size > strings.size() - str.offset)
+            return false;
+        res = strings.substr(str.offset, str.size);
+        return true;
+    };
+
+    // the sources must be the ones the cache was baked from
+    std::string_view anPath;
+    int64_t time;
+    uint64_t size;
+    if (!getString(header.anPath, anPath) || !GetSourceStamp(descPath.string(), time, size) ||
+        time != header.descTime || size != header.descSize || !GetSourceStamp(std::string(anPath), time, size) ||
+        time != header.anTime || size != header.anSize)
+        return nullptr;
+
+    auto *info = new AnimationInfo(animationName);
+    info->SetNumFrames(header.nFrames);
+    info->SetFPS(header.framesPerSec);
+    info->CreateBones(header.nJoints);
+    auto &skeleton = info->skeleton;
+    skeleton.numJoints = header.nJoints;
+    skeleton.paddedJoints = paddedJoints;
+    skeleton.numFrames = header.nFrames;
+    skeleton.angles = std::move(angles);
+    skeleton.rootPos = std::move(rootPos);
+    skeleton.jointPos.resize(header.nJoints);
+    skeleton.parents.resize(header.nJoints);
+    for (int32_t i = 0; i < header.nJoints; i++)
+    {
+        const auto &joint = joints[i];
+        if (joint.parent >= header.nJoints || (i > 0) != (joint.parent >= 0))
+        {
+            delete info;
+            return nullptr;
+        }
+        auto &bn = info->GetBone(i);
+        if (joint.parent >= 0)
+            bn.SetParent(&info->GetBone(joint.parent));
+        bn.pos0 = CVECTOR(joint.pos[0], joint.pos[1], joint.pos[2]);
+        std::memcpy(bn.start.matrix, joint.start, sizeof(joint.start));
+        skeleton.jointPos[i] = bn.pos0;
+        skeleton.parents[i] = joint.parent;
+    }
+
+    auto addUserData = [&](std::unordered_map<std::string, std::string> &dst, int32_t first, int32_t num) {
+        if (first < 0 || num < 0 || num > header.nUserData - first)
+            return false;
+        for (int32_t i = first; i < first + num; i++)
+        {
+            std::string_view key, value;
+            if (!getString(userData[i].key, key) || !getString(userData[i].value, value))
+                return false;
+            dst[std::string(key)] = value;
+        }
+        return true;
+    };
+
+    auto isLoaded = addUserData(info->userData, 0, header.nAniUserData);
+    for (const auto &action : actions)
+    {
+        std::string_view name;
+        if (!isLoaded || !getString(action.name, name) || name.empty() || name.size() >= 64 ||
+            action.startFrame < 0 || action.startFrame > action.endFrame || action.numEvents < 0 ||
+            action.numEvents > ANI_MAX_EVENTS || action.firstEvent < 0 ||
+            action.numEvents > header.nEvents - action.firstEvent)
+        {
+            isLoaded = false;
+            break;
+        }
+        auto *aci = info->AddAction(std::string(name).c_str(), action.startFrame, action.endFrame);
+        if (!aci)
+            continue;
+        aci->kRate = action.rate;
+        aci->type = static_cast<AnimationType>(action.type);
+        aci->isLoop = action.isLoop != 0;
+        for (int32_t i = 0; i < action.numEvents && isLoaded; i++)
+        {
+            const auto &event = events[action.firstEvent + i];
+            std::string_view eventName;
+            isLoaded = getString(event.name, eventName) && eventName.size() < 64;
+            if (!isLoaded)
+                break;
+            auto &dst = aci->event[aci->numEvents++];
+            std::memcpy(dst.name, eventName.data(), eventName.size());
+            dst.name[eventName.size()] = 0;
+            dst.time = event.time;
+            dst.event = static_cast<ExtAnimationEventType>(event.type);
+        }
+        isLoaded = isLoaded && addUserData(aci->userData, action.firstUserData, action.numUserData);
+    }
+    if (!isLoaded)
+    {
+        delete info;
+        return nullptr;
+    }
+    return info;
+}
+
+void AnimationCache::Save(const AnimationInfo &info, const std::filesystem::path &descPath, const std::string &anPath)
+{
+    ANCACHE::HEADER header{};
+    header.magic = ANCACHE::MAGIC;
+    header.version = ANCACHE::VERSION;
+    if (!GetSourceStamp(descPath.string(), header.descTime, header.descSize) ||
+        !GetSourceStamp(anPath, header.anTime, header.anSize))
+        return;
+
+    Writer writer;
+    const auto &skeleton = info.skeleton;
+    header.anPath = writer.AddString(anPath);
+    header.nFrames = info.numFrames;
+    header.nJoints = info.numBones;
+    header.framesPerSec = info.fps;
+    header.nRootPos = static_cast<int32_t>(skeleton.rootPos.size());
+
+    for (int32_t i = 0; i < info.numBones; i++)
+    {
+        const auto &bn = info.bone[i];
+        ANCACHE::JOINT joint;
+        joint.parent = skeleton.parents[i];
+        joint.pos[0] = bn.pos0.x;
+        joint.pos[1] = bn.pos0.y;
+        joint.pos[2] = bn.pos0.z;
+        std::memcpy(joint.start, bn.start.matrix, sizeof(joint.start));
+        writer.Write(&joint, 1);
+    }
+    writer.Write(skeleton.rootPos.data(), skeleton.rootPos.size());
+    writer.Write(skeleton.angles.data(), skeleton.angles.size());
+
+    std::vector<ANCACHE::ACTION> actions;
+    std::vector<ANCACHE::EVENT> events;
+    std::vector<ANCACHE::USERDATA> userData;
+    for (const auto &[key, value] : info.userData)
+        userData.push_back({writer.AddString(key), writer.AddString(value)});
+    header.nAniUserData = static_cast<int32_t>(userData.size());
+    for (const auto &aci : info.actions)
+    {
+        ANCACHE::ACTION action;
+        action.name = writer.AddString(aci.name);
+        action.startFrame = aci.startFrame;
+        action.endFrame = aci.endFrame;
+        action.rate = aci.kRate;
+        action.type = aci.type;
+        action.isLoop = aci.isLoop;
+        action.firstEvent = static_cast<int32_t>(events.size());
+        action.numEvents = aci.numEvents;
+        action.firstUserData = static_cast<int32_t>(userData.size());
+        action.numUserData = static_cast<int32_t>(aci.userData.size());
+        for (int32_t i = 0; i < aci.numEvents; i++)
+            events.push_back({writer.AddString(aci.event[i].name), aci.event[i].time, aci.event[i].event});
+        for (const auto &[key, value] : aci.userData)
+            userData.push_back({writer.AddString(key), writer.AddString(value)});
+        actions.push_back(action);
+    }
+    header.nActions = static_cast<int32_t>(actions.size());
+    header.nEvents = static_cast<int32_t>(events.size());
+    header.nUserData = static_cast<int32_t>(userData.size());
+    header.stringsSize = static_cast<uint32_t>(writer.strings.size());
+    writer.Write(actions.data(), actions.size());
+    writer.Write(events.data(), events.size());
+    writer.Write(userData.data(), userData.size());
+    writer.Write(writer.strings.data(), writer.strings.size());
+    header.hash = Hash(writer.data.data(), writer.data.size());
+
+    // write next to the cache and swap, so a load never sees a half written file
+    const auto path = GetCachePath(info.name);
+    auto tmpPath = path;
+    tmpPath += ".tmp";
+    std::error_code ec;
+    create_directories(path.parent_path(), ec);
+    {
+        std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            return;
+        stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        stream.write(writer.data.data(), writer.data.size());
+        if (!stream)
+        {
+            stream.close();
+            remove(tmpPath, ec);
+            return;
+        }
+    }
+    rename(tmpPath, path, ec);
+    if (ec)
+        remove(tmpPath, ec);
+}
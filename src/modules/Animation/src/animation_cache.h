@@ -0,0 +1,27 @@
+// ============================================================================================
+// Storm engine v2.00
+// --------------------------------------------------------------------------------------------
+// AnimationCache
+// --------------------------------------------------------------------------------------------
+// Pre-baked animations, so a description and its key frames are loaded with one read
+// instead of parsing the toml and the an file every time the animation is needed
+// ============================================================================================
+
+#pragma once
+
+#include <filesystem>
+#include <string>
+
+class AnimationInfo;
+
+class AnimationCache final
+{
+  public:
+    // Load the animation baked from descPath, nullptr if there is no cache or sources have changed
+    static AnimationInfo *Load(const char *animationName, const std::filesystem::path &descPath);
+    // Bake the loaded animation
+    static void Save(const AnimationInfo &info, const std::filesystem::path &descPath, const std::string &anPath);
+
+  private:
+    static std::filesystem::path GetCachePath(const char *animationName);
+};
@@ -34,6 +34,10 @@ AnimationImp::AnimationImp(int32_t id, AnimationInfo *animationInfo)
         timer[i].SetAnimation(this);
     }
     matrix = new CMatrix[aniInfo->NumBones()];
+    boneMatrix = new CMatrix[aniInfo->NumBones()];
+    localMatrix = new CMatrix[aniInfo->NumBones()];
+    for (auto &p : pose)
+        p.Resize(aniInfo->GetSkeleton().PaddedJoints());
     memset(ae_listeners, 0, sizeof(ae_listeners));
     ae_listenersExt = nullptr;
     // Auto normalization
@@ -48,6 +52,7 @@ AnimationImp::AnimationImp(int32_t id, AnimationInfo *animationInfo)
         headBoneIndex = atol(dataStr);
     customHeadAX = 0.0f;
     customHeadAY = 0.0f;
+    isDeferEvents = false;
 }
 
 AnimationImp::~AnimationImp()
@@ -55,6 +60,8 @@ AnimationImp::~AnimationImp()
     aniInfo->RelRef();
     aniService->DeleteAnimation(this);
     delete[] matrix;
+    delete[] boneMatrix;
+    delete[] localMatrix;
 }
 
 //--------------------------------------------------------------------------------------------
@@ -241,6 +248,7 @@ void AnimationImp::BuildAnimationMatrices()
     // Auto normalization
     if (normBlend != 0.0f)
     {
+        const auto &skeleton = aniInfo->GetSkeleton();
         if (plCnt > 1)
         {
             normBlend = 1.0f / normBlend;
@@ -265,79 +273,16 @@ void AnimationImp::BuildAnimationMatrices()
 
             auto kBlend = 1.0f - action[0].kBlendCurrent * normBlend;
             //-------------------------------------------------------------------------
-            for (int32_t j = 0; j < nbones; j++)
-            {
-                auto &bn = aniInfo->GetBone(j);
-                Matrix tmpMtx;
-                CMatrix inmtx;
-                Quaternion qt0, qt1, qt;
-                bn.BlendFrame(f0, ki0, qt0);
-                bn.BlendFrame(f1, ki1, qt1);
-                qt.SLerp(qt0, qt1, kBlend);
-                qt.GetMatrix(tmpMtx);
-                inmtx = tmpMtx;
-                inmtx.Pos() = bn.pos0;
-                if (j == 0)
-                {
-                    auto p0 = bn.pos[f0] + ki0 * (bn.pos[f0 + 1] - bn.pos[f0]);
-                    auto p1 = bn.pos[f1] + ki1 * (bn.pos[f1 + 1] - bn.pos[f1]);
-                    inmtx.Pos() = p0 + kBlend * (p1 - p0);
-                }
-
-                // Procedural head look
-                if (j == headBoneIndex && isControllableHead)
-                {
-                    inmtx.RotateX(customHeadAX);
-                    inmtx.RotateY(customHeadAY);
-                }
-
-                if (bn.parent)
-                    bn.matrix.EqMultiply(inmtx, CMatrix(bn.parent->matrix));
-                else
-                    bn.matrix = inmtx;
-            }
-        }
-        else if (action[0].IsPlaying())
-        {
-            auto frame = action[0].GetCurrentFrame();
-            auto f = static_cast<int32_t>(frame);
-            auto ki = frame - static_cast<float>(f);
-            if (f >= nFrames)
-            {
-                f = nFrames - 1;
-                ki = 0.0f;
-            }
-
-            //-------------------------------------------------------------------------
-            for (int32_t j = 0; j < nbones; j++)
-            {
-                auto &bn = aniInfo->GetBone(j);
-                Matrix tmpMtx;
-                CMatrix inmtx;
-                Quaternion qt;
-                bn.BlendFrame(f, ki, qt);
-                qt.GetMatrix(tmpMtx);
-                inmtx = tmpMtx;
-                inmtx.Pos() = bn.pos0;
-                if (j == 0)
-                    inmtx.Pos() = bn.pos[f] + ki * (bn.pos[f + 1] - bn.pos[f]);
-
-                // Procedural head look
-                if (j == headBoneIndex && isControllableHead)
-                {
-                    inmtx.RotateX(customHeadAX);
-                    inmtx.RotateY(customHeadAY);
-                }
-
-                if (bn.parent)
-                    bn.matrix.EqMultiply(inmtx, CMatrix(bn.parent->matrix));
-                else
-                    bn.matrix = inmtx;
-            }
+            skeleton.BlendFrame(f0, ki0, pose[1]);
+            skeleton.BlendFrame(f1, ki1, pose[2]);
+            skeleton.Blend(pose[1], pose[2], kBlend, pose[0]);
+            const auto p0 = skeleton.RootPosition(f0, ki0);
+            const auto p1 = skeleton.RootPosition(f1, ki1);
+            BuildBoneMatrices(p0 + kBlend * (p1 - p0));
         }
-        else if (action[1].IsPlaying())
+        else if (action[0].IsPlaying() || action[1].IsPlaying())
         {
-            auto frame = action[1].GetCurrentFrame();
+            auto frame = action[action[0].IsPlaying() ? 0 : 1].GetCurrentFrame();
             auto f = static_cast<int32_t>(frame);
             auto ki = frame - static_cast<float>(f);
             if (f >= nFrames)
@@ -347,46 +292,19 @@ void AnimationImp::BuildAnimationMatrices()
             }
 
             //-------------------------------------------------------------------------
-            for (int32_t j = 0; j < nbones; j++)
-            {
-                auto &bn = aniInfo->GetBone(j);
-                Matrix tmpMtx;
-                CMatrix inmtx;
-                Quaternion qt;
-                bn.BlendFrame(f, ki, qt);
-                qt.GetMatrix(tmpMtx);
-                inmtx = tmpMtx;
-                inmtx.Pos() = bn.pos0;
-                if (j == 0)
-                    inmtx.Pos() = bn.pos[f] + ki * (bn.pos[f + 1] - bn.pos[f]);
-
-                // Procedural head look
-                if (j == headBoneIndex && isControllableHead)
-                {
-                    inmtx.RotateX(customHeadAX);
-                    inmtx.RotateY(customHeadAY);
-                }
-
-                if (bn.parent)
-                    bn.matrix.EqMultiply(inmtx, CMatrix(bn.parent->matrix));
-                else
-                    bn.matrix = inmtx;
-            }
+            skeleton.BlendFrame(f, ki, pose[0]);
+            BuildBoneMatrices(skeleton.RootPosition(f, ki));
         }
         else
         {
             core.Trace("AnimationImp::BuildAnimationMatrices -> Not support mode");
             psnip_trap();
-            /*_asm int 3;*/
-            //    float frame = 0.0f;
-            //    for(int32_t j = 0; j < nbones; j++)
-            //        aniInfo->GetBone(j).BlendFrame(frame);
         }
     }
     for (int32_t j = 0; j < nbones; j++)
     {
         auto &bn = aniInfo->GetBone(j);
-        matrix[j] = CMatrix(bn.start) * CMatrix(bn.matrix);
+        matrix[j] = CMatrix(bn.start) * boneMatrix[j];
 #ifdef _WIN32 // FIX_LINUX DirectXMath
         // inverse first column in advance
         matrix[j].matrix[0] = -matrix[j].matrix[0];
@@ -397,10 +315,40 @@ void AnimationImp::BuildAnimationMatrices()
     }
 }
 
+// Model space bone matrices from the pose in pose[0]
+void AnimationImp::BuildBoneMatrices(const CVECTOR &rootPos)
+{
+    const auto &skeleton = aniInfo->GetSkeleton();
+    skeleton.BuildLocalMatrices(pose[0], localMatrix);
+    localMatrix[0].Pos() = rootPos;
+    for (int32_t j = 0; j < skeleton.NumJoints(); j++)
+    {
+        auto &inmtx = localMatrix[j];
+
+        // Procedural head look
+        if (j == headBoneIndex && isControllableHead)
+        {
+            inmtx.RotateX(customHeadAX);
+            inmtx.RotateY(customHeadAY);
+        }
+
+        const auto parent = skeleton.Parent(j);
+        if (parent >= 0)
+            boneMatrix[j].EqMultiply(inmtx, boneMatrix[parent]);
+        else
+            boneMatrix[j] = inmtx;
+    }
+}
+
 // Events
 // Send events
 void AnimationImp::SendEvent(AnimationEvent event, int32_t index)
 {
+    if (isDeferEvents)
+    {
+        deferredEvents.push_back({event, index, nullptr});
+        return;
+    }
     for (int32_t i = 0; i < ANIIMP_MAXLISTENERS; i++)
     {
         if (ae_listeners[event][i])
@@ -409,3 +357,23 @@ void AnimationImp::SendEvent(AnimationEvent event, int32_t index)
         }
     }
 }
+
+void AnimationImp::DeferEvents()
+{
+    isDeferEvents = true;
+}
+
+void AnimationImp::FlushEvents()
+{
+    isDeferEvents = false;
+    // listeners may react by changing this animation, the events they raise are sent at once
+    for (size_t i = 0; i < deferredEvents.size(); i++)
+    {
+        const auto &e = deferredEvents[i];
+        if (e.externEvent)
+            AteExtern(e.index, e.externEvent);
+        else
+            SendEvent(e.event, e.index);
+    }
+    deferredEvents.clear();
+}
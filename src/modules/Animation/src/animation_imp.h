@@ -15,6 +15,8 @@
 #include "animation_info.h"
 #include "animation_timer_imp.h"
 
+#include <vector>
+
 #define ANIIMP_MAXLISTENERS 8
 
 class AnimationServiceImp;
@@ -84,6 +86,12 @@ class AnimationImp final : public Animation
     void Execute(int32_t dltTime);
     // Calculate animation matrices
     void BuildAnimationMatrices();
+    // Model space bone matrices from the blended pose
+    void BuildBoneMatrices(const CVECTOR &rootPos);
+    // Queue events instead of sending them, so Execute can run off the main thread
+    void DeferEvents();
+    // Send queued events in the order they were raised and stop queueing
+    void FlushEvents();
     // Get a pointer to the animation srvis
     static AnimationServiceImp *GetAniService();
     // AnimationPlayer events
@@ -115,6 +123,14 @@ class AnimationImp final : public Animation
     // Send events
     void SendEvent(AnimationEvent event, int32_t index);
 
+    struct DeferredEvent
+    {
+        AnimationEvent event;
+        int32_t index;
+        // set for external events
+        const char *externEvent;
+    };
+
     // --------------------------------------------------------------------------------------------
     // Encapsulation
     // --------------------------------------------------------------------------------------------
@@ -133,12 +149,20 @@ class AnimationImp final : public Animation
     bool isUserBlend;
     // Skeleton matrices
     CMatrix *matrix;
+    // Bone positions in model space, kept per animation so instances of one AnimationInfo can run in parallel
+    CMatrix *boneMatrix;
+    // Blended joint rotations and their local matrices
+    SkeletonPose pose[3];
+    CMatrix *localMatrix;
     // Internal event subscribers
     AnimationEventListener *ae_listeners[ae_numevents][ANIIMP_MAXLISTENERS];
     // Subscribers to external events
     AnimationEventListener *ae_listenersExt;
     // Animation Service Pointer
     static AnimationServiceImp *aniService;
+    // Events raised while executing in parallel
+    bool isDeferEvents;
+    std::vector<DeferredEvent> deferredEvents;
 	// Procedural head look
     bool isControllableHead;
     int32_t headBoneIndex;
@@ -243,6 +267,11 @@ inline void AnimationImp::AteTimerstop(int32_t index)
 // External event
 inline void AnimationImp::AteExtern(int32_t plIndex, const char *evt)
 {
+    if (isDeferEvents)
+    {
+        deferredEvents.push_back({ae_numevents, plIndex, evt});
+        return;
+    }
     if (ae_listenersExt)
         ae_listenersExt->Event(this, plIndex, evt);
 }
@@ -56,6 +56,17 @@ ActionInfo *AnimationInfo::AddAction(const char *anctionName, int32_t startframe
     return &actions.emplace_back(anctionName, startframe, endframe);
 }
 
+// Copy bone key frames to the skeleton and release them
+void AnimationInfo::BuildSkeleton()
+{
+    skeleton.Build(bone, numBones, numFrames);
+    for (int32_t i = 0; i < numBones; i++)
+    {
+        auto pos0 = bone[i].pos0;
+        bone[i].SetNumFrames(0, pos0, false);
+    }
+}
+
 // --------------------------------------------------------------------------------------------
 // Working with animation
 // --------------------------------------------------------------------------------------------
@@ -12,12 +12,17 @@
 
 #include "action_info.h"
 #include "bone.h"
+#include "skeleton.h"
 #include "storm_assert.h"
 #include <string>
 #include <vector>
 
+class AnimationCache;
+
 class AnimationInfo final
 {
+    friend AnimationCache;
+
     // --------------------------------------------------------------------------------------------
     // Construction, destruction
     // --------------------------------------------------------------------------------------------
@@ -32,6 +37,8 @@ class AnimationInfo final
     ActionInfo *AddAction(const char *anctionName, int32_t startframe, int32_t endframe);
     // Set execution speed
     void SetFPS(float _fps);
+    // Copy bone key frames to the skeleton and release them
+    void BuildSkeleton();
 
     // --------------------------------------------------------------------------------------------
     // Working with animation
@@ -41,6 +48,8 @@ class AnimationInfo final
     int32_t NumBones();
     // Access to the bone
     Bone &GetBone(int32_t iBone);
+    // Key frames of all bones
+    const Skeleton &GetSkeleton() const;
     // Compare with current name
     bool operator==(const char *animationName);
     // Increment reference count
@@ -73,6 +82,7 @@ class AnimationInfo final
 
     Bone *bone;    // Bones with animation keys
     int32_t numBones; // The number of bones in the skeleton
+    Skeleton skeleton; // Key frames of the bones for evaluation
 
     std::vector<ActionInfo> actions; // Actions
 
@@ -117,6 +127,12 @@ inline Bone &AnimationInfo::GetBone(int32_t iBone)
     return bone[iBone];
 }
 
+// Key frames of all bones
+inline const Skeleton &AnimationInfo::GetSkeleton() const
+{
+    return skeleton;
+}
+
 // Increment reference count
 inline void AnimationInfo::AddRef()
 {
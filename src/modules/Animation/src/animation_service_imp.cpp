@@ -12,6 +12,7 @@
 
 #include "core.h"
 
+#include "animation_cache.h"
 #include "animation_imp.h"
 #include "an_file.h"
 #include "string_compare.hpp"
@@ -19,6 +20,9 @@
 #include "Filesystem/Config/Config.hpp"
 #include "Filesystem/Constants/Paths.hpp"
 
+#include <algorithm>
+#include <execution>
+
 using namespace Storm::Filesystem;
 using namespace Storm::Math;
 
@@ -80,17 +84,21 @@ void AnimationServiceImp::RunStart()
                 ainfo[i] = nullptr;
             }
         }
-    // execute all animations
-    for (auto i = 0; i < animations.size(); i++)
+    // execute all animations, they only share read-only AnimationInfo so run them in parallel
+    std::for_each(std::execution::par, animations.begin(), animations.end(), [dltTime](AnimationImp *ani) {
+        if (!ani)
+            return;
+        ani->DeferEvents();
+        int32_t dt;
+        for (dt = dltTime; dt > ASRV_MAXDLTTIME; dt -= ASRV_MAXDLTTIME)
+            ani->Execute(ASRV_MAXDLTTIME);
+        if (dt > 0)
+            ani->Execute(dt);
+    });
+    // listeners are not thread safe, send the events here in animation order
+    for (size_t i = 0; i < animations.size(); i++)
         if (animations[i])
-        {
-            int32_t dt;
-            for (dt = dltTime; dt > ASRV_MAXDLTTIME; dt -= ASRV_MAXDLTTIME)
-                animations[i]->Execute(ASRV_MAXDLTTIME);
-            if (dt > 0)
-                animations[i]->Execute(dt);
-            // core.Trace("Animation: 0x%.8x Time: %f", animation[i], animation[i]->Player(0).GetPosition());
-        }
+            animations[i]->FlushEvents();
 }
 
 void AnimationServiceImp::RunEnd()
@@ -146,21 +154,59 @@ void AnimationServiceImp::Event(const char *eventName)
 // load animation
 int32_t AnimationServiceImp::LoadAnimation(const char *animationName)
 {
-    std::filesystem::path aniPath{Constants::Paths::animation() / (std::string(animationName) + ".toml")};
-    // Open the ini file describing the animation
-    auto config = Config::Load(aniPath);
+    const std::filesystem::path aniPath{Constants::Paths::animation() / (std::string(animationName) + ".toml")};
+    // Baked copy is used while the sources are unchanged
+    auto *info = AnimationCache::Load(animationName, aniPath);
+    if (!info)
+    {
+        std::string animation_file;
+        info = LoadDescription(animationName, aniPath, animation_file);
+        if (!info)
+        {
+            return -1;
+        }
+        AnimationCache::Save(*info, aniPath, animation_file);
+    }
+
+    // Looking for a free pointer
+    int32_t i;
+    for (i = 0; i < ainfo.size(); i++) {
+        if (ainfo[i] == nullptr) {
+            break;
+        }
+    }
+    // expand the array if not found
+    if (i == ainfo.size()) {
+        ainfo.emplace_back(nullptr);
+    }
+    ainfo[i] = info;
+    return i;
+}
+
+// load animation description and its key frames
+AnimationInfo *AnimationServiceImp::LoadDescription(const char *animationName, const std::filesystem::path &aniPath,
+                                                    std::string &animation_file)
+{
+    // Open the ini file describing the animation, it may be packed
+    const auto file = fio->_MapFile(aniPath.string().c_str());
+    if (!file.IsOpen())
+    {
+        core.Trace("Can't open animation description %s", aniPath.string().c_str());
+        return nullptr;
+    }
+    auto config = Config::Parse(std::string_view(file.Data(), file.Size()), aniPath);
     std::ignore = config.SelectSection("Main");
 
     const auto animation_path_opt = config.Get<std::string>("animation");
     if (!animation_path_opt.has_value()) {
-        return -1;
+        return nullptr;
     }
-    const std::string animation_file = (aniPath.parent_path() / animation_path_opt.value()).string();
+    animation_file = (aniPath.parent_path() / animation_path_opt.value()).string();
     auto *info = new AnimationInfo(animationName);
     if (!LoadAN(animation_file.c_str(), info))
     {
         delete info;
-        return -1;
+        return nullptr;
     }
 
     const auto data_vec = config.Get<std::vector<Types::Vector2<std::string>>>("data", {{}});
@@ -235,127 +281,105 @@ int32_t AnimationServiceImp::LoadAnimation(const char *animationName)
             aciData[data.x] = data.y;
         }
     }
-
-    // Looking for a free pointer
-    int32_t i;
-    for (i = 0; i < ainfo.size(); i++) {
-        if (ainfo[i] == nullptr) {
-            break;
-        }
-    }
-    // expand the array if not found
-    if (i == ainfo.size()) {
-        ainfo.emplace_back(nullptr);
-    }
-    ainfo[i] = info;
-    return i;
+    return info;
 }
 
 // load AN
 bool AnimationServiceImp::LoadAN(const char *fname, AnimationInfo *info)
 {
-    std::fstream fileS;
     try
     {
-        fileS = fio->_CreateFile(fname, std::ios::binary | std::ios::in);
-        if (!fileS.is_open())
+        // The file is read in place
+        const auto file = fio->_MapFile(fname);
+        if (!file.IsOpen())
         {
             core.Trace("Cannot open file: %s", fname);
             return false;
         }
+        const auto view = file.View();
+        size_t offset = 0;
         // Reading the file header
-        ANFILE::HEADER header;
-        if (!fio->_ReadFile(fileS, &header, sizeof(ANFILE::HEADER)) || header.nFrames <= 0 || header.nJoints <= 0 ||
-            header.framesPerSec < 0.0f || header.framesPerSec > 1000.0f)
+        const auto *header = view.Get<ANFILE::HEADER>(offset);
+        if (!header || header->nFrames <= 0 || header->nJoints <= 0 || header->framesPerSec < 0.0f ||
+            header->framesPerSec > 1000.0f)
         {
             core.Trace("Incorrect file header in animation file: %s", fname);
-            fio->_CloseFile(fileS);
             return false;
         }
+        offset += sizeof(ANFILE::HEADER);
         // Set animation time
-        info->SetNumFrames(header.nFrames);
+        info->SetNumFrames(header->nFrames);
         // Set the animation speed
-        info->SetFPS(header.framesPerSec);
+        info->SetFPS(header->framesPerSec);
         // Create the required number of bones
-        info->CreateBones(header.nJoints);
+        info->CreateBones(header->nJoints);
         // Setting parents
-        auto *const prntIndeces = new int32_t[header.nJoints];
-        if (!fio->_ReadFile(fileS, prntIndeces, header.nJoints * sizeof(int32_t)))
+        const auto *prntIndeces = view.Get<int32_t>(offset, header->nJoints);
+        if (!prntIndeces)
         {
             core.Trace("Incorrect parent indeces block in animation file: %s", fname);
-            delete[] prntIndeces;
-            fio->_CloseFile(fileS);
             return false;
         }
-        for (int32_t i = 1; i < header.nJoints; i++)
+        offset += header->nJoints * sizeof(int32_t);
+        for (int32_t i = 1; i < header->nJoints; i++)
         {
-            Assert(prntIndeces[i] >= 0 || prntIndeces[i] < header.nJoints);
+            Assert(prntIndeces[i] >= 0 || prntIndeces[i] < header->nJoints);
             Assert(prntIndeces[i] != i);
             info->GetBone(i).SetParent(&info->GetBone(prntIndeces[i]));
         }
-        delete[] prntIndeces;
         // Starting positions of bones
-        auto *vrt = new CVECTOR[header.nJoints];
-        if (!fio->_ReadFile(fileS, vrt, header.nJoints * sizeof(CVECTOR)))
+        const auto *vrt = view.Get<CVECTOR>(offset, header->nJoints);
+        if (!vrt)
         {
             core.Trace("Incorrect start joints position block block in animation file: %s", fname);
-            delete[] vrt;
-            fio->_CloseFile(fileS);
             return false;
         }
-        for (int32_t i = 0; i < header.nJoints; i++)
+        offset += header->nJoints * sizeof(CVECTOR);
+        for (int32_t i = 0; i < header->nJoints; i++)
         {
-            info->GetBone(i).SetNumFrames(header.nFrames, vrt[i], i == 0);
+            auto pos = vrt[i];
+            info->GetBone(i).SetNumFrames(header->nFrames, pos, i == 0);
         }
-        delete[] vrt;
 
         // Root bone positions
-        vrt = new CVECTOR[header.nFrames];
-        if (!fio->_ReadFile(fileS, vrt, header.nFrames * sizeof(CVECTOR)))
+        vrt = view.Get<CVECTOR>(offset, header->nFrames);
+        if (!vrt)
         {
             core.Trace("Incorrect root joint position block block in animation file: %s", fname);
-            delete[] vrt;
-            fio->_CloseFile(fileS);
             return false;
         }
-        info->GetBone(0).SetPositions(vrt, header.nFrames);
-        delete[] vrt;
+        offset += header->nFrames * sizeof(CVECTOR);
+        info->GetBone(0).SetPositions(vrt, header->nFrames);
 
         // Angles
-        auto *ang = new Quaternion[header.nFrames];
-        for (int32_t i = 0; i < header.nJoints; i++)
+        for (int32_t i = 0; i < header->nJoints; i++)
         {
-            if (!fio->_ReadFile(fileS, ang, header.nFrames * sizeof(*ang)))
+            const auto *ang = view.Get<Quaternion>(offset, header->nFrames);
+            if (!ang)
             {
                 core.Trace("Incorrect joint angle block (%i) block in animation file: %s", i, fname);
-                fio->_CloseFile(fileS);
                 return false;
             }
-            info->GetBone(i).SetAngles(ang, header.nFrames);
+            offset += header->nFrames * sizeof(Quaternion);
+            info->GetBone(i).SetAngles(ang, header->nFrames);
         }
-        delete[] ang;
 
         //-----------------------------------------------
-        for (int32_t i = 0; i < header.nJoints; i++)
+        for (int32_t i = 0; i < header->nJoints; i++)
         {
             info->GetBone(i).BuildStartMatrix();
         }
-        for (int32_t i = 0; i < header.nJoints; i++)
+        for (int32_t i = 0; i < header->nJoints; i++)
         {
             info->GetBone(i).start.Transposition();
         }
+        info->BuildSkeleton();
         //-----------------------------------------------
 
-        // Close the file
-        fio->_CloseFile(fileS);
         return true;
     }
     catch (...)
     {
-        if (fileS.is_open())
-        {
-            fio->_CloseFile(fileS);
-        }
         core.Trace("Error reading animation file: %s", fname);
         return false;
     }
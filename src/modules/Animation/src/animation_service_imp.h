@@ -13,6 +13,9 @@
 #include "animation.h"
 #include "animation_info.h"
 
+#include <filesystem>
+#include <string>
+
 class INIFILE;
 class AnimationImp;
 
@@ -47,6 +50,9 @@ class AnimationServiceImp final : public AnimationService
   private:
     // load animation
     int32_t LoadAnimation(const char *animationName);
+    // load animation description and its key frames
+    AnimationInfo *LoadDescription(const char *animationName, const std::filesystem::path &aniPath,
+                                   std::string &animation_file);
     // load AN
     bool LoadAN(const char *fname, AnimationInfo *info);
 
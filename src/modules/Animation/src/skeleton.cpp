@@ -0,0 +1,268 @@
+// ============================================================================================
+// Storm engine v2.00
+// --------------------------------------------------------------------------------------------
+// Skeleton
+// --------------------------------------------------------------------------------------------
+// Structure-of-arrays copy of the bones of an animation
+// ============================================================================================
+
+#include "skeleton.h"
+
+#include "bone.h"
+
+#include <algorithm>
+#include <emmintrin.h>
+
+namespace
+{
+
+// 4 joint rotations
+struct Quaternion4
+{
+    __m128 x, y, z, w;
+};
+
+// sin(x) for |x| <= PI / 2, Taylor series up to x^11 which keeps it within a float ulp there
+inline __m128 SinHalfPi(__m128 x)
+{
+    const __m128 x2 = _mm_mul_ps(x, x);
+    __m128 r = _mm_set1_ps(-1.0f / 39916800.0f);
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(1.0f / 362880.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(-1.0f / 5040.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(1.0f / 120.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(-1.0f / 6.0f));
+    r = _mm_add_ps(_mm_mul_ps(r, x2), _mm_set1_ps(1.0f));
+    return _mm_mul_ps(r, x);
+}
+
+// Bone::GetFrame for 4 joints
+inline __m128 DecompressAngle(const int16_t *src)
+{
+    const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(src));
+    const __m128 f = _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16));
+    const __m128 a = _mm_mul_ps(_mm_mul_ps(_mm_mul_ps(f, _mm_set1_ps(1.0f / 32767.0f)), _mm_set1_ps(PI)),
+                                _mm_set1_ps(0.5f));
+    return SinHalfPi(a);
+}
+
+inline Quaternion4 Decompress(const int16_t *frame, int32_t paddedJoints, int32_t joint)
+{
+    return {DecompressAngle(frame + joint), DecompressAngle(frame + paddedJoints + joint),
+            DecompressAngle(frame + 2 * paddedJoints + joint), DecompressAngle(frame + 3 * paddedJoints + joint)};
+}
+
+inline Quaternion4 Load(const SkeletonPose &pose, int32_t joint)
+{
+    return {_mm_loadu_ps(&pose.x[joint]), _mm_loadu_ps(&pose.y[joint]), _mm_loadu_ps(&pose.z[joint]),
+            _mm_loadu_ps(&pose.w[joint])};
+}
+
+inline void Store(SkeletonPose &pose, int32_t joint, const Quaternion4 &q)
+{
+    _mm_storeu_ps(&pose.x[joint], q.x);
+    _mm_storeu_ps(&pose.y[joint], q.y);
+    _mm_storeu_ps(&pose.z[joint], q.z);
+    _mm_storeu_ps(&pose.w[joint], q.w);
+}
+
+// Quaternion::SLerp for 4 joints: close rotations take its lerp branch in SIMD,
+// the rest fall back to the scalar slerp
+void Slerp(const Quaternion4 &q0, const Quaternion4 &q1, float kBlend, SkeletonPose &res, int32_t joint)
+{
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 cosomega = _mm_add_ps(_mm_add_ps(_mm_mul_ps(q0.x, q1.x), _mm_mul_ps(q0.y, q1.y)),
+                                       _mm_add_ps(_mm_mul_ps(q0.z, q1.z), _mm_mul_ps(q0.w, q1.w)));
+    // nearest direction
+    const __m128 isNegative = _mm_cmplt_ps(cosomega, _mm_setzero_ps());
+    const __m128 k = _mm_or_ps(_mm_and_ps(isNegative, _mm_set1_ps(-1.0f)), _mm_andnot_ps(isNegative, one));
+    const __m128 absCos = _mm_mul_ps(cosomega, k);
+
+    const __m128 k0 = _mm_mul_ps(_mm_set1_ps(1.0f - kBlend), k);
+    const __m128 k1 = _mm_set1_ps(kBlend);
+    Store(res, joint,
+          {_mm_add_ps(_mm_mul_ps(q0.x, k0), _mm_mul_ps(q1.x, k1)),
+           _mm_add_ps(_mm_mul_ps(q0.y, k0), _mm_mul_ps(q1.y, k1)),
+           _mm_add_ps(_mm_mul_ps(q0.z, k0), _mm_mul_ps(q1.z, k1)),
+           _mm_add_ps(_mm_mul_ps(q0.w, k0), _mm_mul_ps(q1.w, k1))});
+
+    const int32_t slerpMask = _mm_movemask_ps(_mm_cmpgt_ps(_mm_sub_ps(one, absCos), _mm_set1_ps(0.1f)));
+    if (slerpMask == 0)
+        return;
+
+    alignas(16) float a[4][4], b[4][4];
+    _mm_store_ps(a[0], q0.x);
+    _mm_store_ps(a[1], q0.y);
+    _mm_store_ps(a[2], q0.z);
+    _mm_store_ps(a[3], q0.w);
+    _mm_store_ps(b[0], q1.x);
+    _mm_store_ps(b[1], q1.y);
+    _mm_store_ps(b[2], q1.z);
+    _mm_store_ps(b[3], q1.w);
+    for (int32_t i = 0; i < 4; i++)
+        if (slerpMask & (1 << i))
+        {
+            Quaternion qt;
+            qt.SLerp(Quaternion(a[0][i], a[1][i], a[2][i], a[3][i]), Quaternion(b[0][i], b[1][i], b[2][i], b[3][i]),
+                     kBlend);
+            res.x[joint + i] = qt.x;
+            res.y[joint + i] = qt.y;
+            res.z[joint + i] = qt.z;
+            res.w[joint + i] = qt.w;
+        }
+}
+
+} // namespace
+
+// ============================================================================================
+// SkeletonPose
+// ============================================================================================
+
+void SkeletonPose::Resize(int32_t numJoints)
+{
+    x.resize(numJoints, 0.0f);
+    y.resize(numJoints, 0.0f);
+    z.resize(numJoints, 0.0f);
+    w.resize(numJoints, 1.0f);
+}
+
+// ============================================================================================
+// Construction
+// ============================================================================================
+
+void Skeleton::Build(const Bone *bones, int32_t numBones, int32_t frames)
+{
+    numJoints = numBones;
+    paddedJoints = (numBones + 3) & ~3;
+    numFrames = std::max(frames, 0);
+
+    parents.resize(numJoints);
+    jointPos.resize(numJoints);
+    for (int32_t j = 0; j < numJoints; j++)
+    {
+        parents[j] = bones[j].parent ? static_cast<int32_t>(bones[j].parent - bones) : -1;
+        jointPos[j] = bones[j].pos0;
+    }
+
+    // padding joints and bones without frames keep the identity rotation
+    angles.assign(static_cast<size_t>(numFrames) * 4 * paddedJoints, 0);
+    for (int32_t f = 0; f < numFrames; f++)
+    {
+        auto *frame = &angles[static_cast<size_t>(f) * 4 * paddedJoints];
+        for (int32_t j = 0; j < paddedJoints; j++)
+        {
+            if (j < numJoints && bones[j].ang && f < bones[j].numFrames)
+            {
+                frame[j] = bones[j].ang[f].x;
+                frame[paddedJoints + j] = bones[j].ang[f].y;
+                frame[2 * paddedJoints + j] = bones[j].ang[f].z;
+                frame[3 * paddedJoints + j] = bones[j].ang[f].w;
+            }
+            else
+                frame[3 * paddedJoints + j] = 32767;
+        }
+    }
+
+    rootPos.clear();
+    if (numJoints > 0 && bones[0].pos)
+        rootPos.assign(bones[0].pos, bones[0].pos + numFrames);
+}
+
+// ============================================================================================
+// Evaluation
+// ============================================================================================
+
+void Skeleton::BlendFrame(int32_t frame, float kBlend, SkeletonPose &res) const
+{
+    res.Resize(paddedJoints);
+    if (numFrames <= 0)
+    {
+        std::fill(res.x.begin(), res.x.end(), 0.0f);
+        std::fill(res.y.begin(), res.y.end(), 0.0f);
+        std::fill(res.z.begin(), res.z.end(), 0.0f);
+        std::fill(res.w.begin(), res.w.end(), 1.0f);
+        return;
+    }
+
+    const auto stride = static_cast<size_t>(4) * paddedJoints;
+    // past the end there is nothing to blend with
+    if (frame + 1 >= numFrames)
+    {
+        const auto *f0 = &angles[(numFrames - 1) * stride];
+        for (int32_t j = 0; j < paddedJoints; j += 4)
+            Store(res, j, Decompress(f0, paddedJoints, j));
+        return;
+    }
+
+    kBlend = std::clamp(kBlend, 0.0f, 1.0f);
+    const auto *f0 = &angles[frame * stride];
+    const auto *f1 = f0 + stride;
+    for (int32_t j = 0; j < paddedJoints; j += 4)
+        Slerp(Decompress(f0, paddedJoints, j), Decompress(f1, paddedJoints, j), kBlend, res, j);
+}
+
+void Skeleton::Blend(const SkeletonPose &p0, const SkeletonPose &p1, float kBlend, SkeletonPose &res) const
+{
+    res.Resize(paddedJoints);
+    for (int32_t j = 0; j < paddedJoints; j += 4)
+        Slerp(Load(p0, j), Load(p1, j), kBlend, res, j);
+}
+
+CVECTOR Skeleton::RootPosition(int32_t frame, float kBlend) const
+{
+    if (rootPos.empty())
+        return numJoints > 0 ? jointPos[0] : CVECTOR(0.0f, 0.0f, 0.0f);
+    const auto f0 = std::min(frame, numFrames - 1);
+    const auto f1 = std::min(frame + 1, numFrames - 1);
+    return rootPos[f0] + kBlend * (rootPos[f1] - rootPos[f0]);
+}
+
+void Skeleton::BuildLocalMatrices(const SkeletonPose &pose, CMatrix *mtx) const
+{
+    const __m128 two = _mm_set1_ps(2.0f);
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (int32_t j = 0; j < numJoints; j += 4)
+    {
+        // Quaternion::GetMatrix for 4 joints
+        const auto q = Load(pose, j);
+        const __m128 xx = _mm_mul_ps(_mm_mul_ps(q.x, q.x), two);
+        const __m128 xy = _mm_mul_ps(_mm_mul_ps(q.x, q.y), two);
+        const __m128 xz = _mm_mul_ps(_mm_mul_ps(q.x, q.z), two);
+        const __m128 yy = _mm_mul_ps(_mm_mul_ps(q.y, q.y), two);
+        const __m128 yz = _mm_mul_ps(_mm_mul_ps(q.y, q.z), two);
+        const __m128 zz = _mm_mul_ps(_mm_mul_ps(q.z, q.z), two);
+        const __m128 wx = _mm_mul_ps(_mm_mul_ps(q.w, q.x), two);
+        const __m128 wy = _mm_mul_ps(_mm_mul_ps(q.w, q.y), two);
+        const __m128 wz = _mm_mul_ps(_mm_mul_ps(q.w, q.z), two);
+
+        alignas(16) float m[9][4];
+        _mm_store_ps(m[0], _mm_sub_ps(one, _mm_add_ps(yy, zz)));
+        _mm_store_ps(m[1], _mm_add_ps(xy, wz));
+        _mm_store_ps(m[2], _mm_sub_ps(xz, wy));
+        _mm_store_ps(m[3], _mm_sub_ps(xy, wz));
+        _mm_store_ps(m[4], _mm_sub_ps(one, _mm_add_ps(xx, zz)));
+        _mm_store_ps(m[5], _mm_add_ps(yz, wx));
+        _mm_store_ps(m[6], _mm_add_ps(xz, wy));
+        _mm_store_ps(m[7], _mm_sub_ps(yz, wx));
+        _mm_store_ps(m[8], _mm_sub_ps(one, _mm_add_ps(xx, yy)));
+
+        const auto num = std::min(4, numJoints - j);
+        for (int32_t i = 0; i < num; i++)
+        {
+            auto &res = mtx[j + i];
+            res.m[0][0] = m[0][i];
+            res.m[0][1] = m[1][i];
+            res.m[0][2] = m[2][i];
+            res.m[0][3] = 0.0f;
+            res.m[1][0] = m[3][i];
+            res.m[1][1] = m[4][i];
+            res.m[1][2] = m[5][i];
+            res.m[1][3] = 0.0f;
+            res.m[2][0] = m[6][i];
+            res.m[2][1] = m[7][i];
+            res.m[2][2] = m[8][i];
+            res.m[2][3] = 0.0f;
+            res.Pos() = jointPos[j + i];
+            res.m[3][3] = 1.0f;
+        }
+    }
+}
@@ -0,0 +1,93 @@
+// ============================================================================================
+// Storm engine v2.00
+// --------------------------------------------------------------------------------------------
+// Skeleton
+// --------------------------------------------------------------------------------------------
+// Structure-of-arrays copy of the bones of an animation: key frames are stored per frame
+// with every joint side by side, so a whole pose is decompressed and blended 4 joints at a time
+// ============================================================================================
+
+#pragma once
+
+#include "matrix.h"
+
+#include <cstdint>
+#include <vector>
+
+class Bone;
+class AnimationCache;
+
+// Joint rotations of one pose, a quaternion component per array
+struct SkeletonPose
+{
+    std::vector<float> x, y, z, w;
+
+    void Resize(int32_t numJoints);
+};
+
+class Skeleton
+{
+    friend AnimationCache;
+
+    // --------------------------------------------------------------------------------------------
+    // Construction
+    // --------------------------------------------------------------------------------------------
+  public:
+    // Copy key frames from bones, all of them must have numFrames frames
+    void Build(const Bone *bones, int32_t numBones, int32_t numFrames);
+
+    // --------------------------------------------------------------------------------------------
+    // Evaluation
+    // --------------------------------------------------------------------------------------------
+  public:
+    // Number of joints
+    int32_t NumJoints() const;
+    // Joint count rounded up for SIMD, the size SkeletonPose arrays must have
+    int32_t PaddedJoints() const;
+    // Parent joint, -1 for root
+    int32_t Parent(int32_t joint) const;
+    // Rotations of all joints between frame and frame + 1, same as Bone::BlendFrame
+    void BlendFrame(int32_t frame, float kBlend, SkeletonPose &res) const;
+    // Blend two poses joint by joint, same as Quaternion::SLerp
+    void Blend(const SkeletonPose &p0, const SkeletonPose &p1, float kBlend, SkeletonPose &res) const;
+    // Root position between frame and frame + 1
+    CVECTOR RootPosition(int32_t frame, float kBlend) const;
+    // Local matrix of each joint: pose rotation and start position
+    void BuildLocalMatrices(const SkeletonPose &pose, CMatrix *mtx) const;
+
+    // --------------------------------------------------------------------------------------------
+    // Encapsulation
+    // --------------------------------------------------------------------------------------------
+  private:
+    int32_t numJoints = 0;
+    int32_t paddedJoints = 0;
+    int32_t numFrames = 0;
+
+    // Compressed angles, [frame][x, y, z, w][joint]
+    std::vector<int16_t> angles;
+    // Root joint positions, [frame]
+    std::vector<CVECTOR> rootPos;
+    // Start positions, [joint]
+    std::vector<CVECTOR> jointPos;
+    // Parent joints, [joint]
+    std::vector<int32_t> parents;
+};
+
+//============================================================================================
+// inline
+//============================================================================================
+
+inline int32_t Skeleton::NumJoints() const
+{
+    return numJoints;
+}
+
+inline int32_t Skeleton::PaddedJoints() const
+{
+    return paddedJoints;
+}
+
+inline int32_t Skeleton::Parent(int32_t joint) const
+{
+    return parents[joint];
+}
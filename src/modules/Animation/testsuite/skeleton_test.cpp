@@ -0,0 +1,243 @@
+#include "bone.h"
+#include "skeleton.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+// Bones with random key frames and the skeleton built from them, as AnimationInfo has them
+struct Rig
+{
+    std::unique_ptr<Bone[]> bones;
+    int32_t numBones;
+    int32_t numFrames;
+    Skeleton skeleton;
+};
+
+Quaternion Normalized(float x, float y, float z, float w)
+{
+    const auto k = 1.0f / sqrtf(x * x + y * y + z * z + w * w);
+    return Quaternion(x * k, y * k, z * k, w * k);
+}
+
+// Every joint hangs off an earlier one. Frame to frame a joint turns a little (the lerp branch of the slerp),
+// jumps to any rotation (the slerp branch) or keeps its rotation with the sign flipped (the nearest direction)
+Rig MakeRig(std::mt19937 &rng, int32_t numBones, int32_t numFrames)
+{
+    std::normal_distribution<float> normal;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const auto randomQt = [&] { return Normalized(normal(rng), normal(rng), normal(rng), normal(rng)); };
+
+    Rig rig{std::make_unique<Bone[]>(numBones), numBones, numFrames, {}};
+    std::vector<Quaternion> angles(numFrames);
+    std::vector<CVECTOR> positions(numFrames);
+    for (int32_t j = 0; j < numBones; j++)
+    {
+        auto &bone = rig.bones[j];
+        bone.SetParent(j > 0 ? &rig.bones[rng() % j] : nullptr);
+        CVECTOR pos0(unit(rng) - 0.5f, unit(rng), unit(rng) - 0.5f);
+        bone.SetNumFrames(numFrames, pos0, j == 0);
+
+        angles[0] = randomQt();
+        for (int32_t f = 1; f < numFrames; f++)
+        {
+            const auto &q = angles[f - 1];
+            const auto kind = unit(rng);
+            if (kind < 0.6f)
+                angles[f] = Normalized(q.x + normal(rng) * 0.1f, q.y + normal(rng) * 0.1f, q.z + normal(rng) * 0.1f,
+                                       q.w + normal(rng) * 0.1f);
+            else if (kind < 0.9f)
+                angles[f] = randomQt();
+            else
+                angles[f] = Quaternion(-q.x, -q.y, -q.z, -q.w);
+        }
+        bone.SetAngles(angles.data(), numFrames);
+
+        if (j == 0)
+        {
+            for (auto &p : positions)
+                p = CVECTOR(unit(rng) * 4.0f - 2.0f, unit(rng), unit(rng) * 4.0f - 2.0f);
+            bone.SetPositions(positions.data(), numFrames);
+        }
+    }
+    rig.skeleton.Build(rig.bones.get(), numBones, numFrames);
+    return rig;
+}
+
+bool Near(float value, float expected, float tolerance)
+{
+    return std::fabs(value - expected) <= tolerance * std::max(1.0f, std::fabs(expected));
+}
+
+bool Near(const SkeletonPose &pose, int32_t joint, const Quaternion &q)
+{
+    return Near(pose.x[joint], q.x, 1e-5f) && Near(pose.y[joint], q.y, 1e-5f) && Near(pose.z[joint], q.z, 1e-5f) &&
+           Near(pose.w[joint], q.w, 1e-5f);
+}
+
+// the joint counts round up to 4, the first and last blocks are partly padding
+constexpr int32_t kNumBones[] = {1, 2, 3, 4, 5, 13, 58};
+constexpr float kBlends[] = {-0.25f, 0.0f, 0.3f, 0.5f, 0.99f, 1.0f, 1.25f};
+} // namespace
+
+TEST_CASE("Skeleton frames match the bones", "[skeleton]")
+{
+    std::mt19937 rng(9);
+    for (const auto numBones : kNumBones)
+    {
+        for (const auto numFrames : {1, 2, 9})
+        {
+            auto rig = MakeRig(rng, numBones, numFrames);
+            const auto &skeleton = rig.skeleton;
+            REQUIRE(skeleton.NumJoints() == numBones);
+            REQUIRE(skeleton.PaddedJoints() == (numBones + 3) / 4 * 4);
+
+            SkeletonPose pose;
+            // past the last frame too, where both hold the last one
+            for (int32_t frame = 0; frame <= numFrames; frame++)
+            {
+                for (const auto kBlend : kBlends)
+                {
+                    skeleton.BlendFrame(frame, kBlend, pose);
+                    REQUIRE(static_cast<int32_t>(pose.x.size()) == skeleton.PaddedJoints());
+                    for (int32_t j = 0; j < numBones; j++)
+                    {
+                        Quaternion q;
+                        rig.bones[j].BlendFrame(frame, kBlend, q);
+                        INFO(numBones << " bones, " << numFrames << " frames, frame " << frame << ", blend "
+                                      << kBlend << ", joint " << j);
+                        CHECK(Near(pose, j, q));
+                    }
+                    // padding joints stay at the identity
+                    for (int32_t j = numBones; j < skeleton.PaddedJoints(); j++)
+                        CHECK(Near(pose, j, Quaternion(0.0f, 0.0f, 0.0f, 1.0f)));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Skeleton pose blend matches Quaternion::SLerp", "[skeleton]")
+{
+    std::mt19937 rng(10);
+    for (const auto numBones : kNumBones)
+    {
+        auto rig = MakeRig(rng, numBones, 12);
+        const auto &skeleton = rig.skeleton;
+        SkeletonPose pose0, pose1, pose;
+        for (int32_t n = 0; n < 20; n++)
+        {
+            const auto f0 = static_cast<int32_t>(rng() % 11);
+            const auto f1 = static_cast<int32_t>(rng() % 11);
+            const auto k0 = kBlends[rng() % std::size(kBlends)];
+            const auto k1 = kBlends[rng() % std::size(kBlends)];
+            skeleton.BlendFrame(f0, k0, pose0);
+            skeleton.BlendFrame(f1, k1, pose1);
+            for (const auto kBlend : {0.0f, 0.2f, 0.5f, 0.75f, 1.0f})
+            {
+                skeleton.Blend(pose0, pose1, kBlend, pose);
+                for (int32_t j = 0; j < numBones; j++)
+                {
+                    Quaternion q0, q1, q;
+                    rig.bones[j].BlendFrame(f0, k0, q0);
+                    rig.bones[j].BlendFrame(f1, k1, q1);
+                    q.SLerp(q0, q1, kBlend);
+                    INFO(numBones << " bones, frames " << f0 << " and " << f1 << ", blend " << kBlend << ", joint "
+                                  << j);
+                    CHECK(Near(pose, j, q));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Skeleton matrices match Bone::BuildMatrix", "[skeleton]")
+{
+    std::mt19937 rng(11);
+    for (const auto numBones : kNumBones)
+    {
+        auto rig = MakeRig(rng, numBones, 9);
+        const auto &skeleton = rig.skeleton;
+        SkeletonPose pose;
+        std::vector<CMatrix> local(numBones), bone(numBones);
+        for (int32_t frame = 0; frame + 1 < rig.numFrames; frame++)
+        {
+            for (const auto kBlend : {0.0f, 0.4f, 1.0f})
+            {
+                // as AnimationImp::BuildBoneMatrices
+                skeleton.BlendFrame(frame, kBlend, pose);
+                skeleton.BuildLocalMatrices(pose, local.data());
+                local[0].Pos() = skeleton.RootPosition(frame, kBlend);
+                for (int32_t j = 0; j < numBones; j++)
+                {
+                    const auto parent = skeleton.Parent(j);
+                    if (parent >= 0)
+                        bone[j].EqMultiply(local[j], bone[parent]);
+                    else
+                        bone[j] = local[j];
+                }
+
+                // as AnimationImp::BuildAnimationMatrices did before the skeleton
+                for (int32_t j = 0; j < numBones; j++)
+                {
+                    auto &bn = rig.bones[j];
+                    bn.BlendFrame(frame, kBlend, bn.a);
+                    bn.p = j == 0 ? bn.pos[frame] + kBlend * (bn.pos[frame + 1] - bn.pos[frame]) : bn.pos0;
+                    bn.BuildMatrix();
+                }
+
+                for (int32_t j = 0; j < numBones; j++)
+                {
+                    INFO(numBones << " bones, frame " << frame << ", blend " << kBlend << ", joint " << j);
+                    REQUIRE(skeleton.Parent(j) == (j > 0 ? static_cast<int32_t>(rig.bones[j].parent - rig.bones.get())
+                                                         : -1));
+                    for (int32_t r = 0; r < 4; r++)
+                        for (int32_t c = 0; c < 4; c++)
+                            CHECK(Near(bone[j].m[r][c], rig.bones[j].matrix.m[r][c], 1e-4f));
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Skeleton against the bones", "[skeleton][benchmark]")
+{
+    // a character skeleton, two actions blended as AnimationImp does
+    std::mt19937 rng(12);
+    auto rig = MakeRig(rng, 58, 200);
+    SkeletonPose pose0, pose1, pose;
+    std::vector<CMatrix> local(rig.numBones);
+
+    BENCHMARK("bones")
+    {
+        for (int32_t j = 0; j < rig.numBones; j++)
+        {
+            auto &bn = rig.bones[j];
+            Quaternion q0, q1;
+            bn.BlendFrame(37, 0.3f, q0);
+            bn.BlendFrame(121, 0.8f, q1);
+            bn.a.SLerp(q0, q1, 0.4f);
+            bn.p = bn.pos0;
+            bn.BuildMatrix();
+        }
+        return rig.bones[rig.numBones - 1].matrix.m[3][0];
+    };
+
+    BENCHMARK("skeleton")
+    {
+        rig.skeleton.BlendFrame(37, 0.3f, pose0);
+        rig.skeleton.BlendFrame(121, 0.8f, pose1);
+        rig.skeleton.Blend(pose0, pose1, 0.4f, pose);
+        rig.skeleton.BuildLocalMatrices(pose, local.data());
+        for (int32_t j = 1; j < rig.numBones; j++)
+            local[j].EqMultiply(CMatrix(local[j]), local[rig.skeleton.Parent(j)]);
+        return local[rig.numBones - 1].m[3][0];
+    };
+}
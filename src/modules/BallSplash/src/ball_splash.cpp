@@ -5,7 +5,7 @@
 #include "core.h"
 
 //--------------------------------------------------------------------
-BALLSPLASH::BALLSPLASH() : renderer(nullptr), sea(nullptr)
+BALLSPLASH::BALLSPLASH() : renderer(nullptr), topTechnique(-1), sea(nullptr)
 {
 }
 
@@ -25,6 +25,7 @@ bool BALLSPLASH::Init()
     sea = static_cast<SEA_BASE *>(core.GetEntityPointer(core.GetEntityId("sea")));
 
     renderer = static_cast<VDX9RENDER *>(core.GetService("dx9render"));
+    topTechnique = renderer->TechniqueGetHandle("splash2");
 
     // core.CreateEntity(&arrowModel,"MODELR");
     // core.Send_Message(arrowModel,"ls",MSG_MODEL_LOAD_GEO, "fish01");
@@ -94,7 +95,7 @@ void BALLSPLASH::Realize(uint32_t _dTime)
     splashes[lastProcessed].Realize(_dTime);
 
     // draw top part
-    const auto techniqueStarted = renderer->TechniqueExecuteStart("splash2");
+    const auto techniqueStarted = renderer->TechniqueExecuteStart(topTechnique);
     TSplash::startRender = true;
     TSplash::topIndex = 0;
     lastProcessed = -1;
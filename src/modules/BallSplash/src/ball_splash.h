@@ -45,5 +45,6 @@ class BALLSPLASH : public Entity
 
     TSplash splashes[MAX_SPLASHES];
     VDX9RENDER *renderer;
+    int32_t topTechnique;
     SEA_BASE *sea;
 };
@@ -408,6 +408,7 @@ void BATTLE_NAVIGATOR::Init(VDX9RENDER *RenderService, Entity *pOwnerEI)
     if (RenderService == nullptr)
         return;
     rs = RenderService;
+    m_idIslandTechnique = rs->TechniqueGetHandle("battle_island_gettexture");
 
     m_dwChargeCannon = ARGB(255, 255, 0, 0);
     m_dwReadyCannon = ARGB(255, 0, 255, 0);
@@ -1371,7 +1372,7 @@ void BATTLE_NAVIGATOR::SetIsland()
                         // fill fone color
                         rs->Clear(0, nullptr, D3DCLEAR_TARGET, m_dwSeaColor, 1.f, 0);
                         // show island
-                        if (rs->TechniqueExecuteStart("battle_island_gettexture"))
+                        if (rs->TechniqueExecuteStart(m_idIslandTechnique))
                         {
                             pM->ProcessStage(Entity::Stage::realize, 1);
                             while (rs->TechniqueExecuteNext())
@@ -31,7 +31,7 @@ class BLADE : public Entity
 
         BLADE_INFO();
         ~BLADE_INFO();
-        void DrawBlade(VDX9RENDER *rs, unsigned int blendValue, MODEL *mdl, NODE *manNode);
+        void DrawBlade(VDX9RENDER *rs, int32_t technique, unsigned int blendValue, MODEL *mdl, NODE *manNode);
         bool LoadBladeModel(MESSAGE &message);
 
         std::string id_;
@@ -67,6 +67,7 @@ class BLADE : public Entity
     };
 
     VDX9RENDER *rs;
+    int32_t bladeTechnique = -1;
     COLLIDE *col;
     entid_t man;
     unsigned int blendValue;
@@ -40,7 +40,8 @@ BLADE::BLADE_INFO::~BLADE_INFO()
     core.EraseEntity(parentEntityId_);
 }
 
-void BLADE::BLADE_INFO::DrawBlade(VDX9RENDER *rs, unsigned int blendValue, MODEL *mdl, NODE *manNode)
+void BLADE::BLADE_INFO::DrawBlade(VDX9RENDER *rs, int32_t technique, unsigned int blendValue, MODEL *mdl,
+                                   NODE *manNode)
 {
     auto *obj = static_cast<MODEL *>(core.GetEntityPointer(parentEntityId_));
     if (obj == nullptr)
@@ -152,7 +153,7 @@ void BLADE::BLADE_INFO::DrawBlade(VDX9RENDER *rs, unsigned int blendValue, MODEL
             vrt[1].diffuse = color[0];
             vrtTime[0] = time;
 
-            auto bDraw = rs->TechniqueExecuteStart("Blade");
+            auto bDraw = rs->TechniqueExecuteStart(technique);
             if (bDraw)
             {
                 if (first > 0)
@@ -245,6 +246,7 @@ bool BLADE::Init()
     rs = static_cast<VDX9RENDER *>(core.GetService("dx9render"));
     if (!rs)
         throw std::runtime_error("No service: dx9render");
+    bladeTechnique = rs->TechniqueGetHandle("Blade");
 
     // UNGUARD
     return true;
@@ -332,8 +334,8 @@ void BLADE::Realize(uint32_t Delta_Time)
 
     //------------------------------------------------------
     // draw saber
-    blades_[0].DrawBlade(rs, blendValue, mdl, manNode);
-    blades_[1].DrawBlade(rs, blendValue, mdl, manNode);
+    blades_[0].DrawBlade(rs, bladeTechnique, blendValue, mdl, manNode);
+    blades_[1].DrawBlade(rs, bladeTechnique, blendValue, mdl, manNode);
 
     //------------------------------------------------------
     // draw tied items
@@ -8,6 +8,8 @@
 #include "types3d.h"
 #include "vma.hpp"
 
+#include <span>
+
 class LOCAL_COLLIDE
 {
   public:
@@ -23,6 +25,18 @@ class LOCAL_COLLIDE
     virtual float Trace(const CVECTOR &src, const CVECTOR &dst) = 0;
 };
 
+struct TRACE_RAY
+{
+    CVECTOR src;
+    CVECTOR dst;
+};
+
+struct TRACE_HIT
+{
+    float dist = 2.0f;             // fraction of src-dst, > 1.0 if nothing was hit
+    entid_t eid = invalid_entity; // hit entity
+};
+
 class COLLIDE : public SERVICE
 {
   public:
@@ -36,6 +50,15 @@ class COLLIDE : public SERVICE
     virtual float Trace(entity_container_cref entities, const CVECTOR &src, const CVECTOR &dst,
                         const entid_t *exclude_list, int32_t exclude_num) = 0;
 
+    // same as above, hit entity is returned with the result instead of through GetObjectID
+    virtual TRACE_HIT TraceHit(entity_container_cref entities, const CVECTOR &src, const CVECTOR &dst,
+                               const entid_t *exclude_list, int32_t exclude_num) = 0;
+
+    // trace every ray of the batch, hits[i] gets the result for rays[i]
+    // thread safe objects are traced on worker threads, all others serially on the calling thread
+    virtual void TraceBatch(entity_container_cref entities, std::span<const TRACE_RAY> rays,
+                            std::span<TRACE_HIT> hits, const entid_t *exclude_list, int32_t exclude_num) = 0;
+
     virtual bool Clip(entity_container_cref entities, const PLANE *planes, int32_t nplanes, const CVECTOR &center,
                       float radius, ADD_POLYGON_FUNC addpoly, const entid_t *exclude_list, int32_t exclude_num) = 0;
 
@@ -5,6 +5,8 @@
 #include "triangle.h"
 #include "types3d.h"
 
+#include <vector>
+
 using ADD_POLYGON_FUNC = bool (*)(const CVECTOR *v, int32_t nv);
 
 class COLLISION_OBJECT : public Entity
@@ -19,9 +21,55 @@ class COLLISION_OBJECT : public Entity
     CMatrix mtx;
 
     virtual float Trace(const CVECTOR &src, const CVECTOR &dst) = 0;
+
+    // objects that return true here can be traced with TraceThreadSafe from several threads at once
+    virtual bool IsTraceThreadSafe() const
+    {
+        return false;
+    }
+
+    // trace that keeps no state: GetCollideMaterialName / GetCollideTriangle are not updated by it
+    virtual float TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const
+    {
+        return 2.0f;
+    }
     virtual bool Clip(const PLANE *planes, int32_t nplanes, const CVECTOR &center, float radius,
                       ADD_POLYGON_FUNC addpoly) = 0;
 
+    // world space sphere enclosing everything Trace / Clip can hit, used to skip the object early
+    // objects returning false are always tested, the others must call BoundsChanged when the sphere changes
+    virtual bool GetBoundSphere(CVECTOR &center, float &radius) const
+    {
+        return false;
+    }
+
+    // objects whose bound sphere changed since the collide service last took them
+    static std::vector<entid_t> &ChangedBounds()
+    {
+        static std::vector<entid_t> changed;
+        return changed;
+    }
+
+    // called by the collide service once it took the new bound sphere
+    void AcceptBounds()
+    {
+        boundsChanged_ = false;
+    }
+
     virtual const char *GetCollideMaterialName() = 0;
     virtual bool GetCollideTriangle(TRIANGLE &triangle) = 0;
+
+  protected:
+    // the object is listed once until the collide service takes its new bound sphere
+    void BoundsChanged()
+    {
+        if (!boundsChanged_)
+        {
+            boundsChanged_ = true;
+            ChangedBounds().push_back(GetId());
+        }
+    }
+
+  private:
+    bool boundsChanged_{};
 };
@@ -0,0 +1,205 @@
+#include "broad_phase.h"
+
+#include <cmath>
+
+namespace
+{
+// a ship is a few cells, a character or a ball a single one
+constexpr float kCellSize = 32.0f;
+// objects covering more cells (islands, locations) are tested by every query instead
+constexpr int32_t kMaxObjectCells = 64;
+// queries covering more cells test the bound spheres of all objects instead
+constexpr int32_t kMaxQueryCells = 256;
+// farther coordinates would overflow the cell indices
+constexpr float kMaxCoordinate = 1.0e7f;
+
+int32_t Cell(float coordinate)
+{
+    return static_cast<int32_t>(std::floor(coordinate * (1.0f / kCellSize)));
+}
+
+bool IsFar(float minX, float minZ, float maxX, float maxZ)
+{
+    // false for NaN as well
+    return !(minX >= -kMaxCoordinate && minZ >= -kMaxCoordinate && maxX <= kMaxCoordinate && maxZ <= kMaxCoordinate);
+}
+} // namespace
+
+bool BroadPhase::Matches(entity_container_cref entities) const
+{
+    return ids_ == entities;
+}
+
+void BroadPhase::Build(entity_container_cref entities, std::span<COLLISION_OBJECT *const> objects)
+{
+    ids_ = entities;
+    slots_.clear();
+    slotOf_.clear();
+    cells_.clear();
+    loose_.clear();
+    query_ = 0;
+
+    slots_.reserve(entities.size());
+    for (size_t i = 0; i < entities.size(); i++)
+    {
+        // a listed twice entity is tested once
+        if (objects[i] == nullptr || slotOf_.contains(entities[i]))
+            continue;
+        const auto slot = static_cast<uint32_t>(slots_.size());
+        slots_.push_back(Slot{TraceCandidate(entities[i], objects[i]), 0, 0, 0, 0, false, 0, 0});
+        slotOf_.emplace(entities[i], slot);
+        Insert(slot);
+    }
+}
+
+void BroadPhase::Move(entid_t eid)
+{
+    const auto it = slotOf_.find(eid);
+    if (it == slotOf_.end())
+        return;
+    auto &slot = slots_[it->second];
+    Remove(it->second);
+    slot.object = TraceCandidate(eid, slot.object.cob);
+    Insert(it->second);
+}
+
+void BroadPhase::BeginQuery(const entid_t *exclude_list, int32_t exclude_num)
+{
+    // wrapped around, the old stamps could match again
+    if (++query_ == 0)
+    {
+        for (auto &slot : slots_)
+            slot.visit = slot.excluded = 0;
+        query_ = 1;
+    }
+    for (int32_t i = 0; i < exclude_num; i++)
+    {
+        if (const auto it = slotOf_.find(exclude_list[i]); it != slotOf_.end())
+            slots_[it->second].excluded = query_;
+    }
+}
+
+void BroadPhase::Query(float minX, float minZ, float maxX, float maxZ, std::vector<TraceCandidate> &candidates)
+{
+    found_.clear();
+    const auto x0 = Cell(minX), z0 = Cell(minZ), x1 = Cell(maxX), z1 = Cell(maxZ);
+    if (IsFar(minX, minZ, maxX, maxZ) ||
+        static_cast<int64_t>(x1 - x0 + 1) * static_cast<int64_t>(z1 - z0 + 1) > kMaxQueryCells)
+    {
+        for (uint32_t i = 0; i < slots_.size(); i++)
+        {
+            if (slots_[i].excluded != query_ && Overlaps(slots_[i], minX, minZ, maxX, maxZ))
+                found_.push_back(i);
+        }
+    }
+    else
+    {
+        for (auto x = x0; x <= x1; x++)
+        {
+            for (auto z = z0; z <= z1; z++)
+            {
+                const auto cell = cells_.find(CellKey(x, z));
+                if (cell == cells_.end())
+                    continue;
+                for (const auto i : cell->second)
+                {
+                    auto &slot = slots_[i];
+                    if (slot.visit == query_ || slot.excluded == query_)
+                        continue;
+                    slot.visit = query_;
+                    if (Overlaps(slot, minX, minZ, maxX, maxZ))
+                        found_.push_back(i);
+                }
+            }
+        }
+        for (const auto i : loose_)
+        {
+            if (slots_[i].excluded != query_ && Overlaps(slots_[i], minX, minZ, maxX, maxZ))
+                found_.push_back(i);
+        }
+        // same order as the list, so ties are resolved as by a linear scan
+        std::ranges::sort(found_);
+    }
+
+    for (const auto i : found_)
+        candidates.push_back(slots_[i].object);
+}
+
+void BroadPhase::QuerySegment(const CVECTOR &src, const CVECTOR &dst, std::vector<TraceCandidate> &candidates)
+{
+    Query(std::min(src.x, dst.x), std::min(src.z, dst.z), std::max(src.x, dst.x), std::max(src.z, dst.z),
+          candidates);
+}
+
+void BroadPhase::QuerySphere(const CVECTOR &center, float radius, std::vector<TraceCandidate> &candidates)
+{
+    Query(center.x - radius, center.z - radius, center.x + radius, center.z + radius, candidates);
+}
+
+size_t BroadPhase::NumObjects() const
+{
+    return slots_.size();
+}
+
+uint64_t BroadPhase::CellKey(int32_t x, int32_t z)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+}
+
+void BroadPhase::Insert(uint32_t i)
+{
+    auto &slot = slots_[i];
+    const auto &object = slot.object;
+    slot.loose = true;
+    if (object.bounded)
+    {
+        const float minX = object.center.x - object.radius, maxX = object.center.x + object.radius;
+        const float minZ = object.center.z - object.radius, maxZ = object.center.z + object.radius;
+        if (!IsFar(minX, minZ, maxX, maxZ))
+        {
+            slot.x0 = Cell(minX);
+            slot.z0 = Cell(minZ);
+            slot.x1 = Cell(maxX);
+            slot.z1 = Cell(maxZ);
+            slot.loose = (slot.x1 - slot.x0 + 1) * (slot.z1 - slot.z0 + 1) > kMaxObjectCells;
+        }
+    }
+
+    if (slot.loose)
+    {
+        loose_.push_back(i);
+        return;
+    }
+    for (auto x = slot.x0; x <= slot.x1; x++)
+        for (auto z = slot.z0; z <= slot.z1; z++)
+            cells_[CellKey(x, z)].push_back(i);
+}
+
+void BroadPhase::Remove(uint32_t i)
+{
+    const auto &slot = slots_[i];
+    if (slot.loose)
+    {
+        std::erase(loose_, i);
+        return;
+    }
+    for (auto x = slot.x0; x <= slot.x1; x++)
+    {
+        for (auto z = slot.z0; z <= slot.z1; z++)
+        {
+            // the cells behind a moving ship are dropped, the grid does not grow over a voyage
+            const auto cell = cells_.find(CellKey(x, z));
+            if (cell != cells_.end() && std::erase(cell->second, i) > 0 && cell->second.empty())
+                cells_.erase(cell);
+        }
+    }
+}
+
+bool BroadPhase::Overlaps(const Slot &slot, float minX, float minZ, float maxX, float maxZ) const
+{
+    const auto &object = slot.object;
+    if (!object.bounded)
+        return true;
+    return object.center.x + object.radius >= minX && object.center.x - object.radius <= maxX &&
+           object.center.z + object.radius >= minZ && object.center.z - object.radius <= maxZ;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "object.h"
+
+#include <algorithm>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+// collision object with its bounding sphere taken when it was binned
+struct TraceCandidate
+{
+    entid_t eid;
+    COLLISION_OBJECT *cob;
+    CVECTOR center;
+    float radius;
+    bool bounded;
+
+    TraceCandidate(entid_t eid, COLLISION_OBJECT *cob) : eid(eid), cob(cob)
+    {
+        bounded = cob->GetBoundSphere(center, radius);
+    }
+
+    bool TouchesSegment(const CVECTOR &src, const CVECTOR &dst) const
+    {
+        if (!bounded)
+            return true;
+        const auto dir = dst - src;
+        const auto len2 = ~dir;
+        const auto t = len2 > 0.0f ? std::clamp(((center - src) | dir) / len2, 0.0f, 1.0f) : 0.0f;
+        return ~(center - (src + dir * t)) <= radius * radius;
+    }
+
+    bool TouchesSphere(const CVECTOR &c, float r) const
+    {
+        return !bounded || ~(center - c) <= (radius + r) * (radius + r);
+    }
+};
+
+// Collision objects of one entity list binned by their bound spheres into a uniform grid over the XZ plane.
+// The grid is built again when the list changes, an object is moved to its new cells when it reports a move
+class BroadPhase final
+{
+  public:
+    // true if the grid was built for a list with the same entities in the same order
+    [[nodiscard]] bool Matches(entity_container_cref entities) const;
+    // objects[i] is the object of entities[i], nullptr if it is gone
+    void Build(entity_container_cref entities, std::span<COLLISION_OBJECT *const> objects);
+    // takes the bound sphere of the object again, if it is in the grid
+    void Move(entid_t eid);
+
+    // starts a query, the listed entities are left out of it
+    void BeginQuery(const entid_t *exclude_list, int32_t exclude_num);
+    // appends the objects whose bound sphere may touch the box in list order, unbounded objects included
+    void Query(float minX, float minZ, float maxX, float maxZ, std::vector<TraceCandidate> &candidates);
+    void QuerySegment(const CVECTOR &src, const CVECTOR &dst, std::vector<TraceCandidate> &candidates);
+    void QuerySphere(const CVECTOR &center, float radius, std::vector<TraceCandidate> &candidates);
+
+    [[nodiscard]] size_t NumObjects() const;
+
+  private:
+    struct Slot
+    {
+        TraceCandidate object;
+        int32_t x0, z0, x1, z1;
+        // unbounded or spanning too many cells, tested by every query
+        bool loose;
+        uint32_t visit;
+        uint32_t excluded;
+    };
+
+    static uint64_t CellKey(int32_t x, int32_t z);
+    void Insert(uint32_t slot);
+    void Remove(uint32_t slot);
+    bool Overlaps(const Slot &slot, float minX, float minZ, float maxX, float maxZ) const;
+
+    std::vector<entid_t> ids_;
+    std::vector<Slot> slots_;
+    std::unordered_map<entid_t, uint32_t> slotOf_;
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cells_;
+    std::vector<uint32_t> loose_;
+    std::vector<uint32_t> found_;
+    uint32_t query_ = 0;
+};
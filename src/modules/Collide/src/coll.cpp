@@ -1,7 +1,18 @@
 #include "core.h"
 #include "vcollide.h"
 
-entid_t last_trace_eid;
+#include <algorithm>
+#include <execution>
+#include <utility>
+#include <vector>
+
+namespace
+{
+// below this many rays the batch is not worth handing to worker threads
+constexpr size_t kParallelTraceBatch = 16;
+// lists the grids are kept for, callers passing their own lists would add one each
+constexpr size_t kMaxGrids = 32;
+} // namespace
 
 //----------------------------------------------------------------------------------
 //
@@ -11,6 +22,53 @@ LOCAL_COLLIDE *COLL::CreateLocalCollide(layer_index_t idx)
     return new LCOLL(idx);
 }
 
+//----------------------------------------------------------------------------------
+// broad phase
+//----------------------------------------------------------------------------------
+BroadPhase &COLL::Grid(entity_container_cref entities)
+{
+    // move the objects that reported new bounds in every grid holding them
+    auto &changed = COLLISION_OBJECT::ChangedBounds();
+    for (const auto eid : changed)
+    {
+        if (auto *cob = static_cast<COLLISION_OBJECT *>(core.GetEntityPointer(eid)))
+        {
+            cob->AcceptBounds();
+            for (auto &[list, grid] : grids_)
+                grid.Move(eid);
+        }
+    }
+    changed.clear();
+
+    if (grids_.size() >= kMaxGrids && !grids_.contains(&entities))
+        grids_.clear();
+    auto &grid = grids_[&entities];
+    if (!grid.Matches(entities))
+    {
+        objects_.clear();
+        for (const auto eid : entities)
+            objects_.push_back(static_cast<COLLISION_OBJECT *>(core.GetEntityPointer(eid)));
+        grid.Build(entities, objects_);
+    }
+    return grid;
+}
+
+std::vector<TraceCandidate> &COLL::Candidates()
+{
+    // an object traced by this call may trace again, each depth gets its own list
+    while (depth_ >= candidates_.size())
+        candidates_.emplace_back();
+    auto &candidates = candidates_[depth_];
+    candidates.clear();
+    return candidates;
+}
+
+bool COLL::IsAlive(const TraceCandidate &candidate)
+{
+    // deleted entities stay in the list until the end of the frame, a trace may delete one
+    return core.GetEntityPointer(candidate.eid) == candidate.cob;
+}
+
 //----------------------------------------------------------------------------------
 // Ray tracing
 //----------------------------------------------------------------------------------
@@ -20,7 +78,7 @@ float COLL::Trace(entid_t entity, const CVECTOR &src, const CVECTOR &dst)
     if (static_cast<Entity *>(cob) == nullptr)
         return 2.0f;
 
-    last_trace_eid = entity;
+    lastTraceId_ = entity;
     return cob->Trace(src, dst);
 }
 
@@ -30,30 +88,115 @@ float COLL::Trace(entid_t entity, const CVECTOR &src, const CVECTOR &dst)
 float COLL::Trace(entity_container_cref entities, const CVECTOR &src, const CVECTOR &dst,
                   const entid_t *exclude_list, int32_t exclude_num)
 {
-    auto best_res = 2.0f;
-    for (const auto eid : entities)
+    const auto hit = TraceHit(entities, src, dst, exclude_list, exclude_num);
+    if (hit.eid != invalid_entity)
+        lastTraceId_ = hit.eid;
+    return hit.dist;
+}
+
+TRACE_HIT COLL::TraceHit(entity_container_cref entities, const CVECTOR &src, const CVECTOR &dst,
+                         const entid_t *exclude_list, int32_t exclude_num)
+{
+    auto &candidates = Candidates();
+    auto &grid = Grid(entities);
+    grid.BeginQuery(exclude_list, exclude_num);
+    grid.QuerySegment(src, dst, candidates);
+
+    TRACE_HIT hit;
+    depth_++;
+    for (const auto &candidate : candidates)
     {
-        int32_t e;
-        for (e = 0; e < exclude_num; e++)
-            if (eid == exclude_list[e])
-                break;
+        if (!candidate.TouchesSegment(src, dst) || !IsAlive(candidate))
+            continue;
 
-        if (e == exclude_num)
+        const auto res = candidate.cob->Trace(src, dst);
+        if (res < hit.dist)
         {
-            auto *cob = static_cast<COLLISION_OBJECT *>(core.GetEntityPointer(eid));
-            if (cob != nullptr)
+            hit.dist = res;
+            hit.eid = candidate.eid;
+        }
+    }
+    depth_--;
+
+    return hit;
+}
+
+//----------------------------------------------------------------------------------
+// batch of rays
+//----------------------------------------------------------------------------------
+void COLL::TraceBatch(entity_container_cref entities, std::span<const TRACE_RAY> rays, std::span<TRACE_HIT> hits,
+                      const entid_t *exclude_list, int32_t exclude_num)
+{
+    Assert(hits.size() >= rays.size());
+    std::fill_n(hits.begin(), rays.size(), TRACE_HIT{});
+
+    if (rays.empty())
+        return;
+
+    // the objects near any of the rays, each ray tests their bound spheres
+    auto minX = rays[0].src.x, minZ = rays[0].src.z, maxX = minX, maxZ = minZ;
+    for (const auto &ray : rays)
+    {
+        minX = std::min({minX, ray.src.x, ray.dst.x});
+        minZ = std::min({minZ, ray.src.z, ray.dst.z});
+        maxX = std::max({maxX, ray.src.x, ray.dst.x});
+        maxZ = std::max({maxZ, ray.src.z, ray.dst.z});
+    }
+    auto &candidates = Candidates();
+    auto &grid = Grid(entities);
+    grid.BeginQuery(exclude_list, exclude_num);
+    grid.Query(minX, minZ, maxX, maxZ, candidates);
+
+    std::vector<TraceCandidate> concurrent, serial;
+    for (const auto &candidate : candidates)
+    {
+        if (!IsAlive(candidate))
+            continue;
+        if (candidate.cob->IsTraceThreadSafe())
+            concurrent.push_back(candidate);
+        else
+            serial.push_back(candidate);
+    }
+
+    if (!concurrent.empty())
+    {
+        const auto traceRay = [&](const TRACE_RAY &ray) {
+            auto &hit = hits[&ray - rays.data()];
+            for (const auto &candidate : concurrent)
             {
-                const auto res = cob->Trace(src, dst);
-                if (res < best_res)
+                if (!candidate.TouchesSegment(ray.src, ray.dst))
+                    continue;
+                const auto res = std::as_const(*candidate.cob).TraceThreadSafe(ray.src, ray.dst);
+                if (res < hit.dist)
                 {
-                    best_res = res;
-                    last_trace_eid = eid;
+                    hit.dist = res;
+                    hit.eid = candidate.eid;
                 }
             }
-        }
+        };
+
+        if (rays.size() < kParallelTraceBatch)
+            std::for_each(rays.begin(), rays.end(), traceRay);
+        else
+            std::for_each(std::execution::par, rays.begin(), rays.end(), traceRay);
     }
 
-    return best_res;
+    depth_++;
+    for (const auto &candidate : serial)
+    {
+        for (size_t i = 0; i < rays.size(); i++)
+        {
+            if (!candidate.TouchesSegment(rays[i].src, rays[i].dst) || !IsAlive(candidate))
+                continue;
+            const auto res = candidate.cob->Trace(rays[i].src, rays[i].dst);
+            if (res < hits[i].dist)
+            {
+                hits[i].dist = res;
+                hits[i].eid = candidate.eid;
+            }
+        }
+    }
+    depth_--;
 }
 
 //----------------------------------------------------------------------------------
@@ -62,26 +205,23 @@ float COLL::Trace(entity_container_cref entities, const CVECTOR &src, const CVEC
 bool COLL::Clip(entity_container_cref entities, const PLANE *planes, int32_t nplanes, const CVECTOR &center,
                 float radius, ADD_POLYGON_FUNC addpoly, const entid_t *exclude_list, int32_t exclude_num)
 {
-    auto retval = false;
+    auto &candidates = Candidates();
+    auto &grid = Grid(entities);
+    grid.BeginQuery(exclude_list, exclude_num);
+    grid.QuerySphere(center, radius, candidates);
 
-    for (const auto eid : entities)
+    auto retval = false;
+    depth_++;
+    for (const auto &candidate : candidates)
     {
-        int32_t e;
-        for (e = 0; e < exclude_num; e++)
-            if (eid == exclude_list[e])
-                break;
-
-        if (e == exclude_num)
+        if (candidate.TouchesSphere(center, radius) && IsAlive(candidate))
         {
-            auto *cob = static_cast<COLLISION_OBJECT *>(core.GetEntityPointer(eid));
-            if (cob != nullptr)
-            {
-                last_trace_eid = eid;
-                if (cob->Clip(planes, nplanes, center, radius, addpoly) == true)
-                    retval = true;
-            }
+            lastTraceId_ = candidate.eid;
+            if (candidate.cob->Clip(planes, nplanes, center, radius, addpoly) == true)
+                retval = true;
         }
     }
+    depth_--;
 
     return retval;
 }
@@ -91,5 +231,5 @@ bool COLL::Clip(entity_container_cref entities, const PLANE *planes, int32_t npl
 //----------------------------------------------------------------------------------
 entid_t COLL::GetObjectID()
 {
-    return last_trace_eid;
+    return lastTraceId_;
 }
@@ -1,7 +1,12 @@
 #pragma once
 
+#include "broad_phase.h"
 #include "collide.h"
 
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
 #pragma pack(push)
 #pragma pack(1)
 
@@ -23,6 +28,17 @@ class LCOLL : public LOCAL_COLLIDE
 
 class COLL : public COLLIDE
 {
+    entid_t lastTraceId_{};
+    // a grid per traced entity list, keyed by the list the layer keeps
+    std::unordered_map<const std::vector<entid_t> *, BroadPhase> grids_;
+    std::vector<COLLISION_OBJECT *> objects_;
+    std::deque<std::vector<TraceCandidate>> candidates_;
+    size_t depth_{};
+
+    BroadPhase &Grid(entity_container_cref entities);
+    std::vector<TraceCandidate> &Candidates();
+    static bool IsAlive(const TraceCandidate &candidate);
+
   public:
     COLL() = default;
     ~COLL() override = default;
@@ -30,6 +46,10 @@ class COLL : public COLLIDE
     float Trace(entid_t entity, const CVECTOR &src, const CVECTOR &dst) override;
     float Trace(entity_container_cref entities, const CVECTOR &src, const CVECTOR &dst, const entid_t *exclude_list,
                 int32_t exclude_num) override;
+    TRACE_HIT TraceHit(entity_container_cref entities, const CVECTOR &src, const CVECTOR &dst,
+                       const entid_t *exclude_list, int32_t exclude_num) override;
+    void TraceBatch(entity_container_cref entities, std::span<const TRACE_RAY> rays, std::span<TRACE_HIT> hits,
+                    const entid_t *exclude_list, int32_t exclude_num) override;
     bool Clip(entity_container_cref entities, const PLANE *planes, int32_t nplanes, const CVECTOR &center, float radius,
               ADD_POLYGON_FUNC addpoly, const entid_t *exclude_list, int32_t exclude_num) override;
     entid_t GetObjectID() override;
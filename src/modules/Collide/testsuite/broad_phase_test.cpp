@@ -0,0 +1,237 @@
+#include "broad_phase.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <memory>
+#include <random>
+
+namespace
+{
+// a sphere that can be moved, tracing only reports whether it was asked
+class SphereObject final : public COLLISION_OBJECT
+{
+  public:
+    SphereObject(const CVECTOR &center, float radius, bool bounded = true)
+        : center_(center), radius_(radius), bounded_(bounded)
+    {
+    }
+
+    void MoveTo(const CVECTOR &center)
+    {
+        center_ = center;
+    }
+
+    float Trace(const CVECTOR &src, const CVECTOR &dst) override
+    {
+        return 2.0f;
+    }
+
+    bool Clip(const PLANE *planes, int32_t nplanes, const CVECTOR &center, float radius,
+              ADD_POLYGON_FUNC addpoly) override
+    {
+        return false;
+    }
+
+    bool GetBoundSphere(CVECTOR &center, float &radius) const override
+    {
+        center = center_;
+        radius = radius_;
+        return bounded_;
+    }
+
+    const char *GetCollideMaterialName() override
+    {
+        return nullptr;
+    }
+
+    bool GetCollideTriangle(TRIANGLE &triangle) override
+    {
+        return false;
+    }
+
+    void ProcessStage(Stage, uint32_t) override
+    {
+    }
+
+  private:
+    CVECTOR center_;
+    float radius_;
+    bool bounded_;
+};
+
+// a sea battle: ships in a few hundred meters, islands and the sea itself tested by everything
+struct Scene
+{
+    std::vector<std::unique_ptr<SphereObject>> objects;
+    std::vector<entid_t> ids;
+    std::vector<COLLISION_OBJECT *> pointers;
+
+    explicit Scene(size_t numShips, uint32_t seed = 1)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> pos(-400.0f, 400.0f);
+        std::uniform_real_distribution<float> size(8.0f, 40.0f);
+        for (size_t i = 0; i < numShips; i++)
+            Add(std::make_unique<SphereObject>(CVECTOR(pos(rng), 0.0f, pos(rng)), size(rng)));
+        Add(std::make_unique<SphereObject>(CVECTOR(0.0f, 0.0f, 0.0f), 2000.0f));
+        Add(std::make_unique<SphereObject>(CVECTOR(0.0f, 0.0f, 0.0f), 0.0f, false));
+    }
+
+    void Add(std::unique_ptr<SphereObject> object)
+    {
+        ids.push_back(objects.size() + 1);
+        pointers.push_back(object.get());
+        objects.push_back(std::move(object));
+    }
+};
+
+std::vector<entid_t> LinearScan(const Scene &scene, const CVECTOR &src, const CVECTOR &dst,
+                                const std::vector<entid_t> &exclude)
+{
+    std::vector<entid_t> found;
+    for (size_t i = 0; i < scene.ids.size(); i++)
+    {
+        if (std::ranges::find(exclude, scene.ids[i]) != exclude.end())
+            continue;
+        if (TraceCandidate(scene.ids[i], scene.pointers[i]).TouchesSegment(src, dst))
+            found.push_back(scene.ids[i]);
+    }
+    return found;
+}
+
+std::vector<entid_t> GridScan(BroadPhase &grid, const CVECTOR &src, const CVECTOR &dst,
+                              const std::vector<entid_t> &exclude)
+{
+    std::vector<TraceCandidate> candidates;
+    grid.BeginQuery(exclude.data(), static_cast<int32_t>(exclude.size()));
+    grid.QuerySegment(src, dst, candidates);
+    std::vector<entid_t> found;
+    for (const auto &candidate : candidates)
+    {
+        if (candidate.TouchesSegment(src, dst))
+            found.push_back(candidate.eid);
+    }
+    return found;
+}
+} // namespace
+
+TEST_CASE("Grid finds the objects a linear scan finds", "[broad_phase]")
+{
+    Scene scene(200);
+    BroadPhase grid;
+    grid.Build(scene.ids, scene.pointers);
+    REQUIRE(grid.Matches(scene.ids));
+    REQUIRE(grid.NumObjects() == scene.ids.size());
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> pos(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> step(-60.0f, 60.0f);
+    const std::vector<entid_t> exclude = {3, 17, 42};
+    for (int frame = 0; frame < 20; frame++)
+    {
+        for (size_t i = 0; i < 200; i += 3)
+        {
+            scene.objects[i]->MoveTo(CVECTOR(pos(rng), 0.0f, pos(rng)));
+            grid.Move(scene.ids[i]);
+        }
+        for (int ray = 0; ray < 50; ray++)
+        {
+            const CVECTOR src(pos(rng), 5.0f, pos(rng));
+            const CVECTOR dst = src + CVECTOR(step(rng), -10.0f, step(rng));
+            CHECK(GridScan(grid, src, dst, {}) == LinearScan(scene, src, dst, {}));
+            CHECK(GridScan(grid, src, dst, exclude) == LinearScan(scene, src, dst, exclude));
+        }
+        // a long ray falls back to the bound spheres of every object
+        const CVECTOR src(-5000.0f, 0.0f, pos(rng)), dst(5000.0f, 0.0f, pos(rng));
+        CHECK(GridScan(grid, src, dst, exclude) == LinearScan(scene, src, dst, exclude));
+    }
+}
+
+TEST_CASE("Grid is built again for another list", "[broad_phase]")
+{
+    Scene scene(10);
+    BroadPhase grid;
+    grid.Build(scene.ids, scene.pointers);
+
+    auto ids = scene.ids;
+    ids.pop_back();
+    CHECK_FALSE(grid.Matches(ids));
+
+    // gone entities are left out
+    auto pointers = scene.pointers;
+    pointers[0] = nullptr;
+    grid.Build(scene.ids, pointers);
+    CHECK(grid.NumObjects() == scene.ids.size() - 1);
+}
+
+TEST_CASE("Trace replay, grid against linear scan", "[broad_phase][benchmark]")
+{
+    // no traces are recorded from the game, so this replays a fixed synthetic battle:
+    // each frame a few ships move and every ship fires a volley of short rays
+    constexpr size_t kShips = 300;
+    constexpr int kRaysPerShip = 8;
+    Scene scene(kShips);
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> step(-2.0f, 2.0f);
+    std::uniform_real_distribution<float> aim(-80.0f, 80.0f);
+
+    BroadPhase grid;
+    grid.Build(scene.ids, scene.pointers);
+    std::vector<TraceCandidate> candidates;
+    const auto moveShips = [&](BroadPhase *moved) {
+        for (size_t i = 0; i < kShips; i += 10)
+        {
+            CVECTOR center;
+            float radius;
+            scene.objects[i]->GetBoundSphere(center, radius);
+            scene.objects[i]->MoveTo(center + CVECTOR(step(rng), 0.0f, step(rng)));
+            if (moved)
+                moved->Move(scene.ids[i]);
+        }
+    };
+
+    BENCHMARK("linear scan")
+    {
+        moveShips(nullptr);
+        size_t touched = 0;
+        for (size_t i = 0; i < kShips; i++)
+        {
+            CVECTOR center;
+            float radius;
+            scene.objects[i]->GetBoundSphere(center, radius);
+            for (int r = 0; r < kRaysPerShip; r++)
+            {
+                const CVECTOR dst = center + CVECTOR(aim(rng), 0.0f, aim(rng));
+                for (size_t j = 0; j < scene.ids.size(); j++)
+                {
+                    if (j != i)
+                        touched += TraceCandidate(scene.ids[j], scene.pointers[j]).TouchesSegment(center, dst);
+                }
+            }
+        }
+        return touched;
+    };
+
+    BENCHMARK("grid")
+    {
+        moveShips(&grid);
+        size_t touched = 0;
+        for (size_t i = 0; i < kShips; i++)
+        {
+            CVECTOR center;
+            float radius;
+            scene.objects[i]->GetBoundSphere(center, radius);
+            for (int r = 0; r < kRaysPerShip; r++)
+            {
+                const CVECTOR dst = center + CVECTOR(aim(rng), 0.0f, aim(rng));
+                candidates.clear();
+                grid.BeginQuery(&scene.ids[i], 1);
+                grid.QuerySegment(center, dst, candidates);
+                for (const auto &candidate : candidates)
+                    touched += candidate.TouchesSegment(center, dst);
+            }
+        }
+        return touched;
+    };
+}
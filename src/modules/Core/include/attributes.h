@@ -5,6 +5,7 @@
 #include <optional>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 /**
  * TODO: header
@@ -23,17 +24,21 @@ class VSTRING_CODEC
     virtual uint32_t Convert(const char *pString) = 0;
     virtual uint32_t Convert(const char *pString, int32_t iLen) = 0;
     virtual const char *Convert(uint32_t code) = 0;
+    // lookup without inserting, returns 0xffffffff if the string is unknown
+    virtual uint32_t Find(const std::string_view &str) = 0;
 
     virtual void VariableChanged() = 0;
 };
 
 class ATTRIBUTES;
+class AttributePath;
 
 bool MatchAttributePath(const std::string_view &pattern, const ATTRIBUTES &attribute);
 
 class ATTRIBUTES final
 {
     class LegacyProxy;
+    friend class AttributePath;
 
   public:
     explicit ATTRIBUTES(VSTRING_CODEC &p);
@@ -88,16 +93,78 @@ class ATTRIBUTES final
 
     void Sort(const std::function<bool(const std::unique_ptr<ATTRIBUTES> &lhs, const std::unique_ptr<ATTRIBUTES> &rhs)>& pred);
 
+    [[nodiscard]] uint32_t GetAttributeAsDword(const AttributePath &path, uint32_t def = 0) const;
+    [[nodiscard]] float GetAttributeAsFloat(const AttributePath &path, float def = 0) const;
+
+    // delta saves write only the subtrees changed after the save epoch they extend
+    [[nodiscard]] bool IsChangedSince(uint32_t epoch) const noexcept;
+    // the node was moved here from another tree or renamed, its children can not be matched by name with an older save
+    [[nodiscard]] bool IsMovedSince(uint32_t epoch) const noexcept;
+    // closes the current save epoch and returns it
+    static uint32_t NextSaveEpoch() noexcept;
+
+    // number of lookups by string name since the last reset, used by the diagnostics
+    [[nodiscard]] static uint32_t GetStringLookupsNum() noexcept;
+    static void ResetStringLookupsNum() noexcept;
+
 private:
+    // kind of value last set from native code
+    enum class NativeType : uint8_t
+    {
+        None,
+        Dword,
+        Float
+    };
+
     ATTRIBUTES(VSTRING_CODEC &string_codec, ATTRIBUTES *parent, const std::string_view &name);
     ATTRIBUTES(VSTRING_CODEC &string_codec, ATTRIBUTES *parent, uint32_t name_code);
 
     ATTRIBUTES *CreateNewAttribute(uint32_t name_code);
+    [[nodiscard]] size_t FindOrCreateChildPosition(uint32_t name_code);
+    void SetNativeValue(uint32_t val) noexcept;
+    void SetNativeValue(float val) noexcept;
+    // the value as scripts see it, formats a pending native value first
+    [[nodiscard]] const std::optional<std::string> &GetStringValue() const;
+    [[nodiscard]] uint32_t GetValueAsDword() const;
+    [[nodiscard]] uintptr_t GetValueAsPointer() const;
+    [[nodiscard]] float GetValueAsFloat() const;
+    [[nodiscard]] size_t FindChildPosition(uint32_t name_code) const;
+    [[nodiscard]] ATTRIBUTES *FindChild(uint32_t name_code) const;
+    [[nodiscard]] ATTRIBUTES *FindPath(const std::string_view &path) const;
+    [[nodiscard]] const ATTRIBUTES *FindChildOrPath(const char *name) const;
+    void IndexChild(size_t position) const;
+    void InvalidateIndex() const noexcept;
+    // children were removed, renamed, reordered or moved away
+    void ChildrenChanged() noexcept;
+    // stamps the node and its ancestors with the current save epoch
+    void MarkChanged() noexcept;
+    // children moved in from another tree
+    void ChildrenMoved() noexcept;
+    static uint32_t NextGeneration() noexcept;
+    static uint32_t CurrentSaveEpoch() noexcept;
+
+    // children count at which name lookups switch from a linear scan to the index
+    static constexpr size_t kIndexThreshold = 16;
+    static constexpr size_t kNoChild = static_cast<size_t>(-1);
 
     VSTRING_CODEC &stringCodec_;
     uint32_t nameCode_{};
-    std::optional<std::string> value_;
+    mutable std::optional<std::string> value_;
+    // value set by SetAttributeUseDword/Float, stays native until it is read as a string
+    union {
+        uint32_t dword;
+        float flt;
+    } nativeValue_{};
+    NativeType nativeType_{NativeType::None};
+    mutable bool isValueFormatted_{true};
     std::vector<std::unique_ptr<ATTRIBUTES>> attributes_;
+    // open addressing table over attributes_ by name code, slots hold position + 1, built lazily
+    mutable std::vector<uint32_t> index_;
+    // unique per structural change, lets AttributePath validate cached pointers
+    uint32_t generation_{NextGeneration()};
+    // save epoch of the latest change in this subtree, never older than any descendant's
+    uint32_t changed_{CurrentSaveEpoch()};
+    uint32_t moved_{};
     ATTRIBUTES *parent_{nullptr};
     bool break_{false};
     
@@ -142,3 +209,26 @@ private:
         proxy_value_t proxy_value_;
     };
 };
+
+// Pre-parsed access path ("ship.stopped") for per-frame lookups from native code.
+// Resolves to name codes once and caches the found attribute while no node along the path changes its children.
+class AttributePath final
+{
+  public:
+    explicit AttributePath(const std::string_view &path);
+
+    // returns nullptr if the path does not exist under root
+    [[nodiscard]] ATTRIBUTES *Find(ATTRIBUTES *root) const;
+    // creates missing attributes along the path
+    ATTRIBUTES *Create(ATTRIBUTES *root) const;
+    [[nodiscard]] const std::string &GetPath() const noexcept;
+
+  private:
+    void ResolveCodes(VSTRING_CODEC &string_codec) const;
+    [[nodiscard]] bool IsCacheValid(const ATTRIBUTES *root) const;
+
+    std::string path_;
+    mutable std::vector<uint32_t> codes_;
+    // resolved nodes from the root down with the generations they had
+    mutable std::vector<std::pair<ATTRIBUTES *, uint32_t>> chain_;
+};
@@ -79,10 +79,14 @@ class Core
     // send message to an object
     virtual uint64_t Send_Message(entid_t Destination, const char *Format, ...) = 0;
 
-    // save core state
+    // save core state, with background_save the file is written later: a failure is reported by WaitStateSaving
+    // and by the evntSaveFailed post event, with the number of failed saves
     virtual bool SaveState(const char *file_name) = 0;
     // force core to load state file at the start of next game loop, return false if no state file
     virtual bool InitiateStateLoading(const char *file_name) = 0;
+    // wait until the states saved in background are written, before touching save files directly.
+    // false if any of them failed since the previous call
+    virtual bool WaitStateSaving() = 0;
 
     // return current fps
     virtual uint32_t EngineFps() = 0;
@@ -109,6 +113,8 @@ class Core
     virtual uint32_t SetScriptFunction(IFUNCINFO *pFuncInfo) = 0;
 
     virtual void *GetScriptVariable(const char *pVariableName, uint32_t *pdwVarIndex = nullptr) = 0;
+    // changes whenever script variables are added, reloaded or unloaded
+    [[nodiscard]] virtual uint32_t GetScriptVariablesGeneration() const noexcept = 0;
 
     [[nodiscard]] virtual storm::ENGINE_VERSION GetTargetEngineVersion() const noexcept = 0;
 
@@ -139,4 +145,30 @@ class Core
     CONTROLS *Controls{};
 };
 
-extern Core &core;
\ No newline at end of file
+extern Core &core;
+
+// Global script variable looked up by name once, re-resolved only when the script variable table changes
+class ScriptVariableHandle final
+{
+  public:
+    explicit ScriptVariableHandle(std::string name) : name_(std::move(name))
+    {
+    }
+
+    // returns nullptr if the variable is not loaded
+    [[nodiscard]] VDATA *Get()
+    {
+        const uint32_t generation = core.GetScriptVariablesGeneration();
+        if (generation != generation_)
+        {
+            data_ = static_cast<VDATA *>(core.GetScriptVariable(name_.c_str()));
+            generation_ = generation;
+        }
+        return data_;
+    }
+
+  private:
+    std::string name_;
+    VDATA *data_{};
+    uint32_t generation_{};
+};
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "attributes.h"
 
+#include <atomic>
 #include <execution>
 
 /**
@@ -9,10 +10,20 @@
 
 #include "string_compare.hpp"
 
+namespace
+{
+std::atomic<uint32_t> generation_counter{1};
+std::atomic<uint32_t> string_lookups_num{0};
+std::atomic<uint32_t> save_epoch{1};
+} // namespace
+
 ATTRIBUTES::ATTRIBUTES(ATTRIBUTES &&other) noexcept
     : stringCodec_(other.stringCodec_), nameCode_(other.stringCodec_.Convert("root")), value_(std::move(other.value_)),
+      nativeValue_(other.nativeValue_), nativeType_(other.nativeType_), isValueFormatted_(other.isValueFormatted_),
       attributes_(std::move(other.attributes_)), break_(other.break_)
 {
+    ChildrenMoved();
+    other.ChildrenChanged();
 }
 
 ATTRIBUTES & ATTRIBUTES::operator=(ATTRIBUTES &&other) noexcept
@@ -22,7 +33,13 @@ ATTRIBUTES & ATTRIBUTES::operator=(ATTRIBUTES &&other) noexcept
     // nameCode_ = other.nameCode_;
     other.nameCode_ = 1337;
     value_ = std::move(other.value_);
+    nativeValue_ = other.nativeValue_;
+    nativeType_ = other.nativeType_;
+    isValueFormatted_ = other.isValueFormatted_;
     attributes_ = std::move(other.attributes_);
+    ChildrenMoved();
+    ChildrenChanged();
+    other.ChildrenChanged();
     // Do not update parent
     // parent_ = other.parent_;
     other.parent_ = (ATTRIBUTES*)0x1;
@@ -60,23 +77,22 @@ const char *ATTRIBUTES::GetThisName() const
 
 bool ATTRIBUTES::HasValue() const noexcept
 {
-    return value_.has_value();
+    return !isValueFormatted_ || value_.has_value();
 }
 
 const std::string & ATTRIBUTES::GetValue() const
 {
-    return *value_;
+    return *GetStringValue();
 }
 
 ATTRIBUTES::LegacyProxy ATTRIBUTES::GetThisAttr() const
 {
-    return value_;
-
+    return GetStringValue();
 }
 
 void ATTRIBUTES::SetName(const std::string_view &new_name)
 {
-    nameCode_ = stringCodec_.Convert(new_name.data());
+    SetNameCode(stringCodec_.Convert(new_name.data()));
 }
 
 void ATTRIBUTES::SetValue(const char *new_value)
@@ -88,6 +104,9 @@ void ATTRIBUTES::SetValue(const char *new_value)
     else {
         value_ = new_value;
     }
+    nativeType_ = NativeType::None;
+    isValueFormatted_ = true;
+    MarkChanged();
 
     if (break_)
         stringCodec_.VariableChanged();
@@ -96,6 +115,9 @@ void ATTRIBUTES::SetValue(const char *new_value)
 void ATTRIBUTES::SetValue(const std::string_view &new_value)
 {
     value_ = new_value;
+    nativeType_ = NativeType::None;
+    isValueFormatted_ = true;
+    MarkChanged();
 
     if (break_)
         stringCodec_.VariableChanged();
@@ -108,10 +130,10 @@ size_t ATTRIBUTES::GetAttributesNum() const
 
 ATTRIBUTES * ATTRIBUTES::GetAttributeClass(const std::string_view &name) const
 {
-    for (const auto &attribute : attributes_)
-        if (storm::iEquals(name, attribute->GetThisName()))
-            return attribute.get();
-    return nullptr;
+    string_lookups_num.fetch_add(1, std::memory_order_relaxed);
+    // the codec is case-insensitive, so an unknown name can not match any child
+    const uint32_t name_code = stringCodec_.Find(name);
+    return name_code == 0xffffffff ? nullptr : FindChild(name_code);
 }
 
 ATTRIBUTES * ATTRIBUTES::GetAttributeClass(uint32_t n) const
@@ -140,7 +162,7 @@ const char *ATTRIBUTES::GetAttributeName(size_t n) const
 ATTRIBUTES::LegacyProxy ATTRIBUTES::GetAttribute(size_t n) const
 {
     if (n < attributes_.size()) {
-        return attributes_[n]->value_;
+        return attributes_[n]->GetStringValue();
     }
     else {
         return {};
@@ -150,18 +172,14 @@ ATTRIBUTES::LegacyProxy ATTRIBUTES::GetAttribute(size_t n) const
 
 ATTRIBUTES::LegacyProxy ATTRIBUTES::GetAttribute(const std::string_view &name) const
 {
-    for (const auto &attribute : attributes_)
-        if (storm::iEquals(name, attribute->GetThisName())) {
-            return attribute->value_;
-        }
+    if (const ATTRIBUTES *attribute = GetAttributeClass(name))
+        return attribute->GetStringValue();
     return {};
 }
 
 bool ATTRIBUTES::HasAttribute(const std::string_view &name) const
 {
-    return std::any_of(begin(attributes_), end(attributes_), [&name] (const auto &attribute) -> bool {
-        return storm::iEquals(name, attribute->GetThisName());
-    });
+    return GetAttributeClass(name) != nullptr;
 }
 
 uint32_t ATTRIBUTES::GetAttributeAsDword(const char *name, uint32_t def) const
@@ -169,13 +187,13 @@ uint32_t ATTRIBUTES::GetAttributeAsDword(const char *name, uint32_t def) const
     uint32_t vDword = def;
     if (name)
     {
-        const char *pAttribute = GetAttribute(name);
-        if (pAttribute)
-            vDword = atol(pAttribute);
+        const ATTRIBUTES *attribute = FindChildOrPath(name);
+        if (attribute && attribute->HasValue())
+            vDword = attribute->GetValueAsDword();
     }
     else
     {
-        vDword = atol( value_->c_str());
+        vDword = GetValueAsDword();
     }
     return vDword;
 }
@@ -185,13 +203,13 @@ uintptr_t ATTRIBUTES::GetAttributeAsPointer(const char *name, uintptr_t def) con
     uintptr_t ptr = def;
     if (name)
     {
-        const char *pAttribute = GetAttribute(name);
-        if (pAttribute)
-            ptr = atoll(pAttribute);
+        const ATTRIBUTES *attribute = FindChildOrPath(name);
+        if (attribute && attribute->HasValue())
+            ptr = attribute->GetValueAsPointer();
     }
     else
     {
-        ptr = atoll(value_->c_str());
+        ptr = GetValueAsPointer();
     }
     return ptr;
 }
@@ -201,62 +219,66 @@ float ATTRIBUTES::GetAttributeAsFloat(const char *name, float def) const
     float vFloat = def;
     if (name)
     {
-        if (const char *pAttribute = GetAttribute(name))
-            vFloat = static_cast<float>(atof(pAttribute));
+        const ATTRIBUTES *attribute = FindChildOrPath(name);
+        if (attribute && attribute->HasValue())
+            vFloat = attribute->GetValueAsFloat();
     }
     else
     {
-        vFloat = static_cast<float>(atof(value_->c_str()));
+        vFloat = GetValueAsFloat();
     }
     return vFloat;
 }
 
 bool ATTRIBUTES::SetAttributeUseDword(const char *name, uint32_t val)
 {
-    std::string buffer;
-    buffer = std::to_string(val);
     if (name)
-        return SetAttribute(name, buffer) != 0;
-    SetValue(buffer);
+    {
+        string_lookups_num.fetch_add(1, std::memory_order_relaxed);
+        const size_t n = FindOrCreateChildPosition(stringCodec_.Convert(name));
+        attributes_[n]->SetNativeValue(val);
+        return n != 0;
+    }
+    SetNativeValue(val);
+    if (break_)
+        stringCodec_.VariableChanged();
     return true;
 }
 
 bool ATTRIBUTES::SetAttributeUseFloat(const char *name, float val)
 {
-    char buffer[128];
-    sprintf_s(buffer, "%g", val);
     if (name)
-        return SetAttribute(name, buffer) != 0;
-    SetValue(buffer);
-
+    {
+        string_lookups_num.fetch_add(1, std::memory_order_relaxed);
+        const size_t n = FindOrCreateChildPosition(stringCodec_.Convert(name));
+        attributes_[n]->SetNativeValue(val);
+        return n != 0;
+    }
+    SetNativeValue(val);
+    if (break_)
+        stringCodec_.VariableChanged();
     return true;
 }
 
 ATTRIBUTES & ATTRIBUTES::CreateAttribute(const std::string_view &name)
 {
-    const auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name));
-    return *attr;
+    return *CreateNewAttribute(stringCodec_.Convert(name.data()));
 }
 
 ATTRIBUTES * ATTRIBUTES::CreateAttribute(const std::string_view &name, const char *attribute)
 {
-    const auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name));
-
-    if (attribute)
-    {
-        attr->value_ = attribute;
-    }
-
-    return attr.get();
+    return CreateAttribute(stringCodec_.Convert(name.data()), attribute);
 }
 
 size_t ATTRIBUTES::SetAttribute(const std::string_view &name, const char *attribute)
 {
+    string_lookups_num.fetch_add(1, std::memory_order_relaxed);
     return SetAttribute(stringCodec_.Convert(name.data()), attribute);
 }
 
 size_t ATTRIBUTES::SetAttribute(const std::string_view &name, const std::string_view &attribute)
 {
+    string_lookups_num.fetch_add(1, std::memory_order_relaxed);
     return SetAttribute(stringCodec_.Convert(name.data()), attribute);
 }
 
@@ -267,6 +289,7 @@ bool ATTRIBUTES::DeleteAttributeClassX(ATTRIBUTES *pA)
     if (pA == this)
     {
         attributes_.clear();
+        ChildrenChanged();
     }
     else
     {
@@ -278,6 +301,7 @@ bool ATTRIBUTES::DeleteAttributeClassX(ATTRIBUTES *pA)
             if (it != attributes_.end() )
             {
                 attributes_.erase(it);
+                ChildrenChanged();
                 return true;
             }
             if (attributes_[n]->DeleteAttributeClassX(pA))
@@ -289,75 +313,48 @@ bool ATTRIBUTES::DeleteAttributeClassX(ATTRIBUTES *pA)
 
 ATTRIBUTES * ATTRIBUTES::CreateSubAClass(ATTRIBUTES *pRoot, const char *access_string)
 {
-    uint32_t dwNameCode;
-    uint32_t n = 0;
-    ATTRIBUTES *pResult = nullptr;
-    ATTRIBUTES *pTemp;
     if (pRoot == nullptr)
         return nullptr;
     if (access_string == nullptr)
         return nullptr;
 
+    std::string_view path(access_string);
     while (true)
     {
-        switch (access_string[n])
+        const size_t separator = path.find('.');
+        const std::string_view section = path.substr(0, separator);
+        string_lookups_num.fetch_add(1, std::memory_order_relaxed);
+
+        // only intern the name when a child has to be created
+        uint32_t dwNameCode = stringCodec_.Find(section);
+        ATTRIBUTES *pTemp = dwNameCode == 0xffffffff ? nullptr : pRoot->FindChild(dwNameCode);
+        if (!pTemp)
         {
-        case '.':
-            dwNameCode = stringCodec_.Convert(access_string, n);
-            pTemp = pRoot->GetAttributeClassByCode(dwNameCode);
-            if (!pTemp)
-                pTemp = pRoot->CreateNewAttribute(dwNameCode);
-            pResult = CreateSubAClass(pTemp, &access_string[n + 1]);
-            return pResult;
-
-        case 0:
-            dwNameCode = stringCodec_.Convert(access_string);
-            pResult = pRoot->GetAttributeClassByCode(dwNameCode);
-            return (pResult) ? pResult : pRoot->CreateNewAttribute(dwNameCode);
-        default: ;
+            if (dwNameCode == 0xffffffff)
+                dwNameCode = stringCodec_.Convert(section.data(), static_cast<int32_t>(section.size()));
+            pTemp = pRoot->CreateNewAttribute(dwNameCode);
         }
-        n++;
+
+        if (separator == std::string_view::npos)
+            return pTemp;
+        pRoot = pTemp;
+        path.remove_prefix(separator + 1);
     }
-    return nullptr;
 }
 
 ATTRIBUTES * ATTRIBUTES::FindAClass(ATTRIBUTES *pRoot, const char *access_string)
 {
-    uint32_t n = 0;
-    ATTRIBUTES *pResult = nullptr;
-    ATTRIBUTES *pTemp = nullptr;
-
     if (!pRoot || !access_string)
         return nullptr;
     if (!access_string[0])
         return pRoot;
 
-    while (true)
-    {
-        switch (access_string[n])
-        {
-        case '.':
-            pTemp = pRoot->GetAttributeClassByCode(stringCodec_.Convert(access_string, n));
-            if (!pTemp)
-                return nullptr;
-            pResult = FindAClass(pTemp, &access_string[n + 1]);
-            return pResult;
-        case 0:
-            pResult = pRoot->GetAttributeClassByCode(stringCodec_.Convert(access_string));
-            return pResult;
-        default: ;
-        }
-        n++;
-    }
-    return nullptr;
+    return pRoot->FindPath(access_string);
 }
 
 ATTRIBUTES * ATTRIBUTES::GetAttributeClassByCode(uint32_t name_code) const
 {
-    for (const auto &attribute : attributes_)
-        if (name_code == attribute->nameCode_)
-            return attribute.get();
-    return nullptr;
+    return FindChild(name_code);
 }
 
 ATTRIBUTES * ATTRIBUTES::VerifyAttributeClassByCode(uint32_t name_code)
@@ -370,65 +367,47 @@ ATTRIBUTES * ATTRIBUTES::VerifyAttributeClassByCode(uint32_t name_code)
 
 ATTRIBUTES * ATTRIBUTES::CreateAttribute(uint32_t name_code, const char *attribute)
 {
-    const auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
+    ATTRIBUTES *attr = CreateNewAttribute(name_code);
 
     if (attribute)
     {
         attr->value_ = attribute;
     }
 
-    return attr.get();
+    return attr;
 }
 
 size_t ATTRIBUTES::SetAttribute(uint32_t name_code, const char *attribute)
 {
-    size_t n;
-    for (n = 0; n < attributes_.size(); n++)
-    {
-        if (attributes_[n]->nameCode_ == name_code)
-        {
-            if (attribute)
-            {
-                attributes_[n]->value_ = attribute;
-            }
-            else
-            {
-                attributes_[n]->value_.reset();
-            }
-            return n;
-        }
-    }
-
-    auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
+    const size_t n = FindOrCreateChildPosition(name_code);
+    ATTRIBUTES &attr = *attributes_[n];
 
     if (attribute)
     {
-        attributes_[n]->value_ = attribute;
+        attr.value_ = attribute;
     }
-    else {
-        attributes_[n]->value_.reset();
+    else
+    {
+        attr.value_.reset();
     }
+    attr.nativeType_ = NativeType::None;
+    attr.isValueFormatted_ = true;
+    attr.MarkChanged();
 
-    return attributes_.size() - 1;
+    return n;
 }
 
 size_t ATTRIBUTES::SetAttribute(uint32_t name_code, const std::string_view &attribute)
 {
-    size_t n;
-    for (n = 0; n < attributes_.size(); n++)
-    {
-        if (attributes_[n]->nameCode_ == name_code)
-        {
-            attributes_[n]->value_ = attribute;
-            return n;
-        }
-    }
-
-    auto &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
+    const size_t n = FindOrCreateChildPosition(name_code);
+    ATTRIBUTES &attr = *attributes_[n];
 
-    attributes_[n]->value_ = attribute;
+    attr.value_ = attribute;
+    attr.nativeType_ = NativeType::None;
+    attr.isValueFormatted_ = true;
+    attr.MarkChanged();
 
-    return attributes_.size() - 1;
+    return n;
 }
 
 uint32_t ATTRIBUTES::GetThisNameCode() const noexcept
@@ -438,7 +417,14 @@ uint32_t ATTRIBUTES::GetThisNameCode() const noexcept
 
 void ATTRIBUTES::SetNameCode(uint32_t n) noexcept
 {
+    if (nameCode_ == n)
+        return;
+    if (parent_ != nullptr)
+        parent_->ChildrenChanged();
     nameCode_ = n;
+    // the children can not be found under the old name in an older save either
+    moved_ = CurrentSaveEpoch();
+    MarkChanged();
 }
 
 VSTRING_CODEC & ATTRIBUTES::GetStringCodec() const noexcept
@@ -450,14 +436,256 @@ void ATTRIBUTES::Sort(
     const std::function<bool(const std::unique_ptr<ATTRIBUTES> &, const std::unique_ptr<ATTRIBUTES> &)>& pred)
 {
     std::sort(std::execution::seq, std::begin(attributes_), std::end(attributes_), pred);
+    ChildrenChanged();
+}
+
+uint32_t ATTRIBUTES::GetAttributeAsDword(const AttributePath &path, uint32_t def) const
+{
+    const ATTRIBUTES *attribute = path.Find(const_cast<ATTRIBUTES *>(this));
+    return attribute && attribute->HasValue() ? attribute->GetValueAsDword() : def;
+}
+
+float ATTRIBUTES::GetAttributeAsFloat(const AttributePath &path, float def) const
+{
+    const ATTRIBUTES *attribute = path.Find(const_cast<ATTRIBUTES *>(this));
+    return attribute && attribute->HasValue() ? attribute->GetValueAsFloat() : def;
+}
+
+uint32_t ATTRIBUTES::NextGeneration() noexcept
+{
+    return generation_counter.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ATTRIBUTES::IsChangedSince(uint32_t epoch) const noexcept
+{
+    return changed_ > epoch;
+}
+
+bool ATTRIBUTES::IsMovedSince(uint32_t epoch) const noexcept
+{
+    return moved_ > epoch;
+}
+
+uint32_t ATTRIBUTES::NextSaveEpoch() noexcept
+{
+    return save_epoch.fetch_add(1, std::memory_order_relaxed);
+}
+
+uint32_t ATTRIBUTES::CurrentSaveEpoch() noexcept
+{
+    return save_epoch.load(std::memory_order_relaxed);
+}
+
+uint32_t ATTRIBUTES::GetStringLookupsNum() noexcept
+{
+    return string_lookups_num.load(std::memory_order_relaxed);
+}
+
+void ATTRIBUTES::ResetStringLookupsNum() noexcept
+{
+    string_lookups_num.store(0, std::memory_order_relaxed);
 }
 
 ATTRIBUTES * ATTRIBUTES::CreateNewAttribute(uint32_t name_code)
 {
     const std::unique_ptr<ATTRIBUTES> &attr = attributes_.emplace_back(new ATTRIBUTES(stringCodec_, this, name_code));
+    MarkChanged();
+    if (!index_.empty())
+    {
+        // keep the load factor at or below one half, otherwise rebuild on the next lookup
+        if (attributes_.size() * 2 <= index_.size())
+            IndexChild(attributes_.size() - 1);
+        else
+            InvalidateIndex();
+    }
     return attr.get();
 }
 
+size_t ATTRIBUTES::FindOrCreateChildPosition(uint32_t name_code)
+{
+    const size_t n = FindChildPosition(name_code);
+    if (n != kNoChild)
+        return n;
+    CreateNewAttribute(name_code);
+    return attributes_.size() - 1;
+}
+
+void ATTRIBUTES::SetNativeValue(uint32_t val) noexcept
+{
+    nativeValue_.dword = val;
+    nativeType_ = NativeType::Dword;
+    isValueFormatted_ = false;
+    MarkChanged();
+}
+
+void ATTRIBUTES::SetNativeValue(float val) noexcept
+{
+    nativeValue_.flt = val;
+    nativeType_ = NativeType::Float;
+    isValueFormatted_ = false;
+    MarkChanged();
+}
+
+const std::optional<std::string> &ATTRIBUTES::GetStringValue() const
+{
+    if (!isValueFormatted_)
+    {
+        // same text the values were stored as before they were kept natively
+        if (nativeType_ == NativeType::Dword)
+        {
+            value_ = std::to_string(nativeValue_.dword);
+        }
+        else
+        {
+            char buffer[128];
+            sprintf_s(buffer, "%g", nativeValue_.flt);
+            value_ = buffer;
+        }
+        isValueFormatted_ = true;
+    }
+    return value_;
+}
+
+uint32_t ATTRIBUTES::GetValueAsDword() const
+{
+    if (nativeType_ == NativeType::Dword)
+        return nativeValue_.dword;
+    return atol(GetStringValue()->c_str());
+}
+
+uintptr_t ATTRIBUTES::GetValueAsPointer() const
+{
+    if (nativeType_ == NativeType::Dword)
+        return nativeValue_.dword;
+    return atoll(GetStringValue()->c_str());
+}
+
+float ATTRIBUTES::GetValueAsFloat() const
+{
+    if (nativeType_ == NativeType::Float)
+        return nativeValue_.flt;
+    if (nativeType_ == NativeType::Dword)
+        return static_cast<float>(static_cast<double>(nativeValue_.dword));
+    return static_cast<float>(atof(GetStringValue()->c_str()));
+}
+
+namespace
+{
+uint32_t IndexSlot(uint32_t name_code, size_t mask)
+{
+    // codes are (bucket << 16) | n, fibonacci hashing spreads both halves over the table
+    return static_cast<uint32_t>((static_cast<uint64_t>(name_code) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+}
+} // namespace
+
+size_t ATTRIBUTES::FindChildPosition(uint32_t name_code) const
+{
+    const size_t count = attributes_.size();
+    if (count < kIndexThreshold)
+    {
+        for (size_t n = 0; n < count; n++)
+            if (attributes_[n]->nameCode_ == name_code)
+                return n;
+        return kNoChild;
+    }
+
+    if (index_.empty())
+    {
+        size_t capacity = kIndexThreshold * 2;
+        while (capacity < count * 2)
+            capacity <<= 1;
+        index_.assign(capacity, 0);
+        for (size_t n = 0; n < count; n++)
+            IndexChild(n);
+    }
+
+    const size_t mask = index_.size() - 1;
+    for (size_t slot = IndexSlot(name_code, mask); index_[slot] != 0; slot = (slot + 1) & mask)
+    {
+        const size_t n = index_[slot] - 1;
+        if (attributes_[n]->nameCode_ == name_code)
+            return n;
+    }
+    return kNoChild;
+}
+
+ATTRIBUTES *ATTRIBUTES::FindChild(uint32_t name_code) const
+{
+    const size_t n = FindChildPosition(name_code);
+    return n == kNoChild ? nullptr : attributes_[n].get();
+}
+
+void ATTRIBUTES::IndexChild(size_t position) const
+{
+    const uint32_t name_code = attributes_[position]->nameCode_;
+    const size_t mask = index_.size() - 1;
+    size_t slot = IndexSlot(name_code, mask);
+    for (; index_[slot] != 0; slot = (slot + 1) & mask)
+    {
+        // duplicated names resolve to the first child, same as the linear scan
+        if (attributes_[index_[slot] - 1]->nameCode_ == name_code)
+            return;
+    }
+    index_[slot] = static_cast<uint32_t>(position + 1);
+}
+
+void ATTRIBUTES::InvalidateIndex() const noexcept
+{
+    index_.clear();
+}
+
+void ATTRIBUTES::ChildrenChanged() noexcept
+{
+    InvalidateIndex();
+    generation_ = NextGeneration();
+    MarkChanged();
+}
+
+void ATTRIBUTES::MarkChanged() noexcept
+{
+    const uint32_t epoch = CurrentSaveEpoch();
+    // the ancestors of a stamped node are stamped already
+    for (ATTRIBUTES *attribute = this; attribute != nullptr && attribute->changed_ != epoch;
+         attribute = attribute->parent_)
+        attribute->changed_ = epoch;
+}
+
+void ATTRIBUTES::ChildrenMoved() noexcept
+{
+    const uint32_t epoch = CurrentSaveEpoch();
+    for (const auto &attribute : attributes_)
+    {
+        attribute->parent_ = this;
+        attribute->moved_ = epoch;
+    }
+}
+
+ATTRIBUTES *ATTRIBUTES::FindPath(const std::string_view &path) const
+{
+    const ATTRIBUTES *current = this;
+    std::string_view remaining = path;
+    while (current != nullptr)
+    {
+        const size_t separator = remaining.find('.');
+        current = current->GetAttributeClass(remaining.substr(0, separator));
+        if (separator == std::string_view::npos)
+            break;
+        remaining.remove_prefix(separator + 1);
+    }
+    return const_cast<ATTRIBUTES *>(current);
+}
+
+const ATTRIBUTES *ATTRIBUTES::FindChildOrPath(const char *name) const
+{
+    // a direct child wins, dotted names fall back to walking the path ("a.b.c")
+    const std::string_view access(name);
+    if (const ATTRIBUTES *attribute = GetAttributeClass(access))
+        return attribute;
+    if (access.find('.') == std::string_view::npos)
+        return nullptr;
+    return FindPath(access);
+}
+
 ATTRIBUTES::ATTRIBUTES(VSTRING_CODEC &p) : ATTRIBUTES(p, nullptr, "root")
 {
 }
@@ -476,6 +704,9 @@ ATTRIBUTES ATTRIBUTES::Copy() const
 {
     ATTRIBUTES result(stringCodec_, nullptr, nameCode_);
     result.value_ = value_;
+    result.nativeValue_ = nativeValue_;
+    result.nativeType_ = nativeType_;
+    result.isValueFormatted_ = isValueFormatted_;
 
     for (const auto &attribute : attributes_)
     {
@@ -486,6 +717,85 @@ ATTRIBUTES ATTRIBUTES::Copy() const
     return result;
 }
 
+AttributePath::AttributePath(const std::string_view &path) : path_(path)
+{
+}
+
+void AttributePath::ResolveCodes(VSTRING_CODEC &string_codec) const
+{
+    std::string_view remaining = path_;
+    while (true)
+    {
+        const size_t separator = remaining.find('.');
+        const std::string_view section = remaining.substr(0, separator);
+        codes_.push_back(string_codec.Convert(section.data(), static_cast<int32_t>(section.size())));
+        if (separator == std::string_view::npos)
+            break;
+        remaining.remove_prefix(separator + 1);
+    }
+}
+
+bool AttributePath::IsCacheValid(const ATTRIBUTES *root) const
+{
+    if (chain_.empty() || chain_.front().first != root)
+        return false;
+    // an unchanged parent still owns the cached child, so the chain can be checked from the root down
+    for (size_t n = 0; n + 1 < chain_.size(); n++)
+        if (chain_[n].first->generation_ != chain_[n].second)
+            return false;
+    return true;
+}
+
+ATTRIBUTES *AttributePath::Find(ATTRIBUTES *root) const
+{
+    if (root == nullptr)
+        return nullptr;
+
+    if (IsCacheValid(root))
+        return chain_.back().first;
+
+    if (codes_.empty())
+        ResolveCodes(root->GetStringCodec());
+
+    // misses are not cached, attributes may be added later without changing any generation
+    chain_.clear();
+    ATTRIBUTES *current = root;
+    for (const uint32_t code : codes_)
+    {
+        ATTRIBUTES *next = current->GetAttributeClassByCode(code);
+        if (next == nullptr)
+        {
+            chain_.clear();
+            return nullptr;
+        }
+        chain_.emplace_back(current, current->generation_);
+        current = next;
+    }
+    chain_.emplace_back(current, current->generation_);
+    return current;
+}
+
+ATTRIBUTES *AttributePath::Create(ATTRIBUTES *root) const
+{
+    if (ATTRIBUTES *result = Find(root))
+        return result;
+    if (root == nullptr)
+        return nullptr;
+
+    ATTRIBUTES *current = root;
+    for (const uint32_t code : codes_)
+    {
+        ATTRIBUTES *next = current->GetAttributeClassByCode(code);
+        current = next ? next : current->CreateNewAttribute(code);
+    }
+    return Find(root);
+}
+
+const std::string &AttributePath::GetPath() const noexcept
+{
+    return path_;
+}
+
 // MatchAttributePath("equipment.*.locator", attribute)
 bool MatchAttributePath(const std::string_view &pattern, const ATTRIBUTES &attribute)
 {
@@ -18,9 +18,13 @@ using namespace Storm::Filesystem;
 
 #include <zlib.h>
 
+#include <algorithm>
+#include <bit>
 #include <unordered_map>
 #include <chrono>
 #include <cstdio>
+#include <memory>
+#include <random>
 
 #define SKIP_COMMENT_TRACING
 #define TRACE_OFF
@@ -29,6 +33,9 @@ using namespace Storm::Filesystem;
 #define INVALID_ARRAY_INDEX 0xffffffff
 #endif
 #define INVALID_OFFSET 0xffffffff
+// in place of the number of subclasses, the attribute is unchanged since the base of a delta save
+#define ATTRIBUTES_KEPT 0xfffffffe
+#define MAX_SAVE_CHAIN 64
 #define DSL_INI_VALUE 0
 #define SBUPDATE 4
 #define DEF_COMPILE_EXPRESSIONS
@@ -50,6 +57,23 @@ std::filesystem::path GetCacheFolder()
 }
 constexpr auto kCacheStateFile = "state";
 
+// non zero, lets a delta check that its base is still the save it was written against
+uint64_t NewSaveId()
+{
+    static std::mt19937_64 generator(std::random_device{}());
+    uint64_t id;
+    do
+        id = generator();
+    while (id == 0);
+    return id;
+}
+
+// the file on disk of a save named by scripts
+std::filesystem::path SaveFilePath(const char *file_name)
+{
+    return std::filesystem::u8path(fio->ConvertPathResource(file_name));
+}
+
 bool ReadCacheFingerprint(uint64_t &fingerprint)
 {
     std::ifstream cache_state(GetCacheFolder() / kCacheStateFile, std::ifstream::binary);
@@ -95,11 +119,11 @@ using std::chrono::milliseconds;
 using std::chrono::system_clock;
 
 COMPILER::COMPILER()
-    : bBreakOnError(false), pRunCodeBase(nullptr), CompilerStage(CS_SYSTEM), pEventMessage(nullptr), SegmentsNum(0),
+    : bBreakOnError(false), pRunCodeBase(nullptr), pRunOps(nullptr), CompilerStage(CS_SYSTEM), pEventMessage(nullptr), SegmentsNum(0),
       InstructionPointer(0), pBuffer(nullptr), ProgramDirectory(nullptr), bCompleted(false), bEntityUpdate(true),
       pDebExpBuffer(nullptr), nDebExpBufferSize(0), pRun_fi(nullptr), bRuntimeLog(false),
       nRuntimeLogEventsBufferSize(0), nRuntimeLogEventsNum(0), nRuntimeTicks(0), bFirstRun(true), bWriteCodeFile(false),
-      bDebugInfo(false), DebugSourceLine(0), pCompileTokenTempBuffer(nullptr), bDebugExpressionRun(false),
+      bDebugInfo(false), bPreDecode(true), DebugSourceLine(0), pCompileTokenTempBuffer(nullptr), bDebugExpressionRun(false),
       bTraceMode(true), nDebugTraceLineCode(0), nIOBufferSize(0), pIOBuffer(nullptr), rAP(nullptr),
       script_cache_mode_(kCacheDisabled)
 
@@ -171,6 +195,8 @@ void COMPILER::Release()
     EventMsg.Release();
     SCodec.Release();
     LibriaryFuncs.clear();
+    // a new program starts a new chain of saves
+    save_chain_length_ = 0;
 
     delete[] pDebExpBuffer;
     pDebExpBuffer = nullptr;
@@ -427,7 +453,14 @@ void COMPILER::LoadPreprocess() {
     bDebugInfo = config.Get<std::int64_t>("debuginfo", 0) == 0;
     bWriteCodeFile = config.Get<std::int64_t>("codefiles", 0) == 0;
     bRuntimeLog = config.Get<std::int64_t>("runtimelog", 0) == 0;
+    bPreDecode = config.Get<std::int64_t>("predecode", 1) != 0;
     script_cache_mode_ = config.Get<std::int64_t>("cache_mode", kCacheDisabled);
+    background_save_ = config.Get<std::int64_t>("background_save", 0) != 0;
+    max_save_deltas_ = static_cast<uint32_t>(std::clamp(config.Get<std::int64_t>("delta_saves", 0),
+                                                        static_cast<std::int64_t>(0),
+                                                        static_cast<std::int64_t>(MAX_SAVE_CHAIN - 1)));
+    save_level_ = std::clamp(static_cast<int32_t>(config.Get<std::int64_t>("save_level", Z_BEST_COMPRESSION)),
+                             static_cast<int32_t>(Z_NO_COMPRESSION), static_cast<int32_t>(Z_BEST_COMPRESSION));
 
     if (script_cache_mode_ < kCacheDisabled || script_cache_mode_ > kCacheEnabledNoRuntimeCheck) {
         script_cache_mode_ = kCacheDisabled;
@@ -529,6 +562,7 @@ void COMPILER::FindErrorSource()
     DebugSourceLine = 0;
     file_line_offset = 0;
     char *pCodeBase = SegmentTable[segment_index].pCode;
+    const uint32_t code_offset = BC_CodeOffset();
     do
     {
         Token_type = static_cast<S_TOKEN_TYPE>(pCodeBase[ip]);
@@ -545,7 +579,7 @@ void COMPILER::FindErrorSource()
             ip += sizeof(uint32_t);
         }
 
-        if (ip >= InstructionPointer)
+        if (ip >= code_offset)
         {
             // DebugSourceLine -= file_line_offset;
             return;
@@ -652,7 +686,6 @@ VDATA *COMPILER::ProcessEvent(const char *event_name)
     VDATA *pVD;
     DATA *pResult;
     MESSAGE *pMem;
-    EVENTINFO ei;
 #ifdef _WIN32 // S_DEBUG
     uint32_t current_debug_mode;
 #endif
@@ -678,11 +711,12 @@ VDATA *COMPILER::ProcessEvent(const char *event_name)
     event_code = EventTab.FindEvent(event_name);
     if (event_code == INVALID_EVENT_CODE)
         return nullptr; // no handlers
-    EventTab.GetEvent(ei, event_code);
-    for (uint32_t n = 0; n < ei.elements; n++)
+    // handlers list is held, not copied: changes made by handlers themselves detach the table from it
+    const EVENT_HANDLERS handlers = EventTab.GetEventHandlers(event_code);
+    for (uint32_t n = 0; n < handlers->size(); n++)
     {
-        func_code = ei.pFuncInfo[n].func_code;
-        if (ei.pFuncInfo[n].status != FSTATUS_NORMAL)
+        func_code = (*handlers)[n].func_code;
+        if (!EventTab.IsHandlerActive(event_code, handlers, n))
             continue;
         pMem = pEventMessage;
         if (pMem)
@@ -692,28 +726,12 @@ VDATA *COMPILER::ProcessEvent(const char *event_name)
 
         const uint32_t nStackVars = SStack.GetDataNum(); // remember stack elements num
         RDTSC_B(nTicks);
-        BC_Execute(ei.pFuncInfo[n].func_code, pResult);
+        BC_Execute(func_code, pResult);
         RDTSC_E(nTicks);
 
-        FuncInfo fi;
-        // if(FuncTab.GetFuncX(fi,ei.pFuncInfo[n].func_code))
-        if (FuncTab.GetFuncX(fi, func_code))
-        {
-            if (fi.return_type != TVOID)
-            {
-                fi.return_type = TVOID;
-            }
-        } //*/
-
-        if (EventTab.GetEvent(ei, event_code)) // to be sure event still exist
+        if (!FuncTab.AddTime(func_code, nTicks))
         {
-            if (n < ei.elements)
-            {
-                if (!FuncTab.AddTime(ei.pFuncInfo[n].func_code, nTicks))
-                {
-                    core_internal.Trace("Invalid func_code = %u for AddTime", ei.pFuncInfo[n].func_code);
-                }
-            }
+            core_internal.Trace("Invalid func_code = %u for AddTime", func_code);
         }
 
         pEventMessage = pMem;
@@ -921,6 +939,10 @@ bool COMPILER::BC_LoadSegment(const char *file_name)
         EventTab.InvalidateBySegmentID(id);
         DefTab.InvalidateBySegmentID(id);
     }
+    else if (bPreDecode)
+    {
+        BC_PreDecode(SegmentTable[index]);
+    }
     return result;
 }
 
@@ -988,7 +1010,7 @@ bool COMPILER::ProcessDebugExpression0(const char *pExpression, DATA &Result)
 
     if (pRun_fi)
     {
-        CurrentFuncCode = FuncTab.FindFunc(pRun_fi->name);
+        CurrentFuncCode = pRun_fi->func_code;
     }
 
     try
@@ -1012,8 +1034,9 @@ bool COMPILER::ProcessDebugExpression0(const char *pExpression, DATA &Result)
     // save current pointers values
     const uint32_t mem_InstructionPointer = InstructionPointer;
     // mem_ip = ip;
-    FuncInfo *mem_pfi = pRun_fi;
+    FUNC_FRAME *mem_pfi = pRun_fi;
     const char *mem_codebase = pRunCodeBase;
+    const BC_OP *mem_ops = pRunOps;
     // mem_CurrentFuncCode = CurrentFuncCode;
 
     // trace("Segment.pCode : %s",pDebExpBuffer);
@@ -1040,6 +1063,7 @@ bool COMPILER::ProcessDebugExpression0(const char *pExpression, DATA &Result)
     // ip = mem_ip;
     // RunningSegmentID = pRun_fi->segment_id;
     pRunCodeBase = mem_codebase;
+    pRunOps = mem_ops;
 
     delete[] Segment.pCode;
 
@@ -1071,7 +1095,7 @@ void COMPILER::ProcessFrame(uint32_t DeltaTime)
 
         for (uint32_t i = n; i < (SegmentsNum - 1); i++)
         {
-            SegmentTable[i] = SegmentTable[i + 1];
+            SegmentTable[i] = std::move(SegmentTable[i + 1]);
         }
         SegmentsNum--;
         // SegmentTable = (SEGMENT_DESC *)RESIZE(SegmentTable,SegmentsNum*sizeof(SEGMENT_DESC));
@@ -1080,6 +1104,13 @@ void COMPILER::ProcessFrame(uint32_t DeltaTime)
         n = 0;
     }
 
+    // SaveState returned before these were written, the scripts learn of it a frame or more later
+    if (const auto numFailed = state_queue_.NumFailed(); numFailed != posted_save_failures_)
+    {
+        core_internal.PostEvent("evntSaveFailed", 0, "l", static_cast<int32_t>(numFailed - posted_save_failures_));
+        posted_save_failures_ = numFailed;
+    }
+
     EventTab.ProcessFrame();
 
     for (int32_t ln = 0; ln < static_cast<int32_t>(EventMsg.GetClassesNum()); ln++)
@@ -3546,6 +3577,19 @@ bool COMPILER::TokenIs(S_TOKEN_TYPE test)
 
 bool COMPILER::BC_Jump(SEGMENT_DESC &Segment, uint32_t offset)
 {
+    if (pRunOps)
+    {
+        // target is resolved by BC_PreDecode, jump is the last read op
+        const uint32_t target = pRunOps[InstructionPointer - 1].jump;
+        if (target == INVALID_OP_INDEX)
+        {
+            SetError("invalid jump");
+            return false;
+        }
+        InstructionPointer = target;
+        return true;
+    }
+
     if (offset >= Segment.BCode_Program_size)
     {
         SetError("invalid jump");
@@ -3560,6 +3604,17 @@ S_TOKEN_TYPE COMPILER::BC_TokenGet(uint32_t &ip, uint32_t &token_data_size)
     // function read token type and data size, advance InstructionPointer to next token
     // set ip to token data
     // set token data size value and return token type
+    if (pRunOps)
+    {
+        const BC_OP &op = pRunOps[InstructionPointer++];
+        token_data_size = op.data_size;
+        ip = op.data_offset;
+        TLR_DataOffset = op.data_offset;
+        TLR_Arg = op.arg;
+        TokenLastReadResult = op.type;
+        return TokenLastReadResult;
+    }
+
     TokenLastReadResult = static_cast<S_TOKEN_TYPE>(pRunCodeBase[InstructionPointer]);
     // Trace("Token: %s", Token.GetTypeName(TokenLastReadResult));
     InstructionPointer++;
@@ -3576,6 +3631,11 @@ S_TOKEN_TYPE COMPILER::BC_TokenGet(uint32_t &ip, uint32_t &token_data_size)
     }
     ip = InstructionPointer;
     TLR_DataOffset = InstructionPointer;
+    TLR_Arg = 0;
+    if (token_data_size >= sizeof(uint32_t))
+    {
+        memcpy(&TLR_Arg, &pRunCodeBase[InstructionPointer], sizeof(uint32_t));
+    }
     InstructionPointer += token_data_size;
     return TokenLastReadResult;
 }
@@ -3583,6 +3643,15 @@ S_TOKEN_TYPE COMPILER::BC_TokenGet(uint32_t &ip, uint32_t &token_data_size)
 S_TOKEN_TYPE COMPILER::BC_TokenGet()
 {
     // short version of function for calls what doesnt need to work with token data
+    if (pRunOps)
+    {
+        const BC_OP &op = pRunOps[InstructionPointer++];
+        TLR_DataOffset = op.data_offset;
+        TLR_Arg = op.arg;
+        TokenLastReadResult = op.type;
+        return TokenLastReadResult;
+    }
+
     uint32_t token_data_size;
     TokenLastReadResult = static_cast<S_TOKEN_TYPE>(pRunCodeBase[InstructionPointer]);
     // Trace("Token: %s", Token.GetTypeName(TokenLastReadResult));
@@ -3599,21 +3668,131 @@ S_TOKEN_TYPE COMPILER::BC_TokenGet()
         InstructionPointer += sizeof(uint32_t);
     }
     TLR_DataOffset = InstructionPointer;
+    TLR_Arg = 0;
+    if (token_data_size >= sizeof(uint32_t))
+    {
+        memcpy(&TLR_Arg, &pRunCodeBase[InstructionPointer], sizeof(uint32_t));
+    }
     InstructionPointer += token_data_size;
     return TokenLastReadResult;
 }
 
 S_TOKEN_TYPE COMPILER::NextTokenType()
 {
+    if (pRunOps)
+    {
+        return pRunOps[InstructionPointer].type;
+    }
     return static_cast<S_TOKEN_TYPE>(pRunCodeBase[InstructionPointer]);
 }
 
+uint32_t COMPILER::BC_CodeOffset() const
+{
+    // byte code offset of the next token, same as InstructionPointer when not running pre-decoded code
+    if (pRunOps == nullptr)
+    {
+        return InstructionPointer;
+    }
+    if (InstructionPointer == 0)
+    {
+        return pRunOps[0].offset;
+    }
+    const BC_OP &op = pRunOps[InstructionPointer - 1];
+    return op.data_offset + op.data_size;
+}
+
+void COMPILER::BC_PreDecode(SEGMENT_DESC &Segment)
+{
+    // decode token headers and the leading operand once, so runtime doesnt parse variable length headers, read
+    // operands from byte code and resolve jump offsets
+    auto &ops = Segment.ops;
+    ops.clear();
+
+    const char *pCodeBase = Segment.pCode;
+    uint32_t offset = 0;
+    while (offset < Segment.BCode_Program_size)
+    {
+        BC_OP op;
+        op.offset = offset;
+        op.type = static_cast<S_TOKEN_TYPE>(pCodeBase[offset]);
+        offset++;
+        if (offset >= Segment.BCode_Program_size)
+        {
+            break;
+        }
+        if (static_cast<uint8_t>(pCodeBase[offset]) < 0xff)
+        {
+            op.data_size = static_cast<uint8_t>(pCodeBase[offset]);
+            offset++;
+        }
+        else
+        {
+            offset++;
+            if (offset + sizeof(uint32_t) > Segment.BCode_Program_size)
+            {
+                break;
+            }
+            memcpy(&op.data_size, &pCodeBase[offset], sizeof(uint32_t));
+            offset += sizeof(uint32_t);
+        }
+        op.data_offset = offset;
+        op.jump = INVALID_OP_INDEX;
+        offset += op.data_size;
+        if (offset > Segment.BCode_Program_size || offset < op.data_offset)
+        {
+            break;
+        }
+        op.arg = 0;
+        if (op.data_size >= sizeof(uint32_t))
+        {
+            memcpy(&op.arg, &pCodeBase[op.data_offset], sizeof(uint32_t));
+        }
+        ops.push_back(op);
+    }
+
+    if (offset != Segment.BCode_Program_size)
+    {
+        // malformed code, execute it as is
+        SetWarning("Segment (%s) byte code cant be pre-decoded", Segment.name.c_str());
+        ops.clear();
+        ops.shrink_to_fit();
+        return;
+    }
+
+    const auto find_op = [&ops](uint32_t code_offset) -> uint32_t {
+        const auto it = std::lower_bound(ops.begin(), ops.end(), code_offset,
+                                         [](const BC_OP &op, uint32_t value) { return op.offset < value; });
+        if (it == ops.end() || it->offset != code_offset)
+        {
+            return INVALID_OP_INDEX;
+        }
+        return static_cast<uint32_t>(it - ops.begin());
+    };
+
+    for (auto &op : ops)
+    {
+        if ((op.type == JUMP || op.type == JUMP_Z || op.type == JUMP_NZ) && op.data_size >= sizeof(uint32_t))
+        {
+            op.jump = find_op(op.arg);
+        }
+    }
+
+    for (size_t n = 0; n < FuncTab.GetFuncNum(); n++)
+    {
+        const auto fi = FuncTab.GetFuncRef(n);
+        if (fi && fi->segment_id == Segment.id)
+        {
+            FuncTab.SetFuncOpIndex(n, find_op(fi->offset));
+        }
+    }
+}
+
 bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult)
 {
-    FuncInfo call_fi;
     uint32_t mem_ip;
     uint32_t mem_InstructionPointer;
-    FuncInfo *mem_pfi;
+    FUNC_FRAME *mem_pfi;
+    const BC_OP *mem_ops;
     //    DATA * pV;
     const char *mem_codebase;
     uint32_t arguments;
@@ -3625,7 +3804,8 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     CompilerStage = CS_RUNTIME;
 
     // get func info
-    if (!FuncTab.GetFunc(call_fi, func_code))
+    const FuncInfoRef call_fi = FuncTab.GetFuncRef(func_code);
+    if (!call_fi)
     {
         SetError("Invalid function call");
         return false;
@@ -3634,7 +3814,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     // TODO: only do if stack debug if enabled (should be runtime configurable)
     // push function details to call stack
     storm::ringbuffer_stack_push_guard push_guard(callStack_);
-    push_guard.push(std::make_tuple(call_fi.decl_file_name.c_str(), call_fi.decl_line, call_fi.name.c_str()));
+    push_guard.push(std::make_tuple(call_fi->decl_file_name.c_str(), call_fi->decl_line, call_fi->name.c_str()));
 
     // number f arguments pushed into stack for this function call
     if (BC_TokenGet() != ARGS_NUM)
@@ -3642,7 +3822,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
         SetError("missing args_num token");
         return false;
     }
-    arguments = *((int32_t *)&pRunCodeBase[TLR_DataOffset]);
+    arguments = static_cast<int32_t>(TLR_Arg);
 
     check_sp = SStack.GetDataNum() - arguments;
     /*
@@ -3691,12 +3871,13 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     mem_ip = ip;
     mem_pfi = pRun_fi;
     mem_codebase = pRunCodeBase;
+    mem_ops = pRunOps;
 
 #ifdef _WIN32 // S_DEBUG
     // nDebugEnterMode = CDebug->GetTraceMode();
 #endif
     uint64_t nTicks;
-    if (call_fi.segment_id == INTERNAL_SEGMENT_ID)
+    if (call_fi->segment_id == INTERNAL_SEGMENT_ID)
     {
         if (bRuntimeLog)
         {
@@ -3716,14 +3897,14 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
             core_internal.Trace("Invalid func_code = %u for AddTime", func_code);
         }
     }
-    else if (call_fi.segment_id == IMPORTED_SEGMENT_ID)
+    else if (call_fi->segment_id == IMPORTED_SEGMENT_ID)
     {
         pVResult = nullptr;
         RDTSC_B(nTicks);
-        const uint32_t nResult = call_fi.imported_func(&SStack);
+        const uint32_t nResult = call_fi->imported_func(&SStack);
         if (nResult == IFUNCRESULT_OK)
         {
-            if (call_fi.return_type != TVOID)
+            if (call_fi->return_type != TVOID)
             {
                 pVResult = SStack.Read();
             }
@@ -3756,7 +3937,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     {
         if (check_sp != (SStack.GetDataNum() - 1))
         {
-            SetError("function '%s' stack error", call_fi.name.c_str());
+            SetError("function '%s' stack error", call_fi->name.c_str());
 
             pRun_fi = mem_pfi;
             InstructionPointer = mem_InstructionPointer;
@@ -3772,7 +3953,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     {
         if (check_sp != SStack.GetDataNum())
         {
-            SetError("function '%s' stack error", call_fi.name.c_str());
+            SetError("function '%s' stack error", call_fi->name.c_str());
             pRun_fi = mem_pfi;
             InstructionPointer = mem_InstructionPointer;
             ip = mem_ip;
@@ -3791,6 +3972,7 @@ bool COMPILER::BC_CallFunction(uint32_t func_code, uint32_t &ip, DATA *&pVResult
     if (pRun_fi)
         RunningSegmentID = pRun_fi->segment_id;
     pRunCodeBase = mem_codebase;
+    pRunOps = mem_ops;
 
     return true;
 }
@@ -3809,7 +3991,9 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
     uint32_t bLeftOperandType;
     int32_t nLeftOperandIndex;
     S_TOKEN_TYPE Token_type;
-    FuncInfo fi;
+    static const FuncInfo debug_expression_fi;
+    const FuncInfo *fi = &debug_expression_fi;
+    FUNC_FRAME frame{};
     const VarInfo *real_var;
     DATA *pV;
     DATA *pVResult;
@@ -3851,34 +4035,36 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
 
     if (pDbgExpSource == nullptr)
     {
-        if (!FuncTab.GetFunc(fi, function_code))
+        frame.info = FuncTab.GetFuncRef(function_code);
+        if (!frame.info)
         {
-            SetError("Invalid function: %s", fi.name.c_str());
+            SetError("Invalid function: %u", function_code);
             return false;
         }
+        fi = frame.info.get();
 
-        if (fi.offset == INVALID_FUNC_OFFSET)
+        if (fi->offset == INVALID_FUNC_OFFSET)
         {
-            SetError("Function (%s) isnt loaded", fi.name.c_str());
+            SetError("Function (%s) isnt loaded", fi->name.c_str());
             return false;
         }
 
-        if (fi.segment_id == INTERNAL_SEGMENT_ID)
+        if (fi->segment_id == INTERNAL_SEGMENT_ID)
         {
-            SetError("Function (%s) is internal", fi.name.c_str());
+            SetError("Function (%s) is internal", fi->name.c_str());
             return false;
         }
 
-        if (fi.segment_id == IMPORTED_SEGMENT_ID)
+        if (fi->segment_id == IMPORTED_SEGMENT_ID)
         {
-            SetError("Function (%s) is imported", fi.name.c_str());
+            SetError("Function (%s) is imported", fi->name.c_str());
             return false;
         }
 
-        segment_index = GetSegmentIndex(fi.segment_id);
+        segment_index = GetSegmentIndex(fi->segment_id);
         if (segment_index == INVALID_SEGMENT_INDEX)
         {
-            SetError("Function (%s) segment not loaded", fi.name.c_str());
+            SetError("Function (%s) segment not loaded", fi->name.c_str());
             return false;
         }
         if (SegmentTable[segment_index].pCode == nullptr)
@@ -3890,16 +4076,18 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
         // Trace("-----------------------------------------------------------------");
         // Trace("Execute function: %s",fi.name);
 
-        RunningSegmentID = fi.segment_id;
-        fi.stack_offset = SStack.GetDataNum() - fi.arguments; // set stack offset
+        RunningSegmentID = fi->segment_id;
+        frame.func_code = function_code;
+        frame.segment_id = fi->segment_id;
+        frame.stack_offset = SStack.GetDataNum() - fi->arguments; // set stack offset
 
         // check arguments types
-        for (n = 0; n < fi.arguments; n++)
+        for (n = 0; n < fi->arguments; n++)
         {
-            if (fi.local_vars[n].type == VAR_REFERENCE)
+            if (fi->local_vars[n].type == VAR_REFERENCE)
                 continue;
-            pV = SStack.Read(fi.stack_offset, n);
-            if (pV->GetType() != fi.local_vars[n].type)
+            pV = SStack.Read(frame.stack_offset, n);
+            if (pV->GetType() != fi->local_vars[n].type)
             {
                 pV = pV->GetVarPointer();
                 if (!pV)
@@ -3908,36 +4096,43 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                     return false;
                 }
 
-                if (fi.local_vars[n].type == VAR_AREFERENCE && pV->GetType() == VAR_OBJECT)
+                if (fi->local_vars[n].type == VAR_AREFERENCE && pV->GetType() == VAR_OBJECT)
                     continue;
 
                 // TODO: remove and fix
-                if (false && pV->GetType() != fi.local_vars[n].type)
+                if (false && pV->GetType() != fi->local_vars[n].type)
                 {
-                    SetWarning("wrong type of argument %d  %s(%s) <-- [%s]", n, fi.name.c_str(),
-                               Token.GetTypeName(fi.local_vars[n].type), Token.GetTypeName(pV->GetType()));
+                    SetWarning("wrong type of argument %d  %s(%s) <-- [%s]", n, fi->name.c_str(),
+                               Token.GetTypeName(fi->local_vars[n].type), Token.GetTypeName(pV->GetType()));
                 }
             }
         }
 
-        for (n = fi.arguments; n < fi.local_vars.size(); n++)
+        for (n = fi->arguments; n < fi->local_vars.size(); n++)
         {
             pV = SStack.Push();
-            pV->SetType(fi.local_vars[n].type, fi.local_vars[n].elements);
+            pV->SetType(fi->local_vars[n].type, fi->local_vars[n].elements);
         }
 
-        pRun_fi = &fi; // set pointer to 'this' function info
+        pRun_fi = &frame; // set pointer to 'this' function frame
 
-        InstructionPointer = fi.offset;
+        InstructionPointer = fi->offset;
 
         pCodeBase = SegmentTable[segment_index].pCode;
         pRunCodeBase = pCodeBase;
+        pRunOps = nullptr;
+        if (fi->op_index != INVALID_OP_INDEX && !SegmentTable[segment_index].ops.empty())
+        {
+            InstructionPointer = fi->op_index;
+            pRunOps = SegmentTable[segment_index].ops.data();
+        }
     }
     else
     {
         InstructionPointer = 0;
         pCodeBase = pDbgExpSource;
         pRunCodeBase = pCodeBase;
+        pRunOps = nullptr;
     }
 
     inout = 0;
@@ -3984,12 +4179,12 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             SStack.Pop();
             break;
         case JUMP:
-            memcpy(&jump_offset, &pCodeBase[ip], sizeof(uint32_t));
+            jump_offset = TLR_Arg;
             if (!BC_Jump(SegmentTable[segment_index], jump_offset))
                 return false;
             break;
         case JUMP_Z:
-            memcpy(&jump_offset, &pCodeBase[ip], sizeof(uint32_t));
+            jump_offset = TLR_Arg;
             ExpressionResult.Convert(VAR_INTEGER);
             ExpressionResult.Get(lvalue);
             if (lvalue)
@@ -3998,7 +4193,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 return false;
             break;
         case JUMP_NZ:
-            memcpy(&jump_offset, &pCodeBase[ip], sizeof(uint32_t));
+            jump_offset = TLR_Arg;
             ExpressionResult.Convert(VAR_INTEGER);
             ExpressionResult.Get(lvalue);
             if (lvalue == 0)
@@ -4009,13 +4204,13 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
         case LOCAL_VARIABLE:
             pLeftOperandAClass = nullptr;            // reset attribute
             nLeftOperandIndex = INVALID_ARRAY_INDEX; // reset index
-            nLeftOperandCode = *((int32_t *)&pRunCodeBase[TLR_DataOffset]);
+            nLeftOperandCode = static_cast<int32_t>(TLR_Arg);
             bLeftOperandType = LOCAL_VARIABLE;
             break;
         case VARIABLE:
             pLeftOperandAClass = nullptr;            // reset attribute
             nLeftOperandIndex = INVALID_ARRAY_INDEX; // reset index
-            nLeftOperandCode = *((int32_t *)&pRunCodeBase[TLR_DataOffset]);
+            nLeftOperandCode = static_cast<int32_t>(TLR_Arg);
             bLeftOperandType = VARIABLE;
             break;
         case ACCESS_WORD_CODE:
@@ -4057,7 +4252,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                     return false;
                 }
                 pLeftOperandAClass =
-                    pLeftOperandAClass->VerifyAttributeClassByCode(*((int32_t *)&pRunCodeBase[TLR_DataOffset]));
+                    pLeftOperandAClass->VerifyAttributeClassByCode(static_cast<int32_t>(TLR_Arg));
                 break;
             }
             if (pLeftOperandAClass == nullptr)
@@ -4090,7 +4285,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 return false;
             }
             pLeftOperandAClass =
-                pLeftOperandAClass->VerifyAttributeClassByCode(*((int32_t *)&pRunCodeBase[TLR_DataOffset]));
+                pLeftOperandAClass->VerifyAttributeClassByCode(static_cast<int32_t>(TLR_Arg));
             break;
             break;
         case ACCESS_WORD:
@@ -4204,7 +4399,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 }
 
                 vtype = BC_TokenGet();
-                var_code = *((int32_t *)&pRunCodeBase[TLR_DataOffset]);
+                var_code = static_cast<int32_t>(TLR_Arg);
                 if (!(vtype == VARIABLE || vtype == LOCAL_VARIABLE))
                 {
                     SetError("invalid access var");
@@ -4267,7 +4462,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             }
 
             vtype = BC_TokenGet();
-            var_code = *((int32_t *)&pRunCodeBase[TLR_DataOffset]);
+            var_code = static_cast<int32_t>(TLR_Arg);
             if (!(vtype == VARIABLE || vtype == LOCAL_VARIABLE))
             {
                 SetError("invalid access var");
@@ -4385,7 +4580,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
 
         case CALL:                                                  // undetermined function call
             vtype = BC_TokenGet();                                  // read variable
-            var_code = *((int32_t *)&pRunCodeBase[TLR_DataOffset]); // var code
+            var_code = static_cast<int32_t>(TLR_Arg); // var code
             if (vtype == VARIABLE)
             {
                 real_var = VarTab.GetVar(var_code);
@@ -4432,24 +4627,24 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 ExpressionResult.Set(0);
             break;
         case CALL_FUNCTION:
-            memcpy(&func_code, &pCodeBase[ip], sizeof(uint32_t));
+            func_code = TLR_Arg;
             pVResult = nullptr;
             if (!BC_CallFunction(func_code, ip, pVResult))
                 return false;
             // if(pVResult) SStack.Pop();
             break;
         case FUNCTION_RETURN_VOID:
-            if (fi.return_type != TVOID)
+            if (fi->return_type != TVOID)
             {
                 SetError("function must return value");
                 return false;
             }
             // for(n=0;n<fi.var_num;n++) SStack.Pop();
-            SStack.InvalidateFrom(fi.stack_offset);
+            SStack.InvalidateFrom(frame.stack_offset);
 
             return true;
         case FUNCTION_RETURN:
-            if (fi.return_type == TVOID)
+            if (fi->return_type == TVOID)
             {
                 SetError("void function return value");
 
@@ -4458,7 +4653,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             // at this moment result expression placed in EX register
 
             if (pDbgExpSource == nullptr) // skip stack unwind for dbg expression process    // ????????
-                SStack.InvalidateFrom(fi.stack_offset);
+                SStack.InvalidateFrom(frame.stack_offset);
 
             // copy result into stack
             pV = SStack.Push();
@@ -4467,15 +4662,15 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
 
             // check return type
             if (pDbgExpSource == nullptr) // skip test for dbg expression process
-                if (fi.return_type != pV->GetType())
+                if (fi->return_type != pV->GetType())
                 {
-                    if (fi.return_type == VAR_INTEGER && pV->GetType() == VAR_PTR)
+                    if (fi->return_type == VAR_INTEGER && pV->GetType() == VAR_PTR)
                     {
                         pV->Convert(VAR_INTEGER);
                         return true;
                     }
 
-                    SetError("%s function return %s value", Token.GetTypeName(fi.return_type),
+                    SetError("%s function return %s value", Token.GetTypeName(fi->return_type),
                              Token.GetTypeName(pV->GetType()));
                     return false;
                 }
@@ -5084,7 +5279,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 pVDst->SetType(VAR_REFERENCE);
                 break;
             case VARIABLE:
-                real_var = VarTab.GetVar(*((uint32_t *)&pCodeBase[ip]));
+                real_var = VarTab.GetVar(TLR_Arg);
                 if (real_var == nullptr)
                 {
                     SetError("Global variable not found");
@@ -5102,7 +5297,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 }
                 break;
             case LOCAL_VARIABLE:
-                pVDst = SStack.Read(pRun_fi->stack_offset, *((uint32_t *)&pCodeBase[ip]));
+                pVDst = SStack.Read(pRun_fi->stack_offset, TLR_Arg);
                 if (pVDst == nullptr)
                 {
                     SetError("Local variable not found");
@@ -5132,7 +5327,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             switch (Token_type)
             {
             case VARIABLE:
-                real_var = VarTab.GetVar(*((uint32_t *)&pCodeBase[ip]));
+                real_var = VarTab.GetVar(TLR_Arg);
                 if (real_var == nullptr)
                 {
                     SetError("Global variable not found");
@@ -5146,7 +5341,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                     return false;
                 break;
             case LOCAL_VARIABLE:
-                pVSrc = SStack.Read(pRun_fi->stack_offset, *((uint32_t *)&pCodeBase[ip]));
+                pVSrc = SStack.Read(pRun_fi->stack_offset, TLR_Arg);
                 if (pVSrc == nullptr)
                 {
                     SetError("Local variable not found");
@@ -5350,16 +5545,16 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             switch (Token_type)
             {
             case NUMBER:
-                pV->Set(*((int32_t *)&pRunCodeBase[TLR_DataOffset]));
+                pV->Set(static_cast<int32_t>(TLR_Arg));
                 break;
             case FLOAT_NUMBER:
-                pV->Set(*((float *)&pRunCodeBase[TLR_DataOffset]));
+                pV->Set(std::bit_cast<float>(TLR_Arg));
                 break;
             case STRING:
                 pV->Set((char *)&pRunCodeBase[TLR_DataOffset + 4]); // 4 - string length
                 break;
             case VARIABLE:
-                real_var = VarTab.GetVar(*((uint32_t *)&pCodeBase[ip]));
+                real_var = VarTab.GetVar(TLR_Arg);
                 if (real_var == nullptr)
                 {
                     SetError("Global variable not found");
@@ -5407,7 +5602,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
 
                 break;
             case LOCAL_VARIABLE:
-                pVar = SStack.Read(pRun_fi->stack_offset, *((uint32_t *)&pCodeBase[ip]));
+                pVar = SStack.Read(pRun_fi->stack_offset, TLR_Arg);
                 if (pVar == nullptr)
                 {
                     SetError("Local variable not found");
@@ -5492,7 +5687,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             switch (Token_type)
             {
             case VARIABLE:
-                real_var = VarTab.GetVar(*((uint32_t *)&pCodeBase[ip]));
+                real_var = VarTab.GetVar(TLR_Arg);
                 if (real_var == nullptr)
                 {
                     SetError("Global variable not found");
@@ -5502,7 +5697,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                 real_var->value->Copy(pV);
                 break;
             case LOCAL_VARIABLE:
-                pVar = SStack.Read(pRun_fi->stack_offset, *((uint32_t *)&pCodeBase[ip]));
+                pVar = SStack.Read(pRun_fi->stack_offset, TLR_Arg);
                 if (pVar == nullptr)
                 {
                     SetError("Local variable not found");
@@ -5687,14 +5882,14 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
             {
             case ACCESS_WORD_CODE:
                 if (sttV == VERIFY_AP)
-                    rAP = rAP->VerifyAttributeClassByCode(*((int32_t *)&pRunCodeBase[TLR_DataOffset]));
+                    rAP = rAP->VerifyAttributeClassByCode(static_cast<int32_t>(TLR_Arg));
                 else
-                    rAP = rAP->GetAttributeClassByCode(*((int32_t *)&pRunCodeBase[TLR_DataOffset]));
+                    rAP = rAP->GetAttributeClassByCode(static_cast<int32_t>(TLR_Arg));
                 if (!rAP)
-                    SetError("missed attribute: %s", SCodec.Convert(*((int32_t *)&pRunCodeBase[TLR_DataOffset])));
+                    SetError("missed attribute: %s", SCodec.Convert(static_cast<int32_t>(TLR_Arg)));
                 break;
             case VARIABLE:
-                real_var = VarTab.GetVar(*((int32_t *)&pRunCodeBase[TLR_DataOffset]));
+                real_var = VarTab.GetVar(static_cast<int32_t>(TLR_Arg));
                 if (real_var == nullptr)
                 {
                     SetError("Global variable not found");
@@ -5722,7 +5917,7 @@ bool COMPILER::BC_Execute(uint32_t function_code, DATA *&pVReturnResult, const c
                     SetError("missed attribute: %s", pChar);
                 break;
             case LOCAL_VARIABLE:
-                pV = SStack.Read(pRun_fi->stack_offset, *((int32_t *)&pRunCodeBase[TLR_DataOffset]));
+                pV = SStack.Read(pRun_fi->stack_offset, static_cast<int32_t>(TLR_Arg));
                 if (pV == nullptr)
                 {
                     SetError("Local variable not found");
@@ -5963,7 +6158,10 @@ void COMPILER::SaveData(const void *data_PTR, uint32_t data_size)
 
     if (dwCurPointer + data_size > dwMaxSize)
     {
-        const uint32_t dwNewAllocate = (1 + (dwCurPointer + data_size) / (1024 * 1024)) * (1024 * 1024);
+        // Doubling keeps the copies linear in the state size
+        uint32_t dwNewAllocate = std::max(dwMaxSize, 1024u * 1024u);
+        while (dwNewAllocate < dwCurPointer + data_size)
+            dwNewAllocate = dwNewAllocate > UINT32_MAX / 2 ? UINT32_MAX : dwNewAllocate * 2;
         // pBuffer = (char*)RESIZE(pBuffer, dwNewAllocate);
         auto *const newPtr = new char[dwNewAllocate];
         memcpy(newPtr, pBuffer, dwMaxSize);
@@ -6505,7 +6703,7 @@ void COMPILER::SaveVariable(DATA *pV, bool bdim)
             eid = invalid_entity;
         }
         SaveData(&eid, sizeof(eid));
-        SaveAttributesData(pV->AttributesClass);
+        SaveAttributesData(pV->AttributesClass, delta_save_ && IsSavedRoot(pV));
         break;
     case VAR_REFERENCE:
 
@@ -6572,9 +6770,10 @@ bool COMPILER::OnLoad()
     return true;
 }
 
-bool COMPILER::SaveState(std::fstream &fileS)
+bool COMPILER::SaveState(const char *file_name)
 {
     uint32_t n;
+    const auto startTime = std::chrono::steady_clock::now();
     delete[] pBuffer;
     pBuffer = nullptr;
 
@@ -6586,6 +6785,18 @@ bool COMPILER::SaveState(std::fstream &fileS)
     if (function_code != INVALID_FUNC_CODE)
         BC_Execute(function_code, pResult);
 
+    // OnSave may change attributes too, the epoch of this save ends after it
+    const uint32_t epoch = ATTRIBUTES::NextSaveEpoch();
+    auto savePath = SaveFilePath(file_name);
+    delta_save_ = CanSaveDelta(savePath);
+    const uint64_t saveId = NewSaveId();
+    const uint64_t baseId = delta_save_ ? last_save_id_ : 0;
+    if (!delta_save_)
+    {
+        save_chain_length_ = 0;
+        save_chain_broken_ = std::make_shared<std::atomic_bool>(false);
+    }
+
     EXTDATA_HEADER edh;
     auto *pVDat = static_cast<VDATA *>(core_internal.GetScriptVariable("savefile_info"));
     if (pVDat && pVDat->GetString())
@@ -6595,8 +6806,6 @@ bool COMPILER::SaveState(std::fstream &fileS)
     edh.dwExtDataOffset = 0;
     edh.dwExtDataSize = 0;
 
-    fio->_WriteFile(fileS, &edh, sizeof(edh));
-
     // 1. Program Directory
     SaveString(ProgramDirectory);
 
@@ -6644,30 +6853,116 @@ bool COMPILER::SaveState(std::fstream &fileS)
         SaveVariable(real_var->value.get());
     }
 
-    uint64_t dw2;
-    if (dwCurPointer)
-    {
-        char *pDst = new char[dwCurPointer * 2];
-        uLongf ulPackLen = dwCurPointer * 2;
-        RDTSC_B(dw2);
-        compress2((Bytef *)pDst, &ulPackLen, (Bytef *)pBuffer, dwCurPointer, Z_BEST_COMPRESSION);
-        RDTSC_E(dw2);
-        uint32_t uiPackLen = ulPackLen;
+    // The next delta extends this save
+    delta_save_ = false;
+    save_chain_length_++;
+    last_save_id_ = saveId;
+    last_save_folder_ = savePath.parent_path();
+    last_save_epoch_ = epoch;
+    CollectSavedRoots();
+    const bool keepBase = save_chain_length_ <= max_save_deltas_;
 
-        fio->_WriteFile(fileS, &dwCurPointer, sizeof(dwCurPointer));
-        fio->_WriteFile(fileS, &uiPackLen, sizeof(uiPackLen));
-        fio->_WriteFile(fileS, pDst, uiPackLen);
+    // The serialized variables are the snapshot, packing and writing them needs nothing from the VM anymore
+    std::shared_ptr<char[]> data(pBuffer);
+    const auto dataSize = dwCurPointer;
+    pBuffer = nullptr;
+    dwCurPointer = 0;
+    dwMaxSize = 0;
+    const auto snapshotTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime);
 
-        delete[] pDst;
+    auto write = [fileName = std::string(file_name), savePath = std::move(savePath), edh, data, dataSize,
+                  level = save_level_, snapshotTime, saveId, baseId, keepBase, isBroken = save_chain_broken_] {
+        const auto packTime = std::chrono::steady_clock::now();
+        auto fileS = fio->_CreateFile(fileName.c_str(), std::ios::binary | std::ios::out);
+        if (!fileS.is_open())
+        {
+            *isBroken = true;
+            spdlog::error("Can't create save file {}", fileName);
+            return false;
+        }
+        auto isWritten = fio->_WriteFile(fileS, &edh, sizeof(edh));
+        if (isWritten && dataSize)
+        {
+            const auto marker = storm::state_packer::kStateMarker;
+            isWritten = fio->_WriteFile(fileS, &dataSize, sizeof(dataSize)) &&
+                        fio->_WriteFile(fileS, &marker, sizeof(marker)) &&
+                        fio->_WriteFile(fileS, &saveId, sizeof(saveId)) &&
+                        fio->_WriteFile(fileS, &baseId, sizeof(baseId)) &&
+                        storm::state_packer::Pack(fileS, data.get(), dataSize, level);
+        }
+        fio->_CloseFile(fileS);
+        if (!isWritten)
+        {
+            // deltas on top of this file would not load
+            *isBroken = true;
+            spdlog::error("Failed to write save file {}", fileName);
+            return false;
+        }
+        // The slot may be overwritten or deleted later, the next delta is applied on an engine copy
+        if (keepBase && !storm::save_chain::KeepBase(savePath, saveId))
+        {
+            *isBroken = true;
+            spdlog::warn("Can't keep the base of save file {}, the next save is full", fileName);
+        }
+        storm::save_chain::PruneBases(savePath.parent_path(), keepBase ? saveId : 0);
+        spdlog::trace("Saved {}{}: {} bytes, snapshot {:.1f} ms, pack and write {:.1f} ms", fileName,
+                      baseId ? " as delta" : "", dataSize, snapshotTime.count(),
+                      std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - packTime).count());
+        return true;
+    };
+
+    // Files of earlier saves can still be in the queue
+    if (!background_save_)
+    {
+        state_queue_.Wait();
+        return write();
     }
+    state_queue_.Push(std::move(write));
+    return true;
+}
 
+bool COMPILER::WaitStateSaving()
+{
+    state_queue_.Wait();
+    const auto numFailed = state_queue_.NumFailed();
+    const bool isSaved = numFailed == waited_save_failures_;
+    waited_save_failures_ = numFailed;
+    return isSaved;
+}
+
+bool COMPILER::LoadState(std::fstream &fileS, const char *file_name)
+{
+    uint64_t saveId;
+    const auto savePath = SaveFilePath(file_name);
+    save_chain_length_ = 0;
+    save_chain_broken_ = std::make_shared<std::atomic_bool>(false);
+    const bool isLoaded = LoadStateFile(fileS, file_name, storm::save_chain::BasesFolder(savePath), saveId, 0);
+    delta_load_ = false;
     delete[] pBuffer;
     pBuffer = nullptr;
+    if (!isLoaded)
+    {
+        save_chain_length_ = 0;
+        return false;
+    }
+
+    // The next delta extends the loaded state, changes made by OnLoad go into it.
+    // It is applied on an engine copy of the loaded save, the slot itself may be overwritten
+    last_save_id_ = saveId;
+    last_save_folder_ = savePath.parent_path();
+    if (saveId != 0 && save_chain_length_ <= max_save_deltas_ && !storm::save_chain::KeepBase(savePath, saveId))
+        *save_chain_broken_ = true;
+    last_save_epoch_ = ATTRIBUTES::NextSaveEpoch();
+    CollectSavedRoots();
+
+    // call to script function "OnLoad()"
+    OnLoad();
 
     return true;
 }
 
-bool COMPILER::LoadState(std::fstream &fileS)
+bool COMPILER::LoadStateFile(std::fstream &fileS, const char *file_name, const std::filesystem::path &bases_folder,
+                             uint64_t &save_id, uint32_t depth)
 {
     uint32_t n;
     char *pString;
@@ -6681,21 +6976,82 @@ bool COMPILER::LoadState(std::fstream &fileS)
     uint32_t dwPackLen;
     fio->_ReadFile(fileS, &dwMaxSize, sizeof(dwMaxSize));
     fio->_ReadFile(fileS, &dwPackLen, sizeof(dwPackLen));
-    if (dwPackLen == 0 || dwPackLen > 0x8000000 || dwMaxSize == 0 || dwMaxSize > 0x8000000)
+    uint64_t baseId = 0;
+    save_id = 0;
+    if (dwPackLen == storm::state_packer::kStateMarker)
     {
-        return false;
+        fio->_ReadFile(fileS, &save_id, sizeof(save_id));
+        fio->_ReadFile(fileS, &baseId, sizeof(baseId));
+
+        // A delta is applied on top of the chain of saves it extends, the bases are engine-owned copies
+        if (baseId != 0)
+        {
+            if (depth >= MAX_SAVE_CHAIN)
+            {
+                SetError("save chain is too long: %s", file_name);
+                return false;
+            }
+            const auto basePath = storm::save_chain::BasePath(bases_folder, baseId);
+            const auto baseName = basePath.string();
+            std::fstream baseS(basePath, std::ios::binary | std::ios::in);
+            if (!baseS.is_open())
+            {
+                SetError("missing base save: %s", baseName.c_str());
+                return false;
+            }
+            uint64_t loadedId;
+            const bool isLoaded = LoadStateFile(baseS, baseName.c_str(), bases_folder, loadedId, depth + 1);
+            fio->_CloseFile(baseS);
+            if (!isLoaded)
+            {
+                return false;
+            }
+            if (loadedId != baseId)
+            {
+                SetError("corrupted base save: %s", baseName.c_str());
+                return false;
+            }
+        }
+    }
+
+    if (dwPackLen == storm::state_packer::kStateMarker || dwPackLen == storm::state_packer::kChunkedMarker)
+    {
+        if (dwMaxSize == 0 || dwMaxSize > 0x40000000)
+        {
+            return false;
+        }
+        pBuffer = new char[dwMaxSize];
+        if (!storm::state_packer::Unpack(fileS, pBuffer, dwMaxSize))
+        {
+            SetError("corrupted save state");
+            delete[] pBuffer;
+            pBuffer = nullptr;
+            return false;
+        }
+    }
+    else
+    {
+        // States saved as a single block
+        if (dwPackLen == 0 || dwPackLen > 0x8000000 || dwMaxSize == 0 || dwMaxSize > 0x8000000)
+        {
+            return false;
+        }
+        char *pCBuffer = new char[dwPackLen];
+        pBuffer = new char[dwMaxSize];
+        fio->_ReadFile(fileS, pCBuffer, dwPackLen);
+        uLongf ulMaxSize = dwMaxSize;
+        uncompress((Bytef *)pBuffer, &ulMaxSize, (Bytef *)pCBuffer, dwPackLen);
+        dwMaxSize = ulMaxSize;
+        delete[] pCBuffer;
     }
-    char *pCBuffer = new char[dwPackLen];
-    pBuffer = new char[dwMaxSize];
-    fio->_ReadFile(fileS, pCBuffer, dwPackLen);
-    uLongf ulMaxSize = dwMaxSize;
-    uncompress((Bytef *)pBuffer, &ulMaxSize, (Bytef *)pCBuffer, dwPackLen);
-    dwMaxSize = ulMaxSize;
-    delete[] pCBuffer;
     dwCurPointer = 0;
 
+    // A delta only updates the variables, the program is loaded by its base
+    delta_load_ = baseId != 0;
+
     // Release all data
-    Release();
+    if (!delta_load_)
+        Release();
 
     // save specific data (name, time, etc)
     // DWORD nSDataSize = ReadVDword();
@@ -6706,16 +7062,24 @@ bool COMPILER::LoadState(std::fstream &fileS)
     // Read(&edh, sizeof(edh));
 
     // 1. Program Directory
-    ProgramDirectory = ReadString();
+    pString = ReadString();
+    if (delta_load_)
+        delete[] pString;
+    else
+        ProgramDirectory = pString;
 
     // 4. SCodec data
+    // a delta names attributes with the codes of the session that saved it, they may differ from the loaded ones
+    delta_name_codes_.Clear();
     const uint32_t nSCStringsNum = ReadVDword();
     for (n = 0; n < nSCStringsNum; n++)
     {
         pString = ReadString();
         if (pString)
         {
-            SCodec.Convert(pString);
+            const uint32_t nCode = SCodec.Convert(pString);
+            if (delta_load_)
+                delta_name_codes_.Add(SCodec.MakeHashValue(pString) & (HASH_TABLE_SIZE - 1), nCode);
             delete[] pString;
         }
     }
@@ -6725,13 +7089,16 @@ bool COMPILER::LoadState(std::fstream &fileS)
     // 3.  Segments names
     // 3.a Initialize internal functions
     // 3.b Load preprocess
-    InitInternalFunctions();
-    LoadPreprocess();
+    if (!delta_load_)
+    {
+        InitInternalFunctions();
+        LoadPreprocess();
+    }
 
     for (n = 0; n < nSegments2Load; n++)
     {
         char *pSegmentName = ReadString();
-        if (!BC_LoadSegment(pSegmentName))
+        if (!delta_load_ && !BC_LoadSegment(pSegmentName))
             return false;
         delete[] pSegmentName;
     }
@@ -6751,27 +7118,68 @@ bool COMPILER::LoadState(std::fstream &fileS)
         delete[] pString;
     }
 
-    // call to script function "OnLoad()"
-    OnLoad();
-
     delete[] pBuffer;
     pBuffer = nullptr;
 
+    save_chain_length_++;
     return true;
 }
 
-void COMPILER::ReadAttributesData(ATTRIBUTES *pRoot, ATTRIBUTES *pParent)
+bool COMPILER::CanSaveDelta(const std::filesystem::path &save_path) const
+{
+    // saves of older versions have no id to check a delta against
+    if (save_chain_length_ == 0 || save_chain_length_ > max_save_deltas_ || last_save_id_ == 0 || *save_chain_broken_)
+        return false;
+    // the base is kept in the folder of the last save
+    return save_path.parent_path() == last_save_folder_;
+}
+
+void COMPILER::CollectSavedRoots()
+{
+    saved_roots_.clear();
+    const uint32_t nVarNum = VarTab.GetVarNum();
+    for (uint32_t n = 0; n < nVarNum; n++)
+    {
+        const VarInfo *real_var = VarTab.GetVar(n);
+        if (real_var == nullptr || real_var->value->GetType() != VAR_OBJECT)
+            continue;
+        DATA *pV = real_var->value.get();
+        if (!pV->IsArray())
+        {
+            saved_roots_[pV] = pV->AttributesClass;
+            continue;
+        }
+        for (uint32_t i = 0; i < pV->GetElementsNum(); i++)
+        {
+            DATA *pElement = pV->GetArrayElement(i);
+            saved_roots_[pElement] = pElement->AttributesClass;
+        }
+    }
+}
+
+bool COMPILER::IsSavedRoot(DATA *pV) const
+{
+    const auto it = saved_roots_.find(pV);
+    return it != saved_roots_.end() && it->second != nullptr && it->second == pV->AttributesClass;
+}
+
+uint32_t COMPILER::ReadAttributesData(ATTRIBUTES *pRoot, ATTRIBUTES *pParent)
 {
     uint32_t nSubClassesNum;
     uint32_t n;
     uint32_t nNameCode;
     // char * pName;
     char *pValue;
+    // children in the order of a delta, the ones it misses were deleted after its base
+    std::vector<uint32_t> codes;
 
     if (pRoot == nullptr)
     {
         nSubClassesNum = ReadVDword();
-        nNameCode = ReadVDword();
+        nNameCode = LoadedNameCode(ReadVDword());
+        // unchanged since the base of the delta
+        if (nSubClassesNum == ATTRIBUTES_KEPT)
+            return nNameCode;
 
         // DTrace(SCodec.Convert(nNameCode));
         pValue = ReadString();
@@ -6780,14 +7188,20 @@ void COMPILER::ReadAttributesData(ATTRIBUTES *pRoot, ATTRIBUTES *pParent)
         delete[] pValue;
         for (n = 0; n < nSubClassesNum; n++)
         {
-            ReadAttributesData(nullptr, pRoot);
+            const uint32_t nCode = ReadAttributesData(nullptr, pRoot);
+            if (delta_load_)
+                codes.push_back(nCode);
         }
+        if (delta_load_)
+            storm::save_chain::PruneAttributes(*pRoot, codes);
 
-        return;
+        return nNameCode;
     }
 
     nSubClassesNum = ReadVDword();
-    nNameCode = ReadVDword();
+    nNameCode = LoadedNameCode(ReadVDword());
+    if (nSubClassesNum == ATTRIBUTES_KEPT)
+        return nNameCode;
     pValue = ReadString();
     // pRoot->SetAttribute(nNameCode,pValue);
 
@@ -6797,14 +7211,19 @@ void COMPILER::ReadAttributesData(ATTRIBUTES *pRoot, ATTRIBUTES *pParent)
     for (n = 0; n < nSubClassesNum; n++)
     {
         // ReadAttributesData(pRoot->GetAttributeClass(n));
-        ReadAttributesData(nullptr, pRoot);
+        const uint32_t nCode = ReadAttributesData(nullptr, pRoot);
+        if (delta_load_)
+            codes.push_back(nCode);
     }
+    if (delta_load_)
+        storm::save_chain::PruneAttributes(*pRoot, codes);
 
     // if(pName) delete pName;
     delete[] pValue;
+    return nNameCode;
 }
 
-void COMPILER::SaveAttributesData(ATTRIBUTES *pRoot)
+void COMPILER::SaveAttributesData(ATTRIBUTES *pRoot, bool bDelta)
 {
     if (pRoot == nullptr)
     {
@@ -6813,6 +7232,15 @@ void COMPILER::SaveAttributesData(ATTRIBUTES *pRoot)
         SaveString(nullptr); // attribute value
         return;
     }
+    // A moved subtree does not match the one of the same name in the base
+    if (bDelta && pRoot->IsMovedSince(last_save_epoch_))
+        bDelta = false;
+    if (bDelta && !pRoot->IsChangedSince(last_save_epoch_))
+    {
+        WriteVDword(ATTRIBUTES_KEPT);
+        WriteVDword(pRoot->GetThisNameCode());
+        return;
+    }
     WriteVDword(pRoot->GetAttributesNum()); // number of subclasses
 
     // save attribute name
@@ -6823,10 +7251,15 @@ void COMPILER::SaveAttributesData(ATTRIBUTES *pRoot)
     SaveString(pRoot->GetThisAttr());
     for (uint32_t n = 0; n < pRoot->GetAttributesNum(); n++)
     {
-        SaveAttributesData(pRoot->GetAttributeClass(n));
+        SaveAttributesData(pRoot->GetAttributeClass(n), bDelta);
     }
 }
 
+uint32_t COMPILER::LoadedNameCode(uint32_t code) const
+{
+    return delta_load_ ? delta_name_codes_.Loaded(code) : code;
+}
+
 void COMPILER::AddPostEvent(S_EVENTMSG *pEM)
 {
     EventMsg.Add(pEM);
@@ -6836,35 +7269,49 @@ bool COMPILER::SetSaveData(const char *file_name, void *save_data, int32_t data_
 {
     EXTDATA_HEADER exdh;
 
-    auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in | std::ios::out);
-    if (!fileS.is_open())
-    {
-        return false;
-    }
-
-    const uint32_t dwFileSize = fio->_GetFileSize(file_name);
     auto *pVDat = static_cast<VDATA *>(core_internal.GetScriptVariable("savefile_info"));
     if (pVDat && pVDat->GetString())
         sprintf_s(exdh.sFileInfo, sizeof(exdh.sFileInfo), "%s", pVDat->GetString());
     else
         sprintf_s(exdh.sFileInfo, sizeof(exdh.sFileInfo), "save");
-    exdh.dwExtDataOffset = dwFileSize;
     exdh.dwExtDataSize = data_size;
 
-    fio->_WriteFile(fileS, &exdh, sizeof(exdh));
-    fio->_SetFilePointer(fileS, dwFileSize, std::ios::beg);
+    // The state of this file may still be in the queue, the data goes after it
+    std::shared_ptr<char[]> data(new char[data_size]);
+    memcpy(data.get(), save_data, data_size);
+    auto write = [fileName = std::string(file_name), exdh, data, data_size]() mutable {
+        auto fileS = fio->_CreateFile(fileName.c_str(), std::ios::binary | std::ios::in | std::ios::out);
+        if (!fileS.is_open())
+        {
+            return false;
+        }
 
-    char *pDst = new char[data_size * 2];
-    uLongf ulPackLen = data_size * 2;
-    compress2((Bytef *)pDst, &ulPackLen, static_cast<Bytef *>(save_data), data_size, Z_BEST_COMPRESSION);
-    uint32_t uiPackLen = ulPackLen;
+        const uint32_t dwFileSize = fio->_GetFileSize(fileName.c_str());
+        exdh.dwExtDataOffset = dwFileSize;
 
-    fio->_WriteFile(fileS, &uiPackLen, sizeof(uiPackLen));
-    fio->_WriteFile(fileS, pDst, uiPackLen);
-    fio->_CloseFile(fileS);
+        fio->_WriteFile(fileS, &exdh, sizeof(exdh));
+        fio->_SetFilePointer(fileS, dwFileSize, std::ios::beg);
+
+        char *pDst = new char[data_size * 2];
+        uLongf ulPackLen = data_size * 2;
+        compress2((Bytef *)pDst, &ulPackLen, reinterpret_cast<Bytef *>(data.get()), data_size, Z_BEST_COMPRESSION);
+        uint32_t uiPackLen = ulPackLen;
 
-    delete[] pDst;
+        fio->_WriteFile(fileS, &uiPackLen, sizeof(uiPackLen));
+        fio->_WriteFile(fileS, pDst, uiPackLen);
+        fio->_CloseFile(fileS);
 
+        delete[] pDst;
+
+        return true;
+    };
+
+    if (!background_save_)
+    {
+        state_queue_.Wait();
+        return write();
+    }
+    state_queue_.Push(std::move(write));
     return true;
 }
 
@@ -6956,6 +7403,7 @@ bool COMPILER::SetSaveData(const char *file_name, void *save_data, int32_t data_
 
 void *COMPILER::GetSaveData(const char *file_name, int32_t &data_size)
 {
+    state_queue_.Wait();
     auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in);
     if (!fileS.is_open())
     {
@@ -7169,7 +7617,7 @@ DATA *COMPILER::GetOperand(const char *pCodeBase, uint32_t &ip, S_TOKEN_TYPE *pT
         pVar = SStack.Read();
         return pVar;
     case VARIABLE:
-        real_var = VarTab.GetVar(*reinterpret_cast<const uint32_t *>(&pCodeBase[ip]));
+        real_var = VarTab.GetVar(TLR_Arg);
         if (real_var == nullptr)
         {
             SetError("Global variable not found");
@@ -7182,7 +7630,7 @@ DATA *COMPILER::GetOperand(const char *pCodeBase, uint32_t &ip, S_TOKEN_TYPE *pT
         }
         return real_var->value.get();
     case LOCAL_VARIABLE:
-        pVar = SStack.Read(pRun_fi->stack_offset, *reinterpret_cast<const uint32_t *>(&pCodeBase[ip]));
+        pVar = SStack.Read(pRun_fi->stack_offset, TLR_Arg);
         if (pVar == nullptr)
         {
             SetError("Local variable not found");
@@ -7427,6 +7875,7 @@ void COMPILER::LoadByteCodeFromCache(storm::script_cache::BufferReader &reader,
 
     // apply relocations
     pRunCodeBase = segment.pCode;
+    pRunOps = nullptr;
     InstructionPointer = 0;
     S_TOKEN_TYPE token_type = END_OF_PROGRAMM;
     do
@@ -7542,6 +7991,7 @@ void COMPILER::SaveByteCodeToCache(storm::script_cache::BufferWriter &writer, co
     auto functions = std::unordered_map<uint32_t, std::string>();
 
     pRunCodeBase = segment.pCode;
+    pRunOps = nullptr;
     InstructionPointer = 0;
     auto token_type = S_TOKEN_TYPE();
     do
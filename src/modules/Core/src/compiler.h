@@ -1,7 +1,10 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string_view>
 #include <tuple>
+#include <unordered_map>
 
 #include "data.h"
 #include "message.h"
@@ -18,6 +21,8 @@
 #include "token.h"
 #include "logging.hpp"
 #include "script_cache.h"
+#include "save_chain.h"
+#include "state_packer.h"
 #include "platform/platform.hpp"
 
 #include "ringbuffer_stack.hpp"
@@ -25,6 +30,17 @@
 #define BCODE_BUFFER_BLOCKSIZE 4096
 #define IOBUFFER_SIZE 65535
 
+// token header of segment byte code decoded at load time, see COMPILER::BC_PreDecode
+struct BC_OP
+{
+    S_TOKEN_TYPE type;
+    uint32_t offset;      // token offset in byte code
+    uint32_t data_offset; // token data offset in byte code
+    uint32_t data_size;
+    uint32_t arg;  // first 4 bytes of token data: var, func and string codes, numbers, jump offsets
+    uint32_t jump; // op index of jump target for JUMP, JUMP_Z and JUMP_NZ
+};
+
 struct SEGMENT_DESC
 {
     std::string name;
@@ -38,6 +54,7 @@ struct SEGMENT_DESC
     char *pCode;
     uint32_t BCode_Program_size;
     uint32_t BCode_Buffer_size;
+    std::vector<BC_OP> ops; // empty if segment is executed from byte code
 
     STRINGS_LIST *Files_list;
 };
@@ -48,13 +65,6 @@ struct OFFSET_INFO
     uint32_t segment_id;
 };
 
-struct EXTDATA_HEADER
-{
-    char sFileInfo[32];
-    uint32_t dwExtDataOffset;
-    uint32_t dwExtDataSize;
-};
-
 /*struct DEFINE_INFO
 {
     uint32_t deftype;
@@ -67,6 +77,15 @@ struct DOUBLE_DWORD
     uint32_t dw2;
 };
 
+// activation record of a running script function
+struct FUNC_FRAME
+{
+    FuncInfoRef info; // keeps function info alive while it runs, even if its segment gets unloaded
+    uint32_t func_code;
+    uint32_t segment_id;
+    uint32_t stack_offset;
+};
+
 class SLIBHOLDER
 {
   public:
@@ -125,6 +144,11 @@ class COMPILER : public VIRTUAL_COMPILER
     bool Run();
     void Release();
     void SetProgramDirectory(const char *dir_name);
+    // decode the byte code of segments loaded from now on, "predecode" in the engine config
+    void SetPreDecode(bool enable)
+    {
+        bPreDecode = enable;
+    }
     VDATA *ProcessEvent(const char *event_name, MESSAGE message);
     VDATA *ProcessEvent(const char *event_name);
     void SetEventHandler(const char *event_name, const char *func_name, int32_t flag, bool bStatic = false);
@@ -157,10 +181,14 @@ class COMPILER : public VIRTUAL_COMPILER
     void FindErrorSource();
     S_TOKEN_TYPE BC_TokenGet(uint32_t &ip, uint32_t &token_data_size);
     S_TOKEN_TYPE BC_TokenGet();
+    void BC_PreDecode(SEGMENT_DESC &Segment);
+    uint32_t BC_CodeOffset() const;
 
     S_TOKEN_TYPE TokenLastReadResult;
     uint32_t TLR_DataOffset;
+    uint32_t TLR_Arg; // first 4 bytes of the last read token data, 0 if shorter
     const char *pRunCodeBase;
+    const BC_OP *pRunOps; // when set, InstructionPointer is an index in it instead of byte code offset
     bool TokenIs(S_TOKEN_TYPE test);
 
     S_TOKEN_TYPE TokenType()
@@ -209,8 +237,11 @@ class COMPILER : public VIRTUAL_COMPILER
     bool CreateMessage(MESSAGE *pMs, uint32_t stack_offset, uint32_t vindex, bool s2s = false);
     void ProcessEvent(const char *event_name, MESSAGE *pMs);
 
-    bool SaveState(std::fstream &fileS);
-    bool LoadState(std::fstream &fileS);
+    bool SaveState(const char *file_name);
+    bool LoadState(std::fstream &fileS, const char *file_name);
+    // returns once the states and save data written in background are on disk,
+    // false if any of them failed since the previous call
+    bool WaitStateSaving();
     bool OnLoad();
     void SaveDataDebug(char *data_PTR, ...);
     void SaveData(const void *data_PTR, uint32_t data_size);
@@ -223,8 +254,9 @@ class COMPILER : public VIRTUAL_COMPILER
     bool FindReferencedVariable(DATA *pRef, uint32_t &var_index, uint32_t &array_index);
     bool FindReferencedVariableByRootA(ATTRIBUTES *pA, uint32_t &var_index, uint32_t &array_index);
     ATTRIBUTES *TraceARoot(ATTRIBUTES *pA, const char *&pAccess);
-    void SaveAttributesData(ATTRIBUTES *pRoot);
-    void ReadAttributesData(ATTRIBUTES *pRoot, ATTRIBUTES *pParent);
+    void SaveAttributesData(ATTRIBUTES *pRoot, bool bDelta = false);
+    // returns the name code of the read attribute
+    uint32_t ReadAttributesData(ATTRIBUTES *pRoot, ATTRIBUTES *pParent);
     void WriteVDword(uint32_t v);
     uint32_t ReadVDword();
 
@@ -271,6 +303,26 @@ private:
     [[nodiscard]] std::filesystem::path GetSegmentCachePath(const SEGMENT_DESC &segment) const;
 
     uint64_t cache_fingerprint_{};
+
+    bool background_save_{};
+    int32_t save_level_{};
+    // number of delta saves on top of a full one, 0 writes full saves only
+    uint32_t max_save_deltas_{};
+    bool delta_save_{};
+    bool delta_load_{};
+    // saves of the current state, the full one and the deltas on top of it
+    uint32_t save_chain_length_{};
+    // the folder of the last save, its bases are kept there
+    std::filesystem::path last_save_folder_;
+    std::shared_ptr<std::atomic_bool> save_chain_broken_{std::make_shared<std::atomic_bool>(false)};
+    uint64_t last_save_id_{};
+    uint32_t last_save_epoch_{};
+    std::unordered_map<const DATA *, const ATTRIBUTES *> saved_roots_;
+    storm::save_chain::NameCodes delta_name_codes_;
+    storm::state_packer::Queue state_queue_;
+    // failed background saves already reported by WaitStateSaving and by the save failed event
+    size_t waited_save_failures_{};
+    size_t posted_save_failures_{};
     
     bool LoadSegmentFromCache(SEGMENT_DESC &segment);
     void LoadDefinesFromCache(storm::script_cache::BufferReader &reader, SEGMENT_DESC &segment);
@@ -288,6 +340,17 @@ private:
     void SaveEventHandlersToCache(storm::script_cache::BufferWriter &writer);
     void SaveByteCodeToCache(storm::script_cache::BufferWriter &writer, const SEGMENT_DESC &segment);
 
+    bool LoadStateFile(std::fstream &fileS, const char *file_name, const std::filesystem::path &bases_folder,
+                       uint64_t &save_id, uint32_t depth);
+    // a delta extends the last save chain if it is short enough and the save goes to the folder of its bases
+    [[nodiscard]] bool CanSaveDelta(const std::filesystem::path &save_path) const;
+    // remembers the attribute trees of the object variables as of the last save
+    void CollectSavedRoots();
+    // the variable still holds the tree it held at the last save
+    [[nodiscard]] bool IsSavedRoot(DATA *pV) const;
+    // the name code of this session for a code read from a delta
+    [[nodiscard]] uint32_t LoadedNameCode(uint32_t code) const;
+
     COMPILER_STAGE CompilerStage;
     STRINGS_LIST LabelTable;
     // STRINGS_LIST EventTable;
@@ -308,7 +371,7 @@ private:
     char *pDebExpBuffer;
     uint32_t nDebExpBufferSize;
 
-    FuncInfo *pRun_fi; // running function info
+    FUNC_FRAME *pRun_fi; // running function frame
     FuncTable FuncTab;
     VarTable VarTab;
     S_DEFTAB DefTab;
@@ -330,6 +393,7 @@ private:
     bool bScriptTrace;
     bool bWriteCodeFile;
     bool bDebugInfo;
+    bool bPreDecode;
     char DebugSourceFileName[MAX_PATH];
     char gs[MAX_PATH];
     uint32_t DebugSourceLine;
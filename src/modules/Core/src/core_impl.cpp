@@ -6,6 +6,8 @@
 
 #include <fstream>
 
+#include <imgui.h>
+
 #include "string_compare.hpp"
 #include <SDL.h>
 
@@ -84,6 +86,7 @@ void CoreImpl::CleanUp()
     Initialized = false;
     bEngineIniProcessed = false;
     ReleaseServices();
+    Compiler->WaitStateSaving();
     Compiler->Release();
     Services_List.Release();
     Services_List.Release();
@@ -127,6 +130,19 @@ void CoreImpl::Init()
     storm::editor::EngineEditor::RegisterEditorTool("Entities", [this] (bool &active) {
         entity_manager_.ShowEditor(active);
     });
+    storm::editor::EngineEditor::RegisterEditorTool("Lookups", [this] (bool &active) {
+        ShowLookupsEditor(active);
+    });
+}
+
+void CoreImpl::ShowLookupsEditor(bool &active) const
+{
+    if (ImGui::Begin("Lookups", &active, 0))
+    {
+        ImGui::Text("Attribute lookups by name per frame: %u", lastFrameAttributeLookups_);
+        ImGui::Text("Script variable lookups by name per frame: %u", lastFrameVariableLookups_);
+    }
+    ImGui::End();
 }
 
 void CoreImpl::InitializeEditor(IDirect3DDevice9 *device)
@@ -163,21 +179,26 @@ bool CoreImpl::Run()
         DumpEntitiesInfo();
     dwNumberScriptCommandsExecuted = 0;
 
+    lastFrameAttributeLookups_ = ATTRIBUTES::GetStringLookupsNum();
+    lastFrameVariableLookups_ = variableLookupsNum_;
+    ATTRIBUTES::ResetStringLookupsNum();
+    variableLookupsNum_ = 0;
+
     if (Exit_flag)
         return false; // exit
 
     Timer.Run(); // calc delta time
 
-    auto *pVCTime = static_cast<VDATA *>(core_internal.GetScriptVariable("iRealDeltaTime"));
+    auto *pVCTime = realDeltaTime_.Get();
     if (pVCTime)
         pVCTime->Set(static_cast<int32_t>(GetRDeltaTime()));
 
     auto tt = std::time(nullptr);
     auto local_tm = *std::localtime(&tt);
 
-    auto *pVYear = static_cast<VDATA *>(core_internal.GetScriptVariable("iRealYear"));
-    auto *pVMonth = static_cast<VDATA *>(core_internal.GetScriptVariable("iRealMonth"));
-    auto *pVDay = static_cast<VDATA *>(core_internal.GetScriptVariable("iRealDay"));
+    auto *pVYear = realYear_.Get();
+    auto *pVMonth = realMonth_.Get();
+    auto *pVDay = realDay_.Get();
 
     if (pVYear)
         pVYear->Set(local_tm.tm_year + 1900);
@@ -194,7 +215,7 @@ bool CoreImpl::Run()
     Timer.Delta_Time = static_cast<uint32_t>(Timer.Delta_Time * fTimeScale);
     Timer.fDeltaTime *= fTimeScale;
 
-    auto *pVData = static_cast<VDATA *>(GetScriptVariable("fHighPrecisionDeltaTime", nullptr));
+    auto *pVData = highPrecisionDeltaTime_.Get();
     if (pVData)
         pVData->Set(Timer.fDeltaTime * 0.001f);
 
@@ -604,22 +625,18 @@ bool CoreImpl::SaveState(const char *file_name)
         throw std::logic_error("Bad file name of save");
     }
 
-    auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::out);
-
-    if (!fileS.is_open())
-    {
-        return false;
-    }
-
-    Compiler->SaveState(fileS);
-    fio->_CloseFile(fileS);
+    return Compiler->SaveState(file_name);
+}
 
-    return true;
+bool CoreImpl::WaitStateSaving()
+{
+    return Compiler->WaitStateSaving();
 }
 
 // force core to load state file at the start of next game loop, return false if no state file
 bool CoreImpl::InitiateStateLoading(const char *file_name)
 {
+    Compiler->WaitStateSaving();
     auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in);
     if (!fileS.is_open())
     {
@@ -641,6 +658,7 @@ void CoreImpl::ProcessStateLoading()
         return;
     }
 
+    Compiler->WaitStateSaving();
     State_loading = true;
     EraseEntities();
 
@@ -649,7 +667,7 @@ void CoreImpl::ProcessStateLoading()
     {
         return;
     }
-    Compiler->LoadState(fileS);
+    Compiler->LoadState(fileS, State_file_name);
     fio->_CloseFile(fileS);
 
     delete[] State_file_name;
@@ -926,6 +944,7 @@ void *CoreImpl::GetScriptVariable(const char *pVariableName, uint32_t *pdwVarInd
 {
     const VarInfo *real_var;
 
+    variableLookupsNum_++;
     const auto dwVarIndex = Compiler->VarTab.FindVar(pVariableName);
     if (dwVarIndex == INVALID_VAR_CODE)
     {
@@ -944,6 +963,11 @@ void *CoreImpl::GetScriptVariable(const char *pVariableName, uint32_t *pdwVarInd
     return real_var->value.get();
 }
 
+uint32_t CoreImpl::GetScriptVariablesGeneration() const noexcept
+{
+    return Compiler->VarTab.GetGeneration();
+}
+
 storm::ENGINE_VERSION CoreImpl::GetTargetEngineVersion() const noexcept
 {
     return targetVersion_;
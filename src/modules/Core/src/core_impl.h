@@ -90,6 +90,8 @@ class CoreImpl final : public CorePrivate
     bool SaveState(const char *file_name) override;
     // force core to load state file at the start of next game loop, return false if no state file
     bool InitiateStateLoading(const char *file_name) override;
+    // wait until the states saved in background are written, before touching save files directly
+    bool WaitStateSaving() override;
 
     // return current fps
     uint32_t EngineFps() override;
@@ -109,6 +111,7 @@ class CoreImpl final : public CorePrivate
     uint32_t SetScriptFunction(IFUNCINFO *pFuncInfo) override;
 
     void *GetScriptVariable(const char *pVariableName, uint32_t *pdwVarIndex = nullptr) override;
+    [[nodiscard]] uint32_t GetScriptVariablesGeneration() const noexcept override;
 
     [[nodiscard]] storm::ENGINE_VERSION GetTargetEngineVersion() const noexcept override;
 
@@ -159,6 +162,19 @@ private:
 
     bool stopFrameProcessing_ = false;
 
+    void ShowLookupsEditor(bool &active) const;
+
+    // per-frame lookups by name, shown in the "Lookups" editor tool
+    uint32_t variableLookupsNum_{};
+    uint32_t lastFrameVariableLookups_{};
+    uint32_t lastFrameAttributeLookups_{};
+
+    ScriptVariableHandle realDeltaTime_{"iRealDeltaTime"};
+    ScriptVariableHandle realYear_{"iRealYear"};
+    ScriptVariableHandle realMonth_{"iRealMonth"};
+    ScriptVariableHandle realDay_{"iRealDay"};
+    ScriptVariableHandle highPrecisionDeltaTime_{"fHighPrecisionDeltaTime"};
+
     bool bAppActive{};
     bool Memory_Leak_flag; // true if core detected memory leak
     bool Root_flag;
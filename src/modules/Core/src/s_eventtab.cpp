@@ -25,10 +25,11 @@ void S_EVENTTAB::Clear()
     {
         for (uint32_t n = 0; n < Event_num[i]; n++)
         {
+            auto &handlers = DetachHandlers(pTable[i][n]);
             for (uint32_t m = 0; m < pTable[i][n].elements; m++)
             {
-                if (!pTable[i][n].pFuncInfo[m].bStatic)
-                    pTable[i][n].pFuncInfo[m].status = FSTATUS_DELETED;
+                if (!handlers[m].bStatic)
+                    handlers[m].status = FSTATUS_DELETED;
             }
 
             // if(pTable[n].pFuncInfo) delete pTable[n].pFuncInfo;
@@ -65,6 +66,42 @@ bool S_EVENTTAB::GetEvent(EVENTINFO &ei, uint32_t event_code)
     return true;
 }
 
+EVENT_HANDLERS S_EVENTTAB::GetEventHandlers(uint32_t event_code) const
+{
+    const auto ti = HASHT_INDEX(event_code);
+    const auto tc = HASHT_CODE(event_code);
+    if (tc >= Event_num[ti])
+        return nullptr;
+    return pTable[ti][tc].pFuncInfo;
+}
+
+bool S_EVENTTAB::IsHandlerActive(uint32_t event_code, const EVENT_HANDLERS &handlers, uint32_t n) const
+{
+    const auto live = GetEventHandlers(event_code);
+    if (!live)
+        return false;
+    // nothing changed the table since the list was taken, it is still the live one
+    if (live == handlers)
+        return (*handlers)[n].status == FSTATUS_NORMAL;
+    // a handler deleted it or its segment was unloaded meanwhile
+    const auto func_code = (*handlers)[n].func_code;
+    for (const auto &handler : *live)
+    {
+        if (handler.func_code == func_code)
+            return handler.status == FSTATUS_NORMAL;
+    }
+    return false;
+}
+
+std::vector<EVENT_FUNC_INFO> &S_EVENTTAB::DetachHandlers(EVENTINFO &ei)
+{
+    if (!ei.pFuncInfo)
+        ei.pFuncInfo = std::make_shared<std::vector<EVENT_FUNC_INFO>>();
+    else if (ei.pFuncInfo.use_count() > 1) // list is held by a running event, copy on write
+        ei.pFuncInfo = std::make_shared<std::vector<EVENT_FUNC_INFO>>(*ei.pFuncInfo);
+    return *ei.pFuncInfo;
+}
+
 uint32_t S_EVENTTAB::AddEventHandler(const char *event_name, uint32_t func_code, uint32_t func_segment_id, int32_t flag,
                                      bool bStatic)
 {
@@ -84,30 +121,32 @@ uint32_t S_EVENTTAB::AddEventHandler(const char *event_name, uint32_t func_code,
             for (i = 0; i < pTable[ti][n].elements; i++)
             {
                 // event handler function already set
-                if (pTable[ti][n].pFuncInfo[i].func_code == func_code)
+                if ((*pTable[ti][n].pFuncInfo)[i].func_code == func_code)
                 {
                     /*if(pTable[ti][n].pFuncInfo[i].status == FSTATUS_DELETED)
                     {
                       trace("pTable[ti][n].pFuncInfo[i].status == FSTATUS_DELETED : %s",pTable[ti][n].name);
                     }*/
                     // return n;
-                    pTable[ti][n].pFuncInfo[i].status = FSTATUS_NORMAL;
+                    if ((*pTable[ti][n].pFuncInfo)[i].status != FSTATUS_NORMAL)
+                        DetachHandlers(pTable[ti][n])[i].status = FSTATUS_NORMAL;
 
                     return (((ti << 24) & 0xff000000) | (n & 0xffffff));
                 }
             }
             // add function
+            auto &handlers = DetachHandlers(pTable[ti][n]);
             i = pTable[ti][n].elements;
             pTable[ti][n].elements++;
-            pTable[ti][n].pFuncInfo.resize(pTable[ti][n].elements);
+            handlers.resize(pTable[ti][n].elements);
 
-            pTable[ti][n].pFuncInfo[i].func_code = func_code;
-            pTable[ti][n].pFuncInfo[i].segment_id = func_segment_id;
+            handlers[i].func_code = func_code;
+            handlers[i].segment_id = func_segment_id;
             if (flag)
-                pTable[ti][n].pFuncInfo[i].status = FSTATUS_NEW;
+                handlers[i].status = FSTATUS_NEW;
             else
-                pTable[ti][n].pFuncInfo[i].status = FSTATUS_NORMAL;
-            pTable[ti][n].pFuncInfo[i].bStatic = bStatic;
+                handlers[i].status = FSTATUS_NORMAL;
+            handlers[i].bStatic = bStatic;
             // return n;
             return (((ti << 24) & 0xff000000) | (n & 0xffffff));
         }
@@ -124,14 +163,15 @@ uint32_t S_EVENTTAB::AddEventHandler(const char *event_name, uint32_t func_code,
     pTable[ti][Event_num[ti]].hash = hash;
     pTable[ti][Event_num[ti]].name = nullptr;
 
-    pTable[ti][Event_num[ti]].pFuncInfo.push_back(EVENT_FUNC_INFO{});
-    pTable[ti][Event_num[ti]].pFuncInfo[0].func_code = func_code;
-    pTable[ti][Event_num[ti]].pFuncInfo[0].segment_id = func_segment_id;
+    pTable[ti][Event_num[ti]].pFuncInfo = std::make_shared<std::vector<EVENT_FUNC_INFO>>(1);
+    auto &handler = pTable[ti][Event_num[ti]].pFuncInfo->front();
+    handler.func_code = func_code;
+    handler.segment_id = func_segment_id;
     if (flag)
-        pTable[ti][Event_num[ti]].pFuncInfo[0].status = FSTATUS_NEW;
+        handler.status = FSTATUS_NEW;
     else
-        pTable[ti][Event_num[ti]].pFuncInfo[0].status = FSTATUS_NORMAL;
-    pTable[ti][Event_num[ti]].pFuncInfo[0].bStatic = bStatic;
+        handler.status = FSTATUS_NORMAL;
+    handler.bStatic = bStatic;
 
     if constexpr (true) // bKeepName)
     {
@@ -201,9 +241,10 @@ void S_EVENTTAB::SetStatus(const char *event_name, uint32_t func_code, uint32_t
             {
                 for (uint32_t i = 0; i < pTable[ti][n].elements; i++)
                 {
-                    if (pTable[ti][n].pFuncInfo[i].func_code == func_code)
+                    if ((*pTable[ti][n].pFuncInfo)[i].func_code == func_code)
                     {
-                        pTable[ti][n].pFuncInfo[i].status = status;
+                        if ((*pTable[ti][n].pFuncInfo)[i].status != status)
+                            DetachHandlers(pTable[ti][n])[i].status = status;
                         return;
                     }
                 }
@@ -215,18 +256,19 @@ bool S_EVENTTAB::DelEventHandler(uint8_t ti, uint32_t event_code, uint32_t func_
 {
     if (!bDelStatic)
     {
-        if (pTable[ti][event_code].pFuncInfo[func_code].bStatic)
+        if ((*pTable[ti][event_code].pFuncInfo)[func_code].bStatic)
         {
             return false;
         }
     }
 
+    auto &handlers = DetachHandlers(pTable[ti][event_code]);
     for (auto n = func_code; n < (pTable[ti][event_code].elements - 1); n++)
     {
-        pTable[ti][event_code].pFuncInfo[n] = pTable[ti][event_code].pFuncInfo[n + 1];
+        handlers[n] = handlers[n + 1];
     }
     pTable[ti][event_code].elements--;
-    pTable[ti][event_code].pFuncInfo.resize(pTable[ti][event_code].elements);
+    handlers.resize(pTable[ti][event_code].elements);
     return true;
 }
 
@@ -238,7 +280,7 @@ void S_EVENTTAB::InvalidateBySegmentID(uint32_t segment_id)
         {
             for (uint32_t i = 0; i < pTable[ti][n].elements; i++)
             {
-                if (pTable[ti][n].pFuncInfo[i].segment_id == segment_id)
+                if ((*pTable[ti][n].pFuncInfo)[i].segment_id == segment_id)
                 {
                     if (DelEventHandler(static_cast<uint8_t>(ti), n, i, true))
                         i = 0;
@@ -271,13 +313,14 @@ void S_EVENTTAB::ProcessFrame()
             // delete old handlers
             for (uint32_t i = 0; i < pTable[ti][n].elements; i++)
             {
-                if (pTable[ti][n].pFuncInfo[i].status == FSTATUS_DELETED)
+                const auto status = (*pTable[ti][n].pFuncInfo)[i].status;
+                if (status == FSTATUS_DELETED)
                 {
                     DelEventHandler(static_cast<uint8_t>(ti), n, i);
                     i = 0;
                 }
-                else
-                    pTable[ti][n].pFuncInfo[i].status = FSTATUS_NORMAL;
+                else if (status != FSTATUS_NORMAL)
+                    DetachHandlers(pTable[ti][n])[i].status = FSTATUS_NORMAL;
             }
         }
 }
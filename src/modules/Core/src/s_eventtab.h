@@ -2,6 +2,8 @@
 
 #include "data.h"
 
+#include <memory>
+
 #define BUFFER_BLOCK_SIZE 4
 #define INVALID_EVENT_CODE 0xffffffff
 #define INVALID_SEGMENT_ID 0xffffffff
@@ -18,10 +20,14 @@ struct EVENT_FUNC_INFO
     bool bStatic;
 };
 
+// handler list is shared copy-on-write: a running event keeps its snapshot alive while the
+// table is changed underneath it (handlers added, deleted or segment unloaded)
+using EVENT_HANDLERS = std::shared_ptr<const std::vector<EVENT_FUNC_INFO>>;
+
 struct EVENTINFO
 {
     uint32_t hash;
-    std::vector<EVENT_FUNC_INFO> pFuncInfo;
+    std::shared_ptr<std::vector<EVENT_FUNC_INFO>> pFuncInfo;
     char *name;
     uint32_t elements;
 };
@@ -34,6 +40,9 @@ class S_EVENTTAB
     uint32_t Event_num[HASHTABLE_SIZE];
     std::vector<EVENTINFO> pTable[HASHTABLE_SIZE];
     // bool bKeepName;
+
+    std::vector<EVENT_FUNC_INFO> &DetachHandlers(EVENTINFO &ei);
+
   public:
     S_EVENTTAB();
     ~S_EVENTTAB();
@@ -44,6 +53,9 @@ class S_EVENTTAB
     bool DelEventHandler(const char *event_name, uint32_t func_code);
     bool DelEventHandler(uint8_t ti, uint32_t event_code, uint32_t func_code, bool bDelStatic = false);
     bool GetEvent(EVENTINFO &ei, uint32_t event_code); // return true if var registred and loaded
+    EVENT_HANDLERS GetEventHandlers(uint32_t event_code) const; // no copy, nullptr if event not registred
+    // true if the n-th handler of the held list is still registered and not deleted in the live table
+    bool IsHandlerActive(uint32_t event_code, const EVENT_HANDLERS &handlers, uint32_t n) const;
     uint32_t MakeHashValue(const char *string);
     //    void  KeepNameMode(bool on){bKeepName = on;};
     void Release();
@@ -1,9 +1,9 @@
 #include "s_functab.h"
 
 FuncInfo::FuncInfo()
-    : name(), local_vars(), segment_id(INVALID_SEGMENT_ID), offset(INVALID_FUNC_OFFSET), stack_offset(), arguments(),
-      return_type(TVOID), decl_file_name(), decl_line(), usage_time(), number_of_calls(), imported_func(),
-      extern_arguments()
+    : name(), local_vars(), segment_id(INVALID_SEGMENT_ID), offset(INVALID_FUNC_OFFSET), op_index(INVALID_OP_INDEX),
+      stack_offset(), arguments(), return_type(TVOID), decl_file_name(), decl_line(), usage_time(), number_of_calls(),
+      imported_func(), extern_arguments()
 {
 }
 
@@ -42,19 +42,17 @@ size_t FuncTable::AddFunc(const FuncInfo &fi)
 
     if (is_new) // newly created function, add to table
     {
-        funcs_.push_back(fi);
+        funcs_.push_back(std::make_shared<FuncInfo>(fi));
     }
-
-    auto &func = funcs_[func_index];
-
-    if (!is_new)
+    else
     {
-        if (func.offset != INVALID_FUNC_OFFSET) // function already loaded
+        auto &func = funcs_[func_index];
+        if (func->offset != INVALID_FUNC_OFFSET) // function already loaded
         {
             return INVALID_FUNC_CODE;
         }
 
-        func = fi; // function exists, but was unloaded, copy data
+        func = std::make_shared<FuncInfo>(fi); // function exists, but was unloaded, copy data
     }
 
     return func_index;
@@ -62,29 +60,41 @@ size_t FuncTable::AddFunc(const FuncInfo &fi)
 
 bool FuncTable::GetFunc(FuncInfo &fi, size_t func_index) const
 {
-    if (func_index >= funcs_.size())
+    const auto func = GetFuncRef(func_index);
+    if (!func)
     {
         return false;
     }
 
-    if (funcs_[func_index].segment_id == IMPORTED_SEGMENT_ID)
+    fi = *func; // copy func info
+    return true;
+}
+
+FuncInfoRef FuncTable::GetFuncRef(size_t func_index) const
+{
+    if (func_index >= funcs_.size())
+    {
+        return nullptr;
+    }
+
+    const auto &func = funcs_[func_index];
+
+    if (func->segment_id == IMPORTED_SEGMENT_ID)
     {
-        if (funcs_[func_index].imported_func == nullptr)
+        if (func->imported_func == nullptr)
         {
-            return false;
+            return nullptr;
         }
 
-        fi = funcs_[func_index]; // copy func info
-        return true;
+        return func;
     }
 
-    if (funcs_[func_index].offset == INVALID_FUNC_OFFSET)
+    if (func->offset == INVALID_FUNC_OFFSET)
     {
-        return false;
+        return nullptr;
     }
 
-    fi = funcs_[func_index]; // copy func info
-    return true;
+    return func;
 }
 
 bool FuncTable::GetFuncX(FuncInfo &fi, size_t func_index) const
@@ -94,20 +104,24 @@ bool FuncTable::GetFuncX(FuncInfo &fi, size_t func_index) const
         return false;
     }
 
-    fi = funcs_[func_index]; // copy func info
+    fi = *funcs_[func_index]; // copy func info
     return true;
 }
 
 void FuncTable::InvalidateBySegmentID(uint32_t segment_id)
 {
-    for (auto &fi : funcs_)
+    for (auto &func : funcs_)
     {
-        if (fi.segment_id == segment_id)
+        if (func->segment_id == segment_id)
         {
-            fi.segment_id = INVALID_SEGMENT_ID; // hash is not deleted from table
-            fi.offset = INVALID_FUNC_OFFSET;
-            fi.local_vars.clear(); // delete local vars
-            fi.decl_file_name.clear();
+            // running calls of this function keep the old info, table gets an invalidated copy
+            auto fi = std::make_shared<FuncInfo>(*func);
+            fi->segment_id = INVALID_SEGMENT_ID; // hash is not deleted from table
+            fi->offset = INVALID_FUNC_OFFSET;
+            fi->op_index = INVALID_OP_INDEX;
+            fi->local_vars.clear(); // delete local vars
+            fi->decl_file_name.clear();
+            func = std::move(fi);
         }
     }
 }
@@ -121,7 +135,18 @@ bool FuncTable::SetFuncOffset(const std::string &func_name, uint32_t offset)
         return false;
     }
 
-    funcs_[func_index].offset = offset;
+    funcs_[func_index]->offset = offset;
+    return true;
+}
+
+bool FuncTable::SetFuncOpIndex(size_t func_index, uint32_t op_index)
+{
+    if (func_index >= funcs_.size())
+    {
+        return false;
+    }
+
+    funcs_[func_index]->op_index = op_index;
     return true;
 }
 
@@ -142,7 +167,7 @@ bool FuncTable::AddFuncVar(size_t func_index, const LocalVarInfo &lvi)
         return false;
     }
 
-    auto &var = funcs_[func_index].local_vars.emplace_back(lvi);
+    auto &var = funcs_[func_index]->local_vars.emplace_back(lvi);
     var.hash = hasher_(var.name);
 
     return true;
@@ -157,11 +182,11 @@ bool FuncTable::AddFuncArg(size_t func_index, const LocalVarInfo &lvi, bool is_e
 
     if (is_extern)
     {
-        ++funcs_[func_index].extern_arguments;
+        ++funcs_[func_index]->extern_arguments;
         return true;
     }
 
-    ++funcs_[func_index].arguments;
+    ++funcs_[func_index]->arguments;
     return AddFuncVar(func_index, lvi);
 }
 
@@ -177,7 +202,7 @@ size_t FuncTable::FindVar(size_t func_index, const std::string &var_name) const
         return INVALID_VAR_CODE;
     }
 
-    const auto &vars = funcs_[func_index].local_vars;
+    const auto &vars = funcs_[func_index]->local_vars;
     size_t hash = hasher_(var_name);
     const auto result = std::find_if(vars.begin(), vars.end(), [hash, &var_name](const LocalVarInfo &var) {
         return var.hash == hash && storm::iEquals(var.name, var_name); // fast comparison
@@ -198,7 +223,7 @@ bool FuncTable::GetVar(LocalVarInfo &lvi, size_t func_index, size_t var_index) c
         return false;
     }
 
-    const auto &vars = funcs_[func_index].local_vars;
+    const auto &vars = funcs_[func_index]->local_vars;
 
     if (var_index >= vars.size())
     {
@@ -217,7 +242,7 @@ bool FuncTable::AddTime(size_t func_index, uint64_t time)
         return false;
     }
 
-    funcs_[func_index].usage_time += time;
+    funcs_[func_index]->usage_time += time;
     return true;
 }
 
@@ -228,7 +253,7 @@ bool FuncTable::AddCall(size_t func_index)
         return false;
     }
 
-    ++funcs_[func_index].number_of_calls;
+    ++funcs_[func_index]->number_of_calls;
     return true;
 }
 
@@ -236,8 +261,8 @@ void FuncTable::ResetTimeAndCalls()
 {
     for (auto &func : funcs_)
     {
-        func.usage_time = 0;
-        func.number_of_calls = 0;
+        func->usage_time = 0;
+        func->number_of_calls = 0;
     }
 }
 
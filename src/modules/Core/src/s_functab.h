@@ -3,6 +3,7 @@
 #include "s_import_func.h"
 #include "s_vartab.h"
 #include "string_compare.hpp"
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -10,6 +11,7 @@
 #define INVALID_FUNC_OFFSET 0xffffffff
 #define INTERNAL_SEGMENT_ID 0xffffffff
 #define IMPORTED_SEGMENT_ID 0xfffffffe
+#define INVALID_OP_INDEX 0xffffffff
 
 // when offset value of function is INVALID_FUNC_OFFSET, function segment
 // isnt currently loaded and function call is impossible
@@ -42,6 +44,7 @@ struct FuncInfo
     // compiler info
     uint32_t segment_id;
     uint32_t offset;
+    uint32_t op_index; // entry in pre-decoded segment code
     uint32_t stack_offset;
     uint32_t arguments;
     S_TOKEN_TYPE return_type;
@@ -59,6 +62,9 @@ struct FuncInfo
     uint32_t extern_arguments;
 };
 
+// shared handle to function info, stays valid after its segment is unloaded or reloaded
+using FuncInfoRef = std::shared_ptr<const FuncInfo>;
+
 class FuncTable
 {
   public:
@@ -75,11 +81,15 @@ class FuncTable
     bool GetFunc(FuncInfo &fi, size_t func_index) const;
     // get func by index, returns true if func is registered
     bool GetFuncX(FuncInfo &fi, size_t func_index) const;
+    // get func by index without copying, returns nullptr if func isnt registered or loaded
+    FuncInfoRef GetFuncRef(size_t func_index) const;
     // invalidate all segment's functions
     void InvalidateBySegmentID(uint32_t segment_id);
 
     // set func's compiler offset
     bool SetFuncOffset(const std::string &func_name, uint32_t offset);
+    // set func's entry in pre-decoded segment code
+    bool SetFuncOpIndex(size_t func_index, uint32_t op_index);
     // add local var to func
     bool AddFuncVar(size_t func_index, const LocalVarInfo &lvi);
     // add arg to func (must precede all regular local vars in order not to break compiler logic)
@@ -96,7 +106,8 @@ class FuncTable
     void Release(); // clear table
 
   private:
-    std::vector<FuncInfo> funcs_;
+    // table entries are replaced rather than modified on segment unload, so running calls keep their info
+    std::vector<std::shared_ptr<FuncInfo>> funcs_;
     storm::iStrHasher hasher_;
     std::unordered_map<std::string, size_t, storm::iStrHasher, storm::iStrComparator> hash_table_;
 };
@@ -57,6 +57,7 @@ size_t VarTable::AddVar(const VarInfo &vi)
     }
 
     var.value = std::make_unique<DATA>();
+    generation_++;
     var.value->SetVCompiler(vc_);
     var.value->SetType(var.type, var.elements);
     var.value->SetGlobalVarTableIndex(var_index); // todo change to size_t
@@ -96,6 +97,7 @@ void VarTable::InvalidateBySegmentID(uint32_t segment_id)
         if (vi.segment_id == segment_id)
         {
             vi.segment_id = INVALID_SEGMENT_ID; // hash is not deleted from table
+            generation_++;
         }
     }
 }
@@ -132,4 +134,5 @@ void VarTable::Release()
 {
     vars_.clear();
     hash_table_.clear();
+    generation_++;
 }
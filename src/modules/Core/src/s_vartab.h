@@ -55,6 +55,11 @@ class VarTable
     bool SetElementsNum(size_t var_index, size_t elements_num);
     // clear table
     void Release();
+    // changes whenever a var is added, reloaded or unloaded, i.e. when cached var pointers become stale
+    uint32_t GetGeneration() const noexcept
+    {
+        return generation_;
+    }
 
     void SetVCompiler(VIRTUAL_COMPILER *vc)
     {
@@ -66,4 +71,5 @@ class VarTable
     std::unordered_map<std::string, size_t, storm::iStrHasher, storm::iStrComparator>
         hash_table_; // name to index mapping
     VIRTUAL_COMPILER *vc_;
+    uint32_t generation_{1};
 };
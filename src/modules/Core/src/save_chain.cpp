@@ -0,0 +1,135 @@
+#include "save_chain.h"
+
+#include "state_packer.h"
+
+#include <fmt/format.h>
+
+#include <fstream>
+#include <unordered_set>
+
+namespace storm
+{
+namespace save_chain
+{
+std::filesystem::path BasesFolder(const std::filesystem::path &saveFile)
+{
+    return saveFile.parent_path() / kBasesFolder;
+}
+
+std::filesystem::path BasePath(const std::filesystem::path &basesFolder, uint64_t saveId)
+{
+    return basesFolder / fmt::format("{:016x}.sav", saveId);
+}
+
+bool ReadStateIds(const std::filesystem::path &file, StateIds &ids)
+{
+    std::ifstream fileS(file, std::ios::binary);
+    EXTDATA_HEADER edh;
+    uint32_t size, marker;
+    fileS.read(reinterpret_cast<char *>(&edh), sizeof(edh));
+    fileS.read(reinterpret_cast<char *>(&size), sizeof(size));
+    fileS.read(reinterpret_cast<char *>(&marker), sizeof(marker));
+    if (!fileS || marker != state_packer::kStateMarker)
+        return false;
+    fileS.read(reinterpret_cast<char *>(&ids.saveId), sizeof(ids.saveId));
+    fileS.read(reinterpret_cast<char *>(&ids.baseId), sizeof(ids.baseId));
+    return static_cast<bool>(fileS);
+}
+
+bool KeepBase(const std::filesystem::path &saveFile, uint64_t saveId)
+{
+    std::error_code ec;
+    const auto folder = BasesFolder(saveFile);
+    std::filesystem::create_directories(folder, ec);
+    // an id is never reused, an existing base is this very save
+    const auto path = BasePath(folder, saveId);
+    if (std::filesystem::exists(path, ec))
+        return true;
+    return std::filesystem::copy_file(saveFile, path, ec);
+}
+
+size_t PruneBases(const std::filesystem::path &saveFolder, uint64_t keepId)
+{
+    std::error_code ec;
+    const auto folder = saveFolder / kBasesFolder;
+    if (!std::filesystem::is_directory(folder, ec))
+        return 0;
+
+    // The bases of the saves, then the bases of those bases
+    std::vector<uint64_t> pending;
+    if (keepId != 0)
+        pending.push_back(keepId);
+    for (const auto &entry : std::filesystem::directory_iterator(saveFolder, ec))
+    {
+        StateIds ids;
+        if (entry.is_regular_file(ec) && ReadStateIds(entry.path(), ids) && ids.baseId != 0)
+            pending.push_back(ids.baseId);
+    }
+    std::unordered_set<uint64_t> needed;
+    while (!pending.empty())
+    {
+        const auto id = pending.back();
+        pending.pop_back();
+        StateIds ids;
+        if (needed.insert(id).second && ReadStateIds(BasePath(folder, id), ids) && ids.baseId != 0)
+            pending.push_back(ids.baseId);
+    }
+
+    std::vector<std::filesystem::path> unused;
+    for (const auto &entry : std::filesystem::directory_iterator(folder, ec))
+    {
+        // other files of the folder are left alone
+        StateIds ids;
+        if (ReadStateIds(entry.path(), ids) && entry.path() == BasePath(folder, ids.saveId) &&
+            !needed.contains(ids.saveId))
+            unused.push_back(entry.path());
+    }
+    size_t numDeleted = 0;
+    for (const auto &path : unused)
+        numDeleted += std::filesystem::remove(path, ec) ? 1 : 0;
+    return numDeleted;
+}
+
+void NameCodes::Clear()
+{
+    bucketSizes_.clear();
+    codes_.clear();
+}
+
+void NameCodes::Add(uint32_t tableIndex, uint32_t loadedCode)
+{
+    // STRING_CODEC codes are the bucket and the position in it
+    const uint32_t savedCode = (tableIndex << 16) | (bucketSizes_[tableIndex]++ & 0xffff);
+    if (savedCode != loadedCode)
+        codes_[savedCode] = loadedCode;
+}
+
+uint32_t NameCodes::Loaded(uint32_t savedCode) const
+{
+    const auto it = codes_.find(savedCode);
+    return it == codes_.end() ? savedCode : it->second;
+}
+
+void PruneAttributes(ATTRIBUTES &root, const std::vector<uint32_t> &codes)
+{
+    bool bSameOrder = root.GetAttributesNum() == codes.size();
+    for (uint32_t n = 0; bSameOrder && n < codes.size(); n++)
+        bSameOrder = root.GetAttributeClass(n)->GetThisNameCode() == codes[n];
+    if (bSameOrder)
+        return;
+
+    std::unordered_map<uint32_t, uint32_t> order;
+    for (uint32_t n = 0; n < codes.size(); n++)
+        order.emplace(codes[n], n);
+    std::vector<ATTRIBUTES *> deleted;
+    for (uint32_t n = 0; n < root.GetAttributesNum(); n++)
+        if (!order.contains(root.GetAttributeClass(n)->GetThisNameCode()))
+            deleted.push_back(root.GetAttributeClass(n));
+    for (auto *pA : deleted)
+        root.DeleteAttributeClassX(pA);
+    root.Sort([&order](const std::unique_ptr<ATTRIBUTES> &lhs, const std::unique_ptr<ATTRIBUTES> &rhs) {
+        return order[lhs->GetThisNameCode()] < order[rhs->GetThisNameCode()];
+    });
+}
+} // namespace save_chain
+} // namespace storm
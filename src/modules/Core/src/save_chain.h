@@ -0,0 +1,59 @@
+#pragma once
+
+#include "attributes.h"
+
+#include <cstdint>
+#include <filesystem>
+#include <unordered_map>
+#include <vector>
+
+struct EXTDATA_HEADER
+{
+    char sFileInfo[32];
+    uint32_t dwExtDataOffset;
+    uint32_t dwExtDataSize;
+};
+
+namespace storm
+{
+namespace save_chain
+{
+// Deltas are applied on engine-owned copies of their bases kept in this subfolder of the saves,
+// the player may overwrite or delete any save without breaking the deltas written on top of it
+constexpr auto kBasesFolder = "DeltaBases";
+
+// Follow the state marker, baseId is 0 for a full save
+struct StateIds
+{
+    uint64_t saveId{};
+    uint64_t baseId{};
+};
+
+// The folder of the bases for a save file
+std::filesystem::path BasesFolder(const std::filesystem::path &saveFile);
+std::filesystem::path BasePath(const std::filesystem::path &basesFolder, uint64_t saveId);
+// false if the file is no state or a state of an older version
+bool ReadStateIds(const std::filesystem::path &file, StateIds &ids);
+// Copies the save into the bases of its folder, so a delta can be written on top of it
+bool KeepBase(const std::filesystem::path &saveFile, uint64_t saveId);
+// Deletes the bases no save of the folder depends on, except the chain of keepId. Returns the number of deleted bases
+size_t PruneBases(const std::filesystem::path &saveFolder, uint64_t keepId);
+
+// Name codes of the session that saved a delta mapped to the codes of the session loading it
+class NameCodes final
+{
+  public:
+    void Clear();
+    // the next string of the saved codec, in the hash table bucket tableIndex
+    void Add(uint32_t tableIndex, uint32_t loadedCode);
+    [[nodiscard]] uint32_t Loaded(uint32_t savedCode) const;
+
+  private:
+    std::unordered_map<uint32_t, uint32_t> bucketSizes_;
+    std::unordered_map<uint32_t, uint32_t> codes_;
+};
+
+// Deletes the children of root a delta does not list and puts the others in the order of codes
+void PruneAttributes(ATTRIBUTES &root, const std::vector<uint32_t> &codes);
+} // namespace save_chain
+} // namespace storm
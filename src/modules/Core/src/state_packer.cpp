@@ -0,0 +1,175 @@
+#include "state_packer.h"
+
+#include "file_service.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <atomic>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+namespace storm
+{
+namespace state_packer
+{
+namespace
+{
+size_t ChunkBytes(uint32_t chunk, uint32_t chunkSize, size_t size)
+{
+    const auto offset = static_cast<size_t>(chunk) * chunkSize;
+    return std::min<size_t>(chunkSize, size - offset);
+}
+} // namespace
+
+bool Pack(std::fstream &file, const char *data, size_t size, int32_t level)
+{
+    const auto numChunks = static_cast<uint32_t>((size + kChunkSize - 1) / kChunkSize);
+    const uint32_t header[] = {kChunkSize, numChunks};
+    std::vector<uint32_t> packedSizes(numChunks);
+
+    const auto tablePos = file.tellp() + static_cast<std::streamoff>(sizeof(header));
+    if (!fio->_WriteFile(file, header, sizeof(header)) ||
+        !fio->_WriteFile(file, packedSizes.data(), packedSizes.size() * sizeof(uint32_t)))
+        return false;
+
+    // A batch of chunks is packed in parallel and written before the next one, so only a batch is held packed
+    const auto batch = std::max(1u, std::thread::hardware_concurrency()) * 2;
+    std::vector<std::vector<Bytef>> packed(batch);
+    std::vector<uint32_t> index(batch);
+    std::iota(index.begin(), index.end(), 0);
+    for (uint32_t first = 0; first < numChunks; first += batch)
+    {
+        const auto count = std::min(batch, numChunks - first);
+        std::atomic_bool isPacked = true;
+        std::for_each(std::execution::par, index.begin(), index.begin() + count, [&](uint32_t i) {
+            const auto chunk = first + i;
+            const auto bytes = ChunkBytes(chunk, kChunkSize, size);
+            auto &dst = packed[i];
+            uLongf len = compressBound(static_cast<uLong>(bytes));
+            dst.resize(len);
+            if (compress2(dst.data(), &len, reinterpret_cast<const Bytef *>(data) + static_cast<size_t>(chunk) * kChunkSize,
+                          static_cast<uLong>(bytes), level) != Z_OK)
+            {
+                isPacked = false;
+                len = 0;
+            }
+            dst.resize(len);
+            packedSizes[chunk] = static_cast<uint32_t>(len);
+        });
+        if (!isPacked)
+            return false;
+        for (uint32_t i = 0; i < count; i++)
+            if (!fio->_WriteFile(file, packed[i].data(), packed[i].size()))
+                return false;
+    }
+
+    // The table is known only now
+    const auto endPos = file.tellp();
+    fio->_SetFilePointer(file, tablePos, std::ios::beg);
+    const auto isWritten = fio->_WriteFile(file, packedSizes.data(), packedSizes.size() * sizeof(uint32_t));
+    fio->_SetFilePointer(file, endPos, std::ios::beg);
+    return isWritten;
+}
+
+bool Unpack(std::fstream &file, char *data, size_t size)
+{
+    uint32_t header[2];
+    if (!fio->_ReadFile(file, header, sizeof(header)))
+        return false;
+    const auto chunkSize = header[0];
+    const auto numChunks = header[1];
+    if (chunkSize == 0 || numChunks != (size + chunkSize - 1) / chunkSize)
+        return false;
+
+    std::vector<uint32_t> packedSizes(numChunks);
+    if (!fio->_ReadFile(file, packedSizes.data(), packedSizes.size() * sizeof(uint32_t)))
+        return false;
+    std::vector<size_t> offsets(numChunks + 1, 0);
+    for (uint32_t i = 0; i < numChunks; i++)
+    {
+        if (packedSizes[i] == 0 || packedSizes[i] > compressBound(chunkSize))
+            return false;
+        offsets[i + 1] = offsets[i] + packedSizes[i];
+    }
+    std::vector<Bytef> packed(offsets.back());
+    if (!fio->_ReadFile(file, packed.data(), packed.size()))
+        return false;
+
+    std::vector<uint32_t> index(numChunks);
+    std::iota(index.begin(), index.end(), 0);
+    std::atomic_bool isUnpacked = true;
+    std::for_each(std::execution::par, index.begin(), index.end(), [&](uint32_t chunk) {
+        const auto bytes = ChunkBytes(chunk, chunkSize, size);
+        uLongf len = static_cast<uLongf>(bytes);
+        if (uncompress(reinterpret_cast<Bytef *>(data) + static_cast<size_t>(chunk) * chunkSize, &len,
+                       packed.data() + offsets[chunk], packedSizes[chunk]) != Z_OK ||
+            len != bytes)
+            isUnpacked = false;
+    });
+    return isUnpacked;
+}
+
+Queue::Queue() : thread_(&Queue::Run, this)
+{
+}
+
+Queue::~Queue()
+{
+    {
+        std::lock_guard lock(mutex_);
+        isStopped_ = true;
+    }
+    condition_.notify_all();
+    thread_.join();
+}
+
+void Queue::Push(std::function<bool()> job)
+{
+    {
+        std::lock_guard lock(mutex_);
+        jobs_.push_back(std::move(job));
+    }
+    condition_.notify_one();
+}
+
+void Queue::Wait()
+{
+    std::unique_lock lock(mutex_);
+    idle_.wait(lock, [this] { return jobs_.empty() && !isBusy_; });
+}
+
+size_t Queue::NumFailed()
+{
+    std::lock_guard lock(mutex_);
+    return numFailed_;
+}
+
+void Queue::Run()
+{
+    while (true)
+    {
+        std::function<bool()> job;
+        {
+            std::unique_lock lock(mutex_);
+            condition_.wait(lock, [this] { return isStopped_ || !jobs_.empty(); });
+            if (jobs_.empty())
+                return;
+            job = std::move(jobs_.front());
+            jobs_.pop_front();
+            isBusy_ = true;
+        }
+
+        const auto isDone = job();
+
+        {
+            std::lock_guard lock(mutex_);
+            numFailed_ += isDone ? 0 : 1;
+            isBusy_ = false;
+        }
+        idle_.notify_all();
+    }
+}
+} // namespace state_packer
+} // namespace storm
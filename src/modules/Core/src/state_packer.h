@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace storm
+{
+namespace state_packer
+{
+// Stands in place of the packed size of a state compressed as one block
+constexpr uint32_t kChunkedMarker = 0x4B4E4843; // "CHNK"
+// Chunked too, followed by the save id and the base of a delta save
+constexpr uint32_t kStateMarker = 0x54415453; // "STAT"
+// Raw bytes per chunk, every chunk is an independent zlib stream
+constexpr uint32_t kChunkSize = 1024 * 1024;
+
+// Write the chunk table and the chunks of data at the current file position
+bool Pack(std::fstream &file, const char *data, size_t size, int32_t level);
+// Read the chunks written by Pack into data of exactly size bytes
+bool Unpack(std::fstream &file, char *data, size_t size);
+
+// Runs file jobs one after another on a worker thread, the pending ones are finished on destruction
+class Queue final
+{
+  public:
+    Queue();
+    ~Queue();
+
+    // the job returns false if it failed
+    void Push(std::function<bool()> job);
+    // returns once every pushed job is done
+    void Wait();
+    // jobs that failed since the queue was created
+    [[nodiscard]] size_t NumFailed();
+
+  private:
+    void Run();
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::condition_variable idle_;
+    std::deque<std::function<bool()>> jobs_;
+    size_t numFailed_ = 0;
+    bool isBusy_ = false;
+    bool isStopped_ = false;
+    std::thread thread_;
+};
+} // namespace state_packer
+} // namespace storm
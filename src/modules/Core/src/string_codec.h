@@ -115,6 +115,21 @@ class STRING_CODEC : public VSTRING_CODEC
         return nStringCode;
     }
 
+    uint32_t Find(const std::string_view &str) override
+    {
+        const uint32_t nHash = MakeHashValue(str);
+        const uint32_t nTableIndex = nHash & (HASH_TABLE_SIZE - 1);
+
+        const HTELEMENT *pE = &HTable[nTableIndex];
+
+        for (uint32_t n = 0; n < pE->nStringsNum; n++)
+        {
+            if (pE->pElements[n].dwHashCode == nHash && storm::iEquals(str, pE->pElements[n].pStr))
+                return (nTableIndex << 16) | (n & 0xffff);
+        }
+        return 0xffffffff;
+    }
+
     void VariableChanged() override;
 
     const char *Convert(uint32_t code) override
@@ -139,11 +154,15 @@ class STRING_CODEC : public VSTRING_CODEC
     }
 
     uint32_t MakeHashValue(const char *ps)
+    {
+        return MakeHashValue(std::string_view(ps));
+    }
+
+    uint32_t MakeHashValue(const std::string_view &str)
     {
         uint32_t hval = 0;
-        while (*ps != 0)
+        for (char v : str)
         {
-            char v = *ps++;
             if ('A' <= v && v <= 'Z')
                 v += 'a' - 'A'; // case independent
             hval = (hval << 4) + (uint32_t)v;
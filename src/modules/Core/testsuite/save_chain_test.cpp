@@ -0,0 +1,173 @@
+#include "save_chain.h"
+#include "state_packer.h"
+#include "string_compare.hpp"
+#include "string_codec.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+namespace
+{
+using namespace storm::save_chain;
+
+class TempFolder final
+{
+  public:
+    TempFolder() : path_(std::filesystem::temp_directory_path() / "storm_save_chain_test")
+    {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempFolder()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    const std::filesystem::path &Path() const
+    {
+        return path_;
+    }
+
+  private:
+    std::filesystem::path path_;
+};
+
+// the head of a state as COMPILER::SaveState writes it, without the packed variables
+void WriteState(const std::filesystem::path &path, uint64_t saveId, uint64_t baseId)
+{
+    std::ofstream file(path, std::ios::binary);
+    EXTDATA_HEADER edh{};
+    const uint32_t size = 0;
+    const uint32_t marker = storm::state_packer::kStateMarker;
+    file.write(reinterpret_cast<const char *>(&edh), sizeof(edh));
+    file.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    file.write(reinterpret_cast<const char *>(&marker), sizeof(marker));
+    file.write(reinterpret_cast<const char *>(&saveId), sizeof(saveId));
+    file.write(reinterpret_cast<const char *>(&baseId), sizeof(baseId));
+}
+} // namespace
+
+TEST_CASE("Read state ids", "[save_chain]")
+{
+    TempFolder folder;
+    const auto path = folder.Path() / "slot";
+
+    WriteState(path, 7, 3);
+    StateIds ids;
+    REQUIRE(ReadStateIds(path, ids));
+    CHECK(ids.saveId == 7);
+    CHECK(ids.baseId == 3);
+
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "not a state";
+    CHECK_FALSE(ReadStateIds(path, ids));
+    CHECK_FALSE(ReadStateIds(folder.Path() / "missing", ids));
+}
+
+TEST_CASE("Bases outlive the slots they were saved to", "[save_chain]")
+{
+    TempFolder folder;
+    const auto bases = BasesFolder(folder.Path() / "slotA");
+
+    // slotA is full, slotB a delta on top of it and slotC a delta on top of slotB
+    WriteState(folder.Path() / "slotA", 1, 0);
+    REQUIRE(KeepBase(folder.Path() / "slotA", 1));
+    WriteState(folder.Path() / "slotB", 2, 1);
+    REQUIRE(KeepBase(folder.Path() / "slotB", 2));
+    WriteState(folder.Path() / "slotC", 3, 2);
+
+    // the player overwrites the full save and deletes the first delta
+    WriteState(folder.Path() / "slotA", 4, 0);
+    std::filesystem::remove(folder.Path() / "slotB");
+
+    CHECK(PruneBases(folder.Path(), 4) == 0);
+    StateIds ids;
+    REQUIRE(ReadStateIds(BasePath(bases, 2), ids));
+    CHECK(ids.baseId == 1);
+    REQUIRE(ReadStateIds(BasePath(bases, 1), ids));
+    CHECK(ids.baseId == 0);
+}
+
+TEST_CASE("Prune the bases no save depends on", "[save_chain]")
+{
+    TempFolder folder;
+    const auto bases = BasesFolder(folder.Path() / "slot");
+
+    WriteState(folder.Path() / "slotA", 1, 0);
+    REQUIRE(KeepBase(folder.Path() / "slotA", 1));
+    WriteState(folder.Path() / "slotB", 2, 1);
+    REQUIRE(KeepBase(folder.Path() / "slotB", 2));
+    WriteState(folder.Path() / "slotC", 3, 0);
+    REQUIRE(KeepBase(folder.Path() / "slotC", 3));
+    std::ofstream(bases / "readme.txt") << "not a base";
+
+    // the last save keeps its own base, slotB keeps the one of slotA
+    CHECK(PruneBases(folder.Path(), 3) == 1);
+    CHECK(std::filesystem::exists(BasePath(bases, 1)));
+    CHECK_FALSE(std::filesystem::exists(BasePath(bases, 2)));
+    CHECK(std::filesystem::exists(BasePath(bases, 3)));
+    CHECK(std::filesystem::exists(bases / "readme.txt"));
+
+    // with the delta deleted nothing needs slotA anymore
+    std::filesystem::remove(folder.Path() / "slotB");
+    CHECK(PruneBases(folder.Path(), 3) == 1);
+    CHECK_FALSE(std::filesystem::exists(BasePath(bases, 1)));
+    CHECK(std::filesystem::exists(BasePath(bases, 3)));
+}
+
+TEST_CASE("Remap the name codes of a delta", "[save_chain]")
+{
+    STRING_CODEC saved;
+    STRING_CODEC loaded;
+    std::vector<std::string> names;
+    for (int i = 0; i < 4 * HASH_TABLE_SIZE; i++)
+        names.push_back("name" + std::to_string(i));
+
+    // the same strings in another order put other codes on the colliding ones
+    for (const auto &name : names)
+        saved.Convert(name.c_str());
+    for (auto it = names.rbegin(); it != names.rend(); ++it)
+        loaded.Convert(it->c_str());
+
+    // the loader walks the saved codec bucket by bucket, in the order of the codes
+    auto order = names;
+    std::ranges::sort(order, {}, [&saved](const std::string &name) { return saved.Find(name); });
+    NameCodes codes;
+    for (const auto &name : order)
+        codes.Add(saved.MakeHashValue(name) & (HASH_TABLE_SIZE - 1), loaded.Convert(name.c_str()));
+
+    size_t numRemapped = 0;
+    for (const auto &name : names)
+    {
+        const uint32_t savedCode = saved.Find(name);
+        CHECK(codes.Loaded(savedCode) == loaded.Find(name));
+        numRemapped += savedCode != loaded.Find(name) ? 1 : 0;
+    }
+    CHECK(numRemapped > 0);
+}
+
+TEST_CASE("Prune and reorder attributes to match a delta", "[save_chain]")
+{
+    STRING_CODEC codec;
+    ATTRIBUTES root(codec);
+    root.SetAttribute("a", "1");
+    root.SetAttribute("b", "2");
+    root.SetAttribute("c", "3");
+
+    const std::vector<uint32_t> codes = {codec.Find("c"), codec.Find("a")};
+    PruneAttributes(root, codes);
+
+    REQUIRE(root.GetAttributesNum() == 2);
+    CHECK(root.GetAttributeClass(0u)->GetThisNameCode() == codes[0]);
+    CHECK(root.GetAttributeClass(1u)->GetThisNameCode() == codes[1]);
+    CHECK(root.GetAttributeClass("b") == nullptr);
+
+    // the same children in the same order are left as they are
+    auto *pA = root.GetAttributeClass(0u);
+    PruneAttributes(root, codes);
+    CHECK(root.GetAttributeClass(0u) == pA);
+}
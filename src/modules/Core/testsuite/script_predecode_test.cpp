@@ -0,0 +1,132 @@
+#include "compiler.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+namespace
+{
+// loops and calls, the part of a frame that is spent in the interpreter rather than in the engine
+constexpr char kScript[] = R"(
+int Mix(int a, int b)
+{
+    return a * 3 + b;
+}
+
+int Fib(int n)
+{
+    if (n < 2)
+    {
+        return n;
+    }
+    return Fib(n - 1) + Fib(n - 2);
+}
+
+int Bench()
+{
+    int i;
+    int j;
+    int sum = 0;
+    for (i = 0; i < 100; i++)
+    {
+        for (j = 0; j < 40; j++)
+        {
+            sum = sum + Mix(i, j);
+        }
+    }
+    return sum + Fib(15);
+}
+)";
+
+int32_t Expected()
+{
+    int32_t sum = 0;
+    for (int32_t i = 0; i < 100; i++)
+        for (int32_t j = 0; j < 40; j++)
+            sum += i * 3 + j;
+    // Fib(15)
+    return sum + 610;
+}
+
+// the script in the temp folder, deleted with the object
+class TempScript final
+{
+  public:
+    explicit TempScript(const char *name) : path_(std::filesystem::temp_directory_path() / name)
+    {
+        std::ofstream(path_, std::ios::binary) << kScript;
+    }
+
+    ~TempScript()
+    {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    std::string Path() const
+    {
+        return path_.string();
+    }
+
+  private:
+    std::filesystem::path path_;
+};
+
+// the segment loaded with or without the decoded ops, Bench set as the handler of its event
+std::unique_ptr<COMPILER> Load(const TempScript &script, bool pre_decode)
+{
+    auto compiler = std::make_unique<COMPILER>();
+    compiler->SetPreDecode(pre_decode);
+    if (!compiler->BC_LoadSegment(script.Path().c_str()))
+        return nullptr;
+    compiler->SetEventHandler("Bench", "Bench", 0);
+    return compiler;
+}
+
+int32_t Run(COMPILER &compiler)
+{
+    int32_t result = -1;
+    if (auto *value = compiler.ProcessEvent("Bench"))
+        value->Get(result);
+    return result;
+}
+} // namespace
+
+TEST_CASE("Decoded segment runs as the byte code", "[script_predecode]")
+{
+    const TempScript script("storm_predecode_test.c");
+    const auto decoded = Load(script, true);
+    const auto plain = Load(script, false);
+    REQUIRE(decoded);
+    REQUIRE(plain);
+
+    // twice, the second run starts from the state the first left behind
+    for (int n = 0; n < 2; n++)
+    {
+        CHECK(Run(*decoded) == Expected());
+        CHECK(Run(*plain) == Expected());
+    }
+}
+
+TEST_CASE("Segment with and without predecode", "[script_predecode][benchmark]")
+{
+    const TempScript script("storm_predecode_bench.c");
+    const auto decoded = Load(script, true);
+    const auto plain = Load(script, false);
+    REQUIRE(decoded);
+    REQUIRE(plain);
+
+    BENCHMARK("byte code")
+    {
+        return Run(*plain);
+    };
+
+    BENCHMARK("predecode")
+    {
+        return Run(*decoded);
+    };
+}
@@ -0,0 +1,154 @@
+#include "s_eventtab.h"
+#include "s_functab.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <string>
+
+namespace
+{
+// a loaded script function with a few locals, as the compiler registers it
+FuncInfo MakeFunc(const std::string &name, uint32_t segment_id, uint32_t offset)
+{
+    FuncInfo fi;
+    fi.name = name;
+    fi.segment_id = segment_id;
+    fi.offset = offset;
+    fi.op_index = offset;
+    fi.decl_file_name = "program\\characters\\characters_events.c";
+    fi.decl_line = offset;
+    return fi;
+}
+
+void AddLocals(FuncTable &funcs, size_t func_index, int count)
+{
+    for (int n = 0; n < count; n++)
+    {
+        LocalVarInfo lvi;
+        lvi.name = "local_" + std::to_string(n);
+        lvi.type = VAR_INTEGER;
+        lvi.elements = 1;
+        funcs.AddFuncVar(func_index, lvi);
+    }
+}
+} // namespace
+
+TEST_CASE("Function info outlives its segment", "[script_tables]")
+{
+    FuncTable funcs;
+    const auto func_index = funcs.AddFunc(MakeFunc("OnShipHit", 3, 100));
+    AddLocals(funcs, func_index, 4);
+
+    // a running call holds the info while its segment is unloaded
+    const auto running = funcs.GetFuncRef(func_index);
+    REQUIRE(running);
+    funcs.InvalidateBySegmentID(3);
+    CHECK_FALSE(funcs.GetFuncRef(func_index));
+    CHECK(running->segment_id == 3);
+    CHECK(running->offset == 100);
+    CHECK(running->local_vars.size() == 4);
+
+    // loaded again under the same index
+    CHECK(funcs.AddFunc(MakeFunc("OnShipHit", 5, 200)) == func_index);
+    const auto reloaded = funcs.GetFuncRef(func_index);
+    REQUIRE(reloaded);
+    CHECK(reloaded->offset == 200);
+    CHECK(running->offset == 100);
+}
+
+TEST_CASE("Held handler list sees changes made during the event", "[script_tables]")
+{
+    S_EVENTTAB events;
+    for (uint32_t func_code = 0; func_code < 4; func_code++)
+        events.AddEventHandler("evntShipHit", func_code, func_code < 2 ? 1 : 2, 0);
+    const auto event_code = events.FindEvent("evntShipHit");
+    REQUIRE(event_code != INVALID_EVENT_CODE);
+
+    const auto handlers = events.GetEventHandlers(event_code);
+    REQUIRE(handlers->size() == 4);
+    for (uint32_t n = 0; n < 4; n++)
+        CHECK(events.IsHandlerActive(event_code, handlers, n));
+
+    // the first handler deletes the second one and unloads the segment of the last two
+    events.DelEventHandler("evntShipHit", 1);
+    events.InvalidateBySegmentID(2);
+    CHECK(handlers->size() == 4);
+    CHECK(events.IsHandlerActive(event_code, handlers, 0));
+    CHECK_FALSE(events.IsHandlerActive(event_code, handlers, 1));
+    CHECK_FALSE(events.IsHandlerActive(event_code, handlers, 2));
+    CHECK_FALSE(events.IsHandlerActive(event_code, handlers, 3));
+    CHECK(events.GetEventHandlers(event_code)->size() == 1);
+
+    // handlers added during the event are left for the next one
+    events.AddEventHandler("evntShipHit", 7, 1, 0);
+    CHECK(handlers->size() == 4);
+    CHECK(events.GetEventHandlers(event_code)->size() == 2);
+}
+
+TEST_CASE("Calls and event dispatch without copying", "[script_tables][benchmark]")
+{
+    // an event listened to by a dozen handlers, each with a dozen locals, as the character events are
+    constexpr uint32_t kHandlers = 12;
+    FuncTable funcs;
+    S_EVENTTAB events;
+    for (uint32_t n = 0; n < kHandlers; n++)
+    {
+        const auto func_index = funcs.AddFunc(MakeFunc("OnCharacterEvent_" + std::to_string(n), 1, 100 * n + 1));
+        AddLocals(funcs, func_index, 12);
+        events.AddEventHandler("evntCharacterEvent", static_cast<uint32_t>(func_index), 1, 0);
+    }
+    const auto event_code = events.FindEvent("evntCharacterEvent");
+
+    BENCHMARK("call, copying the function info")
+    {
+        uint64_t sum = 0;
+        FuncInfo fi;
+        for (size_t n = 0; n < kHandlers; n++)
+        {
+            if (funcs.GetFunc(fi, n))
+                sum += fi.offset + fi.local_vars.size();
+        }
+        return sum;
+    };
+
+    BENCHMARK("call, sharing the function info")
+    {
+        uint64_t sum = 0;
+        for (size_t n = 0; n < kHandlers; n++)
+        {
+            if (const auto fi = funcs.GetFuncRef(n))
+                sum += fi->offset + fi->local_vars.size();
+        }
+        return sum;
+    };
+
+    // as ProcessEvent read the handlers before: the event again and a copy of the function info per handler
+    BENCHMARK("event, copying the handlers' info")
+    {
+        uint64_t sum = 0;
+        EVENTINFO ei;
+        FuncInfo fi;
+        for (uint32_t n = 0; events.GetEvent(ei, event_code) && n < ei.elements; n++)
+        {
+            const auto &handler = (*ei.pFuncInfo)[n];
+            if (handler.status == FSTATUS_NORMAL && funcs.GetFuncX(fi, handler.func_code))
+                sum += fi.offset;
+        }
+        return sum;
+    };
+
+    BENCHMARK("event, holding the handler list")
+    {
+        uint64_t sum = 0;
+        const auto handlers = events.GetEventHandlers(event_code);
+        for (uint32_t n = 0; n < handlers->size(); n++)
+        {
+            if (!events.IsHandlerActive(event_code, handlers, n))
+                continue;
+            if (const auto fi = funcs.GetFuncRef((*handlers)[n].func_code))
+                sum += fi->offset;
+        }
+        return sum;
+    };
+}
@@ -0,0 +1,142 @@
+#include "state_packer.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <zlib.h>
+
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+using namespace storm::state_packer;
+
+// a file in the temp folder, deleted with the object
+class TempFile final
+{
+  public:
+    explicit TempFile(const char *name) : path_(std::filesystem::temp_directory_path() / name)
+    {
+    }
+
+    ~TempFile()
+    {
+        std::error_code ec;
+        std::filesystem::remove(path_, ec);
+    }
+
+    std::fstream Open(std::ios::openmode mode) const
+    {
+        return std::fstream(path_, std::ios::binary | mode);
+    }
+
+  private:
+    std::filesystem::path path_;
+};
+
+// variables as SaveState serializes them: names, attribute strings and numbers
+std::vector<char> MakeState(size_t size)
+{
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<int32_t> number(0, 100000);
+    const char *names[] = {"characters", "ship", "cargo", "location", "quest", "reputation", "items", "nation"};
+    std::vector<char> state;
+    state.reserve(size + 64);
+    while (state.size() < size)
+    {
+        const std::string text = names[number(rng) % std::size(names)] + std::to_string(number(rng));
+        state.insert(state.end(), text.begin(), text.end());
+        const auto value = number(rng);
+        state.insert(state.end(), reinterpret_cast<const char *>(&value), reinterpret_cast<const char *>(&value + 1));
+    }
+    state.resize(size);
+    return state;
+}
+
+bool RoundTrip(const TempFile &file, const std::vector<char> &state, int32_t level, std::vector<char> &unpacked)
+{
+    {
+        auto out = file.Open(std::ios::out | std::ios::trunc);
+        if (!Pack(out, state.data(), state.size(), level))
+            return false;
+    }
+    auto in = file.Open(std::ios::in);
+    unpacked.assign(state.size(), 0);
+    return Unpack(in, unpacked.data(), unpacked.size());
+}
+} // namespace
+
+TEST_CASE("Unpack restores what Pack wrote", "[state_packer]")
+{
+    TempFile file("storm_state_packer_test");
+    std::vector<char> unpacked;
+    for (const size_t size : {size_t{1}, size_t{kChunkSize}, size_t{kChunkSize} * 3 + 17})
+    {
+        const auto state = MakeState(size);
+        REQUIRE(RoundTrip(file, state, Z_BEST_SPEED, unpacked));
+        CHECK(unpacked == state);
+    }
+
+    // a state of another size does not match the chunk table
+    const auto state = MakeState(kChunkSize * 2);
+    {
+        auto out = file.Open(std::ios::out | std::ios::trunc);
+        REQUIRE(Pack(out, state.data(), state.size(), Z_BEST_SPEED));
+    }
+    auto in = file.Open(std::ios::in);
+    unpacked.assign(kChunkSize * 4, 0);
+    CHECK_FALSE(Unpack(in, unpacked.data(), unpacked.size()));
+}
+
+TEST_CASE("Queue counts the failed jobs", "[state_packer]")
+{
+    Queue queue;
+    std::vector<int> done;
+    queue.Push([&done] {
+        done.push_back(1);
+        return true;
+    });
+    queue.Push([&done] {
+        done.push_back(2);
+        return false;
+    });
+    queue.Push([&done] {
+        done.push_back(3);
+        return false;
+    });
+    queue.Wait();
+    CHECK(done == std::vector{1, 2, 3});
+    CHECK(queue.NumFailed() == 2);
+}
+
+TEST_CASE("Pack and unpack a large state", "[state_packer][benchmark]")
+{
+    // a late game state of a heavily modded campaign
+    constexpr size_t kStateSize = 384 * 1024 * 1024;
+    const auto state = MakeState(kStateSize);
+    TempFile file("storm_state_packer_benchmark");
+    std::vector<char> unpacked(kStateSize);
+
+    BENCHMARK("Pack, best compression")
+    {
+        auto out = file.Open(std::ios::out | std::ios::trunc);
+        return Pack(out, state.data(), state.size(), Z_BEST_COMPRESSION);
+    };
+
+    BENCHMARK("Pack, best speed")
+    {
+        auto out = file.Open(std::ios::out | std::ios::trunc);
+        return Pack(out, state.data(), state.size(), Z_BEST_SPEED);
+    };
+
+    // the file of the last pack
+    BENCHMARK("Unpack")
+    {
+        auto in = file.Open(std::ios::in);
+        return Unpack(in, unpacked.data(), unpacked.size());
+    };
+    CHECK(unpacked == state);
+}
@@ -1,3 +1,4 @@
+#include <chrono>
 #include <thread>
 
 #include <SDL.h>
@@ -63,6 +64,7 @@
 #include "model_realizer.h"
 #include "modelr.h"
 #include "np_character.h"
+#include "null_render.h"
 #include "pcs_controls.h"
 #include "player.h"
 #include "rope.h"
@@ -127,6 +129,7 @@ constexpr char defaultLoggerName[] = "system";
 bool isRunning = false;
 bool bActive = true;
 bool bSoundInBackground = false;
+bool bNullRender = false;
 
 storm::diag::LifecycleDiagnosticsService lifecycleDiagnostics;
 
@@ -333,7 +336,7 @@ CREATE_SCRIPTLIBRIARY(Config)
 CREATE_SCRIPTLIBRIARY(SCRIPT_INTERFACE_FUNCTIONS)
 
 CREATE_SERVICE(PCS_CONTROLS)
-CREATE_SERVICE(DX9RENDER)
+CREATE_SERVICE_OR(DX9RENDER, NullRender, bNullRender)
 CREATE_SERVICE(ParticleService)
 CREATE_SERVICE(AnimationServiceImp)
 CREATE_SERVICE(COLL)
@@ -351,7 +354,13 @@ int main(int argc, char *argv[])
     CLI::App app("Storm Engine");
 
     bool enable_editor = false;
-    app.add_flag("--editor", enable_editor, "Enable in-game editor");
+    auto *editor_flag = app.add_flag("--editor", enable_editor, "Enable in-game editor");
+    app.add_flag("--null-render", bNullRender, "Run without a device or a window to measure CPU frame time")
+        ->excludes(editor_flag);
+    int32_t fixed_delta = 0;
+    app.add_option("--fixed-delta", fixed_delta, "Advance the game by this many milliseconds every frame");
+    uint32_t max_frames = 0;
+    app.add_option("--frames", max_frames, "Exit after this many frames and log the average frame time");
 
     try
     {
@@ -385,6 +394,11 @@ int main(int argc, char *argv[])
     mi_option_set(mi_option_verbose, 4);
 #endif
 
+    if (bNullRender)
+    {
+        SDL_SetHint(SDL_HINT_VIDEODRIVER, "dummy");
+    }
+
     if (SDL_Init(SDL_INIT_EVENTS | SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) != 0) {
         SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, "SDL ERROR", "Init Error", nullptr);
         SDL_Log("Something went wrong with SDL Init %s", SDL_GetError());
@@ -415,6 +429,9 @@ int main(int argc, char *argv[])
     spdlog::info("Logging system initialized. Running on {}", STORM_BUILD_WATERMARK_STRING);
     spdlog::info("mimalloc-redirect status: {}", mi_is_redirected());
 
+    // Packed resources, loose files still override them
+    fio->MountArchives(Storm::Filesystem::Constants::Paths::resources());
+
     // Init core
     core_private = static_cast<CorePrivate *>(&core);
     core_private->EnableEditor(enable_editor);
@@ -437,11 +454,16 @@ int main(int argc, char *argv[])
         auto config =  Config::Load(Constants::ConfigNames::engine());
         std::ignore = config.SelectSection("Main");
         dwMaxFPS = config.Get<std::int64_t>("max_fps", 0);
+        // a frame time measurement runs uncapped
+        if (max_frames || bNullRender) {
+            dwMaxFPS = 0;
+        }
         bDebugWindow = config.Get<std::int64_t>("DebugWindow", 0) == 1;
         bAcceleration = config.Get<std::string>("Acceleration", "0") == "0";
 
         auto log = config.Get<std::int64_t>("logs", 0);
-        if (log == 0) {
+        // the benchmark summary is logged even with the logs off
+        if (log == 0 && max_frames == 0) {
             spdlog::set_level(spdlog::level::off);
         }
 
@@ -481,9 +503,15 @@ int main(int argc, char *argv[])
 
     // Init core
     core_private->InitBase();
+    if (fixed_delta > 0)
+    {
+        core_private->SetDeltaTime(fixed_delta);
+    }
 
     // Message loop
     auto dwOldTime = SDL_GetTicks();
+    const auto start_time = std::chrono::steady_clock::now();
+    uint32_t num_frames = 0;
 
     isRunning = true;
     while (isRunning)
@@ -508,6 +536,10 @@ int main(int argc, char *argv[])
             }
 
             RunFrameWithOverflowCheck();
+            if (max_frames && ++num_frames == max_frames)
+            {
+                isRunning = false;
+            }
         // }
         // else
         // {
@@ -521,6 +553,22 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (max_frames)
+    {
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start_time;
+        spdlog::info("{} frames, {:.3f} ms per frame", num_frames, elapsed.count() / std::max(num_frames, 1u));
+        if (const auto *null_render = bNullRender ? static_cast<NullRender *>(core.GetService("dx9render")) : nullptr;
+            null_render && null_render->NumFrames() > 0)
+        {
+            const auto &total = null_render->TotalCounters();
+            const double frames = null_render->NumFrames();
+            spdlog::info("per frame: {:.1f} draw calls, {:.1f} primitives, {:.0f} user bytes, {:.0f} locked bytes, "
+                         "{:.1f} state changes, {:.1f} techniques",
+                         total.drawCalls / frames, total.primitives / frames, total.userBytes / frames,
+                         total.lockedBytes / frames, total.stateChanges / frames, total.techniques / frames);
+        }
+    }
+
     // Release
     core_private->Event("ExitApplication");
     core_private->CleanUp();
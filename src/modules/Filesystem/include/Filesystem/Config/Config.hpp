@@ -18,12 +18,25 @@ namespace Storm::Filesystem {
          * \brief
          *
          * \param   file_path   Config file's name.
+         *          \n
+         *          Read from the disk only, resources that may be packed are read with fio->_MapFile and Parse.
          *
          * \return  Config or empty config.
          */
         [[nodiscard]]
         static Config Load(const std::filesystem::path &file_path) noexcept;
 
+        /**
+         * \brief   Parses config text read elsewhere, e.g. from a mounted resource archive.
+         *
+         * \param   text        Config file's contents.
+         * \param   file_path   Config file's name, for messages and Name().
+         *
+         * \return  Config or empty config.
+         */
+        [[nodiscard]]
+        static Config Parse(std::string_view text, const std::filesystem::path &file_path) noexcept;
+
         /**
          * \brief   Select section in toml config for future accessors and mutators.
          *
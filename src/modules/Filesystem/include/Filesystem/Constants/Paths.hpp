@@ -36,6 +36,12 @@ namespace Storm::Filesystem::Constants::Paths {
     [[nodiscard]]
     std::filesystem::path script_cache() noexcept;
 
+    [[nodiscard]]
+    std::filesystem::path animation_cache() noexcept;
+
+    [[nodiscard]]
+    std::filesystem::path resource_index() noexcept;
+
     [[nodiscard]]
     std::filesystem::path save_data() noexcept;
 
@@ -1,8 +1,11 @@
 #pragma once
 
 #include "ifs.h"
+#include "mapped_file.h"
+#include "resource_archive.h"
 #include "v_file_service.h"
 #include <memory>
+#include <string_view>
 #include <unordered_map>
 
 #define _MAX_OPEN_INI_FILES 1024
@@ -90,7 +93,24 @@ class FILE_SERVICE final
     uint32_t Max_File_Index;
     // Resource paths
     bool ResourcePathsFirstScan = true; // Since some code may call this statically, we use a flag to know if this is the first time
-    std::unordered_map<std::string, std::string> ResourcePaths;
+    struct ResourcePathHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view path) const noexcept
+        {
+            return std::hash<std::string_view>{}(path);
+        }
+    };
+    // lower-cased normalized path -> path on disk, looked up by string_view without copies
+    std::unordered_map<std::string, std::string, ResourcePathHash, std::equal_to<>> ResourcePaths;
+    // Mounted archives, the last mounted one wins
+    std::vector<std::unique_ptr<ResourceArchive>> Archives;
+    // normalized game folder the archive entries are relative to, absolute paths below it are looked up without it
+    std::string ArchiveRoot;
+
+    // archive entry of a path, {nullptr, -1} if the path is not packed or a loose file overrides it
+    std::pair<const ResourceArchive *, int32_t> FindArchiveEntry(const char *path) const;
 
   public:
     FILE_SERVICE();
@@ -117,6 +137,8 @@ class FILE_SERVICE final
     bool _CreateDirectory(const char *pathName);
     std::uintmax_t _RemoveDirectory(const char *pathName);
     bool LoadFile(const char *file_name, char **ppBuffer, uint32_t *dwSize);
+    // map the whole file read-only, check IsOpen() on the result
+    MappedFile _MapFile(const char *filename);
     // ini files section
     void Close();
     std::unique_ptr<INIFILE> CreateIniFile(const char *file_name, bool fail_if_exist);
@@ -125,9 +147,19 @@ class FILE_SERVICE final
     void FlushIniFiles();
 
     // Resource paths
-    void AddEntryToResourcePaths(const std::filesystem::directory_entry &entry, std::string &CheckingPath);
+    void AddEntryToResourcePaths(const std::string &path, const std::string &CheckingPath);
     void ScanResourcePaths();
     std::string ConvertPathResource(const char *path);
+    // path on disk of an indexed file or directory, empty if it is not indexed; does not allocate
+    std::string_view FindResourcePath(const char *path);
+
+    // Archives are consulted before loose files by LoadFile, _MapFile, _GetFileSize, _FileOrDirectoryExists and
+    // _GetFsPathsByMask; _CreateFile opens loose files only, resources are read through LoadFile or _MapFile
+    // (toml resources with _MapFile and Config::Parse, Config::Load reads the disk only).
+    // Entries that also exist as loose files are hidden when the archive is mounted, so mods still override them.
+    bool MountArchive(const std::filesystem::path &path);
+    // mount every *.pak in the folder in name order
+    void MountArchives(const std::filesystem::path &folder);
 
     uint64_t GetPathFingerprint(const std::filesystem::path &path);
 };
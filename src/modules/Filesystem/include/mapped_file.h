@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <type_traits>
+
+// Non-owning read-only window into file data, valid while its MappedFile lives
+class FileView final
+{
+  public:
+    FileView() = default;
+    FileView(const char *data, size_t size) noexcept : data_(data), size_(size)
+    {
+    }
+
+    [[nodiscard]] const char *Data() const noexcept
+    {
+        return data_;
+    }
+
+    [[nodiscard]] size_t Size() const noexcept
+    {
+        return size_;
+    }
+
+    [[nodiscard]] bool Empty() const noexcept
+    {
+        return size_ == 0;
+    }
+
+    // count objects of type T at offset, nullptr if they do not fit into the view
+    template <typename T> [[nodiscard]] const T *Get(size_t offset, size_t count = 1) const noexcept
+    {
+        // plain data only, it is used in place
+        static_assert(std::is_standard_layout_v<T> && std::is_trivially_destructible_v<T>);
+        if (offset > size_ || count > (size_ - offset) / sizeof(T))
+            return nullptr;
+        return reinterpret_cast<const T *>(data_ + offset);
+    }
+
+    // reads a byte of every page, a mapped file is read from the disk here and not where the data is used
+    void Touch() const noexcept
+    {
+        constexpr size_t kPageSize = 4096;
+        volatile char sink = 0;
+        for (size_t offset = 0; offset < size_; offset += kPageSize)
+            sink = sink + data_[offset];
+        if (size_)
+            sink = sink + data_[size_ - 1];
+    }
+
+    // sub view, empty if it does not fit
+    [[nodiscard]] FileView Sub(size_t offset, size_t size) const noexcept
+    {
+        if (offset > size_ || size > size_ - offset)
+            return {};
+        return {data_ + offset, size};
+    }
+
+  private:
+    const char *data_{};
+    size_t size_{};
+};
+
+// Whole file mapped read-only into memory, unmapped on destruction.
+// Loaders parse straight from the mapping instead of copying the file into a buffer first.
+// Files from an archive are blocks of memory the owner keeps alive instead.
+class MappedFile final
+{
+  public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path &path);
+    MappedFile(std::shared_ptr<const void> owner, const char *data, size_t size) noexcept;
+    MappedFile(const MappedFile &) = delete;
+    MappedFile(MappedFile &&other) noexcept;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile &operator=(MappedFile &&other) noexcept;
+    ~MappedFile();
+
+    // false if the file could not be opened or is empty
+    [[nodiscard]] bool IsOpen() const noexcept;
+    [[nodiscard]] const char *Data() const noexcept;
+    [[nodiscard]] size_t Size() const noexcept;
+    [[nodiscard]] FileView View() const noexcept;
+    void Close() noexcept;
+
+  private:
+    const char *data_{};
+    size_t size_{};
+    std::shared_ptr<const void> owner_;
+#ifdef _WIN32
+    void *file_{};
+    void *mapping_{};
+#endif
+};
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "mapped_file.h"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace PAK
+{
+struct HEADER;
+struct ENTRY;
+} // namespace PAK
+
+// Read-only archive of resource files, mapped once and looked up through its hash table
+class ResourceArchive final
+{
+  public:
+    // nullptr if the file is not a valid archive
+    static std::unique_ptr<ResourceArchive> Open(const std::filesystem::path &path);
+
+    // Pack every file below dirs (relative to root) into out, level 0 stores the files as is
+    static bool Pack(const std::filesystem::path &root, const std::vector<std::filesystem::path> &dirs,
+                     const std::filesystem::path &out, int level);
+
+    // Archive key of a resource path: lower-cased, '/' separated, without "." and ".."
+    static void NormalizePath(std::string_view path, std::string &out);
+
+    // entry index of a normalized path, -1 if there is none or it is hidden
+    [[nodiscard]] int32_t Find(std::string_view key) const;
+    // the entry is no longer found, used for entries overridden by loose files
+    void Hide(int32_t entry);
+
+    // distinct first path segments of the entries
+    [[nodiscard]] std::vector<std::string> GetRootFolders() const;
+    // keys of the visible entries in a normalized folder, "" for all of them
+    [[nodiscard]] std::vector<std::string_view> GetFiles(std::string_view folder, bool recursive) const;
+
+    [[nodiscard]] uint64_t GetSize(int32_t entry) const;
+    [[nodiscard]] const std::filesystem::path &GetPath() const;
+
+    // entry data, in place for stored entries and unpacked for compressed ones
+    [[nodiscard]] MappedFile Map(int32_t entry) const;
+    // unpack the entry into dst of GetSize() bytes
+    bool Read(int32_t entry, char *dst) const;
+
+  private:
+    ResourceArchive() = default;
+
+    [[nodiscard]] std::string_view GetName(const PAK::ENTRY &entry) const;
+
+    std::filesystem::path path_;
+    std::shared_ptr<MappedFile> file_;
+    const PAK::HEADER *header_{};
+    const PAK::ENTRY *entries_{};
+    const uint32_t *table_{};
+    const char *names_{};
+    std::vector<bool> hidden_;
+};
@@ -22,6 +22,17 @@ Config Config::Load(const std::filesystem::path &file_path) noexcept {
     return std::move(config);
 }
 
+Config Config::Parse(std::string_view text, const std::filesystem::path &file_path) noexcept {
+    Config config;
+    try {
+        config._config = toml::parse(text, file_path.string());
+    } catch (const toml::parse_error &err) {
+        std::printf("Can't parse config file - %s\n", file_path.string().c_str());
+        std::printf("\tError - %s\n\t\t%s\n", err.what(), std::string(err.description()).c_str());
+    }
+    return std::move(config);
+}
+
 bool Config::SelectSection(const std::string_view &section_name) noexcept {
     if (_config.empty()) {
         return false;
@@ -64,6 +64,14 @@ std::filesystem::path Paths::script_cache() noexcept {
     return {stash() / "Cache"};
 }
 
+std::filesystem::path Paths::animation_cache() noexcept {
+    return {stash() / "AnimationCache"};
+}
+
+std::filesystem::path Paths::resource_index() noexcept {
+    return {stash() / "resource_index.bin"};
+}
+
 std::filesystem::path Paths::save_data() noexcept {
     return {stash() / "SaveData"};
 }
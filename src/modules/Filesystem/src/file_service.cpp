@@ -6,10 +6,14 @@
 #include "string_compare.hpp"
 #include "platform/platform.hpp"
 
+#include "Filesystem/Constants/Paths.hpp"
+
 #include <SDL.h>
 #include <exception>
+#include <functional>
 #include <string>
 #include <ranges>
+#include <unordered_set>
 
 #define COMMENT ';'
 #define SECTION_A '['
@@ -106,6 +110,10 @@ bool FILE_SERVICE::_ReadFile(std::fstream &fileS, void *s, std::streamsize count
 
 bool FILE_SERVICE::_FileOrDirectoryExists(const char *p)
 {
+    if (FindArchiveEntry(p).first)
+    {
+        return true;
+    }
     std::filesystem::path path = std::filesystem::u8path(ConvertPathResource(p));
     auto ec = std::error_code{};
     bool result = std::filesystem::exists(path, ec);
@@ -179,27 +187,58 @@ std::vector<std::filesystem::path> FILE_SERVICE::_GetFsPathsByMask(const char *s
         srcPath = std::filesystem::u8path(ConvertPathResource(sourcePath));
     }
 
+    // a folder may be packed only, so a missing loose one is no error then
+    std::vector<std::filesystem::path> result;
     std::error_code ec;
     if (recursive)
     {
         auto it = std::filesystem::recursive_directory_iterator(srcPath, ec);
-        if (ec)
+        if (!ec)
         {
-            spdlog::warn("Failed to create recursive directory iterator for '{}': {}", srcPath.string(), ec.message());
-            return {};
+            result = iter_directory(it, mask, getPaths, onlyDirs, onlyFiles);
         }
-        return iter_directory(it, mask, getPaths, onlyDirs, onlyFiles);
     }
     else
     {
         auto it = std::filesystem::directory_iterator(srcPath, ec);
-        if (ec)
+        if (!ec)
         {
-            spdlog::warn("Failed to create directory iterator for '{}': {}", srcPath.string(), ec.message());
-            return {};
+            result = iter_directory(it, mask, getPaths, onlyDirs, onlyFiles);
         }
-        return iter_directory(it, mask, getPaths, onlyDirs, onlyFiles);
     }
+
+    // Packed files are listed by their archive keys, loose files overriding them are listed above
+    if (!onlyDirs && !Archives.empty())
+    {
+        std::string folder;
+        if (sourcePath != nullptr)
+        {
+            ResourceArchive::NormalizePath(sourcePath, folder);
+        }
+        std::unordered_set<std::string_view> listed;
+        for (auto it = Archives.rbegin(); it != Archives.rend(); ++it)
+        {
+            for (const auto name : (*it)->GetFiles(folder, recursive))
+            {
+                const auto fileName = name.substr(name.rfind('/') + 1);
+                if ((mask == nullptr || storm::wildicmp(mask, std::string(fileName).c_str())) &&
+                    listed.insert(name).second)
+                {
+                    result.push_back(std::filesystem::u8path(getPaths ? name : fileName));
+                }
+            }
+        }
+        if (!listed.empty())
+        {
+            ec.clear();
+        }
+    }
+
+    if (ec)
+    {
+        spdlog::warn("Failed to list '{}': {}", srcPath.string(), ec.message());
+    }
+    return result;
 }
 
 std::filesystem::file_time_type FILE_SERVICE::_GetLastWriteTime(const char *filename)
@@ -228,6 +267,10 @@ std::string FILE_SERVICE::_GetExecutableDirectory()
 
 std::uintmax_t FILE_SERVICE::_GetFileSize(const char *filename)
 {
+    if (const auto [archive, entry] = FindArchiveEntry(filename); archive)
+    {
+        return archive->GetSize(entry);
+    }
     std::filesystem::path path = std::filesystem::u8path(ConvertPathResource(filename));
     return std::filesystem::file_size(path);
 }
@@ -360,6 +403,29 @@ bool FILE_SERVICE::LoadFile(const char *file_name, char **ppBuffer, uint32_t *dw
     if (ppBuffer == nullptr)
         return false;
 
+    if (const auto [archive, entry] = FindArchiveEntry(file_name); archive)
+    {
+        const auto size = archive->GetSize(entry);
+        if (dwSize)
+        {
+            *dwSize = static_cast<uint32_t>(size);
+        }
+        *ppBuffer = nullptr;
+        if (size == 0)
+        {
+            return false;
+        }
+        auto *buffer = new char[size];
+        if (!archive->Read(entry, buffer))
+        {
+            spdlog::error("Can't unpack {} from {}", file_name, archive->GetPath().string());
+            delete[] buffer;
+            return false;
+        }
+        *ppBuffer = buffer;
+        return true;
+    }
+
     auto fileS = fio->_CreateFile(file_name, std::ios::binary | std::ios::in);
     if (!fileS.is_open())
     {
@@ -383,6 +449,115 @@ bool FILE_SERVICE::LoadFile(const char *file_name, char **ppBuffer, uint32_t *dw
     return true;
 }
 
+MappedFile FILE_SERVICE::_MapFile(const char *filename)
+{
+    if (const auto [archive, entry] = FindArchiveEntry(filename); archive)
+    {
+        auto file = archive->Map(entry);
+        if (!file.IsOpen() && archive->GetSize(entry) != 0)
+        {
+            spdlog::error("Can't unpack {} from {}", filename, archive->GetPath().string());
+        }
+        return file;
+    }
+
+    MappedFile file(std::filesystem::u8path(ConvertPathResource(filename)));
+    if (!file.IsOpen())
+    {
+        spdlog::trace("Can't map file: {}", filename);
+    }
+    return file;
+}
+
+//------------------------------------------------------------------------------------------------
+// Archives
+//
+
+namespace
+{
+// archive key of the last lookup on this thread
+thread_local std::string archive_key;
+} // namespace
+
+bool FILE_SERVICE::MountArchive(const std::filesystem::path &path)
+{
+    auto archive = ResourceArchive::Open(path);
+    if (!archive)
+    {
+        spdlog::error("Can't mount archive {}", path.string());
+        return false;
+    }
+    std::error_code ec;
+    ResourceArchive::NormalizePath(std::filesystem::current_path(ec).generic_string(), ArchiveRoot);
+
+    // loose files override the archive, one walk over the folders it covers finds them
+    size_t hidden = 0;
+    for (const auto &folder : archive->GetRootFolders())
+    {
+        // resolve the folder's case like any other resource path
+        const auto loose = std::filesystem::u8path(ConvertPathResource(folder.c_str()));
+        for (auto it = std::filesystem::recursive_directory_iterator(loose, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (!it->is_regular_file(ec))
+            {
+                continue;
+            }
+            ResourceArchive::NormalizePath(it->path().string(), archive_key);
+            if (const auto entry = archive->Find(archive_key); entry >= 0)
+            {
+                archive->Hide(entry);
+                hidden++;
+            }
+        }
+    }
+
+    spdlog::info("Mounted archive {}, {} entries overridden by loose files", path.string(), hidden);
+    Archives.push_back(std::move(archive));
+    return true;
+}
+
+void FILE_SERVICE::MountArchives(const std::filesystem::path &folder)
+{
+    std::vector<std::filesystem::path> paths;
+    std::error_code ec;
+    for (const auto &entry : std::filesystem::directory_iterator(folder, ec))
+    {
+        if (entry.is_regular_file(ec) && storm::iEquals(entry.path().extension().string(), ".pak"))
+        {
+            paths.push_back(entry.path());
+        }
+    }
+    std::ranges::sort(paths);
+    for (const auto &path : paths)
+    {
+        MountArchive(path);
+    }
+}
+
+std::pair<const ResourceArchive *, int32_t> FILE_SERVICE::FindArchiveEntry(const char *path) const
+{
+    if (Archives.empty() || path == nullptr)
+    {
+        return {nullptr, -1};
+    }
+    ResourceArchive::NormalizePath(path, archive_key);
+    // absolute paths into the game folder, e.g. built from Constants::Paths, are looked up by their relative part
+    if (!ArchiveRoot.empty() && archive_key.size() > ArchiveRoot.size() && archive_key.starts_with(ArchiveRoot) &&
+        archive_key[ArchiveRoot.size()] == '/')
+    {
+        archive_key.erase(0, ArchiveRoot.size() + 1);
+    }
+    for (auto it = Archives.rbegin(); it != Archives.rend(); ++it)
+    {
+        if (const auto entry = (*it)->Find(archive_key); entry >= 0)
+        {
+            return {it->get(), entry};
+        }
+    }
+    return {nullptr, -1};
+}
+
 //------------------------------------------------------------------------------------------------
 // Resource paths
 //
@@ -432,18 +607,239 @@ std::string convert_path(const char *path)
     return conv;
 }
 
-void FILE_SERVICE::AddEntryToResourcePaths(const std::filesystem::directory_entry &entry, std::string &CheckingPath)
+#ifndef _WIN32
+namespace
+{
+constexpr uint32_t kResourceIndexMagic = 0x58444952; // "RIDX"
+constexpr uint32_t kResourceIndexVersion = 1;
+
+// Listing of one scanned directory, reused while the directory's mtime is unchanged
+struct ResourceDirectory
 {
-    if (entry.is_regular_file() || entry.is_directory())
+    struct Entry
     {
-        std::string path = get_dir_iterator_path(entry.path());
-        std::string path_lwr = convert_path(path.c_str());
-        std::ranges::for_each(path_lwr, [](char &c) { c = std::tolower(c); });
-        if (starts_with(path_lwr, CheckingPath + "program") || starts_with(path_lwr, CheckingPath + "resource") ||
-            starts_with(path_lwr, CheckingPath + "save") || ends_with(path_lwr, ".ini"))
+        std::string name;
+        bool isScanned; // real directory, not a link
+    };
+
+    std::string path;
+    int64_t time;
+    std::vector<Entry> entries;
+};
+
+using ResourceDirectories = std::unordered_map<std::string, ResourceDirectory>;
+
+// normalized path of the last lookup on this thread
+thread_local std::string resource_path_lwr;
+
+std::string JoinResourcePath(const std::string &dir, const std::string &name)
+{
+    // same paths recursive_directory_iterator gives, without the leading "./"
+    if (dir == ".")
+        return name;
+    if (!dir.empty() && dir.back() == PATH_SEP)
+        return dir + name;
+    return dir + PATH_SEP + name;
+}
+
+// Walk dir recursively, listing only directories that changed since they were cached
+void ScanResourceDirectory(const std::string &dir, const ResourceDirectories &cached, ResourceDirectories &scanned,
+                           const std::function<void(const std::string &)> &addEntry)
+{
+    std::error_code ec;
+    const auto time = std::filesystem::last_write_time(dir, ec);
+    if (ec)
+        return;
+
+    ResourceDirectory directory{dir, time.time_since_epoch().count(), {}};
+    if (const auto it = cached.find(dir); it != cached.end() && it->second.time == directory.time)
+    {
+        directory.entries = it->second.entries;
+    }
+    else
+    {
+        for (const auto &entry : std::filesystem::directory_iterator(dir, ec))
+        {
+            std::error_code entry_ec;
+            const bool is_directory = entry.is_directory(entry_ec);
+            if (is_directory || entry.is_regular_file(entry_ec))
+                directory.entries.push_back(
+                    {entry.path().filename().string(), is_directory && !entry.is_symlink(entry_ec)});
+        }
+    }
+
+    for (const auto &entry : directory.entries)
+    {
+        const auto path = JoinResourcePath(dir, entry.name);
+        addEntry(path);
+        if (entry.isScanned)
+            ScanResourceDirectory(path, cached, scanned, addEntry);
+    }
+    scanned[dir] = std::move(directory);
+}
+
+void WriteIndexString(std::ofstream &stream, const std::string &str)
+{
+    const auto size = static_cast<uint32_t>(str.size());
+    stream.write(reinterpret_cast<const char *>(&size), sizeof(size));
+    stream.write(str.data(), size);
+}
+
+bool ReadIndexString(std::ifstream &stream, std::string &str)
+{
+    uint32_t size;
+    if (!stream.read(reinterpret_cast<char *>(&size), sizeof(size)) || size > 0x10000)
+        return false;
+    str.resize(size);
+    return static_cast<bool>(stream.read(str.data(), size));
+}
+
+// Directories from the previous run, empty if they were listed from another place
+ResourceDirectories LoadResourceIndex(const std::string &current_dir, const std::string &exe_dir)
+{
+    ResourceDirectories result;
+    std::ifstream stream(Storm::Filesystem::Constants::Paths::resource_index(), std::ios::binary);
+    uint32_t magic, version, count;
+    std::string stored_current_dir, stored_exe_dir;
+    if (!stream || !stream.read(reinterpret_cast<char *>(&magic), sizeof(magic)) ||
+        !stream.read(reinterpret_cast<char *>(&version), sizeof(version)) || magic != kResourceIndexMagic ||
+        version != kResourceIndexVersion || !ReadIndexString(stream, stored_current_dir) ||
+        !ReadIndexString(stream, stored_exe_dir) || stored_current_dir != current_dir || stored_exe_dir != exe_dir ||
+        !stream.read(reinterpret_cast<char *>(&count), sizeof(count)))
+        return {};
+
+    for (uint32_t n = 0; n < count; n++)
+    {
+        ResourceDirectory directory;
+        uint32_t entries_num;
+        if (!ReadIndexString(stream, directory.path) ||
+            !stream.read(reinterpret_cast<char *>(&directory.time), sizeof(directory.time)) ||
+            !stream.read(reinterpret_cast<char *>(&entries_num), sizeof(entries_num)))
+            return {};
+        directory.entries.resize(entries_num);
+        for (auto &entry : directory.entries)
+        {
+            char is_scanned;
+            if (!ReadIndexString(stream, entry.name) || !stream.get(is_scanned))
+                return {};
+            entry.isScanned = is_scanned != 0;
+        }
+        auto path = directory.path;
+        result.emplace(std::move(path), std::move(directory));
+    }
+    return result;
+}
+
+void SaveResourceIndex(const std::string &current_dir, const std::string &exe_dir,
+                       const ResourceDirectories &directories)
+{
+    const auto path = Storm::Filesystem::Constants::Paths::resource_index();
+    if (!path.has_parent_path())
+        return;
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+    if (!stream)
+        return;
+
+    stream.write(reinterpret_cast<const char *>(&kResourceIndexMagic), sizeof(kResourceIndexMagic));
+    stream.write(reinterpret_cast<const char *>(&kResourceIndexVersion), sizeof(kResourceIndexVersion));
+    WriteIndexString(stream, current_dir);
+    WriteIndexString(stream, exe_dir);
+    const auto count = static_cast<uint32_t>(directories.size());
+    stream.write(reinterpret_cast<const char *>(&count), sizeof(count));
+    for (const auto &[dir_path, directory] : directories)
+    {
+        WriteIndexString(stream, directory.path);
+        stream.write(reinterpret_cast<const char *>(&directory.time), sizeof(directory.time));
+        const auto entries_num = static_cast<uint32_t>(directory.entries.size());
+        stream.write(reinterpret_cast<const char *>(&entries_num), sizeof(entries_num));
+        for (const auto &entry : directory.entries)
+        {
+            WriteIndexString(stream, entry.name);
+            stream.put(entry.isScanned ? 1 : 0);
+        }
+    }
+}
+
+bool IsSameListing(const ResourceDirectories &lhs, const ResourceDirectories &rhs)
+{
+    if (lhs.size() != rhs.size())
+        return false;
+    for (const auto &[path, directory] : lhs)
+    {
+        const auto it = rhs.find(path);
+        if (it == rhs.end() || it->second.time != directory.time ||
+            it->second.entries.size() != directory.entries.size())
+            return false;
+    }
+    return true;
+}
+
+bool EndsWithDotDot(const std::string &path, size_t root)
+{
+    const size_t separator = path.rfind(PATH_SEP);
+    const size_t last = separator == std::string::npos || separator < root ? root : separator + 1;
+    return std::string_view(path).substr(last) == "..";
+}
+
+// lower-cased std::filesystem::path::lexically_normal(), reusing out's storage
+void NormalizeResourcePath(std::string_view path, std::string &out)
+{
+    out.clear();
+    if (!path.empty() && (path[0] == PATH_SEP || path[0] == WRONG_PATH_SEP))
+        out.push_back(PATH_SEP);
+    const size_t root = out.size();
+    bool is_trailing = false;
+    size_t pos = 0;
+    while (pos < path.size())
+    {
+        size_t end = path.find_first_of("/\\", pos);
+        if (end == std::string_view::npos)
+            end = path.size();
+        const auto segment = path.substr(pos, end - pos);
+        pos = end + 1;
+        is_trailing = pos <= path.size();
+        if (segment.empty() || segment == ".")
         {
-            ResourcePaths[path_lwr] = path;
+            is_trailing = true;
+            continue;
         }
+        if (segment == "..")
+        {
+            if (out.size() > root && !EndsWithDotDot(out, root))
+            {
+                // drop the previous name
+                const size_t separator = out.rfind(PATH_SEP);
+                out.resize(separator == std::string::npos || separator < root ? root : separator);
+                is_trailing = true;
+                continue;
+            }
+            if (root > 0)
+                continue;
+            is_trailing = false;
+        }
+        if (out.size() > root)
+            out.push_back(PATH_SEP);
+        for (const char c : segment)
+            out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+    if (is_trailing && out.size() > root && !EndsWithDotDot(out, root))
+        out.push_back(PATH_SEP);
+    if (out.empty() && !path.empty())
+        out.push_back('.');
+}
+} // namespace
+#endif
+
+void FILE_SERVICE::AddEntryToResourcePaths(const std::string &path, const std::string &CheckingPath)
+{
+    std::string path_lwr = convert_path(path.c_str());
+    std::ranges::for_each(path_lwr, [](char &c) { c = std::tolower(c); });
+    if (starts_with(path_lwr, CheckingPath + "program") || starts_with(path_lwr, CheckingPath + "resource") ||
+        starts_with(path_lwr, CheckingPath + "save") || ends_with(path_lwr, ".ini"))
+    {
+        ResourcePaths[path_lwr] = path;
     }
 }
 
@@ -453,61 +849,68 @@ void FILE_SERVICE::ScanResourcePaths()
     if (ResourcePathsFirstScan)
     {
         // Seems like if static code calls us we need to do this manually to avoid any bugs
-        ResourcePaths = std::unordered_map<std::string, std::string>();
+        ResourcePaths = decltype(ResourcePaths)();
     }
     ResourcePaths.clear();
+
+    // directories whose mtime did not change are taken from the previous run instead of being listed again
+    std::error_code ec;
+    const auto current_dir = std::filesystem::current_path(ec).string();
+    const auto exe_dir = fio->_GetExecutableDirectory();
+    const auto cached = LoadResourceIndex(current_dir, exe_dir);
+    ResourceDirectories scanned;
+
     std::string ExePath = "";
-    for (const auto &entry : std::filesystem::recursive_directory_iterator("."))
-    {
-        AddEntryToResourcePaths(entry, ExePath);
-    }
-    ExePath = fio->_GetExecutableDirectory();
-    auto it = std::filesystem::recursive_directory_iterator(ExePath);
+    ScanResourceDirectory(".", cached, scanned, [&](const std::string &path) { AddEntryToResourcePaths(path, ExePath); });
+    ExePath = exe_dir;
     std::ranges::for_each(ExePath, [](char &c) { c = std::tolower(c); });
-    for (const auto &entry : it)
-    {
-        AddEntryToResourcePaths(entry, ExePath);
-    }
+    ScanResourceDirectory(exe_dir, cached, scanned,
+                          [&](const std::string &path) { AddEntryToResourcePaths(path, ExePath); });
+
+    if (!IsSameListing(scanned, cached))
+        SaveResourceIndex(current_dir, exe_dir, scanned);
 #endif
     ResourcePathsFirstScan = false;
 }
 
-std::string FILE_SERVICE::ConvertPathResource(const char *path)
+std::string_view FILE_SERVICE::FindResourcePath(const char *path)
 {
 #ifdef _WIN32
-    return std::string(path);
+    return path;
 #else
     if (ResourcePathsFirstScan)
     {
         ScanResourcePaths();
     }
-    std::string conv = convert_path(path);
-    std::string path_lwr = conv; // save original string if we will need to create new file in existing folder
-    std::ranges::for_each(path_lwr, [](char &c) { c = std::tolower(c); });
-    std::filesystem::path tmp_path = std::filesystem::u8path(path_lwr).lexically_normal(); // remove relative paths
-    path_lwr = tmp_path.string();
-    std::string result = ResourcePaths[path_lwr];
-    if (result.empty())
-    {
-        // if we need to create new file in existing folder, then we need to check ResourcePaths[parent_folder]
-        result = ResourcePaths[tmp_path.parent_path().string()];
-        if (result.empty())
-        {
-            // no such parent folder
-            return path_lwr;
-        }
-        else
-        {
-            // parent folder found
-            result = result + PATH_SEP + std::filesystem::u8path(conv).filename().string();
-            ResourcePaths[path_lwr] = result;
-            return result;
-        }
+    NormalizeResourcePath(path, resource_path_lwr);
+    const auto it = ResourcePaths.find(std::string_view(resource_path_lwr));
+    return it != ResourcePaths.end() ? std::string_view(it->second) : std::string_view();
+#endif
+}
+
+std::string FILE_SERVICE::ConvertPathResource(const char *path)
+{
+#ifdef _WIN32
+    return std::string(path);
+#else
+    if (const auto result = FindResourcePath(path); !result.empty())
+    {
+        return std::string(result);
     }
-    else
+    const std::string &path_lwr = resource_path_lwr;
+    // if we need to create new file in existing folder, then we need to check ResourcePaths[parent_folder]
+    const size_t separator = path_lwr.rfind(PATH_SEP);
+    const auto parent =
+        separator == std::string::npos ? std::string_view() : std::string_view(path_lwr).substr(0, separator);
+    const auto it = parent.empty() ? ResourcePaths.end() : ResourcePaths.find(parent);
+    if (it == ResourcePaths.end() || it->second.empty())
     {
-        return result;
+        // no such parent folder
+        return path_lwr;
     }
+    // parent folder found
+    const std::string_view file_name(path);
+    return it->second + PATH_SEP + std::string(file_name.substr(file_name.find_last_of("/\\") + 1));
 #endif
 }
 
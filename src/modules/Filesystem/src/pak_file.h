@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+// Packed resource archive, offsets are from the start of the file
+
+// HEADER
+// data of the entries, each block aligned to DATA_ALIGNMENT
+// ENTRY entry[numEntries]
+// uint32_t table[tableSize] - open addressing by ENTRY::hash, entry index + 1 or 0 for a free slot
+// char names[namesSize] - lower-cased paths with '/' separators relative to the game folder
+
+#pragma pack(push, 1)
+
+namespace PAK
+{
+constexpr uint32_t MAGIC = 0x4b415053; // "SPAK"
+constexpr uint32_t VERSION = 1;
+constexpr uint64_t DATA_ALIGNMENT = 16;
+
+enum COMPRESSION : uint32_t
+{
+    COMPRESSION_NONE = 0,
+    COMPRESSION_ZLIB = 1,
+};
+
+struct HEADER
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numEntries;
+    uint32_t tableSize; // power of two
+    uint64_t entriesOffset;
+    uint64_t tableOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+};
+
+struct ENTRY
+{
+    uint64_t hash; // FNV-1a of the name
+    uint64_t offset;
+    uint64_t storedSize;
+    uint64_t size;
+    uint32_t nameOffset;
+    uint32_t nameSize;
+    uint32_t compression;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(HEADER) == 48);
+static_assert(sizeof(ENTRY) == 48);
+} // namespace PAK
+
+#pragma pack(pop)
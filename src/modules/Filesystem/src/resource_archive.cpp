@@ -0,0 +1,341 @@
+#include "resource_archive.h"
+
+#include "pak_file.h"
+
+#include <spdlog/spdlog.h>
+#include <zlib.h>
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <fstream>
+#include <limits>
+#include <system_error>
+
+namespace
+{
+
+uint64_t Hash(std::string_view key)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (const char c : key)
+    {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+bool Unpack(const PAK::ENTRY &entry, const char *src, char *dst)
+{
+    switch (entry.compression)
+    {
+    case PAK::COMPRESSION_NONE:
+        std::copy_n(src, entry.size, dst);
+        return true;
+    case PAK::COMPRESSION_ZLIB: {
+        auto size = static_cast<uLongf>(entry.size);
+        return uncompress(reinterpret_cast<Bytef *>(dst), &size, reinterpret_cast<const Bytef *>(src),
+                          static_cast<uLong>(entry.storedSize)) == Z_OK &&
+               size == entry.size;
+    }
+    default:
+        return false;
+    }
+}
+
+void WritePadding(std::ofstream &stream, uint64_t &offset)
+{
+    static constexpr char zeros[PAK::DATA_ALIGNMENT]{};
+    const auto padding = (PAK::DATA_ALIGNMENT - offset % PAK::DATA_ALIGNMENT) % PAK::DATA_ALIGNMENT;
+    stream.write(zeros, static_cast<std::streamsize>(padding));
+    offset += padding;
+}
+
+} // namespace
+
+std::unique_ptr<ResourceArchive> ResourceArchive::Open(const std::filesystem::path &path)
+{
+    auto file = std::make_shared<MappedFile>(path);
+    const auto view = file->View();
+    const auto *header = view.Get<PAK::HEADER>(0);
+    if (!header || header->magic != PAK::MAGIC || header->version != PAK::VERSION ||
+        !std::has_single_bit(header->tableSize) || header->tableSize <= header->numEntries)
+        return nullptr;
+
+    std::unique_ptr<ResourceArchive> archive(new ResourceArchive());
+    archive->entries_ = view.Get<PAK::ENTRY>(header->entriesOffset, header->numEntries);
+    archive->table_ = view.Get<uint32_t>(header->tableOffset, header->tableSize);
+    archive->names_ = view.Get<char>(header->namesOffset, header->namesSize);
+    if (!archive->entries_ || !archive->table_ || (!archive->names_ && header->namesSize))
+        return nullptr;
+
+    // everything Find and Map touch is checked once here
+    for (uint32_t i = 0; i < header->tableSize; i++)
+    {
+        if (archive->table_[i] > header->numEntries)
+            return nullptr;
+    }
+    for (uint32_t i = 0; i < header->numEntries; i++)
+    {
+        const auto &entry = archive->entries_[i];
+        if (entry.nameOffset > header->namesSize || entry.nameSize > header->namesSize - entry.nameOffset ||
+            !view.Get<char>(entry.offset, entry.storedSize) ||
+            (entry.compression == PAK::COMPRESSION_NONE && entry.storedSize != entry.size))
+            return nullptr;
+    }
+
+    archive->path_ = path;
+    archive->header_ = header;
+    archive->file_ = std::move(file);
+    archive->hidden_.resize(header->numEntries);
+    return archive;
+}
+
+bool ResourceArchive::Pack(const std::filesystem::path &root, const std::vector<std::filesystem::path> &dirs,
+                           const std::filesystem::path &out, int level)
+{
+    struct File
+    {
+        std::string name;
+        std::filesystem::path path;
+    };
+
+    // collect files, sorted so the same tree always gives the same archive
+    std::vector<File> files;
+    std::error_code ec;
+    for (const auto &dir : dirs)
+    {
+        for (auto it = std::filesystem::recursive_directory_iterator(root / dir, ec);
+             !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+        {
+            if (!it->is_regular_file(ec) || it->path().extension() == out.extension())
+                continue;
+            File file{{}, it->path()};
+            NormalizePath(std::filesystem::relative(it->path(), root, ec).generic_string(), file.name);
+            files.push_back(std::move(file));
+        }
+        if (ec)
+        {
+            spdlog::error("Can't list {}: {}", (root / dir).string(), ec.message());
+            return false;
+        }
+    }
+    std::ranges::sort(files, {}, &File::name);
+    files.erase(std::ranges::unique(files, {}, &File::name).begin(), files.end());
+    if (files.size() >= std::numeric_limits<uint32_t>::max() / 2)
+        return false;
+
+    auto tmpPath = out;
+    tmpPath += ".tmp";
+    std::ofstream stream(tmpPath, std::ios::binary | std::ios::trunc);
+    if (!stream)
+    {
+        spdlog::error("Can't create {}", tmpPath.string());
+        return false;
+    }
+
+    PAK::HEADER header{};
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    uint64_t offset = sizeof(header);
+
+    std::vector<PAK::ENTRY> entries;
+    std::string names;
+    std::vector<Bytef> packed;
+    for (const auto &file : files)
+    {
+        const MappedFile data(file.path);
+        PAK::ENTRY entry{};
+        entry.hash = Hash(file.name);
+        entry.nameOffset = static_cast<uint32_t>(names.size());
+        entry.nameSize = static_cast<uint32_t>(file.name.size());
+        entry.size = data.Size();
+        entry.storedSize = data.Size();
+        entry.compression = PAK::COMPRESSION_NONE;
+        names += file.name;
+
+        const char *stored = data.Data();
+        // keep the packed data only if it saves at least an eighth
+        if (level > 0 && data.Size() > 0 && data.Size() <= std::numeric_limits<uint32_t>::max())
+        {
+            auto packedSize = compressBound(static_cast<uLong>(data.Size()));
+            packed.resize(packedSize);
+            if (compress2(packed.data(), &packedSize, reinterpret_cast<const Bytef *>(data.Data()),
+                          static_cast<uLong>(data.Size()), level) == Z_OK &&
+                packedSize < data.Size() - data.Size() / 8)
+            {
+                entry.storedSize = packedSize;
+                entry.compression = PAK::COMPRESSION_ZLIB;
+                stored = reinterpret_cast<const char *>(packed.data());
+            }
+        }
+
+        WritePadding(stream, offset);
+        entry.offset = offset;
+        stream.write(stored, static_cast<std::streamsize>(entry.storedSize));
+        offset += entry.storedSize;
+        entries.push_back(entry);
+    }
+
+    header.magic = PAK::MAGIC;
+    header.version = PAK::VERSION;
+    header.numEntries = static_cast<uint32_t>(entries.size());
+    // at most half full, so probes stay short
+    header.tableSize = std::bit_ceil(std::max(header.numEntries * 2, 16u));
+    std::vector<uint32_t> table(header.tableSize);
+    for (uint32_t i = 0; i < header.numEntries; i++)
+    {
+        auto slot = static_cast<uint32_t>(entries[i].hash) & (header.tableSize - 1);
+        while (table[slot])
+            slot = (slot + 1) & (header.tableSize - 1);
+        table[slot] = i + 1;
+    }
+
+    WritePadding(stream, offset);
+    header.entriesOffset = offset;
+    header.tableOffset = header.entriesOffset + entries.size() * sizeof(PAK::ENTRY);
+    header.namesOffset = header.tableOffset + table.size() * sizeof(uint32_t);
+    header.namesSize = names.size();
+    stream.write(reinterpret_cast<const char *>(entries.data()),
+                 static_cast<std::streamsize>(entries.size() * sizeof(PAK::ENTRY)));
+    stream.write(reinterpret_cast<const char *>(table.data()),
+                 static_cast<std::streamsize>(table.size() * sizeof(uint32_t)));
+    stream.write(names.data(), static_cast<std::streamsize>(names.size()));
+    stream.seekp(0);
+    stream.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    stream.close();
+    if (!stream)
+    {
+        spdlog::error("Can't write {}", tmpPath.string());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+
+    std::filesystem::rename(tmpPath, out, ec);
+    if (ec)
+    {
+        spdlog::error("Can't write {}: {}", out.string(), ec.message());
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    spdlog::info("Packed {} files into {}", entries.size(), out.string());
+    return true;
+}
+
+void ResourceArchive::NormalizePath(std::string_view path, std::string &out)
+{
+    out.clear();
+    size_t pos = 0;
+    while (pos < path.size())
+    {
+        size_t end = path.find_first_of("/\\", pos);
+        if (end == std::string_view::npos)
+            end = path.size();
+        const auto segment = path.substr(pos, end - pos);
+        pos = end + 1;
+        if (segment.empty() || segment == ".")
+            continue;
+        if (segment == ".." && !out.empty())
+        {
+            const size_t separator = out.rfind('/');
+            out.resize(separator == std::string::npos ? 0 : separator);
+            continue;
+        }
+        if (!out.empty())
+            out.push_back('/');
+        for (const char c : segment)
+            out.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+    }
+}
+
+int32_t ResourceArchive::Find(std::string_view key) const
+{
+    const auto hash = Hash(key);
+    const auto mask = header_->tableSize - 1;
+    for (auto slot = static_cast<uint32_t>(hash) & mask;; slot = (slot + 1) & mask)
+    {
+        // the table is never full, so a free slot always ends the probe
+        const auto index = table_[slot];
+        if (index == 0)
+            return -1;
+        const auto &entry = entries_[index - 1];
+        if (entry.hash == hash && GetName(entry) == key)
+            return hidden_[index - 1] ? -1 : static_cast<int32_t>(index - 1);
+    }
+}
+
+void ResourceArchive::Hide(int32_t entry)
+{
+    hidden_[entry] = true;
+}
+
+std::vector<std::string> ResourceArchive::GetRootFolders() const
+{
+    std::vector<std::string> folders;
+    for (uint32_t i = 0; i < header_->numEntries; i++)
+    {
+        const auto name = GetName(entries_[i]);
+        const auto separator = name.find('/');
+        if (separator == std::string_view::npos)
+            continue;
+        const auto folder = name.substr(0, separator);
+        if (std::ranges::find(folders, folder) == folders.end())
+            folders.emplace_back(folder);
+    }
+    return folders;
+}
+
+std::vector<std::string_view> ResourceArchive::GetFiles(std::string_view folder, bool recursive) const
+{
+    std::vector<std::string_view> files;
+    for (uint32_t i = 0; i < header_->numEntries; i++)
+    {
+        auto name = GetName(entries_[i]);
+        if (hidden_[i])
+            continue;
+        if (!folder.empty())
+        {
+            if (name.size() <= folder.size() || !name.starts_with(folder) || name[folder.size()] != '/')
+                continue;
+        }
+        const auto relative = folder.empty() ? name : name.substr(folder.size() + 1);
+        if (recursive || relative.find('/') == std::string_view::npos)
+            files.push_back(name);
+    }
+    return files;
+}
+
+uint64_t ResourceArchive::GetSize(int32_t entry) const
+{
+    return entries_[entry].size;
+}
+
+const std::filesystem::path &ResourceArchive::GetPath() const
+{
+    return path_;
+}
+
+MappedFile ResourceArchive::Map(int32_t entry) const
+{
+    const auto &info = entries_[entry];
+    const auto *data = file_->Data() + info.offset;
+    if (info.compression == PAK::COMPRESSION_NONE)
+        return {file_, data, static_cast<size_t>(info.size)};
+
+    std::shared_ptr<char[]> buffer(new char[info.size]);
+    if (!Unpack(info, data, buffer.get()))
+        return {};
+    const auto *unpacked = buffer.get();
+    return {std::move(buffer), unpacked, static_cast<size_t>(info.size)};
+}
+
+bool ResourceArchive::Read(int32_t entry, char *dst) const
+{
+    const auto &info = entries_[entry];
+    return Unpack(info, file_->Data() + info.offset, dst);
+}
+
+std::string_view ResourceArchive::GetName(const PAK::ENTRY &entry) const
+{
+    return {names_ + entry.nameOffset, entry.nameSize};
+}
@@ -0,0 +1,63 @@
+// Packs resource folders into an archive the engine mounts over the loose files:
+// resource_packer -o RESOURCE/base.pak RESOURCE/models RESOURCE/textures
+// run from the game folder, entries are named by their path relative to it
+
+#include "resource_archive.h"
+
+#include <CLI/CLI.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+namespace
+{
+// Folders still read through FILE_SERVICE::_CreateFile, which does not see archives
+constexpr std::string_view kLooseOnlyFolders[] = {"program", "resource/ini", "resource/foam"};
+
+// normalized path is the folder or below it
+bool IsWithin(std::string_view path, std::string_view folder)
+{
+    return folder.empty() || path == folder || (path.starts_with(folder) && path[folder.size()] == '/');
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    CLI::App app("Storm resource packer");
+
+    std::filesystem::path out;
+    std::filesystem::path root = ".";
+    std::vector<std::filesystem::path> dirs;
+    int level = 6;
+    app.add_option("-o,--output", out, "Archive to write")->required();
+    app.add_option("-r,--root", root, "Game folder the entry names are relative to");
+    app.add_option("-l,--level", level, "zlib level, 0 stores the files unpacked")->check(CLI::Range(0, 9));
+    app.add_option("dirs", dirs, "Folders to pack, relative to the game folder")->required();
+
+    try
+    {
+        app.parse(argc, argv);
+    }
+    catch (const CLI::ParseError &e)
+    {
+        return app.exit(e);
+    }
+
+    std::string key;
+    for (const auto &dir : dirs)
+    {
+        ResourceArchive::NormalizePath(dir.generic_string(), key);
+        for (const auto folder : kLooseOnlyFolders)
+        {
+            if (IsWithin(key, folder) || IsWithin(folder, key))
+            {
+                std::cerr << "Can't pack " << dir.string() << ": the engine reads " << folder
+                          << " as loose files only\n";
+                return EXIT_FAILURE;
+            }
+        }
+    }
+
+    return ResourceArchive::Pack(root, dirs, out, level) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
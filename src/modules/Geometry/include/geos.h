@@ -10,8 +10,9 @@ Import library main header
 
 #pragma once
 
+#include "mapped_file.h"
+
 #include <cstdint>
-#include <fstream>
 
 class GEOS
 {
@@ -245,6 +246,8 @@ class GEOS
 
     // Trace a ray in local coord-system
     virtual float Trace(VERTEX &src, VERTEX &dst) = 0;
+    // Same, but keeps no state: safe to call from several threads, hit triangle is returned in face
+    virtual float Trace(const VERTEX &src, const VERTEX &dst, int32_t &face) const = 0;
 
     // clip in local coord-system
     using ADD_POLYGON_FUNC = bool (*)(const VERTEX *v, int32_t nv);
@@ -279,10 +282,8 @@ class GEOM_SERVICE
 {
   public:
     virtual ~GEOM_SERVICE(){};
-    virtual std::fstream OpenFile(const char *fname) = 0;
-    virtual bool ReadFile(std::fstream &fileS, void *data, int32_t bytes) = 0;
-    virtual int FileSize(const char *fname) = 0;
-    virtual void CloseFile(std::fstream &fileS) = 0;
+    // whole file, loose or from an archive
+    virtual MappedFile MapFile(const char *fname) = 0;
     virtual void *malloc(int32_t bytes) = 0;
     virtual void free(void *ptr) = 0;
 
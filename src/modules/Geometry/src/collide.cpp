@@ -13,8 +13,6 @@ trace and clip functions
 //---------------------------------------------------------------------------
 // Trace main procedure
 //---------------------------------------------------------------------------
-SAVAGE GEOM::_stack[256];
-
 float GEOM::Trace(VERTEX &start, VERTEX &finish)
 {
     if (!(rhead.flags & FLAGS_BSP_PRESENT))
@@ -22,19 +20,35 @@ float GEOM::Trace(VERTEX &start, VERTEX &finish)
     src = DVECTOR(start.x, start.y, start.z);
     dst = DVECTOR(finish.x, finish.y, finish.z);
 
+    res_dist = TraceBSP(src, dst, traceid);
+    return res_dist;
+}
+
+float GEOM::Trace(const VERTEX &start, const VERTEX &finish, int32_t &face) const
+{
+    face = -1;
+    if (!(rhead.flags & FLAGS_BSP_PRESENT))
+        return 2.0f;
+    return TraceBSP(DVECTOR(start.x, start.y, start.z), DVECTOR(finish.x, finish.y, finish.z), face);
+}
+
+// re-entrant: the traversal stack lives on the caller's stack and no members are written
+float GEOM::TraceBSP(const DVECTOR &src, const DVECTOR &dst, int32_t &traceid) const
+{
+    SAVAGE savage[256];
     double diss, dise, ssrc, sdst, dist;
     DVECTOR dirvec, tp, V, AV;
-    BSP_NODE *second;
-    BSP_NODE *node;
+    const BSP_NODE *second;
+    const BSP_NODE *node;
     SAVAGE *stack;
-    unsigned char *pface;
+    const unsigned char *pface;
     unsigned char t;
 
     diss = 0.0;
     dise = 1.0;
     dirvec = dst - src;
     node = sroot.data();
-    stack = _stack - 1;
+    stack = savage - 1;
 
 rec_loop:;
 
@@ -123,7 +137,7 @@ rec_return:;
     if (node->nfaces > 0)
     {
         t = node->nfaces;
-        pface = (unsigned char *)&node->face;
+        pface = (const unsigned char *)&node->face;
 
     loop0:
         const auto face = (static_cast<int32_t>(*(pface + 2)) << 16) | (static_cast<int32_t>(*(pface + 1)) << 8) |
@@ -148,16 +162,14 @@ rec_return:;
         {
             if (U < 0.0f && U > det && V < 0.0f && U + V > det)
             {
-                res_dist = static_cast<float>(dist);
                 traceid = face;
-                return res_dist;
+                return static_cast<float>(dist);
             }
         }
         else if (U >= 0.0f && U <= det && V >= 0.0f && U + V <= det)
         {
-            res_dist = static_cast<float>(dist);
             traceid = face;
-            return res_dist;
+            return static_cast<float>(dist);
         }
 
         if (--t > 0)
@@ -171,7 +183,7 @@ rec_return:;
     if (second == nullptr)
     {
     rec_avoid:;
-        if (stack < _stack)
+        if (stack < savage)
         {
             traceid = -1;
             return 2.0f;
@@ -306,7 +318,7 @@ rec_loop:;
     // trace all faces
     if (ssrc * ssrc < radius * radius)
     {
-        auto *pface = (unsigned char *)&node->face;
+        auto *pface = (const unsigned char *)&node->face;
         for (uint32_t f = 0; f < node->nfaces; f++)
         {
             const int32_t face = (static_cast<int32_t>(*(pface + 2)) << 16) | (static_cast<int32_t>(*(pface + 1)) << 8) |
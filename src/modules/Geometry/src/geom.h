@@ -19,12 +19,11 @@ Import library class
 struct SAVAGE
 {
     double dist, dise;
-    BSP_NODE *node, *second;
+    const BSP_NODE *node, *second;
 };
 
 class GEOM : public GEOS
 {
-    static SAVAGE _stack[256];
     std::vector<CVECTOR> vrt{};
     std::vector<RDF_BSPTRIANGLE> btrg{};
     std::vector<BSP_NODE> sroot{};
@@ -60,6 +59,8 @@ class GEOM : public GEOS
     int32_t traceid;
     DVECTOR src, dst;
 
+    float TraceBSP(const DVECTOR &src, const DVECTOR &dst, int32_t &traceid) const;
+
   public:
     GEOM(const char *fname, const char *lightname, GEOM_SERVICE &srv, int32_t flags);
     virtual ~GEOM();
@@ -90,6 +91,7 @@ class GEOM : public GEOS
     virtual void Draw(const PLANE *pl, int32_t np, MATERIAL_FUNC mtf) const;
 
     virtual float Trace(VERTEX &src, VERTEX &dst);
+    virtual float Trace(const VERTEX &src, const VERTEX &dst, int32_t &face) const;
     virtual bool Clip(const PLANE *planes, int32_t nplanes, const VERTEX &center, float radius, ADD_POLYGON_FUNC addpoly);
     virtual bool GetCollisionDetails(TRACE_INFO &ti) const;
 
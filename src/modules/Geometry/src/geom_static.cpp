@@ -26,20 +26,39 @@ std::vector<uint32_t> getColData(GEOM_SERVICE &srv, const std::string_view &file
 {
     std::vector<uint32_t> result;
 
-    auto ltfl = srv.OpenFile(file_name.data());
-    if (ltfl.is_open())
+    const auto ltfl = srv.MapFile(file_name.data());
+    if (ltfl.IsOpen())
     {
-        const auto file_size = srv.FileSize(file_name.data());
-        if (file_size > 0)
-        {
-            result.resize(file_size / sizeof(uint32_t));
-            srv.ReadFile(ltfl, result.data(), file_size);
-        }
+        result.resize(ltfl.Size() / sizeof(uint32_t));
+        memcpy(result.data(), ltfl.Data(), result.size() * sizeof(uint32_t));
     }
-    srv.CloseFile(ltfl);
 
     return result;
 }
+
+// reads the sections of a geometry file one after another
+class GeomReader final
+{
+  public:
+    explicit GeomReader(const MappedFile &file) : view_(file.View())
+    {
+    }
+
+    void Read(void *data, size_t bytes)
+    {
+        if (bytes == 0)
+            return;
+        const auto src = view_.Sub(pos_, bytes);
+        if (src.Empty())
+            throw std::runtime_error("unexpected end of geometry file");
+        memcpy(data, src.Data(), bytes);
+        pos_ += bytes;
+    }
+
+  private:
+    FileView view_;
+    size_t pos_{};
+};
 } // namespace
 
 // create geometry func
@@ -57,32 +76,33 @@ GEOM::GEOM(const char *fname, const char *lightname, GEOM_SERVICE &_srv, int32_t
         colData = getColData(srv, lightname);
     }
 
-    auto file = srv.OpenFile(fname);
+    const auto file = srv.MapFile(fname);
+    GeomReader reader(file);
     // read header
-    srv.ReadFile(file, &rhead, sizeof(RDF_HEAD));
+    reader.Read(&rhead, sizeof(RDF_HEAD));
     if (rhead.version != RDF_VERSION)
         throw std::runtime_error("invalid version");
 
     // read names
     globname = static_cast<char *>(srv.malloc(rhead.name_size));
-    srv.ReadFile(file, globname, rhead.name_size);
+    reader.Read(globname, rhead.name_size);
 
     names = static_cast<int32_t *>(srv.malloc(rhead.names * sizeof(int32_t)));
-    srv.ReadFile(file, names, rhead.names * sizeof(int32_t));
+    reader.Read(names, rhead.names * sizeof(int32_t));
 
     // load textures
     tname = static_cast<int32_t *>(srv.malloc(rhead.ntextures * sizeof(int32_t)));
     tlookup = static_cast<int32_t *>(srv.malloc(rhead.ntextures * sizeof(int32_t)));
-    srv.ReadFile(file, tname, rhead.ntextures * sizeof(int32_t));
+    reader.Read(tname, rhead.ntextures * sizeof(int32_t));
 
     // read materials
     auto *rmat = static_cast<RDF_MATERIAL *>(srv.malloc(sizeof(RDF_MATERIAL) * rhead.nmaterials));
-    srv.ReadFile(file, rmat, sizeof(RDF_MATERIAL) * rhead.nmaterials);
+    reader.Read(rmat, sizeof(RDF_MATERIAL) * rhead.nmaterials);
     material = static_cast<MATERIAL *>(srv.malloc(sizeof(MATERIAL) * rhead.nmaterials));
 
     // read lights
     auto *rlig = static_cast<RDF_LIGHT *>(srv.malloc(sizeof(RDF_LIGHT) * rhead.nlights));
-    srv.ReadFile(file, rlig, sizeof(RDF_LIGHT) * rhead.nlights);
+    reader.Read(rlig, sizeof(RDF_LIGHT) * rhead.nlights);
     light = static_cast<LIGHT *>(srv.malloc(sizeof(LIGHT) * rhead.nlights));
     for (int32_t l = 0; l < rhead.nlights; l++)
     {
@@ -112,7 +132,7 @@ GEOM::GEOM(const char *fname, const char *lightname, GEOM_SERVICE &_srv, int32_t
 
     // read labels
     auto *lab = static_cast<RDF_LABEL *>(srv.malloc(sizeof(RDF_LABEL) * rhead.nlabels));
-    srv.ReadFile(file, lab, sizeof(RDF_LABEL) * rhead.nlabels);
+    reader.Read(lab, sizeof(RDF_LABEL) * rhead.nlabels);
     label = static_cast<LABEL *>(srv.malloc(sizeof(LABEL) * rhead.nlabels));
     for (int32_t lb = 0; lb < rhead.nlabels; lb++)
     {
@@ -128,7 +148,7 @@ GEOM::GEOM(const char *fname, const char *lightname, GEOM_SERVICE &_srv, int32_t
     // read objects
     auto *obj = static_cast<RDF_OBJECT *>(srv.malloc(sizeof(RDF_OBJECT) * rhead.nobjects));
     atriangles = static_cast<int32_t *>(srv.malloc(sizeof(int32_t) * rhead.nobjects));
-    srv.ReadFile(file, obj, sizeof(RDF_OBJECT) * rhead.nobjects);
+    reader.Read(obj, sizeof(RDF_OBJECT) * rhead.nobjects);
     object = static_cast<OBJECT *>(srv.malloc(sizeof(OBJECT) * rhead.nobjects));
     for (int32_t o = 0; o < rhead.nobjects; o++)
     {
@@ -152,13 +172,13 @@ GEOM::GEOM(const char *fname, const char *lightname, GEOM_SERVICE &_srv, int32_t
     // read triangles
     idx_buff = srv.CreateIndexBuffer(rhead.ntriangles * sizeof(RDF_TRIANGLE));
     auto *trg = static_cast<RDF_TRIANGLE *>(srv.LockIndexBuffer(idx_buff));
-    srv.ReadFile(file, trg, sizeof(RDF_TRIANGLE) * rhead.ntriangles);
+    reader.Read(trg, sizeof(RDF_TRIANGLE) * rhead.ntriangles);
     srv.UnlockIndexBuffer(idx_buff);
 
     auto nvertices = 0;
     // read vertex buffers
     auto *rvb = static_cast<RDF_VERTEXBUFF *>(srv.malloc(rhead.nvrtbuffs * sizeof(RDF_VERTEXBUFF)));
-    srv.ReadFile(file, rvb, rhead.nvrtbuffs * sizeof(RDF_VERTEXBUFF));
+    reader.Read(rvb, rhead.nvrtbuffs * sizeof(RDF_VERTEXBUFF));
     vbuff = static_cast<VERTEX_BUFFER *>(srv.malloc(rhead.nvrtbuffs * sizeof(VERTEX_BUFFER)));
     int32_t v;
     for (v = 0; v < rhead.nvrtbuffs; v++)
@@ -176,7 +196,7 @@ GEOM::GEOM(const char *fname, const char *lightname, GEOM_SERVICE &_srv, int32_t
     for (v = 0; v < rhead.nvrtbuffs; v++)
     {
         auto *vrt = static_cast<RDF_VERTEX0 *>(srv.LockVertexBuffer(vbuff[v].dev_buff));
-        srv.ReadFile(file, vrt, vbuff[v].size);
+        reader.Read(vrt, vbuff[v].size);
         for (int32_t vr = 0; vr < vbuff[v].nverts; vr++)
         {
             auto *prv = (RDF_VERTEX0 *)((uint8_t *)(vrt) + vbuff[v].stride * vr);
@@ -195,16 +215,16 @@ GEOM::GEOM(const char *fname, const char *lightname, GEOM_SERVICE &_srv, int32_t
     if (rhead.flags & FLAGS_BSP_PRESENT)
     {
         RDF_BSPHEAD bhead;
-        srv.ReadFile(file, &bhead, sizeof(RDF_BSPHEAD));
+        reader.Read(&bhead, sizeof(RDF_BSPHEAD));
 
         sroot = std::vector<BSP_NODE>(bhead.nnodes);
-        srv.ReadFile(file, sroot.data(), sroot.size() * sizeof(BSP_NODE));
+        reader.Read(sroot.data(), sroot.size() * sizeof(BSP_NODE));
 
         vrt = std::vector<CVECTOR>(bhead.nvertices);
-        srv.ReadFile(file, vrt.data(), vrt.size() * sizeof(RDF_BSPVERTEX));
+        reader.Read(vrt.data(), vrt.size() * sizeof(RDF_BSPVERTEX));
 
         btrg = std::vector<RDF_BSPTRIANGLE>(bhead.ntriangles);
-        srv.ReadFile(file, btrg.data(), btrg.size() * sizeof(RDF_BSPTRIANGLE));
+        reader.Read(btrg.data(), btrg.size() * sizeof(RDF_BSPTRIANGLE));
 
         if constexpr (storm::kValidateCollisionData)  {
             const bool valid = std::all_of(std::begin(btrg), std::end(btrg), [this](const auto &triangle) {
@@ -218,8 +238,6 @@ GEOM::GEOM(const char *fname, const char *lightname, GEOM_SERVICE &_srv, int32_t
         }
     }
 
-    srv.CloseFile(file);
-
     for (int32_t t = 0; t < rhead.ntextures; t++)
         tlookup[t] = srv.CreateTexture(&globname[tname[t]]);
     for (int32_t m = 0; m < rhead.nmaterials; m++)
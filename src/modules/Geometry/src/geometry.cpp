@@ -185,14 +185,14 @@ void GEOM_SERVICE_R::SetRenderService(VDX9RENDER *render_service)
         RenderService->CreateVertexDeclaration(VertexElements, &vertexDecl_);
 }
 
-std::fstream GEOM_SERVICE_R::OpenFile(const char *fname)
+MappedFile GEOM_SERVICE_R::MapFile(const char *fname)
 {
     if (RenderService)
     {
         RenderService->ProgressView();
     }
-    auto fileS = fio->_CreateFile(fname, std::ios::binary | std::ios::in);
-    if (!fileS.is_open())
+    auto file = fio->_MapFile(fname);
+    if (!file.IsOpen())
     {
         if (storm::iEquals(&fname[strlen(fname) - 4], ".col"))
         {
@@ -204,22 +204,7 @@ std::fstream GEOM_SERVICE_R::OpenFile(const char *fname)
         }
     }
 
-    return fileS;
-}
-
-int GEOM_SERVICE_R::FileSize(const char *fname)
-{
-    return fio->_GetFileSize(fname);
-}
-
-bool GEOM_SERVICE_R::ReadFile(std::fstream &fileS, void *data, int32_t bytes)
-{
-    return fio->_ReadFile(fileS, data, bytes);
-}
-
-void GEOM_SERVICE_R::CloseFile(std::fstream &fileS)
-{
-    fio->_CloseFile(fileS);
+    return file;
 }
 
 void *GEOM_SERVICE_R::malloc(int32_t bytes)
@@ -235,7 +220,8 @@ void GEOM_SERVICE_R::free(void *ptr)
 GEOS::ID GEOM_SERVICE_R::CreateTexture(const char *fname)
 {
     char tex[256];
-    if (storm::iEquals(fname, "shadow.tga"))
+    const bool isLighting = storm::iEquals(fname, "shadow.tga");
+    if (isLighting)
     {
         sprintf_s(tex, "lighting\\%s\\%s", lightPath, fname);
     }
@@ -247,7 +233,8 @@ GEOS::ID GEOM_SERVICE_R::CreateTexture(const char *fname)
     if (RenderService)
     {
         RenderService->ProgressView();
-        return RenderService->TextureCreate(tex);
+        // model textures may show up a few frames later, lighting is needed right away
+        return isLighting ? RenderService->TextureCreate(tex) : RenderService->TextureCreateAsync(tex);
     }
     return INVALID_TEXTURE_ID;
 }
@@ -41,10 +41,7 @@ class GEOM_SERVICE_R final : public GEOM_SERVICE
   public:
     void SetRenderService(VDX9RENDER *render_service);
 
-    std::fstream OpenFile(const char *fname);
-    int FileSize(const char *fname);
-    bool ReadFile(std::fstream &fileS, void *data, int32_t bytes);
-    void CloseFile(std::fstream &fileS);
+    MappedFile MapFile(const char *fname);
     void *malloc(int32_t bytes);
     void free(void *ptr);
 
@@ -13,6 +13,8 @@
 #include "entity.h"
 #include "core.h"
 
+#include <utility>
+
 #ifdef _WIN32
 #include <corecrt_io.h>
 #else
@@ -24,7 +26,7 @@
 // ============================================================================================
 
 LGeometry::LGeometry()
-    : min(), max(), useColor(false)
+    : min(), max(), useColor(false), isTraceThreadSafe(false)
 {
     numObjects = 0;
     maxObjects = 0;
@@ -368,6 +370,10 @@ bool LGeometry::Process(VDX9RENDER *rs, int32_t numLights)
         }
     }
     radius = sqrtf(~(max - min));
+    // skinned models are traced through their animation and have to stay on one thread
+    isTraceThreadSafe = true;
+    for (int32_t i = 0; i < numObjects; i++)
+        isTraceThreadSafe &= object[i].m->IsTraceThreadSafe();
     return true;
 }
 
@@ -448,6 +454,18 @@ float LGeometry::Trace(const CVECTOR &src, const CVECTOR &dst)
     return 2.0f;
 }
 
+// Trace the ray from any thread
+float LGeometry::TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const
+{
+    for (int32_t i = 0; i < numObjects; i++)
+    {
+        const float res = std::as_const(*object[i].m).TraceThreadSafe(src, dst);
+        if (res <= 1.0f)
+            return res;
+    }
+    return 2.0f;
+}
+
 // Save lighting
 bool LGeometry::Save()
 {
@@ -54,6 +54,8 @@ class LGeometry
     void UpdateColors(VDX9RENDER *rs);
     // Trace the ray through all models
     float Trace(const CVECTOR &src, const CVECTOR &dst);
+    // Trace the ray through all models from any thread, only when isTraceThreadSafe is set
+    float TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const;
     // Save lighting
     bool Save();
 
@@ -79,6 +81,8 @@ class LGeometry
     float radius;
 
     bool useColor;
+    // All the models can be traced from several threads at once
+    bool isTraceThreadSafe;
 
     CVECTOR *drawbuf;
 
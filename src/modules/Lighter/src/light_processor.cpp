@@ -10,9 +10,40 @@
 
 #include "light_processor.h"
 
+#include "core.h"
+
+#include <algorithm>
+#include <chrono>
+#include <execution>
+
 #define LIGHTPRC_TRACE_NUM 1000
 #define LIGHTPRC_SMOOTH_NUM 1000
 #define LIGHTPRC_BLUR_NUM 500
+// Work of one thread task
+#define LIGHTPRC_TRACE_BLOCK 64
+#define LIGHTPRC_VERTEX_BLOCK 256
+// Triangles traced before their shading is added to the vertices, bounds the memory of a bake
+#define LIGHTPRC_BAKE_TRACE_NUM 65536
+
+namespace
+{
+
+// Call func(first, last) for the blocks of [0, num) on all cores
+template <class Func> void ParallelBlocks(int32_t num, int32_t block, Func func)
+{
+    std::vector<int32_t> starts;
+    for (int32_t i = 0; i < num; i += block)
+        starts.push_back(i);
+    std::for_each(std::execution::par, starts.begin(), starts.end(),
+                  [&](int32_t first) { func(first, std::min(first + block, num)); });
+}
+
+float Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
 
 // ============================================================================================
 // Construction, destruction
@@ -54,25 +85,7 @@ void LightProcessor::Process()
             shadowTriangle = -1;
         if (shadowTriangle == -1)
         {
-            // Normalizing the result
-            auto *const vrt = geometry->vrt.data();
-            const auto numVrt = geometry->numVrt;
-            const auto numLights = lights->Num();
-            for (int32_t i = 0; i < numVrt; i++)
-            {
-                for (int32_t j = 0; j < numLights; j++)
-                {
-                    if (vrt[i].shadow[j].nrm > 0.0)
-                    {
-                        vrt[i].shadow[j].v /= vrt[i].shadow[j].nrm;
-                    }
-                    else
-                    {
-                        vrt[i].shadow[j].v = 1.0;
-                    }
-                    vrt[i].shadow[j].sm = vrt[i].shadow[j].v;
-                }
-            }
+            NormalizeShadows();
             // indicate that finished
             window->isLockCtrl = false;
             window->tracePrc = 1.0f;
@@ -119,19 +132,7 @@ void LightProcessor::Process()
         window->isTraceShadows = false;
         window->isLockCtrl = true;
         window->tracePrc = 0.0f;
-        // Resetting the color state
-        auto *const vrt = geometry->vrt.data();
-        const auto numVrt = geometry->numVrt;
-        const auto numLights = lights->Num();
-        for (int32_t i = 0; i < numVrt; i++)
-        {
-            for (int32_t j = 0; j < numLights; j++)
-            {
-                vrt[i].shadow[j].v = 0.0f;
-                vrt[i].shadow[j].nrm = 0.0f;
-                vrt[i].shadow[j].sm = 0.0f;
-            }
-        }
+        ResetShadows();
     }
     if (window->isSmoothShadows)
     {
@@ -240,47 +241,136 @@ void LightProcessor::UpdateLightsParam()
     }
 }
 
+// Trace, smooth and light everything at once
+void LightProcessor::Bake()
+{
+    // cancel the steps in progress, everything is done here
+    shadowTriangle = -1;
+    smoothVertex = -1;
+    blurVertex = -1;
+    // Shading
+    auto start = std::chrono::steady_clock::now();
+    ResetShadows();
+    for (int32_t i = 0; i < geometry->numTrg; i += LIGHTPRC_BAKE_TRACE_NUM)
+        TraceShadows(i, std::min(i + LIGHTPRC_BAKE_TRACE_NUM, geometry->numTrg));
+    NormalizeShadows();
+    core.Trace("Location lighter: traced %d triangles in %.2f s%s", geometry->numTrg, Seconds(start),
+               geometry->isTraceThreadSafe ? "" : " (skinned models, single thread)");
+    // Smoothing
+    start = std::chrono::steady_clock::now();
+    ParallelBlocks(geometry->numVrt, LIGHTPRC_VERTEX_BLOCK, [this](int32_t first, int32_t last) {
+        std::vector<OctFndVerts> verts;
+        for (auto i = first; i < last; i++)
+            SmoothVertex(geometry->vrt[i], verts);
+    });
+    core.Trace("Location lighter: smoothed %d vertices in %.2f s", geometry->numVrt, Seconds(start));
+    // No blur: BlurVertex stops after looking up the neighbours and leaves the colors as they are
+    // Lighting
+    start = std::chrono::steady_clock::now();
+    CalcLights();
+    core.Trace("Location lighter: lit %d vertices in %.2f s", geometry->numVrt, Seconds(start));
+
+    window->isLockCtrl = false;
+    window->tracePrc = 1.0f;
+    window->smoothPrc = 1.0f;
+    window->blurPrc = 1.0f;
+}
+
+// Reset the shading before tracing
+void LightProcessor::ResetShadows()
+{
+    auto *const vrt = geometry->vrt.data();
+    const auto numVrt = geometry->numVrt;
+    const auto numLights = lights->Num();
+    for (int32_t i = 0; i < numVrt; i++)
+    {
+        for (int32_t j = 0; j < numLights; j++)
+        {
+            vrt[i].shadow[j].v = 0.0f;
+            vrt[i].shadow[j].nrm = 0.0f;
+            vrt[i].shadow[j].sm = 0.0f;
+        }
+    }
+}
+
+// Normalize the traced shading
+void LightProcessor::NormalizeShadows()
+{
+    auto *const vrt = geometry->vrt.data();
+    const auto numVrt = geometry->numVrt;
+    const auto numLights = lights->Num();
+    for (int32_t i = 0; i < numVrt; i++)
+    {
+        for (int32_t j = 0; j < numLights; j++)
+        {
+            if (vrt[i].shadow[j].nrm > 0.0)
+            {
+                vrt[i].shadow[j].v /= vrt[i].shadow[j].nrm;
+            }
+            else
+            {
+                vrt[i].shadow[j].v = 1.0;
+            }
+            vrt[i].shadow[j].sm = vrt[i].shadow[j].v;
+        }
+    }
+}
+
 // Calculate shading
 void LightProcessor::CalcShadows()
 {
     // Calculating shading
-    for (int32_t i = 0; i < LIGHTPRC_TRACE_NUM && shadowTriangle < geometry->numTrg; i++, shadowTriangle++)
-        ApplyTriangleShadows(geometry->trg[shadowTriangle]);
+    const auto last = std::min(shadowTriangle + LIGHTPRC_TRACE_NUM, geometry->numTrg);
+    TraceShadows(shadowTriangle, last);
+    shadowTriangle = last;
     if (shadowTriangle == geometry->numTrg)
         shadowTriangle = -1;
 }
 
-// Distribute shading from triangle to vertices
-void LightProcessor::ApplyTriangleShadows(Triangle &t)
+// Trace triangles and distribute their shading to vertices
+void LightProcessor::TraceShadows(int32_t first, int32_t last)
+{
+    const auto num = lights->Num();
+    trgShadows.resize(static_cast<size_t>(last - first) * num);
+    auto *const shw = trgShadows.data();
+    const auto trace = [this, first, num, shw](int32_t from, int32_t to) {
+        for (auto i = from; i < to; i++)
+            CalcTriangleShadows(geometry->trg[first + i], shw + static_cast<size_t>(i) * num);
+    };
+    if (geometry->isTraceThreadSafe)
+        ParallelBlocks(last - first, LIGHTPRC_TRACE_BLOCK, trace);
+    else
+        trace(0, last - first);
+    // the vertex sums are built in the triangle order, as if traced one by one
+    for (auto i = first; i < last; i++)
+        ApplyTriangleShadows(geometry->trg[i], shw + static_cast<size_t>(i - first) * num);
+}
+
+// Shading of the triangle from every source
+void LightProcessor::CalcTriangleShadows(const Triangle &t, float *shw) const
 {
     auto &ls = *lights;
     const auto num = ls.Num();
-    auto *const vrt = geometry->vrt.data();
+    const auto *const vrt = geometry->vrt.data();
+    // Point from where to trace
+    auto pnt = (vrt[t.i[0]].p + vrt[t.i[1]].p + vrt[t.i[2]].p) / 3.0f;
+    pnt += t.n * 0.001f;
     for (int32_t i = 0; i < num; i++)
     {
-        // need to trace?
-        if (ls[i].type == Light::t_none || ls[i].type == Light::t_amb)
-            continue;
-        // Standardization coefficient
-        vrt[t.i[0]].shadow[i].nrm += t.sq;
-        vrt[t.i[1]].shadow[i].nrm += t.sq;
-        vrt[t.i[2]].shadow[i].nrm += t.sq;
-        // Point from where to trace
-        auto pnt = (vrt[t.i[0]].p + vrt[t.i[1]].p + vrt[t.i[2]].p) / 3.0f;
-        pnt += t.n * 0.001f;
+        shw[i] = 0.0f;
         // Determining shading
         switch (ls[i].type)
         {
+        case Light::t_none:
+        case Light::t_amb:
+            // need not to trace
+            break;
         case Light::t_sun:
             // Sun lighting
             if ((ls[i].p | t.n) >= 0.0f)
             {
-                if (geometry->Trace(pnt, pnt + ls[i].p * geometry->radius) > 1.0f)
-                {
-                    vrt[t.i[0]].shadow[i].v += t.sq;
-                    vrt[t.i[1]].shadow[i].v += t.sq;
-                    vrt[t.i[2]].shadow[i].v += t.sq;
-                }
+                if (Trace(pnt, pnt + ls[i].p * geometry->radius) > 1.0f)
+                    shw[i] = t.sq;
             }
             break;
         case Light::t_sky:
@@ -290,119 +380,135 @@ void LightProcessor::ApplyTriangleShadows(Triangle &t)
                 float sky = 0.0;
                 const auto rad = geometry->radius;
                 const auto rdx = geometry->radius * 0.2f;
-                if (geometry->Trace(pnt, pnt + CVECTOR(0.0f, rad, 0.0f)) > 1.0f)
+                if (Trace(pnt, pnt + CVECTOR(0.0f, rad, 0.0f)) > 1.0f)
                     sky += 1.0f / 5.0f;
-                if (geometry->Trace(pnt, pnt + CVECTOR(rdx, rad, 0.0f)) > 1.0f)
+                if (Trace(pnt, pnt + CVECTOR(rdx, rad, 0.0f)) > 1.0f)
                     sky += 1.0f / 5.0f;
-                if (geometry->Trace(pnt, pnt + CVECTOR(-rdx, rad, 0.0f)) > 1.0f)
+                if (Trace(pnt, pnt + CVECTOR(-rdx, rad, 0.0f)) > 1.0f)
                     sky += 1.0f / 5.0f;
-                if (geometry->Trace(pnt, pnt + CVECTOR(0.0f, rad, rdx)) > 1.0f)
+                if (Trace(pnt, pnt + CVECTOR(0.0f, rad, rdx)) > 1.0f)
                     sky += 1.0f / 5.0f;
-                if (geometry->Trace(pnt, pnt + CVECTOR(0.0f, rad, -rdx)) > 1.0f)
+                if (Trace(pnt, pnt + CVECTOR(0.0f, rad, -rdx)) > 1.0f)
                     sky += 1.0f / 5.0f;
-                sky *= t.sq;
-                vrt[t.i[0]].shadow[i].v += sky;
-                vrt[t.i[1]].shadow[i].v += sky;
-                vrt[t.i[2]].shadow[i].v += sky;
+                shw[i] = sky * t.sq;
             }
             break;
         case Light::t_point:
             // Sun lighting
             if (((ls[i].p - pnt) | t.n) >= 0.0f)
             {
-                if (geometry->Trace(pnt, ls[i].p) > 1.0f)
-                {
-                    vrt[t.i[0]].shadow[i].v += t.sq;
-                    vrt[t.i[1]].shadow[i].v += t.sq;
-                    vrt[t.i[2]].shadow[i].v += t.sq;
-                }
+                if (Trace(pnt, ls[i].p) > 1.0f)
+                    shw[i] = t.sq;
             }
             break;
         default:
-            vrt[t.i[0]].shadow[i].v += t.sq;
-            vrt[t.i[1]].shadow[i].v += t.sq;
-            vrt[t.i[2]].shadow[i].v += t.sq;
+            shw[i] = t.sq;
         }
     }
 }
 
+// Distribute shading from triangle to vertices
+void LightProcessor::ApplyTriangleShadows(const Triangle &t, const float *shw)
+{
+    auto &ls = *lights;
+    const auto num = ls.Num();
+    auto *const vrt = geometry->vrt.data();
+    for (int32_t i = 0; i < num; i++)
+    {
+        // need to trace?
+        if (ls[i].type == Light::t_none || ls[i].type == Light::t_amb)
+            continue;
+        // Standardization coefficient
+        vrt[t.i[0]].shadow[i].nrm += t.sq;
+        vrt[t.i[1]].shadow[i].nrm += t.sq;
+        vrt[t.i[2]].shadow[i].nrm += t.sq;
+        vrt[t.i[0]].shadow[i].v += shw[i];
+        vrt[t.i[1]].shadow[i].v += shw[i];
+        vrt[t.i[2]].shadow[i].v += shw[i];
+    }
+}
+
+// Trace through the geometry
+float LightProcessor::Trace(const CVECTOR &src, const CVECTOR &dst) const
+{
+    if (geometry->isTraceThreadSafe)
+        return geometry->TraceThreadSafe(src, dst);
+    return geometry->Trace(src, dst);
+}
+
 // Smooth shading
 void LightProcessor::SmoothShadows()
+{
+    const auto last = std::min(smoothVertex + LIGHTPRC_SMOOTH_NUM, geometry->numVrt);
+    ParallelBlocks(last - smoothVertex, LIGHTPRC_VERTEX_BLOCK, [this](int32_t first, int32_t end) {
+        std::vector<OctFndVerts> verts;
+        for (auto i = first; i < end; i++)
+            SmoothVertex(geometry->vrt[smoothVertex + i], verts);
+    });
+    smoothVertex = last;
+    if (smoothVertex >= geometry->numVrt)
+        smoothVertex = -1;
+}
+
+// Smooth shading of one vertex
+void LightProcessor::SmoothVertex(Vertex &v, std::vector<OctFndVerts> &verts) const
 {
     const auto lookNorm = window->smoothNorm;
     const auto smoothRad = window->smoothRad;
     const auto kSmoothRad = 1.0f / smoothRad;
-    double smoothRad2 = smoothRad * smoothRad;
-    auto &ls = *lights;
-    const auto num = ls.Num();
-    auto &vrt = geometry->vrt;
-    for (int32_t i = 0; i < LIGHTPRC_SMOOTH_NUM && smoothVertex < geometry->numVrt; i++, smoothVertex++)
+    const auto num = lights->Num();
+    // Looking for surrounding vertices
+    octtree->FindVerts(v.p, smoothRad, verts);
+    const auto numVerts = static_cast<int32_t>(verts.size());
+    // go through all the sources
+    for (int32_t n = 0; n < num; n++)
     {
-        auto &v = vrt[smoothVertex];
-        // Looking for surrounding vertices
-        octtree->FindVerts(v.p, smoothRad);
-        auto *const verts = octtree->verts.data();
-        const auto numVerts = octtree->numVerts;
-
-        /*if constexpr (false)
-        {
-          float r2 = smoothRad * smoothRad;
-          static Vertex* ov[16384];
-          int32_t numV = 0;
-          int32_t num = geometry->numVrt;
-          int32_t n;
-          for (n = 0; n < num; n++)
-          {
-            float r = ~(vrt[n].p - v.p);
-            if (r < r2)
-            {
-              Assert(numV < sizeof(ov)/sizeof(OctFndVerts));
-              ov[numV++] = &vrt[n];
-            }
-          }
-          if (numVerts != numV) core.Trace("numVerts(%i) != numV(%i)", numVerts, numV);
-          for (n = 0; n < numVerts; n++)
-          {
-            int32_t k;
-            for (k = 0; k < numV; k++)
-              if (verts[n].v == ov[k]) break;
-            if (k >= numV) core.Trace("k >= numV");
-          }
-        }*/
-        // Assert(numVerts > 0);
-        // go through all the sources
-        for (int32_t n = 0; n < num; n++)
+        // Set to zero
+        auto sm = 0.0;
+        double kNorm = 0.0f;
+        // All the vertices
+        for (int32_t j = 0; j < numVerts; j++)
         {
-            // Set to zero
-            auto sm = 0.0;
-            double kNorm = 0.0f;
-            // All the vertices
-            for (int32_t j = 0; j < numVerts; j++)
-            {
-                if (lookNorm && (v.n | verts[j].v->n) <= 0.6f)
-                    continue;
-                double k = sqrt(verts[j].r2) * kSmoothRad;
-                if (k < 0.0)
-                    k = 0.0;
-                if (k > 1.0)
-                    k = 1.0;
-                k = 1.0 - k;
-                sm += verts[j].v->shadow[n].v * k;
-                kNorm += k;
-            }
-            if (kNorm > 0.0)
-                sm /= kNorm;
-            else
-                sm = v.shadow[n].v;
-            v.shadow[n].sm = sm;
+            if (lookNorm && (v.n | verts[j].v->n) <= 0.6f)
+                continue;
+            double k = sqrt(verts[j].r2) * kSmoothRad;
+            if (k < 0.0)
+                k = 0.0;
+            if (k > 1.0)
+                k = 1.0;
+            k = 1.0 - k;
+            sm += verts[j].v->shadow[n].v * k;
+            kNorm += k;
         }
+        if (kNorm > 0.0)
+            sm /= kNorm;
+        else
+            sm = v.shadow[n].v;
+        v.shadow[n].sm = sm;
     }
-    if (smoothVertex >= geometry->numVrt)
-        smoothVertex = -1;
 }
 
 // Smooth lighting
 void LightProcessor::BlurLight()
+{
+    const auto last = std::min(blurVertex + LIGHTPRC_BLUR_NUM, geometry->numVrt);
+    const auto blur = [this](int32_t first, int32_t end) {
+        std::vector<OctFndVerts> verts;
+        for (auto i = first; i < end; i++)
+            BlurVertex(geometry->vrt[blurVertex + i], verts);
+    };
+    // tracing skinned models has to stay on this thread
+    if (geometry->isTraceThreadSafe || !window->isTraceBlur)
+        ParallelBlocks(last - blurVertex, LIGHTPRC_VERTEX_BLOCK, blur);
+    else
+        blur(0, last - blurVertex);
+    blurVertex = last;
+    if (blurVertex >= geometry->numVrt)
+        blurVertex = -1;
+}
+
+// Smooth lighting of one vertex
+void LightProcessor::BlurVertex(Vertex &v, std::vector<OctFndVerts> &verts) const
 {
     auto isTrace = window->isTraceBlur;
     const auto blurRad = window->blurRad;
@@ -410,85 +516,75 @@ void LightProcessor::BlurLight()
     auto pw = window->blurAtt;
     auto kCos = window->blurCos;
     auto kCos1 = 1.0f - window->blurCos;
-    double blurRad2 = blurRad * blurRad;
-    auto *const vrt = geometry->vrt.data();
-    const auto numVrt = geometry->numVrt;
-    for (int32_t i = 0; i < LIGHTPRC_BLUR_NUM && blurVertex < numVrt; i++, blurVertex++)
-    {
-        auto &v = vrt[blurVertex];
-        // Looking for surrounding vertices
-        octtree->FindVerts(v.p, blurRad);
-        auto *verts = octtree->verts.data();
-        auto numVerts = octtree->numVerts;
+    // Looking for surrounding vertices
+    octtree->FindVerts(v.p, blurRad, verts);
+    auto numVerts = static_cast<int32_t>(verts.size());
 
-        continue;
+    return;
 
-        auto step = (numVerts + 8) >> 4;
-        if (step < 1)
-            step = 1;
+    auto step = (numVerts + 8) >> 4;
+    if (step < 1)
         step = 1;
-        auto r = 0.0, g = 0.0, b = 0.0, sum = 0.0;
-        // All the vertices
-        for (int32_t j = 0; j < numVerts; j += step)
-        {
-            auto &vs = *verts[j].v;
-            if (vs.c.x + vs.c.y + vs.c.z <= 0.0f)
-                continue;
-            auto n = vs.p - v.p;
-            double css = -(n | vs.n);
-            if (css <= 0.0)
-                continue;
-            double csd = n | v.n;
-            if (csd <= 0.0)
-                continue;
-            double dst = sqrt(~n);
-            if (dst <= 0.0)
-                continue;
-            auto k = dst * kBlurRad;
-            dst = 1.0f / dst;
-            n *= static_cast<float>(dst * 0.001);
-            if (isTrace && geometry->Trace(v.p + n, vs.p - n) <= 1.0f)
-                continue;
-            css *= dst;
-            csd *= dst;
-            if (css > 1.0)
-                css = 1.0;
-            if (csd > 1.0)
-                csd = 1.0;
-            if (k <= 0.0)
-                continue;
-            if (k > 1.0)
-                k = 1.0;
-            k = powf(1.0f - k, pw) * (css * csd * kCos + kCos1);
-            r += vs.c.x * k;
-            g += vs.c.y * k;
-            b += vs.c.z * k;
-            sum += 1.0f;
-        }
-        if (sum > 0.0)
-        {
-            sum = 1.0 / sum;
-            r *= sum;
-            g *= sum;
-            b *= sum;
-        }
-        auto max = r > g ? r : g;
-        if (max < b)
-            max = b;
-        max = 1.0;
-        if (max > 0.0)
-        {
-            max = 1.0 / max;
-            r *= max;
-            g *= max;
-            b *= max;
-        }
-        v.bc.x = static_cast<float>(r);
-        v.bc.y = static_cast<float>(g);
-        v.bc.z = static_cast<float>(b);
+    step = 1;
+    auto r = 0.0, g = 0.0, b = 0.0, sum = 0.0;
+    // All the vertices
+    for (int32_t j = 0; j < numVerts; j += step)
+    {
+        auto &vs = *verts[j].v;
+        if (vs.c.x + vs.c.y + vs.c.z <= 0.0f)
+            continue;
+        auto n = vs.p - v.p;
+        double css = -(n | vs.n);
+        if (css <= 0.0)
+            continue;
+        double csd = n | v.n;
+        if (csd <= 0.0)
+            continue;
+        double dst = sqrt(~n);
+        if (dst <= 0.0)
+            continue;
+        auto k = dst * kBlurRad;
+        dst = 1.0f / dst;
+        n *= static_cast<float>(dst * 0.001);
+        if (isTrace && Trace(v.p + n, vs.p - n) <= 1.0f)
+            continue;
+        css *= dst;
+        csd *= dst;
+        if (css > 1.0)
+            css = 1.0;
+        if (csd > 1.0)
+            csd = 1.0;
+        if (k <= 0.0)
+            continue;
+        if (k > 1.0)
+            k = 1.0;
+        k = powf(1.0f - k, pw) * (css * csd * kCos + kCos1);
+        r += vs.c.x * k;
+        g += vs.c.y * k;
+        b += vs.c.z * k;
+        sum += 1.0f;
     }
-    if (blurVertex >= geometry->numVrt)
-        blurVertex = -1;
+    if (sum > 0.0)
+    {
+        sum = 1.0 / sum;
+        r *= sum;
+        g *= sum;
+        b *= sum;
+    }
+    auto max = r > g ? r : g;
+    if (max < b)
+        max = b;
+    max = 1.0;
+    if (max > 0.0)
+    {
+        max = 1.0 / max;
+        r *= max;
+        g *= max;
+        b *= max;
+    }
+    v.bc.x = static_cast<float>(r);
+    v.bc.y = static_cast<float>(g);
+    v.bc.z = static_cast<float>(b);
 }
 
 // Calculate lighting
@@ -499,7 +595,6 @@ void LightProcessor::CalcLights(int32_t lit, bool isCos, bool isAtt, bool isSdw)
     const auto num = ls.Num();
     auto *const vrt = geometry->vrt.data();
     const auto kBlur = window->kBlur;
-    CVECTOR c;
     for (int32_t i = 0; i < num; i++)
     {
         if (!ls[i].isOn)
@@ -510,123 +605,126 @@ void LightProcessor::CalcLights(int32_t lit, bool isCos, bool isAtt, bool isSdw)
         ls[i].curgm = 1.0f / ls[i].curgm;
         ls[i].curct = ls[i].contr >= 0.5f ? 1.0f + (ls[i].contr - 0.5f) * 20.0f : 0.05f + ls[i].contr * 2.0f * 0.95f;
     }
-    for (int32_t n = 0; n < geometry->numVrt; n++)
-    {
-        auto &v = vrt[n];
-        if (!v.shadow)
-            continue;
-        c = v.bc * (kBlur * kBlur * 2.0f);
-        float sw;
-        double vl;
-        for (int32_t i = 0; i < num; i++)
+    // every vertex is lit on its own
+    ParallelBlocks(geometry->numVrt, LIGHTPRC_VERTEX_BLOCK, [&](int32_t first, int32_t last) {
+        for (int32_t n = first; n < last; n++)
         {
-            auto &lt = ls[i];
-            if (!lt.isOn)
-                continue;
-            auto &shw = v.shadow[i];
-            if (!lt.isMark)
-            {
-                c += shw.c;
+            auto &v = vrt[n];
+            if (!v.shadow)
                 continue;
-            }
-            switch (lt.type)
+            CVECTOR c = v.bc * (kBlur * kBlur * 2.0f);
+            float sw;
+            double vl;
+            for (int32_t i = 0; i < num; i++)
             {
-            case Light::t_amb:
-                shw.c = lt.color;
-                c += shw.c;
-                break;
-            case Light::t_sun:
-                // Cosine of an angle
-                if (isCos)
-                {
-                    shw.csatt = lt.cosine * shw.cs + (1.0f - lt.cosine);
-                }
-                // Shading coefficient
-                if (isSdw)
-                {
-                    vl = (v.shadow[i].sm - 0.5) * lt.curct + 0.5;
-                    if (vl < 0.0f)
-                        vl = 0.0f;
-                    if (vl > 1.0f)
-                        vl = 1.0f;
-                    sw = static_cast<float>(pow(vl, static_cast<double>(lt.curgm))) + (lt.bright - 0.5f) * 1.8f;
-                    if (sw < 0.0f)
-                        sw = 0.0f;
-                    if (sw > 1.0f)
-                        sw = 1.0f;
-                    shw.shw = lt.shadow * sw + (1.0f - lt.shadow);
-                }
-                // Resulting color
-                shw.c = lt.color * (shw.csatt * shw.shw);
-                c += shw.c;
-                break;
-            case Light::t_sky:
-                // Cosine of an angle
-                if (isCos)
-                {
-                    shw.csatt = lt.cosine * shw.cs + (1.0f - lt.cosine);
-                }
-                // Shading coefficient
-                if (isSdw)
+                auto &lt = ls[i];
+                if (!lt.isOn)
+                    continue;
+                auto &shw = v.shadow[i];
+                if (!lt.isMark)
                 {
-                    vl = (v.shadow[i].sm - 0.5) * lt.curct + 0.5;
-                    if (vl < 0.0f)
-                        vl = 0.0f;
-                    if (vl > 1.0f)
-                        vl = 1.0f;
-                    sw = static_cast<float>(pow(vl, static_cast<double>(lt.curgm))) + (lt.bright - 0.5f) * 1.8f;
-                    if (sw < 0.0f)
-                        sw = 0.0f;
-                    if (sw > 1.0f)
-                        sw = 1.0f;
-                    shw.shw = lt.shadow * sw + (1.0f - lt.shadow);
+                    c += shw.c;
+                    continue;
                 }
-                // Resulting color
-                shw.c = lt.color * (shw.csatt * shw.shw);
-                c += shw.c;
-                break;
-            case Light::t_point:
-                // Attenuation coefficient
-                if (isAtt)
+                switch (lt.type)
                 {
-                    if (shw.dst < lt.range)
+                case Light::t_amb:
+                    shw.c = lt.color;
+                    c += shw.c;
+                    break;
+                case Light::t_sun:
+                    // Cosine of an angle
+                    if (isCos)
+                    {
+                        shw.csatt = lt.cosine * shw.cs + (1.0f - lt.cosine);
+                    }
+                    // Shading coefficient
+                    if (isSdw)
+                    {
+                        vl = (v.shadow[i].sm - 0.5) * lt.curct + 0.5;
+                        if (vl < 0.0f)
+                            vl = 0.0f;
+                        if (vl > 1.0f)
+                            vl = 1.0f;
+                        sw = static_cast<float>(pow(vl, static_cast<double>(lt.curgm))) + (lt.bright - 0.5f) * 1.8f;
+                        if (sw < 0.0f)
+                            sw = 0.0f;
+                        if (sw > 1.0f)
+                            sw = 1.0f;
+                        shw.shw = lt.shadow * sw + (1.0f - lt.shadow);
+                    }
+                    // Resulting color
+                    shw.c = lt.color * (shw.csatt * shw.shw);
+                    c += shw.c;
+                    break;
+                case Light::t_sky:
+                    // Cosine of an angle
+                    if (isCos)
+                    {
+                        shw.csatt = lt.cosine * shw.cs + (1.0f - lt.cosine);
+                    }
+                    // Shading coefficient
+                    if (isSdw)
+                    {
+                        vl = (v.shadow[i].sm - 0.5) * lt.curct + 0.5;
+                        if (vl < 0.0f)
+                            vl = 0.0f;
+                        if (vl > 1.0f)
+                            vl = 1.0f;
+                        sw = static_cast<float>(pow(vl, static_cast<double>(lt.curgm))) + (lt.bright - 0.5f) * 1.8f;
+                        if (sw < 0.0f)
+                            sw = 0.0f;
+                        if (sw > 1.0f)
+                            sw = 1.0f;
+                        shw.shw = lt.shadow * sw + (1.0f - lt.shadow);
+                    }
+                    // Resulting color
+                    shw.c = lt.color * (shw.csatt * shw.shw);
+                    c += shw.c;
+                    break;
+                case Light::t_point:
+                    // Attenuation coefficient
+                    if (isAtt)
                     {
-                        shw.att = lt.att0 + shw.dst * lt.att1 + shw.dst * shw.dst * lt.att2;
-                        if (shw.att > 0.0f)
-                            shw.att = 1.0f / shw.att;
+                        if (shw.dst < lt.range)
+                        {
+                            shw.att = lt.att0 + shw.dst * lt.att1 + shw.dst * shw.dst * lt.att2;
+                            if (shw.att > 0.0f)
+                                shw.att = 1.0f / shw.att;
+                            else
+                                shw.att = 0.0f;
+                        }
                         else
                             shw.att = 0.0f;
                     }
-                    else
-                        shw.att = 0.0f;
-                }
-                // Cosine of an angle
-                if (isCos || isAtt)
-                {
-                    shw.csatt = (lt.cosine * shw.cs + (1.0f - lt.cosine)) * shw.att;
-                }
-                // Shading coefficient
-                if (isSdw)
-                {
-                    vl = (v.shadow[i].sm - 0.5) * lt.curct + 0.5;
-                    if (vl < 0.0f)
-                        vl = 0.0f;
-                    if (vl > 1.0f)
-                        vl = 1.0f;
-                    sw = static_cast<float>(pow(vl, static_cast<double>(lt.curgm))) + (lt.bright - 0.5f) * 1.8f;
-                    if (sw < 0.0f)
-                        sw = 0.0f;
-                    if (sw > 1.0f)
-                        sw = 1.0f;
-                    shw.shw = lt.shadow * sw + (1.0f - lt.shadow);
+                    // Cosine of an angle
+                    if (isCos || isAtt)
+                    {
+                        shw.csatt = (lt.cosine * shw.cs + (1.0f - lt.cosine)) * shw.att;
+                    }
+                    // Shading coefficient
+                    if (isSdw)
+                    {
+                        vl = (v.shadow[i].sm - 0.5) * lt.curct + 0.5;
+                        if (vl < 0.0f)
+                            vl = 0.0f;
+                        if (vl > 1.0f)
+                            vl = 1.0f;
+                        sw = static_cast<float>(pow(vl, static_cast<double>(lt.curgm))) + (lt.bright - 0.5f) * 1.8f;
+                        if (sw < 0.0f)
+                            sw = 0.0f;
+                        if (sw > 1.0f)
+                            sw = 1.0f;
+                        shw.shw = lt.shadow * sw + (1.0f - lt.shadow);
+                    }
+                    // Resulting color
+                    shw.c = lt.color * (shw.csatt * shw.shw);
+                    c += shw.c;
+                    break;
                 }
-                // Resulting color
-                shw.c = lt.color * (shw.csatt * shw.shw);
-                c += shw.c;
-                break;
             }
+            v.c = c;
         }
-        v.c = c;
-    }
+    });
     geometry->UpdateColors(rs);
 }
@@ -15,6 +15,8 @@
 #include "oct_tree.h"
 #include "window.h"
 
+#include <vector>
+
 class VDX9RENDER;
 
 class LightProcessor
@@ -30,6 +32,8 @@ class LightProcessor
 
     // Perform Calculation Step
     void Process();
+    // Trace, smooth and light everything at once on all cores, reporting the time of each phase
+    void Bake();
 
     // --------------------------------------------------------------------------------------------
     // Encapsulation
@@ -43,8 +47,22 @@ class LightProcessor
     void BlurLight();
     // Calculate lighting
     void CalcLights(int32_t lit = -1, bool isCos = true, bool isAtt = true, bool isSdw = true);
+    // Reset the shading before tracing
+    void ResetShadows();
+    // Normalize the traced shading
+    void NormalizeShadows();
+    // Trace triangles [first, last) and distribute their shading to vertices in the triangle order
+    void TraceShadows(int32_t first, int32_t last);
+    // Shading of the triangle from every source, what ApplyTriangleShadows adds to the vertices
+    void CalcTriangleShadows(const Triangle &t, float *shw) const;
     // Distribute shading from triangle to vertices
-    void ApplyTriangleShadows(Triangle &t);
+    void ApplyTriangleShadows(const Triangle &t, const float *shw);
+    // Smooth shading of one vertex
+    void SmoothVertex(Vertex &v, std::vector<OctFndVerts> &verts) const;
+    // Smooth lighting of one vertex
+    void BlurVertex(Vertex &v, std::vector<OctFndVerts> &verts) const;
+    // Trace through the geometry, from the worker threads when the models allow it
+    float Trace(const CVECTOR &src, const CVECTOR &dst) const;
 
   private:
     LGeometry *geometry;
@@ -56,4 +74,7 @@ class LightProcessor
     int32_t shadowTriangle;
     int32_t smoothVertex;
     int32_t blurVertex;
+
+    // Shading of the traced triangles, numLights values for each
+    std::vector<float> trgShadows;
 };
@@ -18,6 +18,8 @@
 #include "Filesystem/Config/Config.hpp"
 #include "Filesystem/Constants/ConfigNames.hpp"
 
+#include <chrono>
+
 using namespace Storm::Filesystem;
 
 // ============================================================================================
@@ -47,6 +49,8 @@ bool Lighter::Init()
     autoSmooth = config.Get<std::int64_t>("autosmooth", 0) != 0;
     window.isSmallSlider = config.Get<std::int64_t>("smallslider", 0) != 0;
     geometry.useColor = config.Get<std::int64_t>("usecolor", 0) != 0;
+    isBatch = config.Get<std::int64_t>("batch", 0) != 0;
+    batchPreset = static_cast<int32_t>(config.Get<std::int64_t>("batchpreset", -1));
 
     if (isLoading)
         return false;
@@ -57,10 +61,13 @@ bool Lighter::Init()
     //
     core.SetLayerType(LIGHTER_EXECUTE, layer_type_t::execute);
     core.AddToLayer(LIGHTER_EXECUTE, GetId(), 1000);
-    core.SetLayerType(LIGHTER_REALIZE, layer_type_t::realize);
-    core.AddToLayer(LIGHTER_REALIZE, GetId(), 1000);
     //
     lightProcessor.SetParams(&geometry, &window, &lights, &octTree, rs);
+    // batch mode has nothing to draw
+    if (isBatch)
+        return true;
+    core.SetLayerType(LIGHTER_REALIZE, layer_type_t::realize);
+    core.AddToLayer(LIGHTER_REALIZE, GetId(), 1000);
     // window system
     if (!window.Init(rs))
         return false;
@@ -71,6 +78,16 @@ bool Lighter::Init()
 // Execution
 void Lighter::Execute(uint32_t delta_time)
 {
+    // the models are added right after the creation, so they are all here on the first frame
+    if (isBatch)
+    {
+        if (!isBatchDone)
+        {
+            isBatchDone = true;
+            Bake(batchPreset);
+        }
+        return;
+    }
     const auto dltTime = delta_time * 0.001f;
     if (window.isSaveLight)
     {
@@ -171,6 +188,30 @@ void Lighter::PreparingData()
     isDataPrepared_ = true;
 }
 
+// Calculate and save the lighting without the interface
+bool Lighter::Bake(int32_t preset)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const auto seconds = [](std::chrono::steady_clock::time_point from) {
+        return std::chrono::duration<float>(std::chrono::steady_clock::now() - from).count();
+    };
+    PreparingData();
+    if (!isDataPrepared_)
+    {
+        core.Trace("Location lighter: no geometry to bake");
+        return false;
+    }
+    window.LoadPreset(preset);
+    core.Trace("Location lighter: prepared %d vertices, %d triangles, %d lights in %.2f s", geometry.numVrt,
+               geometry.numTrg, lights.Num(), seconds(start));
+    lightProcessor.Bake();
+    const auto saveStart = std::chrono::steady_clock::now();
+    const auto isSaved = geometry.Save();
+    core.Trace("Location lighter: %s in %.2f s, total %.2f s", isSaved ? "saved" : "failed to save", seconds(saveStart),
+               seconds(start));
+    return isSaved;
+}
+
 void Lighter::Realize(uint32_t delta_time)
 {
     if (core.Controls->GetAsyncKeyState(VK_DECIMAL) < 0)
@@ -241,6 +282,11 @@ uint64_t Lighter::ProcessMessage(MESSAGE &message)
         lightProcessor.Process();
         return true;
     }
+    if (storm::iEquals(command, "Bake"))
+    {
+        const int32_t preset = message.ParamValid() ? message.Long() : -1;
+        return Bake(preset);
+    }
     if (storm::iEquals(command, "SaveLight"))
     {
         PreparingData();
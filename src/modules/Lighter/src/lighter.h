@@ -55,6 +55,8 @@ class Lighter : public Entity
     void MsgLightPath(MESSAGE &message);
     void MsgAddLight(MESSAGE &message);
     void PreparingData();
+    // Calculate and save the lighting without the interface
+    bool Bake(int32_t preset);
 
     VDX9RENDER *rs;
 
@@ -69,4 +71,8 @@ class Lighter : public Entity
     bool autoTrace;
     bool autoSmooth;
     bool isDataPrepared_ = false;
+    // Bake on the first frame and skip the interface
+    bool isBatch = false;
+    bool isBatchDone = false;
+    int32_t batchPreset = -1;
 };
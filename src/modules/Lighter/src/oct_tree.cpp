@@ -39,11 +39,8 @@ OctTree::OTNode::~OTNode()
 // ============================================================================================
 
 OctTree::OctTree()
-    : vertsPos(), vertsPosMin(), vertsPosMax(), vertsR(0)
 {
     root = nullptr;
-    numVerts = 0;
-    maxVerts = 0;
     vrt = nullptr;
     numVrt = 0;
 }
@@ -165,35 +162,37 @@ void OctTree::Optimize(OTNode *node)
 }
 
 // Find vertices in a given radius
-void OctTree::FindVerts(const CVECTOR &pos, float r)
+void OctTree::FindVerts(const CVECTOR &pos, float r, std::vector<OctFndVerts> &verts) const
 {
-    numVerts = 0;
-    vertsPos = pos;
-    vertsR = r * r;
+    verts.clear();
+    Search search;
+    search.pos = pos;
+    search.r2 = r * r;
     r += 0.000001f;
-    vertsPosMin = pos - CVECTOR(r);
-    vertsPosMax = pos + CVECTOR(r);
+    search.min = pos - CVECTOR(r);
+    search.max = pos + CVECTOR(r);
+    search.verts = &verts;
     if (root)
-        FindVerts(root);
+        FindVerts(root, search);
 }
 
 // Search
-void OctTree::FindVerts(OTNode *node)
+void OctTree::FindVerts(const OTNode *node, Search &search)
 {
     auto &min = node->min;
     auto &max = node->max;
     // Preliminary check
-    if (vertsPosMin.x > max.x)
+    if (search.min.x > max.x)
         return;
-    if (vertsPosMax.x < min.x)
+    if (search.max.x < min.x)
         return;
-    if (vertsPosMin.y > max.y)
+    if (search.min.y > max.y)
         return;
-    if (vertsPosMax.y < min.y)
+    if (search.max.y < min.y)
         return;
-    if (vertsPosMin.z > max.z)
+    if (search.min.z > max.z)
         return;
-    if (vertsPosMax.z < min.z)
+    if (search.max.z < min.z)
         return;
     // Refined check
 
@@ -202,23 +201,15 @@ void OctTree::FindVerts(OTNode *node)
     {
         for (int32_t i = 0; i < 8; i++)
             if (node->node[i])
-                FindVerts(node->node[i]);
+                FindVerts(node->node[i], search);
     }
     else
     {
         for (int32_t i = 0; i < node->num; i++)
         {
-            const auto r = ~(node->vrt[i]->p - vertsPos);
-            if (r < vertsR)
-            {
-                if (numVerts >= maxVerts)
-                {
-                    maxVerts += 1024;
-                    verts.resize(maxVerts);
-                }
-                verts[numVerts].v = node->vrt[i];
-                verts[numVerts++].r2 = r;
-            }
+            const auto r = ~(node->vrt[i]->p - search.pos);
+            if (r < search.r2)
+                search.verts->push_back({node->vrt[i], r});
         }
     }
 }
@@ -34,12 +34,8 @@ class OctTree
 
     // Initialize tree
     void Init(LGeometry *g);
-    // Find vertices in a given radius
-    void FindVerts(const CVECTOR &pos, float r);
-
-    std::vector<OctFndVerts> verts;
-    int32_t numVerts;
-    int32_t maxVerts;
+    // Find vertices in a given radius, safe to call from several threads with their own lists
+    void FindVerts(const CVECTOR &pos, float r, std::vector<OctFndVerts> &verts) const;
 
     // --------------------------------------------------------------------------------------------
     // Encapsulation
@@ -49,8 +45,15 @@ class OctTree
     bool AddVertex(OTNode *node, Vertex *v);
     // Optimizing the tree
     void Optimize(OTNode *node);
+    struct Search
+    {
+        CVECTOR pos, min, max;
+        float r2;
+        std::vector<OctFndVerts> *verts;
+    };
+
     // Search
-    void FindVerts(OTNode *node);
+    static void FindVerts(const OTNode *node, Search &search);
 
     int32_t Check(OTNode *node, Vertex *v, int32_t num);
 
@@ -58,6 +61,4 @@ class OctTree
     Vertex *vrt;
     int32_t numVrt;
     OTNode *root;
-    CVECTOR vertsPos, vertsPosMin, vertsPosMax;
-    float vertsR;
 };
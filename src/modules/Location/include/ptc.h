@@ -51,7 +51,7 @@ struct PtcHeader
     int32_t numNormals;        // Number of normals
     int32_t mapL, mapW;        // Collision map dimensions
     int32_t numIndeces;        // Index table size
-    int32_t lineSize;          // The size of the row in the path lookup table
+    int32_t lineSize;          // The size of the row in the path lookup table, may be 0 without a table
     float minX, minY, minZ; // Minimum box border
     float maxX, maxY, maxZ; // Maximum box border
 };
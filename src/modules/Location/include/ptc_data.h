@@ -11,7 +11,11 @@
 #pragma once
 
 #include "c_vector.h"
+#include "mapped_file.h"
 #include "ptc.h"
+#include "ptc_path_graph.h"
+
+#include <vector>
 
 #define PTCDATA_MAXSTEPS 32
 
@@ -95,8 +99,8 @@ class PtcData
 
     // private:
   public:
-    // Data block
-    char *data;
+    // Data block, the structures below point into the mapped file
+    MappedFile data;
 
     // Geometry
     PtcTriangle *triangle; // Geometry triangles
@@ -120,9 +124,9 @@ class PtcData
     uint16_t *indeces; // Indexes
     int32_t numIndeces;   // Number of indexes
 
-    // Pathfinding data
-    uint8_t *table; // Direction table
-    int32_t lineSize;  // Line size
+    // Pathfinding data, the direction table of the file is not used
+    PtcPathGraph pathGraph;
+    std::vector<uint8_t> corridor; // Edges to cross by the steps of the last search
 
     // Triangles after collision
     Triangle *ctriangle;
@@ -0,0 +1,74 @@
+// ============================================================================================
+// Sea Dogs II
+// --------------------------------------------------------------------------------------------
+// PtcPathGraph
+// --------------------------------------------------------------------------------------------
+// Two level path search over the patch: triangles are grouped into connected clusters, the
+// clusters are linked through their shared edges. Routes between clusters are cached per target
+// ============================================================================================
+
+#pragma once
+
+#include "c_vector.h"
+#include "ptc.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class PtcPathGraph
+{
+  public:
+    PtcPathGraph();
+
+    // Split the patch into clusters, the arrays must outlive the graph
+    void Build(const PtcTriangle *triangle, int32_t numTriangles, const PtcVertex *vertex);
+    // Forget the patch
+    void Clear();
+    // Edges (0..2) to cross one after another on the way from the triangle to the other one,
+    // the corridor ends early after maxSteps edges. Returns false if there is no way
+    bool FindCorridor(int32_t from, int32_t to, const CVECTOR &toPos, int32_t maxSteps, std::vector<uint8_t> &edges);
+
+    int32_t NumClusters() const;
+    // Bytes allocated by the graph and its route cache
+    size_t MemoryUsage() const;
+
+  private:
+    struct Link
+    {
+        int32_t cluster;
+        float cost;
+    };
+
+    struct Cluster
+    {
+        int32_t firstLink, numLinks;
+        CVECTOR center;
+    };
+
+    CVECTOR Center(int32_t trg) const;
+    // Next cluster on the way to the target cluster for every cluster, -1 if unreachable
+    const std::vector<int32_t> &Route(int32_t target);
+    // Shortest way over the triangles of the window clusters, appends the crossed edges
+    bool FindWindowCorridor(int32_t from, int32_t to, const CVECTOR &toPos, const std::vector<int32_t> &window,
+                            std::vector<int32_t> &trgs);
+
+    const PtcTriangle *triangle;
+    const PtcVertex *vertex;
+    int32_t numTriangles;
+
+    std::vector<int32_t> clusterOf;
+    std::vector<Cluster> cluster;
+    std::vector<Link> link;
+    std::unordered_map<int32_t, std::vector<int32_t>> route;
+
+    // Search state per triangle, valid where visit equals the current search
+    std::vector<float> cost;
+    std::vector<int32_t> parent;
+    std::vector<uint32_t> visit;
+    uint32_t search;
+    std::vector<std::pair<float, int32_t>> open; // Binary heap, nearest first
+    std::vector<int32_t> window;
+    std::vector<int32_t> path;
+};
@@ -1155,6 +1155,7 @@ bool Character::Teleport(float x, float y, float z)
     currentNode = location->GetPtcData().FindNode(curPos, bearingY);
     if (curPos.y < bearingY)
         curPos.y = bearingY;
+    location->supervisor.MoveCharacter(this);
     CharacterTeleport();
     return true;
 }
@@ -1178,6 +1179,7 @@ bool Character::Teleport(float x, float y, float z, float ay)
     currentNode = location->GetPtcData().FindNode(curPos, bearingY);
     if (curPos.y < bearingY)
         curPos.y = bearingY;
+    location->supervisor.MoveCharacter(this);
     CharacterTeleport();
     return true;
 }
@@ -0,0 +1,157 @@
+// ============================================================================================
+// Sea Dogs II
+// --------------------------------------------------------------------------------------------
+// CharacterGrid
+// --------------------------------------------------------------------------------------------
+//
+// ============================================================================================
+
+#include "character_grid.h"
+
+#include <algorithm>
+#include <cmath>
+
+// Cell side, close to the distance at which two characters interact
+#define CHARACTER_GRID_CELL 8.0f
+// Number of hash buckets, power of two
+#define CHARACTER_GRID_BUCKETS 1024
+// Cell coordinates are clamped to keep far away positions hashable
+#define CHARACTER_GRID_LIMIT 1000000
+
+// ============================================================================================
+// Construction, destruction
+// ============================================================================================
+
+CharacterGrid::CharacterGrid() : bucket(CHARACTER_GRID_BUCKETS, -1), numUsed(0)
+{
+}
+
+// ============================================================================================
+// Entries
+// ============================================================================================
+
+void CharacterGrid::Clear()
+{
+    std::ranges::fill(bucket, -1);
+    entry.clear();
+    loose.clear();
+    numUsed = 0;
+}
+
+void CharacterGrid::Insert(int32_t idx, float x, float z)
+{
+    if (idx >= static_cast<int32_t>(entry.size()))
+        entry.resize(idx + 1, Entry{0, 0, -1, -1, false, false});
+    if (entry[idx].used)
+        Remove(idx);
+    auto &e = entry[idx];
+    e.used = true;
+    e.loose = !std::isfinite(x) || !std::isfinite(z);
+    numUsed++;
+    if (e.loose)
+    {
+        loose.push_back(idx);
+        return;
+    }
+    e.cx = Cell(x);
+    e.cz = Cell(z);
+    Link(idx);
+}
+
+void CharacterGrid::Remove(int32_t idx)
+{
+    if (idx >= static_cast<int32_t>(entry.size()) || !entry[idx].used)
+        return;
+    if (entry[idx].loose)
+        loose.erase(std::ranges::find(loose, idx));
+    else
+        Unlink(idx);
+    entry[idx].used = false;
+    numUsed--;
+}
+
+void CharacterGrid::Update(int32_t idx, float x, float z)
+{
+    if (idx >= static_cast<int32_t>(entry.size()) || !entry[idx].used)
+    {
+        Insert(idx, x, z);
+        return;
+    }
+    // Most updates stay in the same cell
+    const auto &e = entry[idx];
+    if (!e.loose && std::isfinite(x) && std::isfinite(z) && e.cx == Cell(x) && e.cz == Cell(z))
+        return;
+    Insert(idx, x, z);
+}
+
+void CharacterGrid::Query(float x, float z, float radius, std::vector<int32_t> &result) const
+{
+    result.clear();
+    // A little slack keeps the float rounding of the callers' tests inside the square
+    radius = radius * 1.001f + 0.001f;
+    int64_t numCells = -1;
+    int32_t x0 = 0, x1 = -1, z0 = 0, z1 = -1;
+    if (std::isfinite(x) && std::isfinite(z) && std::isfinite(radius))
+    {
+        x0 = Cell(x - radius);
+        x1 = Cell(x + radius);
+        z0 = Cell(z - radius);
+        z1 = Cell(z + radius);
+        numCells = (static_cast<int64_t>(x1) - x0 + 1) * (static_cast<int64_t>(z1) - z0 + 1);
+    }
+    // A query wider than the population is cheaper as a plain list
+    if (numCells < 0 || numCells > numUsed)
+    {
+        for (int32_t i = 0; i < static_cast<int32_t>(entry.size()); i++)
+            if (entry[i].used)
+                result.push_back(i);
+        return;
+    }
+    for (auto cz = z0; cz <= z1; cz++)
+        for (auto cx = x0; cx <= x1; cx++)
+            for (auto i = bucket[Bucket(cx, cz)]; i >= 0; i = entry[i].next)
+                if (entry[i].cx == cx && entry[i].cz == cz)
+                    result.push_back(i);
+    result.insert(result.end(), loose.begin(), loose.end());
+    std::ranges::sort(result);
+}
+
+// ============================================================================================
+// Encapsulation
+// ============================================================================================
+
+int32_t CharacterGrid::Bucket(int32_t cx, int32_t cz) const
+{
+    const auto h = static_cast<uint32_t>(cx) * 73856093u ^ static_cast<uint32_t>(cz) * 19349663u;
+    return static_cast<int32_t>(h & (CHARACTER_GRID_BUCKETS - 1));
+}
+
+int32_t CharacterGrid::Cell(float v) const
+{
+    const auto c = std::floor(v * (1.0f / CHARACTER_GRID_CELL));
+    return static_cast<int32_t>(std::clamp(c, static_cast<float>(-CHARACTER_GRID_LIMIT),
+                                           static_cast<float>(CHARACTER_GRID_LIMIT)));
+}
+
+void CharacterGrid::Link(int32_t idx)
+{
+    auto &e = entry[idx];
+    auto &head = bucket[Bucket(e.cx, e.cz)];
+    e.prev = -1;
+    e.next = head;
+    if (head >= 0)
+        entry[head].prev = idx;
+    head = idx;
+}
+
+void CharacterGrid::Unlink(int32_t idx)
+{
+    auto &e = entry[idx];
+    if (e.prev >= 0)
+        entry[e.prev].next = e.next;
+    else
+        bucket[Bucket(e.cx, e.cz)] = e.next;
+    if (e.next >= 0)
+        entry[e.next].prev = e.prev;
+    e.prev = e.next = -1;
+}
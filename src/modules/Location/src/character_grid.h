@@ -0,0 +1,48 @@
+// ============================================================================================
+// Sea Dogs II
+// --------------------------------------------------------------------------------------------
+// CharacterGrid
+// --------------------------------------------------------------------------------------------
+// Uniform grid over the xz plane of the location, hashed into a fixed bucket table
+// ============================================================================================
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class CharacterGrid
+{
+  public:
+    CharacterGrid();
+
+    // Forget all the entries
+    void Clear();
+    // Put the entry with the index into the cell of the position
+    void Insert(int32_t idx, float x, float z);
+    // Take the entry out of the grid
+    void Remove(int32_t idx);
+    // Move the entry to the cell of the new position
+    void Update(int32_t idx, float x, float z);
+    // Ascending indices of the entries in the cells touching the square around x, z.
+    // Every entry within radius is there, the exact test is up to the caller
+    void Query(float x, float z, float radius, std::vector<int32_t> &result) const;
+
+  private:
+    struct Entry
+    {
+        int32_t cx, cz;     // Cell
+        int32_t prev, next; // Neighbours in the bucket list
+        bool used;
+        bool loose; // Position not finite, returned by every query
+    };
+
+    int32_t Bucket(int32_t cx, int32_t cz) const;
+    int32_t Cell(float v) const;
+    void Link(int32_t idx);
+    void Unlink(int32_t idx);
+
+    std::vector<int32_t> bucket;
+    std::vector<Entry> entry;
+    std::vector<int32_t> loose;
+    int32_t numUsed;
+};
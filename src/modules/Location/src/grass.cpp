@@ -181,17 +181,18 @@ bool Grass::LoadData(const char *patchName)
     miniMap = nullptr;
     delete block;
     block = nullptr;
-    // Load the data file
-    uint8_t *load = nullptr;
-    uint32_t size = 0;
-    if (!fio->LoadFile(patchName, (char **)&load, &size))
+    // Map the data file, it is unpacked straight from the mapping
+    const auto file = fio->_MapFile(patchName);
+    if (!file.IsOpen())
         return false;
+    const auto *load = reinterpret_cast<const uint8_t *>(file.Data());
+    const auto size = file.Size();
     try
     {
         // Check the data
         if (size < sizeof(GRSHeader))
             throw std::runtime_error("invalide file size");
-        auto &hdr = *(GRSHeader *)load;
+        auto &hdr = *(const GRSHeader *)load;
         if (hdr.id != GRASS_ID)
             throw std::runtime_error("invalide file id");
         if (hdr.ver != GRASS_VER)
@@ -221,7 +222,8 @@ bool Grass::LoadData(const char *patchName)
             translate[i] = static_cast<uint8_t>((i * 255) / 15);
         }
         block = new GRSMapElementEx[elements];
-        auto *const src = (GRSMapElement *)(load + sizeof(GRSHeader) + minisize * sizeof(GRSMiniMapElement));
+        auto *const src =
+            (const GRSMapElement *)(load + sizeof(GRSHeader) + minisize * sizeof(GRSMiniMapElement));
         for (int32_t i = 0; i < elements; i++)
         {
             auto &sb = src[i];
@@ -276,7 +278,6 @@ bool Grass::LoadData(const char *patchName)
         delete block;
         block = nullptr;
     }
-    delete load;
     return true;
 }
 
@@ -88,6 +88,7 @@ bool Location::Init()
     rs = static_cast<VDX9RENDER *>(core.GetService("dx9render"));
     if (!rs)
         throw std::runtime_error("No service: dx9render");
+    locatorsTechnique = rs->TechniqueGetHandle("DbgDrawLocators");
     rs->SetRenderState(D3DRS_LIGHTING, FALSE);
 
     // core.LayerCreate("execute", true, false);
@@ -111,7 +112,7 @@ bool Location::Init()
 // Execution
 void Location::Execute(uint32_t delta_time)
 {
-    bSwimming = AttributesPointer->GetAttributeAsDword("swimming", 1) != 0;
+    bSwimming = AttributesPointer->GetAttributeAsDword(pathSwimming, 1) != 0;
 
     // Updating characters
     if (!isDebugView)
@@ -843,7 +844,7 @@ void Location::DrawLocators(LocatorArray *la)
         rs->TextureSet(0, -1);
         rs->TextureSet(1, -1);
         // start the technique
-        const bool isSet = rs->TechniqueExecuteStart("DbgDrawLocators");
+        const bool isSet = rs->TechniqueExecuteStart(locatorsTechnique);
         rs->SetRenderState(D3DRS_TEXTUREFACTOR, la->color);
         // Draw
         for (int32_t i = 0; i < la->Num(); i++)
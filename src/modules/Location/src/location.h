@@ -167,6 +167,7 @@ class Location : public Entity
     bool isDebugView;
 
     VDX9RENDER *rs;
+    int32_t locatorsTechnique = -1;
 
     // All models
     ModelArray model;
@@ -206,6 +207,7 @@ class Location : public Entity
     bool bDrawBars;
 
     bool bSwimming;
+    AttributePath pathSwimming{"swimming"};
 };
 
 // Get a character patch
@@ -234,8 +234,8 @@ void NPCharacter::Move(float dltTime)
 // Update character position
 void NPCharacter::Update(float dltTime)
 {
-    bMusketer = AttributesPointer->GetAttributeAsDword("isMusketer", 0) != 0;
-    fMusketerDistance = AttributesPointer->GetAttributeAsFloat("MusketerDistance", 20.0f);
+    bMusketer = AttributesPointer->GetAttributeAsDword(pathIsMusketer, 0) != 0;
+    fMusketerDistance = AttributesPointer->GetAttributeAsFloat(pathMusketerDistance, 20.0f);
     bMusketerNoMove = fMusketerDistance <= 0.0f;
 
     AICharacter::bMusketer = bMusketer;
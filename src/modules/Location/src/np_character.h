@@ -203,6 +203,9 @@ class NPCharacter : public AICharacter
     bool bMusketerNoMove; //~!~
     bool bTryAnyTarget;
 
+    AttributePath pathIsMusketer{"isMusketer"};
+    AttributePath pathMusketerDistance{"MusketerDistance"};
+
     void SetEscapeTask(Character *c);
 };
 
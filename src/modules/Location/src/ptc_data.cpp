@@ -29,7 +29,6 @@ PtcData::PtcData()
     using std::chrono::system_clock;
 
     srand(duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count());
-    data = nullptr;
     triangle = nullptr;
     numTriangles = 0;
     vertex = nullptr;
@@ -42,8 +41,6 @@ PtcData::PtcData()
     ls = ws = 0.0f;
     indeces = nullptr;
     numIndeces = 0;
-    table = nullptr;
-    lineSize = 0;
     ctriangle = nullptr;
     numClTriangles = 0;
     maxClTriangles = 0;
@@ -56,7 +53,6 @@ PtcData::PtcData()
 
 PtcData::~PtcData()
 {
-    delete[] data;
     delete ctriangle;
     delete dbgTriangles;
     delete dbgEdges;
@@ -64,34 +60,32 @@ PtcData::~PtcData()
 
 bool PtcData::Load(const char *path)
 {
-    Assert(data == nullptr);
-    char *buf = nullptr;
-    uint32_t size = 0;
+    Assert(!data.IsOpen());
     middle = 0.0f;
-    // Loading data
-    if (!fio->LoadFile(path, &buf, &size))
+    // Loading data, the file is used in place
+    auto file = fio->_MapFile(path);
+    if (!file.IsOpen())
     {
         core.Trace("Ptc(\"%s\") -> file not found", path);
         return false;
     }
     // Checking the file for correctness
-    if (!buf || size < sizeof(PtcHeader))
+    const auto size = file.Size();
+    const auto *hdrPtr = file.View().Get<PtcHeader>(0);
+    if (!hdrPtr)
     {
         core.Trace("Ptc(\"%s\") -> invalide file size", path);
-        delete buf;
         return false;
     }
-    auto &hdr = *(PtcHeader *)buf;
+    auto &hdr = *hdrPtr;
     if (hdr.id != PTC_ID)
     {
         core.Trace("Ptc(\"%s\") -> invalide file ID", path);
-        delete buf;
         return false;
     }
     if (hdr.ver != PTC_VERSION && hdr.ver != PTC_PREVERSION1)
     {
         core.Trace("Ptc(\"%s\") -> invalide file version", path);
-        delete buf;
         return false;
     }
     uint32_t tsize = sizeof(PtcHeader);
@@ -106,19 +100,23 @@ bool PtcData::Load(const char *path)
     if (tsize != size)
     {
         core.Trace("Ptc(\"%s\") -> invalide file size", path);
-        delete buf;
         return false;
     }
     if (hdr.numTriangles < 1 || hdr.numVerteces < 3 || hdr.numNormals < 1 || hdr.mapL < 1 || hdr.mapW < 1 ||
-        hdr.numIndeces < 1 || hdr.lineSize < 1 || hdr.minX >= hdr.maxX || hdr.minY > hdr.maxY || hdr.minZ >= hdr.maxZ)
+        hdr.numIndeces < 1 || hdr.lineSize < 0 || hdr.minX >= hdr.maxX || hdr.minY > hdr.maxY || hdr.minZ >= hdr.maxZ)
     {
         core.Trace("Ptc(\"%s\") -> invalide file header", path);
-        delete buf;
         return false;
     }
     // form data structures
-    data = buf;
+    const auto tableSize = static_cast<uint32_t>(hdr.lineSize * hdr.numTriangles);
+    data = std::move(file);
+    const auto buildStart = std::chrono::steady_clock::now();
     SFLB_PotectionLoad();
+    const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - buildStart;
+    core.Trace("Ptc(\"%s\") -> %d triangles, path graph of %d clusters in %u bytes (table %u bytes), built in %.2f ms",
+               path, numTriangles, pathGraph.NumClusters(), static_cast<uint32_t>(pathGraph.MemoryUsage()),
+               tableSize, buildTime.count());
     return true;
 }
 
@@ -126,7 +124,8 @@ bool PtcData::Load(const char *path)
 void PtcData::SFLB_PotectionLoad()
 {
     // Data
-    auto *const buf = static_cast<char *>(data);
+    // nothing writes through these pointers, the mapping is read-only
+    auto *const buf = const_cast<char *>(data.Data());
     auto &hdr = *(PtcHeader *)buf;
     // Triangles
     uint32_t tsize = sizeof(PtcHeader);
@@ -155,13 +154,13 @@ void PtcData::SFLB_PotectionLoad()
     ws = (max.x - min.x) / w;
     tsize += hdr.mapL * hdr.mapW * sizeof(PtcMap);
     indeces = (uint16_t *)(buf + tsize);
-    // Pathfinding data
+    // Pathfinding data, the direction table is skipped and never paged in
     tsize += hdr.numIndeces * sizeof(uint16_t);
-    table = (uint8_t *)(buf + tsize);
-    lineSize = hdr.lineSize;
+    tsize += hdr.lineSize * hdr.numTriangles * sizeof(uint8_t);
+    pathGraph.Build(triangle, numTriangles, vertex);
     // Materials
     if (hdr.ver == PTC_VERSION)
-        materials = (PtcMaterials *)(table + lineSize * numTriangles);
+        materials = (PtcMaterials *)(buf + tsize);
     // Looking for the midpoint
     middle = 0.0f;
     for (int32_t i = 0; i < numVerteces; i++)
@@ -508,7 +507,8 @@ bool PtcData::FindPathDir(int32_t curNode, const CVECTOR &cur, int32_t toNode, c
     numSteps = 0;
     if (curNode < 0 || toNode < 0)
         return false;
-    if (FindPathDir(0, curNode, cur, toNode, to, node, toPos))
+    if (pathGraph.FindCorridor(curNode, toNode, to, PTCDATA_MAXSTEPS, corridor) &&
+        FindPathDir(0, curNode, cur, toNode, to, node, toPos))
         return true;
     toPos = to;
     return false;
@@ -532,8 +532,9 @@ bool PtcData::FindPathDir(int32_t step, int32_t curNode, const CVECTOR &cur, int
     // Determine in which direction to move (edge)
     Assert(curNode < numTriangles);
     Assert(toNode < numTriangles);
-    uint8_t *line = table + curNode * lineSize;
-    const uint8_t v = (line[toNode >> 2] >> ((toNode & 3) * 2)) & 3;
+    if (step >= static_cast<int32_t>(corridor.size()))
+        return false;
+    const uint8_t v = corridor[step];
     if (v == 3)
         return false;
     // Edge
@@ -0,0 +1,275 @@
+// ============================================================================================
+// Sea Dogs II
+// --------------------------------------------------------------------------------------------
+// PtcPathGraph
+// --------------------------------------------------------------------------------------------
+//
+// ============================================================================================
+
+#include "ptc_path_graph.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <functional>
+
+// Triangles in a cluster, a corridor of PTCDATA_MAXSTEPS edges spans a few clusters
+#define PTCPATHGRAPH_CLUSTER 64
+// Clusters searched over the triangles at once, the current one and the next ones on the route
+#define PTCPATHGRAPH_WINDOW 3
+// Target clusters with a cached route, the cache is dropped as a whole when full
+#define PTCPATHGRAPH_ROUTES 256
+
+namespace
+{
+void PushOpen(std::vector<std::pair<float, int32_t>> &open, float f, int32_t idx)
+{
+    open.emplace_back(f, idx);
+    std::push_heap(open.begin(), open.end(), std::greater<>());
+}
+
+std::pair<float, int32_t> PopOpen(std::vector<std::pair<float, int32_t>> &open)
+{
+    std::pop_heap(open.begin(), open.end(), std::greater<>());
+    const auto top = open.back();
+    open.pop_back();
+    return top;
+}
+} // namespace
+
+// ============================================================================================
+// Construction, destruction
+// ============================================================================================
+
+PtcPathGraph::PtcPathGraph() : triangle(nullptr), vertex(nullptr), numTriangles(0), search(0)
+{
+}
+
+void PtcPathGraph::Build(const PtcTriangle *triangle, int32_t numTriangles, const PtcVertex *vertex)
+{
+    Clear();
+    this->triangle = triangle;
+    this->vertex = vertex;
+    this->numTriangles = numTriangles;
+    // Grow the clusters breadth first over the neighbours, so each of them is connected
+    clusterOf.assign(numTriangles, -1);
+    std::vector<int32_t> queue;
+    for (int32_t seed = 0; seed < numTriangles; seed++)
+    {
+        if (clusterOf[seed] >= 0)
+            continue;
+        const auto id = static_cast<int32_t>(cluster.size());
+        queue.clear();
+        queue.push_back(seed);
+        clusterOf[seed] = id;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            const auto &trg = triangle[queue[head]];
+            for (int32_t j = 0; j < 3 && queue.size() < PTCPATHGRAPH_CLUSTER; j++)
+            {
+                const int32_t nb = trg.nb[j];
+                if (nb < 0 || nb >= numTriangles || clusterOf[nb] >= 0)
+                    continue;
+                clusterOf[nb] = id;
+                queue.push_back(nb);
+            }
+        }
+        CVECTOR center = 0.0f;
+        for (const auto trg : queue)
+            center += Center(trg);
+        cluster.push_back(Cluster{0, 0, center * (1.0f / queue.size())});
+    }
+    // Links between the clusters sharing an edge
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    for (int32_t i = 0; i < numTriangles; i++)
+    {
+        for (int32_t j = 0; j < 3; j++)
+        {
+            const int32_t nb = triangle[i].nb[j];
+            if (nb >= 0 && nb < numTriangles && clusterOf[nb] != clusterOf[i])
+                pairs.emplace_back(clusterOf[i], clusterOf[nb]);
+        }
+    }
+    std::ranges::sort(pairs);
+    pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+    link.reserve(pairs.size());
+    for (const auto &[from, to] : pairs)
+    {
+        auto &c = cluster[from];
+        if (c.numLinks == 0)
+            c.firstLink = static_cast<int32_t>(link.size());
+        c.numLinks++;
+        link.push_back(Link{to, sqrtf(~(cluster[to].center - c.center))});
+    }
+    // Search state
+    cost.assign(numTriangles, 0.0f);
+    parent.assign(numTriangles, -1);
+    visit.assign(numTriangles, 0);
+}
+
+void PtcPathGraph::Clear()
+{
+    triangle = nullptr;
+    vertex = nullptr;
+    numTriangles = 0;
+    clusterOf.clear();
+    cluster.clear();
+    link.clear();
+    route.clear();
+    cost.clear();
+    parent.clear();
+    visit.clear();
+    search = 0;
+    open.clear();
+}
+
+// ============================================================================================
+// Search
+// ============================================================================================
+
+bool PtcPathGraph::FindCorridor(int32_t from, int32_t to, const CVECTOR &toPos, int32_t maxSteps,
+                                std::vector<uint8_t> &edges)
+{
+    edges.clear();
+    if (from < 0 || to < 0 || from >= numTriangles || to >= numTriangles)
+        return false;
+    const auto target = clusterOf[to];
+    const auto &next = Route(target);
+    int32_t cur = from;
+    while (cur != to && static_cast<int32_t>(edges.size()) < maxSteps)
+    {
+        // The current cluster and the next ones on the route
+        window.clear();
+        for (auto c = clusterOf[cur]; window.size() < PTCPATHGRAPH_WINDOW; c = next[c])
+        {
+            if (c < 0)
+                return false;
+            window.push_back(c);
+            if (c == target)
+                break;
+        }
+        path.clear();
+        if (!FindWindowCorridor(cur, to, toPos, window, path) || path.empty())
+            return false;
+        for (const auto trg : path)
+        {
+            int32_t j;
+            for (j = 0; j < 3 && triangle[cur].nb[j] != trg; j++)
+                ;
+            edges.push_back(static_cast<uint8_t>(j));
+            cur = trg;
+            if (static_cast<int32_t>(edges.size()) >= maxSteps)
+                break;
+        }
+    }
+    return true;
+}
+
+bool PtcPathGraph::FindWindowCorridor(int32_t from, int32_t to, const CVECTOR &toPos,
+                                      const std::vector<int32_t> &window, std::vector<int32_t> &trgs)
+{
+    if (++search == 0)
+    {
+        std::ranges::fill(visit, 0);
+        search = 1;
+    }
+    // A* to the target, or to the last cluster of the window if the target is further on
+    const bool isTargetInWindow = window.back() == clusterOf[to];
+    open.clear();
+    visit[from] = search;
+    cost[from] = 0.0f;
+    parent[from] = -1;
+    PushOpen(open, sqrtf(~(Center(from) - toPos)), from);
+    while (!open.empty())
+    {
+        const auto [f, trg] = PopOpen(open);
+        const auto center = Center(trg);
+        if (f > cost[trg] + sqrtf(~(center - toPos)))
+            continue;
+        if (isTargetInWindow ? trg == to : clusterOf[trg] == window.back())
+        {
+            const auto start = trgs.size();
+            for (auto t = trg; t != from; t = parent[t])
+                trgs.push_back(t);
+            std::reverse(trgs.begin() + start, trgs.end());
+            return true;
+        }
+        for (int32_t j = 0; j < 3; j++)
+        {
+            const int32_t nb = triangle[trg].nb[j];
+            if (nb < 0 || nb >= numTriangles || std::ranges::find(window, clusterOf[nb]) == window.end())
+                continue;
+            const auto nbCenter = Center(nb);
+            const float c = cost[trg] + sqrtf(~(nbCenter - center));
+            if (visit[nb] == search && cost[nb] <= c)
+                continue;
+            visit[nb] = search;
+            cost[nb] = c;
+            parent[nb] = trg;
+            PushOpen(open, c + sqrtf(~(nbCenter - toPos)), nb);
+        }
+    }
+    return false;
+}
+
+const std::vector<int32_t> &PtcPathGraph::Route(int32_t target)
+{
+    if (const auto it = route.find(target); it != route.end())
+        return it->second;
+    if (route.size() >= PTCPATHGRAPH_ROUTES)
+        route.clear();
+    // Dijkstra from the target, each cluster remembers the one it was reached from
+    auto &next = route[target];
+    next.assign(cluster.size(), -1);
+    std::vector<float> dist(cluster.size(), FLT_MAX);
+    open.clear();
+    dist[target] = 0.0f;
+    next[target] = target;
+    PushOpen(open, 0.0f, target);
+    while (!open.empty())
+    {
+        const auto [d, c] = PopOpen(open);
+        if (d > dist[c])
+            continue;
+        for (int32_t i = 0; i < cluster[c].numLinks; i++)
+        {
+            const auto &l = link[cluster[c].firstLink + i];
+            const float nd = d + l.cost;
+            if (nd >= dist[l.cluster])
+                continue;
+            dist[l.cluster] = nd;
+            next[l.cluster] = c;
+            PushOpen(open, nd, l.cluster);
+        }
+    }
+    return next;
+}
+
+// ============================================================================================
+// Utilities
+// ============================================================================================
+
+CVECTOR PtcPathGraph::Center(int32_t trg) const
+{
+    const auto &t = triangle[trg];
+    const auto &v0 = vertex[t.i[0]];
+    const auto &v1 = vertex[t.i[1]];
+    const auto &v2 = vertex[t.i[2]];
+    return CVECTOR(v0.x + v1.x + v2.x, v0.y + v1.y + v2.y, v0.z + v1.z + v2.z) * (1.0f / 3.0f);
+}
+
+int32_t PtcPathGraph::NumClusters() const
+{
+    return static_cast<int32_t>(cluster.size());
+}
+
+size_t PtcPathGraph::MemoryUsage() const
+{
+    size_t size = clusterOf.capacity() * sizeof(int32_t) + cluster.capacity() * sizeof(Cluster) +
+                  link.capacity() * sizeof(Link) + cost.capacity() * sizeof(float) +
+                  parent.capacity() * sizeof(int32_t) + visit.capacity() * sizeof(uint32_t) +
+                  open.capacity() * sizeof(open[0]);
+    for (const auto &[target, next] : route)
+        size += sizeof(target) + next.capacity() * sizeof(int32_t);
+    return size;
+}
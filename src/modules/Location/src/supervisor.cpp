@@ -15,6 +15,8 @@
 #include "core.h"
 #include "math_inlines.h"
 
+#include <algorithm>
+
 // ============================================================================================
 // Construction, destruction
 // ============================================================================================
@@ -25,6 +27,7 @@ Supervisor::Supervisor()
     time = 0.0f;
     waveTime = 0.0f;
     curUpdate = 0;
+    maxRadius = 0.0f;
     player = nullptr;
 }
 
@@ -44,6 +47,9 @@ void Supervisor::AddCharacter(Character *ch)
     Assert(ch);
     character.emplace_back(CharacterEx{ch, time});
     colchr.resize(character.size() * character.size());
+    // the radius switches between these two with the fight mode
+    maxRadius = std::max({maxRadius, ch->radius, ch->radiusNrm, ch->radiusFgt});
+    UpdateCell(character.size() - 1);
 }
 
 // Remove character from location
@@ -55,10 +61,31 @@ void Supervisor::DelCharacter(Character *ch)
             character[i] = character.back();
             character.pop_back();
             colchr.resize(character.size() * character.size());
+            grid.Remove(static_cast<int32_t>(character.size()));
+            if (i < character.size())
+                UpdateCell(i);
+            return;
+        }
+}
+
+// The character has been moved outside the update
+void Supervisor::MoveCharacter(Character *ch)
+{
+    for (size_t i = 0; i < character.size(); i++)
+        if (character[i].c == ch)
+        {
+            UpdateCell(i);
             return;
         }
 }
 
+// Put the character into the grid cell of its current position
+void Supervisor::UpdateCell(size_t i)
+{
+    const auto &pos = character[i].c->curPos;
+    grid.Update(static_cast<int32_t>(i), pos.x, pos.z);
+}
+
 void Supervisor::Update(float dltTime)
 {
     // If there are no characters, do nothing
@@ -70,6 +97,7 @@ void Supervisor::Update(float dltTime)
         character[i].c->Move(dltTime);
         character[i].c->colMove = 0.0f;
         character[i].c->isCollision = false;
+        UpdateCell(i);
     }
     // calculate the distances, and determine the interacting characters
     constexpr float push_ang_step = PI / 64.0f;
@@ -84,8 +112,13 @@ void Supervisor::Update(float dltTime)
         character[i].c->startColCharacter = chr;
         auto curPos(character[i].c->curPos);
         const auto radius = character[i].c->radius;
-        for (auto j = i + 1; j < character.size(); j++)
+        // only the characters near enough to interact, in the order of the full scan
+        grid.Query(curPos.x, curPos.z, (radius + maxRadius) * 4.0f, nearby);
+        for (const auto nj : nearby)
         {
+            const auto j = static_cast<size_t>(nj);
+            if (j <= i)
+                continue;
             // skip the dead
             auto *ci = character[i].c;
             auto *cj = character[j].c;
@@ -191,6 +224,8 @@ void Supervisor::Update(float dltTime)
                     cj->curPos.z -= dz * 0.9f;
                 }
             }
+            UpdateCell(i);
+            UpdateCell(j);
         }
         character[i].c->numColCharacter = chr - character[i].c->startColCharacter;
     }
@@ -200,7 +235,10 @@ void Supervisor::Update(float dltTime)
         character[i].c->Calculate(dltTime);
     // Collision of characters and setting new coordinates
     for (i = 0; i < character.size(); i++)
+    {
         character[i].c->Update(dltTime);
+        UpdateCell(i);
+    }
 }
 
 void Supervisor::PreUpdate(float dltTime) const
@@ -274,7 +312,10 @@ void Supervisor::DelSavePositions(bool isTeleport) const
 // Check for free position
 bool Supervisor::CheckPosition(float x, float y, float z, Character *c) const
 {
-    for (size_t i = 0; i < character.size(); i++)
+    // the test below compares the squared distance with 0.8 radius
+    std::vector<int32_t> cell;
+    grid.Query(x, z, sqrtf(maxRadius * 0.8f), cell);
+    for (const auto i : cell)
     {
         if (character[i].c == c)
             continue;
@@ -333,7 +374,9 @@ std::vector<Supervisor::FindCharacter> Supervisor::FindCharacters(Character *chr
     ax *= ax;
     auto testY = y + chr->height * 0.5f;
     // Viewing the characters
-    for (size_t i = 0; i < character.size(); i++)
+    std::vector<int32_t> cell;
+    grid.Query(x, z, sqrtf(radius), cell);
+    for (const auto i : cell)
     {
         // Exclude ourselves
         if (character[i].c == chr)
@@ -9,6 +9,9 @@
 // ============================================================================================
 
 #pragma once
+#include "character_grid.h"
+
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -68,6 +71,9 @@ class Supervisor
     // Find the best locator to continue walking the character
     int32_t FindForvardLocator(LocatorArray *la, const CVECTOR &pos, const CVECTOR &norm, bool lookChr = false) const;
 
+    // The character has been moved outside the update
+    void MoveCharacter(Character *ch);
+
     // --------------------------------------------------------------------------------------------
     // Encapsulation
     // --------------------------------------------------------------------------------------------
@@ -76,9 +82,16 @@ class Supervisor
     void AddCharacter(Character *ch);
     // Remove character from location
     void DelCharacter(Character *ch);
+    // Put the character into the grid cell of its current position
+    void UpdateCell(size_t i);
 
     float time, waveTime;
     int32_t curUpdate;
+    // Characters by position in xz
+    CharacterGrid grid;
+    // The largest radius a character can take, bounds the grid queries
+    float maxRadius;
+    std::vector<int32_t> nearby;
 
   public:
     std::vector<CharacterEx> character;
@@ -0,0 +1,322 @@
+#include "character_grid.h"
+
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace
+{
+struct Chr
+{
+    float x, y, z;
+    float radius;
+    float height;
+};
+
+// the characters of a location and the grid Supervisor keeps over them
+struct Crowd
+{
+    std::vector<Chr> chr;
+    CharacterGrid grid;
+    // only grows, as Supervisor::maxRadius
+    float maxRadius = 0.0f;
+
+    // Supervisor::AddCharacter
+    void Add(const Chr &c)
+    {
+        chr.push_back(c);
+        maxRadius = std::max(maxRadius, c.radius);
+        UpdateCell(chr.size() - 1);
+    }
+
+    // Supervisor::DelCharacter, the last one takes the place
+    void Del(size_t i)
+    {
+        chr[i] = chr.back();
+        chr.pop_back();
+        grid.Remove(static_cast<int32_t>(chr.size()));
+        if (i < chr.size())
+            UpdateCell(i);
+    }
+
+    void UpdateCell(size_t i)
+    {
+        grid.Update(static_cast<int32_t>(i), chr[i].x, chr[i].z);
+    }
+};
+
+// the interaction test of Supervisor::Update
+bool Interacts(const Chr &ci, const Chr &cj)
+{
+    const auto dx = ci.x - cj.x;
+    const auto dy = ci.y - cj.y;
+    const auto dz = ci.z - cj.z;
+    const auto d = dx * dx + dy * dy + dz * dz;
+    const auto rr = (ci.radius + cj.radius) * 4.0f;
+    return !(d > rr * rr);
+}
+
+// the test of Supervisor::CheckPosition
+bool Blocks(float x, float y, float z, const Chr &c)
+{
+    const auto dx = x - c.x;
+    const auto dy = y - c.y;
+    const auto dz = z - c.z;
+    if (fabsf(dy) > c.height * 0.8f)
+        return false;
+    return !(dx * dx + dz * dz > c.radius * 0.8f);
+}
+
+// the distance test of Supervisor::FindCharacters, radius is squared
+bool Within(float x, float z, float radius, const Chr &c)
+{
+    const auto dx = c.x - x;
+    const auto dz = c.z - z;
+    return !(dx * dx + dz * dz > radius);
+}
+
+// One pass of Supervisor::Update over the pairs, checked against all pairs.
+// Overlapping characters are pushed apart and their cells updated, as the supervisor does
+void CheckInteractions(Crowd &crowd)
+{
+    std::vector<int32_t> nearby;
+    std::vector<size_t> expected, found;
+    float pushAng = 0.0f;
+    for (size_t i = 0; i + 1 < crowd.chr.size(); i++)
+    {
+        const auto ci = crowd.chr[i];
+        expected.clear();
+        for (size_t j = i + 1; j < crowd.chr.size(); j++)
+            if (Interacts(ci, crowd.chr[j]))
+                expected.push_back(j);
+
+        found.clear();
+        crowd.grid.Query(ci.x, ci.z, (ci.radius + crowd.maxRadius) * 4.0f, nearby);
+        for (const auto nj : nearby)
+        {
+            const auto j = static_cast<size_t>(nj);
+            if (j > i && Interacts(ci, crowd.chr[j]))
+                found.push_back(j);
+        }
+        INFO("character " << i << " of " << crowd.chr.size() << " at " << ci.x << ", " << ci.z);
+        REQUIRE(found == expected);
+
+        for (const auto j : found)
+        {
+            auto &a = crowd.chr[i];
+            auto &b = crowd.chr[j];
+            auto dx = ci.x - b.x;
+            auto dz = ci.z - b.z;
+            auto d = dx * dx + dz * dz;
+            const auto r = (ci.radius + b.radius) * 0.5f;
+            if (!std::isfinite(d) || d >= r * r)
+                continue;
+            if (d <= 0.25f)
+            {
+                dx = 0.5f * cosf(pushAng);
+                dz = 0.5f * sinf(pushAng);
+                d = dx * dx + dz * dz;
+                pushAng += 3.14159265f / 64.0f;
+            }
+            d = sqrtf(d);
+            d = (r - d) / d;
+            a.x += dx * d * 0.5f;
+            a.z += dz * d * 0.5f;
+            b.x -= dx * d * 0.5f;
+            b.z -= dz * d * 0.5f;
+            crowd.UpdateCell(i);
+            crowd.UpdateCell(j);
+        }
+    }
+}
+
+// Supervisor::CheckPosition and FindCharacters at the point, checked against all characters
+void CheckProbes(const Crowd &crowd, float x, float y, float z, float findRadius)
+{
+    std::vector<int32_t> cell;
+    std::vector<size_t> expected, found;
+    for (size_t i = 0; i < crowd.chr.size(); i++)
+        if (Blocks(x, y, z, crowd.chr[i]))
+            expected.push_back(i);
+    crowd.grid.Query(x, z, sqrtf(crowd.maxRadius * 0.8f), cell);
+    for (const auto i : cell)
+        if (Blocks(x, y, z, crowd.chr[i]))
+            found.push_back(i);
+    INFO("check position at " << x << ", " << z);
+    CHECK(found == expected);
+
+    const auto radius = findRadius * findRadius;
+    expected.clear();
+    found.clear();
+    for (size_t i = 0; i < crowd.chr.size(); i++)
+        if (Within(x, z, radius, crowd.chr[i]))
+            expected.push_back(i);
+    crowd.grid.Query(x, z, sqrtf(radius), cell);
+    for (const auto i : cell)
+        if (Within(x, z, radius, crowd.chr[i]))
+            found.push_back(i);
+    INFO("find characters within " << findRadius << " of " << x << ", " << z);
+    CHECK(found == expected);
+}
+} // namespace
+
+TEST_CASE("Grid queries find what the full scan finds", "[character_grid]")
+{
+    std::mt19937 rng(19);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    const auto rand = [&](float lo, float hi) { return lo + (hi - lo) * unit(rng); };
+
+    // a crowd in a yard, a town square and a spread out location
+    for (const auto &[numChr, side] : {std::pair{12, 10.0f}, std::pair{150, 40.0f}, std::pair{400, 300.0f}})
+    {
+        Crowd crowd;
+        // half of them at the largest radius, so the query square is tight around their pairs
+        const auto newChr = [&] {
+            const auto radius = unit(rng) < 0.5f ? 0.6f : rand(0.2f, 0.6f);
+            return Chr{rand(-side, side), rand(-1.0f, 1.0f), rand(-side, side), radius, rand(1.5f, 2.0f)};
+        };
+        for (int32_t i = 0; i < numChr; i++)
+            crowd.Add(newChr());
+
+        for (int32_t frame = 0; frame < 60; frame++)
+        {
+            INFO("crowd of " << numChr << " over " << side << " m, frame " << frame);
+            // walk, the supervisor updates the cells after Move
+            for (size_t i = 0; i < crowd.chr.size(); i++)
+            {
+                crowd.chr[i].x += rand(-0.3f, 0.3f);
+                crowd.chr[i].z += rand(-0.3f, 0.3f);
+                crowd.UpdateCell(i);
+            }
+            // teleports, leaving and coming characters between the updates
+            for (int32_t n = 0; n < 3; n++)
+            {
+                const auto op = unit(rng);
+                if (crowd.chr.empty() || op < 0.3f)
+                {
+                    crowd.Add(newChr());
+                }
+                else
+                {
+                    const auto i = static_cast<size_t>(rng() % crowd.chr.size());
+                    if (op < 0.6f)
+                    {
+                        crowd.Del(i);
+                    }
+                    else
+                    {
+                        crowd.chr[i].x = rand(-side, side);
+                        crowd.chr[i].z = rand(-side, side);
+                        crowd.UpdateCell(i);
+                    }
+                }
+            }
+            // a larger character raises the bound of every query
+            if (frame == 30)
+            {
+                auto big = newChr();
+                big.radius = 1.5f;
+                crowd.Add(big);
+            }
+
+            CheckInteractions(crowd);
+            for (int32_t n = 0; n < 20; n++)
+                CheckProbes(crowd, rand(-side, side), rand(-1.0f, 1.0f), rand(-side, side), rand(0.0f, 20.0f));
+            // the points of the characters themselves, as CheckPosition asks for a free place next to them
+            for (size_t i = 0; i < crowd.chr.size(); i += 7)
+                CheckProbes(crowd, crowd.chr[i].x + rand(-1.0f, 1.0f), crowd.chr[i].y, crowd.chr[i].z, 3.0f);
+        }
+    }
+}
+
+TEST_CASE("Pairs at the interaction distance are found across cell borders", "[character_grid]")
+{
+    // the far character sits on a cell border and the near one a few ulps off the interaction distance,
+    // where the rounding of x + radius in the query and of the squared distance in the test may disagree
+    std::mt19937 rng(20);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    Crowd crowd;
+    for (int32_t n = 0; n < 1500; n++)
+    {
+        const auto radius = 0.2f + 0.4f * unit(rng);
+        const auto rr = (radius + 0.6f) * 4.0f;
+        const auto border = 8.0f * static_cast<float>(static_cast<int32_t>(rng() % 8) - 4);
+        const auto side = n % 2 ? 1.0f : -1.0f;
+        auto x = border - side * rr;
+        for (auto ulp = static_cast<int32_t>(rng() % 7) - 3; ulp != 0; ulp += ulp > 0 ? -1 : 1)
+            x = std::nextafter(x, ulp > 0 ? border : -side * 1.0e9f);
+        // along x or along z, the other coordinate anywhere in its cell
+        const auto other = 8.0f * static_cast<float>(static_cast<int32_t>(rng() % 200) - 100) + unit(rng) * 8.0f;
+        if (n % 4 < 2)
+        {
+            crowd.Add(Chr{x, 0.0f, other, radius, 1.8f});
+            crowd.Add(Chr{border, 0.0f, other, 0.6f, 1.8f});
+        }
+        else
+        {
+            crowd.Add(Chr{other, 0.0f, x, radius, 1.8f});
+            crowd.Add(Chr{other, 0.0f, border, 0.6f, 1.8f});
+        }
+    }
+    CheckInteractions(crowd);
+
+    // FindCharacters from a few ulps off its radius, sqrtf of the squared radius may round below the border
+    Crowd targets;
+    for (int32_t n = 0; n < 1000; n++)
+    {
+        const auto radius = 0.5f + 30.0f * unit(rng);
+        const auto border = 8.0f * static_cast<float>(static_cast<int32_t>(rng() % 8) - 4);
+        const auto side = n % 2 ? 1.0f : -1.0f;
+        auto x = border - side * radius;
+        for (auto ulp = static_cast<int32_t>(rng() % 7) - 3; ulp != 0; ulp += ulp > 0 ? -1 : 1)
+            x = std::nextafter(x, ulp > 0 ? border : -side * 1.0e9f);
+        const auto z = 8.0f * static_cast<float>(n) + 4.0f;
+        targets.Add(Chr{border, 0.0f, z, 0.6f, 1.8f});
+        CheckProbes(targets, x, 0.0f, z, radius);
+    }
+}
+
+TEST_CASE("A push moves a character into the query of a later one", "[character_grid]")
+{
+    // 0 pushes 2 from the cell at x 8..16 over the border, into the interaction distance of 1.
+    // The query of 1 ends at x 7.996, so it finds 2 only if the push updated its cell
+    Crowd crowd;
+    crowd.Add(Chr{8.56f, 0.0f, 4.0f, 0.6f, 1.8f});
+    crowd.Add(Chr{3.19f, 0.0f, 4.0f, 0.6f, 1.8f});
+    crowd.Add(Chr{8.01f, 0.0f, 4.0f, 0.6f, 1.8f});
+    REQUIRE_FALSE(Interacts(crowd.chr[1], crowd.chr[2]));
+    CheckInteractions(crowd);
+    CHECK(crowd.chr[2].x < 8.0f);
+    CHECK(Interacts(crowd.chr[1], crowd.chr[2]));
+}
+
+TEST_CASE("Far away and lost characters are found by every query", "[character_grid]")
+{
+    Crowd crowd;
+    const auto nan = std::numeric_limits<float>::quiet_NaN();
+    crowd.Add(Chr{0.0f, 0.0f, 0.0f, 0.5f, 1.8f});
+    crowd.Add(Chr{1.0f, 0.0f, 0.5f, 0.5f, 1.8f});
+    crowd.Add(Chr{nan, 0.0f, 0.0f, 0.5f, 1.8f});
+    crowd.Add(Chr{2.0e7f, 0.0f, -2.0e7f, 0.5f, 1.8f});
+    crowd.Add(Chr{2.0e7f + 1.0f, 0.0f, -2.0e7f, 0.5f, 1.8f});
+    crowd.Add(Chr{-1.0e8f, 0.0f, 1.0e8f, 0.5f, 1.8f});
+    CheckInteractions(crowd);
+    CheckProbes(crowd, 0.0f, 0.0f, 0.0f, 5.0f);
+    CheckProbes(crowd, 2.0e7f, 0.0f, -2.0e7f, 5.0f);
+    CheckProbes(crowd, nan, 0.0f, 0.0f, 5.0f);
+
+    // back to a finite position and away again
+    crowd.chr[2].x = 0.5f;
+    crowd.UpdateCell(2);
+    CheckInteractions(crowd);
+    crowd.chr[0].z = nan;
+    crowd.UpdateCell(0);
+    CheckInteractions(crowd);
+    crowd.Del(0);
+    CheckInteractions(crowd);
+    CheckProbes(crowd, 0.5f, 0.0f, 0.0f, 5.0f);
+}
@@ -0,0 +1,318 @@
+#include "ptc_data.h"
+#include "ptc_path_graph.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+// triangles, vertices and the 2-bit direction table of a patch
+struct Patch
+{
+    std::string name;
+    std::vector<PtcTriangle> triangles;
+    std::vector<PtcVertex> vertices;
+    std::vector<uint8_t> table;
+    int32_t lineSize = 0;
+
+    int32_t NumTriangles() const
+    {
+        return static_cast<int32_t>(triangles.size());
+    }
+
+    // the edge to cross from the triangle on the way to the other one, 3 if there is no way
+    uint8_t Direction(int32_t from, int32_t to) const
+    {
+        const auto *line = table.data() + static_cast<size_t>(from) * lineSize;
+        return (line[to >> 2] >> ((to & 3) * 2)) & 3;
+    }
+
+    // the edges the table crosses on the way, as PtcData::FindPathDir walked them before the graph
+    bool TableCorridor(int32_t from, int32_t to, int32_t maxSteps, std::vector<uint8_t> &edges) const
+    {
+        edges.clear();
+        for (auto cur = from; cur != to && static_cast<int32_t>(edges.size()) < maxSteps;)
+        {
+            const auto v = Direction(cur, to);
+            if (v == 3 || triangles[cur].nb[v] < 0)
+                return false;
+            edges.push_back(v);
+            cur = triangles[cur].nb[v];
+        }
+        return true;
+    }
+
+    // the triangle reached over the edges, -1 if an edge leads off the patch
+    int32_t Walk(int32_t from, const std::vector<uint8_t> &edges) const
+    {
+        auto cur = from;
+        for (const auto v : edges)
+        {
+            if (v > 2 || (cur = triangles[cur].nb[v]) < 0)
+                return -1;
+        }
+        return cur;
+    }
+
+    CVECTOR Center(int32_t trg) const
+    {
+        CVECTOR center = 0.0f;
+        for (const auto i : triangles[trg].i)
+            center += CVECTOR(vertices[i].x, vertices[i].y, vertices[i].z);
+        return center * (1.0f / 3.0f);
+    }
+};
+
+// a square grid of cells split in two triangles, some cells are walls
+Patch MakeGridPatch(int32_t size, float wallShare, uint32_t seed)
+{
+    Patch patch;
+    patch.name = "synthetic";
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    std::vector<int32_t> cellTriangle(size * size, -1);
+    for (auto &first : cellTriangle)
+    {
+        if (chance(rng) >= wallShare)
+        {
+            first = static_cast<int32_t>(patch.triangles.size());
+            patch.triangles.resize(patch.triangles.size() + 2);
+        }
+    }
+    for (int32_t z = 0; z <= size; z++)
+    {
+        for (int32_t x = 0; x <= size; x++)
+            patch.vertices.push_back(PtcVertex{x * 2.0f, 0.0f, z * 2.0f});
+    }
+
+    const auto vertex = [size](int32_t x, int32_t z) { return static_cast<unsigned short>(z * (size + 1) + x); };
+    const auto cell = [&](int32_t x, int32_t z, int32_t half) -> short {
+        if (x < 0 || z < 0 || x >= size || z >= size || cellTriangle[z * size + x] < 0)
+            return -1;
+        return static_cast<short>(cellTriangle[z * size + x] + half);
+    };
+    for (int32_t z = 0; z < size; z++)
+    {
+        for (int32_t x = 0; x < size; x++)
+        {
+            if (cellTriangle[z * size + x] < 0)
+                continue;
+            // the lower right half: bottom, right, diagonal
+            auto &lower = patch.triangles[cell(x, z, 0)];
+            lower = PtcTriangle{{vertex(x, z), vertex(x + 1, z), vertex(x + 1, z + 1)}, 0,
+                                {cell(x, z - 1, 1), cell(x + 1, z, 1), cell(x, z, 1)}, 0, 0};
+            // the upper left half: diagonal, top, left
+            auto &upper = patch.triangles[cell(x, z, 1)];
+            upper = PtcTriangle{{vertex(x, z), vertex(x + 1, z + 1), vertex(x, z + 1)}, 0,
+                                {cell(x, z, 0), cell(x, z + 1, 0), cell(x - 1, z, 0)}, 0, 0};
+        }
+    }
+
+    // the table as the patcher wrote it, fewest edges to the target
+    const auto n = patch.NumTriangles();
+    patch.lineSize = (n + 3) / 4;
+    patch.table.assign(static_cast<size_t>(n) * patch.lineSize, 0xff);
+    std::vector<int32_t> queue;
+    std::vector<bool> seen;
+    for (int32_t to = 0; to < n; to++)
+    {
+        queue.assign(1, to);
+        seen.assign(n, false);
+        seen[to] = true;
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            const auto cur = queue[head];
+            for (int32_t j = 0; j < 3; j++)
+            {
+                const auto nb = patch.triangles[cur].nb[j];
+                if (nb < 0 || seen[nb])
+                    continue;
+                seen[nb] = true;
+                queue.push_back(nb);
+                // the neighbour crosses back over its edge shared with cur
+                int32_t back = 0;
+                while (patch.triangles[nb].nb[back] != cur)
+                    back++;
+                auto &byte = patch.table[static_cast<size_t>(nb) * patch.lineSize + (to >> 2)];
+                byte = static_cast<uint8_t>((byte & ~(3 << ((to & 3) * 2))) | (back << ((to & 3) * 2)));
+            }
+        }
+    }
+    return patch;
+}
+
+// the patches of the game resources, their folder is given by STORM_PTC_DIR
+std::vector<Patch> LoadPatches()
+{
+    std::vector<Patch> patches;
+    const char *folder = std::getenv("STORM_PTC_DIR");
+    std::error_code ec;
+    if (folder == nullptr || !std::filesystem::is_directory(folder, ec))
+        return patches;
+    for (const auto &entry : std::filesystem::recursive_directory_iterator(folder, ec))
+    {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != ".ptc")
+            continue;
+        std::ifstream file(entry.path(), std::ios::binary);
+        PtcHeader hdr{};
+        file.read(reinterpret_cast<char *>(&hdr), sizeof(hdr));
+        // patches without a table have nothing to compare against
+        if (!file || hdr.id != PTC_ID || hdr.numTriangles < 1 || hdr.lineSize < (hdr.numTriangles + 3) / 4)
+            continue;
+        Patch patch;
+        patch.name = entry.path().filename().string();
+        patch.lineSize = hdr.lineSize;
+        patch.triangles.resize(hdr.numTriangles);
+        patch.vertices.resize(hdr.numVerteces);
+        patch.table.resize(static_cast<size_t>(hdr.lineSize) * hdr.numTriangles);
+        file.read(reinterpret_cast<char *>(patch.triangles.data()), patch.triangles.size() * sizeof(PtcTriangle));
+        file.read(reinterpret_cast<char *>(patch.vertices.data()), patch.vertices.size() * sizeof(PtcVertex));
+        file.seekg(hdr.numNormals * sizeof(PtcNormal) + hdr.mapL * hdr.mapW * sizeof(PtcMap) +
+                       hdr.numIndeces * sizeof(uint16_t),
+                   std::ios::cur);
+        file.read(reinterpret_cast<char *>(patch.table.data()), patch.table.size());
+        if (file)
+            patches.push_back(std::move(patch));
+    }
+    return patches;
+}
+
+std::vector<std::pair<int32_t, int32_t>> MakeQueries(const Patch &patch, size_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int32_t> trg(0, patch.NumTriangles() - 1);
+    std::vector<std::pair<int32_t, int32_t>> queries(count);
+    for (auto &[from, to] : queries)
+    {
+        from = trg(rng);
+        to = trg(rng);
+    }
+    return queries;
+}
+
+float CorridorLength(const Patch &patch, int32_t from, const std::vector<uint8_t> &edges)
+{
+    float length = 0.0f;
+    auto cur = from;
+    for (const auto v : edges)
+    {
+        const auto next = patch.triangles[cur].nb[v];
+        length += sqrtf(~(patch.Center(next) - patch.Center(cur)));
+        cur = next;
+    }
+    return length;
+}
+
+// the graph finds a way wherever the table does and its corridors lead where they should
+void CheckAgainstTable(const Patch &patch, size_t numQueries)
+{
+    PtcPathGraph graph;
+    graph.Build(patch.triangles.data(), patch.NumTriangles(), patch.vertices.data());
+    std::vector<uint8_t> tableEdges, graphEdges;
+    for (const auto &[from, to] : MakeQueries(patch, numQueries, 3))
+    {
+        const auto isTableWay = patch.TableCorridor(from, to, patch.NumTriangles(), tableEdges);
+        const auto isGraphWay =
+            graph.FindCorridor(from, to, patch.Center(to), patch.NumTriangles(), graphEdges);
+        INFO(patch.name << ": " << from << " -> " << to);
+        REQUIRE(isGraphWay == isTableWay);
+        if (isGraphWay)
+            CHECK(patch.Walk(from, graphEdges) == to);
+        // a window of the corridor ends where the same number of steps lead
+        REQUIRE(graph.FindCorridor(from, to, patch.Center(to), PTCDATA_MAXSTEPS, graphEdges) == isTableWay);
+        if (isTableWay)
+            CHECK(patch.Walk(from, graphEdges) >= 0);
+    }
+}
+
+void ComparePatch(const Patch &patch)
+{
+    const auto n = patch.NumTriangles();
+    const auto queries = MakeQueries(patch, 1000, 9);
+
+    PtcPathGraph graph;
+    const auto buildStart = std::chrono::steady_clock::now();
+    graph.Build(patch.triangles.data(), n, patch.vertices.data());
+    const std::chrono::duration<double, std::milli> buildTime = std::chrono::steady_clock::now() - buildStart;
+
+    // full corridors, how often the graph crosses the same edges and how much longer its way is
+    size_t numWays = 0, numSame = 0;
+    double tableLength = 0.0, graphLength = 0.0;
+    std::vector<uint8_t> tableEdges, graphEdges;
+    for (const auto &[from, to] : queries)
+    {
+        if (!patch.TableCorridor(from, to, n, tableEdges) ||
+            !graph.FindCorridor(from, to, patch.Center(to), n, graphEdges))
+            continue;
+        numWays++;
+        numSame += tableEdges == graphEdges;
+        tableLength += CorridorLength(patch, from, tableEdges);
+        graphLength += CorridorLength(patch, from, graphEdges);
+    }
+    WARN(patch.name << ": " << n << " triangles, " << graph.NumClusters() << " clusters built in " << buildTime.count()
+                    << " ms; graph " << graph.MemoryUsage() << " bytes against a table of " << patch.table.size()
+                    << " bytes; " << numSame << " of " << numWays << " corridors the same, graph ways "
+                    << (tableLength > 0.0 ? graphLength / tableLength : 1.0) << " times as long");
+
+    BENCHMARK(patch.name + ": table, " + std::to_string(PTCDATA_MAXSTEPS) + " steps")
+    {
+        size_t steps = 0;
+        for (const auto &[from, to] : queries)
+        {
+            patch.TableCorridor(from, to, PTCDATA_MAXSTEPS, tableEdges);
+            steps += tableEdges.size();
+        }
+        return steps;
+    };
+
+    BENCHMARK(patch.name + ": graph, " + std::to_string(PTCDATA_MAXSTEPS) + " steps")
+    {
+        size_t steps = 0;
+        for (const auto &[from, to] : queries)
+        {
+            graph.FindCorridor(from, to, patch.Center(to), PTCDATA_MAXSTEPS, graphEdges);
+            steps += graphEdges.size();
+        }
+        return steps;
+    };
+
+    BENCHMARK(patch.name + ": graph build")
+    {
+        PtcPathGraph built;
+        built.Build(patch.triangles.data(), n, patch.vertices.data());
+        return built.NumClusters();
+    };
+}
+} // namespace
+
+TEST_CASE("Path graph finds the ways of the direction table", "[ptc_path_graph]")
+{
+    // open ground, a maze of walls and islands cut off from each other
+    for (const auto wallShare : {0.0f, 0.2f, 0.4f})
+        CheckAgainstTable(MakeGridPatch(32, wallShare, 1), 500);
+}
+
+TEST_CASE("Path graph finds the ways of the shipped patches", "[ptc_path_graph]")
+{
+    for (const auto &patch : LoadPatches())
+        CheckAgainstTable(patch, 200);
+}
+
+TEST_CASE("Path graph against the direction table", "[ptc_path_graph][benchmark]")
+{
+    auto patches = LoadPatches();
+    // without the game resources a large synthetic patch stands in for them
+    if (patches.empty())
+        patches.push_back(MakeGridPatch(96, 0.2f, 2));
+    for (const auto &patch : patches)
+        ComparePatch(patch);
+}
@@ -219,6 +219,7 @@ void MODELR::Realize(uint32_t Delta_Time)
 
     CVECTOR tmp;
     root->Update(mtx, tmp);
+    BoundsChanged();
 
     // if have animation - special render
     if (ani)
@@ -363,6 +364,7 @@ uint64_t MODELR::ProcessMessage(MESSAGE &message)
         }
         // CVECTOR tmp;
         root->Update(mtx, tmp);
+        BoundsChanged();
         return 1;
         // UNGUARD
         break;
@@ -462,6 +464,7 @@ void MODELR::Update()
 {
     CVECTOR tmp;
     static_cast<NODER *>(root)->Update(mtx, tmp);
+    BoundsChanged();
 }
 
 //-------------------------------------------------------------------
@@ -669,6 +672,29 @@ float MODELR::Trace(const CVECTOR &src, const CVECTOR &dst)
     return d;
 }
 
+//-------------------------------------------------------------------
+// skinned trace goes through shared vertex scratch and lazily locks the index buffer
+bool MODELR::IsTraceThreadSafe() const
+{
+    return ani == nullptr && root != nullptr;
+}
+
+float MODELR::TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const
+{
+    if (!IsTraceThreadSafe())
+        return 2.0f;
+    return root->TraceThreadSafe(src, dst);
+}
+
+bool MODELR::GetBoundSphere(CVECTOR &center, float &radius) const
+{
+    if (root == nullptr)
+        return false;
+    center = root->glob_mtx * root->center;
+    radius = root->radius;
+    return true;
+}
+
 //-------------------------------------------------------------------
 NODE *MODELR::GetCollideNode()
 {
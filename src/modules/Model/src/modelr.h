@@ -41,6 +41,7 @@ class NODER final : public NODE
     ~NODER() override;
     void Draw();
     float Trace(const CVECTOR &src, const CVECTOR &dst) override;
+    float TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const;
     NODER *GetNode(int32_t n);
     NODER *FindNode(const char *cNodeName);
     float Update(CMatrix &mtx, CVECTOR &cnt);
@@ -109,6 +110,9 @@ class MODELR final : public MODEL
     Animation *GetAnimation() override;
 
     float Trace(const CVECTOR &src, const CVECTOR &dst) override;
+    bool IsTraceThreadSafe() const override;
+    float TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const override;
+    bool GetBoundSphere(CVECTOR &center, float &radius) const override;
     const char *GetCollideMaterialName() override;
     bool GetCollideTriangle(TRIANGLE &triangle) override;
     bool Clip(const PLANE *planes, int32_t nplanes, const CVECTOR &center, float radius,
@@ -6,6 +6,8 @@
 #include "string_compare.hpp"
 #include <storm/editor/storm_imgui.hpp>
 
+#include <algorithm>
+
 VGEOMETRY *NODER::gs = nullptr;
 VDX9RENDER *NODER::rs = nullptr;
 int32_t NODER::depth = -1;
@@ -162,6 +164,39 @@ float NODER::Trace(const CVECTOR &src, const CVECTOR &dst)
     return best_dist;
 }
 
+float NODER::TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const
+{
+    if (isReleased)
+        return 2.0f;
+    // check for bounding spheres intersection
+    const auto lmn = dst - src;
+    const auto dist2ray2 = ~((glob_mtx * center - src) ^ lmn);
+    const auto dlmn = ~(lmn);
+    // hierarchy test
+    if (dist2ray2 > dlmn * radius * radius)
+        return 2.0f;
+
+    auto best_dist = 2.0f;
+
+    if (flags & TRACE_ENABLE_TREE)
+        for (const auto *child : next)
+        {
+            if (child == nullptr)
+                continue;
+            best_dist = std::min(best_dist, static_cast<const NODER *>(child)->TraceThreadSafe(src, dst));
+        }
+
+    if (flags & TRACE_ENABLE && dist2ray2 < dlmn * geo_radius * geo_radius)
+    {
+        CVECTOR _src, _dst;
+        glob_mtx.MulToInv(src, _src);
+        glob_mtx.MulToInv(dst, _dst);
+        int32_t face;
+        best_dist = std::min(best_dist, geo->Trace((const GEOS::VERTEX &)_src, (const GEOS::VERTEX &)_dst, face));
+    }
+    return best_dist;
+}
+
 //----------------------------------------------------------
 // NODE constructor
 //----------------------------------------------------------
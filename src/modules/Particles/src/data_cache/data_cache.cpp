@@ -36,25 +36,18 @@ void DataCache::CacheSystem(const char *FileName)
     std::transform(pathStr.begin(), pathStr.end(), pathStr.begin(), tolower);
     // MessageBoxA(NULL, (LPCSTR)path.c_str(), "", MB_OK); //~!~
 
-    auto sysFile = fio->_CreateFile(pathStr.c_str(), std::ios::binary | std::ios::in);
-
-    if (!sysFile.is_open())
+    char *pMemBuffer = nullptr;
+    uint32_t FileSize = 0;
+    if (!fio->LoadFile(pathStr.c_str(), &pMemBuffer, &FileSize))
     {
         core.Trace("Particles: '%s' File not found !!!", pathStr.c_str());
         return;
     }
 
-    const auto FileSize = fio->_GetFileSize(pathStr.c_str());
-
-    auto *pMemBuffer = new uint8_t[FileSize];
-    fio->_ReadFile(sysFile, pMemBuffer, FileSize);
-
     // Create data from file ...
     CreateDataSource(pMemBuffer, FileSize, pathStr.c_str());
 
     delete[] pMemBuffer;
-
-    fio->_CloseFile(sysFile);
 }
 
 // Reset cache
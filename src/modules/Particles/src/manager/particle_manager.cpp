@@ -112,7 +112,13 @@ bool ParticleManager::OpenProject(const char *FileName)
     auto path = std::filesystem::path() / "resource" / "particles" / FileName;
     path.replace_extension(".prf");
 
-    auto config = Config::Load(path);
+    // the project may be packed
+    const auto file = fio->_MapFile(path.string().c_str());
+    if (!file.IsOpen())
+    {
+        core.Trace("Can't open particles project %s", path.string().c_str());
+    }
+    auto config = Config::Parse(std::string_view(file.Data(), file.Size()), path);
     std::ignore = config.SelectSection("Textures");
 
     SetProjectTexture(config.Get<std::string>("MainTexture", "none").c_str());
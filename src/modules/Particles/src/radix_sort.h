@@ -0,0 +1,54 @@
+//****************************************************************
+//*
+//*  description: LSD radix sort of values by integer keys
+//*
+//****************************************************************
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Stable sort of Values by the low KeyBits bits of Keys, ascending, one 8 bit digit per pass.
+// TmpKeys and TmpValues are scratch, all the vectors keep their capacity between calls
+template <uint32_t KeyBits, class TYPE>
+void RadixSort(std::vector<uint32_t> &Keys, std::vector<TYPE> &Values, std::vector<uint32_t> &TmpKeys,
+               std::vector<TYPE> &TmpValues)
+{
+    static_assert(KeyBits > 0 && KeyBits <= 32 && KeyBits % 8 == 0);
+
+    const auto Count = Keys.size();
+    if (Count < 2)
+        return;
+    TmpKeys.resize(Count);
+    TmpValues.resize(Count);
+
+    for (uint32_t Shift = 0; Shift < KeyBits; Shift += 8)
+    {
+        uint32_t Offsets[256] = {};
+        for (const auto Key : Keys)
+            Offsets[(Key >> Shift) & 0xFF]++;
+
+        // all the keys have the same digit, nothing to move
+        if (Offsets[(Keys[0] >> Shift) & 0xFF] == Count)
+            continue;
+
+        uint32_t Sum = 0;
+        for (auto &Offset : Offsets)
+        {
+            const auto DigitCount = Offset;
+            Offset = Sum;
+            Sum += DigitCount;
+        }
+
+        for (size_t n = 0; n < Count; n++)
+        {
+            const auto Dst = Offsets[(Keys[n] >> Shift) & 0xFF]++;
+            TmpKeys[Dst] = Keys[n];
+            TmpValues[Dst] = std::move(Values[n]);
+        }
+        Keys.swap(TmpKeys);
+        Values.swap(TmpValues);
+    }
+}
@@ -3,6 +3,8 @@
 #include "../../i_common/types.h"
 #include "vma.hpp"
 
+#include <algorithm>
+
 #pragma warning(disable : 4800)
 
 extern uint32_t GraphRead;
@@ -28,13 +30,35 @@ float RandomRange(float Min, float Max)
     return Rand + Min;
 }
 
+// Value of the graph at this time, 0 past its last vertex
+static float SampleGraph(const std::vector<GraphVertex> &Graph, float Time)
+{
+    if (Graph.size() < 2 || !(Time <= Graph.back().Time))
+        return 0.0f;
+
+    // The first segment that ends at or after this time
+    const auto To = std::lower_bound(Graph.begin() + 1, Graph.end(), Time,
+                                     [](const GraphVertex &Vertex, float Value) { return Vertex.Time < Value; });
+    const auto From = To - 1;
+
+    const auto SegmentDeltaTime = To->Time - From->Time;
+    const auto ValueDeltaTime = Time - From->Time;
+    float blend_k;
+    if (SegmentDeltaTime > 0.001f)
+        blend_k = ValueDeltaTime / SegmentDeltaTime;
+    else
+        blend_k = 0.0f;
+
+    return Lerp(From->Val, To->Val, blend_k);
+}
+
 // constructor / destructor
 DataGraph::DataGraph()
 {
     bRelative = false;
     bNegative = false;
 
-    ResetCachedTime();
+    Bake();
 }
 
 DataGraph::~DataGraph()
@@ -59,7 +83,7 @@ void DataGraph::SetValues(const GraphVertex *MinValues, uint32_t MinValuesSize,
         MaxGraph.push_back(MaxValues[n]);
     }
 
-    ResetCachedTime();
+    Bake();
 }
 
 // Set the "default"
@@ -83,7 +107,7 @@ void DataGraph::SetDefaultValue(float MaxValue, float MinValue)
     Max.Time = MAX_GRAPH_TIME;
     MaxGraph.push_back(Max);
 
-    ResetCachedTime();
+    Bake();
 }
 
 // Get the count in the minimum graph
@@ -110,10 +134,35 @@ const GraphVertex &DataGraph::GetMaxVertex(uint32_t Index)
     return MaxGraph[Index];
 }
 
-void DataGraph::ResetCachedTime()
-{
-    MaxCachedTime = NOT_INITED_CACHE_VALUE;
-    MinCachedTime = NOT_INITED_CACHE_VALUE;
+void DataGraph::Bake()
+{
+    Baked.clear();
+    if (MinGraph.size() < 2 || MaxGraph.size() < 2)
+        return;
+
+    // The closing vertex at MAX_GRAPH_TIME only holds the value, times past the last key are looked up directly.
+    // A graph without it drops to 0 after its last vertex, that step must not be smoothed
+    const auto LastKey = [](const std::vector<GraphVertex> &Graph) {
+        const auto &Last = Graph.back();
+        return Last.Time < MAX_GRAPH_TIME ? Last.Time : Graph[Graph.size() - 2].Time;
+    };
+    const auto End = [](const std::vector<GraphVertex> &Graph) {
+        const auto &Last = Graph.back();
+        return Last.Time < MAX_GRAPH_TIME ? Last.Time : MAX_GRAPH_TIME;
+    };
+    BakedStart = std::min(MinGraph.front().Time, MaxGraph.front().Time);
+    BakedEnd = std::min({std::max(LastKey(MinGraph), LastKey(MaxGraph)), End(MinGraph), End(MaxGraph)});
+    if (!(BakedEnd > BakedStart))
+        return;
+    BakedScale = BAKED_SIZE / (BakedEnd - BakedStart);
+
+    Baked.resize(BAKED_SIZE + 1);
+    for (uint32_t n = 0; n <= BAKED_SIZE; n++)
+    {
+        const auto Time = Lerp(BakedStart, BakedEnd, static_cast<float>(n) / BAKED_SIZE);
+        Baked[n].Min = SampleGraph(MinGraph, Time);
+        Baked[n].Max = SampleGraph(MaxGraph, Time);
+    }
 }
 
 void DataGraph::Load(MemFile *File)
@@ -183,6 +232,7 @@ void DataGraph::Load(MemFile *File)
     // core.Trace("Name %s", AttribueName);
 
     SetName(AttribueName);
+    Bake();
 
     // HACK! For backward compatibility
     // convert after loading the graphs into the desired format
@@ -244,107 +294,47 @@ void DataGraph::MultiplyBy(float Val)
 
     for (n = 0; n < MinGraph.size(); n++)
         MinGraph[n].Val *= Val;
+
+    Bake();
 }
 
-float DataGraph::GetMinAtTime(float Time, float LifeTime)
+void DataGraph::GetMinMaxAtTime(float Time, float LifeTime, float &Min, float &Max) const
 {
     if (bRelative)
         Time = Time / LifeTime * 100.0f;
 
-    const uint32_t Count = MinGraph.size();
-    uint32_t Index;
-    if (MinCachedTime < Time)
-        Index = MinCachedIndex;
-    else
-        Index = 0;
-
-    for (; Index < (Count - 1); Index++)
+    if (!Baked.empty() && Time >= BakedStart && Time < BakedEnd)
     {
-        const auto ToTime = MinGraph[Index + 1].Time;
-
-        // If the time is in the correct range
-        // if ((Time >= FromTime) && (Time <= ToTime))
-        if (Time <= ToTime)
-        {
-            const auto FromTime = MinGraph[Index].Time;
-
-            const auto SegmentDeltaTime = ToTime - FromTime;
-            const auto ValueDeltaTime = Time - FromTime;
-            float blend_k;
-            if (SegmentDeltaTime > 0.001f)
-                blend_k = ValueDeltaTime / SegmentDeltaTime;
-            else
-                blend_k = 0.0f;
-
-            const auto ValueFirst = MinGraph[Index].Val;
-            const auto ValueSecond = MinGraph[Index + 1].Val;
-
-            MinCachedTime = Time;
-            MinCachedIndex = Index;
-            return Lerp(ValueFirst, ValueSecond, blend_k);
-        }
+        const auto Pos = (Time - BakedStart) * BakedScale;
+        const auto Index = std::min(static_cast<uint32_t>(Pos), BAKED_SIZE - 1);
+        const auto blend_k = Pos - static_cast<float>(Index);
+        Min = Lerp(Baked[Index].Min, Baked[Index + 1].Min, blend_k);
+        Max = Lerp(Baked[Index].Max, Baked[Index + 1].Max, blend_k);
+        return;
     }
 
-    return 0.0f;
+    Min = SampleGraph(MinGraph, Time);
+    Max = SampleGraph(MaxGraph, Time);
 }
 
-float DataGraph::GetMaxAtTime(float Time, float LifeTime)
+float DataGraph::GetValue(float Time, float LifeTime, float K_rand) const
 {
-    if (bRelative)
-        Time = Time / LifeTime * 100.0f;
-
-    const uint32_t Count = MaxGraph.size();
-
-    uint32_t Index;
-
-    if (MaxCachedTime < Time)
-        Index = MaxCachedIndex;
-    else
-        Index = 0;
-
-    for (; Index < (Count - 1); Index++)
-    {
-        const auto ToTime = MaxGraph[Index + 1].Time;
-
-        // If the time is in the correct range
-        // if ((Time >= FromTime) && (Time <= ToTime))
-        if (Time <= ToTime)
-        {
-            const auto FromTime = MaxGraph[Index].Time;
-
-            const auto SegmentDeltaTime = ToTime - FromTime;
-            const auto ValueDeltaTime = Time - FromTime;
-            float blend_k;
-            if (SegmentDeltaTime > 0.001f)
-                blend_k = ValueDeltaTime / SegmentDeltaTime;
-            else
-                blend_k = 0.0f;
-
-            const auto ValueFirst = MaxGraph[Index].Val;
-            const auto ValueSecond = MaxGraph[Index + 1].Val;
-
-            MaxCachedTime = Time;
-            MaxCachedIndex = Index;
-            return Lerp(ValueFirst, ValueSecond, blend_k);
-        }
-    }
-
-    return 0.0f;
+    GraphRead++;
+    return Sample(Time, LifeTime, K_rand);
 }
 
-float DataGraph::GetValue(float Time, float LifeTime, float K_rand)
+float DataGraph::Sample(float Time, float LifeTime, float K_rand) const
 {
-    GraphRead++;
-    const auto pMax = GetMaxAtTime(Time, LifeTime);
-    const auto pMin = GetMinAtTime(Time, LifeTime);
+    float pMin, pMax;
+    GetMinMaxAtTime(Time, LifeTime, pMin, pMax);
     return Lerp(pMin, pMax, K_rand);
 }
 
-float DataGraph::GetRandomValue(float Time, float LifeTime)
+float DataGraph::GetRandomValue(float Time, float LifeTime) const
 {
     GraphRead++;
-    const auto pMax = GetMaxAtTime(Time, LifeTime);
-    const auto pMin = GetMinAtTime(Time, LifeTime);
+    float pMin, pMax;
+    GetMinMaxAtTime(Time, LifeTime, pMin, pMax);
     return RandomRange(pMin, pMax);
 }
 
@@ -366,6 +356,8 @@ void DataGraph::Clamp(float MinValue, float MaxValue)
         if (MinGraph[n].Val < MinValue)
             MinGraph[n].Val = MinValue;
     }
+
+    Bake();
 }
 
 void DataGraph::Reverse()
@@ -376,6 +368,8 @@ void DataGraph::Reverse()
 
     for (n = 0; n < MinGraph.size(); n++)
         MinGraph[n].Val = 1.0f - MinGraph[n].Val;
+
+    Bake();
 }
 
 void DataGraph::NormalToPercent()
@@ -8,22 +8,32 @@
 
 class DataGraph
 {
-    std::string Name;
+    // Resolution of the baked graphs
+    static constexpr uint32_t BAKED_SIZE = 256;
+
+    struct BakedValue
+    {
+        float Min;
+        float Max;
+    };
 
-    // when was the last time the value was read
-    float MaxCachedTime;
-    float MinCachedTime;
-    // What was the index of this time
-    uint32_t MaxCachedIndex;
-    uint32_t MinCachedIndex;
+    std::string Name;
 
     std::vector<GraphVertex> MinGraph;
     std::vector<GraphVertex> MaxGraph;
 
-    void ResetCachedTime();
+    // Both graphs sampled at BAKED_SIZE + 1 evenly spaced times from BakedStart to BakedEnd,
+    // empty if there is nothing to bake
+    std::vector<BakedValue> Baked;
+    float BakedStart;
+    float BakedEnd;
+    float BakedScale;
+
+    // Rebuild Baked, called whenever the graphs change
+    void Bake();
 
-    float GetMinAtTime(float Time, float LifeTime);
-    float GetMaxAtTime(float Time, float LifeTime);
+    // Values of both graphs at this time
+    void GetMinMaxAtTime(float Time, float LifeTime, float &Min, float &Max) const;
 
     bool bRelative;
     bool bNegative;
@@ -42,8 +52,10 @@ class DataGraph
     bool GetRelative() const;
 
     // Get value (Current time, Random factor [0..1])
-    float GetValue(float Time, float LifeTime, float K_rand);
-    float GetRandomValue(float Time, float LifeTime);
+    float GetValue(float Time, float LifeTime, float K_rand) const;
+    // GetValue that is not counted in GraphRead, safe to call from worker threads
+    float Sample(float Time, float LifeTime, float K_rand) const;
+    float GetRandomValue(float Time, float LifeTime) const;
 
     // Set values
     void SetValues(const GraphVertex *MinValues, uint32_t MinValuesSize, const GraphVertex *MaxValues,
@@ -0,0 +1,156 @@
+#include "bb_particles.h"
+
+#include "../data_source/data_graph.h"
+
+#include <emmintrin.h>
+
+// "Kill" the particle
+void BillBoardParticles::Free(uint32_t n)
+{
+    *(ActiveCount[n]) = (*(ActiveCount[n]) - 1);
+
+    const auto last = --Count;
+    if (n == last)
+        return;
+
+    ElapsedTime[n] = ElapsedTime[last];
+    LifeTime[n] = LifeTime[last];
+    PhysPosX[n] = PhysPosX[last];
+    PhysPosY[n] = PhysPosY[last];
+    PhysPosZ[n] = PhysPosZ[last];
+    VelocityX[n] = VelocityX[last];
+    VelocityY[n] = VelocityY[last];
+    VelocityZ[n] = VelocityZ[last];
+    Mass[n] = Mass[last];
+    UMass[n] = UMass[last];
+    Angle[n] = Angle[last];
+    Spin[n] = Spin[last];
+    RenderPosX[n] = RenderPosX[last];
+    RenderPosY[n] = RenderPosY[last];
+    RenderPosZ[n] = RenderPosZ[last];
+    OldRenderPosX[n] = OldRenderPosX[last];
+    OldRenderPosY[n] = OldRenderPosY[last];
+    OldRenderPosZ[n] = OldRenderPosZ[last];
+    OldRenderAngle[n] = OldRenderAngle[last];
+    for (auto &w : World)
+        w[n] = w[last];
+
+    DragK[n] = DragK[last];
+    SpinDragK[n] = SpinDragK[last];
+    SizeK[n] = SizeK[last];
+    ColorK[n] = ColorK[last];
+    AlphaK[n] = AlphaK[last];
+    FrameK[n] = FrameK[last];
+    GravKK[n] = GravKK[last];
+    AddPowerK[n] = AddPowerK[last];
+    KTrackX[n] = KTrackX[last];
+    KTrackY[n] = KTrackY[last];
+    KTrackZ[n] = KTrackZ[last];
+    KPhysBlend[n] = KPhysBlend[last];
+
+    CamDistance[n] = CamDistance[last];
+    Graphs[n] = Graphs[last];
+    ActiveCount[n] = ActiveCount[last];
+    AttachedEmitter[n] = AttachedEmitter[last];
+    EmitterGUID[n] = EmitterGUID[last];
+    SpeedOriented[n] = SpeedOriented[last];
+}
+
+// SolvePhysic, AddGravityForce, spin and track blend of 4 particles at once
+void BillBoardParticles::ProcessBlock(uint32_t n, float DeltaTime)
+{
+    // the arrays through p, the locals share their names
+    auto &p = *this;
+    const auto zero = _mm_setzero_ps();
+    const auto one = _mm_set1_ps(1.0f);
+    const auto percent = _mm_set1_ps(0.01f);
+    const auto dt = _mm_set1_ps(DeltaTime);
+    const auto clamp01 = [&](__m128 v) { return _mm_min_ps(_mm_max_ps(v, zero), one); };
+
+    // Physics
+    const auto Drag = clamp01(_mm_sub_ps(one, _mm_mul_ps(_mm_load_ps(&p.Drag[n]), percent)));
+    const auto GravK = clamp01(_mm_mul_ps(_mm_load_ps(&p.GravK[n]), percent));
+    const auto UMass = _mm_load_ps(&p.UMass[n]);
+    const auto Force = _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(-9.8f), _mm_load_ps(&p.Mass[n])), GravK);
+    // No acceleration for massless particles
+    const auto Acceleration = _mm_and_ps(_mm_div_ps(Force, UMass), _mm_cmpneq_ps(UMass, zero));
+
+    const auto VelocityX = _mm_load_ps(&p.VelocityX[n]);
+    const auto VelocityY = _mm_add_ps(_mm_load_ps(&p.VelocityY[n]), _mm_mul_ps(Acceleration, dt));
+    const auto VelocityZ = _mm_load_ps(&p.VelocityZ[n]);
+    _mm_store_ps(&p.VelocityY[n], VelocityY);
+
+    const auto Step = _mm_mul_ps(Drag, dt);
+    const auto PhysPosX = _mm_add_ps(_mm_load_ps(&p.PhysPosX[n]), _mm_mul_ps(VelocityX, Step));
+    const auto PhysPosY = _mm_add_ps(_mm_load_ps(&p.PhysPosY[n]), _mm_mul_ps(VelocityY, Step));
+    const auto PhysPosZ = _mm_add_ps(_mm_load_ps(&p.PhysPosZ[n]), _mm_mul_ps(VelocityZ, Step));
+
+    // Spin
+    const auto SpinDrag = clamp01(_mm_sub_ps(one, _mm_mul_ps(_mm_load_ps(&p.SpinDrag[n]), percent)));
+    _mm_store_ps(&p.Angle[n],
+                 _mm_add_ps(_mm_load_ps(&p.Angle[n]), _mm_mul_ps(_mm_mul_ps(_mm_load_ps(&p.Spin[n]), SpinDrag), dt)));
+
+    // Track, Matrix::MulVertex
+    const auto TrackX = _mm_load_ps(&p.TrackX[n]);
+    const auto TrackY = _mm_load_ps(&p.TrackY[n]);
+    const auto TrackZ = _mm_load_ps(&p.TrackZ[n]);
+    __m128 TrackPos[3];
+    for (uint32_t col = 0; col < 3; col++)
+    {
+        TrackPos[col] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_load_ps(&p.World[col][n]), TrackX),
+                                              _mm_mul_ps(_mm_load_ps(&p.World[3 + col][n]), TrackY)),
+                                   _mm_add_ps(_mm_mul_ps(_mm_load_ps(&p.World[6 + col][n]), TrackZ),
+                                              _mm_load_ps(&p.World[9 + col][n])));
+    }
+
+    const auto BlendPhys = clamp01(_mm_sub_ps(one, _mm_mul_ps(_mm_load_ps(&p.PhysBlend[n]), dt)));
+
+    // Save old positions, the new one is between the track and the physics
+    _mm_store_ps(&p.OldRenderPosX[n], _mm_load_ps(&p.RenderPosX[n]));
+    _mm_store_ps(&p.OldRenderPosY[n], _mm_load_ps(&p.RenderPosY[n]));
+    _mm_store_ps(&p.OldRenderPosZ[n], _mm_load_ps(&p.RenderPosZ[n]));
+
+    const auto RenderPosX = _mm_add_ps(TrackPos[0], _mm_mul_ps(_mm_sub_ps(PhysPosX, TrackPos[0]), BlendPhys));
+    const auto RenderPosY = _mm_add_ps(TrackPos[1], _mm_mul_ps(_mm_sub_ps(PhysPosY, TrackPos[1]), BlendPhys));
+    const auto RenderPosZ = _mm_add_ps(TrackPos[2], _mm_mul_ps(_mm_sub_ps(PhysPosZ, TrackPos[2]), BlendPhys));
+    _mm_store_ps(&p.RenderPosX[n], RenderPosX);
+    _mm_store_ps(&p.RenderPosY[n], RenderPosY);
+    _mm_store_ps(&p.RenderPosZ[n], RenderPosZ);
+    _mm_store_ps(&p.PhysPosX[n], RenderPosX);
+    _mm_store_ps(&p.PhysPosY[n], RenderPosY);
+    _mm_store_ps(&p.PhysPosZ[n], RenderPosZ);
+}
+
+void BillBoardParticles::Process(float DeltaTime)
+{
+    auto &p = *this;
+
+    // Age the particles, immediately kill the dead and gather the graph values of the rest
+    for (uint32_t n = 0; n < p.Count; n++)
+    {
+        p.ElapsedTime[n] += DeltaTime;
+
+        const auto Time = p.ElapsedTime[n];
+        const auto LifeTime = p.LifeTime[n];
+
+        if (Time > LifeTime)
+        {
+            Free(n);
+            n--;
+            continue;
+        }
+
+        const auto &Graphs = p.Graphs[n];
+        p.Drag[n] = Graphs.Drag->GetValue(Time, LifeTime, p.DragK[n]);
+        p.GravK[n] = Graphs.GravK->GetValue(Time, LifeTime, p.GravKK[n]);
+        p.SpinDrag[n] = Graphs.SpinDrag->GetValue(Time, LifeTime, p.SpinDragK[n]);
+        p.TrackX[n] = Graphs.TrackX->GetValue(Time, LifeTime, p.KTrackX[n]);
+        p.TrackY[n] = Graphs.TrackY->GetValue(Time, LifeTime, p.KTrackY[n]);
+        p.TrackZ[n] = Graphs.TrackZ->GetValue(Time, LifeTime, p.KTrackZ[n]);
+        p.PhysBlend[n] = Graphs.PhysBlend->GetValue(Time, LifeTime, p.KPhysBlend[n]);
+    }
+
+    // The last block may run over dead slots, nobody reads them
+    for (uint32_t n = 0; n < p.Count; n += 4)
+        ProcessBlock(n, DeltaTime);
+}
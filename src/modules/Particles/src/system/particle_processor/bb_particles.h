@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+
+class DataGraph;
+class DataColor;
+class DataUV;
+class IEmitter;
+
+// How many billboards can there be
+#define MAX_BILLBOARDS 4096
+
+// Billboards as structure of arrays, the alive ones are packed at [0, Count).
+// The arrays are padded to whole SIMD blocks so Process never needs a scalar tail
+struct BillBoardParticles
+{
+    // Graphs of a particle
+    struct ParticleGraphs
+    {
+        DataGraph *SpinDrag;
+        DataGraph *Drag;
+        DataGraph *Size;
+        DataGraph *Frames;
+        DataColor *Color;
+        DataUV *UV;
+        DataGraph *Transparency;
+        DataGraph *TrackX;
+        DataGraph *TrackY;
+        DataGraph *TrackZ;
+        DataGraph *PhysBlend;
+        DataGraph *GravK;
+        DataGraph *AddPower;
+    };
+
+    // Lifetime and how long did it live
+    alignas(16) float ElapsedTime[MAX_BILLBOARDS];
+    alignas(16) float LifeTime[MAX_BILLBOARDS];
+    // Physical position
+    alignas(16) float PhysPosX[MAX_BILLBOARDS];
+    alignas(16) float PhysPosY[MAX_BILLBOARDS];
+    alignas(16) float PhysPosZ[MAX_BILLBOARDS];
+    // Direction and "strength" of speed (NOT Normalized)
+    alignas(16) float VelocityX[MAX_BILLBOARDS];
+    alignas(16) float VelocityY[MAX_BILLBOARDS];
+    alignas(16) float VelocityZ[MAX_BILLBOARDS];
+    // Weight and fabsf(Mass)
+    alignas(16) float Mass[MAX_BILLBOARDS];
+    alignas(16) float UMass[MAX_BILLBOARDS];
+    // Angle of rotation and twisting speed, radians per second
+    alignas(16) float Angle[MAX_BILLBOARDS];
+    alignas(16) float Spin[MAX_BILLBOARDS];
+    // Final position for rendering, the angle is Angle
+    alignas(16) float RenderPosX[MAX_BILLBOARDS];
+    alignas(16) float RenderPosY[MAX_BILLBOARDS];
+    alignas(16) float RenderPosZ[MAX_BILLBOARDS];
+    alignas(16) float OldRenderPosX[MAX_BILLBOARDS];
+    alignas(16) float OldRenderPosY[MAX_BILLBOARDS];
+    alignas(16) float OldRenderPosZ[MAX_BILLBOARDS];
+    alignas(16) float OldRenderAngle[MAX_BILLBOARDS];
+    // Transformation matrix at emission of a particle (for a track), m[0..3][0..2]
+    alignas(16) float World[12][MAX_BILLBOARDS];
+
+    // Coefficients for randomization
+    alignas(16) float DragK[MAX_BILLBOARDS];
+    alignas(16) float SpinDragK[MAX_BILLBOARDS];
+    alignas(16) float SizeK[MAX_BILLBOARDS];
+    alignas(16) float ColorK[MAX_BILLBOARDS];
+    alignas(16) float AlphaK[MAX_BILLBOARDS];
+    alignas(16) float FrameK[MAX_BILLBOARDS];
+    alignas(16) float GravKK[MAX_BILLBOARDS];
+    alignas(16) float AddPowerK[MAX_BILLBOARDS];
+    alignas(16) float KTrackX[MAX_BILLBOARDS];
+    alignas(16) float KTrackY[MAX_BILLBOARDS];
+    alignas(16) float KTrackZ[MAX_BILLBOARDS];
+    alignas(16) float KPhysBlend[MAX_BILLBOARDS];
+
+    // Graph values of the current Process, gathered per particle before the SIMD pass
+    alignas(16) float Drag[MAX_BILLBOARDS];
+    alignas(16) float GravK[MAX_BILLBOARDS];
+    alignas(16) float SpinDrag[MAX_BILLBOARDS];
+    alignas(16) float TrackX[MAX_BILLBOARDS];
+    alignas(16) float TrackY[MAX_BILLBOARDS];
+    alignas(16) float TrackZ[MAX_BILLBOARDS];
+    alignas(16) float PhysBlend[MAX_BILLBOARDS];
+
+    alignas(16) float CamDistance[MAX_BILLBOARDS];
+
+    ParticleGraphs Graphs[MAX_BILLBOARDS];
+    // Pointer to the number of particles of this type, decreased when the particle dies
+    uint32_t *ActiveCount[MAX_BILLBOARDS];
+    IEmitter *AttachedEmitter[MAX_BILLBOARDS];
+    uint32_t EmitterGUID[MAX_BILLBOARDS];
+    // Turn along the velocity vector
+    bool SpeedOriented[MAX_BILLBOARDS];
+
+    uint32_t Count;
+
+    // "Kill" the particle, the last one takes its place
+    void Free(uint32_t n);
+
+    // Age the particles, kill the dead ones and move the rest by their physics and track
+    void Process(float DeltaTime);
+
+  private:
+    // Physics, spin and track of particles [n, n + 4)
+    void ProcessBlock(uint32_t n, float DeltaTime);
+};
@@ -9,11 +9,14 @@
 #include "../data_source/data_graph.h"
 #include "../data_source/data_uv.h"
 #include "../particle_system/particle_system.h"
-#include "physic.h"
+#include "../../radix_sort.h"
 #include "string_compare.hpp"
 
-// How many billboards can there be
-#define MAX_BILLBOARDS 4096
+#include <algorithm>
+#include <bit>
+#include <execution>
+
+extern uint32_t GraphRead;
 
 #define UV_TX1 0
 #define UV_TX2 2
@@ -29,17 +32,18 @@ Must be > 0
 #define PLOD 5.0f
 //=============================================================
 
+// Billboards filled by one worker task
+#define DRAW_CHUNK 256
+
 IDirect3DVertexDeclaration9 *BillBoardProcessor::vertexDecl_ = nullptr;
 
 BillBoardProcessor::BillBoardProcessor()
 {
-    Particles.reserve(MAX_BILLBOARDS);
-    pMemArray = new MemArrayItem[MAX_BILLBOARDS];
-
-    for (uint32_t n = 0; n < MAX_BILLBOARDS; n++)
-    {
-        pMemArray[n].Free = true;
-    }
+    // Zeroed, so the padding lanes of the SIMD blocks are valid floats
+    pData = std::make_unique<BillBoardParticles>();
+    DrawOrder.reserve(MAX_BILLBOARDS);
+    DrawKeys.reserve(MAX_BILLBOARDS);
+    Staging.resize(MAX_BILLBOARDS * 4);
 
     pRS = static_cast<VDX9RENDER *>(core.GetService("DX9Render"));
     Assert(pRS);
@@ -70,8 +74,6 @@ BillBoardProcessor::BillBoardProcessor()
 
 BillBoardProcessor::~BillBoardProcessor()
 {
-    delete pMemArray;
-
     pRS = static_cast<VDX9RENDER *>(core.GetService("DX9Render"));
     if (pRS != nullptr)
     {
@@ -83,420 +85,344 @@ BillBoardProcessor::~BillBoardProcessor()
     pIBuffer = -1;
 }
 
-// Allocate memory for particle storage
-BB_ParticleData *BillBoardProcessor::AllocParticle() const
-{
-    for (uint32_t n = 0; n < MAX_BILLBOARDS; n++)
-    {
-        if (pMemArray[n].Free)
-        {
-            pMemArray[n].Free = false;
-            return &pMemArray[n].pData;
-        }
-    }
-
-    return nullptr;
-}
-
-// "Kill" the particle
-void BillBoardProcessor::FreeParticle(BB_ParticleData *pItem) const
-{
-    for (uint32_t n = 0; n < MAX_BILLBOARDS; n++)
-    {
-        if (&pMemArray[n].pData == pItem)
-        {
-            pMemArray[n].Free = true;
-            return;
-        }
-    }
-}
-
 void BillBoardProcessor::AddParticle(ParticleSystem *pSystem, const Vector &velocity_dir, const Vector &pos,
                                      const Matrix &matWorld, float EmitterTime, float EmitterLifeTime,
                                      FieldList *pFields, uint32_t *pActiveCount, uint32_t dwGUID)
 {
-    auto *pData = AllocParticle();
+    auto &p = *pData;
 
     // It will work if there are particles > MAX_BILLBOARDS, there should not be so many of them
-    if (!pData)
+    if (p.Count >= MAX_BILLBOARDS)
     {
         *(pActiveCount) = (*(pActiveCount)-1);
         return;
     }
+    const auto n = p.Count++;
 
-    pData->Graph_TrackX = pFields->FindGraph(PARTICLE_TRACK_X);
-    pData->Graph_TrackY = pFields->FindGraph(PARTICLE_TRACK_Y);
-    pData->Graph_TrackZ = pFields->FindGraph(PARTICLE_TRACK_Z);
+    auto &Graphs = p.Graphs[n];
+    Graphs.TrackX = pFields->FindGraph(PARTICLE_TRACK_X);
+    Graphs.TrackY = pFields->FindGraph(PARTICLE_TRACK_Y);
+    Graphs.TrackZ = pFields->FindGraph(PARTICLE_TRACK_Z);
 
     Vector PositionOffset;
-    PositionOffset.x = pData->Graph_TrackX->GetRandomValue(0.0f, 100.0f);
-    PositionOffset.y = pData->Graph_TrackY->GetRandomValue(0.0f, 100.0f);
-    PositionOffset.z = pData->Graph_TrackZ->GetRandomValue(0.0f, 100.0f);
-
-    pData->SpeedOriented = pFields->GetBool(PARTICLE_DIR_ORIENT, false);
-    pData->EmitterGUID = dwGUID;
-    pData->ActiveCount = pActiveCount;
-    pData->RenderPos = (pos + PositionOffset) * matWorld;
-    pData->Velocity = matWorld.MulNormal(velocity_dir);
-    pData->ElapsedTime = 0.0f;
-    pData->matWorld = matWorld;
-
-    pData->Angle = 0.0f;
-    pData->RenderAngle = 0.0f;
-    pData->ExternalForce = Vector(0.0f, 0.0f, 0.0f);
-    pData->PhysPos = pData->RenderPos;
-
-    pData->OldRenderPos = pData->RenderPos;
-    pData->OldRenderAngle = pData->RenderAngle;
-
-    pData->LifeTime = pFields->GetRandomGraphVal(PARTICLE_LIFE_TIME, EmitterTime, EmitterLifeTime);
-    pData->Mass = pFields->GetRandomGraphVal(PARTICLE_MASS, EmitterTime, EmitterLifeTime);
-    pData->Spin = pFields->GetRandomGraphVal(PARTICLE_SPIN, EmitterTime, EmitterLifeTime);
-    pData->Spin = pData->Spin * MUL_DEGTORAD;
+    PositionOffset.x = Graphs.TrackX->GetRandomValue(0.0f, 100.0f);
+    PositionOffset.y = Graphs.TrackY->GetRandomValue(0.0f, 100.0f);
+    PositionOffset.z = Graphs.TrackZ->GetRandomValue(0.0f, 100.0f);
+
+    p.SpeedOriented[n] = pFields->GetBool(PARTICLE_DIR_ORIENT, false);
+    p.EmitterGUID[n] = dwGUID;
+    p.ActiveCount[n] = pActiveCount;
+    const auto RenderPos = (pos + PositionOffset) * matWorld;
+    auto Velocity = matWorld.MulNormal(velocity_dir);
+    p.ElapsedTime[n] = 0.0f;
+    for (uint32_t row = 0; row < 4; row++)
+    {
+        for (uint32_t col = 0; col < 3; col++)
+            p.World[row * 3 + col][n] = matWorld.m[row][col];
+    }
+
+    p.Angle[n] = 0.0f;
+    p.PhysPosX[n] = p.RenderPosX[n] = p.OldRenderPosX[n] = RenderPos.x;
+    p.PhysPosY[n] = p.RenderPosY[n] = p.OldRenderPosY[n] = RenderPos.y;
+    p.PhysPosZ[n] = p.RenderPosZ[n] = p.OldRenderPosZ[n] = RenderPos.z;
+    p.OldRenderAngle[n] = 0.0f;
+
+    p.LifeTime[n] = pFields->GetRandomGraphVal(PARTICLE_LIFE_TIME, EmitterTime, EmitterLifeTime);
+    p.Mass[n] = pFields->GetRandomGraphVal(PARTICLE_MASS, EmitterTime, EmitterLifeTime);
+    p.Spin[n] = pFields->GetRandomGraphVal(PARTICLE_SPIN, EmitterTime, EmitterLifeTime);
+    p.Spin[n] = p.Spin[n] * MUL_DEGTORAD;
 
     const auto VelocityPower = pFields->GetRandomGraphVal(PARTICLE_VELOCITY_POWER, EmitterTime, EmitterLifeTime);
-    pData->Velocity = pData->Velocity * VelocityPower;
-    pData->UMass = fabsf(pData->Mass);
-
-    pData->Graph_SpinDrag = pFields->FindGraph(PARTICLE_SPIN_DRAG);
-    pData->Graph_Size = pFields->FindGraph(PARTICLE_SIZE);
-    pData->Graph_Frames = pFields->FindGraph(PARTICLE_ANIMFRAME);
-    pData->Graph_Color = pFields->FindColor(PARTICLE_COLOR);
-    pData->Graph_UV = pFields->FindUV(PARTICLE_FRAMES);
-    pData->Graph_Transparency = pFields->FindGraph(PARTICLE_TRANSPARENCY);
-    pData->Graph_Drag = pFields->FindGraph(PARTICLE_DRAG);
-    pData->Graph_PhysBlend = pFields->FindGraph(PARTICLE_PHYSIC_BLEND);
-    pData->graph_GravK = pFields->FindGraph(PARTICLE_GRAVITATION_K);
-    pData->graph_AddPower = pFields->FindGraph(PARTICLE_ADDPOWER);
-
-    pData->DragK = FRAND(1.0f);
-    pData->SpinDragK = FRAND(1.0f);
-    pData->SizeK = FRAND(1.0f);
-    pData->ColorK = FRAND(1.0f);
-    pData->AlphaK = FRAND(1.0f);
-    pData->FrameK = FRAND(1.0f);
-    pData->GravKK = FRAND(1.0f);
-    pData->AddPowerK = FRAND(1.0f);
-
-    pData->KPhysBlend = FRAND(1.0f);
-    pData->KTrackX = FRAND(1.0f);
-    pData->KTrackY = FRAND(1.0f);
-    pData->KTrackZ = FRAND(1.0f);
+    Velocity = Velocity * VelocityPower;
+    p.VelocityX[n] = Velocity.x;
+    p.VelocityY[n] = Velocity.y;
+    p.VelocityZ[n] = Velocity.z;
+    p.UMass[n] = fabsf(p.Mass[n]);
+
+    Graphs.SpinDrag = pFields->FindGraph(PARTICLE_SPIN_DRAG);
+    Graphs.Size = pFields->FindGraph(PARTICLE_SIZE);
+    Graphs.Frames = pFields->FindGraph(PARTICLE_ANIMFRAME);
+    Graphs.Color = pFields->FindColor(PARTICLE_COLOR);
+    Graphs.UV = pFields->FindUV(PARTICLE_FRAMES);
+    Graphs.Transparency = pFields->FindGraph(PARTICLE_TRANSPARENCY);
+    Graphs.Drag = pFields->FindGraph(PARTICLE_DRAG);
+    Graphs.PhysBlend = pFields->FindGraph(PARTICLE_PHYSIC_BLEND);
+    Graphs.GravK = pFields->FindGraph(PARTICLE_GRAVITATION_K);
+    Graphs.AddPower = pFields->FindGraph(PARTICLE_ADDPOWER);
+
+    p.DragK[n] = FRAND(1.0f);
+    p.SpinDragK[n] = FRAND(1.0f);
+    p.SizeK[n] = FRAND(1.0f);
+    p.ColorK[n] = FRAND(1.0f);
+    p.AlphaK[n] = FRAND(1.0f);
+    p.FrameK[n] = FRAND(1.0f);
+    p.GravKK[n] = FRAND(1.0f);
+    p.AddPowerK[n] = FRAND(1.0f);
+
+    p.KPhysBlend[n] = FRAND(1.0f);
+    p.KTrackX[n] = FRAND(1.0f);
+    p.KTrackY[n] = FRAND(1.0f);
+    p.KTrackZ[n] = FRAND(1.0f);
 
     const auto *const pEmitterName = pFields->GetString(ATTACHEDEMITTER_NAME);
     if (storm::iEquals(pEmitterName, "none"))
     {
-        pData->AttachedEmitter = nullptr;
+        p.AttachedEmitter[n] = nullptr;
     }
     else
     {
-        pData->AttachedEmitter = pSystem->FindEmitter(pEmitterName);
-        if (pData->AttachedEmitter)
-            pData->AttachedEmitter->SetAttachedFlag(true);
+        p.AttachedEmitter[n] = pSystem->FindEmitter(pEmitterName);
+        if (p.AttachedEmitter[n])
+            p.AttachedEmitter[n]->SetAttachedFlag(true);
     }
-
-    Particles.push_back(pData);
 }
 
 // Calculate physics, tracks, etc.
 void BillBoardProcessor::Process(float DeltaTime)
 {
-    // DWORD t;
-    // RDTSC_B (t);
-
-    for (uint32_t n = 0; n < Particles.size(); n++)
-    {
-        Particles[n]->ElapsedTime += DeltaTime;
-
-        const auto Time = Particles[n]->ElapsedTime;
-        const auto LifeTime = Particles[n]->LifeTime;
+    auto &p = *pData;
 
-        //        _mm_prefetch ((const char *)Particles[n+1], _MM_HINT_T0);
-
-        // immediately kill the dead
-        if (Time > LifeTime)
-        {
-            *(Particles[n]->ActiveCount) = (*(Particles[n]->ActiveCount) - 1);
-            FreeParticle(Particles[n]);
-            // Particles.ExtractNoShift(n);
-            Particles[n] = Particles.back();
-            Particles.pop_back();
-            n--;
-            continue;
-        }
-
-        auto Drag = Particles[n]->Graph_Drag->GetValue(Time, LifeTime, Particles[n]->DragK);
-        Drag = 1.0f - (Drag * 0.01f);
-        if (Drag < 0.0f)
-            Drag = 0.0f;
-        if (Drag > 1.0f)
-            Drag = 1.0f;
-
-        const auto GravK = Particles[n]->graph_GravK->GetValue(Time, LifeTime, Particles[n]->GravKK);
-
-        AddGravityForce(Particles[n]->ExternalForce, Particles[n]->Mass, GravK);
-        SolvePhysic(Particles[n]->PhysPos, Particles[n]->Velocity, Particles[n]->ExternalForce, Particles[n]->UMass,
-                    Drag, DeltaTime);
-        Particles[n]->ExternalForce = Vector(0.0f);
-
-        // FIX ME !!!
-        auto SpinDrag = Particles[n]->Graph_SpinDrag->GetValue(Time, LifeTime, Particles[n]->SpinDragK);
-        SpinDrag = 1.0f - (SpinDrag * 0.01f);
-        if (SpinDrag < 0.0f)
-            SpinDrag = 0.0f;
-        if (SpinDrag > 1.0f)
-            SpinDrag = 1.0f;
-        Particles[n]->Angle += (Particles[n]->Spin * SpinDrag) * DeltaTime;
-
-        Vector TrackPos;
-        TrackPos.x = Particles[n]->Graph_TrackX->GetValue(Time, LifeTime, Particles[n]->KTrackX);
-        TrackPos.y = Particles[n]->Graph_TrackY->GetValue(Time, LifeTime, Particles[n]->KTrackY);
-        TrackPos.z = Particles[n]->Graph_TrackZ->GetValue(Time, LifeTime, Particles[n]->KTrackZ);
-        TrackPos = TrackPos * Particles[n]->matWorld;
-
-        // FIX ME !!!
-        auto BlendPhys = Particles[n]->Graph_PhysBlend->GetValue(Time, LifeTime, Particles[n]->KPhysBlend);
-        BlendPhys = 1.0f - (BlendPhys * DeltaTime);
-        if (BlendPhys < 0.0f)
-            BlendPhys = 0.0f;
-        if (BlendPhys > 1.0f)
-            BlendPhys = 1.0f;
-
-        // Save old positions
-        Particles[n]->OldRenderPos = Particles[n]->RenderPos;
-        // Particles[n]->OldRenderAngle = Particles[n]->RenderAngle;
-
-        Particles[n]->RenderPos.Lerp(TrackPos, Particles[n]->PhysPos, BlendPhys);
-        Particles[n]->PhysPos = Particles[n]->RenderPos;
-
-        // Particles[n]->RenderPos    = Particles[n]->PhysPos;
-        Particles[n]->RenderAngle = Particles[n]->Angle;
-    }
+    p.Process(DeltaTime);
 
     // emit particles that are attached to our particle
-
-    for (uint32_t n = 0; n < Particles.size(); n++)
+    for (uint32_t n = 0; n < p.Count; n++)
     {
-        if (Particles[n]->AttachedEmitter)
+        if (p.AttachedEmitter[n])
         {
-            //            core.Trace("%d, %3.2f, %3.2f, %3.2f", n, Particles[n]->RenderPos.x, Particles[n]->RenderPos.y,
-            // Particles[n]->RenderPos.z);             Particles[n]->AttachedEmitter->SaveTime();
-            Particles[n]->AttachedEmitter->Teleport(Matrix(Particles[n]->OldRenderAngle, Particles[n]->OldRenderPos));
-            Particles[n]->AttachedEmitter->SetTransform(Matrix(Particles[n]->RenderAngle, Particles[n]->RenderPos));
-            Particles[n]->AttachedEmitter->BornParticles(DeltaTime);
-
-            // if (n < Particles.size()-1)    Particles[n]->AttachedEmitter->RestoreTime();
+            const Vector OldRenderPos(p.OldRenderPosX[n], p.OldRenderPosY[n], p.OldRenderPosZ[n]);
+            const Vector RenderPos(p.RenderPosX[n], p.RenderPosY[n], p.RenderPosZ[n]);
+            p.AttachedEmitter[n]->Teleport(Matrix(p.OldRenderAngle[n], OldRenderPos));
+            p.AttachedEmitter[n]->SetTransform(Matrix(p.Angle[n], RenderPos));
+            p.AttachedEmitter[n]->BornParticles(DeltaTime);
         }
     }
-
-    // RDTSC_E (t);
-    // core.Trace("Time - %d", t);
 }
 
 // Calculate distance to billboards
 uint32_t BillBoardProcessor::CalcDistanceToCamera()
 {
-    uint32_t VisParticles = 0;
+    auto &p = *pData;
+    DrawOrder.clear();
+    DrawKeys.clear();
     const Matrix mView;
     pRS->GetTransform(D3DTS_VIEW, mView);
-    for (uint32_t j = 0; j < Particles.size(); j++)
+    for (uint32_t j = 0; j < p.Count; j++)
     {
-        Particles[j]->CamDistance = Vector(Particles[j]->RenderPos * mView).z;
-
-        //        _mm_prefetch ((const char *)Particles[j+1], _MM_HINT_T0);
-
-        if (Particles[j]->CamDistance > 0)
+        p.CamDistance[j] = Vector(Vector(p.RenderPosX[j], p.RenderPosY[j], p.RenderPosZ[j]) * mView).z;
+        if (p.CamDistance[j] > 0)
         {
-            Particles[j]->Visible = true;
-            VisParticles++;
-        }
-        else
-        {
-            Particles[j]->Visible = false;
+            // A positive float orders as its bits, the lowest 8 of them are dropped so 3 passes sort it.
+            // Inverted, so the far ones come first
+            DrawOrder.push_back(j);
+            DrawKeys.push_back(0xFFFFFFu - (std::bit_cast<uint32_t>(p.CamDistance[j]) >> 8));
         }
     }
-    return VisParticles;
+    return DrawOrder.size();
 }
 
-// Compare function when sorting
-BOOL BillBoardProcessor::CompareFunction(BB_ParticleData *e1, BB_ParticleData *e2)
+void BillBoardProcessor::SortByDistance()
 {
-    if (e1->CamDistance > e2->CamDistance)
-        return true;
-    return false;
+    RadixSort<24>(DrawKeys, DrawOrder, SortKeys, SortOrder);
 }
 
-// Draws all the billboards
-void BillBoardProcessor::Draw()
+uint32_t BillBoardProcessor::FillVertices(const Matrix &matView)
 {
-    if (CalcDistanceToCamera() == 0)
-        return;
-    ParticleSorter.QSort(CompareFunction, &Particles[0], Particles.size());
+    DrawChunks.clear();
+    for (uint32_t First = 0; First < DrawOrder.size(); First += DRAW_CHUNK)
+        DrawChunks.push_back({First, std::min<uint32_t>(First + DRAW_CHUNK, DrawOrder.size()), 0, 0});
 
-    auto *pVerts = static_cast<RECT_VERTEX *>(pRS->LockVertexBuffer(pVBuffer, D3DLOCK_DISCARD));
-    // RECT_VERTEX * pVerts = (RECT_VERTEX*)pVBuffer->Lock(0, 0, D3DLOCK_DISCARD);
-    // RECT_VERTEX * pVerts = (RECT_VERTEX*)pVBuffer->Lock();
+    std::for_each(std::execution::par, DrawChunks.begin(), DrawChunks.end(), [this, &matView](DrawChunk &Chunk) {
+        auto *pV = &Staging[Chunk.First * 4];
+        for (auto j = Chunk.First; j < Chunk.Last; j++)
+        {
+            if (FillParticle(DrawOrder[j], matView, pV, Chunk.GraphReads))
+            {
+                pV += 4;
+                Chunk.Count++;
+            }
+        }
+    });
 
-    int32_t Index = 0;
     uint32_t ParticlesCount = 0;
-    for (uint32_t j = 0; j < Particles.size(); j++)
+    for (const auto &Chunk : DrawChunks)
     {
-        auto pR = Particles[j];
-
-        if (!pR->Visible)
-            continue;
-
-        auto SpeedOriented = pR->SpeedOriented;
-        auto fSize = pR->Graph_Size->GetValue(pR->ElapsedTime, pR->LifeTime, pR->SizeK);
-        if (fSize <= 0.000001f)
-            continue;
-
-        //        _mm_prefetch ((const char *)Particles[j+1], _MM_HINT_T0);
-
-        auto fAngle = pR->RenderAngle;
-        auto vPos = pR->RenderPos;
-        uint32_t dwColor = pR->Graph_Color->GetValue(pR->ElapsedTime, pR->LifeTime, pR->ColorK);
-
-        auto Alpha = pR->Graph_Transparency->GetValue(pR->ElapsedTime, pR->LifeTime, pR->AlphaK);
-        Alpha = Alpha * 0.01f;
-        Alpha = 1.0f - Alpha;
-        if (Alpha < 0.0f)
-            Alpha = 0.0f;
-        if (Alpha > 1.0f)
-            Alpha = 1.0f;
-        Alpha = Alpha * 255.0f;
-
-        auto AddPower = pR->graph_AddPower->GetValue(pR->ElapsedTime, pR->LifeTime, pR->AddPowerK);
-        AddPower = AddPower * 0.01f;
-        AddPower = 1.0f - AddPower;
-        if (AddPower < 0.0f)
-            AddPower = 0.0f;
-        if (AddPower > 1.0f)
-            AddPower = 1.0f;
-
-        // AddPower = 0.0f;
-
-        auto FrameIndex = pR->Graph_Frames->GetValue(pR->ElapsedTime, pR->LifeTime, pR->FrameK);
-        auto FrameIndexLong = fftol(FrameIndex);
-        auto FrameBlendK = 1.0f - (FrameIndex - FrameIndexLong);
-        const auto &UV_WH1 = pR->Graph_UV->GetValue(FrameIndexLong);
-        const auto &UV_WH2 = pR->Graph_UV->GetValue(FrameIndexLong + 1);
-
-        // Maximum particle size limiter
-        // =============================================================
-        auto SizeK = pR->CamDistance / fSize;
-        if (SizeK < PLOD)
-            fSize = pR->CamDistance / PLOD;
-        //=============================================================
-
-        auto *pV = &pVerts[Index * 4];
-        Index++;
-
-        auto DirAngle = 0.0f;
-        auto ScaleF = 1.0f;
-
-        if (SpeedOriented)
-        {
-            Matrix matView;
-            pRS->GetTransform(D3DTS_VIEW, matView);
-            auto SpeedVector = pR->Velocity;
-            // pR->RenderPos - pR->OldRenderPos;
-            SpeedVector = matView.MulNormal(SpeedVector);
-            SpeedVector.Normalize();
-            ScaleF = 1.0f - fabsf(SpeedVector.z);
-
-            if (ScaleF < 0.3f)
-                ScaleF = 0.3f;
-            Alpha *= ScaleF;
-
-            SpeedVector.z = SpeedVector.y;
-            DirAngle = SpeedVector.GetAY(pR->OldRenderAngle);
-
-            pR->OldRenderAngle = DirAngle;
-        }
+        ParticlesCount += Chunk.Count;
+        GraphRead += Chunk.GraphReads;
+    }
+    return ParticlesCount;
+}
 
-        uint32_t dwAlpha = static_cast<uint8_t>(Alpha) << 24;
-        dwColor = dwColor & 0x00FFFFFF;
-        dwColor = dwColor | dwAlpha;
+bool BillBoardProcessor::FillParticle(uint32_t n, const Matrix &matView, RECT_VERTEX *pV, uint32_t &GraphReads)
+{
+    auto &p = *pData;
+    const auto &Graphs = p.Graphs[n];
+    const auto Time = p.ElapsedTime[n];
+    const auto LifeTime = p.LifeTime[n];
+
+    auto SpeedOriented = p.SpeedOriented[n];
+    auto fSize = Graphs.Size->Sample(Time, LifeTime, p.SizeK[n]);
+    GraphReads++;
+    if (fSize <= 0.000001f)
+        return false;
+
+    auto fAngle = p.Angle[n];
+    auto vPos = Vector(p.RenderPosX[n], p.RenderPosY[n], p.RenderPosZ[n]);
+    uint32_t dwColor = Graphs.Color->GetValue(Time, LifeTime, p.ColorK[n]);
+
+    auto Alpha = Graphs.Transparency->Sample(Time, LifeTime, p.AlphaK[n]);
+    Alpha = Alpha * 0.01f;
+    Alpha = 1.0f - Alpha;
+    if (Alpha < 0.0f)
+        Alpha = 0.0f;
+    if (Alpha > 1.0f)
+        Alpha = 1.0f;
+    Alpha = Alpha * 255.0f;
+
+    auto AddPower = Graphs.AddPower->Sample(Time, LifeTime, p.AddPowerK[n]);
+    AddPower = AddPower * 0.01f;
+    AddPower = 1.0f - AddPower;
+    if (AddPower < 0.0f)
+        AddPower = 0.0f;
+    if (AddPower > 1.0f)
+        AddPower = 1.0f;
+
+    GraphReads += 3;
+
+    // AddPower = 0.0f;
+
+    auto FrameIndex = Graphs.Frames->Sample(Time, LifeTime, p.FrameK[n]);
+    auto FrameIndexLong = fftol(FrameIndex);
+    auto FrameBlendK = 1.0f - (FrameIndex - FrameIndexLong);
+    const auto &UV_WH1 = Graphs.UV->GetValue(FrameIndexLong);
+    const auto &UV_WH2 = Graphs.UV->GetValue(FrameIndexLong + 1);
+
+    // Maximum particle size limiter
+    // =============================================================
+    auto SizeK = p.CamDistance[n] / fSize;
+    if (SizeK < PLOD)
+        fSize = p.CamDistance[n] / PLOD;
+    //=============================================================
+
+    auto DirAngle = 0.0f;
+    auto ScaleF = 1.0f;
+
+    if (SpeedOriented)
+    {
+        auto SpeedVector = Vector(p.VelocityX[n], p.VelocityY[n], p.VelocityZ[n]);
+        SpeedVector = matView.MulNormal(SpeedVector);
+        SpeedVector.Normalize();
+        ScaleF = 1.0f - fabsf(SpeedVector.z);
 
-        // if (j == 0)    core.Trace("fAngle[0]: %3.2f", fAngle);
+        if (ScaleF < 0.3f)
+            ScaleF = 0.3f;
+        Alpha *= ScaleF;
 
-        pV[0].vRelativePos = Vector(-fSize, -fSize, 0.0f);
-        pV[0].dwColor = dwColor;
-        pV[0].tu1 = UV_WH1.v4[UV_TX1];
-        pV[0].tv1 = UV_WH1.v4[UV_TY1];
-        pV[0].tu2 = UV_WH2.v4[UV_TX1];
-        pV[0].tv2 = UV_WH2.v4[UV_TY1];
-        pV[0].angle = fAngle;
-        pV[0].BlendK = FrameBlendK;
-        pV[0].vParticlePos = vPos;
-        pV[0].AddPowerK = AddPower;
+        SpeedVector.z = SpeedVector.y;
+        DirAngle = SpeedVector.GetAY(p.OldRenderAngle[n]);
 
-        // if (SpeedOriented) pV[0].DirK = 0.0f; else pV[0].DirK = 1.0f;
+        p.OldRenderAngle[n] = DirAngle;
+    }
 
-        if (SpeedOriented)
-        {
-            pV[0].angle = DirAngle;
-            pV[0].vRelativePos.y *= ScaleF;
-        }
+    uint32_t dwAlpha = static_cast<uint8_t>(Alpha) << 24;
+    dwColor = dwColor & 0x00FFFFFF;
+    dwColor = dwColor | dwAlpha;
 
-        pV[1].vRelativePos = Vector(-fSize, fSize, 0.0f);
-        pV[1].dwColor = dwColor;
-        pV[1].tu1 = UV_WH1.v4[UV_TX1];
-        pV[1].tv1 = UV_WH1.v4[UV_TY2];
-        pV[1].tu2 = UV_WH2.v4[UV_TX1];
-        pV[1].tv2 = UV_WH2.v4[UV_TY2];
-        pV[1].angle = fAngle;
-        pV[1].BlendK = FrameBlendK;
-        pV[1].vParticlePos = vPos;
-        pV[1].AddPowerK = AddPower;
-        // if (SpeedOriented) pV[1].DirK = 0.0f; else pV[1].DirK = 1.0f;
-
-        if (SpeedOriented)
-        {
-            pV[1].angle = DirAngle;
-            pV[1].vRelativePos.y *= ScaleF;
-        }
+    pV[0].vRelativePos = Vector(-fSize, -fSize, 0.0f);
+    pV[0].dwColor = dwColor;
+    pV[0].tu1 = UV_WH1.v4[UV_TX1];
+    pV[0].tv1 = UV_WH1.v4[UV_TY1];
+    pV[0].tu2 = UV_WH2.v4[UV_TX1];
+    pV[0].tv2 = UV_WH2.v4[UV_TY1];
+    pV[0].angle = fAngle;
+    pV[0].BlendK = FrameBlendK;
+    pV[0].vParticlePos = vPos;
+    pV[0].AddPowerK = AddPower;
 
-        pV[2].vRelativePos = Vector(fSize, fSize, 0.0f);
-        pV[2].dwColor = dwColor;
-        pV[2].tu1 = UV_WH1.v4[UV_TX2];
-        pV[2].tv1 = UV_WH1.v4[UV_TY2];
-        pV[2].tu2 = UV_WH2.v4[UV_TX2];
-        pV[2].tv2 = UV_WH2.v4[UV_TY2];
-        pV[2].angle = fAngle;
-        pV[2].BlendK = FrameBlendK;
-        pV[2].vParticlePos = vPos;
-        pV[2].AddPowerK = AddPower;
-        // if (SpeedOriented) pV[2].DirK = 0.0f; else pV[2].DirK = 1.0f;
-
-        if (SpeedOriented)
-        {
-            pV[2].angle = DirAngle;
-            pV[2].vRelativePos.y *= ScaleF;
-        }
+    // if (SpeedOriented) pV[0].DirK = 0.0f; else pV[0].DirK = 1.0f;
 
-        pV[3].vRelativePos = Vector(fSize, -fSize, 0.0f);
-        pV[3].dwColor = dwColor;
-        pV[3].tu1 = UV_WH1.v4[UV_TX2];
-        pV[3].tv1 = UV_WH1.v4[UV_TY1];
-        pV[3].tu2 = UV_WH2.v4[UV_TX2];
-        pV[3].tv2 = UV_WH2.v4[UV_TY1];
-        pV[3].angle = fAngle;
-        pV[3].BlendK = FrameBlendK;
-        pV[3].vParticlePos = vPos;
-        pV[3].AddPowerK = AddPower;
-        // if (SpeedOriented) pV[3].DirK = 0.0f; else pV[3].DirK = 1.0f;
-
-        if (SpeedOriented)
-        {
-            pV[3].angle = DirAngle;
-            pV[3].vRelativePos.y *= ScaleF;
-        }
+    if (SpeedOriented)
+    {
+        pV[0].angle = DirAngle;
+        pV[0].vRelativePos.y *= ScaleF;
+    }
+
+    pV[1].vRelativePos = Vector(-fSize, fSize, 0.0f);
+    pV[1].dwColor = dwColor;
+    pV[1].tu1 = UV_WH1.v4[UV_TX1];
+    pV[1].tv1 = UV_WH1.v4[UV_TY2];
+    pV[1].tu2 = UV_WH2.v4[UV_TX1];
+    pV[1].tv2 = UV_WH2.v4[UV_TY2];
+    pV[1].angle = fAngle;
+    pV[1].BlendK = FrameBlendK;
+    pV[1].vParticlePos = vPos;
+    pV[1].AddPowerK = AddPower;
+    // if (SpeedOriented) pV[1].DirK = 0.0f; else pV[1].DirK = 1.0f;
+
+    if (SpeedOriented)
+    {
+        pV[1].angle = DirAngle;
+        pV[1].vRelativePos.y *= ScaleF;
+    }
+
+    pV[2].vRelativePos = Vector(fSize, fSize, 0.0f);
+    pV[2].dwColor = dwColor;
+    pV[2].tu1 = UV_WH1.v4[UV_TX2];
+    pV[2].tv1 = UV_WH1.v4[UV_TY2];
+    pV[2].tu2 = UV_WH2.v4[UV_TX2];
+    pV[2].tv2 = UV_WH2.v4[UV_TY2];
+    pV[2].angle = fAngle;
+    pV[2].BlendK = FrameBlendK;
+    pV[2].vParticlePos = vPos;
+    pV[2].AddPowerK = AddPower;
+    // if (SpeedOriented) pV[2].DirK = 0.0f; else pV[2].DirK = 1.0f;
+
+    if (SpeedOriented)
+    {
+        pV[2].angle = DirAngle;
+        pV[2].vRelativePos.y *= ScaleF;
+    }
 
-        ParticlesCount++;
+    pV[3].vRelativePos = Vector(fSize, -fSize, 0.0f);
+    pV[3].dwColor = dwColor;
+    pV[3].tu1 = UV_WH1.v4[UV_TX2];
+    pV[3].tv1 = UV_WH1.v4[UV_TY1];
+    pV[3].tu2 = UV_WH2.v4[UV_TX2];
+    pV[3].tv2 = UV_WH2.v4[UV_TY1];
+    pV[3].angle = fAngle;
+    pV[3].BlendK = FrameBlendK;
+    pV[3].vParticlePos = vPos;
+    pV[3].AddPowerK = AddPower;
+    // if (SpeedOriented) pV[3].DirK = 0.0f; else pV[3].DirK = 1.0f;
+
+    if (SpeedOriented)
+    {
+        pV[3].angle = DirAngle;
+        pV[3].vRelativePos.y *= ScaleF;
     }
 
+    return true;
+}
+
+// Draws all the billboards
+void BillBoardProcessor::Draw()
+{
+    if (CalcDistanceToCamera() == 0)
+        return;
+    SortByDistance();
+
+    Matrix matView;
+    pRS->GetTransform(D3DTS_VIEW, matView);
+    const auto ParticlesCount = FillVertices(matView);
+    if (ParticlesCount == 0)
+        return;
+
+    // The chunks are compact, only the gaps of the skipped billboards are left out
+    auto *pVerts = static_cast<RECT_VERTEX *>(pRS->LockVertexBuffer(pVBuffer, D3DLOCK_DISCARD));
+    for (const auto &Chunk : DrawChunks)
+    {
+        std::copy_n(&Staging[Chunk.First * 4], Chunk.Count * 4, pVerts);
+        pVerts += Chunk.Count * 4;
+    }
     pRS->UnLockVertexBuffer(pVBuffer);
 
     Vector4 const1(0.0416666f, 1.0f, 0.0f, -0.5f);
@@ -512,8 +438,7 @@ void BillBoardProcessor::Draw()
     pRS->SetVertexShaderConstantF(2, static_cast<const float *>(const3.v4), 1);
     pRS->SetVertexShaderConstantF(13, static_cast<const float *>(cGlobal.v4), 1);
 
-    Matrix matOldView, matView, matProjection;
-    pRS->GetTransform(D3DTS_VIEW, matView);
+    Matrix matOldView, matProjection;
     pRS->GetTransform(D3DTS_PROJECTION, matProjection);
 
     matOldView = matView;
@@ -535,20 +460,16 @@ void BillBoardProcessor::Draw()
 
 uint32_t BillBoardProcessor::GetCount() const
 {
-    return Particles.size();
+    return pData->Count;
 }
 
 void BillBoardProcessor::DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange)
 {
-    for (uint32_t j = 0; j < Particles.size(); j++)
+    for (uint32_t j = 0; j < pData->Count; j++)
     {
-        if (Particles[j]->EmitterGUID >= dwGUID && Particles[j]->EmitterGUID < dwGUID + GUIDRange)
+        if (pData->EmitterGUID[j] >= dwGUID && pData->EmitterGUID[j] < dwGUID + GUIDRange)
         {
-            *(Particles[j]->ActiveCount) = (*(Particles[j]->ActiveCount) - 1);
-            FreeParticle(Particles[j]);
-            // Particles.ExtractNoShift(j);
-            Particles[j] = Particles.back();
-            Particles.pop_back();
+            pData->Free(j);
             j--;
         }
     }
@@ -556,12 +477,9 @@ void BillBoardProcessor::DeleteWithGUID(uint32_t dwGUID, uint32_t GUIDRange)
 
 void BillBoardProcessor::Clear()
 {
-    for (uint32_t j = 0; j < Particles.size(); j++)
-    {
-        *(Particles[j]->ActiveCount) = (*(Particles[j]->ActiveCount) - 1);
-        FreeParticle(Particles[j]);
-    }
-    Particles.clear();
+    for (uint32_t j = 0; j < pData->Count; j++)
+        *(pData->ActiveCount[j]) = (*(pData->ActiveCount[j]) - 1);
+    pData->Count = 0;
 }
 
 void BillBoardProcessor::CreateVertexDeclaration() const
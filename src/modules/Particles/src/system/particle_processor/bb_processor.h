@@ -9,10 +9,12 @@
 
 #include "dx9render.h"
 #include "math3d/matrix.h"
-#include "../../gmx_qsort.h"
 
 #include "../../i_common/particle.h"
 #include "../data_source/field_list.h"
+#include "bb_particles.h"
+
+#include <memory>
 
 class ParticleSystem;
 
@@ -38,32 +40,37 @@ class BillBoardProcessor
     int32_t pVBuffer;
     int32_t pIBuffer;
 
-    struct MemArrayItem
-    {
-        BB_ParticleData pData;
-        bool Free;
-
-        MemArrayItem()
-            : pData()
-        {
-            Free = true;
-        }
-    };
+    std::unique_ptr<BillBoardParticles> pData;
 
-    MemArrayItem *pMemArray;
+    // Indices of the visible particles, far to near after SortByDistance
+    std::vector<uint32_t> DrawOrder;
+    // Quantised distances of DrawOrder, far ones first
+    std::vector<uint32_t> DrawKeys;
+    std::vector<uint32_t> SortKeys;
+    std::vector<uint32_t> SortOrder;
 
-    std::vector<BB_ParticleData *> Particles;
+    // Billboards of DrawOrder filled by one worker task, starting at the same index of Staging
+    struct DrawChunk
+    {
+        uint32_t First;
+        uint32_t Last;
+        uint32_t Count;
+        uint32_t GraphReads;
+    };
 
-    GMXQSort<BB_ParticleData *> ParticleSorter;
+    std::vector<DrawChunk> DrawChunks;
+    std::vector<RECT_VERTEX> Staging;
 
-    // Counts distance to billboards
+    // Counts distance to billboards and fills DrawOrder
     uint32_t CalcDistanceToCamera();
 
-    // Compare function when sorting
-    static BOOL CompareFunction(BB_ParticleData *e1, BB_ParticleData *e2);
+    void SortByDistance();
+
+    // Vertices of the sorted billboards into Staging, returns how many of them are drawn
+    uint32_t FillVertices(const Matrix &matView);
 
-    BB_ParticleData *AllocParticle() const;
-    void FreeParticle(BB_ParticleData *pItem) const;
+    // Four vertices of a billboard, false if it is too small to draw
+    bool FillParticle(uint32_t n, const Matrix &matView, RECT_VERTEX *pV, uint32_t &GraphReads);
 
   public:
     BillBoardProcessor();
@@ -0,0 +1,336 @@
+#include "i_common/graph_time.h"
+#include "system/data_source/data_graph.h"
+#include "system/particle_processor/bb_particles.h"
+#include "math3d/matrix.h"
+#include "math_inlines.h"
+#include "system/particle_processor/physic.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+// a billboard as BillBoardProcessor kept it before the arrays, in a pool walked through pointers
+struct OldParticle
+{
+    uint32_t *ActiveCount;
+    Vector PhysPos;
+    float Angle;
+    float Spin;
+    Vector Velocity;
+    Vector ExternalForce;
+    float LifeTime;
+    float ElapsedTime;
+    Matrix matWorld;
+    float Mass;
+    float UMass;
+    Vector RenderPos;
+    float RenderAngle;
+    Vector OldRenderPos;
+
+    DataGraph *Graph_SpinDrag;
+    DataGraph *Graph_Drag;
+    DataGraph *Graph_TrackX;
+    DataGraph *Graph_TrackY;
+    DataGraph *Graph_TrackZ;
+    DataGraph *Graph_PhysBlend;
+    DataGraph *graph_GravK;
+
+    float DragK;
+    float SpinDragK;
+    float GravKK;
+    float KTrackX;
+    float KTrackY;
+    float KTrackZ;
+    float KPhysBlend;
+};
+
+// the per particle update BillBoardProcessor::Process did before the SIMD kernel
+void OldProcess(std::vector<OldParticle *> &Particles, float DeltaTime)
+{
+    for (uint32_t n = 0; n < Particles.size(); n++)
+    {
+        Particles[n]->ElapsedTime += DeltaTime;
+
+        const auto Time = Particles[n]->ElapsedTime;
+        const auto LifeTime = Particles[n]->LifeTime;
+
+        if (Time > LifeTime)
+        {
+            *(Particles[n]->ActiveCount) = (*(Particles[n]->ActiveCount) - 1);
+            Particles[n] = Particles.back();
+            Particles.pop_back();
+            n--;
+            continue;
+        }
+
+        auto Drag = Particles[n]->Graph_Drag->GetValue(Time, LifeTime, Particles[n]->DragK);
+        Drag = 1.0f - (Drag * 0.01f);
+        if (Drag < 0.0f)
+            Drag = 0.0f;
+        if (Drag > 1.0f)
+            Drag = 1.0f;
+
+        const auto GravK = Particles[n]->graph_GravK->GetValue(Time, LifeTime, Particles[n]->GravKK);
+
+        AddGravityForce(Particles[n]->ExternalForce, Particles[n]->Mass, GravK);
+        SolvePhysic(Particles[n]->PhysPos, Particles[n]->Velocity, Particles[n]->ExternalForce, Particles[n]->UMass,
+                    Drag, DeltaTime);
+        Particles[n]->ExternalForce = Vector(0.0f);
+
+        auto SpinDrag = Particles[n]->Graph_SpinDrag->GetValue(Time, LifeTime, Particles[n]->SpinDragK);
+        SpinDrag = 1.0f - (SpinDrag * 0.01f);
+        if (SpinDrag < 0.0f)
+            SpinDrag = 0.0f;
+        if (SpinDrag > 1.0f)
+            SpinDrag = 1.0f;
+        Particles[n]->Angle += (Particles[n]->Spin * SpinDrag) * DeltaTime;
+
+        Vector TrackPos;
+        TrackPos.x = Particles[n]->Graph_TrackX->GetValue(Time, LifeTime, Particles[n]->KTrackX);
+        TrackPos.y = Particles[n]->Graph_TrackY->GetValue(Time, LifeTime, Particles[n]->KTrackY);
+        TrackPos.z = Particles[n]->Graph_TrackZ->GetValue(Time, LifeTime, Particles[n]->KTrackZ);
+        TrackPos = TrackPos * Particles[n]->matWorld;
+
+        auto BlendPhys = Particles[n]->Graph_PhysBlend->GetValue(Time, LifeTime, Particles[n]->KPhysBlend);
+        BlendPhys = 1.0f - (BlendPhys * DeltaTime);
+        if (BlendPhys < 0.0f)
+            BlendPhys = 0.0f;
+        if (BlendPhys > 1.0f)
+            BlendPhys = 1.0f;
+
+        Particles[n]->OldRenderPos = Particles[n]->RenderPos;
+        Particles[n]->RenderPos.Lerp(TrackPos, Particles[n]->PhysPos, BlendPhys);
+        Particles[n]->PhysPos = Particles[n]->RenderPos;
+        Particles[n]->RenderAngle = Particles[n]->Angle;
+    }
+}
+
+// a graph of random keys between Lo and Hi
+std::unique_ptr<DataGraph> MakeGraph(std::mt19937 &rng, float Lo, float Hi)
+{
+    std::uniform_real_distribution<float> Value(Lo, Hi);
+    std::vector<GraphVertex> MinGraph(5), MaxGraph(5);
+    for (size_t n = 0; n < MinGraph.size(); n++)
+    {
+        MinGraph[n].Time = MaxGraph[n].Time = MIN_GRAPH_TIME + (MAX_GRAPH_TIME - MIN_GRAPH_TIME) * n / 4.0f;
+        MinGraph[n].Val = Value(rng);
+        MaxGraph[n].Val = Value(rng);
+    }
+    auto Graph = std::make_unique<DataGraph>();
+    Graph->SetRelative(true);
+    Graph->SetValues(MinGraph.data(), static_cast<uint32_t>(MinGraph.size()), MaxGraph.data(),
+                     static_cast<uint32_t>(MaxGraph.size()));
+    return Graph;
+}
+
+// The same particles in both layouts
+struct BothLayouts
+{
+    std::vector<std::unique_ptr<DataGraph>> GraphStore;
+    std::unique_ptr<BillBoardParticles> Arrays = std::make_unique<BillBoardParticles>();
+    std::vector<OldParticle> Pool;
+    std::vector<OldParticle *> Old;
+    uint32_t ActiveCount = 0;
+    uint32_t OldActiveCount = 0;
+
+    // every fifth particle is massless, Drag, GravK and SpinDrag leave 0..100 percent and PhysBlend * DeltaTime
+    // leaves 0..1 so every clamp is hit
+    BothLayouts(uint32_t Count, float MaxLifeTime, uint32_t Seed)
+    {
+        std::mt19937 rng(Seed);
+        std::uniform_real_distribution<float> Rand(0.0f, 1.0f);
+        std::uniform_real_distribution<float> Signed(-1.0f, 1.0f);
+        const auto Random = [&](float Lo, float Hi) { return Lo + (Hi - Lo) * Rand(rng); };
+
+        // a few particle types share the graphs, as the systems of a scene do
+        struct Type
+        {
+            DataGraph *Drag, *GravK, *SpinDrag, *TrackX, *TrackY, *TrackZ, *PhysBlend;
+        };
+        std::vector<Type> Types;
+        for (int t = 0; t < 4; t++)
+        {
+            const auto Add = [&](float Lo, float Hi) {
+                GraphStore.push_back(MakeGraph(rng, Lo, Hi));
+                return GraphStore.back().get();
+            };
+            Types.push_back({Add(-50.0f, 150.0f), Add(-50.0f, 150.0f), Add(-50.0f, 150.0f), Add(-5.0f, 5.0f),
+                             Add(-5.0f, 5.0f), Add(-5.0f, 5.0f), Add(-10.0f, 60.0f)});
+        }
+
+        auto &p = *Arrays;
+        p.Count = Count;
+        ActiveCount = OldActiveCount = Count;
+        Pool.resize(Count);
+        for (uint32_t n = 0; n < Count; n++)
+        {
+            const auto &T = Types[n % Types.size()];
+            const Matrix World(Vector(Signed(rng), Signed(rng), Signed(rng)) * PI,
+                               Vector(Signed(rng), Signed(rng), Signed(rng)) * 10.0f);
+            const Vector Pos(Signed(rng) * 10.0f, Signed(rng) * 10.0f, Signed(rng) * 10.0f);
+            const Vector Velocity(Signed(rng) * 5.0f, Signed(rng) * 5.0f, Signed(rng) * 5.0f);
+            const auto Mass = n % 5 == 0 ? 0.0f : Random(-3.0f, 3.0f);
+            const auto LifeTime = Random(0.1f, MaxLifeTime);
+
+            auto &o = Pool[n];
+            o = {};
+            o.ActiveCount = &OldActiveCount;
+            o.PhysPos = o.RenderPos = o.OldRenderPos = Pos;
+            o.Angle = o.RenderAngle = 0.0f;
+            o.Spin = Random(-6.0f, 6.0f);
+            o.Velocity = Velocity;
+            o.ExternalForce = Vector(0.0f);
+            o.LifeTime = LifeTime;
+            o.ElapsedTime = Random(0.0f, LifeTime);
+            o.matWorld = World;
+            o.Mass = Mass;
+            o.UMass = fabsf(Mass);
+            o.Graph_Drag = T.Drag;
+            o.graph_GravK = T.GravK;
+            o.Graph_SpinDrag = T.SpinDrag;
+            o.Graph_TrackX = T.TrackX;
+            o.Graph_TrackY = T.TrackY;
+            o.Graph_TrackZ = T.TrackZ;
+            o.Graph_PhysBlend = T.PhysBlend;
+            o.DragK = Rand(rng);
+            o.SpinDragK = Rand(rng);
+            o.GravKK = Rand(rng);
+            o.KTrackX = Rand(rng);
+            o.KTrackY = Rand(rng);
+            o.KTrackZ = Rand(rng);
+            o.KPhysBlend = Rand(rng);
+            Old.push_back(&o);
+
+            p.ElapsedTime[n] = o.ElapsedTime;
+            p.LifeTime[n] = o.LifeTime;
+            p.PhysPosX[n] = p.RenderPosX[n] = p.OldRenderPosX[n] = Pos.x;
+            p.PhysPosY[n] = p.RenderPosY[n] = p.OldRenderPosY[n] = Pos.y;
+            p.PhysPosZ[n] = p.RenderPosZ[n] = p.OldRenderPosZ[n] = Pos.z;
+            p.VelocityX[n] = Velocity.x;
+            p.VelocityY[n] = Velocity.y;
+            p.VelocityZ[n] = Velocity.z;
+            p.Mass[n] = o.Mass;
+            p.UMass[n] = o.UMass;
+            p.Angle[n] = p.OldRenderAngle[n] = 0.0f;
+            p.Spin[n] = o.Spin;
+            for (uint32_t row = 0; row < 4; row++)
+            {
+                for (uint32_t col = 0; col < 3; col++)
+                    p.World[row * 3 + col][n] = World.m[row][col];
+            }
+            p.DragK[n] = o.DragK;
+            p.SpinDragK[n] = o.SpinDragK;
+            p.GravKK[n] = o.GravKK;
+            p.KTrackX[n] = o.KTrackX;
+            p.KTrackY[n] = o.KTrackY;
+            p.KTrackZ[n] = o.KTrackZ;
+            p.KPhysBlend[n] = o.KPhysBlend;
+            p.Graphs[n] = {};
+            p.Graphs[n].Drag = T.Drag;
+            p.Graphs[n].GravK = T.GravK;
+            p.Graphs[n].SpinDrag = T.SpinDrag;
+            p.Graphs[n].TrackX = T.TrackX;
+            p.Graphs[n].TrackY = T.TrackY;
+            p.Graphs[n].TrackZ = T.TrackZ;
+            p.Graphs[n].PhysBlend = T.PhysBlend;
+            p.ActiveCount[n] = &ActiveCount;
+            p.AttachedEmitter[n] = nullptr;
+        }
+    }
+};
+
+bool Near(float Value, float Expected)
+{
+    return std::isfinite(Value) && std::fabs(Value - Expected) <= 1e-3f * std::max(1.0f, std::fabs(Expected));
+}
+} // namespace
+
+TEST_CASE("Billboard kernel matches the per particle update", "[bb_particles]")
+{
+    constexpr auto DeltaTime = 1.0f / 30.0f;
+    // the counts end mid block and the deaths move the end, the last block runs over dead slots
+    for (const auto Count : {1u, 7u, 1001u, static_cast<uint32_t>(MAX_BILLBOARDS)})
+    {
+        BothLayouts Both(Count, 3.0f, Count);
+        auto &p = *Both.Arrays;
+        for (int Frame = 0; Frame < 120 && p.Count > 0; Frame++)
+        {
+            p.Process(DeltaTime);
+            OldProcess(Both.Old, DeltaTime);
+
+            INFO("count " << Count << ", frame " << Frame);
+            REQUIRE(p.Count == Both.Old.size());
+            REQUIRE(Both.ActiveCount == Both.OldActiveCount);
+            for (uint32_t n = 0; n < p.Count; n++)
+            {
+                const auto &o = *Both.Old[n];
+                INFO("particle " << n << ", mass " << o.Mass);
+                CHECK(p.LifeTime[n] == o.LifeTime);
+                CHECK(Near(p.VelocityX[n], o.Velocity.x));
+                CHECK(Near(p.VelocityY[n], o.Velocity.y));
+                CHECK(Near(p.VelocityZ[n], o.Velocity.z));
+                CHECK(Near(p.PhysPosX[n], o.PhysPos.x));
+                CHECK(Near(p.PhysPosY[n], o.PhysPos.y));
+                CHECK(Near(p.PhysPosZ[n], o.PhysPos.z));
+                CHECK(Near(p.RenderPosX[n], o.RenderPos.x));
+                CHECK(Near(p.RenderPosY[n], o.RenderPos.y));
+                CHECK(Near(p.RenderPosZ[n], o.RenderPos.z));
+                CHECK(Near(p.OldRenderPosX[n], o.OldRenderPos.x));
+                CHECK(Near(p.OldRenderPosY[n], o.OldRenderPos.y));
+                CHECK(Near(p.OldRenderPosZ[n], o.OldRenderPos.z));
+                CHECK(Near(p.Angle[n], o.RenderAngle));
+            }
+        }
+        // the lifetimes are shorter than the frames run
+        CHECK(p.Count == 0);
+        CHECK(Both.ActiveCount == 0);
+    }
+}
+
+TEST_CASE("Massless billboards are only moved by their velocity", "[bb_particles]")
+{
+    constexpr auto DeltaTime = 1.0f / 30.0f;
+    BothLayouts Both(64, 100.0f, 7);
+    auto &p = *Both.Arrays;
+    std::vector<float> VelocityY(p.Count);
+    for (uint32_t n = 0; n < p.Count; n++)
+        VelocityY[n] = p.VelocityY[n];
+    p.Process(DeltaTime);
+    REQUIRE(p.Count == 64);
+    for (uint32_t n = 0; n < p.Count; n += 5)
+    {
+        INFO("particle " << n);
+        REQUIRE(p.UMass[n] == 0.0f);
+        CHECK(p.VelocityY[n] == VelocityY[n]);
+    }
+}
+
+TEST_CASE("Billboard update of the old layout and the arrays", "[bb_particles][benchmark]")
+{
+    // a full processor of long living particles, nobody dies during the samples
+    constexpr auto DeltaTime = 1.0f / 60.0f;
+    BothLayouts Both(MAX_BILLBOARDS, 1.0e6f, 11);
+    for (auto *o : Both.Old)
+        o->ElapsedTime = 0.0f;
+    for (uint32_t n = 0; n < Both.Arrays->Count; n++)
+        Both.Arrays->ElapsedTime[n] = 0.0f;
+
+    BENCHMARK("old layout")
+    {
+        OldProcess(Both.Old, DeltaTime);
+        return Both.Old.size();
+    };
+
+    BENCHMARK("arrays")
+    {
+        Both.Arrays->Process(DeltaTime);
+        return Both.Arrays->Count;
+    };
+}
@@ -0,0 +1,161 @@
+#include "i_common/graph_time.h"
+#include "system/data_source/data_graph.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+// the graph walked from its first vertex, as DataGraph read it before the baked tables
+float ScanGraph(const std::vector<GraphVertex> &Graph, float Time)
+{
+    for (size_t Index = 0; Index + 1 < Graph.size(); Index++)
+    {
+        const auto &From = Graph[Index];
+        const auto &To = Graph[Index + 1];
+        if (Time <= To.Time)
+        {
+            const auto SegmentDeltaTime = To.Time - From.Time;
+            const auto blend_k = SegmentDeltaTime > 0.001f ? (Time - From.Time) / SegmentDeltaTime : 0.0f;
+            return From.Val + (To.Val - From.Val) * blend_k;
+        }
+    }
+    return 0.0f;
+}
+
+// keys at random times over 0..100, closed by the vertex at MAX_GRAPH_TIME as the editor saves them
+std::vector<GraphVertex> MakeGraph(std::mt19937 &rng, uint32_t NumKeys, bool bClosed)
+{
+    std::uniform_real_distribution<float> Time(0.0f, 100.0f);
+    std::uniform_real_distribution<float> Value(-50.0f, 50.0f);
+    std::vector<float> Times(NumKeys);
+    std::ranges::generate(Times, [&] { return Time(rng); });
+    Times.front() = MIN_GRAPH_TIME;
+    std::ranges::sort(Times);
+
+    std::vector<GraphVertex> Graph;
+    for (const auto T : Times)
+    {
+        GraphVertex Vertex;
+        Vertex.Time = T;
+        Vertex.Val = Value(rng);
+        Graph.push_back(Vertex);
+    }
+    if (bClosed)
+    {
+        auto Last = Graph.back();
+        Last.Time = MAX_GRAPH_TIME;
+        Graph.push_back(Last);
+    }
+    return Graph;
+}
+
+// the largest change of value per unit of time, the baked tables may be off by it times their step
+float MaxSlope(const std::vector<GraphVertex> &Graph)
+{
+    float Slope = 0.0f;
+    for (size_t n = 0; n + 1 < Graph.size(); n++)
+    {
+        const auto Dt = Graph[n + 1].Time - Graph[n].Time;
+        if (Dt > 0.001f)
+            Slope = std::max(Slope, std::fabs(Graph[n + 1].Val - Graph[n].Val) / Dt);
+    }
+    return Slope;
+}
+} // namespace
+
+TEST_CASE("Baked graph matches the graph it was baked from", "[data_graph]")
+{
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> Time(-10.0f, 120.0f);
+    for (const auto bClosed : {true, false})
+    {
+        for (const auto NumKeys : {2u, 3u, 8u, 40u})
+        {
+            const auto MinGraph = MakeGraph(rng, NumKeys, bClosed);
+            const auto MaxGraph = MakeGraph(rng, NumKeys + 1, bClosed);
+            DataGraph Graph;
+            Graph.SetValues(MinGraph.data(), static_cast<uint32_t>(MinGraph.size()), MaxGraph.data(),
+                            static_cast<uint32_t>(MaxGraph.size()));
+
+            // a step of the table is at most 100 / 256, the keys fall between its samples
+            const auto Tolerance = std::max(MaxSlope(MinGraph), MaxSlope(MaxGraph)) * 100.0f / 256.0f + 1e-3f;
+            for (int n = 0; n < 2000; n++)
+            {
+                const auto T = Time(rng);
+                INFO("keys " << NumKeys << ", closed " << bClosed << ", time " << T);
+                CHECK(std::fabs(Graph.Sample(T, 1.0f, 0.0f) - ScanGraph(MinGraph, T)) <= Tolerance);
+                CHECK(std::fabs(Graph.Sample(T, 1.0f, 1.0f) - ScanGraph(MaxGraph, T)) <= Tolerance);
+            }
+            // the keys themselves
+            for (const auto &Vertex : MinGraph)
+            {
+                if (Vertex.Time < MAX_GRAPH_TIME)
+                    CHECK(std::fabs(Graph.Sample(Vertex.Time, 1.0f, 0.0f) - ScanGraph(MinGraph, Vertex.Time)) <=
+                          Tolerance);
+            }
+        }
+    }
+}
+
+TEST_CASE("Relative graphs are looked up by the share of the lifetime", "[data_graph]")
+{
+    std::mt19937 rng(4);
+    const auto MinGraph = MakeGraph(rng, 6, true);
+    const auto MaxGraph = MakeGraph(rng, 6, true);
+    DataGraph Graph;
+    Graph.SetRelative(true);
+    Graph.SetValues(MinGraph.data(), static_cast<uint32_t>(MinGraph.size()), MaxGraph.data(),
+                    static_cast<uint32_t>(MaxGraph.size()));
+    const auto Tolerance = std::max(MaxSlope(MinGraph), MaxSlope(MaxGraph)) * 100.0f / 256.0f + 1e-3f;
+    for (const auto T : {0.0f, 0.5f, 1.25f, 2.0f})
+        CHECK(std::fabs(Graph.Sample(T, 2.0f, 0.5f) -
+                        (ScanGraph(MinGraph, T * 50.0f) + ScanGraph(MaxGraph, T * 50.0f)) * 0.5f) <= Tolerance);
+}
+
+TEST_CASE("Baked graph against the graph scan", "[data_graph][benchmark]")
+{
+    // a system of a few thousand particles at random ages, each reading a graph of a dozen keys
+    std::mt19937 rng(5);
+    const auto MinGraph = MakeGraph(rng, 12, true);
+    const auto MaxGraph = MakeGraph(rng, 12, true);
+    DataGraph Graph;
+    Graph.SetValues(MinGraph.data(), static_cast<uint32_t>(MinGraph.size()), MaxGraph.data(),
+                    static_cast<uint32_t>(MaxGraph.size()));
+    std::uniform_real_distribution<float> Time(0.0f, 100.0f);
+    std::uniform_real_distribution<float> Rand(0.0f, 1.0f);
+    std::vector<float> Times(4096), Rands(4096);
+    std::ranges::generate(Times, [&] { return Time(rng); });
+    std::ranges::generate(Rands, [&] { return Rand(rng); });
+
+    BENCHMARK("graph scan")
+    {
+        float Sum = 0.0f;
+        for (size_t n = 0; n < Times.size(); n++)
+        {
+            const auto Min = ScanGraph(MinGraph, Times[n]);
+            Sum += Min + (ScanGraph(MaxGraph, Times[n]) - Min) * Rands[n];
+        }
+        return Sum;
+    };
+
+    BENCHMARK("baked table")
+    {
+        float Sum = 0.0f;
+        for (size_t n = 0; n < Times.size(); n++)
+            Sum += Graph.Sample(Times[n], 1.0f, Rands[n]);
+        return Sum;
+    };
+
+    BENCHMARK("bake")
+    {
+        Graph.SetValues(MinGraph.data(), static_cast<uint32_t>(MinGraph.size()), MaxGraph.data(),
+                        static_cast<uint32_t>(MaxGraph.size()));
+        return Graph.GetMinCount();
+    };
+}
@@ -0,0 +1,114 @@
+#include "radix_sort.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+// the key BillBoardProcessor::CalcDistanceToCamera sorts a billboard by, far ones first
+uint32_t DistanceKey(float Distance)
+{
+    return 0xFFFFFFu - (std::bit_cast<uint32_t>(Distance) >> 8);
+}
+
+std::vector<float> MakeDistances(size_t Count, uint32_t Seed)
+{
+    std::mt19937 rng(Seed);
+    std::uniform_real_distribution<float> Distance(0.1f, 500.0f);
+    std::vector<float> Distances(Count);
+    std::ranges::generate(Distances, [&] { return Distance(rng); });
+    return Distances;
+}
+
+// the order std::stable_sort gives, the values are the indices of the keys
+template <uint32_t KeyBits> std::vector<uint32_t> StableOrder(const std::vector<uint32_t> &Keys)
+{
+    constexpr uint64_t Mask = (uint64_t{1} << KeyBits) - 1;
+    std::vector<uint32_t> Order(Keys.size());
+    std::iota(Order.begin(), Order.end(), 0);
+    std::ranges::stable_sort(Order, [&](uint32_t a, uint32_t b) { return (Keys[a] & Mask) < (Keys[b] & Mask); });
+    return Order;
+}
+
+template <uint32_t KeyBits> void CheckSort(const std::vector<uint32_t> &Keys)
+{
+    auto SortedKeys = Keys;
+    std::vector<uint32_t> Values(Keys.size()), TmpKeys, TmpValues;
+    std::iota(Values.begin(), Values.end(), 0);
+    RadixSort<KeyBits>(SortedKeys, Values, TmpKeys, TmpValues);
+    INFO(KeyBits << " bits, " << Keys.size() << " keys");
+    CHECK(Values == StableOrder<KeyBits>(Keys));
+    for (size_t n = 0; n < Values.size(); n++)
+        CHECK(SortedKeys[n] == Keys[Values[n]]);
+}
+} // namespace
+
+TEST_CASE("Radix sort orders as a stable sort", "[radix_sort]")
+{
+    std::mt19937 rng(1);
+    for (const size_t Count : {size_t{0}, size_t{1}, size_t{2}, size_t{1000}, size_t{20000}})
+    {
+        std::vector<uint32_t> Keys(Count);
+        std::ranges::generate(Keys, [&] { return rng(); });
+        CheckSort<8>(Keys);
+        CheckSort<16>(Keys);
+        CheckSort<24>(Keys);
+        CheckSort<32>(Keys);
+
+        // few distinct keys, the equal ones keep their order
+        for (auto &Key : Keys)
+            Key &= 0x0F0F;
+        CheckSort<16>(Keys);
+        CheckSort<24>(Keys);
+    }
+}
+
+TEST_CASE("Billboards are sorted far ones first", "[radix_sort]")
+{
+    const auto Distances = MakeDistances(5000, 2);
+    std::vector<uint32_t> Keys, Order(Distances.size()), TmpKeys, TmpOrder;
+    for (const auto Distance : Distances)
+        Keys.push_back(DistanceKey(Distance));
+    std::iota(Order.begin(), Order.end(), 0);
+    RadixSort<24>(Keys, Order, TmpKeys, TmpOrder);
+
+    // only the dropped low bits of the distance may swap neighbours
+    for (size_t n = 1; n < Order.size(); n++)
+        CHECK(Distances[Order[n - 1]] * (1.0f + 1e-4f) >= Distances[Order[n]]);
+}
+
+TEST_CASE("Radix sort against std::sort", "[radix_sort][benchmark]")
+{
+    for (const size_t Count : {size_t{1000}, size_t{20000}, size_t{200000}})
+    {
+        const auto Distances = MakeDistances(Count, 3);
+        std::vector<uint32_t> Keys, Order, TmpKeys, TmpOrder;
+
+        BENCHMARK("std::sort, " + std::to_string(Count) + " billboards")
+        {
+            Order.resize(Count);
+            std::iota(Order.begin(), Order.end(), 0);
+            std::sort(Order.begin(), Order.end(),
+                      [&](uint32_t a, uint32_t b) { return Distances[a] > Distances[b]; });
+            return Order.front();
+        };
+
+        BENCHMARK("RadixSort<24>, " + std::to_string(Count) + " billboards")
+        {
+            Keys.clear();
+            for (const auto Distance : Distances)
+                Keys.push_back(DistanceKey(Distance));
+            Order.resize(Count);
+            std::iota(Order.begin(), Order.end(), 0);
+            RadixSort<24>(Keys, Order, TmpKeys, TmpOrder);
+            return Order.front();
+        };
+    }
+}
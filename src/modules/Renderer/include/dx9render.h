@@ -289,6 +289,8 @@ class VDX9RENDER : public SERVICE
 
     // DX9Render: Textures Section
     virtual int32_t TextureCreate(const char *fname) = 0;
+    // Returns at once, the texture shows a placeholder until it is streamed in (if streaming is enabled)
+    virtual int32_t TextureCreateAsync(const char *fname) = 0;
     virtual int32_t TextureCreate(UINT width, UINT height, UINT levels, uint32_t usage, D3DFORMAT format, D3DPOOL pool) = 0;
     virtual bool TextureSet(int32_t stage, int32_t texid) = 0;
     virtual bool TextureRelease(int32_t texid) = 0;
@@ -315,7 +317,10 @@ class VDX9RENDER : public SERVICE
     virtual bool SetFontIniFileName(const char *iniName) = 0;
 
     // DX9Render: Techniques Section
+    // returns a handle for the technique name, it stays valid while the render exists, or -1 on error
+    virtual int32_t TechniqueGetHandle(const char *cBlockName) = 0;
     virtual bool TechniqueExecuteStart(const char *cBlockName) = 0;
+    virtual bool TechniqueExecuteStart(int32_t technique) = 0; // same without the name lookup
     virtual bool TechniqueExecuteNext() = 0;
 
     // DX9Render: Draw Section
@@ -4,6 +4,7 @@
 
 #include "core.h"
 // #include <DxErr.h>
+#include <algorithm>
 #include <d2derr.h>
 #include <iterator>
 
@@ -23,6 +24,299 @@ inline bool Effects::ErrorHandler(HRESULT hr, const char *file, unsigned line, c
     return false;
 }
 
+void EffectStateManager::setDevice(IDirect3DDevice9 *device, StateCache *stateCache)
+{
+    restore();
+    device_ = device;
+    stateCache_ = stateCache;
+}
+
+bool EffectStateManager::save(StateKind kind, uint32_t index, uint32_t type)
+{
+    for (const auto &state : states_)
+        if (state.kind == kind && state.index == index && state.type == type)
+            return false;
+
+    DWORD value = 0;
+    switch (kind)
+    {
+    case StateKind::Render:
+        device_->GetRenderState(static_cast<D3DRENDERSTATETYPE>(index), &value);
+        break;
+    case StateKind::Sampler:
+        device_->GetSamplerState(index, static_cast<D3DSAMPLERSTATETYPE>(type), &value);
+        break;
+    case StateKind::TextureStage:
+        device_->GetTextureStageState(index, static_cast<D3DTEXTURESTAGESTATETYPE>(type), &value);
+        break;
+    case StateKind::Fvf:
+        device_->GetFVF(&value);
+        break;
+    case StateKind::LightEnable: {
+        BOOL enable = FALSE;
+        device_->GetLightEnable(index, &enable);
+        value = enable;
+        break;
+    }
+    }
+    states_.push_back(SavedState{kind, index, type, value});
+    return true;
+}
+
+void EffectStateManager::restore()
+{
+    for (const auto &state : states_)
+    {
+        switch (state.kind)
+        {
+        case StateKind::Render:
+            setRenderState(static_cast<D3DRENDERSTATETYPE>(state.index), state.value);
+            break;
+        case StateKind::Sampler:
+            setSamplerState(state.index, static_cast<D3DSAMPLERSTATETYPE>(state.type), state.value);
+            break;
+        case StateKind::TextureStage:
+            setTextureStageState(state.index, static_cast<D3DTEXTURESTAGESTATETYPE>(state.type), state.value);
+            break;
+        case StateKind::Fvf:
+            device_->SetFVF(state.value);
+            break;
+        case StateKind::LightEnable:
+            device_->LightEnable(state.index, state.value);
+            break;
+        }
+    }
+    states_.clear();
+
+    for (auto &[stage, texture] : textures_)
+    {
+        device_->SetTexture(stage, texture);
+        if (texture)
+            texture->Release();
+    }
+    textures_.clear();
+    for (const auto &[state, matrix] : transforms_)
+        device_->SetTransform(state, &matrix);
+    transforms_.clear();
+    for (const auto &[index, light] : lights_)
+        device_->SetLight(index, &light);
+    lights_.clear();
+
+    if (isVertexShaderSaved_)
+    {
+        device_->SetVertexShader(vertexShader_);
+        if (vertexShader_)
+            vertexShader_->Release();
+        vertexShader_ = nullptr;
+        isVertexShaderSaved_ = false;
+    }
+    if (isPixelShaderSaved_)
+    {
+        device_->SetPixelShader(pixelShader_);
+        if (pixelShader_)
+            pixelShader_->Release();
+        pixelShader_ = nullptr;
+        isPixelShaderSaved_ = false;
+    }
+    if (isMaterialSaved_)
+    {
+        device_->SetMaterial(&material_);
+        isMaterialSaved_ = false;
+    }
+    if (isNPatchModeSaved_)
+    {
+        device_->SetNPatchMode(nPatchMode_);
+        isNPatchModeSaved_ = false;
+    }
+}
+
+HRESULT EffectStateManager::setRenderState(D3DRENDERSTATETYPE state, DWORD value)
+{
+    if (!stateCache_->SetRenderState(state, value))
+        return D3D_OK;
+    const auto hr = device_->SetRenderState(state, value);
+    if (FAILED(hr))
+        stateCache_->ForgetRenderState(state);
+    return hr;
+}
+
+HRESULT EffectStateManager::setSamplerState(DWORD sampler, D3DSAMPLERSTATETYPE type, DWORD value)
+{
+    if (!stateCache_->SetSamplerState(sampler, type, value))
+        return D3D_OK;
+    const auto hr = device_->SetSamplerState(sampler, type, value);
+    if (FAILED(hr))
+        stateCache_->ForgetSamplerState(sampler, type);
+    return hr;
+}
+
+HRESULT EffectStateManager::setTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE type, DWORD value)
+{
+    if (!stateCache_->SetTextureStageState(stage, type, value))
+        return D3D_OK;
+    const auto hr = device_->SetTextureStageState(stage, type, value);
+    if (FAILED(hr))
+        stateCache_->ForgetTextureStageState(stage, type);
+    return hr;
+}
+
+HRESULT EffectStateManager::QueryInterface(REFIID iid, LPVOID *ppv)
+{
+    if (iid == IID_IUnknown || iid == IID_ID3DXEffectStateManager)
+    {
+        *ppv = static_cast<ID3DXEffectStateManager *>(this);
+        return S_OK;
+    }
+    *ppv = nullptr;
+    return E_NOINTERFACE;
+}
+
+ULONG EffectStateManager::AddRef()
+{
+    return 1;
+}
+
+ULONG EffectStateManager::Release()
+{
+    return 1;
+}
+
+HRESULT EffectStateManager::SetRenderState(D3DRENDERSTATETYPE State, DWORD Value)
+{
+    save(StateKind::Render, State, 0);
+    return setRenderState(State, Value);
+}
+
+HRESULT EffectStateManager::SetSamplerState(DWORD Sampler, D3DSAMPLERSTATETYPE Type, DWORD Value)
+{
+    save(StateKind::Sampler, Sampler, Type);
+    return setSamplerState(Sampler, Type, Value);
+}
+
+HRESULT EffectStateManager::SetTextureStageState(DWORD Stage, D3DTEXTURESTAGESTATETYPE Type, DWORD Value)
+{
+    save(StateKind::TextureStage, Stage, Type);
+    return setTextureStageState(Stage, Type, Value);
+}
+
+HRESULT EffectStateManager::SetTexture(DWORD Stage, LPDIRECT3DBASETEXTURE9 pTexture)
+{
+    if (std::ranges::find(textures_, Stage, &std::pair<DWORD, IDirect3DBaseTexture9 *>::first) == textures_.end())
+    {
+        IDirect3DBaseTexture9 *texture = nullptr;
+        device_->GetTexture(Stage, &texture);
+        textures_.emplace_back(Stage, texture);
+    }
+    return device_->SetTexture(Stage, pTexture);
+}
+
+HRESULT EffectStateManager::SetVertexShader(LPDIRECT3DVERTEXSHADER9 pShader)
+{
+    if (!isVertexShaderSaved_)
+    {
+        device_->GetVertexShader(&vertexShader_);
+        isVertexShaderSaved_ = true;
+    }
+    return device_->SetVertexShader(pShader);
+}
+
+HRESULT EffectStateManager::SetPixelShader(LPDIRECT3DPIXELSHADER9 pShader)
+{
+    if (!isPixelShaderSaved_)
+    {
+        device_->GetPixelShader(&pixelShader_);
+        isPixelShaderSaved_ = true;
+    }
+    return device_->SetPixelShader(pShader);
+}
+
+HRESULT EffectStateManager::SetFVF(DWORD FVF)
+{
+    save(StateKind::Fvf, 0, 0);
+    return device_->SetFVF(FVF);
+}
+
+HRESULT EffectStateManager::SetTransform(D3DTRANSFORMSTATETYPE State, CONST D3DMATRIX *pMatrix)
+{
+    if (std::ranges::find(transforms_, State, &std::pair<D3DTRANSFORMSTATETYPE, D3DMATRIX>::first) ==
+        transforms_.end())
+    {
+        D3DMATRIX matrix;
+        device_->GetTransform(State, &matrix);
+        transforms_.emplace_back(State, matrix);
+    }
+    return device_->SetTransform(State, pMatrix);
+}
+
+HRESULT EffectStateManager::SetMaterial(CONST D3DMATERIAL9 *pMaterial)
+{
+    if (!isMaterialSaved_)
+    {
+        device_->GetMaterial(&material_);
+        isMaterialSaved_ = true;
+    }
+    return device_->SetMaterial(pMaterial);
+}
+
+HRESULT EffectStateManager::SetLight(DWORD Index, CONST D3DLIGHT9 *pLight)
+{
+    if (std::ranges::find(lights_, Index, &std::pair<DWORD, D3DLIGHT9>::first) == lights_.end())
+    {
+        D3DLIGHT9 light{};
+        device_->GetLight(Index, &light);
+        lights_.emplace_back(Index, light);
+    }
+    return device_->SetLight(Index, pLight);
+}
+
+HRESULT EffectStateManager::LightEnable(DWORD Index, BOOL Enable)
+{
+    save(StateKind::LightEnable, Index, 0);
+    return device_->LightEnable(Index, Enable);
+}
+
+HRESULT EffectStateManager::SetNPatchMode(FLOAT NumSegments)
+{
+    if (!isNPatchModeSaved_)
+    {
+        nPatchMode_ = device_->GetNPatchMode();
+        isNPatchModeSaved_ = true;
+    }
+    return device_->SetNPatchMode(NumSegments);
+}
+
+HRESULT EffectStateManager::SetVertexShaderConstantF(UINT RegisterIndex, CONST FLOAT *pConstantData,
+                                                     UINT RegisterCount)
+{
+    return device_->SetVertexShaderConstantF(RegisterIndex, pConstantData, RegisterCount);
+}
+
+HRESULT EffectStateManager::SetVertexShaderConstantI(UINT RegisterIndex, CONST INT *pConstantData, UINT RegisterCount)
+{
+    return device_->SetVertexShaderConstantI(RegisterIndex, pConstantData, RegisterCount);
+}
+
+HRESULT EffectStateManager::SetVertexShaderConstantB(UINT RegisterIndex, CONST BOOL *pConstantData,
+                                                     UINT RegisterCount)
+{
+    return device_->SetVertexShaderConstantB(RegisterIndex, pConstantData, RegisterCount);
+}
+
+HRESULT EffectStateManager::SetPixelShaderConstantF(UINT RegisterIndex, CONST FLOAT *pConstantData, UINT RegisterCount)
+{
+    return device_->SetPixelShaderConstantF(RegisterIndex, pConstantData, RegisterCount);
+}
+
+HRESULT EffectStateManager::SetPixelShaderConstantI(UINT RegisterIndex, CONST INT *pConstantData, UINT RegisterCount)
+{
+    return device_->SetPixelShaderConstantI(RegisterIndex, pConstantData, RegisterCount);
+}
+
+HRESULT EffectStateManager::SetPixelShaderConstantB(UINT RegisterIndex, CONST BOOL *pConstantData, UINT RegisterCount)
+{
+    return device_->SetPixelShaderConstantB(RegisterIndex, pConstantData, RegisterCount);
+}
+
 Effects::Effects(IDirect3DDevice9 *d3dDevice) : device_(d3dDevice), currentTechnique_(nullptr), currentPass_(0u)
 {
 }
@@ -32,9 +326,10 @@ Effects::~Effects()
     release();
 }
 
-void Effects::setDevice(IDirect3DDevice9 *device)
+void Effects::setDevice(IDirect3DDevice9 *device, StateCache *stateCache)
 {
     device_ = device;
+    stateManager_.setDevice(device, stateCache);
 }
 
 void Effects::compile(const char *fxPath)
@@ -53,6 +348,7 @@ void Effects::compile(const char *fxPath)
     }
 
     effects_.push_back(fx);
+    CHECKD3DERR(fx->SetStateManager(&stateManager_));
 
     D3DXHANDLE technique = nullptr;
     CHECKD3DERR(fx->FindNextValidTechnique(nullptr, &technique));
@@ -67,13 +363,14 @@ void Effects::compile(const char *fxPath)
         name_in_lowercase.reserve(len);
         std::transform(desc.Name, desc.Name + len, std::back_inserter(name_in_lowercase), tolower);
 
-        if (techniques_.count(name_in_lowercase) > 0)
+        if (techniqueIndices_.count(name_in_lowercase) > 0)
         {
             core.Trace("Warning: duplicate technique (%s)", desc.Name);
         }
         else
         {
-            techniques_.emplace(std::move(name_in_lowercase), Technique(fx, technique, desc));
+            techniqueIndices_.emplace(std::move(name_in_lowercase), static_cast<int32_t>(techniques_.size()));
+            techniques_.emplace_back(fx, technique, desc);
         }
 
         CHECKD3DERR(fx->FindNextValidTechnique(technique, &technique));
@@ -86,33 +383,49 @@ void Effects::release()
         fx->Release();
     effects_.clear();
     techniques_.clear();
+    techniqueIndices_.clear();
     currentTechnique_ = nullptr;
 }
 
-bool Effects::begin(const std::string &techniqueName)
+int32_t Effects::find(const std::string &techniqueName) const
 {
     // transform to lowercase to be compliant with the original code
     std::string name_in_lowercase;
     name_in_lowercase.reserve(techniqueName.length());
     std::transform(std::begin(techniqueName), std::end(techniqueName), std::back_inserter(name_in_lowercase), tolower);
 
-    debugMsg_ = name_in_lowercase;
-    const auto technique = techniques_.find(name_in_lowercase);
-    if (technique == techniques_.end())
+    const auto technique = techniqueIndices_.find(name_in_lowercase);
+    return technique != techniqueIndices_.end() ? technique->second : -1;
+}
+
+bool Effects::begin(const std::string &techniqueName)
+{
+    const auto technique = find(techniqueName);
+    if (technique < 0)
     {
-        core.Trace("Warning: technique (%s) not found!", name_in_lowercase.c_str());
+        core.Trace("Warning: technique (%s) not found!", techniqueName.c_str());
         return false;
     }
 
-    currentTechnique_ = &technique->second;
+    return begin(technique);
+}
+
+bool Effects::begin(int32_t technique)
+{
+    if (technique < 0 || technique >= static_cast<int32_t>(techniques_.size()))
+        return false;
+
+    currentTechnique_ = &techniques_[technique];
+    debugMsg_ = currentTechnique_->desc.Name;
     auto *fx = currentTechnique_->fx;
     CHECKD3DERR(fx->SetTechnique(currentTechnique_->handle));
 
+    // the state manager saves and restores the states instead of the effect
     UINT passes = 0;
-    CHECKD3DERR(fx->Begin(&passes, 0));
+    CHECKD3DERR(fx->Begin(&passes, D3DXFX_DONOTSAVESTATE));
     if (passes == 0)
     {
-        core.Trace("Warning: empty technique (%s)!", name_in_lowercase.c_str());
+        core.Trace("Warning: empty technique (%s)!", currentTechnique_->desc.Name);
         return false;
     }
 
@@ -136,6 +449,7 @@ bool Effects::next()
         }
 
         CHECKD3DERR(fx->End());
+        stateManager_.restore();
         currentTechnique_ = nullptr;
     }
     return false;
@@ -143,12 +457,7 @@ bool Effects::next()
 
 ID3DXEffect *Effects::getEffectPointer(const std::string &techniqueName)
 {
-    // transform to lowercase to be compliant with the original code
-    std::string name_in_lowercase;
-    name_in_lowercase.reserve(techniqueName.length());
-    std::transform(std::begin(techniqueName), std::end(techniqueName), std::back_inserter(name_in_lowercase), tolower);
-
-    const auto technique = techniques_.find(name_in_lowercase);
-    return technique != techniques_.end() ? technique->second.fx : nullptr;
+    const auto technique = find(techniqueName);
+    return technique >= 0 ? techniques_[technique].fx : nullptr;
 }
 #endif // _WIN32
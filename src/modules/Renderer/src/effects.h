@@ -1,6 +1,8 @@
 #ifdef _WIN32 // Effects
 #pragma once
 
+#include "state_cache.h"
+
 #include <cstdint>
 #include <d3d9.h>
 #include <d3dx9.h>
@@ -8,6 +10,83 @@
 #include <vector>
 #include <string>
 
+// The effects set the states of their passes through it: render, sampler and texture stage states go through the
+// renderer state cache, a value the device already has is dropped. The techniques begin with D3DXFX_DONOTSAVESTATE,
+// the manager keeps the value each state had before the technique and puts it back through the cache at its end
+class EffectStateManager final : public ID3DXEffectStateManager
+{
+  public:
+    void setDevice(IDirect3DDevice9 *device, StateCache *stateCache);
+    // put back the states the technique has set
+    void restore();
+
+    // owned by Effects, not reference counted
+    STDMETHOD(QueryInterface)(REFIID iid, LPVOID *ppv) override;
+    STDMETHOD_(ULONG, AddRef)() override;
+    STDMETHOD_(ULONG, Release)() override;
+
+    STDMETHOD(SetRenderState)(D3DRENDERSTATETYPE State, DWORD Value) override;
+    STDMETHOD(SetSamplerState)(DWORD Sampler, D3DSAMPLERSTATETYPE Type, DWORD Value) override;
+    STDMETHOD(SetTextureStageState)(DWORD Stage, D3DTEXTURESTAGESTATETYPE Type, DWORD Value) override;
+    STDMETHOD(SetTexture)(DWORD Stage, LPDIRECT3DBASETEXTURE9 pTexture) override;
+    STDMETHOD(SetVertexShader)(LPDIRECT3DVERTEXSHADER9 pShader) override;
+    STDMETHOD(SetPixelShader)(LPDIRECT3DPIXELSHADER9 pShader) override;
+    STDMETHOD(SetFVF)(DWORD FVF) override;
+    STDMETHOD(SetTransform)(D3DTRANSFORMSTATETYPE State, CONST D3DMATRIX *pMatrix) override;
+    STDMETHOD(SetMaterial)(CONST D3DMATERIAL9 *pMaterial) override;
+    STDMETHOD(SetLight)(DWORD Index, CONST D3DLIGHT9 *pLight) override;
+    STDMETHOD(LightEnable)(DWORD Index, BOOL Enable) override;
+    STDMETHOD(SetNPatchMode)(FLOAT NumSegments) override;
+    // constants are left as the pass set them, every shader gets its own from its effect or draw call
+    STDMETHOD(SetVertexShaderConstantF)(UINT RegisterIndex, CONST FLOAT *pConstantData, UINT RegisterCount) override;
+    STDMETHOD(SetVertexShaderConstantI)(UINT RegisterIndex, CONST INT *pConstantData, UINT RegisterCount) override;
+    STDMETHOD(SetVertexShaderConstantB)(UINT RegisterIndex, CONST BOOL *pConstantData, UINT RegisterCount) override;
+    STDMETHOD(SetPixelShaderConstantF)(UINT RegisterIndex, CONST FLOAT *pConstantData, UINT RegisterCount) override;
+    STDMETHOD(SetPixelShaderConstantI)(UINT RegisterIndex, CONST INT *pConstantData, UINT RegisterCount) override;
+    STDMETHOD(SetPixelShaderConstantB)(UINT RegisterIndex, CONST BOOL *pConstantData, UINT RegisterCount) override;
+
+  private:
+    enum class StateKind : uint32_t
+    {
+        Render,
+        Sampler,
+        TextureStage,
+        Fvf,
+        LightEnable,
+    };
+
+    struct SavedState
+    {
+        StateKind kind;
+        uint32_t index;
+        uint32_t type;
+        uint32_t value;
+    };
+
+    // false if the state was already saved by the technique
+    bool save(StateKind kind, uint32_t index, uint32_t type);
+    HRESULT setRenderState(D3DRENDERSTATETYPE state, DWORD value);
+    HRESULT setSamplerState(DWORD sampler, D3DSAMPLERSTATETYPE type, DWORD value);
+    HRESULT setTextureStageState(DWORD stage, D3DTEXTURESTAGESTATETYPE type, DWORD value);
+
+    IDirect3DDevice9 *device_ = nullptr;
+    StateCache *stateCache_ = nullptr;
+
+    std::vector<SavedState> states_;
+    // saved objects are referenced until restored
+    std::vector<std::pair<DWORD, IDirect3DBaseTexture9 *>> textures_;
+    std::vector<std::pair<D3DTRANSFORMSTATETYPE, D3DMATRIX>> transforms_;
+    std::vector<std::pair<DWORD, D3DLIGHT9>> lights_;
+    bool isVertexShaderSaved_ = false;
+    IDirect3DVertexShader9 *vertexShader_ = nullptr;
+    bool isPixelShaderSaved_ = false;
+    IDirect3DPixelShader9 *pixelShader_ = nullptr;
+    bool isMaterialSaved_ = false;
+    D3DMATERIAL9 material_{};
+    bool isNPatchModeSaved_ = false;
+    float nPatchMode_ = 0.0f;
+};
+
 class Effects final
 {
   private:
@@ -23,9 +102,11 @@ class Effects final
     };
 
     IDirect3DDevice9 *device_;
+    EffectStateManager stateManager_;
 
     std::vector<ID3DXEffect *> effects_;
-    std::unordered_map<std::string, Technique> techniques_;
+    std::vector<Technique> techniques_;
+    std::unordered_map<std::string, int32_t> techniqueIndices_;
 
     const Technique *currentTechnique_;
     uint32_t currentPass_;
@@ -42,14 +123,18 @@ class Effects final
 
     explicit Effects(IDirect3DDevice9 *d3dDevice = nullptr);
     ~Effects();
-    // Set device
-    void setDevice(IDirect3DDevice9 *device);
+    // Set device and the cache of its states
+    void setDevice(IDirect3DDevice9 *device, StateCache *stateCache);
     // Compile effect by path
     void compile(const char *fxPath);
     // Release all effects
     void release();
+    // Get technique index by name, -1 if not found. Valid until release
+    int32_t find(const std::string &techniqueName) const;
     // Begin technique
     bool begin(const std::string &techniqueName);
+    // Begin technique by index
+    bool begin(int32_t technique);
     // Execute next technique
     bool next();
     // Get effect pointer by technique name
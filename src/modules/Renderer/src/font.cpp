@@ -109,6 +109,7 @@ bool FONT::Init(const char *font_name, const char *iniName)
     if (ini->ReadString(font_name, "Techniques", buffer, sizeof(buffer) - 1, ""))
     {
         techniqueName_ = buffer;
+        technique_ = renderService_.TechniqueGetHandle(techniqueName_.c_str());
     }
     textureSizeX_ = ini->GetInt(font_name, "Texture_xsize", 1);
     textureSizeY_ = ini->GetInt(font_name, "Texture_ysize", 1);
@@ -338,7 +339,7 @@ std::optional<size_t> FONT::Print(float x, float y, const std::string_view &text
     const auto str = std::string(text);
     const char *data_PTR = str.c_str();
 
-    const auto bDraw = renderService_.TechniqueExecuteStart(techniqueName_.c_str());
+    const auto bDraw = renderService_.TechniqueExecuteStart(technique_);
     if (!bDraw)
         return xoffset;
 
@@ -354,14 +355,14 @@ std::optional<size_t> FONT::Print(float x, float y, const std::string_view &text
     {
         UpdateVertexBuffer(static_cast<int32_t>(x) + shadowOffsetX_, static_cast<int32_t>(y) + shadowOffsetY_, data_PTR, s_num, scale, color);
 
-        device_.SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ZERO);
-        device_.SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+        renderService_.SetRenderState(D3DRS_SRCBLEND, D3DBLEND_ZERO);
+        renderService_.SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
 
         device_.DrawPrimitive(D3DPT_TRIANGLELIST, 0, s_num * 2);
     }
     xoffset = UpdateVertexBuffer(static_cast<int32_t>(x), static_cast<int32_t>(y), data_PTR, s_num, scale, color);
-    device_.SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
-    device_.SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
+    renderService_.SetRenderState(D3DRS_SRCBLEND, D3DBLEND_SRCALPHA);
+    renderService_.SetRenderState(D3DRS_DESTBLEND, D3DBLEND_INVSRCALPHA);
     device_.DrawPrimitive(D3DPT_TRIANGLELIST, 0, s_num * 2);
     while (renderService_.TechniqueExecuteNext())
         ;
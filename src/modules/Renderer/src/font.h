@@ -69,6 +69,7 @@ class FONT final : public storm::VFont
     std::vector<FONT_SYMBOL> charDescriptors_{};
 
     std::string techniqueName_{};
+    int32_t technique_ = -1;
     std::string textureName_{};
 
     VDX9RENDER &renderService_;
@@ -0,0 +1,1494 @@
+#include "null_render.h"
+
+#include "core.h"
+#include "math_inlines.h"
+#include "string_compare.hpp"
+#include "texture_streamer.h"
+
+#include "Filesystem/Config/Config.hpp"
+#include "Filesystem/Constants/ConfigNames.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+
+using namespace Storm::Filesystem;
+
+// Deterministic glyph metrics of the null fonts
+#define NULL_FONT_CHAR_WIDTH 8
+#define NULL_FONT_CHAR_HEIGHT 16
+
+namespace
+{
+
+uint64_t NumVertices(D3DPRIMITIVETYPE type, uint64_t numPrimitives)
+{
+    switch (type)
+    {
+    case D3DPT_POINTLIST:
+        return numPrimitives;
+    case D3DPT_LINELIST:
+        return numPrimitives * 2;
+    case D3DPT_LINESTRIP:
+        return numPrimitives + 1;
+    case D3DPT_TRIANGLELIST:
+        return numPrimitives * 3;
+    default:
+        return numPrimitives + 2;
+    }
+}
+
+char printBuffer[4096];
+
+} // namespace
+
+void NullRender::Counters::Add(const Counters &other)
+{
+    drawCalls += other.drawCalls;
+    primitives += other.primitives;
+    userBytes += other.userBytes;
+    lockedBytes += other.lockedBytes;
+    techniques += other.techniques;
+    stateChanges += other.stateChanges;
+    textureLoads += other.textureLoads;
+    textureBytes += other.textureBytes;
+    prints += other.prints;
+}
+
+// ============================================================================================
+// Service
+// ============================================================================================
+
+NullRender::NullRender()
+    : fov_(PI / 2.0f), aspectRatio_(-1.0f), fovMultiplier_(1.0f), nearPlane_(0.1f), farPlane_(4000.0f),
+      textureDegradation_(0), isInsideScene_(false), isLoadTextureEnabled_(true), setupPathStep_(0),
+      setupPathNumber_(0), curFont_(0), backBuffer_(nullptr), depthSurface_(nullptr),
+      renderTarget_{nullptr, nullptr}, numFrames_(0)
+{
+}
+
+NullRender::~NullRender()
+{
+    if (numFrames_ > 0)
+    {
+        const auto frames = static_cast<double>(numFrames_);
+        core.Trace("NullRender: %u frames, per frame %.1f draw calls, %.1f primitives, %.0f user bytes, "
+                   "%.0f locked bytes, %.1f state changes",
+                   numFrames_, total_.drawCalls / frames, total_.primitives / frames, total_.userBytes / frames,
+                   total_.lockedBytes / frames, total_.stateChanges / frames);
+    }
+    core.Trace("NullRender: %llu texture loads, %llu texture bytes, %llu resident bytes left",
+               static_cast<unsigned long long>(total_.textureLoads + frame_.textureLoads),
+               static_cast<unsigned long long>(total_.textureBytes + frame_.textureBytes),
+               static_cast<unsigned long long>(ResidentBytes()));
+
+    while (!renderTargets_.empty())
+        PopRenderTarget();
+    Release(renderTarget_.target);
+    Release(renderTarget_.depth);
+    Release(backBuffer_);
+    Release(depthSurface_);
+
+    for (auto *vb : vertexBuffers_)
+        Release(vb);
+    for (auto &texture : textures_)
+        Release(texture.d3dtex);
+}
+
+bool NullRender::Init()
+{
+    auto config = Config::Load(Constants::ConfigNames::engine());
+    std::ignore = config.SelectSection("Main");
+
+    screenSize_.x = config.Get<std::int64_t>("screen_x", 1024);
+    screenSize_.y = config.Get<std::int64_t>("screen_y", 768);
+    fovMultiplier_ = config.Get<double>("fov_multiplier", 1.0f);
+    nearPlane_ = config.Get<double>("NearClipPlane", 0.1f);
+    farPlane_ = config.Get<double>("FarClipPlane", 4000.0f);
+    textureDegradation_ = config.Get<std::int64_t>("texture_degradation", 0);
+    fontIniFileName_ = config.Get<std::string>("startFontIniFile", "resource\\ini\\fonts.ini");
+
+    InitDevice(true, nullptr, screenSize_.x, screenSize_.y);
+    LoadFont(config.Get<std::string>("font", "normal"));
+    SetPerspective(fov_);
+    return true;
+}
+
+void NullRender::RunStart()
+{
+    frame_ = {};
+    Clear(0, nullptr, D3DCLEAR_TARGET | D3DCLEAR_ZBUFFER, 0, 1.0f, 0);
+    BeginScene();
+    isInsideScene_ = true;
+}
+
+void NullRender::RunEnd()
+{
+    isInsideScene_ = false;
+    EndScene();
+    total_.Add(frame_);
+    numFrames_++;
+}
+
+const NullRender::Counters &NullRender::FrameCounters() const
+{
+    return frame_;
+}
+
+const NullRender::Counters &NullRender::TotalCounters() const
+{
+    return total_;
+}
+
+uint32_t NullRender::NumFrames() const
+{
+    return numFrames_;
+}
+
+uint64_t NullRender::ResidentBytes() const
+{
+    uint64_t size = 0;
+    for (const auto *vb : vertexBuffers_)
+        if (vb)
+            size += vb->Size();
+    for (const auto &ib : indexBuffers_)
+        size += ib.data.size();
+    for (const auto &texture : textures_)
+        if (texture.ref > 0)
+            size += texture.size;
+    return size;
+}
+
+// ============================================================================================
+// Device
+// ============================================================================================
+
+bool NullRender::InitDevice(bool windowed, HWND hwnd, int32_t width, int32_t height)
+{
+    screenSize_.x = width;
+    screenSize_.y = height;
+
+    Release(renderTarget_.target);
+    Release(renderTarget_.depth);
+    Release(backBuffer_);
+    Release(depthSurface_);
+    backBuffer_ = new NullSurface(D3DSURFACE_DESC{D3DFMT_X8R8G8B8, D3DRTYPE_SURFACE, D3DUSAGE_RENDERTARGET,
+                                                  D3DPOOL_DEFAULT, D3DMULTISAMPLE_NONE, 0, static_cast<UINT>(width),
+                                                  static_cast<UINT>(height)});
+    depthSurface_ = new NullSurface(D3DSURFACE_DESC{D3DFMT_D24S8, D3DRTYPE_SURFACE, D3DUSAGE_DEPTHSTENCIL,
+                                                    D3DPOOL_DEFAULT, D3DMULTISAMPLE_NONE, 0, static_cast<UINT>(width),
+                                                    static_cast<UINT>(height)});
+    renderTarget_ = {nullptr, nullptr};
+    SetRenderTarget(backBuffer_, depthSurface_);
+
+    viewport_ = {0, 0, static_cast<DWORD>(width), static_cast<DWORD>(height), 0.0f, 1.0f};
+    return true;
+}
+
+bool NullRender::ReleaseDevice()
+{
+    return true;
+}
+
+void *NullRender::GetD3DDevice()
+{
+    return nullptr;
+}
+
+bool NullRender::DX9Clear(int32_t type)
+{
+    return Clear(0, nullptr, type, 0, 1.0f, 0) == D3D_OK;
+}
+
+bool NullRender::DX9BeginScene()
+{
+    return BeginScene() == D3D_OK;
+}
+
+bool NullRender::DX9EndScene()
+{
+    return EndScene() == D3D_OK;
+}
+
+void NullRender::SaveShoot()
+{
+}
+
+HRESULT NullRender::SetClipPlane(uint32_t Index, const float *pPlane)
+{
+    return D3D_OK;
+}
+
+PLANE *NullRender::GetPlanes()
+{
+    FindPlanes();
+    return viewplane_;
+}
+
+// ============================================================================================
+// Materials, lights
+// ============================================================================================
+
+bool NullRender::SetLight(uint32_t dwIndex, const D3DLIGHT9 *pLight)
+{
+    if (!pLight)
+        return false;
+    lights_[dwIndex] = *pLight;
+    return true;
+}
+
+bool NullRender::LightEnable(uint32_t dwIndex, bool bOn)
+{
+    lightEnabled_[dwIndex] = bOn;
+    return true;
+}
+
+bool NullRender::SetMaterial(D3DMATERIAL9 &material)
+{
+    material_ = material;
+    return true;
+}
+
+bool NullRender::GetLightEnable(uint32_t dwIndex, BOOL *pEnable)
+{
+    const auto it = lightEnabled_.find(dwIndex);
+    if (it == lightEnabled_.end() || !pEnable)
+        return false;
+    *pEnable = it->second;
+    return true;
+}
+
+bool NullRender::GetLight(uint32_t dwIndex, D3DLIGHT9 *pLight)
+{
+    const auto it = lights_.find(dwIndex);
+    if (it == lights_.end() || !pLight)
+        return false;
+    *pLight = it->second;
+    return true;
+}
+
+// ============================================================================================
+// Camera
+// ============================================================================================
+
+void NullRender::SetTransform(int32_t type, D3DMATRIX *mtx)
+{
+    if (mtx)
+        transforms_[type] = *reinterpret_cast<CMatrix *>(mtx);
+}
+
+void NullRender::GetTransform(int32_t type, D3DMATRIX *mtx)
+{
+    if (mtx)
+        *mtx = *static_cast<D3DMATRIX *>(transforms_[type]);
+}
+
+bool NullRender::SetCamera(const CVECTOR &pos, const CVECTOR &ang, float perspective)
+{
+    if (!SetCamera(pos, ang))
+        return false;
+    return SetPerspective(perspective, aspectRatio_);
+}
+
+bool NullRender::SetCamera(const CVECTOR &pos, const CVECTOR &ang)
+{
+    CMatrix mtx;
+    mtx.BuildMatrix(ang);
+    mtx.Transposition3X3();
+    mtx.SetInversePosition(pos.x, pos.y, pos.z);
+    SetTransform(D3DTS_VIEW, mtx);
+    pos_ = pos;
+    ang_ = ang;
+
+    FindPlanes();
+    core.Event("CameraPosAng", "ffffff", pos.x, pos.y, pos.z, ang.x, ang.y, ang.z);
+    return true;
+}
+
+bool NullRender::SetCamera(CVECTOR lookFrom, CVECTOR lookTo, CVECTOR up)
+{
+    CMatrix mtx;
+    if (!mtx.BuildViewMatrix(lookFrom, lookTo, up))
+        return false;
+    SetTransform(D3DTS_VIEW, mtx);
+    pos_ = lookFrom;
+
+    const CVECTOR vNorm = !(lookTo - lookFrom);
+    ang_.y = atan2f(vNorm.x, vNorm.z);
+    ang_.x = atan2f(-vNorm.y, sqrtf(vNorm.x * vNorm.x + vNorm.z * vNorm.z));
+    ang_.z = 0.f;
+
+    FindPlanes();
+    core.Event("CameraPosAng", "ffffff", pos_.x, pos_.y, pos_.z, ang_.x, ang_.y, ang_.z);
+    return true;
+}
+
+bool NullRender::SetPerspective(float perspective, float fAspectRatio)
+{
+    perspective *= fovMultiplier_;
+    if (fAspectRatio < 0)
+        fAspectRatio = static_cast<float>(screenSize_.y) / screenSize_.x;
+    aspectRatio_ = fAspectRatio;
+    const float fovVert = 2.f * atanf(tanf(perspective / 2.f) * fAspectRatio);
+
+    const float w = 1.0f / tanf(perspective * 0.5f);
+    const float h = 1.0f / tanf(fovVert * 0.5f);
+    const float Q = farPlane_ / (farPlane_ - nearPlane_);
+
+    D3DMATRIX mtx{};
+    mtx._11 = w;
+    mtx._22 = h;
+    mtx._33 = Q;
+    mtx._43 = -Q * nearPlane_;
+    mtx._34 = 1.0f;
+    SetTransform(D3DTS_PROJECTION, &mtx);
+
+    fov_ = perspective;
+    FindPlanes();
+    return true;
+}
+
+void NullRender::GetCamera(CVECTOR &pos, CVECTOR &ang, float &perspective)
+{
+    pos = pos_;
+    ang = ang_;
+    perspective = fov_;
+}
+
+bool NullRender::SetCurrentMatrix(D3DMATRIX *mtx)
+{
+    SetTransform(D3DTS_WORLD, mtx);
+    return true;
+}
+
+void NullRender::SetView(const CMatrix &mView)
+{
+    SetTransform(D3DTS_VIEW, mView);
+}
+
+void NullRender::SetWorld(const CMatrix &mWorld)
+{
+    SetTransform(D3DTS_WORLD, mWorld);
+}
+
+void NullRender::SetProjection(const CMatrix &mProjection)
+{
+    SetTransform(D3DTS_PROJECTION, mProjection);
+}
+
+const CMatrix &NullRender::GetView()
+{
+    return transforms_[D3DTS_VIEW];
+}
+
+const CMatrix &NullRender::GetWorld()
+{
+    return transforms_[D3DTS_WORLD];
+}
+
+const CMatrix &NullRender::GetProjection()
+{
+    return transforms_[D3DTS_PROJECTION];
+}
+
+void NullRender::GetNearFarPlane(float &fNear, float &fFar)
+{
+    fNear = nearPlane_;
+    fFar = farPlane_;
+}
+
+void NullRender::SetNearFarPlane(float fNear, float fFar)
+{
+    nearPlane_ = fNear;
+    farPlane_ = fFar;
+    SetPerspective(fov_ / fovMultiplier_, aspectRatio_);
+}
+
+float NullRender::GetHeightDeformator()
+{
+    return static_cast<float>(screenSize_.y) * 4.0f / (static_cast<float>(screenSize_.x) * 3.0f);
+}
+
+POINT NullRender::GetScreenSize()
+{
+    return screenSize_;
+}
+
+// Same planes as DX9RENDER::FindPlanes, the view here keeps its translation
+void NullRender::FindPlanes()
+{
+    const auto &p = transforms_[D3DTS_PROJECTION];
+    CVECTOR v[4];
+    v[0] = !CVECTOR(p.m[0][0], 0.0f, 1.0f);
+    v[1] = !CVECTOR(-p.m[0][0], 0.0f, 1.0f);
+    v[2] = !CVECTOR(0.0f, -p.m[1][1], 1.0f);
+    v[3] = !CVECTOR(0.0f, p.m[1][1], 1.0f);
+
+    const auto &m = transforms_[D3DTS_VIEW];
+    CVECTOR pos;
+    pos.x = -m.m[3][0] * m.m[0][0] - m.m[3][1] * m.m[0][1] - m.m[3][2] * m.m[0][2];
+    pos.y = -m.m[3][0] * m.m[1][0] - m.m[3][1] * m.m[1][1] - m.m[3][2] * m.m[1][2];
+    pos.z = -m.m[3][0] * m.m[2][0] - m.m[3][1] * m.m[2][1] - m.m[3][2] * m.m[2][2];
+
+    for (int32_t i = 0; i < 4; i++)
+    {
+        auto &plane = viewplane_[i];
+        plane.Nx = v[i].x * m.m[0][0] + v[i].y * m.m[0][1] + v[i].z * m.m[0][2];
+        plane.Ny = v[i].x * m.m[1][0] + v[i].y * m.m[1][1] + v[i].z * m.m[1][2];
+        plane.Nz = v[i].x * m.m[2][0] + v[i].y * m.m[2][1] + v[i].z * m.m[2][2];
+        plane.D = pos.x * plane.Nx + pos.y * plane.Ny + pos.z * plane.Nz;
+    }
+}
+
+// ============================================================================================
+// Textures
+// ============================================================================================
+
+int32_t NullRender::TextureCreate(const char *fname)
+{
+    // the script sets a texture path with three calls: -1, the path number, the path
+    if ((uintptr_t)fname == -1)
+    {
+        setupPathStep_ = 1;
+        return -1;
+    }
+    if (setupPathStep_ == 1)
+    {
+        setupPathNumber_ = (uintptr_t)fname;
+        setupPathStep_ = 2;
+        return -1;
+    }
+    if (setupPathStep_ == 2)
+    {
+        setupPathStep_ = 0;
+        if (setupPathNumber_ < texPaths_.size())
+            texPaths_[setupPathNumber_] = fname ? fname : "";
+        return -1;
+    }
+
+    return LoadNamedTexture(fname);
+}
+
+int32_t NullRender::TextureCreateAsync(const char *fname)
+{
+    return TextureCreate(fname);
+}
+
+int32_t NullRender::LoadNamedTexture(const char *fname)
+{
+    if (fname == nullptr)
+    {
+        core.Trace("Can't create texture with null name");
+        return -1;
+    }
+    if (!isLoadTextureEnabled_)
+        return -1;
+
+    // the texture paths first, as DX9RENDER::LoadNamedTexture does
+    for (int32_t i = static_cast<int32_t>(texPaths_.size()) - 1; i >= -1; i--)
+    {
+        if (i >= 0 && texPaths_[i].empty())
+            continue;
+
+        std::string name = fname;
+        if (i >= 0)
+        {
+            const auto slash = name.rfind('\\');
+            name.insert(slash == std::string::npos ? 0 : slash + 1, texPaths_[i]);
+        }
+        std::ranges::transform(name, name.begin(), [](unsigned char c) { return std::toupper(c); });
+
+        if (const auto it = textureIndex_.find(name); it != textureIndex_.end())
+        {
+            textures_[it->second].ref++;
+            return it->second;
+        }
+
+        const auto path = GetTexturePath(name.c_str());
+        const auto data = DecodeTexture(path.c_str(), textureDegradation_);
+        if (data.status != TextureData::Status::Ok)
+        {
+            if (i < 0)
+                core.Trace("Can't load texture %s", path.c_str());
+            continue;
+        }
+
+        IDirect3DBaseTexture9 *d3dtex;
+        if (data.isCubeMap)
+            d3dtex = new NullCubeTexture(data.width, data.numMips, 0, data.format, D3DPOOL_MANAGED);
+        else
+            d3dtex = new NullTexture(data.width, data.height, data.numMips, 0, data.format, D3DPOOL_MANAGED);
+        const auto size = static_cast<uint32_t>(data.Size());
+        frame_.textureLoads++;
+        frame_.textureBytes += size;
+
+        const auto t = AddTexture(name, d3dtex, size);
+        textureIndex_.emplace(std::move(name), t);
+        return t;
+    }
+    return -1;
+}
+
+int32_t NullRender::TextureCreate(UINT width, UINT height, UINT levels, uint32_t usage, D3DFORMAT format,
+                                  D3DPOOL pool)
+{
+    auto *texture = new NullTexture(width, height, levels, usage, format, pool);
+    return AddTexture({}, texture, texture->Size());
+}
+
+int32_t NullRender::AddTexture(std::string name, IDirect3DBaseTexture9 *d3dtex, uint32_t size)
+{
+    auto it = std::ranges::find_if(textures_, [](const Texture &texture) { return texture.ref == 0; });
+    if (it == textures_.end())
+        it = textures_.insert(textures_.end(), Texture{});
+    *it = {std::move(name), d3dtex, 1, size};
+    return static_cast<int32_t>(it - textures_.begin());
+}
+
+bool NullRender::TextureSet(int32_t stage, int32_t texid)
+{
+    frame_.stateChanges++;
+    return texid < 0 || (texid < static_cast<int32_t>(textures_.size()) && textures_[texid].ref > 0);
+}
+
+bool NullRender::TextureRelease(int32_t texid)
+{
+    if (texid < 0 || texid >= static_cast<int32_t>(textures_.size()) || textures_[texid].ref == 0)
+        return false;
+    auto &texture = textures_[texid];
+    if (--texture.ref > 0)
+        return false;
+    if (!texture.name.empty())
+        textureIndex_.erase(texture.name);
+    Release(texture.d3dtex);
+    texture = {};
+    return true;
+}
+
+bool NullRender::TextureIncReference(int32_t texid)
+{
+    if (texid < 0 || texid >= static_cast<int32_t>(textures_.size()) || textures_[texid].ref == 0)
+        return false;
+    textures_[texid].ref++;
+    return true;
+}
+
+void NullRender::SetLoadTextureEnable(bool bEnable)
+{
+    isLoadTextureEnabled_ = bEnable;
+}
+
+IDirect3DBaseTexture9 *NullRender::GetBaseTexture(int32_t iTexture)
+{
+    return GetTextureFromID(iTexture);
+}
+
+IDirect3DBaseTexture9 *NullRender::GetTextureFromID(int32_t nTextureID)
+{
+    if (nTextureID < 0 || nTextureID >= static_cast<int32_t>(textures_.size()))
+        return nullptr;
+    return textures_[nTextureID].d3dtex;
+}
+
+// ============================================================================================
+// Fonts
+// ============================================================================================
+
+int32_t NullRender::PrintText(int32_t nFontNum, float fScale, const char *format, va_list args)
+{
+    if (nFontNum < 0 || nFontNum >= static_cast<int32_t>(fonts_.size()) || fonts_[nFontNum].ref == 0)
+        return 0;
+    vsnprintf(printBuffer, sizeof(printBuffer), format, args);
+    frame_.prints++;
+    return StringWidth(std::string_view(printBuffer), nFontNum, fScale);
+}
+
+int32_t NullRender::Print(int32_t x, int32_t y, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const auto width = PrintText(curFont_, 1.0f, format, args);
+    va_end(args);
+    return width;
+}
+
+int32_t NullRender::Print(int32_t nFontNum, uint32_t color, int32_t x, int32_t y, const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const auto width = PrintText(nFontNum, 1.0f, format, args);
+    va_end(args);
+    return width;
+}
+
+int32_t NullRender::ExtPrint(int32_t nFontNum, uint32_t foreColor, uint32_t backColor, int wAlignment, bool bShadow,
+                             float fScale, int32_t scrWidth, int32_t scrHeight, int32_t x, int32_t y,
+                             const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    const auto width = PrintText(nFontNum, fScale, format, args);
+    va_end(args);
+    return width;
+}
+
+int32_t NullRender::StringWidth(const char *string, int32_t nFontNum, float fScale, int32_t scrWidth)
+{
+    if (string == nullptr)
+        return 0;
+    return StringWidth(std::string_view(string), nFontNum, fScale, scrWidth);
+}
+
+int32_t NullRender::StringWidth(const std::string_view &string, int32_t nFontNum, float fScale, int32_t scrWidth)
+{
+    if (nFontNum < 0 || nFontNum >= static_cast<int32_t>(fonts_.size()) || fonts_[nFontNum].ref == 0)
+        return 0;
+    if (scrWidth != 0 && scrWidth != screenSize_.x)
+        fScale *= static_cast<float>(screenSize_.x) / scrWidth;
+    return static_cast<int32_t>(utf8::Utf8StringLength(string) * NULL_FONT_CHAR_WIDTH * fScale);
+}
+
+int32_t NullRender::CharWidth(utf8::u8_char ucVKey, int32_t nFontNum, float fScale, int32_t scrWidth)
+{
+    return StringWidth(std::string_view(ucVKey.b, ucVKey.l), nFontNum, fScale, scrWidth);
+}
+
+int32_t NullRender::CharHeight(int32_t fontID)
+{
+    if (fontID < 0 || fontID >= static_cast<int32_t>(fonts_.size()) || fonts_[fontID].ref == 0)
+        return 0;
+    return NULL_FONT_CHAR_HEIGHT;
+}
+
+int32_t NullRender::LoadFont(const std::string_view &fontName)
+{
+    if (fontName.empty())
+        return -1;
+    for (int32_t i = 0; i < static_cast<int32_t>(fonts_.size()); i++)
+        if (fonts_[i].ref > 0 && storm::iEquals(fonts_[i].name, fontName))
+        {
+            fonts_[i].ref++;
+            return i;
+        }
+
+    auto it = std::ranges::find_if(fonts_, [](const Font &font) { return font.ref == 0; });
+    if (it == fonts_.end())
+        it = fonts_.insert(fonts_.end(), Font{});
+    *it = {std::string(fontName), 1};
+    return static_cast<int32_t>(it - fonts_.begin());
+}
+
+bool NullRender::UnloadFont(const char *fontName)
+{
+    if (fontName == nullptr)
+        return false;
+    for (int32_t i = 0; i < static_cast<int32_t>(fonts_.size()); i++)
+        if (fonts_[i].ref > 0 && storm::iEquals(fonts_[i].name, std::string_view(fontName)))
+            return UnloadFont(i);
+    return false;
+}
+
+bool NullRender::UnloadFont(int32_t fontID)
+{
+    if (fontID < 0 || fontID >= static_cast<int32_t>(fonts_.size()) || fonts_[fontID].ref == 0)
+        return false;
+    return --fonts_[fontID].ref > 0;
+}
+
+bool NullRender::IncRefCounter(int32_t fontID)
+{
+    if (fontID < 0 || fontID >= static_cast<int32_t>(fonts_.size()) || fonts_[fontID].ref == 0)
+        return false;
+    fonts_[fontID].ref++;
+    return true;
+}
+
+bool NullRender::SetCurFont(const char *fontName)
+{
+    if (fontName == nullptr)
+        return false;
+    for (int32_t i = 0; i < static_cast<int32_t>(fonts_.size()); i++)
+        if (fonts_[i].ref > 0 && storm::iEquals(fonts_[i].name, std::string_view(fontName)))
+            return SetCurFont(i);
+    return false;
+}
+
+bool NullRender::SetCurFont(int32_t fontID)
+{
+    if (fontID < 0 || fontID >= static_cast<int32_t>(fonts_.size()) || fonts_[fontID].ref == 0)
+        return false;
+    curFont_ = fontID;
+    return true;
+}
+
+int32_t NullRender::GetCurFont()
+{
+    return curFont_;
+}
+
+char *NullRender::GetFontIniFileName()
+{
+    return fontIniFileName_.data();
+}
+
+bool NullRender::SetFontIniFileName(const char *iniName)
+{
+    fontIniFileName_ = iniName ? iniName : "";
+    return true;
+}
+
+// ============================================================================================
+// Techniques, drawing
+// ============================================================================================
+
+int32_t NullRender::TechniqueGetHandle(const char *cBlockName)
+{
+    if (!cBlockName || !cBlockName[0])
+        return -1;
+    std::string name = cBlockName;
+    std::ranges::transform(name, name.begin(), [](unsigned char c) { return std::tolower(c); });
+    const auto handle = static_cast<int32_t>(techniqueHandles_.size());
+    return techniqueHandles_.emplace(std::move(name), handle).first->second;
+}
+
+bool NullRender::TechniqueExecuteStart(const char *cBlockName)
+{
+    if (!cBlockName || !cBlockName[0])
+        return false;
+    frame_.techniques++;
+    return true;
+}
+
+bool NullRender::TechniqueExecuteStart(int32_t technique)
+{
+    if (technique < 0 || technique >= static_cast<int32_t>(techniqueHandles_.size()))
+        return false;
+    frame_.techniques++;
+    return true;
+}
+
+// every technique is a single pass
+bool NullRender::TechniqueExecuteNext()
+{
+    return false;
+}
+
+void NullRender::Draw(const char *technique, uint64_t numPrimitives)
+{
+    if (technique && technique[0] && !TechniqueExecuteStart(technique))
+        return;
+    frame_.drawCalls++;
+    frame_.primitives += numPrimitives;
+}
+
+void NullRender::DrawRects(RS_RECT *pRSR, uint32_t dwRectsNum, const char *cBlockName, uint32_t dwSubTexturesX,
+                           uint32_t dwSubTexturesY, float fScaleX, float fScaleY)
+{
+    if (!pRSR || dwRectsNum == 0)
+        return;
+    Draw(cBlockName ? cBlockName : "particles", dwRectsNum * 2);
+}
+
+void NullRender::DrawSprites(RS_SPRITE *pRSS, uint32_t dwSpritesNum, const char *cBlockName)
+{
+    if (!pRSS || dwSpritesNum == 0)
+        return;
+    frame_.userBytes += dwSpritesNum * 4 * sizeof(RS_SPRITE) + dwSpritesNum * 6 * sizeof(uint16_t);
+    Draw(cBlockName, dwSpritesNum * 2);
+}
+
+void NullRender::DrawLines(RS_LINE *pRSL, uint32_t dwLinesNum, const char *cBlockName)
+{
+    if (!pRSL || dwLinesNum == 0)
+        return;
+    frame_.userBytes += dwLinesNum * 2 * sizeof(RS_LINE);
+    Draw(cBlockName, dwLinesNum);
+}
+
+void NullRender::DrawVector(const CVECTOR &v1, const CVECTOR &v2, uint32_t dwColor, const char *pTechniqueName)
+{
+    Draw(pTechniqueName, 51);
+}
+
+void NullRender::DrawLines2D(RS_LINE2D *pRSL2D, size_t dwLinesNum, const char *cBlockName)
+{
+    if (!pRSL2D || dwLinesNum == 0)
+        return;
+    frame_.userBytes += dwLinesNum * 2 * sizeof(RS_LINE2D);
+    Draw(cBlockName, dwLinesNum);
+}
+
+void NullRender::DrawBuffer(int32_t vbuff, int32_t stride, int32_t ibuff, int32_t minv, size_t numv,
+                            size_t startidx, size_t numtrg, const char *cBlockName)
+{
+    Draw(cBlockName, numtrg);
+}
+
+void NullRender::DrawIndexedPrimitiveNoVShader(D3DPRIMITIVETYPE dwPrimitiveType, int32_t iVBuff, int32_t iStride,
+                                               int32_t iIBuff, int32_t iMinV, int32_t iNumV, int32_t iStartIdx,
+                                               int32_t iNumTrg, const char *cBlockName)
+{
+    Draw(cBlockName, iNumTrg);
+}
+
+void NullRender::DrawPrimitive(D3DPRIMITIVETYPE dwPrimitiveType, int32_t iVBuff, int32_t iStride, int32_t iStartV,
+                               int32_t iNumPT, const char *cBlockName)
+{
+    Draw(cBlockName, iNumPT);
+}
+
+void NullRender::DrawPrimitiveUP(D3DPRIMITIVETYPE dwPrimitiveType, uint32_t dwVertexBufferFormat, uint32_t dwNumPT,
+                                 const void *pVerts, uint32_t dwStride, const char *cBlockName)
+{
+    frame_.userBytes += NumVertices(dwPrimitiveType, dwNumPT) * dwStride;
+    Draw(cBlockName, dwNumPT);
+}
+
+void NullRender::DrawIndexedPrimitiveUP(D3DPRIMITIVETYPE dwPrimitiveType, uint32_t dwMinIndex, uint32_t dwNumVertices,
+                                        uint32_t dwPrimitiveCount, const void *pIndexData, D3DFORMAT IndexDataFormat,
+                                        const void *pVertexData, uint32_t dwVertexStride, const char *cBlockName)
+{
+    const uint64_t indexSize = IndexDataFormat == D3DFMT_INDEX32 ? 4 : 2;
+    frame_.userBytes += static_cast<uint64_t>(dwNumVertices) * dwVertexStride +
+                        NumVertices(dwPrimitiveType, dwPrimitiveCount) * indexSize;
+    Draw(cBlockName, dwPrimitiveCount);
+}
+
+HRESULT NullRender::DrawPrimitive(D3DPRIMITIVETYPE PrimitiveType, UINT StartVertex, UINT PrimitiveCount)
+{
+    Draw(nullptr, PrimitiveCount);
+    return D3D_OK;
+}
+
+void NullRender::RenderAnimation(int32_t ib, void *src, int32_t numVrts, int32_t minv, int32_t numv, int32_t startidx,
+                                 int32_t numtrg, bool isUpdateVB)
+{
+    if (numVrts <= 0 || !src || ib < 0)
+        return;
+    // the vertices are copied as DX9RENDER copies them into its animation buffer
+    const auto size = numVrts * sizeof(FVF_VERTEX);
+    if (isUpdateVB || size > animationBuffer_.size())
+    {
+        if (size > animationBuffer_.size())
+            animationBuffer_.resize(size);
+        std::copy_n(static_cast<const char *>(src), size, animationBuffer_.data());
+        frame_.lockedBytes += size;
+    }
+    Draw(nullptr, numtrg);
+}
+
+void NullRender::DrawSphere(const CVECTOR &vPos, float fRadius, uint32_t dwColor)
+{
+    Draw("DXSphere", 0);
+}
+
+void NullRender::DrawEllipsoid(const CVECTOR &vPos, float a, float b, float c, float ay, uint32_t dwColor)
+{
+    Draw("DXEllipsoid", 0);
+}
+
+HRESULT NullRender::ImageBlt(const char *pName, RECT *pDstRect, RECT *pSrcRect)
+{
+    Draw(nullptr, 2);
+    return D3D_OK;
+}
+
+HRESULT NullRender::ImageBlt(int32_t nTextureId, RECT *pDstRect, RECT *pSrcRect)
+{
+    Draw(nullptr, 2);
+    return D3D_OK;
+}
+
+void NullRender::MakePostProcess()
+{
+}
+
+void NullRender::SetGLOWParams(float _fBlurBrushSize, int32_t _GlowIntensity, int32_t _GlowPasses)
+{
+}
+
+void NullRender::SetColorParameters(float fGamma, float fBrightness, float fContrast)
+{
+}
+
+// ============================================================================================
+// Video, progress
+// ============================================================================================
+
+void NullRender::PlayToTexture()
+{
+}
+
+CVideoTexture *NullRender::GetVideoTexture(const char *sVideoName)
+{
+    return nullptr;
+}
+
+void NullRender::ReleaseVideoTexture(CVideoTexture *pVTexture)
+{
+}
+
+void NullRender::SetProgressImage(const char *image)
+{
+}
+
+void NullRender::SetProgressBackImage(const char *image)
+{
+}
+
+void NullRender::SetTipsImage(const char *image)
+{
+    tipsImage_ = image ? image : "";
+}
+
+void NullRender::StartProgressView()
+{
+}
+
+void NullRender::ProgressView()
+{
+}
+
+void NullRender::EndProgressView()
+{
+}
+
+bool NullRender::IsInsideScene()
+{
+    return isInsideScene_;
+}
+
+char *NullRender::GetTipsImage()
+{
+    return tipsImage_.empty() ? nullptr : tipsImage_.data();
+}
+
+// ============================================================================================
+// Buffers
+// ============================================================================================
+
+int32_t NullRender::CreateVertexBuffer(int32_t type, size_t nverts, uint32_t usage, uint32_t dwPool)
+{
+    if (nverts <= 0)
+        return -1;
+    auto it = std::ranges::find(vertexBuffers_, nullptr);
+    if (it == vertexBuffers_.end())
+        it = vertexBuffers_.insert(vertexBuffers_.end(), nullptr);
+    *it = new NullVertexBuffer(static_cast<uint32_t>(nverts), usage, type, static_cast<D3DPOOL>(dwPool));
+    return static_cast<int32_t>(it - vertexBuffers_.begin());
+}
+
+int32_t NullRender::CreateIndexBuffer(size_t ntrgs, uint32_t dwUsage)
+{
+    auto it = std::ranges::find_if(indexBuffers_, [](const IndexBuffer &ib) { return !ib.used; });
+    if (it == indexBuffers_.end())
+        it = indexBuffers_.insert(indexBuffers_.end(), IndexBuffer{});
+    it->used = true;
+    it->data.assign(ntrgs, 0);
+    return static_cast<int32_t>(it - indexBuffers_.begin());
+}
+
+IDirect3DVertexBuffer9 *NullRender::GetVertexBuffer(int32_t id)
+{
+    if (id < 0 || id >= static_cast<int32_t>(vertexBuffers_.size()))
+        return nullptr;
+    return vertexBuffers_[id];
+}
+
+int32_t NullRender::GetVertexBufferFVF(int32_t id)
+{
+    D3DVERTEXBUFFER_DESC desc;
+    if (auto *vb = GetVertexBuffer(id); vb && vb->GetDesc(&desc) == D3D_OK)
+        return desc.FVF;
+    return 0;
+}
+
+void *NullRender::LockVertexBuffer(int32_t id, uint32_t dwFlags)
+{
+    auto *vb = GetVertexBuffer(id);
+    if (!vb)
+        return nullptr;
+    void *data = nullptr;
+    if (vb->Lock(0, 0, &data, dwFlags) != D3D_OK)
+        return nullptr;
+    frame_.lockedBytes += vertexBuffers_[id]->Size();
+    return data;
+}
+
+void NullRender::UnLockVertexBuffer(int32_t id)
+{
+    if (auto *vb = GetVertexBuffer(id))
+        vb->Unlock();
+}
+
+int32_t NullRender::GetVertexBufferSize(int32_t id)
+{
+    if (id < 0 || id >= static_cast<int32_t>(vertexBuffers_.size()) || !vertexBuffers_[id])
+        return 0;
+    return static_cast<int32_t>(vertexBuffers_[id]->Size());
+}
+
+void *NullRender::LockIndexBuffer(int32_t id, uint32_t dwFlags)
+{
+    if (id < 0 || id >= static_cast<int32_t>(indexBuffers_.size()) || !indexBuffers_[id].used)
+        return nullptr;
+    frame_.lockedBytes += indexBuffers_[id].data.size();
+    return indexBuffers_[id].data.data();
+}
+
+void NullRender::UnLockIndexBuffer(int32_t id)
+{
+}
+
+void NullRender::ReleaseVertexBuffer(int32_t id)
+{
+    if (id < 0 || id >= static_cast<int32_t>(vertexBuffers_.size()))
+        return;
+    Release(vertexBuffers_[id]);
+    vertexBuffers_[id] = nullptr;
+}
+
+void NullRender::ReleaseIndexBuffer(int32_t id)
+{
+    if (id < 0 || id >= static_cast<int32_t>(indexBuffers_.size()))
+        return;
+    indexBuffers_[id].used = false;
+    indexBuffers_[id].data = {};
+}
+
+HRESULT NullRender::CreateVertexBuffer(UINT Length, uint32_t Usage, uint32_t FVF, D3DPOOL Pool,
+                                       IDirect3DVertexBuffer9 **ppVertexBuffer)
+{
+    if (!ppVertexBuffer)
+        return D3DERR_INVALIDCALL;
+    *ppVertexBuffer = new NullVertexBuffer(Length, Usage, FVF, Pool);
+    return D3D_OK;
+}
+
+HRESULT NullRender::VBLock(IDirect3DVertexBuffer9 *pVB, UINT OffsetToLock, UINT SizeToLock, uint8_t **ppbData,
+                           uint32_t Flags)
+{
+    if (!pVB)
+        return D3DERR_INVALIDCALL;
+    const auto result = pVB->Lock(OffsetToLock, SizeToLock, reinterpret_cast<void **>(ppbData), Flags);
+    if (result == D3D_OK)
+    {
+        D3DVERTEXBUFFER_DESC desc;
+        pVB->GetDesc(&desc);
+        frame_.lockedBytes += SizeToLock ? SizeToLock : desc.Size - OffsetToLock;
+    }
+    return result;
+}
+
+void NullRender::VBUnlock(IDirect3DVertexBuffer9 *pVB)
+{
+    if (pVB)
+        pVB->Unlock();
+}
+
+HRESULT NullRender::SetStreamSource(UINT StreamNumber, void *pStreamData, UINT Stride)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetIndices(void *pIndexData)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::Release(IUnknown *pObject)
+{
+    if (pObject)
+        return pObject->Release();
+    return D3D_OK;
+}
+
+// ============================================================================================
+// States
+// ============================================================================================
+
+uint32_t NullRender::SetRenderState(uint32_t State, uint32_t Value)
+{
+    frame_.stateChanges++;
+    if (State >= renderStates_.size())
+        return D3DERR_INVALIDCALL;
+    renderStates_[State] = Value;
+    return D3D_OK;
+}
+
+uint32_t NullRender::GetRenderState(uint32_t State, uint32_t *pValue)
+{
+    if (State >= renderStates_.size() || !pValue)
+        return D3DERR_INVALIDCALL;
+    *pValue = renderStates_[State];
+    return D3D_OK;
+}
+
+uint32_t NullRender::GetSamplerState(uint32_t Sampler, D3DSAMPLERSTATETYPE Type, uint32_t *pValue)
+{
+    const auto type = static_cast<uint32_t>(Type);
+    if (Sampler >= samplerStates_.size() || type >= samplerStates_[0].size() || !pValue)
+        return D3DERR_INVALIDCALL;
+    *pValue = samplerStates_[Sampler][type];
+    return D3D_OK;
+}
+
+uint32_t NullRender::SetSamplerState(uint32_t Sampler, D3DSAMPLERSTATETYPE Type, uint32_t Value)
+{
+    frame_.stateChanges++;
+    const auto type = static_cast<uint32_t>(Type);
+    if (Sampler >= samplerStates_.size() || type >= samplerStates_[0].size())
+        return D3DERR_INVALIDCALL;
+    samplerStates_[Sampler][type] = Value;
+    return D3D_OK;
+}
+
+uint32_t NullRender::SetTextureStageState(uint32_t Stage, uint32_t Type, uint32_t Value)
+{
+    frame_.stateChanges++;
+    if (Stage >= textureStageStates_.size() || Type >= textureStageStates_[0].size())
+        return D3DERR_INVALIDCALL;
+    textureStageStates_[Stage][Type] = Value;
+    return D3D_OK;
+}
+
+uint32_t NullRender::GetTextureStageState(uint32_t Stage, uint32_t Type, uint32_t *pValue)
+{
+    if (Stage >= textureStageStates_.size() || Type >= textureStageStates_[0].size() || !pValue)
+        return D3DERR_INVALIDCALL;
+    *pValue = textureStageStates_[Stage][Type];
+    return D3D_OK;
+}
+
+HRESULT NullRender::GetViewport(D3DVIEWPORT9 *pViewport)
+{
+    if (!pViewport)
+        return D3DERR_INVALIDCALL;
+    *pViewport = viewport_;
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetViewport(const D3DVIEWPORT9 *pViewport)
+{
+    if (!pViewport)
+        return D3DERR_INVALIDCALL;
+    viewport_ = *pViewport;
+    return D3D_OK;
+}
+
+// a device without any capability
+HRESULT NullRender::GetDeviceCaps(D3DCAPS9 *pCaps)
+{
+    if (!pCaps)
+        return D3DERR_INVALIDCALL;
+    *pCaps = {};
+    return D3D_OK;
+}
+
+// ============================================================================================
+// Textures, surfaces
+// ============================================================================================
+
+HRESULT NullRender::GetDepthStencilSurface(IDirect3DSurface9 **ppZStencilSurface)
+{
+    if (!ppZStencilSurface || !renderTarget_.depth)
+        return D3DERR_NOTFOUND;
+    renderTarget_.depth->AddRef();
+    *ppZStencilSurface = renderTarget_.depth;
+    return D3D_OK;
+}
+
+HRESULT NullRender::GetCubeMapSurface(IDirect3DCubeTexture9 *ppCubeTexture, D3DCUBEMAP_FACES FaceType, UINT Level,
+                                      IDirect3DSurface9 **ppCubeMapSurface)
+{
+    if (!ppCubeTexture)
+        return D3DERR_INVALIDCALL;
+    return ppCubeTexture->GetCubeMapSurface(FaceType, Level, ppCubeMapSurface);
+}
+
+HRESULT NullRender::CreateTexture(UINT Width, UINT Height, UINT Levels, uint32_t Usage, D3DFORMAT Format,
+                                  D3DPOOL Pool, IDirect3DTexture9 **ppTexture)
+{
+    if (!ppTexture)
+        return D3DERR_INVALIDCALL;
+    *ppTexture = new NullTexture(Width, Height, Levels, Usage, Format, Pool);
+    return D3D_OK;
+}
+
+HRESULT NullRender::CreateCubeTexture(UINT EdgeLength, UINT Levels, uint32_t Usage, D3DFORMAT Format, D3DPOOL Pool,
+                                      IDirect3DCubeTexture9 **ppCubeTexture)
+{
+    if (!ppCubeTexture)
+        return D3DERR_INVALIDCALL;
+    *ppCubeTexture = new NullCubeTexture(EdgeLength, Levels, Usage, Format, Pool);
+    return D3D_OK;
+}
+
+HRESULT NullRender::CreateOffscreenPlainSurface(UINT Width, UINT Height, D3DFORMAT Format,
+                                                IDirect3DSurface9 **ppSurface)
+{
+    if (!ppSurface)
+        return D3DERR_INVALIDCALL;
+    *ppSurface = new NullSurface(
+        D3DSURFACE_DESC{Format, D3DRTYPE_SURFACE, 0, D3DPOOL_SYSTEMMEM, D3DMULTISAMPLE_NONE, 0, Width, Height});
+    return D3D_OK;
+}
+
+HRESULT NullRender::CreateDepthStencilSurface(UINT Width, UINT Height, D3DFORMAT Format,
+                                              D3DMULTISAMPLE_TYPE MultiSample, IDirect3DSurface9 **ppSurface)
+{
+    if (!ppSurface)
+        return D3DERR_INVALIDCALL;
+    *ppSurface = new NullSurface(D3DSURFACE_DESC{Format, D3DRTYPE_SURFACE, D3DUSAGE_DEPTHSTENCIL, D3DPOOL_DEFAULT,
+                                                 MultiSample, 0, Width, Height});
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetTexture(uint32_t Stage, IDirect3DBaseTexture9 *pTexture)
+{
+    frame_.stateChanges++;
+    return D3D_OK;
+}
+
+HRESULT NullRender::GetLevelDesc(IDirect3DTexture9 *ppTexture, UINT Level, D3DSURFACE_DESC *pDesc)
+{
+    return ppTexture ? ppTexture->GetLevelDesc(Level, pDesc) : D3DERR_INVALIDCALL;
+}
+
+HRESULT NullRender::GetLevelDesc(IDirect3DCubeTexture9 *ppCubeTexture, UINT Level, D3DSURFACE_DESC *pDesc)
+{
+    return ppCubeTexture ? ppCubeTexture->GetLevelDesc(Level, pDesc) : D3DERR_INVALIDCALL;
+}
+
+HRESULT NullRender::LockRect(IDirect3DCubeTexture9 *ppCubeTexture, D3DCUBEMAP_FACES FaceType, UINT Level,
+                             D3DLOCKED_RECT *pLockedRect, const RECT *pRect, uint32_t Flags)
+{
+    D3DSURFACE_DESC desc;
+    if (!ppCubeTexture || ppCubeTexture->GetLevelDesc(Level, &desc) != D3D_OK)
+        return D3DERR_INVALIDCALL;
+    frame_.lockedBytes += NullFormatPitch(desc.Format, desc.Width) * NullFormatRows(desc.Format, desc.Height);
+    return ppCubeTexture->LockRect(FaceType, Level, pLockedRect, pRect, Flags);
+}
+
+HRESULT NullRender::LockRect(IDirect3DTexture9 *ppTexture, UINT Level, D3DLOCKED_RECT *pLockedRect,
+                             const RECT *pRect, uint32_t Flags)
+{
+    D3DSURFACE_DESC desc;
+    if (!ppTexture || ppTexture->GetLevelDesc(Level, &desc) != D3D_OK)
+        return D3DERR_INVALIDCALL;
+    frame_.lockedBytes += NullFormatPitch(desc.Format, desc.Width) * NullFormatRows(desc.Format, desc.Height);
+    return ppTexture->LockRect(Level, pLockedRect, pRect, Flags);
+}
+
+HRESULT NullRender::UnlockRect(IDirect3DCubeTexture9 *pCubeTexture, D3DCUBEMAP_FACES FaceType, UINT Level)
+{
+    return pCubeTexture ? pCubeTexture->UnlockRect(FaceType, Level) : D3DERR_INVALIDCALL;
+}
+
+HRESULT NullRender::UnlockRect(IDirect3DTexture9 *pTexture, UINT Level)
+{
+    return pTexture ? pTexture->UnlockRect(Level) : D3DERR_INVALIDCALL;
+}
+
+HRESULT NullRender::GetSurfaceLevel(IDirect3DTexture9 *ppTexture, UINT Level, IDirect3DSurface9 **ppSurfaceLevel)
+{
+    return ppTexture ? ppTexture->GetSurfaceLevel(Level, ppSurfaceLevel) : D3DERR_INVALIDCALL;
+}
+
+HRESULT NullRender::UpdateSurface(IDirect3DSurface9 *pSourceSurface, const RECT *pSourceRectsArray, UINT cRects,
+                                  IDirect3DSurface9 *pDestinationSurface, const POINT *pDestPointsArray)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::StretchRect(IDirect3DSurface9 *pSourceSurface, const RECT *pSourceRect,
+                                IDirect3DSurface9 *pDestSurface, const RECT *pDestRect, D3DTEXTUREFILTERTYPE Filter)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::GetRenderTargetData(IDirect3DSurface9 *pRenderTarget, IDirect3DSurface9 *pDestSurface)
+{
+    return D3D_OK;
+}
+
+IDirect3DVolumeTexture9 *NullRender::CreateVolumeTexture(uint32_t Width, uint32_t Height, uint32_t Depth,
+                                                         uint32_t Levels, uint32_t Usage, D3DFORMAT Format,
+                                                         D3DPOOL Pool)
+{
+    // not supported, the callers fall back to plain textures
+    return nullptr;
+}
+
+bool NullRender::GetRenderTargetAsTexture(IDirect3DTexture9 **tex)
+{
+    if (!tex)
+        return false;
+    *tex = new NullTexture(screenSize_.x, screenSize_.y, 1, D3DUSAGE_RENDERTARGET, D3DFMT_X8R8G8B8,
+                           D3DPOOL_DEFAULT);
+    return true;
+}
+
+// ============================================================================================
+// Shaders
+// ============================================================================================
+
+HRESULT NullRender::CreateVertexDeclaration(const D3DVERTEXELEMENT9 *pVertexElements,
+                                            IDirect3DVertexDeclaration9 **ppDecl)
+{
+    if (ppDecl)
+        *ppDecl = nullptr;
+    return E_FAIL;
+}
+
+HRESULT NullRender::SetVertexDeclaration(IDirect3DVertexDeclaration9 *pDecl)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::CreatePixelShader(const uint32_t *pFunction, IDirect3DPixelShader9 **ppShader)
+{
+    if (ppShader)
+        *ppShader = nullptr;
+    return E_FAIL;
+}
+
+HRESULT NullRender::CreateVertexShader(const uint32_t *pFunction, IDirect3DVertexShader9 **ppShader)
+{
+    if (ppShader)
+        *ppShader = nullptr;
+    return E_FAIL;
+}
+
+HRESULT NullRender::DeletePixelShader(IDirect3DPixelShader9 *pShader)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::DeleteVertexShader(IDirect3DVertexShader9 *pShader)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetVertexShader(IDirect3DVertexShader9 *pShader)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetPixelShader(IDirect3DPixelShader9 *pShader)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetVertexShaderConstantF(UINT StartRegister, const float *pConstantData, UINT Vector4iCount)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetPixelShaderConstantF(UINT StartRegister, const float *pConstantData, UINT Vector4iCount)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetFVF(uint32_t handle)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::GetVertexShader(IDirect3DVertexShader9 **ppShader)
+{
+    if (ppShader)
+        *ppShader = nullptr;
+    return D3D_OK;
+}
+
+HRESULT NullRender::GetPixelShader(IDirect3DPixelShader9 **ppShader)
+{
+    if (ppShader)
+        *ppShader = nullptr;
+    return D3D_OK;
+}
+
+#ifdef _WIN32 // Effects
+ID3DXEffect *NullRender::GetEffectPointer(const char *techniqueName)
+{
+    return nullptr;
+}
+#endif
+
+// ============================================================================================
+// Render targets
+// ============================================================================================
+
+HRESULT NullRender::GetRenderTarget(IDirect3DSurface9 **ppRenderTarget)
+{
+    if (!ppRenderTarget || !renderTarget_.target)
+        return D3DERR_NOTFOUND;
+    renderTarget_.target->AddRef();
+    *ppRenderTarget = renderTarget_.target;
+    return D3D_OK;
+}
+
+HRESULT NullRender::SetRenderTarget(IDirect3DSurface9 *pRenderTarget, IDirect3DSurface9 *pNewZStencil)
+{
+    if (!pRenderTarget)
+        return D3DERR_INVALIDCALL;
+    pRenderTarget->AddRef();
+    if (pNewZStencil)
+        pNewZStencil->AddRef();
+    Release(renderTarget_.target);
+    Release(renderTarget_.depth);
+    renderTarget_ = {pRenderTarget, pNewZStencil};
+    return D3D_OK;
+}
+
+bool NullRender::SetRenderTarget(IDirect3DCubeTexture9 *pCubeTex, uint32_t dwFaceType, uint32_t dwLevel,
+                                 IDirect3DSurface9 *pNewZStencil)
+{
+    IDirect3DSurface9 *surface = nullptr;
+    if (GetCubeMapSurface(pCubeTex, static_cast<D3DCUBEMAP_FACES>(dwFaceType), dwLevel, &surface) != D3D_OK)
+        return false;
+    const auto result = SetRenderTarget(surface, pNewZStencil);
+    surface->Release();
+    return result == D3D_OK;
+}
+
+bool NullRender::PushRenderTarget()
+{
+    if (renderTarget_.target)
+        renderTarget_.target->AddRef();
+    if (renderTarget_.depth)
+        renderTarget_.depth->AddRef();
+    renderTargets_.push(renderTarget_);
+    return true;
+}
+
+bool NullRender::PopRenderTarget()
+{
+    if (renderTargets_.empty())
+        return false;
+    const auto rt = renderTargets_.top();
+    renderTargets_.pop();
+    Release(renderTarget_.target);
+    Release(renderTarget_.depth);
+    renderTarget_ = rt;
+    return true;
+}
+
+HRESULT NullRender::Clear(uint32_t Count, const D3DRECT *pRects, uint32_t Flags, D3DCOLOR Color, float Z,
+                          uint32_t Stencil)
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::BeginScene()
+{
+    return D3D_OK;
+}
+
+HRESULT NullRender::EndScene()
+{
+    return D3D_OK;
+}
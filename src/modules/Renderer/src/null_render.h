@@ -0,0 +1,383 @@
+#pragma once
+
+#include "dx9render.h"
+#include "null_resources.h"
+
+#include <array>
+#include <cstdint>
+#include <stack>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Render service without a device or a window, started instead of DX9RENDER for CPU frame benchmarks.
+// Calls are accepted and counted, textures are decoded to know their size, nothing is drawn
+class NullRender final : public VDX9RENDER
+{
+  public:
+    // a frame is from RunStart to RunEnd
+    struct Counters
+    {
+        uint64_t drawCalls = 0;
+        uint64_t primitives = 0;
+        uint64_t userBytes = 0;   // vertices and indices passed by pointer to the draw calls
+        uint64_t lockedBytes = 0; // buffers and texture levels locked through the render
+        uint64_t techniques = 0;
+        uint64_t stateChanges = 0; // render, sampler, texture stage states and texture binds
+        uint64_t textureLoads = 0;
+        uint64_t textureBytes = 0; // decoded by the texture loads
+        uint64_t prints = 0;
+
+        void Add(const Counters &other);
+    };
+
+    NullRender();
+    ~NullRender() override;
+
+    bool Init() override;
+    void RunStart() override;
+    void RunEnd() override;
+    uint32_t RunSection() override
+    {
+        return SECTION_REALIZE;
+    };
+
+    [[nodiscard]] const Counters &FrameCounters() const;
+    [[nodiscard]] const Counters &TotalCounters() const;
+    [[nodiscard]] uint32_t NumFrames() const;
+    // bytes held by the buffers and textures alive now
+    [[nodiscard]] uint64_t ResidentBytes() const;
+
+    // DX9Render: Init/Release
+    bool InitDevice(bool windowed, HWND hwnd, int32_t width, int32_t height) override;
+    bool ReleaseDevice() override;
+
+    // DX9Render: Animation
+    void RenderAnimation(int32_t ib, void *src, int32_t numVrts, int32_t minv, int32_t numv, int32_t startidx,
+                         int32_t numtrg, bool isUpdateVB) override;
+
+    // DX9Render: Return d3d9 device
+    void *GetD3DDevice() override;
+
+    // DX9Render: Render Target/Begin/End/Clear
+    bool DX9Clear(int32_t type) override;
+    bool DX9BeginScene() override;
+    bool DX9EndScene() override;
+
+    // DX9Render: Materials/Lights Section
+    bool SetLight(uint32_t dwIndex, const D3DLIGHT9 *pLight) override;
+    bool LightEnable(uint32_t dwIndex, bool bOn) override;
+    bool SetMaterial(D3DMATERIAL9 &material) override;
+    bool GetLightEnable(uint32_t dwIndex, BOOL *pEnable) override;
+    bool GetLight(uint32_t dwIndex, D3DLIGHT9 *pLight) override;
+
+    // DX9Render: Screenshot Section
+    void SaveShoot() override;
+
+    // DX9Render: Clip Planes Section
+    HRESULT SetClipPlane(uint32_t Index, const float *pPlane) override;
+    PLANE *GetPlanes() override;
+
+    // DX9Render: Camera Section
+    void SetTransform(int32_t type, D3DMATRIX *mtx) override;
+    void GetTransform(int32_t type, D3DMATRIX *mtx) override;
+
+    bool SetCamera(const CVECTOR &pos, const CVECTOR &ang, float perspective) override;
+    bool SetCamera(const CVECTOR &pos, const CVECTOR &ang) override;
+    bool SetCamera(CVECTOR lookFrom, CVECTOR lookTo, CVECTOR up) override;
+    bool SetPerspective(float perspective, float fAspectRatio = -1.0f) override;
+    void GetCamera(CVECTOR &pos, CVECTOR &ang, float &perspective) override;
+
+    bool SetCurrentMatrix(D3DMATRIX *mtx) override;
+
+    // DX9Render: Textures Section
+    int32_t TextureCreate(const char *fname) override;
+    int32_t TextureCreateAsync(const char *fname) override;
+    int32_t TextureCreate(UINT width, UINT height, UINT levels, uint32_t usage, D3DFORMAT format,
+                          D3DPOOL pool) override;
+    bool TextureSet(int32_t stage, int32_t texid) override;
+    bool TextureRelease(int32_t texid) override;
+    bool TextureIncReference(int32_t texid) override;
+
+    // DX9Render: Fonts Section
+    int32_t Print(int32_t x, int32_t y, const char *format, ...) override;
+    int32_t Print(int32_t nFontNum, uint32_t color, int32_t x, int32_t y, const char *format, ...) override;
+    int32_t ExtPrint(int32_t nFontNum, uint32_t foreColor, uint32_t backColor, int wAlignment, bool bShadow,
+                     float fScale, int32_t scrWidth, int32_t scrHeight, int32_t x, int32_t y, const char *format,
+                     ...) override;
+    int32_t StringWidth(const char *string, int32_t nFontNum = 0, float fScale = 1.f, int32_t scrWidth = 0) override;
+    int32_t StringWidth(const std::string_view &string, int32_t nFontNum = 0, float fScale = 1.f,
+                        int32_t scrWidth = 0) override;
+    int32_t CharWidth(utf8::u8_char ucVKey, int32_t nFontNum = 0, float fScale = 1.f, int32_t scrWidth = 0) override;
+    int32_t CharHeight(int32_t fontID) override;
+    int32_t LoadFont(const std::string_view &fontName) override;
+    bool UnloadFont(const char *fontName) override;
+    bool UnloadFont(int32_t fontID) override;
+    bool IncRefCounter(int32_t fontID) override;
+    bool SetCurFont(const char *fontName) override;
+    bool SetCurFont(int32_t fontID) override;
+    int32_t GetCurFont() override;
+    char *GetFontIniFileName() override;
+    bool SetFontIniFileName(const char *iniName) override;
+
+    // DX9Render: Techniques Section
+    int32_t TechniqueGetHandle(const char *cBlockName) override;
+    bool TechniqueExecuteStart(const char *cBlockName) override;
+    bool TechniqueExecuteStart(int32_t technique) override;
+    bool TechniqueExecuteNext() override;
+
+    // DX9Render: Draw Section
+    void DrawRects(RS_RECT *pRSR, uint32_t dwRectsNum, const char *cBlockName = nullptr, uint32_t dwSubTexturesX = 1,
+                   uint32_t dwSubTexturesY = 1, float fScaleX = 1.0f, float fScaleY = 1.0f) override;
+    void DrawSprites(RS_SPRITE *pRSS, uint32_t dwSpritesNum, const char *cBlockName = nullptr) override;
+    void DrawLines(RS_LINE *pRSL, uint32_t dwLinesNum, const char *cBlockName = nullptr) override;
+    void DrawVector(const CVECTOR &v1, const CVECTOR &v2, uint32_t dwColor,
+                    const char *pTechniqueName = "DXVector") override;
+    void DrawLines2D(RS_LINE2D *pRSL2D, size_t dwLinesNum, const char *cBlockName = nullptr) override;
+
+    void DrawBuffer(int32_t vbuff, int32_t stride, int32_t ibuff, int32_t minv, size_t numv, size_t startidx,
+                    size_t numtrg, const char *cBlockName = nullptr) override;
+    void DrawIndexedPrimitiveNoVShader(D3DPRIMITIVETYPE dwPrimitiveType, int32_t iVBuff, int32_t iStride,
+                                       int32_t iIBuff, int32_t iMinV, int32_t iNumV, int32_t iStartIdx,
+                                       int32_t iNumTrg, const char *cBlockName = nullptr) override;
+    void DrawPrimitive(D3DPRIMITIVETYPE dwPrimitiveType, int32_t iVBuff, int32_t iStride, int32_t iStartV,
+                       int32_t iNumPT, const char *cBlockName = nullptr) override;
+    void DrawPrimitiveUP(D3DPRIMITIVETYPE dwPrimitiveType, uint32_t dwVertexBufferFormat, uint32_t dwNumPT,
+                         const void *pVerts, uint32_t dwStride, const char *cBlockName = nullptr) override;
+    void DrawIndexedPrimitiveUP(D3DPRIMITIVETYPE dwPrimitiveType, uint32_t dwMinIndex, uint32_t dwNumVertices,
+                                uint32_t dwPrimitiveCount, const void *pIndexData, D3DFORMAT IndexDataFormat,
+                                const void *pVertexData, uint32_t dwVertexStride,
+                                const char *cBlockName = nullptr) override;
+
+    // DX9Render: Video Section
+    void PlayToTexture() override;
+    CVideoTexture *GetVideoTexture(const char *sVideoName) override;
+    void ReleaseVideoTexture(CVideoTexture *pVTexture) override;
+
+    // DX9Render: Vertex/Index Buffers Section
+    int32_t CreateVertexBuffer(int32_t type, size_t nverts, uint32_t usage, uint32_t dwPool = D3DPOOL_DEFAULT) override;
+    int32_t CreateIndexBuffer(size_t ntrgs, uint32_t dwUsage = D3DUSAGE_WRITEONLY) override;
+
+    IDirect3DVertexBuffer9 *GetVertexBuffer(int32_t id) override;
+    int32_t GetVertexBufferFVF(int32_t id) override;
+    void *LockVertexBuffer(int32_t id, uint32_t dwFlags = 0) override;
+    void UnLockVertexBuffer(int32_t id) override;
+    int32_t GetVertexBufferSize(int32_t id) override;
+    void *LockIndexBuffer(int32_t id, uint32_t dwFlags = 0) override;
+    void UnLockIndexBuffer(int32_t id) override;
+    void ReleaseVertexBuffer(int32_t id) override;
+    void ReleaseIndexBuffer(int32_t id) override;
+
+    // DX9Render: Render/Texture States Section
+    uint32_t SetRenderState(uint32_t State, uint32_t Value) override;
+    uint32_t GetRenderState(uint32_t State, uint32_t *pValue) override;
+    uint32_t GetSamplerState(uint32_t Sampler, D3DSAMPLERSTATETYPE Type, uint32_t *pValue) override;
+    uint32_t SetSamplerState(uint32_t Sampler, D3DSAMPLERSTATETYPE Type, uint32_t Value) override;
+    uint32_t SetTextureStageState(uint32_t Stage, uint32_t Type, uint32_t Value) override;
+    uint32_t GetTextureStageState(uint32_t Stage, uint32_t Type, uint32_t *pValue) override;
+
+    // aspect ratio section
+    float GetHeightDeformator() override;
+    POINT GetScreenSize() override;
+
+    // D3D Device/Viewport Section
+    HRESULT GetViewport(D3DVIEWPORT9 *pViewport) override;
+    HRESULT SetViewport(const D3DVIEWPORT9 *pViewport) override;
+    HRESULT GetDeviceCaps(D3DCAPS9 *pCaps) override;
+
+    // D3D
+    HRESULT SetStreamSource(UINT StreamNumber, void *pStreamData, UINT Stride) override;
+    HRESULT SetIndices(void *pIndexData) override;
+    HRESULT DrawPrimitive(D3DPRIMITIVETYPE PrimitiveType, UINT StartVertex, UINT PrimitiveCount) override;
+
+    HRESULT Release(IUnknown *pObject) override;
+
+    // Vertex/Index Buffers Section
+    HRESULT CreateVertexBuffer(UINT Length, uint32_t Usage, uint32_t FVF, D3DPOOL Pool,
+                               IDirect3DVertexBuffer9 **ppVertexBuffer) override;
+    HRESULT VBLock(IDirect3DVertexBuffer9 *pVB, UINT OffsetToLock, UINT SizeToLock, uint8_t **ppbData,
+                   uint32_t Flags) override;
+    void VBUnlock(IDirect3DVertexBuffer9 *pVB) override;
+
+    // D3D Textures/Surfaces Section
+    HRESULT GetDepthStencilSurface(IDirect3DSurface9 **ppZStencilSurface) override;
+    HRESULT GetCubeMapSurface(IDirect3DCubeTexture9 *ppCubeTexture, D3DCUBEMAP_FACES FaceType, UINT Level,
+                              IDirect3DSurface9 **ppCubeMapSurface) override;
+    HRESULT CreateTexture(UINT Width, UINT Height, UINT Levels, uint32_t Usage, D3DFORMAT Format, D3DPOOL Pool,
+                          IDirect3DTexture9 **ppTexture) override;
+    HRESULT CreateCubeTexture(UINT EdgeLength, UINT Levels, uint32_t Usage, D3DFORMAT Format, D3DPOOL Pool,
+                              IDirect3DCubeTexture9 **ppCubeTexture) override;
+    HRESULT CreateOffscreenPlainSurface(UINT Width, UINT Height, D3DFORMAT Format,
+                                        IDirect3DSurface9 **ppSurface) override;
+    HRESULT CreateDepthStencilSurface(UINT Width, UINT Height, D3DFORMAT Format, D3DMULTISAMPLE_TYPE MultiSample,
+                                      IDirect3DSurface9 **ppSurface) override;
+    HRESULT SetTexture(uint32_t Stage, IDirect3DBaseTexture9 *pTexture) override;
+    HRESULT GetLevelDesc(IDirect3DTexture9 *ppTexture, UINT Level, D3DSURFACE_DESC *pDesc) override;
+    HRESULT GetLevelDesc(IDirect3DCubeTexture9 *ppCubeTexture, UINT Level, D3DSURFACE_DESC *pDesc) override;
+    HRESULT LockRect(IDirect3DCubeTexture9 *ppCubeTexture, D3DCUBEMAP_FACES FaceType, UINT Level,
+                     D3DLOCKED_RECT *pLockedRect, const RECT *pRect, uint32_t Flags) override;
+    HRESULT LockRect(IDirect3DTexture9 *ppTexture, UINT Level, D3DLOCKED_RECT *pLockedRect, const RECT *pRect,
+                     uint32_t Flags) override;
+    HRESULT UnlockRect(IDirect3DCubeTexture9 *pCubeTexture, D3DCUBEMAP_FACES FaceType, UINT Level) override;
+    HRESULT UnlockRect(IDirect3DTexture9 *pTexture, UINT Level) override;
+    HRESULT GetSurfaceLevel(IDirect3DTexture9 *ppTexture, UINT Level, IDirect3DSurface9 **ppSurfaceLevel) override;
+    HRESULT UpdateSurface(IDirect3DSurface9 *pSourceSurface, const RECT *pSourceRectsArray, UINT cRects,
+                          IDirect3DSurface9 *pDestinationSurface, const POINT *pDestPointsArray) override;
+    HRESULT StretchRect(IDirect3DSurface9 *pSourceSurface, const RECT *pSourceRect, IDirect3DSurface9 *pDestSurface,
+                        const RECT *pDestRect, D3DTEXTUREFILTERTYPE Filter) override;
+    HRESULT GetRenderTargetData(IDirect3DSurface9 *pRenderTarget, IDirect3DSurface9 *pDestSurface) override;
+
+    // D3D Pixel/Vertex Shaders Section
+    HRESULT CreateVertexDeclaration(const D3DVERTEXELEMENT9 *pVertexElements,
+                                    IDirect3DVertexDeclaration9 **ppDecl) override;
+    HRESULT SetVertexDeclaration(IDirect3DVertexDeclaration9 *pDecl) override;
+    HRESULT CreatePixelShader(const uint32_t *pFunction, IDirect3DPixelShader9 **ppShader) override;
+    HRESULT CreateVertexShader(const uint32_t *pFunction, IDirect3DVertexShader9 **ppShader) override;
+    HRESULT DeletePixelShader(IDirect3DPixelShader9 *pShader) override;
+    HRESULT DeleteVertexShader(IDirect3DVertexShader9 *pShader) override;
+    HRESULT SetVertexShader(IDirect3DVertexShader9 *pShader) override;
+    HRESULT SetPixelShader(IDirect3DPixelShader9 *pShader) override;
+    HRESULT SetVertexShaderConstantF(UINT StartRegister, const float *pConstantData, UINT Vector4iCount) override;
+    HRESULT SetPixelShaderConstantF(UINT StartRegister, const float *pConstantData, UINT Vector4iCount) override;
+    HRESULT SetFVF(uint32_t handle) override;
+    HRESULT GetVertexShader(IDirect3DVertexShader9 **ppShader) override;
+    HRESULT GetPixelShader(IDirect3DPixelShader9 **ppShader) override;
+#ifdef _WIN32 // Effects
+    ID3DXEffect *GetEffectPointer(const char *techniqueName) override;
+#endif
+
+    // D3D Render Target/Begin/End/Clear
+    HRESULT GetRenderTarget(IDirect3DSurface9 **ppRenderTarget) override;
+    HRESULT SetRenderTarget(IDirect3DSurface9 *pRenderTarget, IDirect3DSurface9 *pNewZStencil) override;
+    HRESULT Clear(uint32_t Count, const D3DRECT *pRects, uint32_t Flags, D3DCOLOR Color, float Z,
+                  uint32_t Stencil) override;
+    HRESULT BeginScene() override;
+    HRESULT EndScene() override;
+
+    HRESULT ImageBlt(const char *pName, RECT *pDstRect = nullptr, RECT *pSrcRect = nullptr) override;
+    HRESULT ImageBlt(int32_t nTextureId, RECT *pDstRect = nullptr, RECT *pSrcRect = nullptr) override;
+
+    void SetProgressImage(const char *image) override;
+    void SetProgressBackImage(const char *image) override;
+    void SetTipsImage(const char *image) override;
+    void StartProgressView() override;
+    void ProgressView() override;
+    void EndProgressView() override;
+
+    bool IsInsideScene() override;
+    char *GetTipsImage() override;
+    void SetColorParameters(float fGamma, float fBrightness, float fContrast) override;
+
+    void DrawSphere(const CVECTOR &vPos, float fRadius, uint32_t dwColor) override;
+    void DrawEllipsoid(const CVECTOR &vPos, float a, float b, float c, float ay, uint32_t dwColor) override;
+
+    void GetNearFarPlane(float &fNear, float &fFar) override;
+    void SetNearFarPlane(float fNear, float fFar) override;
+
+    void SetLoadTextureEnable(bool bEnable = true) override;
+    IDirect3DBaseTexture9 *GetBaseTexture(int32_t iTexture) override;
+
+    bool PushRenderTarget() override;
+    bool PopRenderTarget() override;
+    bool SetRenderTarget(IDirect3DCubeTexture9 *pCubeTex, uint32_t dwFaceType, uint32_t dwLevel,
+                         IDirect3DSurface9 *pNewZStencil) override;
+    void SetView(const CMatrix &mView) override;
+    void SetWorld(const CMatrix &mView) override;
+    void SetProjection(const CMatrix &mView) override;
+    const CMatrix &GetView() override;
+    const CMatrix &GetWorld() override;
+    const CMatrix &GetProjection() override;
+
+    IDirect3DVolumeTexture9 *CreateVolumeTexture(uint32_t Width, uint32_t Height, uint32_t Depth, uint32_t Levels,
+                                                 uint32_t Usage, D3DFORMAT Format, D3DPOOL Pool) override;
+
+    void MakePostProcess() override;
+    void SetGLOWParams(float _fBlurBrushSize, int32_t _GlowIntensity, int32_t _GlowPasses) override;
+
+    IDirect3DBaseTexture9 *GetTextureFromID(int32_t nTextureID) override;
+
+    bool GetRenderTargetAsTexture(IDirect3DTexture9 **tex) override;
+
+  private:
+    struct Texture
+    {
+        std::string name; // upper case, empty for the textures made in place
+        IDirect3DBaseTexture9 *d3dtex;
+        int32_t ref;
+        uint32_t size;
+    };
+
+    struct IndexBuffer
+    {
+        bool used;
+        std::vector<char> data;
+    };
+
+    struct Font
+    {
+        std::string name;
+        int32_t ref;
+    };
+
+    struct RenderTarget
+    {
+        IDirect3DSurface9 *target;
+        IDirect3DSurface9 *depth;
+    };
+
+    int32_t LoadNamedTexture(const char *fname);
+    int32_t AddTexture(std::string name, IDirect3DBaseTexture9 *d3dtex, uint32_t size);
+    void Draw(const char *technique, uint64_t numPrimitives);
+    void FindPlanes();
+    int32_t PrintText(int32_t nFontNum, float fScale, const char *format, va_list args);
+
+    // render, sampler and texture stage states, the ranges of StateCache
+    std::array<uint32_t, 256> renderStates_{};
+    std::array<std::array<uint32_t, 16>, 16> samplerStates_{};
+    std::array<std::array<uint32_t, 33>, 8> textureStageStates_{};
+
+    std::unordered_map<int32_t, CMatrix> transforms_;
+    std::unordered_map<uint32_t, D3DLIGHT9> lights_;
+    std::unordered_map<uint32_t, bool> lightEnabled_;
+    D3DMATERIAL9 material_{};
+    D3DVIEWPORT9 viewport_{};
+    PLANE viewplane_[4]{};
+
+    POINT screenSize_{};
+    CVECTOR pos_;
+    CVECTOR ang_;
+    float fov_;
+    float aspectRatio_;
+    float fovMultiplier_;
+    float nearPlane_;
+    float farPlane_;
+    int32_t textureDegradation_;
+    bool isInsideScene_;
+    bool isLoadTextureEnabled_;
+
+    std::vector<NullVertexBuffer *> vertexBuffers_;
+    std::vector<IndexBuffer> indexBuffers_;
+    std::vector<char> animationBuffer_;
+
+    std::vector<Texture> textures_;
+    std::unordered_map<std::string, int32_t> textureIndex_;
+    std::array<std::string, 4> texPaths_;
+    int32_t setupPathStep_;
+    uintptr_t setupPathNumber_;
+
+    std::vector<Font> fonts_;
+    int32_t curFont_;
+    std::string fontIniFileName_;
+    std::string tipsImage_;
+
+    std::unordered_map<std::string, int32_t> techniqueHandles_;
+
+    NullSurface *backBuffer_;
+    NullSurface *depthSurface_;
+    RenderTarget renderTarget_;
+    std::stack<RenderTarget> renderTargets_;
+
+    Counters frame_;
+    Counters total_;
+    uint32_t numFrames_;
+};
@@ -0,0 +1,315 @@
+#include "null_resources.h"
+
+#include <algorithm>
+
+namespace
+{
+
+bool IsBlockFormat(D3DFORMAT format)
+{
+    return format == D3DFMT_DXT1 || format == D3DFMT_DXT2 || format == D3DFMT_DXT3 || format == D3DFMT_DXT4 ||
+           format == D3DFMT_DXT5;
+}
+
+uint32_t NumLevels(uint32_t width, uint32_t height, uint32_t levels)
+{
+    uint32_t numLevels = 1;
+    for (auto size = std::max(width, height); size > 1; size >>= 1)
+        numLevels++;
+    return levels == 0 ? numLevels : std::min(levels, numLevels);
+}
+
+D3DSURFACE_DESC SurfaceDesc(uint32_t width, uint32_t height, uint32_t usage, D3DFORMAT format, D3DPOOL pool)
+{
+    D3DSURFACE_DESC desc{};
+    desc.Format = format;
+    desc.Type = D3DRTYPE_SURFACE;
+    desc.Usage = usage;
+    desc.Pool = pool;
+    desc.MultiSampleType = D3DMULTISAMPLE_NONE;
+    desc.MultiSampleQuality = 0;
+    desc.Width = std::max(width, 1u);
+    desc.Height = std::max(height, 1u);
+    return desc;
+}
+
+} // namespace
+
+uint32_t NullFormatPitch(D3DFORMAT format, uint32_t width)
+{
+    switch (format)
+    {
+    case D3DFMT_DXT1:
+        return (width + 3) / 4 * 8;
+    case D3DFMT_DXT2:
+    case D3DFMT_DXT3:
+    case D3DFMT_DXT4:
+    case D3DFMT_DXT5:
+        return (width + 3) / 4 * 16;
+    case D3DFMT_A8:
+    case D3DFMT_L8:
+    case D3DFMT_P8:
+    case D3DFMT_R3G3B2:
+        return width;
+    case D3DFMT_R5G6B5:
+    case D3DFMT_X1R5G5B5:
+    case D3DFMT_A1R5G5B5:
+    case D3DFMT_A4R4G4B4:
+    case D3DFMT_X4R4G4B4:
+    case D3DFMT_A8R3G3B2:
+    case D3DFMT_A8L8:
+    case D3DFMT_L16:
+    case D3DFMT_R16F:
+    case D3DFMT_D16:
+        return width * 2;
+    case D3DFMT_R8G8B8:
+        return width * 3;
+    case D3DFMT_G32R32F:
+        return width * 8;
+    default:
+        return width * 4;
+    }
+}
+
+uint32_t NullFormatRows(D3DFORMAT format, uint32_t height)
+{
+    return IsBlockFormat(format) ? (height + 3) / 4 : height;
+}
+
+// ============================================================================================
+// NullSurface
+// ============================================================================================
+
+NullSurface::NullSurface(const D3DSURFACE_DESC &desc) : NullResource(D3DRTYPE_SURFACE), desc_(desc)
+{
+}
+
+HRESULT NullSurface::GetContainer(REFIID riid, void **ppContainer)
+{
+    if (ppContainer)
+        *ppContainer = nullptr;
+    return E_NOINTERFACE;
+}
+
+HRESULT NullSurface::GetDesc(D3DSURFACE_DESC *pDesc)
+{
+    if (!pDesc)
+        return D3DERR_INVALIDCALL;
+    *pDesc = desc_;
+    return D3D_OK;
+}
+
+HRESULT NullSurface::LockRect(D3DLOCKED_RECT *pLockedRect, const RECT *pRect, DWORD Flags)
+{
+    if (!pLockedRect)
+        return D3DERR_INVALIDCALL;
+    if (bits_.empty())
+        bits_.resize(Size());
+    const auto pitch = NullFormatPitch(desc_.Format, desc_.Width);
+    size_t offset = 0;
+    if (pRect)
+        offset = static_cast<size_t>(NullFormatRows(desc_.Format, pRect->top)) * pitch +
+                 NullFormatPitch(desc_.Format, pRect->left);
+    pLockedRect->Pitch = static_cast<INT>(pitch);
+    pLockedRect->pBits = bits_.data() + std::min(offset, bits_.size());
+    return D3D_OK;
+}
+
+HRESULT NullSurface::UnlockRect()
+{
+    return D3D_OK;
+}
+
+HRESULT NullSurface::GetDC(HDC *phdc)
+{
+    return D3DERR_INVALIDCALL;
+}
+
+HRESULT NullSurface::ReleaseDC(HDC hdc)
+{
+    return D3DERR_INVALIDCALL;
+}
+
+uint32_t NullSurface::Size() const
+{
+    return NullFormatPitch(desc_.Format, desc_.Width) * NullFormatRows(desc_.Format, desc_.Height);
+}
+
+// ============================================================================================
+// NullTexture
+// ============================================================================================
+
+NullTexture::NullTexture(uint32_t width, uint32_t height, uint32_t levels, uint32_t usage, D3DFORMAT format,
+                         D3DPOOL pool)
+    : NullBaseTexture(D3DRTYPE_TEXTURE, NumLevels(width, height, levels))
+{
+    for (uint32_t i = 0; i < numLevels_; i++)
+        levels_.push_back(new NullSurface(SurfaceDesc(width >> i, height >> i, usage, format, pool)));
+}
+
+NullTexture::~NullTexture()
+{
+    for (auto *surface : levels_)
+        surface->Release();
+}
+
+HRESULT NullTexture::GetLevelDesc(UINT Level, D3DSURFACE_DESC *pDesc)
+{
+    if (Level >= levels_.size())
+        return D3DERR_INVALIDCALL;
+    return levels_[Level]->GetDesc(pDesc);
+}
+
+HRESULT NullTexture::GetSurfaceLevel(UINT Level, IDirect3DSurface9 **ppSurfaceLevel)
+{
+    if (!ppSurfaceLevel)
+        return D3DERR_INVALIDCALL;
+    *ppSurfaceLevel = nullptr;
+    if (Level >= levels_.size())
+        return D3DERR_INVALIDCALL;
+    levels_[Level]->AddRef();
+    *ppSurfaceLevel = levels_[Level];
+    return D3D_OK;
+}
+
+HRESULT NullTexture::LockRect(UINT Level, D3DLOCKED_RECT *pLockedRect, const RECT *pRect, DWORD Flags)
+{
+    if (Level >= levels_.size())
+        return D3DERR_INVALIDCALL;
+    return levels_[Level]->LockRect(pLockedRect, pRect, Flags);
+}
+
+HRESULT NullTexture::UnlockRect(UINT Level)
+{
+    if (Level >= levels_.size())
+        return D3DERR_INVALIDCALL;
+    return levels_[Level]->UnlockRect();
+}
+
+HRESULT NullTexture::AddDirtyRect(const RECT *pDirtyRect)
+{
+    return D3D_OK;
+}
+
+uint32_t NullTexture::Size() const
+{
+    uint32_t size = 0;
+    for (const auto *surface : levels_)
+        size += surface->Size();
+    return size;
+}
+
+// ============================================================================================
+// NullCubeTexture
+// ============================================================================================
+
+NullCubeTexture::NullCubeTexture(uint32_t edgeLength, uint32_t levels, uint32_t usage, D3DFORMAT format,
+                                 D3DPOOL pool)
+    : NullBaseTexture(D3DRTYPE_CUBETEXTURE, NumLevels(edgeLength, edgeLength, levels))
+{
+    for (uint32_t face = 0; face < 6; face++)
+        for (uint32_t i = 0; i < numLevels_; i++)
+            surfaces_.push_back(new NullSurface(SurfaceDesc(edgeLength >> i, edgeLength >> i, usage, format, pool)));
+}
+
+NullCubeTexture::~NullCubeTexture()
+{
+    for (auto *surface : surfaces_)
+        surface->Release();
+}
+
+HRESULT NullCubeTexture::GetLevelDesc(UINT Level, D3DSURFACE_DESC *pDesc)
+{
+    if (Level >= numLevels_)
+        return D3DERR_INVALIDCALL;
+    return surfaces_[Level]->GetDesc(pDesc);
+}
+
+HRESULT NullCubeTexture::GetCubeMapSurface(D3DCUBEMAP_FACES FaceType, UINT Level,
+                                           IDirect3DSurface9 **ppCubeMapSurface)
+{
+    if (!ppCubeMapSurface)
+        return D3DERR_INVALIDCALL;
+    *ppCubeMapSurface = Surface(FaceType, Level);
+    if (!*ppCubeMapSurface)
+        return D3DERR_INVALIDCALL;
+    (*ppCubeMapSurface)->AddRef();
+    return D3D_OK;
+}
+
+HRESULT NullCubeTexture::LockRect(D3DCUBEMAP_FACES FaceType, UINT Level, D3DLOCKED_RECT *pLockedRect,
+                                  const RECT *pRect, DWORD Flags)
+{
+    auto *surface = Surface(FaceType, Level);
+    return surface ? surface->LockRect(pLockedRect, pRect, Flags) : D3DERR_INVALIDCALL;
+}
+
+HRESULT NullCubeTexture::UnlockRect(D3DCUBEMAP_FACES FaceType, UINT Level)
+{
+    auto *surface = Surface(FaceType, Level);
+    return surface ? surface->UnlockRect() : D3DERR_INVALIDCALL;
+}
+
+HRESULT NullCubeTexture::AddDirtyRect(D3DCUBEMAP_FACES FaceType, const RECT *pDirtyRect)
+{
+    return D3D_OK;
+}
+
+uint32_t NullCubeTexture::Size() const
+{
+    uint32_t size = 0;
+    for (const auto *surface : surfaces_)
+        size += surface->Size();
+    return size;
+}
+
+NullSurface *NullCubeTexture::Surface(D3DCUBEMAP_FACES face, UINT level) const
+{
+    const auto faceIndex = static_cast<uint32_t>(face);
+    if (faceIndex >= 6 || level >= numLevels_)
+        return nullptr;
+    return surfaces_[faceIndex * numLevels_ + level];
+}
+
+// ============================================================================================
+// NullVertexBuffer
+// ============================================================================================
+
+NullVertexBuffer::NullVertexBuffer(uint32_t length, uint32_t usage, uint32_t fvf, D3DPOOL pool)
+    : NullResource(D3DRTYPE_VERTEXBUFFER), desc_{}
+{
+    desc_.Format = D3DFMT_VERTEXDATA;
+    desc_.Type = D3DRTYPE_VERTEXBUFFER;
+    desc_.Usage = usage;
+    desc_.Pool = pool;
+    desc_.Size = length;
+    desc_.FVF = fvf;
+}
+
+HRESULT NullVertexBuffer::Lock(UINT OffsetToLock, UINT SizeToLock, void **ppbData, DWORD Flags)
+{
+    if (!ppbData || OffsetToLock > desc_.Size)
+        return D3DERR_INVALIDCALL;
+    if (data_.empty())
+        data_.resize(desc_.Size);
+    *ppbData = data_.data() + OffsetToLock;
+    return D3D_OK;
+}
+
+HRESULT NullVertexBuffer::Unlock()
+{
+    return D3D_OK;
+}
+
+HRESULT NullVertexBuffer::GetDesc(D3DVERTEXBUFFER_DESC *pDesc)
+{
+    if (!pDesc)
+        return D3DERR_INVALIDCALL;
+    *pDesc = desc_;
+    return D3D_OK;
+}
+
+uint32_t NullVertexBuffer::Size() const
+{
+    return desc_.Size;
+}
@@ -0,0 +1,204 @@
+#pragma once
+
+#include <d3d9.h>
+
+#include <cstdint>
+#include <vector>
+
+// System memory stand-ins for the d3d9 objects handed out by the null render, nothing here touches a device.
+// The memory of a surface or a buffer is allocated on its first lock
+
+// bytes in a row of pixels, a row of 4x4 blocks for DXT formats
+uint32_t NullFormatPitch(D3DFORMAT format, uint32_t width);
+// rows of pixels or of 4x4 blocks
+uint32_t NullFormatRows(D3DFORMAT format, uint32_t height);
+
+template <class Interface> class NullResource : public Interface
+{
+  public:
+    explicit NullResource(D3DRESOURCETYPE type) : type_(type)
+    {
+    }
+    virtual ~NullResource() = default;
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void **ppvObj) override
+    {
+        if (ppvObj)
+            *ppvObj = nullptr;
+        return E_NOINTERFACE;
+    }
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return ++ref_;
+    }
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const auto ref = --ref_;
+        if (ref == 0)
+            delete this;
+        return ref;
+    }
+
+    HRESULT STDMETHODCALLTYPE GetDevice(IDirect3DDevice9 **ppDevice) override
+    {
+        if (ppDevice)
+            *ppDevice = nullptr;
+        return D3DERR_INVALIDCALL;
+    }
+    HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID refguid, const void *pData, DWORD SizeOfData,
+                                             DWORD Flags) override
+    {
+        return D3DERR_INVALIDCALL;
+    }
+    HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID refguid, void *pData, DWORD *pSizeOfData) override
+    {
+        return D3DERR_NOTFOUND;
+    }
+    HRESULT STDMETHODCALLTYPE FreePrivateData(REFGUID refguid) override
+    {
+        return D3DERR_NOTFOUND;
+    }
+    DWORD STDMETHODCALLTYPE SetPriority(DWORD PriorityNew) override
+    {
+        const auto priority = priority_;
+        priority_ = PriorityNew;
+        return priority;
+    }
+    DWORD STDMETHODCALLTYPE GetPriority() override
+    {
+        return priority_;
+    }
+    void STDMETHODCALLTYPE PreLoad() override
+    {
+    }
+    D3DRESOURCETYPE STDMETHODCALLTYPE GetType() override
+    {
+        return type_;
+    }
+
+  private:
+    ULONG ref_ = 1;
+    D3DRESOURCETYPE type_;
+    DWORD priority_ = 0;
+};
+
+class NullSurface final : public NullResource<IDirect3DSurface9>
+{
+  public:
+    explicit NullSurface(const D3DSURFACE_DESC &desc);
+
+    HRESULT STDMETHODCALLTYPE GetContainer(REFIID riid, void **ppContainer) override;
+    HRESULT STDMETHODCALLTYPE GetDesc(D3DSURFACE_DESC *pDesc) override;
+    HRESULT STDMETHODCALLTYPE LockRect(D3DLOCKED_RECT *pLockedRect, const RECT *pRect, DWORD Flags) override;
+    HRESULT STDMETHODCALLTYPE UnlockRect() override;
+    HRESULT STDMETHODCALLTYPE GetDC(HDC *phdc) override;
+    HRESULT STDMETHODCALLTYPE ReleaseDC(HDC hdc) override;
+
+    [[nodiscard]] uint32_t Size() const;
+
+  private:
+    D3DSURFACE_DESC desc_;
+    std::vector<char> bits_;
+};
+
+template <class Interface> class NullBaseTexture : public NullResource<Interface>
+{
+  public:
+    NullBaseTexture(D3DRESOURCETYPE type, uint32_t numLevels) : NullResource<Interface>(type), numLevels_(numLevels)
+    {
+    }
+
+    DWORD STDMETHODCALLTYPE SetLOD(DWORD LODNew) override
+    {
+        const auto lod = lod_;
+        lod_ = LODNew < numLevels_ ? LODNew : numLevels_ - 1;
+        return lod;
+    }
+    DWORD STDMETHODCALLTYPE GetLOD() override
+    {
+        return lod_;
+    }
+    DWORD STDMETHODCALLTYPE GetLevelCount() override
+    {
+        return numLevels_;
+    }
+    HRESULT STDMETHODCALLTYPE SetAutoGenFilterType(D3DTEXTUREFILTERTYPE FilterType) override
+    {
+        filter_ = FilterType;
+        return D3D_OK;
+    }
+    D3DTEXTUREFILTERTYPE STDMETHODCALLTYPE GetAutoGenFilterType() override
+    {
+        return filter_;
+    }
+    void STDMETHODCALLTYPE GenerateMipSubLevels() override
+    {
+    }
+
+  protected:
+    uint32_t numLevels_;
+
+  private:
+    DWORD lod_ = 0;
+    D3DTEXTUREFILTERTYPE filter_ = D3DTEXF_LINEAR;
+};
+
+class NullTexture final : public NullBaseTexture<IDirect3DTexture9>
+{
+  public:
+    NullTexture(uint32_t width, uint32_t height, uint32_t levels, uint32_t usage, D3DFORMAT format, D3DPOOL pool);
+    ~NullTexture() override;
+
+    HRESULT STDMETHODCALLTYPE GetLevelDesc(UINT Level, D3DSURFACE_DESC *pDesc) override;
+    HRESULT STDMETHODCALLTYPE GetSurfaceLevel(UINT Level, IDirect3DSurface9 **ppSurfaceLevel) override;
+    HRESULT STDMETHODCALLTYPE LockRect(UINT Level, D3DLOCKED_RECT *pLockedRect, const RECT *pRect,
+                                       DWORD Flags) override;
+    HRESULT STDMETHODCALLTYPE UnlockRect(UINT Level) override;
+    HRESULT STDMETHODCALLTYPE AddDirtyRect(const RECT *pDirtyRect) override;
+
+    // bytes of all the levels
+    [[nodiscard]] uint32_t Size() const;
+
+  private:
+    std::vector<NullSurface *> levels_;
+};
+
+class NullCubeTexture final : public NullBaseTexture<IDirect3DCubeTexture9>
+{
+  public:
+    NullCubeTexture(uint32_t edgeLength, uint32_t levels, uint32_t usage, D3DFORMAT format, D3DPOOL pool);
+    ~NullCubeTexture() override;
+
+    HRESULT STDMETHODCALLTYPE GetLevelDesc(UINT Level, D3DSURFACE_DESC *pDesc) override;
+    HRESULT STDMETHODCALLTYPE GetCubeMapSurface(D3DCUBEMAP_FACES FaceType, UINT Level,
+                                                IDirect3DSurface9 **ppCubeMapSurface) override;
+    HRESULT STDMETHODCALLTYPE LockRect(D3DCUBEMAP_FACES FaceType, UINT Level, D3DLOCKED_RECT *pLockedRect,
+                                       const RECT *pRect, DWORD Flags) override;
+    HRESULT STDMETHODCALLTYPE UnlockRect(D3DCUBEMAP_FACES FaceType, UINT Level) override;
+    HRESULT STDMETHODCALLTYPE AddDirtyRect(D3DCUBEMAP_FACES FaceType, const RECT *pDirtyRect) override;
+
+    // bytes of all the levels of all the faces
+    [[nodiscard]] uint32_t Size() const;
+
+  private:
+    NullSurface *Surface(D3DCUBEMAP_FACES face, UINT level) const;
+
+    // levels of the first face, then of the next one
+    std::vector<NullSurface *> surfaces_;
+};
+
+class NullVertexBuffer final : public NullResource<IDirect3DVertexBuffer9>
+{
+  public:
+    NullVertexBuffer(uint32_t length, uint32_t usage, uint32_t fvf, D3DPOOL pool);
+
+    HRESULT STDMETHODCALLTYPE Lock(UINT OffsetToLock, UINT SizeToLock, void **ppbData, DWORD Flags) override;
+    HRESULT STDMETHODCALLTYPE Unlock() override;
+    HRESULT STDMETHODCALLTYPE GetDesc(D3DVERTEXBUFFER_DESC *pDesc) override;
+
+    [[nodiscard]] uint32_t Size() const;
+
+  private:
+    D3DVERTEXBUFFER_DESC desc_;
+    std::vector<char> data_;
+};
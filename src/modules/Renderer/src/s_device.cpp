@@ -19,6 +19,7 @@
 #include <SDL_timer.h>
 
 #include <algorithm>
+#include <cctype>
 #include <imgui_impl_sdl2.h>
 
 using namespace Storm::Filesystem;
@@ -35,6 +36,8 @@ using namespace Storm::Filesystem;
 #endif
 
 #define POST_PROCESS_FVF (D3DFVF_XYZRHW | D3DFVF_TEX4)
+// block of a technique handle not looked up in the loaded techniques yet
+#define TECHNIQUE_UNRESOLVED -2
 
 #define S_RELEASE(a, b)                                                                                                \
     if (a)                                                                                                             \
@@ -106,6 +109,8 @@ DX9RENDER *DX9RENDER::pRS = nullptr;
 
     void LostDeviceSentinel::RunStart()
     {
+        if (!DX9RENDER::pRS)
+            return;
         if (auto d3d9 = static_cast<IDirect3DDevice9 *>(DX9RENDER::pRS->GetD3DDevice()))
         {
             switch (d3d9->TestCooperativeLevel())
@@ -125,6 +130,12 @@ DX9RENDER *DX9RENDER::pRS = nullptr;
 
     }
 
+// The render service may be the null one, script functions must not reach for DX9RENDER::pRS
+static VDX9RENDER *GetScriptRender()
+{
+    return static_cast<VDX9RENDER *>(core.GetService("dx9render"));
+}
+
 uint32_t DX9SetTexturePath(VS_STACK *pS)
 {
     auto *pString = (VDATA *)pS->Pop();
@@ -133,11 +144,8 @@ uint32_t DX9SetTexturePath(VS_STACK *pS)
     const uintptr_t iNumber = pNumber->GetInt();
     auto *const pStr = pString->GetString();
 
-    if (!DX9RENDER::pRS)
-    {
-        core.GetService("dx9render");
-        Assert(DX9RENDER::pRS);
-    }
+    auto *rs = GetScriptRender();
+    Assert(rs);
 
     auto *pVR = (VDATA *)pS->Push();
     if (!pVR || iNumber < 0 || iNumber >= 4)
@@ -146,9 +154,9 @@ uint32_t DX9SetTexturePath(VS_STACK *pS)
         return IFUNCRESULT_OK;
     }
 
-    DX9RENDER::pRS->TextureCreate((const char *)-1);
-    DX9RENDER::pRS->TextureCreate((const char *)iNumber);
-    DX9RENDER::pRS->TextureCreate(static_cast<const char *>(pStr));
+    rs->TextureCreate((const char *)-1);
+    rs->TextureCreate((const char *)iNumber);
+    rs->TextureCreate(static_cast<const char *>(pStr));
 
     pVR->Set(1);
 
@@ -162,7 +170,7 @@ uint32_t RPrint(VS_STACK *pS)
     const int32_t x = ((VDATA *)pS->Pop())->GetInt();
 
     if (pString->GetString())
-        DX9RENDER::pRS->Print(x, y, pString->GetString());
+        GetScriptRender()->Print(x, y, pString->GetString());
     auto *pVR = (VDATA *)pS->Push();
     pVR->Set(0);
     return IFUNCRESULT_OK;
@@ -174,7 +182,7 @@ uint32_t SetGlowParams(VS_STACK *pS)
     const int32_t Intensivity = ((VDATA *)pS->Pop())->GetInt();
     const int32_t BlurPasses = ((VDATA *)pS->Pop())->GetInt();
 
-    DX9RENDER::pRS->SetGLOWParams(fBlurBrushSize, Intensivity, BlurPasses);
+    GetScriptRender()->SetGLOWParams(fBlurBrushSize, Intensivity, BlurPasses);
 
     auto *pVR = (VDATA *)pS->Push();
     pVR->Set(0);
@@ -184,7 +192,7 @@ uint32_t SetGlowParams(VS_STACK *pS)
 uint32_t slGetTexture(VS_STACK *pS)
 {
     auto filename = ((VDATA *)pS->Pop())->GetString();
-    int32_t texNum = DX9RENDER::pRS->TextureCreate(filename);
+    int32_t texNum = GetScriptRender()->TextureCreate(filename);
 
     auto *pVR = (VDATA *)pS->Push();
     pVR->Set(texNum);
@@ -195,7 +203,7 @@ uint32_t slReleaseTexture(VS_STACK *pS)
 {
     int32_t texNum = ((VDATA *)pS->Pop())->GetInt();
 
-    DX9RENDER::pRS->TextureRelease(texNum);
+    GetScriptRender()->TextureRelease(texNum);
     return IFUNCRESULT_OK;
 }
 
@@ -332,25 +340,6 @@ void CreateSphere()
     }
 }
 
-struct SD_TEXTURE_FORMAT
-{
-    TX_FORMAT txFormat;
-    D3DFORMAT d3dFormat;
-    bool isSwizzled;
-    const char *format;
-};
-
-SD_TEXTURE_FORMAT textureFormats[] = {
-    {TXF_DXT1, D3DFMT_DXT1, true, "D3DFMT_DXT1"},
-    {TXF_DXT3, D3DFMT_DXT3, true, "D3DFMT_DXT3"},
-    {TXF_DXT5, D3DFMT_DXT5, true, "D3DFMT_DXT5"},
-    {TXF_A8R8G8B8, D3DFMT_A8R8G8B8, false, "D3DFMT_A8R8G8B8"},
-    {TXF_X8R8G8B8, D3DFMT_X8R8G8B8, false, "D3DFMT_X8R8G8B8"},
-    {TXF_R5G6B5, D3DFMT_R5G6B5, false, "D3DFMT_R5G6B5"},
-    {TXF_A4R4G4B4, D3DFMT_A4R4G4B4, false, "D3DFMT_A4R4G4B4"},
-    {TXF_A1R5G5B5, D3DFMT_A1R5G5B5, false, "D3DFMT_A1R5G5B5"},
-};
-
 uint32_t dwSoundBuffersCount = 0;
 uint32_t dwSoundBytes = 0;
 uint32_t dwSoundBytesCached = 0;
@@ -422,6 +411,9 @@ DX9RENDER::DX9RENDER()
     idFontCurrent = 0;
 
     bLoadTextureEnabled = true;
+    textureUploadBudget = 0;
+    textureTicket = 0;
+    placeholderTexture = nullptr;
 
     bSeaEffect = false;
     fSeaEffectSize = 0.0f;
@@ -513,6 +505,12 @@ bool DX9RENDER::Init() {
     bUseLargeBackBuffer = config.Get<std::int64_t>("UseLargeBackBuffer", 0) != 0;
     bWindow = config.Get<std::int64_t>("full_screen", 1) == 0;
     nTextureDegradation = config.Get<std::int64_t>("texture_degradation", 0);
+    if (config.Get<std::int64_t>("texture_streaming", 0) != 0)
+    {
+        const auto numThreads = std::clamp(std::thread::hardware_concurrency() / 2, 1u, 4u);
+        textureStreamer = std::make_unique<TextureStreamer>(nTextureDegradation, numThreads);
+        textureUploadBudget = config.Get<std::int64_t>("texture_upload_budget", 4096) * 1024;
+    }
     FovMultiplier = config.Get<double>("fov_multiplier", 1.0f);
     screen_size.x = config.Get<std::int64_t>("screen_x", 1024);
     screen_size.y = config.Get<std::int64_t>("screen_y", 768);
@@ -559,12 +557,7 @@ bool DX9RENDER::Init() {
     if (!InitDevice(bWindow, static_cast<HWND>(core.GetWindow()->OSHandle()), screen_size.x, screen_size.y))
         return false;
 
-#ifdef _WIN32 // Effects
-    RecompileEffects();
-#else
-    pTechnique = std::make_unique<CTechnique>(this);
-    pTechnique->DecodeFiles();
-#endif
+    LoadTechniques();
 
     fontIniFileName = config.Get<std::string>("startFontIniFile", "resource\\ini\\fonts.ini");
     // get start ini file for fonts
@@ -658,6 +651,7 @@ DX9RENDER::~DX9RENDER()
 
     STORM_DELETE(DX9sphereVertex);
     ReleaseDevice();
+    textureStreamer.reset();
 }
 
 bool DX9RENDER::InitDevice(bool windowed, HWND _hwnd, int32_t width, int32_t height)
@@ -776,8 +770,9 @@ bool DX9RENDER::InitDevice(bool windowed, HWND _hwnd, int32_t width, int32_t hei
             }
         }
     }
+    stateCache.Invalidate();
 #ifdef _WIN32 // Effects
-    effects_.setDevice(d3d9);
+    effects_.setDevice(d3d9, &stateCache);
 #endif
 
     if (core.IsEditorEnabled() )
@@ -919,6 +914,12 @@ bool DX9RENDER::ReleaseDevice()
     }
 
     bool res = true;
+    if (textureStreamer)
+        textureStreamer->Clear();
+    S_RELEASE(placeholderTexture, 9);
+    TextureIndex.clear();
+    for (int32_t t = 0; t < MAX_STEXTURES; t++)
+        Textures[t].ticket = 0;
     for (int32_t t = 0; t < MAX_STEXTURES; t++)
         if (Textures[t].ref && Textures[t].loaded && Textures[t].d3dtex)
         {
@@ -1167,6 +1168,7 @@ void DX9RENDER::MakePostProcess()
 
     pStateBlock->Apply();
     pStateBlock->Release();
+    stateCache.Invalidate();
 
     SetScreenAsRenderTarget();
     /*
@@ -1219,6 +1221,7 @@ bool DX9RENDER::DX9EndScene()
         Print(80, 90, "v : %d, %.3f Mb", dwTotalVB, float(dwTotalVBSize) / (1024.0f * 1024.0f));
         Print(80, 110, "i : %d, %.3f Mb", dwTotalIB, float(dwTotalIBSize) / (1024.0f * 1024.0f));
         Print(80, 130, "d : %d, lv: %d, li: %d", dwNumDrawPrimitive, dwNumLV, dwNumLI);
+        Print(80, 170, "rs : %d, elided %d", stateCache.Submitted(), stateCache.Elided());
         Print(80, 150, "s : %d, %.3f, %.3f", dwSoundBuffersCount, dwSoundBytes / 1024.f, dwSoundBytesCached / 1024.f);
     }
 
@@ -1293,6 +1296,18 @@ int32_t DX9RENDER::TextureCreate(const char *fname)
         return -1;
     }
 
+    return LoadNamedTexture(fname, false);
+}
+
+int32_t DX9RENDER::TextureCreateAsync(const char *fname)
+{
+    if (!textureStreamer || iSetupPath || (uintptr_t)fname == -1)
+        return TextureCreate(fname);
+    return LoadNamedTexture(fname, true);
+}
+
+int32_t DX9RENDER::LoadNamedTexture(const char *fname, bool isAsync)
+{
     if (fname == nullptr)
     {
         core.Trace("Can't create texture with null name");
@@ -1332,23 +1347,18 @@ int32_t DX9RENDER::TextureCreate(const char *fname)
 
         std::ranges::for_each(_fname, [](char &c) { c = std::toupper(c); });
 
-        const uint32_t hf = MakeHashValue(_fname);
+        if (const auto it = TextureIndex.find(std::string_view(_fname)); it != TextureIndex.end())
+        {
+            Textures[it->second].ref++;
+            return it->second;
+        }
 
         int32_t t;
-        for (t = 0; t < MAX_STEXTURES; t++)
-            if (Textures[t].ref != 0)
-                if (Textures[t].name)
-                    if (Textures[t].hash == hf && storm::iEquals(Textures[t].name, _fname))
-                    {
-                        Textures[t].ref++;
-                        return t;
-                    }
-
         for (t = 0; t < MAX_STEXTURES; t++)
             if (Textures[t].ref == 0)
                 break;
 
-        Textures[t].hash = hf;
+        Textures[t].hash = MakeHashValue(_fname);
 
         const auto len = strlen(_fname) + 1;
         if ((Textures[t].name = new char[len]) == nullptr)
@@ -1357,8 +1367,34 @@ int32_t DX9RENDER::TextureCreate(const char *fname)
         Textures[t].isCubeMap = false;
         Textures[t].loaded = false;
         Textures[t].ref++;
+
+        // only existing .tx files are streamed, anything else is loaded at once
+        if (isAsync)
+        {
+            auto path = GetTexturePath(_fname);
+            if (fio->_FileOrDirectoryExists(path.c_str()))
+            {
+                if (!placeholderTexture)
+                {
+                    CreatePlaceholderTexture();
+                }
+                Textures[t].dwSize = 0;
+                Textures[t].d3dtex = nullptr;
+                if (++textureTicket == 0)
+                {
+                    ++textureTicket; // 0 is no request
+                }
+                Textures[t].ticket = textureTicket;
+                textureStreamer->Push(t, Textures[t].ticket, std::move(path));
+                TextureIndex.emplace(_fname, t);
+                return t;
+            }
+        }
         if (TextureLoad(t))
+        {
+            TextureIndex.emplace(_fname, t);
             return t;
+        }
         Textures[t].ref--;
         STORM_DELETE(Textures[t].name);
     }
@@ -1401,38 +1437,65 @@ bool DX9RENDER::TextureIncReference(int32_t texid)
     return true;
 }
 
-bool DX9RENDER::TextureLoad(int32_t t)
+void DX9RENDER::CreatePlaceholderTexture()
 {
-    using namespace std::literals;
-
-    ProgressView();
-    // Form the path to the texture
-    char fn[_MAX_FNAME];
-    Textures[t].dwSize = 0;
-    if (Textures[t].name == nullptr)
+    // mid grey, close to what most textures average to
+    if (CHECKD3DERR(d3d9->CreateTexture(1, 1, 1, 0, D3DFMT_A8R8G8B8, D3DPOOL_MANAGED, &placeholderTexture, NULL)) ==
+            true ||
+        !placeholderTexture)
     {
-        return false;
+        placeholderTexture = nullptr;
+        return;
     }
+    D3DLOCKED_RECT lock;
+    if (CHECKD3DERR(placeholderTexture->LockRect(0, &lock, NULL, 0L)) == false)
+    {
+        *static_cast<uint32_t *>(lock.pBits) = 0xff808080;
+        placeholderTexture->UnlockRect(0);
+    }
+}
 
-    auto lTexture = std::string(Textures[t].name);
-    std::transform(lTexture.begin(), lTexture.end(), lTexture.begin(), [](unsigned char c) { return std::tolower(c); });
-    auto has_resource_prefix = starts_with(lTexture, "resource\\textures\\");
-    auto has_tx_postfix = ends_with(lTexture, ".tx");
-
-    sprintf_s(fn, "%s%s%s", has_resource_prefix ? "" : "resource\\textures\\", Textures[t].name, has_tx_postfix ? "" : ".tx");
-
-    for (int32_t s = 0, d = 0; fn[d]; s++)
+void DX9RENDER::UploadStreamedTextures()
+{
+    if (!textureStreamer)
+    {
+        return;
+    }
+    for (const auto &result : textureStreamer->Pop(textureUploadBudget))
     {
-        if (d > 0 && (fn[d - 1] == PATH_SEP || fn[d - 1] == WRONG_PATH_SEP) &&
-            (fn[s] == PATH_SEP || fn[s] == WRONG_PATH_SEP))
+        auto &texture = Textures[result.texture];
+        // released, maybe even reused, while it was decoded
+        if (texture.ticket != result.ticket)
         {
             continue;
         }
-        fn[d++] = fn[s];
+        texture.ticket = 0;
+        bTrace = true;
+        TextureUpload(result.texture, result.path.c_str(), result.data);
+    }
+}
+
+IDirect3DBaseTexture9 *DX9RENDER::GetTexture(int32_t texid) const
+{
+    if (Textures[texid].ticket)
+    {
+        return placeholderTexture;
+    }
+    return Textures[texid].d3dtex;
+}
+
+bool DX9RENDER::TextureLoad(int32_t t)
+{
+    ProgressView();
+    Textures[t].dwSize = 0;
+    if (Textures[t].name == nullptr)
+    {
+        return false;
     }
-    // Opening the file
-    auto fileS = fio->_CreateFile(fn, std::ios::binary | std::ios::in);
-    if (!fileS.is_open())
+
+    const auto fn = GetTexturePath(Textures[t].name);
+    const auto data = DecodeTexture(fn.c_str(), nTextureDegradation);
+    if (data.status == TextureData::Status::NotFound)
     {
         // try to load without '.tx' (e.g. raw Targa)
         std::filesystem::path path_to_tex{fn};
@@ -1441,108 +1504,68 @@ bool DX9RENDER::TextureLoad(int32_t t)
         {
             return TextureLoadUsingD3DX(path_to_tex.string().c_str(), t);
         }
-        if (bTrace)
-        {
-            core.Trace("Can't load texture %s", fn);
-        }
+    }
+    if (!TextureUpload(t, fn.c_str(), data))
+    {
         delete Textures[t].name;
         Textures[t].name = nullptr;
         return false;
     }
-    // Reading the header
-    TX_FILE_HEADER head;
-    if (!fio->_ReadFile(fileS, &head, sizeof(head)))
+    return true;
+}
+
+bool DX9RENDER::TextureUpload(int32_t t, const char *fn, const TextureData &data)
+{
+    switch (data.status)
     {
+    case TextureData::Status::Ok:
+        break;
+    case TextureData::Status::BadFormat:
         if (bTrace)
         {
-            core.Trace("Can't load texture %s", fn);
+            core.Trace("Invalidate texture format %s, not loading it.", fn);
         }
-        delete Textures[t].name;
-        Textures[t].name = nullptr;
-        fio->_CloseFile(fileS);
         return false;
-    }
-    // Analyzing the format
-    D3DFORMAT d3dFormat = D3DFMT_UNKNOWN;
-    int32_t textureFI;
-    for (textureFI = 0; textureFI < sizeof(textureFormats) / sizeof(SD_TEXTURE_FORMAT); textureFI++)
-    {
-        if (textureFormats[textureFI].txFormat == head.format)
+    case TextureData::Status::NotSquare:
+        if (bTrace)
         {
-            break;
+            core.Trace("Cube map texture can't has not squared sides %s, not loading it.", fn);
         }
-    }
-    if (textureFI == sizeof(textureFormats) / sizeof(SD_TEXTURE_FORMAT) || head.flags & TX_FLAGS_PALLETTE)
-    {
+        return false;
+    default:
         if (bTrace)
         {
-            core.Trace("Invalidate texture format %s, not loading it.", fn);
+            core.Trace("Can't load texture %s", fn);
         }
-        delete Textures[t].name;
-        Textures[t].name = nullptr;
-        fio->_CloseFile(fileS);
         return false;
     }
-    d3dFormat = textureFormats[textureFI].d3dFormat;
-    bool isSwizzled = textureFormats[textureFI].isSwizzled;
-    const char *formatTxt = textureFormats[textureFI].format;
-    // Skipping mips
-    uint32_t seekposition = 0;
-    for (int32_t nTD = nTextureDegradation; nTD > 0; nTD--)
+
+    Textures[t].dwSize = 0;
+    if (!data.isCubeMap)
     {
-        if (head.nmips <= 1 || head.width <= 32 || head.height <= 32)
-        {
-            break; // degradation limit
-        }
-        seekposition += head.mip_size;
-        head.nmips--;
-        head.width /= 2;
-        head.height /= 2;
-        head.mip_size /= 4;
-    }
-    // Loading the texture
-    if (!(head.flags & TX_FLAGS_CUBEMAP))
-    {
-        // Loading a regular texture
-        // Position in file
-        if (seekposition)
-        {
-            fio->_SetFilePointer(fileS, seekposition, std::ios::cur);
-        }
         // create the texture
         IDirect3DTexture9 *tex = nullptr;
-        if (CHECKD3DERR(d3d9->CreateTexture(head.width, head.height, head.nmips, 0, d3dFormat, D3DPOOL_MANAGED, &tex,
-                                            NULL)) == true ||
+        if (CHECKD3DERR(d3d9->CreateTexture(data.width, data.height, data.numMips, 0, data.format, D3DPOOL_MANAGED,
+                                            &tex, NULL)) == true ||
             !tex)
         {
             if (bTrace)
             {
                 core.Trace(
                     "Texture %s is not created (width: %i, height: %i, num mips: %i, format: %s), not loading it.", fn,
-                    head.width, head.height, head.nmips, formatTxt);
+                    data.width, data.height, data.numMips, data.formatName);
             }
-            delete Textures[t].name;
-            Textures[t].name = nullptr;
-            fio->_CloseFile(fileS);
             return false;
         }
         // Filling the levels
-        for (int32_t m = 0; m < head.nmips; m++)
+        const char *src = data.sides.front().Data();
+        uint32_t mipSize = data.mipSize;
+        for (uint32_t m = 0; m < data.numMips; m++)
         {
-            // take into account the size of the mip
-            Textures[t].dwSize += head.mip_size;
             // Getting the mip surface
-            bool isError = false;
             IDirect3DSurface9 *surface = nullptr;
-            if (CHECKD3DERR(tex->GetSurfaceLevel(m, &surface)) == true || !surface)
-            {
-                isError = true;
-            }
-            else
-            {
-                // read the mip
-                isError = !LoadTextureSurface(fileS, surface, head.mip_size, head.width, head.height, isSwizzled);
-            }
+            const bool isError = CHECKD3DERR(tex->GetSurfaceLevel(m, &surface)) == true || !surface ||
+                                 !LoadTextureSurface(surface, src, mipSize);
             // Freeing the surface
             if (surface)
             {
@@ -1555,36 +1578,21 @@ bool DX9RENDER::TextureLoad(int32_t t)
                 {
                     core.Trace("Can't loading mip %i, texture %s is not created (width: %i, height: %i, num mips: %i, "
                                "format: %s), not loading it.",
-                               m, fn, head.width, head.height, head.nmips, formatTxt);
+                               m, fn, data.width >> m, data.height >> m, data.numMips, data.formatName);
                 }
-                delete Textures[t].name;
-                Textures[t].name = nullptr;
-                fio->_CloseFile(fileS);
                 tex->Release();
                 return false;
             }
-            // recalculate the dimensions for the next mip
-            head.width /= 2;
-            head.height /= 2;
-            head.mip_size /= 4;
+            // take into account the size of the mip
+            Textures[t].dwSize += mipSize;
+            src += mipSize;
+            mipSize /= 4;
         }
         Textures[t].d3dtex = tex;
         Textures[t].isCubeMap = false;
     }
     else
     {
-        // Download cubemap
-        if (head.width != head.height)
-        {
-            if (bTrace)
-            {
-                core.Trace("Cube map texture can't has not squared sides %s, not loading it.", fn);
-            }
-            delete Textures[t].name;
-            Textures[t].name = nullptr;
-            fio->_CloseFile(fileS);
-            return false;
-        }
         // Number of mips
         D3DCAPS9 devcaps;
         if (CHECKD3DERR(d3d9->GetDeviceCaps(&devcaps)))
@@ -1592,129 +1600,44 @@ bool DX9RENDER::TextureLoad(int32_t t)
             if (bTrace)
             {
                 core.Trace("Cube map texture %s is not created (size: %i, num mips: %i, format: %s), not loading it.",
-                           fn, head.width, head.nmips, formatTxt);
+                           fn, data.width, data.numMips, data.formatName);
             }
-            delete Textures[t].name;
-            Textures[t].name = nullptr;
-            fio->_CloseFile(fileS);
             return false;
         }
-        if (!(devcaps.TextureCaps & D3DPTEXTURECAPS_MIPCUBEMAP))
-        {
-            head.nmips = 1;
-        }
+        const uint32_t numMips = devcaps.TextureCaps & D3DPTEXTURECAPS_MIPCUBEMAP ? data.numMips : 1;
         // create the texture
         IDirect3DCubeTexture9 *tex = nullptr;
-        if (CHECKD3DERR(d3d9->CreateCubeTexture(head.width, head.nmips, 0, d3dFormat, D3DPOOL_MANAGED, &tex, NULL)) ==
+        if (CHECKD3DERR(d3d9->CreateCubeTexture(data.width, numMips, 0, data.format, D3DPOOL_MANAGED, &tex, NULL)) ==
                 true ||
             !tex)
         {
             if (bTrace)
             {
                 core.Trace("Cube map texture %s is not created (size: %i, num mips: %i, format: %s), not loading it.",
-                           fn, head.width, head.nmips, formatTxt);
+                           fn, data.width, numMips, data.formatName);
             }
-            delete Textures[t].name;
-            Textures[t].name = nullptr;
-            fio->_CloseFile(fileS);
             return false;
         }
-        // Loading the sides
-        bool isError = false;
-        if (seekposition)
-        {
-            fio->_SetFilePointer(fileS, seekposition, std::ios::cur);
-        }
-        uint32_t sz =
-            LoadCubmapSide(fileS, tex, D3DCUBEMAP_FACE_POSITIVE_Z, head.nmips, head.mip_size, head.width, isSwizzled);
-        if (sz)
+        // Loading the sides in the file order
+        constexpr D3DCUBEMAP_FACES faces[] = {D3DCUBEMAP_FACE_POSITIVE_Z, D3DCUBEMAP_FACE_POSITIVE_X,
+                                              D3DCUBEMAP_FACE_NEGATIVE_Z, D3DCUBEMAP_FACE_NEGATIVE_X,
+                                              D3DCUBEMAP_FACE_POSITIVE_Y, D3DCUBEMAP_FACE_NEGATIVE_Y};
+        for (size_t side = 0; side < std::size(faces); side++)
         {
-            Textures[t].dwSize += sz;
-            if (seekposition)
-            {
-                fio->_SetFilePointer(fileS, seekposition, std::ios::cur);
-            }
-            sz = LoadCubmapSide(fileS, tex, D3DCUBEMAP_FACE_POSITIVE_X, head.nmips, head.mip_size, head.width,
-                                isSwizzled);
-            if (sz)
+            const uint32_t sz =
+                LoadCubmapSide(tex, faces[side], numMips, data.mipSize, data.sides[side].Data());
+            if (!sz)
             {
-                Textures[t].dwSize += sz;
-                if (seekposition)
-                {
-                    fio->_SetFilePointer(fileS, seekposition, std::ios::cur);
-                }
-                sz = LoadCubmapSide(fileS, tex, D3DCUBEMAP_FACE_NEGATIVE_Z, head.nmips, head.mip_size, head.width,
-                                    isSwizzled);
-                if (sz)
-                {
-                    Textures[t].dwSize += sz;
-                    if (seekposition)
-                    {
-                        fio->_SetFilePointer(fileS, seekposition, std::ios::cur);
-                    }
-                    sz = LoadCubmapSide(fileS, tex, D3DCUBEMAP_FACE_NEGATIVE_X, head.nmips, head.mip_size, head.width,
-                                        isSwizzled);
-                    if (sz)
-                    {
-                        Textures[t].dwSize += sz;
-                        if (seekposition)
-                        {
-                            fio->_SetFilePointer(fileS, seekposition, std::ios::cur);
-                        }
-                        sz = LoadCubmapSide(fileS, tex, D3DCUBEMAP_FACE_POSITIVE_Y, head.nmips, head.mip_size,
-                                            head.width, isSwizzled);
-                        if (sz)
-                        {
-                            Textures[t].dwSize += sz;
-                            if (seekposition)
-                            {
-                                fio->_SetFilePointer(fileS, seekposition, std::ios::cur);
-                            }
-                            sz = LoadCubmapSide(fileS, tex, D3DCUBEMAP_FACE_NEGATIVE_Y, head.nmips, head.mip_size,
-                                                head.width, isSwizzled);
-                            if (!sz)
-                            {
-                                isError = true;
-                            }
-                            Textures[t].dwSize += sz;
-                        }
-                        else
-                        {
-                            isError = true;
-                        }
-                    }
-                    else
-                    {
-                        isError = true;
-                    }
-                }
-                else
+                if (bTrace)
                 {
-                    isError = true;
+                    core.Trace(
+                        "Cube map texture %s can't loading (size: %i, num mips: %i, format: %s), not loading it.", fn,
+                        data.width, numMips, data.formatName);
                 }
+                tex->Release();
+                return false;
             }
-            else
-            {
-                isError = true;
-            }
-        }
-        else
-        {
-            isError = true;
-        }
-
-        if (isError)
-        {
-            if (bTrace)
-            {
-                core.Trace("Cube map texture %s can't loading (size: %i, num mips: %i, format: %s), not loading it.",
-                           fn, head.width, head.nmips, formatTxt);
-            }
-            delete Textures[t].name;
-            Textures[t].name = nullptr;
-            fio->_CloseFile(fileS);
-            tex->Release();
-            return false;
+            Textures[t].dwSize += sz;
         }
         Textures[t].d3dtex = tex;
         Textures[t].isCubeMap = true;
@@ -1732,8 +1655,8 @@ bool DX9RENDER::TextureLoad(int32_t t)
         }
         auto fileS2 = fio->_CreateFile("texLoad.txt", std::ios::binary | std::ios::out | std::ios::app);
         totSize += Textures[t].dwSize;
-        sprintf_s(s, "%.2f, size: %d, %d * %d, %s\n", totSize / 1024.0f / 1024.0f, Textures[t].dwSize, head.width,
-                  head.height, Textures[t].name);
+        sprintf_s(s, "%.2f, size: %d, %d * %d, %s\n", totSize / 1024.0f / 1024.0f, Textures[t].dwSize, data.width,
+                  data.height, Textures[t].name);
         fio->_WriteFile(fileS2, s, strlen(s));
         fio->_FlushFileBuffers(fileS2);
         fio->_CloseFile(fileS2);
@@ -1741,8 +1664,6 @@ bool DX9RENDER::TextureLoad(int32_t t)
     dwTotalSize += Textures[t].dwSize;
     //---------------------------------------------------------------
     Textures[t].loaded = true;
-    // Close the file
-    fio->_CloseFile(fileS);
     return true;
 }
 
@@ -1776,30 +1697,20 @@ bool DX9RENDER::TextureLoadUsingD3DX(const char* path, int32_t t)
 
 IDirect3DBaseTexture9 *DX9RENDER::GetBaseTexture(int32_t iTexture)
 {
-    return (iTexture >= 0) ? Textures[iTexture].d3dtex : nullptr;
+    return (iTexture >= 0) ? GetTexture(iTexture) : nullptr;
 }
 
-uint32_t DX9RENDER::LoadCubmapSide(std::fstream &fileS, IDirect3DCubeTexture9 *tex, D3DCUBEMAP_FACES face,
-                                   uint32_t numMips, uint32_t mipSize, uint32_t size, bool isSwizzled)
+uint32_t DX9RENDER::LoadCubmapSide(IDirect3DCubeTexture9 *tex, D3DCUBEMAP_FACES face, uint32_t numMips,
+                                   uint32_t mipSize, const char *src)
 {
     uint32_t texsize = 0;
     // Filling the levels
     for (uint32_t m = 0; m < numMips; m++)
     {
-        // take into account the size of the mip
-        texsize += mipSize;
         // Getting the mip surface
-        bool isError = false;
         IDirect3DSurface9 *surface = nullptr;
-        if (CHECKD3DERR(tex->GetCubeMapSurface(face, m, &surface)) == true || !surface)
-        {
-            isError = true;
-        }
-        else
-        {
-            // read the mip
-            isError = !LoadTextureSurface(fileS, surface, mipSize, size, size, isSwizzled);
-        }
+        const bool isError = CHECKD3DERR(tex->GetCubeMapSurface(face, m, &surface)) == true || !surface ||
+                             !LoadTextureSurface(surface, src, mipSize);
         // Freeing the surface
         if (surface)
         {
@@ -1814,41 +1725,30 @@ uint32_t DX9RENDER::LoadCubmapSide(std::fstream &fileS, IDirect3DCubeTexture9 *t
             }
             return 0;
         }
+        // take into account the size of the mip
+        texsize += mipSize;
+        src += mipSize;
         // recalculate the dimensions for the next mip
-        size /= 2;
         mipSize /= 4;
     }
     return texsize;
 }
 
-bool DX9RENDER::LoadTextureSurface(std::fstream &fileS, IDirect3DSurface9 *suface, uint32_t mipSize, uint32_t width,
-                                   uint32_t height, bool isSwizzled)
+bool DX9RENDER::LoadTextureSurface(IDirect3DSurface9 *suface, const char *src, uint32_t mipSize)
 {
-    //------------------------------------------------------------------------------------------
-    // PC version
-    // ------------------------------------------------------------------------------------------
     // Surface pointer
     D3DLOCKED_RECT lock;
     if (CHECKD3DERR(suface->LockRect(&lock, NULL, 0L)) == true)
     {
         return false;
     }
-    // Reading out
-    if (!fio->_ReadFile(fileS, lock.pBits, mipSize))
-    {
-        if (CHECKD3DERR(suface->UnlockRect()) == true)
-        {
-            return false;
-        }
-        return false;
-    }
+    std::memcpy(lock.pBits, src, mipSize);
     // Surface release
     if (CHECKD3DERR(suface->UnlockRect()) == true)
     {
         return false;
     }
     return true;
-    //------------------------------------------------------------------------------------------
 }
 
 //################################################################################
@@ -1890,7 +1790,7 @@ bool DX9RENDER::TextureSet(int32_t stage, int32_t texid)
     }
     */
 
-    if (CHECKD3DERR(d3d9->SetTexture(stage, Textures[texid].d3dtex)) == true)
+    if (CHECKD3DERR(d3d9->SetTexture(stage, GetTexture(texid))) == true)
     {
         return false;
     }
@@ -1909,8 +1809,15 @@ bool DX9RENDER::TextureRelease(int32_t texid)
     {
         return false;
     }
+    // a streamed texture that is still decoded is dropped when it arrives
+    Textures[texid].ticket = 0;
     if (Textures[texid].name != nullptr)
     {
+        if (const auto it = TextureIndex.find(std::string_view(Textures[texid].name));
+            it != TextureIndex.end() && it->second == texid)
+        {
+            TextureIndex.erase(it);
+        }
         if (texLog)
         {
             auto fileS = fio->_CreateFile("texLoad.txt", std::ios::binary | std::ios::in | std::ios::out);
@@ -2614,16 +2521,24 @@ void DX9RENDER::RestoreRender()
     }
     SetCommonStates();
 
+    LoadTechniques();
+
+    InvokeEntitiesRestoreRender();
+
+    resourcesReleased = false;
+}
+
+void DX9RENDER::LoadTechniques()
+{
 #ifdef _WIN32 // Effects
     RecompileEffects();
 #else
     pTechnique = std::make_unique<CTechnique>(this);
     pTechnique->DecodeFiles();
 #endif
-
-    InvokeEntitiesRestoreRender();
-
-    resourcesReleased = false;
+    // handles keep their names, the blocks are looked up again
+    for (auto &handle : techniqueHandles)
+        handle.block = TECHNIQUE_UNRESOLVED;
 }
 
 void DX9RENDER::RecompileEffects()
@@ -2649,6 +2564,8 @@ bool DX9RENDER::ResetDevice()
 
     if (CHECKD3DERR(d3d9->Reset(&d3dpp)))
         return false;
+    // the device is back to the default states
+    stateCache.Invalidate();
 
     RestoreRender();
 
@@ -2664,6 +2581,8 @@ void DX9RENDER::SetGLOWParams(float _fBlurBrushSize, int32_t _GlowIntensity, int
 
 void DX9RENDER::RunStart()
 {
+    UploadStreamedTextures();
+
     auto *pScriptRender = static_cast<VDATA *>(core.GetScriptVariable("Render"));
     ATTRIBUTES *pARender = pScriptRender->GetAClass();
 
@@ -2718,6 +2637,7 @@ void DX9RENDER::RunStart()
     dwNumDrawPrimitive = 0;
     dwNumLV = 0;
     dwNumLI = 0;
+    stateCache.ResetCounters();
     BeginScene();
 
     auto *editor = core.GetEditor();
@@ -2736,12 +2656,7 @@ void DX9RENDER::RunStart()
     if (core.Controls->GetDebugAsyncKeyState(VK_SHIFT) < 0 && core.Controls->GetDebugAsyncKeyState(VK_F11) < 0)
     {
         InvokeEntitiesLostRender();
-#ifdef _WIN32 // Effects
-        RecompileEffects();
-#else
-        pTechnique = std::make_unique<CTechnique>(this);
-        pTechnique->DecodeFiles();
-#endif
+        LoadTechniques();
         InvokeEntitiesRestoreRender();
     }
 
@@ -3160,7 +3075,12 @@ HRESULT DX9RENDER::SetViewport(const D3DVIEWPORT9 *pViewport)
 
 uint32_t DX9RENDER::SetRenderState(uint32_t State, uint32_t Value)
 {
-    return CHECKD3DERR(d3d9->SetRenderState(static_cast<D3DRENDERSTATETYPE>(State), Value));
+    if (!stateCache.SetRenderState(State, Value))
+        return false;
+    const bool bError = CHECKD3DERR(d3d9->SetRenderState(static_cast<D3DRENDERSTATETYPE>(State), Value));
+    if (bError)
+        stateCache.ForgetRenderState(State);
+    return bError;
 }
 
 uint32_t DX9RENDER::GetRenderState(uint32_t State, uint32_t *pValue)
@@ -3175,12 +3095,23 @@ uint32_t DX9RENDER::GetSamplerState(uint32_t Sampler, D3DSAMPLERSTATETYPE Type,
 
 uint32_t DX9RENDER::SetSamplerState(uint32_t Sampler, D3DSAMPLERSTATETYPE Type, uint32_t Value)
 {
-    return CHECKD3DERR(d3d9->SetSamplerState(Sampler, Type, Value));
+    if (!stateCache.SetSamplerState(Sampler, Type, Value))
+        return false;
+    const bool bError = CHECKD3DERR(d3d9->SetSamplerState(Sampler, Type, Value));
+    if (bError)
+        stateCache.ForgetSamplerState(Sampler, Type);
+    return bError;
 }
 
 uint32_t DX9RENDER::SetTextureStageState(uint32_t Stage, uint32_t Type, uint32_t Value)
 {
-    return CHECKD3DERR(d3d9->SetTextureStageState(Stage, static_cast<D3DTEXTURESTAGESTATETYPE>(Type), Value));
+    if (!stateCache.SetTextureStageState(Stage, Type, Value))
+        return false;
+    const bool bError =
+        CHECKD3DERR(d3d9->SetTextureStageState(Stage, static_cast<D3DTEXTURESTAGESTATETYPE>(Type), Value));
+    if (bError)
+        stateCache.ForgetTextureStageState(Stage, Type);
+    return bError;
 }
 
 uint32_t DX9RENDER::GetTextureStageState(uint32_t Stage, uint32_t Type, uint32_t *pValue)
@@ -3321,6 +3252,22 @@ void DX9RENDER::FindPlanes(IDirect3DDevice9 *d3dDevice)
     viewplane[3].D = (pos.x * viewplane[3].Nx + pos.y * viewplane[3].Ny + pos.z * viewplane[3].Nz);
 }
 
+int32_t DX9RENDER::TechniqueGetHandle(const char *cBlockName)
+{
+    if (!cBlockName || !cBlockName[0])
+        return -1;
+
+    std::string name = cBlockName;
+    std::ranges::transform(name, name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (const auto it = techniqueHandleIndex.find(name); it != techniqueHandleIndex.end())
+        return it->second;
+
+    const auto technique = static_cast<int32_t>(techniqueHandles.size());
+    techniqueHandles.push_back(TechniqueHandle{name, TECHNIQUE_UNRESOLVED});
+    techniqueHandleIndex.emplace(std::move(name), technique);
+    return technique;
+}
+
 #ifdef _WIN32 // Effects
 bool DX9RENDER::TechniqueExecuteStart(const char *cBlockName)
 {
@@ -3338,6 +3285,34 @@ bool DX9RENDER::TechniqueExecuteStart(const char *cBlockName)
 }
 #endif
 
+bool DX9RENDER::TechniqueExecuteStart(int32_t technique)
+{
+    if (technique < 0 || technique >= static_cast<int32_t>(techniqueHandles.size()))
+        return false;
+
+    auto &handle = techniqueHandles[technique];
+    if (handle.block == TECHNIQUE_UNRESOLVED)
+    {
+#ifdef _WIN32 // Effects
+        handle.block = effects_.find(handle.name);
+#else
+        const auto dwBlock = pTechnique->GetBlockIndex(handle.name.c_str());
+        handle.block = (dwBlock == INVALID_BLOCK_INDEX) ? -1 : static_cast<int32_t>(dwBlock);
+#endif
+        if (handle.block < 0)
+            core.Trace("Warning: technique (%s) not found!", handle.name.c_str());
+    }
+    if (handle.block < 0)
+        return false;
+
+#ifdef _WIN32 // Effects
+    return effects_.begin(handle.block);
+#else
+    pTechnique->SetCurrentBlock(static_cast<uint32_t>(handle.block), 0, nullptr);
+    return pTechnique->ExecutePassStart();
+#endif
+}
+
 bool DX9RENDER::TechniqueExecuteNext()
 {
 #ifdef _WIN32 // Effects
@@ -4183,6 +4158,8 @@ void DX9RENDER::ProgressView()
     progressUpdateTime = time;
     isInPViewProcess = true;
     progressSafeCounter = 0;
+    // loading screens are a good time to take in the streamed textures
+    UploadStreamedTextures();
     // Drawing mode
     BeginScene();
     // Filling the vertices of the texture
@@ -4534,7 +4511,7 @@ IDirect3DBaseTexture9 *DX9RENDER::GetTextureFromID(int32_t nTextureID)
 {
     if (nTextureID < 0)
         return nullptr;
-    return Textures[nTextureID].d3dtex;
+    return GetTexture(nTextureID);
 }
 
 bool DX9RENDER::GetRenderTargetAsTexture(IDirect3DTexture9 **tex)
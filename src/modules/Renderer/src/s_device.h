@@ -6,6 +6,8 @@
 #include "technique.h"
 #endif
 #include "font.h"
+#include "state_cache.h"
+#include "texture_streamer.h"
 #include "video_texture.h"
 #include "dx9render.h"
 #include "vma.hpp"
@@ -14,7 +16,10 @@
 #include "d3d9types.h"
 #include "script_libriary.h"
 
+#include <memory>
 #include <stack>
+#include <string_view>
+#include <unordered_map>
 #include <vector>
 
 #define MAX_STEXTURES 10240
@@ -46,6 +51,7 @@ struct STEXTURE
     uint32_t dwSize;
     bool isCubeMap;
     bool loaded;
+    uint32_t ticket; // streaming request in flight, 0 if none
 };
 
 //-----------buffers-----------
@@ -161,6 +167,7 @@ class DX9RENDER : public VDX9RENDER
 
     // DX9Render: Textures Section
     int32_t TextureCreate(const char *fname) override;
+    int32_t TextureCreateAsync(const char *fname) override;
     int32_t TextureCreate(UINT width, UINT height, UINT levels, uint32_t usage, D3DFORMAT format, D3DPOOL pool) override;
     bool TextureSet(int32_t stage, int32_t texid) override;
     bool TextureRelease(int32_t texid) override;
@@ -186,7 +193,9 @@ class DX9RENDER : public VDX9RENDER
     bool SetFontIniFileName(const char *iniName) override;
 
     // DX9Render: Techniques Section
+    int32_t TechniqueGetHandle(const char *cBlockName) override;
     bool TechniqueExecuteStart(const char *cBlockName) override;
+    bool TechniqueExecuteStart(int32_t technique) override;
     bool TechniqueExecuteNext() override;
 
     // DX9Render: Draw Section
@@ -330,10 +339,9 @@ class DX9RENDER : public VDX9RENDER
     HRESULT ImageBlt(int32_t nTextureId, RECT *pDstRect, RECT *pSrcRect) override;
 
     void MakeScreenShot();
-    bool LoadTextureSurface(std::fstream &fileS, IDirect3DSurface9 *suface, uint32_t mipSize, uint32_t width,
-                            uint32_t height, bool isSwizzled);
-    uint32_t LoadCubmapSide(std::fstream &fileS, IDirect3DCubeTexture9 *tex, D3DCUBEMAP_FACES face, uint32_t numMips,
-                            uint32_t mipSize, uint32_t size, bool isSwizzled);
+    bool LoadTextureSurface(IDirect3DSurface9 *suface, const char *src, uint32_t mipSize);
+    uint32_t LoadCubmapSide(IDirect3DCubeTexture9 *tex, D3DCUBEMAP_FACES face, uint32_t numMips, uint32_t mipSize,
+                            const char *src);
 
     // core interface
     bool Init() override;
@@ -449,6 +457,8 @@ class DX9RENDER : public VDX9RENDER
     void RecompileEffects();
 
 private:
+    void LoadTechniques();
+
     struct RECT_VERTEX
     {
         CVECTOR pos;
@@ -478,6 +488,20 @@ private:
     std::unique_ptr<CTechnique> pTechnique;
 #endif
 
+    struct TechniqueHandle
+    {
+        std::string name;
+        // resolved in the loaded techniques, TECHNIQUE_UNRESOLVED after they are loaded again
+        int32_t block;
+    };
+    // the handle is the index
+    std::vector<TechniqueHandle> techniqueHandles;
+    // lower-cased name -> handle
+    std::unordered_map<std::string, int32_t> techniqueHandleIndex;
+
+    // render, sampler and texture stage states set on the device
+    StateCache stateCache;
+
     std::string fontIniFileName;
     std::vector<FONTEntity> FontList{};
     int32_t idFontCurrent;
@@ -495,6 +519,23 @@ private:
     PLANE viewplane[4];
 
     STEXTURE Textures[MAX_STEXTURES]{};
+
+    struct TextureNameHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view name) const noexcept
+        {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+    // upper-cased name -> slot of the loaded named textures
+    std::unordered_map<std::string, int32_t, TextureNameHash, std::equal_to<>> TextureIndex;
+
+    std::unique_ptr<TextureStreamer> textureStreamer;
+    size_t textureUploadBudget;
+    uint32_t textureTicket;
+    IDirect3DTexture9 *placeholderTexture;
     INDEX_BUFFER IndexBuffers[MAX_BUFFERS]{};
     VERTEX_BUFFER VertexBuffers[MAX_BUFFERS]{};
 
@@ -602,6 +643,14 @@ private:
 #endif
     std::string screenshotExt;
 
+    int32_t LoadNamedTexture(const char *fname, bool isAsync);
     bool TextureLoad(int32_t texid);
     bool TextureLoadUsingD3DX(const char *path, int32_t texid);
+    // create the device texture from decoded data, false if it can't be created
+    bool TextureUpload(int32_t texid, const char *path, const TextureData &data);
+    void CreatePlaceholderTexture();
+    // upload the streamed textures that fit into this frame's budget
+    void UploadStreamedTextures();
+    // the placeholder while the texture is streamed
+    IDirect3DBaseTexture9 *GetTexture(int32_t texid) const;
 };
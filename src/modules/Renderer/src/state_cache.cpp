@@ -0,0 +1,98 @@
+#include "state_cache.h"
+
+#include <algorithm>
+
+void StateCache::Invalidate()
+{
+    // wrapped around, the old stamps could match again
+    if (++generation_ == 0)
+    {
+        std::ranges::fill(renderStates_, Entry{});
+        std::ranges::fill(samplerStates_, Entry{});
+        std::ranges::fill(stageStates_, Entry{});
+        generation_ = 1;
+    }
+}
+
+bool StateCache::SetRenderState(uint32_t state, uint32_t value)
+{
+    return Set(RenderState(state), value);
+}
+
+bool StateCache::SetSamplerState(uint32_t sampler, uint32_t type, uint32_t value)
+{
+    return Set(SamplerState(sampler, type), value);
+}
+
+bool StateCache::SetTextureStageState(uint32_t stage, uint32_t type, uint32_t value)
+{
+    return Set(TextureStageState(stage, type), value);
+}
+
+void StateCache::ForgetRenderState(uint32_t state)
+{
+    if (auto *entry = RenderState(state))
+        entry->generation = 0;
+}
+
+void StateCache::ForgetSamplerState(uint32_t sampler, uint32_t type)
+{
+    if (auto *entry = SamplerState(sampler, type))
+        entry->generation = 0;
+}
+
+void StateCache::ForgetTextureStageState(uint32_t stage, uint32_t type)
+{
+    if (auto *entry = TextureStageState(stage, type))
+        entry->generation = 0;
+}
+
+uint32_t StateCache::Submitted() const
+{
+    return submitted_;
+}
+
+uint32_t StateCache::Elided() const
+{
+    return elided_;
+}
+
+void StateCache::ResetCounters()
+{
+    submitted_ = 0;
+    elided_ = 0;
+}
+
+bool StateCache::Set(Entry *entry, uint32_t value)
+{
+    // states out of the shadowed range always go to the device
+    if (entry && entry->generation == generation_ && entry->value == value)
+    {
+        elided_++;
+        return false;
+    }
+
+    if (entry)
+        *entry = Entry{value, generation_};
+    submitted_++;
+    return true;
+}
+
+StateCache::Entry *StateCache::RenderState(uint32_t state)
+{
+    return (state < kNumRenderStates) ? &renderStates_[state] : nullptr;
+}
+
+StateCache::Entry *StateCache::SamplerState(uint32_t sampler, uint32_t type)
+{
+    if (sampler >= kNumSamplers || type >= kNumSamplerStates)
+        return nullptr;
+    return &samplerStates_[sampler * kNumSamplerStates + type];
+}
+
+StateCache::Entry *StateCache::TextureStageState(uint32_t stage, uint32_t type)
+{
+    if (stage >= kNumStages || type >= kNumStageStates)
+        return nullptr;
+    return &stageStates_[stage * kNumStageStates + type];
+}
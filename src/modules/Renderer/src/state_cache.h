@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+// Shadow copy of the device states set through the renderer, a value equal to the shadowed one is not sent again.
+// Anything changing the states behind the renderer (state blocks, device reset) has to invalidate it, the effects
+// set theirs through EffectStateManager
+class StateCache final
+{
+  public:
+    // forget every shadowed value
+    void Invalidate();
+
+    // true if the value has to be set on the device, the shadow is updated then
+    bool SetRenderState(uint32_t state, uint32_t value);
+    bool SetSamplerState(uint32_t sampler, uint32_t type, uint32_t value);
+    bool SetTextureStageState(uint32_t stage, uint32_t type, uint32_t value);
+
+    // the device refused the value, the shadowed one is unknown now
+    void ForgetRenderState(uint32_t state);
+    void ForgetSamplerState(uint32_t sampler, uint32_t type);
+    void ForgetTextureStageState(uint32_t stage, uint32_t type);
+
+    // states sent to the device and dropped as redundant since the last reset
+    [[nodiscard]] uint32_t Submitted() const;
+    [[nodiscard]] uint32_t Elided() const;
+    void ResetCounters();
+
+  private:
+    // D3DRS_BLENDOPALPHA is the last render state
+    static constexpr uint32_t kNumRenderStates = 256;
+    // D3DVERTEXTEXTURESAMPLER and D3DDMAPSAMPLER ones are not shadowed
+    static constexpr uint32_t kNumSamplers = 16;
+    // D3DSAMP_DMAPOFFSET is the last sampler state
+    static constexpr uint32_t kNumSamplerStates = 16;
+    static constexpr uint32_t kNumStages = 8;
+    // D3DTSS_CONSTANT is the last texture stage state
+    static constexpr uint32_t kNumStageStates = 33;
+
+    struct Entry
+    {
+        uint32_t value;
+        // the value is valid while it is equal to the cache one
+        uint32_t generation;
+    };
+
+    bool Set(Entry *entry, uint32_t value);
+    Entry *RenderState(uint32_t state);
+    Entry *SamplerState(uint32_t sampler, uint32_t type);
+    Entry *TextureStageState(uint32_t stage, uint32_t type);
+
+    std::array<Entry, kNumRenderStates> renderStates_{};
+    std::array<Entry, kNumSamplers * kNumSamplerStates> samplerStates_{};
+    std::array<Entry, kNumStages * kNumStageStates> stageStates_{};
+    uint32_t generation_ = 1;
+    uint32_t submitted_ = 0;
+    uint32_t elided_ = 0;
+};
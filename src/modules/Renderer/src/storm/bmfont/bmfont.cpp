@@ -1,9 +1,10 @@
 #include "bmfont.hpp"
 #include "core.h"
+#include "file_service.h"
 
 #include <array>
 #include <filesystem>
-#include <fstream>
+#include <sstream>
 
 namespace storm::bmfont {
 
@@ -27,14 +28,14 @@ bool IsSignatureValid(const std::array<char, 4> &signature) {
 }
 
 template<typename T>
-T Read(std::ifstream &stream)
+T Read(std::istream &stream)
 {
     T value{};
     stream.read(reinterpret_cast<char *>(&value), sizeof(value));
     return value;
 }
 
-std::string ReadString(std::ifstream &stream)
+std::string ReadString(std::istream &stream)
 {
     std::string result{};
     result.resize(MAX_PATH);
@@ -54,6 +55,8 @@ std::string ReadString(std::ifstream &stream)
 
 BmFont::BmFont(const std::string_view &file_path, VDX9RENDER &renderer) : renderer_(renderer)
 {
+    technique_ = renderer_.TechniqueGetHandle("BmFont");
+    gradientTechnique_ = renderer_.TechniqueGetHandle("BmFontGradient");
     LoadFromFnt(std::string(file_path));
 
     InitTextures();
@@ -78,11 +81,11 @@ std::optional<size_t> BmFont::Print(float x, float y, const std::string_view &te
 
     if (gradientTexture_ != -1)
     {
-        renderer_.TechniqueExecuteStart("BmFontGradient");
+        renderer_.TechniqueExecuteStart(gradientTechnique_);
     }
     else
     {
-        renderer_.TechniqueExecuteStart("BmFont");
+        renderer_.TechniqueExecuteStart(technique_);
     }
 
     renderer_.TextureSet(0, textures_[0].textureHandle_);
@@ -173,7 +176,9 @@ void BmFont::LoadFromFnt(const std::string &file_path)
 {
     const std::filesystem::path path = file_path;
     const auto directory = path.parent_path();
-    std::ifstream file(path, std::ios::binary);
+    // fonts may be packed, read them through the file service
+    const auto mapped = fio->_MapFile(file_path.c_str());
+    std::istringstream file(std::string(mapped.Data(), mapped.Size()), std::ios::binary);
 
     std::array<char, 4> signature{};
     file.read(signature.data(), signature.size());
@@ -85,6 +85,8 @@ class BmFont : public VFont {
     int32_t vertexBuffer_{};
 
     int32_t gradientTexture_ = -1;
+    int32_t technique_ = -1;
+    int32_t gradientTechnique_ = -1;
 
 #ifdef _WIN32 // Effects
     static inline ID3DXEffect *fx_;
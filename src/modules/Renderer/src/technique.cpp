@@ -1817,12 +1817,13 @@ bool CTechnique::DecodeFile(std::string sname)
 
     sprintf(fname, "%s", sname.c_str());
     strcpy(sCurrentFileName, fname);
-    auto fileS = fio->_CreateFile(fname, std::ios::binary | std::ios::in);
-    auto dwSize = fio->_GetFileSize(fname);
-    Assert(dwSize != 0);
-    char *pFile = new char[dwSize];
-    fio->_ReadFile(fileS, pFile, dwSize);
-    fio->_CloseFile(fileS);
+    char *pFile = nullptr;
+    uint32_t dwSize = 0;
+    if (!fio->LoadFile(fname, &pFile, &dwSize))
+    {
+        core.Trace("Can't load technique file %s", fname);
+        return false;
+    }
 
     // change 0xd and 0xa to 0x0
     for (uint32_t i = 0; i < dwSize; i++)
@@ -1880,15 +1881,9 @@ bool CTechnique::DecodeFile(std::string sname)
 // return true for drawbuffer, and false for exit
 bool CTechnique::ExecutePassStart()
 {
-    // search block
-    // ~!~
-    auto it = htBlocks.find(sCurrentBlockName);
-    if (it == htBlocks.end())
+    // block is resolved by SetCurrentBlock
+    if (dwCurBlock == INVALID_BLOCK_INDEX)
         return false;
-    dwCurBlock = it->second;
-    // for (uint32_t i=0;i<dwNumBlocks;i++) if (pBlocks[i].dwHashBlockName == dwHashCode &&
-    // (storm::iEquals(pBlocks[i].pBlockName,sCurrentBlockName))) break; if (i==dwNumBlocks) return false;	// don't
-    // find concur block Assert(i == dwFind); dwCurBlock = i;
 
     block_t *pB = &pBlocks[dwCurBlock];
     if (pB->dwNumTechniques == 0)
@@ -2239,29 +2234,48 @@ void CTechnique::RestoreSavedStates()
     ClearSavedStates();
 }
 
+uint32_t CTechnique::GetBlockIndex(const char *name) const
+{
+    if (!name || !name[0])
+        return INVALID_BLOCK_INDEX;
+
+    char sBlockName[256];
+    strcpy_s(sBlockName, name);
+    tolwr(sBlockName);
+    const auto it = htBlocks.find(sBlockName);
+    return (it == htBlocks.end()) ? INVALID_BLOCK_INDEX : it->second;
+}
+
 void CTechnique::SetCurrentBlock(const char *name, uint32_t _dwNumParams, void *pParams)
 {
     if (name && name[0])
     {
-
         strcpy_s(sCurrentBlockName, name);
         tolwr(sCurrentBlockName);
-        // dwHashCode = MakeHashValue(sCurrentBlockName);
-        dwCurNumParams = _dwNumParams;
-
-        if (dwCurNumParams > dwCurParamsMax)
-        {
-            while (dwCurNumParams > dwCurParamsMax)
-                dwCurParamsMax += 10;
-            pCurParams = (uint32_t *)realloc(pCurParams, sizeof(uint32_t) * dwCurParamsMax);
-        }
-
-        for (uint32_t i = 0; i < _dwNumParams; i++)
-            pCurParams[i] = ((uint32_t *)pParams)[i];
+        const auto it = htBlocks.find(sCurrentBlockName);
+        SetCurrentBlock((it == htBlocks.end()) ? INVALID_BLOCK_INDEX : it->second, _dwNumParams, pParams);
     }
     else
     {
+        dwCurBlock = INVALID_BLOCK_INDEX;
         core.Trace("ERROR: SetCurrentBlock: unknown technique <%s> first character is <%s> ", name, name[0]);
     }
 }
+
+void CTechnique::SetCurrentBlock(uint32_t dwBlock, uint32_t _dwNumParams, void *pParams)
+{
+    dwCurBlock = (dwBlock < dwNumBlocks) ? dwBlock : INVALID_BLOCK_INDEX;
+    // dwHashCode = MakeHashValue(sCurrentBlockName);
+    dwCurNumParams = _dwNumParams;
+
+    if (dwCurNumParams > dwCurParamsMax)
+    {
+        while (dwCurNumParams > dwCurParamsMax)
+            dwCurParamsMax += 10;
+        pCurParams = (uint32_t *)realloc(pCurParams, sizeof(uint32_t) * dwCurParamsMax);
+    }
+
+    for (uint32_t i = 0; i < _dwNumParams; i++)
+        pCurParams[i] = ((uint32_t *)pParams)[i];
+}
 #endif // _WIN32
@@ -5,6 +5,8 @@
 
 #include "dx9render.h"
 
+#define INVALID_BLOCK_INDEX 0xFFFFFFFF
+
 struct SRSPARAM
 {
     char *cName;
@@ -156,7 +158,11 @@ class CTechnique
     void ClearSRS_STSS_bUse();
 
   public:
+    // index of the block with the name, or INVALID_BLOCK_INDEX, valid until the techniques are decoded again
+    uint32_t GetBlockIndex(const char *name) const;
+
     void SetCurrentBlock(const char *name, uint32_t _dwNumParams, void *pParams);
+    void SetCurrentBlock(uint32_t dwBlock, uint32_t _dwNumParams, void *pParams);
 
     bool DecodeFile(std::string sname);
     void DecodeFiles(char *sub_dir = nullptr);
@@ -0,0 +1,206 @@
+#include "texture_streamer.h"
+
+#include "file_service.h"
+#include "platform/platform.hpp"
+#include "texture.h"
+
+#include <algorithm>
+
+namespace
+{
+
+struct SD_TEXTURE_FORMAT
+{
+    TX_FORMAT txFormat;
+    D3DFORMAT d3dFormat;
+    const char *format;
+};
+
+const SD_TEXTURE_FORMAT textureFormats[] = {
+    {TXF_DXT1, D3DFMT_DXT1, "D3DFMT_DXT1"},
+    {TXF_DXT3, D3DFMT_DXT3, "D3DFMT_DXT3"},
+    {TXF_DXT5, D3DFMT_DXT5, "D3DFMT_DXT5"},
+    {TXF_A8R8G8B8, D3DFMT_A8R8G8B8, "D3DFMT_A8R8G8B8"},
+    {TXF_X8R8G8B8, D3DFMT_X8R8G8B8, "D3DFMT_X8R8G8B8"},
+    {TXF_R5G6B5, D3DFMT_R5G6B5, "D3DFMT_R5G6B5"},
+    {TXF_A4R4G4B4, D3DFMT_A4R4G4B4, "D3DFMT_A4R4G4B4"},
+    {TXF_A1R5G5B5, D3DFMT_A1R5G5B5, "D3DFMT_A1R5G5B5"},
+};
+
+} // namespace
+
+size_t TextureData::SideSize() const
+{
+    size_t size = 0;
+    for (uint32_t m = 0, mip = mipSize; m < numMips; m++, mip /= 4)
+        size += mip;
+    return size;
+}
+
+size_t TextureData::Size() const
+{
+    return sides.size() * SideSize();
+}
+
+TextureData DecodeTexture(const char *path, int32_t degradation)
+{
+    TextureData texture;
+    texture.file = fio->_MapFile(path);
+    if (!texture.file.IsOpen())
+        return texture;
+    const auto view = texture.file.View();
+
+    // Reading the header
+    const auto *head = view.Get<TX_FILE_HEADER>(0);
+    if (!head || head->nmips <= 0 || head->width <= 0 || head->height <= 0 || head->mip_size < 0)
+    {
+        texture.status = TextureData::Status::BadHeader;
+        return texture;
+    }
+    // Analyzing the format
+    const auto *format = std::ranges::find(textureFormats, head->format, &SD_TEXTURE_FORMAT::txFormat);
+    if (format == std::end(textureFormats) || head->flags & TX_FLAGS_PALLETTE)
+    {
+        texture.status = TextureData::Status::BadFormat;
+        return texture;
+    }
+    texture.format = format->d3dFormat;
+    texture.formatName = format->format;
+    texture.isCubeMap = (head->flags & TX_FLAGS_CUBEMAP) != 0;
+    texture.width = head->width;
+    texture.height = head->height;
+    texture.numMips = head->nmips;
+    texture.mipSize = head->mip_size;
+    if (texture.isCubeMap && texture.width != texture.height)
+    {
+        texture.status = TextureData::Status::NotSquare;
+        return texture;
+    }
+
+    // Skipping mips
+    size_t skipSize = 0;
+    for (int32_t nTD = degradation; nTD > 0; nTD--)
+    {
+        if (texture.numMips <= 1 || texture.width <= 32 || texture.height <= 32)
+            break; // degradation limit
+        skipSize += texture.mipSize;
+        texture.numMips--;
+        texture.width /= 2;
+        texture.height /= 2;
+        texture.mipSize /= 4;
+    }
+
+    // Finding the mips of every side
+    const size_t numSides = texture.isCubeMap ? 6 : 1;
+    const auto sideSize = texture.SideSize();
+    size_t offset = sizeof(TX_FILE_HEADER);
+    for (size_t side = 0; side < numSides; side++)
+    {
+        offset += skipSize;
+        const auto data = view.Sub(offset, sideSize);
+        if (data.Size() != sideSize)
+        {
+            texture.status = TextureData::Status::Truncated;
+            texture.sides.clear();
+            texture.file.Close();
+            return texture;
+        }
+        texture.sides.push_back(data);
+        offset += sideSize;
+    }
+    texture.status = TextureData::Status::Ok;
+    return texture;
+}
+
+std::string GetTexturePath(const char *name)
+{
+    std::string lTexture(name);
+    std::ranges::transform(lTexture, lTexture.begin(), [](unsigned char c) { return std::tolower(c); });
+    const auto has_resource_prefix = starts_with(lTexture, "resource\\textures\\");
+    const auto has_tx_postfix = ends_with(lTexture, ".tx");
+
+    const auto path =
+        std::string(has_resource_prefix ? "" : "resource\\textures\\") + name + (has_tx_postfix ? "" : ".tx");
+    std::string fn;
+    for (const char c : path)
+    {
+        if (!fn.empty() && (fn.back() == PATH_SEP || fn.back() == WRONG_PATH_SEP) &&
+            (c == PATH_SEP || c == WRONG_PATH_SEP))
+        {
+            continue;
+        }
+        fn.push_back(c);
+    }
+    return fn;
+}
+
+TextureStreamer::TextureStreamer(int32_t degradation, uint32_t numThreads) : degradation_(degradation)
+{
+    for (uint32_t i = 0; i < numThreads; i++)
+        threads_.emplace_back(&TextureStreamer::Run, this);
+}
+
+TextureStreamer::~TextureStreamer()
+{
+    {
+        std::lock_guard lock(mutex_);
+        isStopped_ = true;
+    }
+    condition_.notify_all();
+    for (auto &thread : threads_)
+        thread.join();
+}
+
+void TextureStreamer::Push(int32_t texture, uint32_t ticket, std::string path)
+{
+    {
+        std::lock_guard lock(mutex_);
+        requests_.push_back({texture, ticket, std::move(path)});
+    }
+    condition_.notify_one();
+}
+
+std::vector<TextureStreamer::Result> TextureStreamer::Pop(size_t budget)
+{
+    std::vector<Result> results;
+    std::lock_guard lock(mutex_);
+    size_t size = 0;
+    while (!results_.empty() && (results.empty() || size + results_.front().data.Size() <= budget))
+    {
+        size += results_.front().data.Size();
+        results.push_back(std::move(results_.front()));
+        results_.pop_front();
+    }
+    return results;
+}
+
+void TextureStreamer::Clear()
+{
+    std::lock_guard lock(mutex_);
+    requests_.clear();
+    results_.clear();
+}
+
+void TextureStreamer::Run()
+{
+    while (true)
+    {
+        Request request;
+        {
+            std::unique_lock lock(mutex_);
+            condition_.wait(lock, [this] { return isStopped_ || !requests_.empty(); });
+            if (isStopped_)
+                return;
+            request = std::move(requests_.front());
+            requests_.pop_front();
+        }
+
+        auto data = DecodeTexture(request.path.c_str(), degradation_);
+        // the mips are read here, the render thread only copies them from memory
+        for (const auto &side : data.sides)
+            side.Touch();
+
+        std::lock_guard lock(mutex_);
+        results_.push_back({request.texture, request.ticket, std::move(request.path), std::move(data)});
+    }
+}
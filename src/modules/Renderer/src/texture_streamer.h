@@ -0,0 +1,91 @@
+#pragma once
+
+#include "mapped_file.h"
+
+#include <d3d9.h>
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// .tx file read and split into mips, nothing here touches the device
+struct TextureData
+{
+    enum class Status
+    {
+        Ok,
+        NotFound,
+        BadHeader,
+        BadFormat,
+        NotSquare,
+        Truncated,
+    };
+
+    Status status = Status::NotFound;
+    D3DFORMAT format = D3DFMT_UNKNOWN;
+    const char *formatName = "";
+    bool isCubeMap = false;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t numMips = 0;
+    // size of the largest mip, every next one is 4 times smaller
+    uint32_t mipSize = 0;
+    // the file stays mapped until the texture is uploaded, the mips are read in place,
+    // from the disk on the first access unless the streamer touched them on its thread
+    MappedFile file;
+    // mips of every side, sides in the file order: front, right, back, left, top, bottom
+    std::vector<FileView> sides;
+
+    [[nodiscard]] size_t SideSize() const;
+    // size of the mips of all sides
+    [[nodiscard]] size_t Size() const;
+};
+
+// Map a .tx file, skipping the first degradation mips
+TextureData DecodeTexture(const char *path, int32_t degradation);
+// Resource path of a texture, names may omit the textures folder and the extension
+std::string GetTexturePath(const char *name);
+
+// Decodes textures on worker threads, creating and filling them stays on the render thread
+class TextureStreamer final
+{
+  public:
+    struct Result
+    {
+        int32_t texture;
+        uint32_t ticket;
+        std::string path;
+        TextureData data;
+    };
+
+    TextureStreamer(int32_t degradation, uint32_t numThreads);
+    ~TextureStreamer();
+
+    void Push(int32_t texture, uint32_t ticket, std::string path);
+    // decoded textures, the first one always and the next ones while they fit into budget bytes
+    std::vector<Result> Pop(size_t budget);
+    // forget the queued and decoded textures
+    void Clear();
+
+  private:
+    struct Request
+    {
+        int32_t texture;
+        uint32_t ticket;
+        std::string path;
+    };
+
+    void Run();
+
+    int32_t degradation_;
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Request> requests_;
+    std::deque<Result> results_;
+    std::vector<std::thread> threads_;
+    bool isStopped_ = false;
+};
@@ -0,0 +1,327 @@
+#include "texture.h"
+#include "texture_streamer.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+class TempFolder final
+{
+  public:
+    TempFolder() : path_(std::filesystem::temp_directory_path() / "storm_texture_streamer_test")
+    {
+        std::filesystem::remove_all(path_);
+        std::filesystem::create_directories(path_);
+    }
+
+    ~TempFolder()
+    {
+        std::error_code ec;
+        std::filesystem::remove_all(path_, ec);
+    }
+
+    // names are lower case, the resource paths are looked up lower cased
+    std::string File(const char *name) const
+    {
+        return (path_ / name).string();
+    }
+
+  private:
+    std::filesystem::path path_;
+};
+
+// a .tx file whose every byte of a mip is side * 16 + mip, missing bytes cut off its end
+void WriteTexture(const std::string &path, TX_FORMAT format, int32_t size, int32_t bytesPerPixel, int32_t numMips,
+                  bool isCubeMap, size_t missing = 0)
+{
+    TX_FILE_HEADER head{};
+    head.flags = isCubeMap ? TX_FLAGS_CUBEMAP : TX_FLAGS_NONE;
+    head.width = size;
+    head.height = size;
+    head.nmips = numMips;
+    head.format = format;
+    head.mip_size = size * size * bytesPerPixel;
+
+    std::vector<char> data(reinterpret_cast<const char *>(&head), reinterpret_cast<const char *>(&head + 1));
+    for (int32_t side = 0; side < (isCubeMap ? 6 : 1); side++)
+    {
+        for (int32_t mip = 0, mipSize = head.mip_size; mip < numMips; mip++, mipSize /= 4)
+            data.insert(data.end(), mipSize, static_cast<char>(side * 16 + mip));
+    }
+    data.resize(data.size() - missing);
+    std::ofstream(path, std::ios::binary).write(data.data(), static_cast<std::streamsize>(data.size()));
+}
+
+// the first byte of every mip of every side, as they are filled by WriteTexture
+std::vector<char> MipMarks(const TextureData &texture)
+{
+    std::vector<char> marks;
+    for (const auto &side : texture.sides)
+    {
+        size_t offset = 0;
+        for (uint32_t m = 0, mip = texture.mipSize; m < texture.numMips; m++, mip /= 4)
+        {
+            marks.push_back(side.Data()[offset]);
+            offset += mip;
+        }
+    }
+    return marks;
+}
+
+// drops the file from the system cache, it is read from the disk again
+void Evict(const std::string &path)
+{
+#ifdef _WIN32
+    // opening a file without buffering purges its cached pages
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                    FILE_FLAG_NO_BUFFERING, nullptr);
+    if (file != INVALID_HANDLE_VALUE)
+        CloseHandle(file);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd >= 0)
+    {
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+#endif
+}
+
+// copies the mips into a surface one after another as the upload does, returns their size
+size_t UploadMips(const TextureData &texture, std::vector<char> &surface)
+{
+    const auto *src = texture.sides.front().Data();
+    size_t size = 0;
+    for (uint32_t m = 0, mipSize = texture.mipSize; m < texture.numMips; m++, mipSize /= 4)
+    {
+        std::copy_n(src + size, mipSize, surface.data());
+        size += mipSize;
+    }
+    return size;
+}
+} // namespace
+
+TEST_CASE("Decode a texture", "[texture_streamer]")
+{
+    TempFolder folder;
+    const auto path = folder.File("ship.tx");
+    WriteTexture(path, TXF_A8R8G8B8, 256, 4, 5, false);
+
+    const auto texture = DecodeTexture(path.c_str(), 0);
+    REQUIRE(texture.status == TextureData::Status::Ok);
+    CHECK(texture.format == D3DFMT_A8R8G8B8);
+    CHECK(texture.width == 256);
+    CHECK(texture.height == 256);
+    CHECK(texture.numMips == 5);
+    CHECK(texture.mipSize == 256 * 256 * 4);
+    REQUIRE(texture.sides.size() == 1);
+    CHECK(texture.Size() == texture.SideSize());
+    CHECK(MipMarks(texture) == std::vector<char>{0, 1, 2, 3, 4});
+}
+
+TEST_CASE("Degradation skips the largest mips", "[texture_streamer]")
+{
+    TempFolder folder;
+    const auto path = folder.File("sky.tx");
+    WriteTexture(path, TXF_DXT5, 128, 1, 4, true);
+
+    // a side keeps at least 32 pixels
+    const auto texture = DecodeTexture(path.c_str(), 3);
+    REQUIRE(texture.status == TextureData::Status::Ok);
+    CHECK(texture.isCubeMap);
+    REQUIRE(texture.sides.size() == 6);
+    CHECK(texture.width == 32);
+    CHECK(texture.numMips == 2);
+    CHECK(texture.mipSize == 32 * 32);
+    // every side is read from its own offset
+    CHECK(MipMarks(texture) == std::vector<char>{2, 3, 18, 19, 34, 35, 50, 51, 66, 67, 82, 83});
+}
+
+TEST_CASE("Broken textures are reported", "[texture_streamer]")
+{
+    TempFolder folder;
+    CHECK(DecodeTexture(folder.File("missing.tx").c_str(), 0).status == TextureData::Status::NotFound);
+
+    const auto truncated = folder.File("truncated.tx");
+    WriteTexture(truncated, TXF_DXT1, 64, 1, 3, true, 1);
+    const auto texture = DecodeTexture(truncated.c_str(), 0);
+    CHECK(texture.status == TextureData::Status::Truncated);
+    CHECK(texture.sides.empty());
+    CHECK_FALSE(texture.file.IsOpen());
+
+    // the device formats only, DXT2 and DXT4 are premultiplied
+    const auto premultiplied = folder.File("premultiplied.tx");
+    WriteTexture(premultiplied, TXF_DXT2, 64, 1, 1, false);
+    CHECK(DecodeTexture(premultiplied.c_str(), 0).status == TextureData::Status::BadFormat);
+}
+
+TEST_CASE("Streamer hands out decoded textures within the budget", "[texture_streamer]")
+{
+    TempFolder folder;
+    const char *names[] = {"a.tx", "b.tx", "c.tx"};
+    for (const auto *name : names)
+        WriteTexture(folder.File(name), TXF_A8R8G8B8, 64, 4, 1, false);
+
+    TextureStreamer streamer(0, 2);
+    for (int32_t n = 0; n < 3; n++)
+        streamer.Push(n, static_cast<uint32_t>(n), folder.File(names[n]));
+
+    std::vector<TextureStreamer::Result> results;
+    while (results.size() < 3)
+    {
+        // the first texture is handed out even over the budget, the next ones only within it
+        auto popped = streamer.Pop(1);
+        CHECK(popped.size() <= 1);
+        for (auto &result : popped)
+            results.push_back(std::move(result));
+        std::this_thread::yield();
+    }
+    for (const auto &result : results)
+    {
+        CHECK(result.data.status == TextureData::Status::Ok);
+        CHECK(result.path == folder.File(names[result.texture]));
+    }
+}
+
+TEST_CASE("Decode a location's textures", "[texture_streamer][benchmark]")
+{
+    // no game resources in the tree: a synthetic set the size of a location's, 48 DXT5 1024x1024 with all mips
+    constexpr int32_t kTextures = 48;
+    TempFolder folder;
+    std::vector<std::string> paths;
+    for (int32_t n = 0; n < kTextures; n++)
+    {
+        paths.push_back(folder.File(("texture_" + std::to_string(n) + ".tx").c_str()));
+        WriteTexture(paths.back(), TXF_DXT5, 1024, 1, 11, false);
+    }
+
+    // the mips end up in the locked surfaces of the device texture, a buffer stands in for them
+    std::vector<char> surface(1024 * 1024);
+
+    // as TextureLoad read them before: the header and then every mip straight into its surface
+    BENCHMARK("std::ifstream, one mip at a time")
+    {
+        size_t size = 0;
+        for (const auto &path : paths)
+        {
+            std::ifstream file(path, std::ios::binary);
+            TX_FILE_HEADER head;
+            file.read(reinterpret_cast<char *>(&head), sizeof(head));
+            for (int32_t m = 0, mipSize = head.mip_size; m < head.nmips; m++, mipSize /= 4)
+            {
+                file.read(surface.data(), mipSize);
+                size += mipSize;
+            }
+        }
+        return size;
+    };
+
+    BENCHMARK("DecodeTexture")
+    {
+        size_t size = 0;
+        for (const auto &path : paths)
+            size += UploadMips(DecodeTexture(path.c_str(), 0), surface);
+        return size;
+    };
+
+    BENCHMARK("TextureStreamer, 4 threads")
+    {
+        TextureStreamer streamer(0, 4);
+        for (int32_t n = 0; n < kTextures; n++)
+            streamer.Push(n, static_cast<uint32_t>(n), paths[n]);
+        size_t size = 0;
+        for (int32_t done = 0; done < kTextures;)
+        {
+            for (const auto &result : streamer.Pop(SIZE_MAX))
+            {
+                size += UploadMips(result.data, surface);
+                done++;
+            }
+            std::this_thread::yield();
+        }
+        return size;
+    };
+
+    // the hitch: what is left for the render thread once the textures are decoded, with the files on the disk
+    BENCHMARK_ADVANCED("render thread upload, cold, mapped only")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::vector<TextureData>> decoded(meter.runs());
+        for (auto &textures : decoded)
+        {
+            for (const auto &path : paths)
+            {
+                Evict(path);
+                textures.push_back(DecodeTexture(path.c_str(), 0));
+            }
+        }
+        meter.measure([&](int run) {
+            size_t size = 0;
+            for (const auto &texture : decoded[run])
+                size += UploadMips(texture, surface);
+            return size;
+        });
+    };
+
+    BENCHMARK_ADVANCED("render thread upload, cold, streamed")(Catch::Benchmark::Chronometer meter)
+    {
+        std::vector<std::vector<TextureStreamer::Result>> decoded(meter.runs());
+        for (auto &results : decoded)
+        {
+            TextureStreamer streamer(0, 4);
+            for (int32_t n = 0; n < kTextures; n++)
+            {
+                Evict(paths[n]);
+                streamer.Push(n, static_cast<uint32_t>(n), paths[n]);
+            }
+            while (results.size() < kTextures)
+            {
+                for (auto &result : streamer.Pop(SIZE_MAX))
+                    results.push_back(std::move(result));
+                std::this_thread::yield();
+            }
+        }
+        meter.measure([&](int run) {
+            size_t size = 0;
+            for (const auto &result : decoded[run])
+                size += UploadMips(result.data, surface);
+            return size;
+        });
+    };
+
+    // the eviction is timed too, it is small next to the reads
+    BENCHMARK("TextureStreamer, 4 threads, cold")
+    {
+        for (const auto &path : paths)
+            Evict(path);
+        TextureStreamer streamer(0, 4);
+        for (int32_t n = 0; n < kTextures; n++)
+            streamer.Push(n, static_cast<uint32_t>(n), paths[n]);
+        size_t size = 0;
+        for (int32_t done = 0; done < kTextures;)
+        {
+            for (const auto &result : streamer.Pop(SIZE_MAX))
+            {
+                size += result.data.Size();
+                done++;
+            }
+            std::this_thread::yield();
+        }
+        return size;
+    };
+}
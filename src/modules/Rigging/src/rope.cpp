@@ -18,6 +18,7 @@ ROPE::ROPE()
     bYesDeleted = false;
     wRopeLast = 0;
     RenderService = nullptr;
+    technique = -1;
     gdata = nullptr;
     groupQuantity = 0;
     rlist = nullptr;
@@ -79,6 +80,7 @@ void ROPE::SetDevice()
     {
         throw std::runtime_error("No service: dx9render");
     }
+    technique = RenderService->TechniqueGetHandle("ShipRope");
 
     LoadIni();
 
@@ -151,7 +153,7 @@ void ROPE::Realize(uint32_t Delta_Time)
             RenderService->GetCamera(cp, ca, pr);
             pr = tanf(pr * .5f);
 
-            const auto bDraw = RenderService->TechniqueExecuteStart("ShipRope");
+            const auto bDraw = RenderService->TechniqueExecuteStart(technique);
 
             if (bDraw)
             {
@@ -48,6 +48,7 @@ class ROPE : public ROPE_BASE
     int32_t texl;
 
     VDX9RENDER *RenderService;
+    int32_t technique;
 
   public:
     ROPE();
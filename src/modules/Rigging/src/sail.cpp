@@ -81,6 +81,7 @@ SAIL::SAIL()
     wFirstIndx = 0;
     bDeleteState = false;
     RenderService = nullptr;
+    technique = -1;
 
     bCannonTrace = false;
 
@@ -147,6 +148,7 @@ void SAIL::SetDevice()
     {
         throw std::runtime_error("No service: dx9render");
     }
+    technique = RenderService->TechniqueGetHandle("ShipSail");
 
     LoadSailIni();
 
@@ -448,7 +450,7 @@ void SAIL::Realize(uint32_t Delta_Time)
     int i, j, idx;
     if (bUse)
     {
-        bool bDraw = RenderService->TechniqueExecuteStart("ShipSail");
+        bool bDraw = RenderService->TechniqueExecuteStart(technique);
         if (!bDraw)
             return;
         RenderService->SetMaterial(mat);
@@ -31,6 +31,7 @@ class SAIL : public SAIL_BASE
     friend SAILONE;
     bool bUse;
     VDX9RENDER *RenderService;
+    int32_t technique;
     D3DMATERIAL9 mat;
     std::filesystem::file_time_type ft_old;
     int32_t texl;
@@ -14,6 +14,7 @@ VANT_BASE::VANT_BASE()
 {
     bUse = false;
     RenderService = nullptr;
+    technique = -1;
     texl = -1;
     bRunFirstTime = true;
     bYesDeleted = false;
@@ -63,6 +64,7 @@ void VANT_BASE::SetDevice()
     {
         throw std::runtime_error("No service: dx9render");
     }
+    technique = RenderService->TechniqueGetHandle("ShipVant");
 
     LoadIni();
 
@@ -114,7 +116,7 @@ void VANT_BASE::Realize(uint32_t Delta_Time)
         uint32_t ambient;
         RenderService->GetRenderState(D3DRS_AMBIENT, &ambient);
         RenderService->SetRenderState(D3DRS_TEXTUREFACTOR, ambient);
-        const auto bDraw = RenderService->TechniqueExecuteStart("ShipVant");
+        const auto bDraw = RenderService->TechniqueExecuteStart(technique);
         if (!bDraw)
             return;
 
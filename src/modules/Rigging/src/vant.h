@@ -51,6 +51,7 @@ class VANT_BASE : public Entity
     }
 
     VDX9RENDER *RenderService;
+    int32_t technique;
 
   protected:
     // parameters obtained from INI file //
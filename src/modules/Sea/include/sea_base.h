@@ -2,8 +2,17 @@
 
 #include "cannon_trace.h"
 
+#include <cstddef>
+
 class SEA_BASE : public CANNON_TRACE_BASE
 {
   public:
     virtual float WaveXZ(float x, float z, CVECTOR *vNormal = nullptr) = 0;
+
+    // wave heights for n points at once, normals may be nullptr; the default is a plain WaveXZ loop
+    virtual void WaveXZBatch(const float *xs, const float *zs, float *ys, CVECTOR *normals, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            ys[i] = WaveXZ(xs[i], zs[i], normals ? &normals[i] : nullptr);
+    }
 };
@@ -27,6 +27,7 @@ using storm::Sqr;
 #define FRAMES 64
 #define XWIDTH 128
 #define YWIDTH 128
+static_assert(XWIDTH == SeaWaves::WIDTH);
 
 #define MIPSLVLS 4
 
@@ -842,120 +843,26 @@ void SEA::SSE_WaveXZ(SeaVertex **pArray)
     pArray[3]->vPos.y += seaHeightOffset_;
 }
 
-float SEA::WaveXZ(float x, float z, CVECTOR *pNormal)
+SeaWaves SEA::Waves() const
 {
-    int32_t iX11, iX12, iX21, iX22, iY11, iY12, iY21, iY22;
-
-    const float fDistance = Sqr(x - vCamPos.x) + Sqr(z - vCamPos.z);
-    if (fDistance > fMaxSeaDistance * fMaxSeaDistance)
-    {
-        if (pNormal)
-            *pNormal = CVECTOR(0.0f, 1.0f, 0.0f);
-        return 0.0f;
-    }
-
-    const float x1 = (x + vMove1.x) * fScale1;
-    const float z1 = (z + vMove1.z) * fScale1;
-    iX11 = ffloor(x1 + 0.0f), iX12 = iX11 + 1;
-    iY11 = ffloor(z1 + 0.0f), iY12 = iY11 + 1;
-    const float fX1 = (x1 - iX11);
-    const float fZ1 = (z1 - iY11);
-    iX11 &= (XWIDTH - 1);
-    iX12 &= (XWIDTH - 1);
-    iY11 &= (XWIDTH - 1);
-    iY12 &= (XWIDTH - 1);
-
-    const float x2 = (x + vMove2.x) * fScale2;
-    const float z2 = (z + vMove2.z) * fScale2;
-    iX21 = ffloor(x2 + 0.0f), iX22 = iX21 + 1;
-    iY21 = ffloor(z2 + 0.0f), iY22 = iY21 + 1;
-    const float fX2 = (x2 - iX21);
-    const float fZ2 = (z2 - iY21);
-    iX21 &= (XWIDTH - 1);
-    iX22 &= (XWIDTH - 1);
-    iY21 &= (XWIDTH - 1);
-    iY22 &= (XWIDTH - 1);
-
-    float a1, a2, a3, a4;
-
-    a1 = pSeaFrame1[iX11 + iY11 * XWIDTH];
-    a2 = pSeaFrame1[iX12 + iY11 * XWIDTH];
-    a3 = pSeaFrame1[iX11 + iY12 * XWIDTH];
-    a4 = pSeaFrame1[iX12 + iY12 * XWIDTH];
-    float fRes = fAmp1 * (a1 + fX1 * (a2 - a1) + fZ1 * (a3 - a1) + fX1 * fZ1 * (a4 + a1 - a2 - a3));
-
-    a1 = pSeaFrame2[iX21 + iY21 * XWIDTH];
-    a2 = pSeaFrame2[iX22 + iY21 * XWIDTH];
-    a3 = pSeaFrame2[iX21 + iY22 * XWIDTH];
-    a4 = pSeaFrame2[iX22 + iY22 * XWIDTH];
-    fRes += fAmp2 * (a1 + fX2 * (a2 - a1) + fZ2 * (a3 - a1) + fX2 * fZ2 * (a4 + a1 - a2 - a3));
-
-    float nx1, nx2, nx3, nx4, nz1, nz2, nz3, nz4;
-
-    nx1 = pSeaNormalsFrame1[2 * (iX11 + iY11 * XWIDTH) + 0];
-    nz1 = pSeaNormalsFrame1[2 * (iX11 + iY11 * XWIDTH) + 1];
-    nx2 = pSeaNormalsFrame1[2 * (iX12 + iY11 * XWIDTH) + 0];
-    nz2 = pSeaNormalsFrame1[2 * (iX12 + iY11 * XWIDTH) + 1];
-    nx3 = pSeaNormalsFrame1[2 * (iX11 + iY12 * XWIDTH) + 0];
-    nz3 = pSeaNormalsFrame1[2 * (iX11 + iY12 * XWIDTH) + 1];
-    nx4 = pSeaNormalsFrame1[2 * (iX12 + iY12 * XWIDTH) + 0];
-    nz4 = pSeaNormalsFrame1[2 * (iX12 + iY12 * XWIDTH) + 1];
-
-    const float nX1 = (nx1 + fX1 * (nx2 - nx1) + fZ1 * (nx3 - nx1) + fX1 * fZ1 * (nx4 + nx1 - nx2 - nx3));
-    const float nZ1 = (nz1 + fX1 * (nz2 - nz1) + fZ1 * (nz3 - nz1) + fX1 * fZ1 * (nz4 + nz1 - nz2 - nz3));
-
-    nx1 = pSeaNormalsFrame2[2 * (iX21 + iY21 * XWIDTH) + 0];
-    nz1 = pSeaNormalsFrame2[2 * (iX21 + iY21 * XWIDTH) + 1];
-    nx2 = pSeaNormalsFrame2[2 * (iX22 + iY21 * XWIDTH) + 0];
-    nz2 = pSeaNormalsFrame2[2 * (iX22 + iY21 * XWIDTH) + 1];
-    nx3 = pSeaNormalsFrame2[2 * (iX21 + iY22 * XWIDTH) + 0];
-    nz3 = pSeaNormalsFrame2[2 * (iX21 + iY22 * XWIDTH) + 1];
-    nx4 = pSeaNormalsFrame2[2 * (iX22 + iY22 * XWIDTH) + 0];
-    nz4 = pSeaNormalsFrame2[2 * (iX22 + iY22 * XWIDTH) + 1];
-
-    const float nX2 = (nx1 + fX2 * (nx2 - nx1) + fZ2 * (nx3 - nx1) + fX2 * fZ2 * (nx4 + nx1 - nx2 - nx3));
-    const float nZ2 = (nz1 + fX2 * (nz2 - nz1) + fZ2 * (nz3 - nz1) + fX2 * fZ2 * (nz4 + nz1 - nz2 - nz3));
-    // float nX2 = 0.0f;
-    // float nZ2 = 0.0f;
-
-    /*float fDistance = sqrt_ss(Sqr(x - vCamPos.x) + Sqr(fRes - vCamPos.y) + Sqr(z - vCamPos.z));
-    {
-      float distance_mul = 1.0f - fDistance / 1900.0f;
-      if (distance_mul < 0.0f) distance_mul = 0.0f;
-
-      fRes *= distance_mul;
-
-      nX1 *= distance_mul;
-      nZ1 *= distance_mul;
-
-      nX2 *= distance_mul;
-      nZ2 *= distance_mul;
-    }*/
-
-    if (pNormal)
-    {
-        /*pNormal->x = 0.0f;
-        pNormal->y = 1.0f;
-        pNormal->z = 0.0f;*/
-        const float nY1 = sqrtf(1.0f - (Sqr(nX1) + Sqr(nZ1)));
-        const float nY2 = sqrtf(1.0f - (Sqr(nX2) + Sqr(nZ2)));
-
-        CVECTOR vNormal;
-
-        vNormal.x = fScale1 * fAmp1 * nX1 + fScale2 * fAmp2 * nX2;
-        vNormal.z = fScale1 * fAmp1 * nZ1 + fScale2 * fAmp2 * nZ2;
-        vNormal.y = nY1 + nY2;
-
-        // vNormal.x += 2.0f * vNormal.x;
-        // vNormal.z += 2.0f * vNormal.z;
-        vNormal = !vNormal;
-
-        *pNormal = vNormal;
-    }
+    return SeaWaves{{pSeaFrame1, pSeaFrame2},
+                    {pSeaNormalsFrame1, pSeaNormalsFrame2},
+                    {vMove1, vMove2},
+                    {fScale1, fScale2},
+                    {fAmp1, fAmp2},
+                    vCamPos,
+                    fMaxSeaDistance,
+                    seaHeightOffset_};
+}
 
-    fRes += seaHeightOffset_;
+void SEA::WaveXZBatch(const float *xs, const float *zs, float *ys, CVECTOR *normals, size_t n)
+{
+    Waves().WaveXZBatch(xs, zs, ys, normals, n);
+}
 
-    return fRes;
+float SEA::WaveXZ(float x, float z, CVECTOR *pNormal)
+{
+    return Waves().WaveXZ(x, z, pNormal);
 }
 
 void SEA::PrepareIndicesForBlock(uint32_t dwBlockIndex)
@@ -1776,33 +1683,47 @@ void SEA::Realize(uint32_t dwDeltaTime)
 
 float SEA::Trace(const CVECTOR &vSrc, const CVECTOR &vDst)
 {
-    const int32_t iNumTests = 5;
-    float fRes = 2.0f;
+    float fWaveY;
+    return TraceWave(vSrc, vDst, fWaveY);
+}
+
+// returns the hit fraction as Trace does and the wave height at the hit point
+float SEA::TraceWave(const CVECTOR &vSrc, const CVECTOR &vDst, float &fHitWaveY)
+{
+    constexpr int32_t iNumTests = 5;
     const float fDV = 1.0f / static_cast<float>(iNumTests - 1);
 
     if (vSrc.y > fMaxSeaHeight && vDst.y > fMaxSeaHeight)
         return 2.0f;
 
+    float xs[iNumTests], ys[iNumTests], zs[iNumTests], fWaveY[iNumTests];
     for (int32_t i = 0; i < iNumTests; i++)
     {
         const CVECTOR vTemp = vSrc + static_cast<float>(i) * fDV * (vDst - vSrc);
-        const float fWaveY = WaveXZ(vTemp.x, vTemp.z, nullptr);
+        xs[i] = vTemp.x;
+        ys[i] = vTemp.y;
+        zs[i] = vTemp.z;
+    }
+    WaveXZBatch(xs, zs, fWaveY, nullptr, iNumTests);
 
-        if (fWaveY > vTemp.y)
+    for (int32_t i = 0; i < iNumTests; i++)
+        if (fWaveY[i] > ys[i])
+        {
+            fHitWaveY = fWaveY[i];
             return static_cast<float>(i) * fDV;
-    }
+        }
 
     return 2.0f;
 }
 
 float SEA::Cannon_Trace(int32_t iBallOwner, const CVECTOR &vSrc, const CVECTOR &vDst)
 {
-    const float fRes = Trace(vSrc, vDst);
+    float fTmpY;
+    const float fRes = TraceWave(vSrc, vDst, fTmpY);
 
     if (fRes <= 1.0f)
     {
         const CVECTOR vTemp = vSrc + fRes * (vDst - vSrc);
-        const float fTmpY = WaveXZ(vTemp.x, vTemp.z, nullptr);
         core.Event(BALL_WATER_HIT, "lfff", iBallOwner, vTemp.x, fTmpY, vTemp.z);
     }
 
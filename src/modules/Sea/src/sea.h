@@ -4,6 +4,7 @@
 #pragma once
 
 #include "sea_base.h"
+#include "sea_waves.h"
 #include "c_vector4.h"
 #include "dx9render.h"
 #include "vma.hpp"
@@ -151,7 +152,11 @@ class SEA final : public SEA_BASE
     CMatrix mTexProjection;
 
     void SSE_WaveXZ(SeaVertex **pArray);
+    // the wave state of the current frame
+    SeaWaves Waves() const;
     float WaveXZ(float x, float z, CVECTOR *pNormal = nullptr) override;
+    void WaveXZBatch(const float *xs, const float *zs, float *ys, CVECTOR *normals, size_t n) override;
+    float TraceWave(const CVECTOR &vSrc, const CVECTOR &vDst, float &fHitWaveY);
 
     void AddBlock(int32_t iTX, int32_t iTY, int32_t iSize, int32_t iLOD);
     void BuildTree(int32_t iTX, int32_t iTY, int32_t iLev);
@@ -0,0 +1,232 @@
+#include "sea_waves.h"
+
+#include "math3d.h"
+#include "math_inlines.h"
+#include "sse.h"
+
+#include <cmath>
+
+using storm::Sqr;
+
+void SeaWaves::WaveXZ4(const float *xs, const float *zs, float *ys, CVECTOR *pNormals) const
+{
+    const __m128 m128X = _mm_loadu_ps(xs);
+    const __m128 m128Z = _mm_loadu_ps(zs);
+    const __m128i m128Mask = _mm_set1_epi32(WIDTH - 1);
+    const __m128i m128One = _mm_set1_epi32(1);
+
+    __m128 m128Height = _mm_setzero_ps();
+    __m128 m128NX[2], m128NZ[2];
+
+    for (int32_t f = 0; f < 2; f++)
+    {
+        __m128i m128IX, m128IZ;
+        const __m128 m128FX =
+            SSE_FloorFrac(_mm_mul_ps(_mm_add_ps(m128X, _mm_set1_ps(vMove[f].x)), _mm_set1_ps(fScale[f])), &m128IX);
+        const __m128 m128FZ =
+            SSE_FloorFrac(_mm_mul_ps(_mm_add_ps(m128Z, _mm_set1_ps(vMove[f].z)), _mm_set1_ps(fScale[f])), &m128IZ);
+
+        // cell corners of the 4 points: x + z * WIDTH, [corner][point]
+        const __m128i m128X1 = _mm_and_si128(m128IX, m128Mask);
+        const __m128i m128X2 = _mm_and_si128(_mm_add_epi32(m128IX, m128One), m128Mask);
+        const __m128i m128Z1 = _mm_slli_epi32(_mm_and_si128(m128IZ, m128Mask), WIDTH_SHIFT);
+        const __m128i m128Z2 = _mm_slli_epi32(_mm_and_si128(_mm_add_epi32(m128IZ, m128One), m128Mask), WIDTH_SHIFT);
+        alignas(16) int32_t iCorners[4][4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(iCorners[0]), _mm_add_epi32(m128X1, m128Z1));
+        _mm_store_si128(reinterpret_cast<__m128i *>(iCorners[1]), _mm_add_epi32(m128X2, m128Z1));
+        _mm_store_si128(reinterpret_cast<__m128i *>(iCorners[2]), _mm_add_epi32(m128X1, m128Z2));
+        _mm_store_si128(reinterpret_cast<__m128i *>(iCorners[3]), _mm_add_epi32(m128X2, m128Z2));
+
+        const float *pH = pHeights[f];
+        __m128 a[4];
+        for (int32_t c = 0; c < 4; c++)
+        {
+            const int32_t *i = iCorners[c];
+            a[c] = _mm_setr_ps(pH[i[0]], pH[i[1]], pH[i[2]], pH[i[3]]);
+        }
+        m128Height =
+            _mm_add_ps(m128Height, _mm_mul_ps(_mm_set1_ps(fAmp[f]), SSE_Bilerp(a[0], a[1], a[2], a[3], m128FX, m128FZ)));
+
+        if (pNormals)
+        {
+            // a normal is an (x, z) pair, the pairs of points 0, 1 and 2, 3 are loaded together and split
+            const float *pN = pNormalFrames[f];
+            __m128 nx[4], nz[4];
+            for (int32_t c = 0; c < 4; c++)
+            {
+                const int32_t *i = iCorners[c];
+                const auto *pPairs = reinterpret_cast<const __m64 *>(pN);
+                const __m128 m128N01 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), pPairs + i[0]), pPairs + i[1]);
+                const __m128 m128N23 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), pPairs + i[2]), pPairs + i[3]);
+                nx[c] = _mm_shuffle_ps(m128N01, m128N23, _MM_SHUFFLE(2, 0, 2, 0));
+                nz[c] = _mm_shuffle_ps(m128N01, m128N23, _MM_SHUFFLE(3, 1, 3, 1));
+            }
+            m128NX[f] = SSE_Bilerp(nx[0], nx[1], nx[2], nx[3], m128FX, m128FZ);
+            m128NZ[f] = SSE_Bilerp(nz[0], nz[1], nz[2], nz[3], m128FX, m128FZ);
+        }
+    }
+
+    // points beyond the sea distance are flat, like in WaveXZ
+    const __m128 m128DX = _mm_sub_ps(m128X, _mm_set1_ps(vCamPos.x));
+    const __m128 m128DZ = _mm_sub_ps(m128Z, _mm_set1_ps(vCamPos.z));
+    const __m128 m128Far = _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(m128DX, m128DX), _mm_mul_ps(m128DZ, m128DZ)),
+                                        _mm_set1_ps(fMaxDistance * fMaxDistance));
+
+    m128Height = _mm_add_ps(m128Height, _mm_set1_ps(fHeightOffset));
+    _mm_storeu_ps(ys, _mm_andnot_ps(m128Far, m128Height));
+
+    if (pNormals)
+    {
+        const __m128 m128One4 = _mm_set1_ps(1.0f);
+        const __m128 m128Y1 = _mm_sqrt_ps(_mm_sub_ps(
+            m128One4, _mm_add_ps(_mm_mul_ps(m128NX[0], m128NX[0]), _mm_mul_ps(m128NZ[0], m128NZ[0]))));
+        const __m128 m128Y2 = _mm_sqrt_ps(_mm_sub_ps(
+            m128One4, _mm_add_ps(_mm_mul_ps(m128NX[1], m128NX[1]), _mm_mul_ps(m128NZ[1], m128NZ[1]))));
+
+        const __m128 m128K1 = _mm_set1_ps(fScale[0] * fAmp[0]);
+        const __m128 m128K2 = _mm_set1_ps(fScale[1] * fAmp[1]);
+        __m128 m128NormX = _mm_add_ps(_mm_mul_ps(m128K1, m128NX[0]), _mm_mul_ps(m128K2, m128NX[1]));
+        __m128 m128NormZ = _mm_add_ps(_mm_mul_ps(m128K1, m128NZ[0]), _mm_mul_ps(m128K2, m128NZ[1]));
+        __m128 m128NormY = _mm_add_ps(m128Y1, m128Y2);
+
+        // exact normalise, callers use these for physics
+        const __m128 m128Len = _mm_sqrt_ps(_mm_add_ps(
+            _mm_add_ps(_mm_mul_ps(m128NormX, m128NormX), _mm_mul_ps(m128NormY, m128NormY)),
+            _mm_mul_ps(m128NormZ, m128NormZ)));
+        m128NormX = _mm_andnot_ps(m128Far, _mm_div_ps(m128NormX, m128Len));
+        m128NormZ = _mm_andnot_ps(m128Far, _mm_div_ps(m128NormZ, m128Len));
+        m128NormY = _mm_or_ps(_mm_and_ps(m128Far, m128One4), _mm_andnot_ps(m128Far, _mm_div_ps(m128NormY, m128Len)));
+
+        alignas(16) float nX[4], nY[4], nZ[4];
+        _mm_store_ps(nX, m128NormX);
+        _mm_store_ps(nY, m128NormY);
+        _mm_store_ps(nZ, m128NormZ);
+        for (int32_t i = 0; i < 4; i++)
+            pNormals[i] = CVECTOR(nX[i], nY[i], nZ[i]);
+    }
+}
+
+void SeaWaves::WaveXZBatch(const float *xs, const float *zs, float *ys, CVECTOR *normals, size_t n) const
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+        WaveXZ4(xs + i, zs + i, ys + i, normals ? normals + i : nullptr);
+    for (; i < n; i++)
+        ys[i] = WaveXZ(xs[i], zs[i], normals ? &normals[i] : nullptr);
+}
+
+float SeaWaves::WaveXZ(float x, float z, CVECTOR *pNormal) const
+{
+    int32_t iX11, iX12, iX21, iX22, iY11, iY12, iY21, iY22;
+
+    const float fDistance = Sqr(x - vCamPos.x) + Sqr(z - vCamPos.z);
+    if (fDistance > fMaxDistance * fMaxDistance)
+    {
+        if (pNormal)
+            *pNormal = CVECTOR(0.0f, 1.0f, 0.0f);
+        return 0.0f;
+    }
+
+    const float x1 = (x + vMove[0].x) * fScale[0];
+    const float z1 = (z + vMove[0].z) * fScale[0];
+    iX11 = ffloor(x1 + 0.0f), iX12 = iX11 + 1;
+    iY11 = ffloor(z1 + 0.0f), iY12 = iY11 + 1;
+    const float fX1 = (x1 - iX11);
+    const float fZ1 = (z1 - iY11);
+    iX11 &= (WIDTH - 1);
+    iX12 &= (WIDTH - 1);
+    iY11 &= (WIDTH - 1);
+    iY12 &= (WIDTH - 1);
+
+    const float x2 = (x + vMove[1].x) * fScale[1];
+    const float z2 = (z + vMove[1].z) * fScale[1];
+    iX21 = ffloor(x2 + 0.0f), iX22 = iX21 + 1;
+    iY21 = ffloor(z2 + 0.0f), iY22 = iY21 + 1;
+    const float fX2 = (x2 - iX21);
+    const float fZ2 = (z2 - iY21);
+    iX21 &= (WIDTH - 1);
+    iX22 &= (WIDTH - 1);
+    iY21 &= (WIDTH - 1);
+    iY22 &= (WIDTH - 1);
+
+    float a1, a2, a3, a4;
+
+    a1 = pHeights[0][iX11 + iY11 * WIDTH];
+    a2 = pHeights[0][iX12 + iY11 * WIDTH];
+    a3 = pHeights[0][iX11 + iY12 * WIDTH];
+    a4 = pHeights[0][iX12 + iY12 * WIDTH];
+    float fRes = fAmp[0] * (a1 + fX1 * (a2 - a1) + fZ1 * (a3 - a1) + fX1 * fZ1 * (a4 + a1 - a2 - a3));
+
+    a1 = pHeights[1][iX21 + iY21 * WIDTH];
+    a2 = pHeights[1][iX22 + iY21 * WIDTH];
+    a3 = pHeights[1][iX21 + iY22 * WIDTH];
+    a4 = pHeights[1][iX22 + iY22 * WIDTH];
+    fRes += fAmp[1] * (a1 + fX2 * (a2 - a1) + fZ2 * (a3 - a1) + fX2 * fZ2 * (a4 + a1 - a2 - a3));
+
+    float nx1, nx2, nx3, nx4, nz1, nz2, nz3, nz4;
+
+    nx1 = pNormalFrames[0][2 * (iX11 + iY11 * WIDTH) + 0];
+    nz1 = pNormalFrames[0][2 * (iX11 + iY11 * WIDTH) + 1];
+    nx2 = pNormalFrames[0][2 * (iX12 + iY11 * WIDTH) + 0];
+    nz2 = pNormalFrames[0][2 * (iX12 + iY11 * WIDTH) + 1];
+    nx3 = pNormalFrames[0][2 * (iX11 + iY12 * WIDTH) + 0];
+    nz3 = pNormalFrames[0][2 * (iX11 + iY12 * WIDTH) + 1];
+    nx4 = pNormalFrames[0][2 * (iX12 + iY12 * WIDTH) + 0];
+    nz4 = pNormalFrames[0][2 * (iX12 + iY12 * WIDTH) + 1];
+
+    const float nX1 = (nx1 + fX1 * (nx2 - nx1) + fZ1 * (nx3 - nx1) + fX1 * fZ1 * (nx4 + nx1 - nx2 - nx3));
+    const float nZ1 = (nz1 + fX1 * (nz2 - nz1) + fZ1 * (nz3 - nz1) + fX1 * fZ1 * (nz4 + nz1 - nz2 - nz3));
+
+    nx1 = pNormalFrames[1][2 * (iX21 + iY21 * WIDTH) + 0];
+    nz1 = pNormalFrames[1][2 * (iX21 + iY21 * WIDTH) + 1];
+    nx2 = pNormalFrames[1][2 * (iX22 + iY21 * WIDTH) + 0];
+    nz2 = pNormalFrames[1][2 * (iX22 + iY21 * WIDTH) + 1];
+    nx3 = pNormalFrames[1][2 * (iX21 + iY22 * WIDTH) + 0];
+    nz3 = pNormalFrames[1][2 * (iX21 + iY22 * WIDTH) + 1];
+    nx4 = pNormalFrames[1][2 * (iX22 + iY22 * WIDTH) + 0];
+    nz4 = pNormalFrames[1][2 * (iX22 + iY22 * WIDTH) + 1];
+
+    const float nX2 = (nx1 + fX2 * (nx2 - nx1) + fZ2 * (nx3 - nx1) + fX2 * fZ2 * (nx4 + nx1 - nx2 - nx3));
+    const float nZ2 = (nz1 + fX2 * (nz2 - nz1) + fZ2 * (nz3 - nz1) + fX2 * fZ2 * (nz4 + nz1 - nz2 - nz3));
+    // float nX2 = 0.0f;
+    // float nZ2 = 0.0f;
+
+    /*float fDistance = sqrt_ss(Sqr(x - vCamPos.x) + Sqr(fRes - vCamPos.y) + Sqr(z - vCamPos.z));
+    {
+      float distance_mul = 1.0f - fDistance / 1900.0f;
+      if (distance_mul < 0.0f) distance_mul = 0.0f;
+
+      fRes *= distance_mul;
+
+      nX1 *= distance_mul;
+      nZ1 *= distance_mul;
+
+      nX2 *= distance_mul;
+      nZ2 *= distance_mul;
+    }*/
+
+    if (pNormal)
+    {
+        /*pNormal->x = 0.0f;
+        pNormal->y = 1.0f;
+        pNormal->z = 0.0f;*/
+        const float nY1 = sqrtf(1.0f - (Sqr(nX1) + Sqr(nZ1)));
+        const float nY2 = sqrtf(1.0f - (Sqr(nX2) + Sqr(nZ2)));
+
+        CVECTOR vNormal;
+
+        vNormal.x = fScale[0] * fAmp[0] * nX1 + fScale[1] * fAmp[1] * nX2;
+        vNormal.z = fScale[0] * fAmp[0] * nZ1 + fScale[1] * fAmp[1] * nZ2;
+        vNormal.y = nY1 + nY2;
+
+        // vNormal.x += 2.0f * vNormal.x;
+        // vNormal.z += 2.0f * vNormal.z;
+        vNormal = !vNormal;
+
+        *pNormal = vNormal;
+    }
+
+    fRes += fHeightOffset;
+
+    return fRes;
+}
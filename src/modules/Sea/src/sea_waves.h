@@ -0,0 +1,32 @@
+#pragma once
+
+#include "c_vector.h"
+
+#include <cstddef>
+#include <cstdint>
+
+// Heights and normals of the sea surface: two animated frames of the wave height field, tiled and summed.
+// SEA fills it from its current frames, the arrays stay owned by SEA
+struct SeaWaves
+{
+    // side of the tiled height and normal frames
+    static constexpr int32_t WIDTH_SHIFT = 7;
+    static constexpr int32_t WIDTH = 1 << WIDTH_SHIFT;
+
+    const float *pHeights[2];      // WIDTH * WIDTH heights
+    const float *pNormalFrames[2]; // WIDTH * WIDTH normals as (x, z) pairs
+    CVECTOR vMove[2];
+    float fScale[2];
+    float fAmp[2];
+
+    // points farther than fMaxDistance from the camera are flat
+    CVECTOR vCamPos;
+    float fMaxDistance;
+    float fHeightOffset;
+
+    float WaveXZ(float x, float z, CVECTOR *pNormal = nullptr) const;
+    // WaveXZ of 4 points at once, the same results: coordinates and interpolation in SSE, only the table reads are scalar
+    void WaveXZ4(const float *xs, const float *zs, float *ys, CVECTOR *pNormals) const;
+    // WaveXZ of n points, normals may be nullptr
+    void WaveXZBatch(const float *xs, const float *zs, float *ys, CVECTOR *normals, size_t n) const;
+};
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <emmintrin.h>
+
 // INTEL COMMENT:
 // This function simply gathers 4 floats and places them on a __m128 variable.
 static inline void SSE_GatherFourFloats(float *pf0, float *pf1, float *pf2, float *pf3, __m128 *pm128Result)
@@ -48,6 +50,24 @@ static inline void SSE_Normalise(__m128 m128X, __m128 m128Y, __m128 m128Z, __m12
     *pm128Z = _mm_mul_ps(m128Z, xmm0); // RecipLength * Z
 }
 
+// Floor of 4 floats the same way ffloor() does it, returns the fractional parts.
+static inline __m128 SSE_FloorFrac(__m128 m128Value, __m128i *pm128Floor)
+{
+    *pm128Floor = _mm_cvtps_epi32(_mm_sub_ps(m128Value, _mm_set1_ps(0.5f)));
+    return _mm_sub_ps(m128Value, _mm_cvtepi32_ps(*pm128Floor));
+}
+
+// Bilinear blend of 4 cell corners for 4 samples at once:
+// a1 + fx * (a2 - a1) + fz * (a3 - a1) + fx * fz * (a4 + a1 - a2 - a3)
+static inline __m128 SSE_Bilerp(__m128 a1, __m128 a2, __m128 a3, __m128 a4, __m128 fx, __m128 fz)
+{
+    const __m128 dx = _mm_sub_ps(a2, a1);
+    const __m128 dz = _mm_sub_ps(a3, a1);
+    const __m128 dxz = _mm_sub_ps(_mm_add_ps(a4, a1), _mm_add_ps(a2, a3));
+    return _mm_add_ps(_mm_add_ps(a1, _mm_mul_ps(fx, dx)),
+                      _mm_add_ps(_mm_mul_ps(fz, dz), _mm_mul_ps(_mm_mul_ps(fx, fz), dxz)));
+}
+
 static inline void GatherFourFloats(float *pf0, float *pf1, float *pf2, float *pf3, __m128 *pm128Result)
 {
     __m128 xmm0 = _mm_load_ss(pf0); // 0 0 0 pf0
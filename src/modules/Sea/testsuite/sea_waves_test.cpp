@@ -0,0 +1,135 @@
+#include "sea_waves.h"
+
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+// two frames of random heights and of normals tilted by up to 0.5, as the sea loads them
+struct Frames
+{
+    std::vector<float> heights[2];
+    std::vector<float> normals[2];
+
+    explicit Frames(uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> height(-1.0f, 1.0f);
+        std::uniform_real_distribution<float> tilt(-0.5f, 0.5f);
+        for (int32_t f = 0; f < 2; f++)
+        {
+            heights[f].resize(SeaWaves::WIDTH * SeaWaves::WIDTH);
+            normals[f].resize(SeaWaves::WIDTH * SeaWaves::WIDTH * 2);
+            std::ranges::generate(heights[f], [&] { return height(rng); });
+            std::ranges::generate(normals[f], [&] { return tilt(rng); });
+        }
+    }
+
+    SeaWaves Waves() const
+    {
+        return SeaWaves{{heights[0].data(), heights[1].data()},
+                        {normals[0].data(), normals[1].data()},
+                        {CVECTOR(13.7f, 0.0f, -4.2f), CVECTOR(-51.3f, 0.0f, 27.9f)},
+                        {0.05f, 0.21f},
+                        {3.5f, 0.8f},
+                        CVECTOR(120.0f, 10.0f, -80.0f),
+                        600.0f,
+                        0.25f};
+    }
+};
+
+// points around the camera, some of them past the sea distance
+void MakePoints(size_t n, uint32_t seed, std::vector<float> &xs, std::vector<float> &zs)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> pos(-800.0f, 800.0f);
+    xs.resize(n);
+    zs.resize(n);
+    std::ranges::generate(xs, [&] { return 120.0f + pos(rng); });
+    std::ranges::generate(zs, [&] { return -80.0f + pos(rng); });
+}
+} // namespace
+
+TEST_CASE("Batched waves match the single point query", "[sea_waves]")
+{
+    const Frames frames(1);
+    const auto waves = frames.Waves();
+    std::vector<float> xs, zs;
+    for (const size_t n : {size_t{0}, size_t{1}, size_t{3}, size_t{4}, size_t{7}, size_t{1001}})
+    {
+        MakePoints(n, static_cast<uint32_t>(n) + 2, xs, zs);
+        std::vector<float> ys(n), ysNoNormals(n);
+        std::vector<CVECTOR> normals(n);
+        waves.WaveXZBatch(xs.data(), zs.data(), ys.data(), normals.data(), n);
+        waves.WaveXZBatch(xs.data(), zs.data(), ysNoNormals.data(), nullptr, n);
+        for (size_t i = 0; i < n; i++)
+        {
+            CVECTOR normal;
+            const float y = waves.WaveXZ(xs[i], zs[i], &normal);
+            INFO(n << " points, point " << i << " at " << xs[i] << ", " << zs[i]);
+            CHECK(std::fabs(ys[i] - y) <= 1e-4f);
+            CHECK(ysNoNormals[i] == ys[i]);
+            CHECK(std::fabs(normals[i].x - normal.x) <= 1e-5f);
+            CHECK(std::fabs(normals[i].y - normal.y) <= 1e-5f);
+            CHECK(std::fabs(normals[i].z - normal.z) <= 1e-5f);
+        }
+    }
+}
+
+TEST_CASE("Waves are flat past the sea distance", "[sea_waves]")
+{
+    const Frames frames(2);
+    const auto waves = frames.Waves();
+    const float xs[4] = {120.0f + 601.0f, 120.0f, -900.0f, 120.0f};
+    const float zs[4] = {-80.0f, -80.0f - 700.0f, 500.0f, -80.0f};
+    float ys[4];
+    CVECTOR normals[4];
+    waves.WaveXZBatch(xs, zs, ys, normals, 3);
+    for (int32_t i = 0; i < 3; i++)
+    {
+        CHECK(ys[i] == 0.0f);
+        CHECK(normals[i].y == 1.0f);
+    }
+}
+
+TEST_CASE("Batched waves against the single point query", "[sea_waves][benchmark]")
+{
+    // the hull points a few ships query each frame
+    constexpr size_t kPoints = 4096;
+    const Frames frames(3);
+    const auto waves = frames.Waves();
+    std::vector<float> xs, zs, ys(kPoints);
+    std::vector<CVECTOR> normals(kPoints);
+    MakePoints(kPoints, 4, xs, zs);
+
+    BENCHMARK("WaveXZ loop")
+    {
+        for (size_t i = 0; i < kPoints; i++)
+            ys[i] = waves.WaveXZ(xs[i], zs[i], &normals[i]);
+        return ys.front();
+    };
+
+    BENCHMARK("WaveXZBatch")
+    {
+        waves.WaveXZBatch(xs.data(), zs.data(), ys.data(), normals.data(), kPoints);
+        return ys.front();
+    };
+
+    BENCHMARK("WaveXZ loop, heights only")
+    {
+        for (size_t i = 0; i < kPoints; i++)
+            ys[i] = waves.WaveXZ(xs[i], zs[i]);
+        return ys.front();
+    };
+
+    BENCHMARK("WaveXZBatch, heights only")
+    {
+        waves.WaveXZBatch(xs.data(), zs.data(), ys.data(), nullptr, kPoints);
+        return ys.front();
+    };
+}
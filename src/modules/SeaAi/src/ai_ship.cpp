@@ -83,7 +83,7 @@ void AIShip::Execute(float fDeltaTime)
 {
     uint32_t i;
 
-    auto *pAAIInit = GetACharacter()->FindAClass(GetACharacter(), "Ship.SeaAI.Init");
+    auto *pAAIInit = pathSeaAIInit.Find(GetACharacter());
 
     fAbordageDistance = (pAAIInit) ? pAAIInit->GetAttributeAsFloat("AbordageDistance", 30.0f) : 30.0f;
     fFollowDistance = (pAAIInit) ? pAAIInit->GetAttributeAsFloat("FollowDistance", 200.0f) : 200.0f;
@@ -126,13 +126,13 @@ void AIShip::Execute(float fDeltaTime)
     auto *pShip = static_cast<SHIP_BASE *>(GetShipPointer());
     Assert(pShip);
 
-    auto *pASeaAIU = GetACharacter()->FindAClass(GetACharacter(), "SeaAI.Update");
+    auto *pASeaAIU = pathSeaAIUpdate.Find(GetACharacter());
     if (pASeaAIU)
         GetACharacter()->DeleteAttributeClassX(pASeaAIU);
 
     if (dtUpdateSeaAIAttributes.Update(fDeltaTime) && !isMainCharacter())
     {
-        auto *pASeaAIU = GetACharacter()->CreateSubAClass(GetACharacter(), "SeaAI.Update");
+        auto *pASeaAIU = pathSeaAIUpdate.Create(GetACharacter());
         auto *const pAShips = pASeaAIU->CreateAttribute("Ships", "");
         for (i = 0; i < AIShips.size(); i++)
             if (this != AIShips[i] && !AIShips[i]->isDead())
@@ -147,7 +147,7 @@ void AIShip::Execute(float fDeltaTime)
         // delete old state
 
         // create new state
-        pASeaAIU = GetACharacter()->CreateSubAClass(GetACharacter(), "SeaAI.Update");
+        pASeaAIU = pathSeaAIUpdate.Create(GetACharacter());
 
         RDTSC_B(dw7);
         // fill state for ships
@@ -201,11 +201,7 @@ void AIShip::CheckSituation()
             }
         }
 
-    auto *pACSituation = GetACharacter()->FindAClass(GetACharacter(), "SeaAI.Update.Situation");
-    if (!pACSituation)
-    {
-        pACSituation = GetACharacter()->CreateSubAClass(GetACharacter(), "SeaAI.Update.Situation");
-    }
+    auto *pACSituation = pathSituation.Create(GetACharacter());
     Assert(pACSituation);
 
     pACSituation->SetAttributeUseFloat("MinEnemyDistance", fMinEnemyDist);
@@ -523,14 +519,14 @@ void AIShip::GetPrediction(float fTime, CVECTOR *vPos, CVECTOR *vAng)
 
 float AIShip::GetShipHP() const
 {
-    auto *pAHP = GetACharacter()->FindAClass(GetACharacter(), "Ship.HP");
+    auto *pAHP = pathShipHP.Find(GetACharacter());
     Assert(pAHP);
     return pAHP->GetAttributeAsFloat();
 }
 
 float AIShip::GetShipBaseHP() const
 {
-    return GetAShip()->GetAttributeAsFloat("HP");
+    return GetAShip()->GetAttributeAsFloat(pathBaseHP);
 }
 
 bool AIShip::isAttack(ATTRIBUTES *pAOtherCharacter) const
@@ -566,7 +562,7 @@ float AIShip::GetPower() const
     Assert(GetAShip());
     if (isDead())
         return 0.0f;
-    const auto fHP = GetAShip()->GetAttributeAsFloat("HP");
+    const auto fHP = GetAShip()->GetAttributeAsFloat(pathBaseHP);
     const auto dwCannonsNum = GetCannonController()->GetCannonsNum();
     return fHP + dwCannonsNum * 100.0f;
 };
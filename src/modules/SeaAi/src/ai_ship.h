@@ -211,6 +211,13 @@ class AIShip : public VAI_INNEROBJ
 
     float fAbordageDistance, fFollowDistance, fAttackDistance;
 
+    // attribute paths resolved every frame, relative to the character unless noted
+    AttributePath pathSeaAIInit{"Ship.SeaAI.Init"};
+    AttributePath pathSeaAIUpdate{"SeaAI.Update"};
+    AttributePath pathSituation{"SeaAI.Update.Situation"};
+    AttributePath pathShipHP{"Ship.HP"};
+    AttributePath pathBaseHP{"HP"}; // relative to the ship attributes
+
     static std::vector<can_fire_t> aShipFire;
     std::vector<AI_POINT> aFollowPoints, aAttackPoints;
 
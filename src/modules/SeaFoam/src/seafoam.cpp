@@ -17,6 +17,7 @@ SEAFOAM::SEAFOAM()
     : seaID(0), sea(nullptr), shipsCount(0), carcassTexture(0), isStorm(false), soundService(nullptr)
 {
     renderer = nullptr;
+    foamTechnique = -1;
 }
 
 //--------------------------------------------------------------------
@@ -47,6 +48,7 @@ bool SEAFOAM::Init()
     }
 
     renderer = static_cast<VDX9RENDER *>(core.GetService("dx9render"));
+    foamTechnique = renderer->TechniqueGetHandle("new_seafoam");
     soundService = static_cast<VSoundService *>(core.GetService("SoundService"));
 
     InitializeShipFoam();
@@ -506,7 +508,7 @@ void SEAFOAM::Realize(uint32_t _dTime)
     renderer->SetTransform(D3DTS_WORLD, static_cast<D3DMATRIX *>(wMatrix));
 
     renderer->TextureSet(0, carcassTexture);
-    const auto techniqueStarted = renderer->TechniqueExecuteStart("new_seafoam");
+    const auto techniqueStarted = renderer->TechniqueExecuteStart(foamTechnique);
     for (ship = 0; ship < shipsCount; ship++)
     {
         foamInfo = &shipFoamInfo[ship];
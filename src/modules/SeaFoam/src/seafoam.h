@@ -76,6 +76,7 @@ class SEAFOAM : public Entity
     void AddShip(entid_t pShipEID);
 
     VDX9RENDER *renderer;
+    int32_t foamTechnique;
     entid_t seaID;
     SEA_BASE *sea;
     tShipFoamInfo shipFoamInfo[MAX_SHIPS]{};
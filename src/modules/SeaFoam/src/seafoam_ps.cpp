@@ -22,6 +22,7 @@ SEAFOAM_PS::SEAFOAM_PS() : enableEmit(true)
     bLinkEmitter = false;
 
     RenderService = nullptr;
+    Technique = -1;
     ParticlesNum = 0;
     TexturesNum = 0;
     Particle = nullptr;
@@ -180,6 +181,7 @@ bool SEAFOAM_PS::Init(const std::string_view& section)
     }
 
     TechniqueName = config.Get<std::string>(PSKEY_TECHNIQUE, {});
+    Technique = RenderService->TechniqueGetHandle(TechniqueName.c_str());
 
     // configure particles
     ParticlesNum = config.Get<std::int64_t>(PSKEY_PNUM, 32);
@@ -483,7 +485,7 @@ void SEAFOAM_PS::Realize(uint32_t DeltaTime)
     // if(bColorInverse)bDraw = RenderService->TechniqueExecuteStart("particles_inv");
     // else bDraw = RenderService->TechniqueExecuteStart("particles");
 
-    bDraw = RenderService->TechniqueExecuteStart(TechniqueName.c_str());
+    bDraw = RenderService->TechniqueExecuteStart(Technique);
     if (bDraw)
     {
         RenderService->DrawPrimitive(D3DPT_TRIANGLELIST, 0, 2 * ParticlesNum);
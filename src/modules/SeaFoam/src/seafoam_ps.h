@@ -159,6 +159,7 @@ class SEAFOAM_PS : VPARTICLE_SYSTEM
     void UseSurface(entid_t surface_id);
     float fSurfaceOffset;
     std::string TechniqueName;
+    int32_t Technique;
     uint32_t ParticleColor;
 
     //---------------------------------
@@ -27,6 +27,8 @@ Shadow::Shadow()
 {
     shading = 1.0f;
     blendValue = 0xFFFFFFFF;
+    techDraw = -1;
+    techSmooth = -1;
 }
 
 Shadow::~Shadow()
@@ -53,6 +55,8 @@ bool Shadow::Init()
     rs = static_cast<VDX9RENDER *>(core.GetService("dx9render"));
     if (!rs)
         throw std::runtime_error("No service: dx9render");
+    techDraw = rs->TechniqueGetHandle("shadow_draw");
+    techSmooth = rs->TechniqueGetHandle("shadow_smooth");
 
     if (refcount == 0)
     {
@@ -354,7 +358,7 @@ void Shadow::Realize(uint32_t Delta_Time)
 
     rs->VBUnlock(vbuff);
 
-    if (tot_verts >= 3 && rs->TechniqueExecuteStart("shadow_draw"))
+    if (tot_verts >= 3 && rs->TechniqueExecuteStart(techDraw))
         do
         {
             rs->DrawPrimitive(D3DPT_TRIANGLELIST, 0, tot_verts / 3);
@@ -475,7 +479,7 @@ void Shadow::Smooth()
 
     rs->SetTexture(0, shTex);
 
-    if (rs->TechniqueExecuteStart("shadow_smooth"))
+    if (rs->TechniqueExecuteStart(techSmooth))
         do
         {
             static const int32_t nIterations = 3;
@@ -8,6 +8,8 @@
 class Shadow : public Entity
 {
     VDX9RENDER *rs;
+    int32_t techDraw;
+    int32_t techSmooth;
     COLLIDE *col;
     void FindPlanes(const CMatrix &view, const CMatrix &proj);
     PLANE planes[6];
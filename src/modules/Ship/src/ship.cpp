@@ -179,51 +179,44 @@ void SHIP::LoadServices()
 
 CVECTOR SHIP::ShipRocking(float fDeltaTime)
 {
-    CMatrix mat;
-    mat = *GetMatrix();
-
     fDeltaTime = Min(fDeltaTime, 0.1f);
     auto fDelta = (fDeltaTime / 0.025f);
 
     if (!pSea)
         return vAng;
-    // core.Send_Message(model,"ll",2,(int32_t)&mat);
 
     auto vAng2 = State.vAng;
 
-    CVECTOR point, fang;
-    fang.x = 0.0f;
-    fang.y = 0.0f;
-    fang.z = 0.0f;
-    auto fFullY = 0.0f, fup = 0.0f;
+    auto fFullY = 0.0f;
 
     int32_t ix, iz;
 
     auto fCos = cosf(State.vAng.y);
     auto fSin = sinf(State.vAng.y);
 
+    // sample the 6x6 grid in one batch
+    float xs[6 * 6], zs[6 * 6], ys[6 * 6];
     for (ix = 0; ix < 6; ix++)
     {
         auto x = (static_cast<float>(ix) * State.vBoxSize.x * 0.2f - 0.5f * State.vBoxSize.x);
         for (iz = 0; iz < 6; iz++)
         {
-            auto *pspt = &ShipPoints[ix][iz];
             auto z = (static_cast<float>(iz) * State.vBoxSize.z * 0.2f - 0.5f * State.vBoxSize.z);
 
             auto xx = x, zz = z;
             RotateAroundY(xx, zz, fCos, fSin);
-            point.x = xx + State.vPos.x + fXOffset;
-            point.y = mat.m[0][1] * x + mat.m[2][1] * z + State.vPos.y;
-            point.z = zz + State.vPos.z + fZOffset;
-
-            auto wave_y = pSea->WaveXZ(point.x, point.z);
-            auto f = (wave_y - point.y);
-
-            pspt->fY = wave_y;
-
-            fFullY += pspt->fY;
+            xs[ix * 6 + iz] = xx + State.vPos.x + fXOffset;
+            zs[ix * 6 + iz] = zz + State.vPos.z + fZOffset;
         }
     }
+    pSea->WaveXZBatch(xs, zs, ys, nullptr, 6 * 6);
+
+    for (ix = 0; ix < 6; ix++)
+        for (iz = 0; iz < 6; iz++)
+        {
+            ShipPoints[ix][iz].fY = ys[ix * 6 + iz];
+            fFullY += ShipPoints[ix][iz].fY;
+        }
 
     auto fNewPos = fFullY / 36.0f;
     //(ShipPoints[2][2].fY + ShipPoints[3][2].fY + ShipPoints[2][3].fY + ShipPoints[3][3].fY) / 4.0f;
@@ -477,7 +470,7 @@ float SHIP::GetBrakingDistance(float *pfTime)
 // calculate ship immersion
 void SHIP::CalculateImmersion()
 {
-    auto *pAShipImmersion = GetACharacter()->FindAClass(GetACharacter(), "Ship.Immersion");
+    auto *pAShipImmersion = pathShipImmersion.Find(GetACharacter());
     State.fShipImmersion = (pAShipImmersion) ? pAShipImmersion->GetAttributeAsFloat() : 0.0f;
     // return State.fShipImmersion;
 }
@@ -548,9 +541,9 @@ void SHIP::SetDead()
 
 void SHIP::Execute(uint32_t DeltaTime)
 {
-    auto *pAPerks = GetACharacter()->FindAClass(GetACharacter(), "TmpPerks");
+    auto *pAPerks = pathTmpPerks.Find(GetACharacter());
 
-    auto *pARocking = GetAShip()->GetAttributeClass("Rocking");
+    auto *pARocking = pathRocking.Find(GetAShip());
 
     if (pARocking)
     {
@@ -582,7 +575,7 @@ void SHIP::Execute(uint32_t DeltaTime)
     }
 
     // temp
-    uniIDX = GetACharacter()->GetAttributeAsDword("index");
+    uniIDX = GetACharacter()->GetAttributeAsDword(pathIndex);
     if (uniIDX >= 900)
         uniIDX = uniIDX - 900 + 2;
 
@@ -591,8 +584,8 @@ void SHIP::Execute(uint32_t DeltaTime)
     if (!bMounted)
         return;
 
-    auto *pAShipStopped = GetACharacter()->FindAClass(GetACharacter(), "ship.stopped");
-    auto bMainCharacter = GetACharacter()->GetAttributeAsDword("MainCharacter", 0) != 0;
+    auto *pAShipStopped = pathShipStopped.Find(GetACharacter());
+    auto bMainCharacter = GetACharacter()->GetAttributeAsDword(pathMainCharacter, 0) != 0;
 
     if (dtUpdateParameters.Update(fDeltaTime))
     {
@@ -602,7 +595,7 @@ void SHIP::Execute(uint32_t DeltaTime)
         }
     }
     // check impulse
-    auto *pAImpulse = GetACharacter()->FindAClass(GetACharacter(), "Ship.Impulse");
+    auto *pAImpulse = pathShipImpulse.Find(GetACharacter());
     if (pAImpulse && !isDead())
     {
         CVECTOR vRotate = 0.0f, vXSpeed = 0.0f;
@@ -653,12 +646,8 @@ void SHIP::Execute(uint32_t DeltaTime)
         vAng.z += fRotate;
     }
 
-    auto *pASpeed = GetACharacter()->FindAClass(GetACharacter(), "ship.speed");
-    if (!pASpeed)
-    {
-        pASpeed = GetACharacter()->CreateSubAClass(GetACharacter(), "ship.speed");
-        Assert(pASpeed);
-    }
+    auto *pASpeed = pathShipSpeed.Create(GetACharacter());
+    Assert(pASpeed);
     pASpeed->SetAttributeUseFloat("x", State.vSpeed.x);
     pASpeed->SetAttributeUseFloat("y", State.vRotate.y);
     pASpeed->SetAttributeUseFloat("z", State.vSpeed.z);
@@ -754,18 +743,9 @@ void SHIP::Execute(uint32_t DeltaTime)
     }
 
     // set attributes for script
-    auto *pAPos = GetACharacter()->FindAClass(GetACharacter(), "ship.pos");
-    auto *pAAng = GetACharacter()->FindAClass(GetACharacter(), "ship.ang");
-    if (!pAPos)
-    {
-        pAPos = GetACharacter()->CreateSubAClass(GetACharacter(), "ship.pos");
-        Assert(pAPos);
-    }
-    if (!pAAng)
-    {
-        pAAng = GetACharacter()->CreateSubAClass(GetACharacter(), "ship.ang");
-        Assert(pAAng);
-    }
+    auto *pAPos = pathShipPos.Create(GetACharacter());
+    auto *pAAng = pathShipAng.Create(GetACharacter());
+    Assert(pAPos && pAAng);
     pAPos->SetAttributeUseFloat("x", State.vPos.x + fXOffset);
     pAPos->SetAttributeUseFloat("y", State.vPos.y);
     pAPos->SetAttributeUseFloat("z", State.vPos.z + fZOffset);
@@ -787,43 +767,53 @@ void SHIP::Execute(uint32_t DeltaTime)
     // activate mast tracer
     if (dtMastTrace.Update(fDeltaTime))
     {
+        // trace all masts at once, a falling mast only touches this ship which is excluded from both layers
+        std::vector<mast_t *> masts;
+        std::vector<TRACE_RAY> rays;
         for (int32_t i = 0; i < iNumMasts; i++)
             if (!pMasts[i].bBroken)
             {
-                CVECTOR v1, v2;
-                VDATA *pV;
-                auto fShipRes = 2.0f, fIslRes = 2.0f;
+                masts.push_back(&pMasts[i]);
+                rays.push_back({matrix * pMasts[i].vSrc, matrix * pMasts[i].vDst});
+            }
 
-                auto *pM = &pMasts[i];
-                v1 = matrix * pM->vSrc;
-                v2 = matrix * pM->vDst;
+        std::vector<TRACE_HIT> shipHits(rays.size()), islandHits(rays.size());
+        auto id = GetId();
+        pCollide->TraceBatch(core.GetEntityIds(MAST_SHIP_TRACE), rays, shipHits, &id, 1);
+        id = GetModelEID();
+        pCollide->TraceBatch(core.GetEntityIds(MAST_ISLAND_TRACE), rays, islandHits, &id, 1);
 
-                auto id = GetId();
-                fShipRes = pCollide->Trace(core.GetEntityIds(MAST_SHIP_TRACE), v1, v2, &id, 1);
-                if (fShipRes <= 1.0f)
-                {
-                    auto *pACollideCharacter = GetACharacter();
-                    auto *pShip = static_cast<SHIP *>(core.GetEntityPointer(pCollide->GetObjectID()));
-                    if (pShip)
-                        pACollideCharacter = pShip->GetACharacter();
-                    pV = core.Event(SHIP_MAST_DAMAGE, "llffffaa", SHIP_MAST_TOUCH_SHIP, pM->iMastNum, v1.x, v1.y, v1.z,
-                                    pM->fDamage, GetACharacter(), pACollideCharacter);
-                    if (pV != nullptr) {
-                        pM->fDamage = Clamp(pV->GetFloat());
-                    }
-                }
+        for (size_t i = 0; i < masts.size(); i++)
+        {
+            VDATA *pV;
 
-                id = GetModelEID();
-                fIslRes = pCollide->Trace(core.GetEntityIds(MAST_ISLAND_TRACE), v1, v2, &id, 1);
-                if (fIslRes <= 1.0f)
-                {
-                    pV = core.Event(SHIP_MAST_DAMAGE, "llffffa", SHIP_MAST_TOUCH_ISLAND, pM->iMastNum, v1.x, v1.y, v1.z,
-                                    pM->fDamage, GetACharacter());
+            auto *pM = masts[i];
+            if (pM->bBroken)
+                continue;
+            const auto &v1 = rays[i].src;
+
+            if (shipHits[i].dist <= 1.0f)
+            {
+                auto *pACollideCharacter = GetACharacter();
+                auto *pShip = static_cast<SHIP *>(core.GetEntityPointer(shipHits[i].eid));
+                if (pShip)
+                    pACollideCharacter = pShip->GetACharacter();
+                pV = core.Event(SHIP_MAST_DAMAGE, "llffffaa", SHIP_MAST_TOUCH_SHIP, pM->iMastNum, v1.x, v1.y, v1.z,
+                                pM->fDamage, GetACharacter(), pACollideCharacter);
+                if (pV != nullptr) {
                     pM->fDamage = Clamp(pV->GetFloat());
                 }
+            }
 
-                MastFall(pM);
+            if (islandHits[i].dist <= 1.0f)
+            {
+                pV = core.Event(SHIP_MAST_DAMAGE, "llffffa", SHIP_MAST_TOUCH_ISLAND, pM->iMastNum, v1.x, v1.y, v1.z,
+                                pM->fDamage, GetACharacter());
+                pM->fDamage = Clamp(pV->GetFloat());
             }
+
+            MastFall(pM);
+        }
     }
 
     // key states
@@ -865,7 +855,7 @@ void SHIP::Execute(uint32_t DeltaTime)
         aFirePlaces[i].Execute(fDeltaTime);
 
     // water sound: set position and volume
-    auto *pASounds = AttributesPointer->FindAClass(AttributesPointer, "Ship.Sounds");
+    auto *pASounds = pathShipSounds.Find(AttributesPointer);
 
     if (pASounds)
     {
@@ -1025,6 +1015,8 @@ CMatrix SHIP::UpdateModelMatrix()
     auto *pModel = GetModel();
     Assert(pModel);
     pModel->Update();
+    // the bound sphere is the one of the model
+    BoundsChanged();
     return pModel->mtx;
 }
 
@@ -1117,6 +1109,7 @@ void SHIP::Realize(uint32_t dtime)
 
     pRS->SetRenderState(D3DRS_LIGHTING, true);
     pM->ProcessStage(Stage::realize, dtime);
+    BoundsChanged();
     pRS->SetRenderState(D3DRS_LIGHTING, false);
 
     UnSetLights();
@@ -1165,19 +1158,19 @@ void SHIP::Fire(const CVECTOR &vPos)
 
 float SHIP::GetMaxSpeedZ()
 {
-    auto *pAMaxSpeedZ = GetACharacter()->FindAClass(GetACharacter(), "Ship.MaxSpeedZ");
+    auto *pAMaxSpeedZ = pathShipMaxSpeedZ.Find(GetACharacter());
     return (pAMaxSpeedZ) ? pAMaxSpeedZ->GetAttributeAsFloat() : 0.0f;
 }
 
 float SHIP::GetMaxSpeedY()
 {
-    auto *pAMaxSpeedY = GetACharacter()->FindAClass(GetACharacter(), "Ship.MaxSpeedY");
+    auto *pAMaxSpeedY = pathShipMaxSpeedY.Find(GetACharacter());
     return (pAMaxSpeedY) ? pAMaxSpeedY->GetAttributeAsFloat() : 0.0f;
 }
 
 float SHIP::GetWindAgainst()
 {
-    auto *pAWindAgainst = GetACharacter()->FindAClass(GetACharacter(), "Ship.WindAgainstSpeed");
+    auto *pAWindAgainst = pathShipWindAgainst.Find(GetACharacter());
     return (pAWindAgainst) ? pAWindAgainst->GetAttributeAsFloat() : 0.0f;
 }
 
@@ -1772,6 +1765,25 @@ float SHIP::Trace(const CVECTOR &src, const CVECTOR &dst)
     return pModel->Trace(src, dst);
 };
 
+bool SHIP::IsTraceThreadSafe() const
+{
+    const MODEL *pModel = GetModel();
+    return pModel && pModel->IsTraceThreadSafe();
+}
+
+float SHIP::TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const
+{
+    const MODEL *pModel = GetModel();
+    Assert(pModel);
+    return pModel->TraceThreadSafe(src, dst);
+}
+
+bool SHIP::GetBoundSphere(CVECTOR &center, float &radius) const
+{
+    const MODEL *pModel = GetModel();
+    return pModel && pModel->GetBoundSphere(center, radius);
+}
+
 float SHIP::Cannon_Trace(int32_t iBallOwner, const CVECTOR &vSrc, const CVECTOR &vDst)
 {
     MODEL *pModel = GetModel();
@@ -133,6 +133,22 @@ class SHIP : public SHIP_BASE
 
     DTimer dtMastTrace, dtUpdateParameters;
 
+    // attribute paths resolved every frame, relative to the character unless noted
+    AttributePath pathTmpPerks{"TmpPerks"};
+    AttributePath pathRocking{"Rocking"}; // relative to the ship attributes
+    AttributePath pathIndex{"index"};
+    AttributePath pathMainCharacter{"MainCharacter"};
+    AttributePath pathShipStopped{"ship.stopped"};
+    AttributePath pathShipImpulse{"Ship.Impulse"};
+    AttributePath pathShipImmersion{"Ship.Immersion"};
+    AttributePath pathShipSpeed{"ship.speed"};
+    AttributePath pathShipPos{"ship.pos"};
+    AttributePath pathShipAng{"ship.ang"};
+    AttributePath pathShipSounds{"Ship.Sounds"}; // relative to the entity attributes
+    AttributePath pathShipMaxSpeedZ{"Ship.MaxSpeedZ"};
+    AttributePath pathShipMaxSpeedY{"Ship.MaxSpeedY"};
+    AttributePath pathShipWindAgainst{"Ship.WindAgainstSpeed"};
+
     // executed functions
     CVECTOR ShipRocking(float fDeltaTime);
     BOOL ApplyStrength(float dtime, BOOL bCollision);
@@ -211,6 +227,9 @@ class SHIP : public SHIP_BASE
 
     // inherit functions COLLISION_OBJECT
     float Trace(const CVECTOR &src, const CVECTOR &dst) override;
+    bool IsTraceThreadSafe() const override;
+    float TraceThreadSafe(const CVECTOR &src, const CVECTOR &dst) const override;
+    bool GetBoundSphere(CVECTOR &center, float &radius) const override;
 
     bool Clip(const PLANE *planes, int32_t nplanes, const CVECTOR &center, float radius,
               ADD_POLYGON_FUNC addpoly) override
@@ -6,6 +6,7 @@
 SEPS_PS::SEPS_PS()
 {
     TechniqueName = nullptr;
+    Technique = -1;
 
     ParticleColor = 0xffffffff;
 
@@ -257,6 +258,7 @@ bool SEPS_PS::Init(INIFILE *ini, char *psname)
     const auto len = strlen(string) + 1;
     TechniqueName = new char[strlen(string) + 1];
     memcpy(TechniqueName, string, len);
+    Technique = RenderService->TechniqueGetHandle(TechniqueName);
 
     // configure particles
     ParticlesNum = ini->GetInt(psname, PSKEY_PNUM, 32);
@@ -582,7 +584,7 @@ void SEPS_PS::Realize(uint32_t DeltaTime)
     // if(bColorInverse)bDraw = RenderService->TechniqueExecuteStart("particles_inv");
     // else bDraw = RenderService->TechniqueExecuteStart("particles");
 
-    bDraw = RenderService->TechniqueExecuteStart(TechniqueName);
+    bDraw = RenderService->TechniqueExecuteStart(Technique);
     if (bDraw)
     {
         RenderService->DrawPrimitive(D3DPT_TRIANGLELIST, 0, 2 * ParticlesNum);
@@ -162,6 +162,7 @@ class SEPS_PS
     void UseSurface(entid_t surface_id);
     float fSurfaceOffset;
     char *TechniqueName;
+    int32_t Technique;
     uint32_t ParticleColor;
 
     //---------------------------------
@@ -35,6 +35,53 @@ FMOD_RESULT ErrorHandler(const FMOD_RESULT result, const char *file, unsigned li
     return result;
 }
 
+// FMOD opens sounds through the file service, so packed ones are found too
+struct SoundFile
+{
+    MappedFile data;
+    size_t pos{};
+};
+
+FMOD_RESULT F_CALLBACK OpenSoundFile(const char *name, unsigned int *filesize, void **handle, void *)
+{
+    auto file = std::make_unique<SoundFile>(SoundFile{fio->_MapFile(name)});
+    if (!file->data.IsOpen())
+    {
+        return FMOD_ERR_FILE_NOTFOUND;
+    }
+    *filesize = static_cast<unsigned int>(file->data.Size());
+    *handle = file.release();
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK CloseSoundFile(void *handle, void *)
+{
+    delete static_cast<SoundFile *>(handle);
+    return FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK ReadSoundFile(void *handle, void *buffer, unsigned int sizebytes, unsigned int *bytesread,
+                                     void *)
+{
+    auto *file = static_cast<SoundFile *>(handle);
+    const auto bytes = std::min<size_t>(sizebytes, file->data.Size() - file->pos);
+    memcpy(buffer, file->data.Data() + file->pos, bytes);
+    file->pos += bytes;
+    *bytesread = static_cast<unsigned int>(bytes);
+    return bytes < sizebytes ? FMOD_ERR_FILE_EOF : FMOD_OK;
+}
+
+FMOD_RESULT F_CALLBACK SeekSoundFile(void *handle, unsigned int pos, void *)
+{
+    auto *file = static_cast<SoundFile *>(handle);
+    if (pos > file->data.Size())
+    {
+        return FMOD_ERR_FILE_COULDNOTSEEK;
+    }
+    file->pos = pos;
+    return FMOD_OK;
+}
+
 } // namespace
 
 SoundService::SoundService()
@@ -97,6 +144,9 @@ bool SoundService::Init()
     core.Trace("Using FMOD %08x", FMOD_VERSION);
     CHECKFMODERR(system->setSoftwareChannels(MAX_SOUNDS_SLOTS));
     CHECKFMODERR(system->setOutput(FMOD_OUTPUTTYPE_AUTODETECT));
+    // the files are in memory already, FMOD does not need to buffer them
+    CHECKFMODERR(
+        system->setFileSystem(OpenSoundFile, CloseSoundFile, ReadSoundFile, SeekSoundFile, nullptr, nullptr, -1));
     CHECKFMODERR(system->init(MAX_SOUNDS_SLOTS, FMOD_INIT_NORMAL, nullptr));
     CHECKFMODERR(system->set3DSettings(1.0, DISTANCEFACTOR, 1.0f));
 
@@ -104,6 +154,7 @@ bool SoundService::Init()
         auto config = Config::Load(Constants::ConfigNames::engine());
         std::ignore = config.SelectSection("sound");
         fadeTimeInSeconds = config.Get<double>("fade_time", 0.5f);
+        maxVoices = static_cast<uint32_t>(std::max<std::int64_t>(config.Get<std::int64_t>("max_voices", 128), 0));
     }
 
     numActiveSounds = 2; // 0 and 1 are special
@@ -173,6 +224,7 @@ void SoundService::ProcessFader(uint16_t idx)
 uint16_t SoundService::FreeSound(const uint16_t idx)
 {
     PlayingSounds[idx].bFree = true;
+    PlayingSounds[idx].bVirtual = false;
     if (idx >= 2 && idx < numActiveSounds)
     {
         freeSounds.push(idx);
@@ -206,7 +258,7 @@ void SoundService::RunStart()
     // release the sounds that have played ...
     for (uint16_t i = 0; i < numActiveSounds; i++)
     {
-        if (PlayingSounds[i].bFree)
+        if (PlayingSounds[i].bFree || PlayingSounds[i].bVirtual)
             continue;
 
         // If it's just paused, don't need to touch it ...
@@ -254,6 +306,7 @@ void SoundService::RunStart()
             core.Event("SoundEnded", "l", i + 2);
         }
     }
+    ProcessVirtualVoices();
     ProcessSoundSchemes();
 }
 
@@ -266,7 +319,7 @@ bool SoundService::AllocateSound(TSD_ID &id)
         return true;
     }
 
-    if (numActiveSounds > MAX_SOUNDS_SLOTS)
+    if (numActiveSounds >= MAX_SOUNDS_SLOTS)
     {
         core.Trace("SoundService::AllocateSound(): no empty slots!");
         return false;
@@ -276,25 +329,208 @@ bool SoundService::AllocateSound(TSD_ID &id)
     return true;
 }
 
-const char *SoundService::GetRandomName(const tAlias *alias) const
+float SoundService::GetTypeVolume(eVolumeType _type) const
 {
-    return alias->soundFiles.pickRandom().c_str();
+    switch (_type)
+    {
+    case VOLUME_FX:
+        return fFXVolume;
+    case VOLUME_MUSIC:
+        return fMusicVolume;
+    case VOLUME_SPEECH:
+        return fSpeechVolume;
+    default:
+        return 1.0f;
+    }
+}
+
+float SoundService::GetAudibility(const tPlayedSound &sound) const
+{
+    float audibility = sound.fSoundVolume * GetTypeVolume(sound.type);
+    if (sound.fMaxDistance <= sound.fMinDistance)
+        return audibility;
+
+    // linear rolloff between min and max distance, silent beyond max
+    const float dx = sound.vPosition.x - vListenerPos.x;
+    const float dy = sound.vPosition.y - vListenerPos.y;
+    const float dz = sound.vPosition.z - vListenerPos.z;
+    const float distance = sqrtf(dx * dx + dy * dy + dz * dz);
+    if (distance >= sound.fMaxDistance)
+        return 0.0f;
+    if (distance > sound.fMinDistance)
+        audibility *= (sound.fMaxDistance - distance) / (sound.fMaxDistance - sound.fMinDistance);
+    return audibility;
 }
 
-int SoundService::GetAliasIndexByName(const char *szAliasName)
+bool SoundService::IsLessImportant(const tPlayedSound &a, const tPlayedSound &b) const
 {
-    const uint32_t dwSearchHash = MakeHashValue(szAliasName);
-    for (size_t i = 0; i < Aliases.size(); i++)
+    if (a.bVirtual != b.bVirtual)
+        return a.bVirtual;
+    if (a.iPrior != b.iPrior)
+        return a.iPrior > b.iPrior;
+    return GetAudibility(a) < GetAudibility(b);
+}
+
+bool SoundService::StartChannel(uint16_t idx, float volume, unsigned int positionMs)
+{
+    auto &sound = PlayingSounds[idx];
+
+    // start to play the sound, but paused ...
+    const auto status = CHECKFMODERR(system->playSound(sound.sound, nullptr, true, &sound.channel));
+    if (status != FMOD_OK || sound.channel == nullptr)
     {
-        if (Aliases[i].dwNameHash == dwSearchHash)
+        core.Trace("system->playSound(sound, nullptr, true, &PlayingSounds[%d].channel)", idx);
+        sound.channel = nullptr;
+        return false;
+    }
+
+    if (positionMs != 0)
+        CHECKFMODERR(sound.channel->setPosition(positionMs, FMOD_TIMEUNIT_MS));
+    CHECKFMODERR(sound.channel->setPriority(sound.iPrior));
+
+    if (sound.sound_type == PCM_3D)
+    {
+        CHECKFMODERR(
+            sound.channel->set3DMinMaxDistance(sound.fMinDistance * DISTANCEFACTOR, sound.fMaxDistance * DISTANCEFACTOR));
+        FMOD_VECTOR vVelocity = {0.0f, 0.0f, 0.0f};
+        CHECKFMODERR(sound.channel->set3DAttributes(&sound.vPosition, &vVelocity));
+    }
+
+    CHECKFMODERR(sound.channel->setVolume(volume));
+    CHECKFMODERR(sound.channel->setPitch(fPitch));
+    CHECKFMODERR(sound.channel->setMode(sound.bLooped ? FMOD_LOOP_NORMAL : FMOD_LOOP_OFF));
+    CHECKFMODERR(sound.channel->setPaused(sound.bPaused));
+
+    // FMOD may have reused a channel another slot still points to, that sound is gone
+    for (uint16_t j = 0; j < numActiveSounds; j++)
+    {
+        if (j == idx || PlayingSounds[j].bFree || PlayingSounds[j].channel != sound.channel)
+            continue;
+
+        PlayingSounds[j].channel = nullptr;
+        j = FreeSound(j);
+    }
+    return true;
+}
+
+void SoundService::VirtualizeSound(uint16_t idx)
+{
+    auto &sound = PlayingSounds[idx];
+    unsigned int positionMs = 0;
+    if (CHECKFMODERR(sound.channel->getPosition(&positionMs, FMOD_TIMEUNIT_MS)) != FMOD_OK)
+    {
+        sound.channel = nullptr;
+        FreeSound(idx);
+        return;
+    }
+    CHECKFMODERR(sound.channel->stop());
+    sound.channel = nullptr;
+    sound.bVirtual = true;
+    sound.fPositionMs = static_cast<float>(positionMs);
+}
+
+void SoundService::PromoteSound(uint16_t idx)
+{
+    auto &sound = PlayingSounds[idx];
+    if (StartChannel(idx, sound.fSoundVolume * GetTypeVolume(sound.type), static_cast<unsigned int>(sound.fPositionMs)))
+        sound.bVirtual = false;
+}
+
+void SoundService::ProcessVirtualVoices()
+{
+    const float fDeltaMs = core.GetDeltaTime() * fPitch;
+
+    VoiceCandidates.clear();
+    for (uint16_t i = 2; i < numActiveSounds; i++)
+    {
+        auto &sound = PlayingSounds[i];
+        if (sound.bFree || sound.sound_type != PCM_3D)
+            continue;
+
+        // virtual sounds keep their play position running without a channel
+        if (sound.bVirtual && !sound.bPaused)
         {
-            if (Aliases[i].Name == szAliasName)
+            sound.fPositionMs += fDeltaMs;
+            if (sound.dwLengthMs > 0 && sound.fPositionMs >= static_cast<float>(sound.dwLengthMs))
             {
-                return i;
+                if (!sound.bLooped)
+                {
+                    i = FreeSound(i);
+                    core.Event("SoundEnded", "l", i + 2);
+                    continue;
+                }
+                sound.fPositionMs = fmodf(sound.fPositionMs, static_cast<float>(sound.dwLengthMs));
             }
         }
+
+        VoiceCandidates.push_back({i, sound.iPrior, GetAudibility(sound)});
     }
-    return -1;
+
+    // audible sounds first, the most important of them get the channels
+    std::ranges::sort(VoiceCandidates, [](const tVoiceCandidate &a, const tVoiceCandidate &b) {
+        if ((a.fAudibility > 0.0f) != (b.fAudibility > 0.0f))
+            return a.fAudibility > 0.0f;
+        if (a.iPrior != b.iPrior)
+            return a.iPrior < b.iPrior;
+        return a.fAudibility > b.fAudibility;
+    });
+
+    numRealVoices = 0;
+    for (const auto &candidate : VoiceCandidates)
+    {
+        auto &sound = PlayingSounds[candidate.idx];
+        // a started channel may have taken over the one of a sound further down the list
+        if (sound.bFree)
+            continue;
+
+        const bool real = candidate.fAudibility > 0.0f && (maxVoices == 0 || numRealVoices < maxVoices);
+        if (real && sound.bVirtual)
+            PromoteSound(candidate.idx);
+        else if (!real && !sound.bVirtual)
+            VirtualizeSound(candidate.idx);
+
+        if (!sound.bFree && !sound.bVirtual)
+            numRealVoices++;
+    }
+}
+
+bool SoundService::StealSound(int32_t _prior)
+{
+    int32_t victim = -1;
+    for (uint16_t i = 2; i < numActiveSounds; i++)
+    {
+        const auto &sound = PlayingSounds[i];
+        if (sound.bFree || sound.iPrior < _prior)
+            continue;
+        if (victim < 0 || IsLessImportant(sound, PlayingSounds[victim]))
+            victim = i;
+    }
+    if (victim < 0)
+        return false;
+
+    if (PlayingSounds[victim].channel)
+        CHECKFMODERR(PlayingSounds[victim].channel->stop());
+    PlayingSounds[victim].channel = nullptr;
+    FreeSound(static_cast<uint16_t>(victim));
+    return true;
+}
+
+const char *SoundService::GetRandomName(const tAlias *alias) const
+{
+    return alias->soundFiles.pickRandom().c_str();
+}
+
+int SoundService::GetAliasIndexByName(std::string_view szAliasName) const
+{
+    const auto it = AliasIndex.find(szAliasName);
+    return it != AliasIndex.end() ? it->second : -1;
+}
+
+std::string SoundService::GetSoundPath(std::string_view fileName)
+{
+    std::string SoundName = "resource\\sounds\\";
+    SoundName += fileName;
+    return fio->ConvertPathResource(SoundName.c_str());
 }
 
 TSD_ID SoundService::SoundPlay(const std::string_view &name, eSoundType _type, eVolumeType _volumeType,
@@ -304,34 +540,35 @@ TSD_ID SoundService::SoundPlay(const std::string_view &name, eSoundType _type, e
                                int32_t _loopPauseTime /* = 0*/, float _volume, /* = 1.0f*/
                                int32_t _prior)
 {
-    auto FileName = std::string(name);
+    std::string SoundName;
 
     // aliases don`t contain `\`
-    if (name.find_first_of('\\') == std::string::npos)
+    const auto AliasIdx = name.find_first_of('\\') == std::string::npos ? GetAliasIndexByName(name) : -1;
+    if (AliasIdx >= 0 && !Aliases[AliasIdx].soundFiles.empty())
     {
-        // Trying to find in aliases
-        const auto AliasIdx = GetAliasIndexByName(FileName.c_str());
-        if (AliasIdx >= 0 && !Aliases[AliasIdx].soundFiles.empty())
-        {
-            // play sound from the alias ...
-            FileName = GetRandomName(&Aliases[AliasIdx]);
-            if constexpr (TRACE_INFORMATION)
-                core.Trace("Play sound from alias %s", FileName.c_str());
+        // play sound from the alias ...
+        SoundName = GetRandomName(&Aliases[AliasIdx]);
+        if constexpr (TRACE_INFORMATION)
+            core.Trace("Play sound from alias %s", SoundName.c_str());
 
-            _minDistance = Aliases[AliasIdx].fMinDistance;
-            _maxDistance = Aliases[AliasIdx].fMaxDistance;
-            _prior = Aliases[AliasIdx].iPrior;
+        _minDistance = Aliases[AliasIdx].fMinDistance;
+        _maxDistance = Aliases[AliasIdx].fMaxDistance;
+        _prior = Aliases[AliasIdx].iPrior;
 
-            if (Aliases[AliasIdx].fVolume > 0.0f)
-            {
-                _volume = Aliases[AliasIdx].fVolume;
-            }
+        if (Aliases[AliasIdx].fVolume > 0.0f)
+        {
+            _volume = Aliases[AliasIdx].fVolume;
         }
     }
+    else
+    {
+        SoundName = GetSoundPath(name);
+    }
 
-    std::string SoundName = "resource\\sounds\\";
-    SoundName += FileName;
-    SoundName = fio->ConvertPathResource(SoundName.c_str());
+    if (_prior < 0)
+        _prior = 0;
+    if (_prior > 255)
+        _prior = 255;
 
     FMOD::Sound *sound = nullptr;
     uint16_t SoundIdx = 0;
@@ -383,13 +620,14 @@ TSD_ID SoundService::SoundPlay(const std::string_view &name, eSoundType _type, e
     else
     {
         // For all other sounds, take from the cache
-        const auto CacheIdx = GetFromCache(SoundName.c_str(), _type);
+        const auto CacheIdx = GetFromCache(SoundName, _type);
         if (CacheIdx < 0)
         {
             return 0;
         }
 
-        bool success = AllocateSound(id);
+        // out of slots, make room by dropping a less important sound
+        bool success = AllocateSound(id) || (StealSound(_prior) && AllocateSound(id));
         if (!success)
         {
             return 0;
@@ -400,31 +638,25 @@ TSD_ID SoundService::SoundPlay(const std::string_view &name, eSoundType _type, e
     }
 
     //--------
-    PlayingSounds[SoundIdx].type = _volumeType;
-    PlayingSounds[SoundIdx].fSoundVolume = _volume;
-
-    // start to play the sound, but paused ...
-    const auto status = CHECKFMODERR(system->playSound(sound, nullptr, true, &PlayingSounds[SoundIdx].channel));
-    if (status != FMOD_OK)
-    {
-        core.Trace("system->playSound(FMOD_CHANNEL_FREE, sound, true, &PlayingSounds[%d].channel)", SoundIdx);
-    }
-
+    auto &slot = PlayingSounds[SoundIdx];
+    slot.type = _volumeType;
+    slot.fSoundVolume = _volume;
+    slot.sound_type = _type;
+    slot.sound = sound;
+    slot.bLooped = _looped;
+    // If just caching ... then keep it paused ...
+    slot.bPaused = _simpleCache;
+    slot.fPositionMs = 0.0f;
+    slot.dwLengthMs = 0;
+    CHECKFMODERR(sound->getLength(&slot.dwLengthMs, FMOD_TIMEUNIT_MS));
+
+    unsigned int positionMs = 0;
     if (SoundIdx <= 1)
     {
-        const auto OGGpos = GetOGGPosition(SoundName.c_str());
-        PlayingSounds[SoundIdx].channel->setPosition(OGGpos, FMOD_TIMEUNIT_MS);
-
+        positionMs = GetOGGPosition(SoundName.c_str());
         _prior = 0;
     }
-
-    if (_prior < 0)
-        _prior = 0;
-    if (_prior > 255)
-        _prior = 255;
-
-    // put priority ...
-    PlayingSounds[SoundIdx].channel->setPriority(_prior);
+    slot.iPrior = _prior;
 
     // Adjust parameters for 3D channel ...
     if (_type == PCM_3D)
@@ -435,86 +667,41 @@ TSD_ID SoundService::SoundPlay(const std::string_view &name, eSoundType _type, e
         if (_maxDistance < 0.0f)
             _maxDistance = 0.0f;
 
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->set3DMinMaxDistance(_minDistance * DISTANCEFACTOR,
-                                                                          _maxDistance * DISTANCEFACTOR));
-
-        FMOD_VECTOR vVelocity = {0.0f, 0.0f, 0.0f};
-        FMOD_VECTOR vPosition{};
+        slot.fMinDistance = _minDistance;
+        slot.fMaxDistance = _maxDistance;
+        slot.vPosition = {};
         if (_startPosition != nullptr)
         {
-            vPosition.x = _startPosition->x;
-            vPosition.y = _startPosition->y;
-            vPosition.z = _startPosition->z;
+            slot.vPosition.x = _startPosition->x;
+            slot.vPosition.y = _startPosition->y;
+            slot.vPosition.z = _startPosition->z;
         }
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->set3DAttributes(&vPosition, &vVelocity));
     }
 
-    switch (_volumeType)
-    {
-    case VOLUME_FX:
-        _volume *= fFXVolume;
-        break;
-    case VOLUME_MUSIC:
-        _volume *= fMusicVolume;
-        break;
-    case VOLUME_SPEECH:
-        _volume *= fSpeechVolume;
-        break;
-    default:
-        _volume *= 1.0f;
-        break;
-    }
+    slot.Name = std::move(SoundName);
+    slot.bFree = false;
 
-    if (_time <= 0)
+    // inaudible and over budget 3D sounds start virtual, ProcessVirtualVoices gives them a channel when they can be
+    // heard
+    if (_type == PCM_3D && SoundIdx > 1 &&
+        (GetAudibility(slot) <= 0.0f || (maxVoices != 0 && numRealVoices >= maxVoices)))
     {
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->setVolume(_volume));
-    }
-    else
-    {
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->setVolume(0));
-    }
-
-    CHECKFMODERR(PlayingSounds[SoundIdx].channel->setPitch(fPitch));
-
-    PlayingSounds[SoundIdx].Name = std::move(SoundName);
-    PlayingSounds[SoundIdx].sound_type = _type;
-
-    // If not just caching ... then unpause ...
-    if (!_simpleCache)
-    {
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->setPaused(false));
-    }
-    else
-    {
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->setPaused(true));
+        slot.channel = nullptr;
+        slot.bVirtual = true;
+        return id;
     }
 
-    PlayingSounds[SoundIdx].bFree = false;
-    // set the looping ..
-    if (_looped)
+    if (!StartChannel(SoundIdx, _time <= 0 ? _volume * GetTypeVolume(_volumeType) : 0.0f, positionMs))
     {
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->setMode(FMOD_LOOP_NORMAL));
+        FreeSound(SoundIdx);
+        return 0;
     }
-    else
+    if (_type == PCM_3D && SoundIdx > 1)
     {
-        CHECKFMODERR(PlayingSounds[SoundIdx].channel->setMode(FMOD_LOOP_OFF));
+        numRealVoices++;
     }
 
-    // ---------- loop through all sounds looking for the one with the same channel --------------
-    for (uint16_t j = 0; j < numActiveSounds; j++)
-    {
-        if (j == SoundIdx)
-            continue;
-
-        if (PlayingSounds[j].channel == PlayingSounds[SoundIdx].channel)
-        {
-            // note that the sound is thrown out ...
-            // so as not to stop him ...
-            j = FreeSound(j);
-        }
-    }
     // Returning the sound ID ...
-
     return id;
 }
 
@@ -534,13 +721,19 @@ void SoundService::SoundSet3DParam(TSD_ID _id, eSoundMessage _message, const voi
     {
     case SM_MAX_DISTANCE: {
         float maxDistance = *((float *)_op);
-        CHECKFMODERR(sound.channel->set3DMinMaxDistance(NULL, maxDistance));
+        sound.fMinDistance = 0.0f;
+        sound.fMaxDistance = maxDistance;
+        if (sound.channel)
+            CHECKFMODERR(sound.channel->set3DMinMaxDistance(NULL, maxDistance));
         break;
     }
 
     case SM_MIN_DISTANCE: {
         float minDistance = *((float *)_op);
-        CHECKFMODERR(sound.channel->set3DMinMaxDistance(minDistance, NULL));
+        sound.fMinDistance = minDistance;
+        sound.fMaxDistance = 0.0f;
+        if (sound.channel)
+            CHECKFMODERR(sound.channel->set3DMinMaxDistance(minDistance, NULL));
         break;
     }
 
@@ -550,8 +743,10 @@ void SoundService::SoundSet3DParam(TSD_ID _id, eSoundMessage _message, const voi
         pos.x = *(fPtr + 0);
         pos.y = *(fPtr + 1);
         pos.z = *(fPtr + 2);
+        sound.vPosition = pos;
         FMOD_VECTOR vVelocity = {0.0f, 0.0f, 0.0f};
-        CHECKFMODERR(sound.channel->set3DAttributes(&pos, &vVelocity));
+        if (sound.channel)
+            CHECKFMODERR(sound.channel->set3DAttributes(&pos, &vVelocity));
         break;
     }
     }
@@ -605,7 +800,8 @@ void SoundService::SoundSetVolume(TSD_ID _id, float _volume)
                 PlayingSounds[i].fFaderCurrentVolume = PlayingSounds[i].fFaderNeedVolume;
             }
 
-            CHECKFMODERR(PlayingSounds[i].channel->setVolume(_volume));
+            if (PlayingSounds[i].channel)
+                CHECKFMODERR(PlayingSounds[i].channel->setVolume(_volume));
         }
         return;
     }
@@ -643,7 +839,8 @@ void SoundService::SoundSetVolume(TSD_ID _id, float _volume)
         _volume *= 1.0f;
         break;
     }
-    CHECKFMODERR(sound.channel->setVolume(_volume));
+    if (sound.channel)
+        CHECKFMODERR(sound.channel->setVolume(_volume));
 }
 
 bool SoundService::SoundIsPlaying(TSD_ID _id)
@@ -669,7 +866,9 @@ void SoundService::SoundResume(TSD_ID _id, int32_t _time /* = 0*/)
             if (PlayingSounds[i].bFree)
                 continue;
 
-            CHECKFMODERR(PlayingSounds[i].channel->setPaused(false));
+            PlayingSounds[i].bPaused = false;
+            if (PlayingSounds[i].channel)
+                CHECKFMODERR(PlayingSounds[i].channel->setPaused(false));
         }
         return;
     }
@@ -682,7 +881,9 @@ void SoundService::SoundResume(TSD_ID _id, int32_t _time /* = 0*/)
     if (_id.stamp() != sound.stamp)
         return;
 
-    CHECKFMODERR(sound.channel->setPaused(false));
+    sound.bPaused = false;
+    if (sound.channel)
+        CHECKFMODERR(sound.channel->setPaused(false));
 }
 
 float SoundService::SoundGetPosition(TSD_ID _id)
@@ -692,7 +893,7 @@ float SoundService::SoundGetPosition(TSD_ID _id)
 
     auto &sound = PlayingSounds[_id.index()];
 
-    if (_id.stamp() != sound.stamp)
+    if (_id.stamp() != sound.stamp || !sound.channel)
         return 0;
 
     unsigned int SoundPositionInMilisecond;
@@ -770,6 +971,9 @@ void SoundService::SetMasterVolume(float _fxVolume, float _musicVolume, float _s
             break;
         }
 
+        if (!PlayingSounds[i].channel)
+            continue;
+
         const auto status = CHECKFMODERR(PlayingSounds[i].channel->setVolume(_volume));
         if (status != FMOD_OK)
         {
@@ -795,7 +999,7 @@ void SoundService::SetPitch(float _pitch)
 
     for (uint16_t i = 0; i < numActiveSounds; i++)
     {
-        if (PlayingSounds[i].bFree)
+        if (PlayingSounds[i].bFree || !PlayingSounds[i].channel)
             continue;
 
         const auto status = CHECKFMODERR(PlayingSounds[i].channel->setPitch(fPitch));
@@ -859,7 +1063,7 @@ void SoundService::SetActiveWithFade(const bool active)
 
     for (const auto &PlayingSound : PlayingSounds)
     {
-        if (PlayingSound.bFree)
+        if (PlayingSound.bFree || !PlayingSound.channel)
             continue;
 
         if (active)
@@ -931,6 +1135,12 @@ void SoundService::SoundStop(TSD_ID _id, int32_t _time)
             if (PlayingSounds[i].bFree)
                 continue;
 
+            if (PlayingSounds[i].bVirtual)
+            {
+                i = FreeSound(i);
+                continue;
+            }
+
             if (i <= 1)
             {
                 unsigned int OGGpos;
@@ -980,6 +1190,13 @@ void SoundService::SoundStop(TSD_ID _id, int32_t _time)
     if (_id.stamp() != sound.stamp)
         return;
 
+    // nothing to fade or stop
+    if (sound.bVirtual)
+    {
+        FreeSound(_id.index());
+        return;
+    }
+
     if (_time > 0)
     {
         float fVol = 0.0f;
@@ -1042,7 +1259,7 @@ void SoundService::AnalyseNameStringAndAddToAlias(tAlias *_alias, const char *in
     if constexpr (TRACE_INFORMATION)
         core.Trace("  -> sound %s, %f", fileName, probability);
 
-    _alias->soundFiles.emplace(probability, fileName);
+    _alias->soundFiles.emplace(probability, GetSoundPath(fileName));
 }
 
 void SoundService::LoadAliasFile(const char *_filename)
@@ -1052,10 +1269,11 @@ void SoundService::LoadAliasFile(const char *_filename)
     const auto sections = config.Sections();
     for (const auto& section : sections) {
         std::ignore = config.SelectSection(section);
+        // the first alias of a name wins
+        AliasIndex.try_emplace(section, static_cast<int32_t>(Aliases.size()));
         Aliases.emplace_back();
         tAlias &alias = Aliases.back();
         alias.Name = section;
-        alias.dwNameHash = MakeHashValue(alias.Name.c_str());
         alias.fMaxDistance = config.Get<double>("maxDistance", -1.0);
         alias.fMinDistance = config.Get<double>("minDistance", -1.0);
         alias.fVolume = config.Get<double>("volume", -1.0);
@@ -1141,6 +1359,18 @@ void SoundService::DebugDraw()
         if (PlayingSounds[i].bFree)
             continue;
 
+        // virtualized by the engine, there is no channel to ask
+        if (PlayingSounds[i].bVirtual)
+        {
+            Count++;
+            const auto &vPos = PlayingSounds[i].vPosition;
+            const CVECTOR vec_pos(vPos.x, vPos.y, vPos.z);
+            rs->DrawSphere(vec_pos, 0.2f, 0xFF808080);
+            DebugPrint3D(vec_pos, 30.0f, 2, 1.0f, 0xFF808080, 1.0f, "%s", PlayingSounds[i].Name.c_str());
+            DebugPrint3D(vec_pos, 30.0f, 4, 1.0f, 0xFF808080, 1.0f, "prior: %d", PlayingSounds[i].iPrior);
+            continue;
+        }
+
         bool bVirtual;
         PlayingSounds[i].channel->isVirtual(&bVirtual);
 
@@ -1239,22 +1469,13 @@ void SoundService::DebugDraw()
     }
 }
 
-int SoundService::GetFromCache(const char *szName, eSoundType _type)
+int SoundService::GetFromCache(const std::string &szName, eSoundType _type)
 {
-    const uint32_t dwSearchHash = MakeHashValue(szName);
-
-    for (size_t i = 0; i < SoundCache.size(); i++)
+    auto &index = SoundCacheIndex[_type];
+    if (const auto it = index.find(szName); it != index.end())
     {
-        if (SoundCache[i].type != _type)
-            continue;
-        if (SoundCache[i].dwNameHash == dwSearchHash)
-        {
-            if (SoundCache[i].Name == szName)
-            {
-                SoundCache[i].fTimeFromLastPlay = 0.0;
-                return i;
-            }
-        }
+        SoundCache[it->second].fTimeFromLastPlay = 0.0;
+        return it->second;
     }
 
     FMOD_MODE mode = FMOD_DEFAULT;
@@ -1269,19 +1490,19 @@ int SoundService::GetFromCache(const char *szName, eSoundType _type)
     }
 
     tSoundCache Cache;
-    CHECKFMODERR(system->createSound(szName, mode, nullptr, &Cache.sound));
+    CHECKFMODERR(system->createSound(szName.c_str(), mode, nullptr, &Cache.sound));
 
     if (Cache.sound == nullptr)
     {
-        core.Trace("Problem with sound loading !!! '%s'", szName);
+        core.Trace("Problem with sound loading !!! '%s'", szName.c_str());
         return -1;
     }
     Cache.type = _type;
     Cache.Name = szName;
-    Cache.dwNameHash = dwSearchHash;
     Cache.fTimeFromLastPlay = 0.0f;
 
     SoundCache.push_back(Cache);
+    index.emplace(szName, static_cast<int32_t>(SoundCache.size() - 1));
 
     return (SoundCache.size() - 1);
 }
@@ -2,6 +2,8 @@
 
 #include <stack>
 #include <string>
+#include <string_view>
+#include <unordered_map>
 
 #include "c_vector.h"
 #include "dx9render.h"
@@ -31,9 +33,18 @@ class SoundService : public VSoundService
     FMOD::System *system;
     FMOD::Sound *OGG_sound[2];
 
+    struct NameHash
+    {
+        using is_transparent = void;
+
+        size_t operator()(std::string_view name) const noexcept
+        {
+            return std::hash<std::string_view>{}(name);
+        }
+    };
+
     struct tSoundCache
     {
-        uint32_t dwNameHash;
         std::string Name;
         FMOD::Sound *sound;
         float fTimeFromLastPlay;
@@ -41,7 +52,6 @@ class SoundService : public VSoundService
 
         tSoundCache() : type()
         {
-            dwNameHash = 0;
             sound = nullptr;
             fTimeFromLastPlay = 0.0f;
         }
@@ -61,6 +71,19 @@ class SoundService : public VSoundService
         // temp
         std::string Name;
 
+        // everything needed to start the channel again after the sound was virtual
+        FMOD::Sound *sound;
+        FMOD_VECTOR vPosition;
+        float fMinDistance;
+        float fMaxDistance;
+        int32_t iPrior;
+        bool bLooped;
+        bool bPaused;
+        // plays without a channel, fPositionMs runs on its own
+        bool bVirtual;
+        float fPositionMs;
+        unsigned int dwLengthMs;
+
         uint16_t stamp;
         bool bFree;
 
@@ -69,6 +92,17 @@ class SoundService : public VSoundService
             channel = nullptr;
             type = VOLUME_FX;
 
+            sound = nullptr;
+            vPosition = {};
+            fMinDistance = 0;
+            fMaxDistance = 0;
+            iPrior = 128;
+            bLooped = false;
+            bPaused = false;
+            bVirtual = false;
+            fPositionMs = 0;
+            dwLengthMs = 0;
+
             fFaderNeedVolume = 0;
             fFaderCurrentVolume = 0;
             fFaderDeltaInSec = 0;
@@ -82,6 +116,29 @@ class SoundService : public VSoundService
     std::stack<uint16_t> freeSounds;
     uint16_t numActiveSounds{};
 
+    // Virtual voices ------------------------------------------------------
+    // 3D sounds past their max distance, or over the budget of real voices, keep their slot but no channel
+    struct tVoiceCandidate
+    {
+        uint16_t idx;
+        int32_t iPrior;
+        float fAudibility;
+    };
+
+    // real 3D voices, 0 is no limit
+    uint32_t maxVoices = 128;
+    uint32_t numRealVoices = 0;
+    std::vector<tVoiceCandidate> VoiceCandidates;
+
+    float GetTypeVolume(eVolumeType _type) const;
+    float GetAudibility(const tPlayedSound &sound) const;
+    bool IsLessImportant(const tPlayedSound &a, const tPlayedSound &b) const;
+    bool StartChannel(uint16_t idx, float volume, unsigned int positionMs);
+    void VirtualizeSound(uint16_t idx);
+    void PromoteSound(uint16_t idx);
+    void ProcessVirtualVoices();
+    bool StealSound(int32_t _prior);
+
     struct PlayedOGG
     {
         std::string Name;
@@ -96,8 +153,10 @@ class SoundService : public VSoundService
     int GetOGGPositionIndex(const char *szName);
 
     std::vector<tSoundCache> SoundCache;
+    // SoundCache indices by name, one map per eSoundType
+    std::unordered_map<std::string, int32_t, NameHash, std::equal_to<>> SoundCacheIndex[PCM_STEREO + 1];
 
-    int GetFromCache(const char *szName, eSoundType _type);
+    int GetFromCache(const std::string &szName, eSoundType _type);
 
     bool FaderParity;
 
@@ -111,12 +170,12 @@ class SoundService : public VSoundService
     struct tAlias
     {
         std::string Name;
-        uint32_t dwNameHash;
-        
+
         float fMinDistance;
         float fMaxDistance;
         int32_t iPrior;
         float fVolume;
+        // resolved paths of the sounds
         storm::ProbabilityTable<std::string> soundFiles;
 
         tAlias()
@@ -125,9 +184,11 @@ class SoundService : public VSoundService
     };
 
     std::vector<tAlias> Aliases;
+    std::unordered_map<std::string, int32_t, NameHash, std::equal_to<>> AliasIndex;
 
     const char *GetRandomName(const tAlias *alias) const;
-    int GetAliasIndexByName(const char *szAliasName);
+    int GetAliasIndexByName(std::string_view szAliasName) const;
+    static std::string GetSoundPath(std::string_view fileName);
     void AnalyseNameStringAndAddToAlias(tAlias *_alias, const char *in_string) const;
     void LoadAliasFile(const char *_filename) override;
     void InitAliases();
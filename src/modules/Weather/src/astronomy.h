@@ -93,6 +93,7 @@ class Astronomy : public Entity
         float fRadius, fSize, fHeightFade, fSunFade;
         float fVisualMagnitude, fTelescopeMagnitude;
         int32_t iTexture;
+        int32_t iTechnique;
         bool bEnable;
         int32_t iVertexBuffer, iVertexBufferColors;
         IDirect3DVertexDeclaration9 *pDecl;
@@ -16,6 +16,7 @@ RAIN::RAIN()
     iVertexBuffer = -1;
     iRainbowTex = -1;
     iRainDropsTexture = -1;
+    iRainTechnique = -1;
     bRainbowEnable = false;
     bShow = true;
 
@@ -191,6 +192,7 @@ bool RAIN::Init()
 {
     rs = static_cast<VDX9RENDER *>(core.GetService("dx9render"));
     cs = static_cast<COLLIDE *>(core.GetService("coll"));
+    iRainTechnique = rs->TechniqueGetHandle("rain");
 
     SetDevice();
 
@@ -462,7 +464,7 @@ void RAIN::Realize(uint32_t Delta_Time)
 
     if (iVertexBuffer >= 0)
     {
-        bool bDraw = rs->TechniqueExecuteStart("rain");
+        bool bDraw = rs->TechniqueExecuteStart(iRainTechnique);
 
         if (bDraw)
             for (i = 0; i < dwNumRainBlocks; i++)
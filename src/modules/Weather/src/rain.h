@@ -57,6 +57,7 @@ class RAIN : public Entity
 
   private:
     int32_t iRainDropsTexture;
+    int32_t iRainTechnique;
     float fDropsDeltaTime;
     std::vector<RS_RECT> aRects;
     std::vector<drop_t> aDrops;
@@ -89,6 +89,9 @@ void SKY::SetDevice()
 {
     pRS = static_cast<VDX9RENDER *>(core.GetService("dx9render"));
     Assert(pRS);
+    iTechSky = pRS->TechniqueGetHandle(sTechSky.c_str());
+    iTechSkyBlend = pRS->TechniqueGetHandle(sTechSkyBlend.c_str());
+    iTechSkyBlendAlpha = pRS->TechniqueGetHandle(sTechSkyBlendAlpha.c_str());
 }
 
 void SKY::UpdateFogSphere(const bool initialize)
@@ -353,7 +356,7 @@ void SKY::Realize(uint32_t Delta_Time)
         uint32_t dwColor = (dwSkyColor & 0x00FFFFFF) | (static_cast<int32_t>(0xFF000000 * fBlendFactor) & 0xFF000000);
         pRS->SetRenderState(D3DRS_TEXTUREFACTOR, dwColor);
 
-        if (pRS->TechniqueExecuteStart(sTechSkyBlend.c_str()))
+        if (pRS->TechniqueExecuteStart(iTechSkyBlend))
             do
             {
                 for (int32_t i = 0; i < SKY_NUM_TEXTURES; i++)
@@ -386,7 +389,7 @@ void SKY::Realize(uint32_t Delta_Time)
                     static_cast<SUNGLOW *>(pSunGlow)->DrawSunMoon();
 
                 pRS->SetTransform(D3DTS_WORLD, pMatWorld);
-                if (pRS->TechniqueExecuteStart(sTechSkyBlendAlpha.c_str()))
+                if (pRS->TechniqueExecuteStart(iTechSkyBlendAlpha))
                     do
                     {
                         for (int32_t i = 0; i < SKY_NUM_TEXTURES; i++)
@@ -410,7 +413,7 @@ void SKY::Realize(uint32_t Delta_Time)
     {
         pRS->SetRenderState(D3DRS_TEXTUREFACTOR, dwSkyColor);
 
-        if (pRS->TechniqueExecuteStart(sTechSky.c_str()))
+        if (pRS->TechniqueExecuteStart(iTechSky))
             do
             {
                 for (int32_t i = 0; i < SKY_NUM_TEXTURES; i++)
@@ -468,18 +471,21 @@ uint32_t SKY::AttributeChanged(ATTRIBUTES *pAttribute)
     if (*pAttribute == "techSky")
     {
         sTechSky = to_string(pAttribute->GetThisAttr());
+        iTechSky = pRS->TechniqueGetHandle(sTechSky.c_str());
         return 0;
     }
 
     if (*pAttribute == "techSkyBlend")
     {
         sTechSkyBlend = to_string(pAttribute->GetThisAttr());
+        iTechSkyBlend = pRS->TechniqueGetHandle(sTechSkyBlend.c_str());
         return 0;
     }
 
     if (*pAttribute == "techSkyAlpha")
     {
         sTechSkyBlendAlpha = to_string(pAttribute->GetThisAttr());
+        iTechSkyBlendAlpha = pRS->TechniqueGetHandle(sTechSkyBlendAlpha.c_str());
         return 0;
     }
 
@@ -62,6 +62,9 @@ class SKY : public Entity
     std::string sTechSkyBlend = "SkyBlend";
     std::string sTechSkyBlendAlpha = "Skyblend_alpha";
     std::string sTechSkyFog = "SkyFog";
+    int32_t iTechSky = -1;
+    int32_t iTechSkyBlend = -1;
+    int32_t iTechSkyBlendAlpha = -1;
 
     VDX9RENDER *pRS;
     int32_t TexturesID[SKY_NUM_TEXTURES];
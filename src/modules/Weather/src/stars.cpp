@@ -14,6 +14,7 @@ Astronomy::STARS::STARS()
 
     pDecl = nullptr;
     iTexture = -1;
+    iTechnique = -1;
     iVertexBuffer = -1;
     iVertexBufferColors = -1;
     fPrevFov = -1.0f;
@@ -60,6 +61,7 @@ void Astronomy::STARS::Init(ATTRIBUTES *pAP)
     iTexture = -1;
     iVertexBuffer = -1;
     iVertexBufferColors = -1;
+    iTechnique = pRS->TechniqueGetHandle("stars");
 
     pAP = pAP->FindAClass(pAP, "Stars");
     if (!pAP)
@@ -324,7 +326,7 @@ void Astronomy::STARS::Realize(double dDeltaTime, double dHour)
     pRS->SetStreamSource(0, pRS->GetVertexBuffer(iVertexBuffer), sizeof(CVECTOR));
     pRS->SetStreamSource(1, pRS->GetVertexBuffer(iVertexBufferColors), sizeof(uint32_t));
 
-    if (pRS->TechniqueExecuteStart("stars"))
+    if (pRS->TechniqueExecuteStart(iTechnique))
         do
         {
             pRS->DrawPrimitive(D3DPT_POINTLIST, 0, aStars.size());
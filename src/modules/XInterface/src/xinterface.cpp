@@ -87,6 +87,8 @@ XINTERFACE::XINTERFACE()
     bActive = true;
 
     pRenderService = nullptr;
+    m_idStartTechnique = -1;
+    m_idExitTechnique = -1;
     m_pNodes = nullptr;
     m_pCurNode = nullptr;
     m_pContHelp = nullptr;
@@ -191,6 +193,8 @@ void XINTERFACE::SetDevice()
     {
         throw std::runtime_error("No service: dx9render");
     }
+    m_idStartTechnique = pRenderService->TechniqueGetHandle("iStartTechnique");
+    m_idExitTechnique = pRenderService->TechniqueGetHandle("iExitTechnique");
 
     pStringService = static_cast<VSTRSERVICE *>(core.GetService("STRSERVICE"));
     if (!pStringService)
@@ -338,7 +342,7 @@ void XINTERFACE::Realize(uint32_t)
 
     uint32_t dwFogFlag;
     pRenderService->GetRenderState(D3DRS_FOGENABLE, &dwFogFlag);
-    if (pRenderService->TechniqueExecuteStart("iStartTechnique"))
+    if (pRenderService->TechniqueExecuteStart(m_idStartTechnique))
         while (pRenderService->TechniqueExecuteNext())
             ;
 
@@ -442,7 +446,7 @@ void XINTERFACE::Realize(uint32_t)
     // Show context help data
     ShowContextHelp();
 
-    if (pRenderService->TechniqueExecuteStart("iExitTechnique"))
+    if (pRenderService->TechniqueExecuteStart(m_idExitTechnique))
         while (pRenderService->TechniqueExecuteNext())
             ;
     pRenderService->SetRenderState(D3DRS_FOGENABLE, dwFogFlag);
@@ -2754,6 +2758,7 @@ char *XINTERFACE::SaveFileFind(int32_t saveNum, char *buffer, size_t bufSize, in
         }
 
         // start save file finding
+        core.WaitStateSaving();
         const auto vFilePaths = fio->_GetFsPathsByMask(sSavePath, nullptr, true);
         for (std::filesystem::path filePath : vFilePaths)
         {
@@ -2807,6 +2812,7 @@ bool XINTERFACE::NewSaveFileName(const char *fileName) const
         sprintf(param, "%s\\%s", sSavePath, fileName);
     }
 
+    core.WaitStateSaving();
     return !(fio->_FileOrDirectoryExists(param));
 }
 
@@ -2826,6 +2832,7 @@ void XINTERFACE::DeleteSaveFile(const char *fileName)
     {
         sprintf(param, "%s\\%s", sSavePath, fileName);
     }
+    core.WaitStateSaving();
     fio->_DeleteFile(param);
 }
 
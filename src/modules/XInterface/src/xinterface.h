@@ -22,6 +22,8 @@ class XINTERFACE : public XINTERFACE_BASE
     VXSERVICE *pPictureService;
     VSTRSERVICE *pStringService;
     VDX9RENDER *pRenderService;
+    int32_t m_idStartTechnique;
+    int32_t m_idExitTechnique;
 
     CXI_UTILS m_UtilContainer;
 
@@ -106,14 +106,14 @@ class CMatrix
     void operator*=(CMatrix &matrix);
     void operator*=(float k);
     CMatrix operator*(const CMatrix &matrix) const;
-    CVECTOR operator*(const CVECTOR &vector);
+    CVECTOR operator*(const CVECTOR &vector) const;
 
     // this = m1*m2, (m1 != this, m2 != this)
     void EqMultiply(const CMatrix &m1, const CMatrix &m2);
     // Transform vertex to local coordinate system
-    void MulToInv(const CVECTOR &srcVrt, CVECTOR &resVrt);
+    void MulToInv(const CVECTOR &srcVrt, CVECTOR &resVrt) const;
     // Transform normal to local coordinate system
-    void MulToInvNorm(const CVECTOR &srcNorm, CVECTOR &resNorm);
+    void MulToInvNorm(const CVECTOR &srcNorm, CVECTOR &resNorm) const;
 
     // Transposition
     void Transposition();
@@ -462,7 +462,7 @@ inline CMatrix CMatrix::operator*(const CMatrix &matrix) const
     return tmp;
 }
 
-inline CVECTOR CMatrix::operator*(const CVECTOR &vector)
+inline CVECTOR CMatrix::operator*(const CVECTOR &vector) const
 {
     CVECTOR tmp;
     tmp.x = matrix[0] * vector.x + matrix[4] * vector.y + matrix[8] * vector.z + matrix[12];
@@ -512,7 +512,7 @@ inline void CMatrix::EqMultiply(const CMatrix &m1, const CMatrix &m2)
 }
 
 // Transform vertex to local coordinate system
-inline void CMatrix::MulToInv(const CVECTOR &src, CVECTOR &res)
+inline void CMatrix::MulToInv(const CVECTOR &src, CVECTOR &res) const
 {
     res.x = (src.x - matrix[12]) * matrix[0] + (src.y - matrix[13]) * matrix[1] + (src.z - matrix[14]) * matrix[2];
     res.y = (src.x - matrix[12]) * matrix[4] + (src.y - matrix[13]) * matrix[5] + (src.z - matrix[14]) * matrix[6];
@@ -520,7 +520,7 @@ inline void CMatrix::MulToInv(const CVECTOR &src, CVECTOR &res)
 }
 
 // Transform normal to local coordinate system
-inline void CMatrix::MulToInvNorm(const CVECTOR &src, CVECTOR &res)
+inline void CMatrix::MulToInvNorm(const CVECTOR &src, CVECTOR &res) const
 {
     res.x = src.x * matrix[0] + src.y * matrix[1] + src.z * matrix[2];
     res.y = src.x * matrix[4] + src.y * matrix[5] + src.z * matrix[6];
@@ -159,6 +159,35 @@ class VMA
             pService = 0;                                                                                              \
         };                                                                                                             \
     } a##vmaci;
+// Registers the service a, served by an instance of b instead when select is true at creation
+#define CREATE_SERVICE_OR(a, b, select)                                                                                \
+    class a##vmacd : public VMA                                                                                        \
+    {                                                                                                                  \
+      public:                                                                                                          \
+        SERVICE *pService = 0;                                                                                         \
+        const char *GetName()                                                                                          \
+        {                                                                                                              \
+            return #a;                                                                                                 \
+        }                                                                                                              \
+        void *CreateClass()                                                                                            \
+        {                                                                                                              \
+            if (pService == 0)                                                                                         \
+                pService = (select) ? static_cast<SERVICE *>(new b) : static_cast<SERVICE *>(new a);                   \
+            nReference++;                                                                                              \
+            return pService;                                                                                           \
+        }                                                                                                              \
+        bool Service()                                                                                                 \
+        {                                                                                                              \
+            return true;                                                                                               \
+        }                                                                                                              \
+        void Clear()                                                                                                   \
+        {                                                                                                              \
+            nReference = 0;                                                                                            \
+            if (pService)                                                                                              \
+                delete pService;                                                                                       \
+            pService = 0;                                                                                              \
+        };                                                                                                             \
+    } a##vmaci;
 #define CREATE_SCRIPTLIBRIARY(a)                                                                                       \
     class a##vmacd : public VMA                                                                                        \
     {                                                                                                                  \